@@ -0,0 +1,179 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include "bench_common.h"
+
+#include "fclmusa/collision.h"
+#include "fclmusa/distance.h"
+#include "fclmusa/geometry.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/memory/alloc_profiler.h"
+#include "fclmusa/memory/pool_allocator.h"
+#include "fclmusa/platform.h"
+#include "fclmusa/upstream/upstream_bridge.h"
+
+//
+// 分配剖析基准：测量 Allocate / Free 的单次开销，并对一段 Mesh 工作负载（创建 / upstream 碰撞与距离 / 销毁）
+// 按调用点与池标记输出分配次数、峰值与大小分布。分别以 FCLMUSA_ENABLE_ALLOC_PROFILING=ON / OFF 构建对比开销；
+// 未编译剖析支持时只输出耗时。
+// 用法：FclMusaAllocationProfileBench [iterations]
+//
+
+namespace {
+
+using fclmusa::bench::KeepAlive;
+using fclmusa::bench::Measure;
+using fclmusa::bench::PrintHeader;
+using fclmusa::bench::PrintResult;
+using fclmusa::geom::IdentityTransform;
+
+constexpr ULONGLONG kPoseCount = 64;
+constexpr ULONG kWorkloadRounds = 32;
+
+constexpr const char* kSiteNames[FCL_ALLOC_SITE_USER_FIRST] = {
+    "unknown", "geometry", "bvh", "upstream model", "upstream query", "libccd", "broadphase", "coherence cache",
+};
+
+struct ShapeHolder {
+    FCL_GEOMETRY_HANDLE Handle = {};
+    FCL_GEOMETRY_REFERENCE Reference = {};
+    FCL_GEOMETRY_SNAPSHOT Snapshot = {};
+
+    ~ShapeHolder() {
+        FclReleaseGeometryReference(&Reference);
+        if (Handle.Value != 0) {
+            FclDestroyGeometry(Handle);
+        }
+    }
+};
+
+bool CreateMesh(float radius, ShapeHolder* holder) {
+    const FCL_VECTOR3 vertices[] = {
+        {radius, 0.0f, 0.0f}, {-radius, 0.0f, 0.0f},
+        {0.0f, radius, 0.0f}, {0.0f, -radius, 0.0f},
+        {0.0f, 0.0f, radius}, {0.0f, 0.0f, -radius},
+    };
+    const UINT32 indices[] = {
+        0, 2, 4, 2, 1, 4, 1, 3, 4, 3, 0, 4,
+        2, 0, 5, 1, 2, 5, 3, 1, 5, 0, 3, 5,
+    };
+    FCL_MESH_GEOMETRY_DESC desc = {};
+    desc.Vertices = vertices;
+    desc.VertexCount = static_cast<ULONG>(sizeof(vertices) / sizeof(vertices[0]));
+    desc.Indices = indices;
+    desc.IndexCount = static_cast<ULONG>(sizeof(indices) / sizeof(indices[0]));
+    return NT_SUCCESS(FclCreateGeometry(FCL_GEOMETRY_MESH, &desc, &holder->Handle)) &&
+           NT_SUCCESS(FclAcquireGeometryReference(holder->Handle, &holder->Reference, &holder->Snapshot));
+}
+
+FCL_TRANSFORM PoseForIteration(ULONGLONG iteration) noexcept {
+    FCL_TRANSFORM transform = IdentityTransform();
+    transform.Translation.X = 0.5f + static_cast<float>(iteration % kPoseCount) * 0.03f;
+    transform.Translation.Y = 0.1f;
+    transform.Translation.Z = 0.05f;
+    return transform;
+}
+
+bool RunMeshWorkload() {
+    const FCL_TRANSFORM origin = IdentityTransform();
+    for (ULONG round = 0; round < kWorkloadRounds; ++round) {
+        ShapeHolder a;
+        ShapeHolder b;
+        if (!CreateMesh(0.8f, &a) || !CreateMesh(0.6f, &b)) {
+            return false;
+        }
+        for (ULONGLONG i = 0; i < kPoseCount; ++i) {
+            BOOLEAN hit = FALSE;
+            FCL_CONTACT_INFO contact = {};
+            FclUpstreamCollide(a.Snapshot, origin, b.Snapshot, PoseForIteration(i), &hit, &contact);
+            FCL_DISTANCE_RESULT result = {};
+            FclUpstreamDistance(a.Snapshot, origin, b.Snapshot, PoseForIteration(i), &result);
+            KeepAlive(hit);
+        }
+    }
+    return true;
+}
+
+// 直方图最高的非空桶，输出为该桶的字节上界。
+unsigned long long LargestBucketBytes(const FCL_ALLOC_PROFILE_ENTRY& entry) noexcept {
+    for (ULONG bucket = FCL_ALLOC_PROFILE_HISTOGRAM_BUCKETS; bucket > 0; --bucket) {
+        if (entry.SizeHistogram[bucket - 1] != 0) {
+            return 16ull << (bucket - 1);
+        }
+    }
+    return 0;
+}
+
+void PrintEntry(const char* name, const FCL_ALLOC_PROFILE_ENTRY& entry) {
+    std::printf("  %-16s allocs %10llu  bytes %12llu  live %10llu  peak %10llu  largest <= %llu B\n",
+        name,
+        entry.AllocationCount,
+        entry.BytesAllocated,
+        entry.LiveBytes,
+        entry.PeakLiveBytes,
+        LargestBucketBytes(entry));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ULONGLONG iterations = 1000000;
+    if (argc > 1) {
+        iterations = std::strtoull(argv[1], nullptr, 10);
+        if (iterations == 0) {
+            std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!NT_SUCCESS(FclGeometrySubsystemInitialize())) {
+        std::fprintf(stderr, "FclGeometrySubsystemInitialize failed\n");
+        return EXIT_FAILURE;
+    }
+
+    PrintHeader(FCL_MUSA_ENABLE_ALLOC_PROFILING ? "allocation profiling: compiled in"
+                                                : "allocation profiling: compiled out");
+    PrintResult(Measure("alloc/free 64 B", iterations, [](ULONGLONG) {
+        void* block = fclmusa::memory::Allocate(64);
+        fclmusa::memory::Free(block);
+        KeepAlive(block != nullptr);
+    }));
+    PrintResult(Measure("alloc/free 64 B (site scope)", iterations, [](ULONGLONG) {
+        FCL_ALLOCATION_SITE(FCL_ALLOC_SITE_USER_FIRST);
+        void* block = fclmusa::memory::Allocate(64);
+        fclmusa::memory::Free(block);
+        KeepAlive(block != nullptr);
+    }));
+
+    FclResetAllocationProfile();
+    int exitCode = EXIT_SUCCESS;
+    if (!RunMeshWorkload()) {
+        std::fprintf(stderr, "failed to create benchmark geometry\n");
+        exitCode = EXIT_FAILURE;
+    }
+
+    static FCL_ALLOC_PROFILE profile = {};
+    if (exitCode == EXIT_SUCCESS && NT_SUCCESS(FclQueryAllocationProfile(&profile))) {
+        std::printf("mesh workload (%lu rounds x %llu poses), by site:\n", kWorkloadRounds, kPoseCount);
+        for (ULONG site = 0; site < FCL_ALLOC_SITE_USER_FIRST; ++site) {
+            PrintEntry(kSiteNames[site], profile.Sites[site]);
+        }
+        std::printf("by pool tag (%lu tags, %llu untracked allocations):\n",
+            profile.TagCount,
+            profile.UntrackedTagAllocations);
+        for (ULONG i = 0; i < profile.TagCount; ++i) {
+            const ULONG key = profile.Tags[i].Key;
+            const char name[5] = {
+                static_cast<char>(key & 0xFF),
+                static_cast<char>((key >> 8) & 0xFF),
+                static_cast<char>((key >> 16) & 0xFF),
+                static_cast<char>((key >> 24) & 0xFF),
+                '\0',
+            };
+            PrintEntry(name, profile.Tags[i]);
+        }
+    }
+
+    FclGeometrySubsystemShutdown();
+    return exitCode;
+}
@@ -0,0 +1,90 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include "bench_common.h"
+
+#include "fclmusa/collision.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/narrowphase/analytic_ccd.h"
+#include "fclmusa/platform.h"
+#include "fclmusa/upstream/upstream_bridge.h"
+
+//
+// 平移 CCD 微基准：对比 upstream 保守推进（每次构造几何 + 迭代）与解析 TOI 内核。
+// 模拟传送带场景：对象 1 以不同偏移高速穿过静止的对象 2，命中 / 掠过交替出现。
+// 用法：FclMusaAnalyticCcdBench [iterations]
+//
+
+namespace {
+
+using fclmusa::bench::KeepAlive;
+using fclmusa::bench::Measure;
+using fclmusa::bench::PrintHeader;
+using fclmusa::bench::PrintResult;
+using fclmusa::geom::IdentityTransform;
+
+FCL_GEOMETRY_SNAPSHOT MakeSphere(float radius) noexcept {
+    FCL_GEOMETRY_SNAPSHOT snapshot = {};
+    snapshot.Type = FCL_GEOMETRY_SPHERE;
+    snapshot.Data.Sphere.Radius = radius;
+    return snapshot;
+}
+
+FCL_GEOMETRY_SNAPSHOT MakeBox(float x, float y, float z) noexcept {
+    FCL_GEOMETRY_SNAPSHOT snapshot = {};
+    snapshot.Type = FCL_GEOMETRY_OBB;
+    snapshot.Data.Obb.Extents = {x, y, z};
+    snapshot.Data.Obb.Rotation = IdentityTransform().Rotation;
+    return snapshot;
+}
+
+FCL_INTERP_MOTION SweepForIteration(ULONGLONG iteration) noexcept {
+    FCL_INTERP_MOTION motion = {};
+    motion.Start = IdentityTransform();
+    motion.Start.Translation = {-4.0f, static_cast<float>(iteration % 32) * 0.05f, 0.0f};
+    motion.End = motion.Start;
+    motion.End.Translation.X = 4.0f;
+    return motion;
+}
+
+void RunCase(const char* label, const FCL_GEOMETRY_SNAPSHOT& object1, const FCL_GEOMETRY_SNAPSHOT& object2, ULONGLONG iterations) {
+    // 对象 2 静止但带固定旋转，使 OBB/OBB 覆盖非轴对齐的叉积轴。
+    FCL_INTERP_MOTION still = {};
+    still.Start = IdentityTransform();
+    still.Start.Rotation = fclmusa::geom::RotationMatrixFromAxisAngle({0.0f, 0.0f, 1.0f}, 0.3f);
+    still.End = still.Start;
+    char name[96] = {};
+
+    std::snprintf(name, sizeof(name), "%s upstream CA", label);
+    PrintResult(Measure(name, iterations, [&](ULONGLONG i) {
+        FCL_CONTINUOUS_COLLISION_RESULT result = {};
+        FclUpstreamContinuousCollision(object1, SweepForIteration(i), object2, still, 1.0e-4, 64, &result);
+        KeepAlive(result.Intersecting);
+    }));
+
+    std::snprintf(name, sizeof(name), "%s analytic", label);
+    PrintResult(Measure(name, iterations, [&](ULONGLONG i) {
+        FCL_CONTINUOUS_COLLISION_RESULT result = {};
+        fclmusa::narrowphase::TryAnalyticContinuousCollision(object1, SweepForIteration(i), object2, still, &result);
+        KeepAlive(result.Intersecting);
+    }));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ULONGLONG iterations = 50000;
+    if (argc > 1) {
+        iterations = std::strtoull(argv[1], nullptr, 10);
+        if (iterations == 0) {
+            std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    PrintHeader("translational CCD: conservative advancement vs analytic TOI");
+    RunCase("sphere/sphere", MakeSphere(0.25f), MakeSphere(0.5f), iterations);
+    RunCase("sphere/box", MakeSphere(0.25f), MakeBox(0.5f, 0.5f, 0.5f), iterations);
+    RunCase("box/box", MakeBox(0.25f, 0.25f, 0.25f), MakeBox(0.5f, 0.5f, 0.5f), iterations);
+    return EXIT_SUCCESS;
+}
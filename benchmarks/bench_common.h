@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdio>
+
+#include "fclmusa/platform.h"
+
+//
+// R3 基准测试公共工具（仅用户态构建）
+// - 使用 QueryPerformanceCounter 计时，QueryThreadCycleTime 统计本线程周期数
+// - 先预热再计时，结果以 ns/op 与 cycles/op 输出
+//
+
+namespace fclmusa::bench {
+
+struct BenchResult {
+    const char* Name;
+    ULONGLONG Iterations;
+    double NanosecondsPerOp;
+    double CyclesPerOp;
+};
+
+// 防止编译器把被测调用当作无副作用代码消除。
+inline volatile ULONGLONG g_BenchSink = 0;
+
+template <typename T>
+inline void KeepAlive(const T& value) noexcept {
+    g_BenchSink = g_BenchSink + static_cast<ULONGLONG>(value);
+}
+
+inline ULONGLONG ReadThreadCycles() noexcept {
+    ULONG64 cycles = 0;
+    QueryThreadCycleTime(GetCurrentThread(), &cycles);
+    return cycles;
+}
+
+template <typename Fn>
+BenchResult Measure(const char* name, ULONGLONG iterations, Fn&& body) {
+    const ULONGLONG warmup = (iterations / 10) + 1;
+    for (ULONGLONG i = 0; i < warmup; ++i) {
+        body(i);
+    }
+
+    LARGE_INTEGER frequency = {};
+    LARGE_INTEGER start = {};
+    LARGE_INTEGER end = {};
+    QueryPerformanceFrequency(&frequency);
+    const ULONGLONG cyclesStart = ReadThreadCycles();
+    QueryPerformanceCounter(&start);
+    for (ULONGLONG i = 0; i < iterations; ++i) {
+        body(i);
+    }
+    QueryPerformanceCounter(&end);
+    const ULONGLONG cyclesEnd = ReadThreadCycles();
+
+    BenchResult result = {};
+    result.Name = name;
+    result.Iterations = iterations;
+    if (iterations != 0 && frequency.QuadPart != 0) {
+        const double elapsedNs =
+            static_cast<double>(end.QuadPart - start.QuadPart) * 1.0e9 / static_cast<double>(frequency.QuadPart);
+        result.NanosecondsPerOp = elapsedNs / static_cast<double>(iterations);
+        result.CyclesPerOp = static_cast<double>(cyclesEnd - cyclesStart) / static_cast<double>(iterations);
+    }
+    return result;
+}
+
+inline void PrintHeader(const char* title) {
+    std::printf("== %s ==\n", title);
+    std::printf("%-44s %12s %12s %12s\n", "case", "iterations", "ns/op", "cycles/op");
+}
+
+inline void PrintResult(const BenchResult& result) {
+    std::printf(
+        "%-44s %12llu %12.1f %12.1f\n",
+        result.Name,
+        static_cast<unsigned long long>(result.Iterations),
+        result.NanosecondsPerOp,
+        result.CyclesPerOp);
+}
+
+}  // namespace fclmusa::bench
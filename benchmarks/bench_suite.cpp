@@ -0,0 +1,768 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_common.h"
+#include "scene_generators.h"
+
+#include "fclmusa/broadphase.h"
+#include "fclmusa/collision.h"
+#include "fclmusa/distance.h"
+#include "fclmusa/geometry.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/memory/pool_allocator.h"
+#include "fclmusa/platform.h"
+#include "fclmusa/version.h"
+
+//
+// 核心接口综合基准（FclMusaBenchSuite）：
+// - primitive   基本体两两碰撞 / 距离
+// - mesh        球 / 盒 / Mesh 与 1k / 10k / 100k / 1M 三角形 Mesh 的碰撞 / 距离
+// - ccd         线性插值运动的连续碰撞（基本体与 Mesh）
+// - broadphase  100 / 1k / 10k / 100k 个物体的整场景 FclBroadphaseDetect
+// - bvh         Mesh 创建（含 BVH 构建）+ 销毁，FclUpdateMeshGeometry（BVH refit）
+// - churn       几何创建 / 销毁的高频交替，以及 256 个存活句柄的混合轮换
+// - threads     1 / 2 / 4 / ... 个线程并发查询的总吞吐
+// 每个用例先标定批大小（每批至少 20 us），再按批采样直到达到最短时长；延迟分位数取自各批的单次平均值，
+// 因此亚微秒级用例的 p99 / max 反映的是批内平均而不是单次尖刺（单次分布见 FclMusaLatencyHistogramBench）。
+// 每次操作的分配次数 / 字节数来自采样期间池统计的差值。场景全部由 --seed 派生，相同种子结果可比。
+// 用法：FclMusaBenchSuite [--json <path>] [--seed <n>] [--quick] [--min-time <seconds>] [--filter <substring>]
+//                         [--max-triangles <n>] [--max-objects <n>] [--threads <n>]
+//
+
+namespace {
+
+using fclmusa::bench::KeepAlive;
+using fclmusa::bench::scene::CreateRandomPrimitive;
+using fclmusa::bench::scene::DeriveSeed;
+using fclmusa::bench::scene::MakeSphereMesh;
+using fclmusa::bench::scene::MeshData;
+using fclmusa::bench::scene::PerturbVertices;
+using fclmusa::bench::scene::PrimitiveKind;
+using fclmusa::bench::scene::RandomPose;
+using fclmusa::bench::scene::RandomPoses;
+using fclmusa::bench::scene::SceneRandom;
+using fclmusa::geom::IdentityTransform;
+
+constexpr size_t kPoseCount = 64;
+constexpr double kMinBatchSeconds = 20.0e-6;
+constexpr ULONG kMaxSamples = 200000;
+constexpr ULONG kMinSamples = 3;
+constexpr ULONG kMeshSizes[] = {1000, 10000, 100000, 1000000};
+constexpr ULONG kBroadphaseSizes[] = {100, 1000, 10000, 100000};
+constexpr ULONG kChurnLiveCount = 256;
+
+struct Options {
+    std::string JsonPath;
+    ULONGLONG Seed = 20240601;
+    bool Quick = false;
+    double MinSeconds = 0.5;
+    std::string Filter;
+    ULONG MaxTriangles = 1000000;
+    ULONG MaxObjects = 100000;
+    unsigned MaxThreads = 0;  // 0 表示 std::thread::hardware_concurrency
+};
+
+struct CaseResult {
+    std::string Group;
+    std::string Name;
+    ULONGLONG Size = 0;
+    unsigned Threads = 1;
+    ULONGLONG Operations = 0;
+    ULONG Samples = 0;
+    ULONGLONG Batch = 0;
+    double Seconds = 0.0;
+    double OpsPerSecond = 0.0;
+    double MeanNs = 0.0;
+    double P50Ns = 0.0;
+    double P90Ns = 0.0;
+    double P99Ns = 0.0;
+    double MaxNs = 0.0;
+    double AllocationsPerOp = 0.0;
+    double BytesPerOp = 0.0;
+};
+
+struct GeometryHolder {
+    FCL_GEOMETRY_HANDLE Handle = {};
+
+    GeometryHolder() = default;
+    GeometryHolder(const GeometryHolder&) = delete;
+    GeometryHolder& operator=(const GeometryHolder&) = delete;
+
+    ~GeometryHolder() {
+        Reset();
+    }
+
+    void Reset() noexcept {
+        if (Handle.Value != 0) {
+            FclDestroyGeometry(Handle);
+            Handle = {};
+        }
+    }
+};
+
+double NowSeconds() noexcept {
+    LARGE_INTEGER frequency = {};
+    LARGE_INTEGER counter = {};
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return static_cast<double>(counter.QuadPart) / static_cast<double>(frequency.QuadPart);
+}
+
+class BenchSuite {
+public:
+    explicit BenchSuite(const Options& options) : options_(options) {}
+
+    const std::vector<CaseResult>& Results() const noexcept {
+        return results_;
+    }
+
+    ULONGLONG SeedFor(const std::string& group, const std::string& name) const noexcept {
+        return DeriveSeed(options_.Seed, (group + "/" + name).c_str());
+    }
+
+    bool Selected(const std::string& group, const std::string& name) const {
+        return options_.Filter.empty() || (group + "/" + name).find(options_.Filter) != std::string::npos;
+    }
+
+    // names 中任一用例被选中时返回 true，用于在构建大场景之前跳过整组。
+    bool AnySelected(const std::string& group, const std::vector<std::string>& names) const {
+        for (const std::string& name : names) {
+            if (Selected(group, name)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void BeginGroup(const char* group) {
+        std::printf("== %s ==\n", group);
+        std::printf("%-40s %8s %12s %10s %10s %10s %10s %10s\n",
+            "case", "threads", "ops/s", "mean ns", "p50 ns", "p99 ns", "max ns", "allocs/op");
+    }
+
+    // 单线程用例：body(i) 执行一次被测操作。
+    template <typename Fn>
+    void Run(const std::string& group, const std::string& name, ULONGLONG size, Fn&& body) {
+        if (!Selected(group, name)) {
+            return;
+        }
+        const ULONGLONG batch = CalibrateBatch(body);
+        std::vector<double> samples;
+        ULONGLONG index = 0;
+        const FCL_POOL_STATS before = fclmusa::memory::QueryStats();
+        const double start = NowSeconds();
+        double elapsed = 0.0;
+        while ((elapsed < options_.MinSeconds || samples.size() < kMinSamples) && samples.size() < kMaxSamples) {
+            const double batchStart = NowSeconds();
+            for (ULONGLONG i = 0; i < batch; ++i) {
+                body(index++);
+            }
+            const double batchEnd = NowSeconds();
+            samples.push_back((batchEnd - batchStart) * 1.0e9 / static_cast<double>(batch));
+            elapsed = batchEnd - start;
+        }
+        const FCL_POOL_STATS after = fclmusa::memory::QueryStats();
+        Record(group, name, size, 1, batch, index, elapsed, &samples, before, after);
+    }
+
+    // 多线程用例：body(thread, i) 由 threads 个线程并发执行，统计总吞吐；延迟样本合并所有线程的批平均。
+    template <typename Fn>
+    void RunThreaded(const std::string& group, const std::string& name, ULONGLONG size, unsigned threads, Fn&& body) {
+        if (!Selected(group, name)) {
+            return;
+        }
+        const ULONGLONG batch = CalibrateBatch([&](ULONGLONG i) { body(0, i); });
+        std::vector<std::vector<double>> perThread(threads);
+        std::vector<ULONGLONG> operations(threads, 0);
+        std::atomic<unsigned> ready{0};
+        std::atomic<bool> go{false};
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                ready.fetch_add(1);
+                while (!go.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                ULONGLONG index = 0;
+                while (!stop.load(std::memory_order_relaxed) && perThread[t].size() < kMaxSamples) {
+                    const double batchStart = NowSeconds();
+                    for (ULONGLONG i = 0; i < batch; ++i) {
+                        body(t, index++);
+                    }
+                    perThread[t].push_back((NowSeconds() - batchStart) * 1.0e9 / static_cast<double>(batch));
+                }
+                operations[t] = index;
+            });
+        }
+        while (ready.load() != threads) {
+            std::this_thread::yield();
+        }
+        const FCL_POOL_STATS before = fclmusa::memory::QueryStats();
+        const double start = NowSeconds();
+        go.store(true, std::memory_order_release);
+        while (NowSeconds() - start < options_.MinSeconds) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        stop.store(true, std::memory_order_relaxed);
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        const double elapsed = NowSeconds() - start;
+        const FCL_POOL_STATS after = fclmusa::memory::QueryStats();
+
+        std::vector<double> samples;
+        ULONGLONG total = 0;
+        for (unsigned t = 0; t < threads; ++t) {
+            samples.insert(samples.end(), perThread[t].begin(), perThread[t].end());
+            total += operations[t];
+        }
+        Record(group, name, size, threads, batch, total, elapsed, &samples, before, after);
+    }
+
+private:
+    // 从 1 开始倍增，直到一批耗时不少于 kMinBatchSeconds；单次已足够慢的操作（大 Mesh 构建）批大小为 1。
+    template <typename Fn>
+    ULONGLONG CalibrateBatch(Fn&& body) const {
+        ULONGLONG batch = 1;
+        ULONGLONG index = 0;
+        for (;;) {
+            const double start = NowSeconds();
+            for (ULONGLONG i = 0; i < batch; ++i) {
+                body(index++);
+            }
+            if (NowSeconds() - start >= kMinBatchSeconds || batch >= (1ULL << 20)) {
+                return batch;
+            }
+            batch *= 2;
+        }
+    }
+
+    static double Percentile(const std::vector<double>& sorted, double fraction) noexcept {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        const size_t rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+        return sorted[(rank == 0) ? 0 : std::min(rank, sorted.size()) - 1];
+    }
+
+    void Record(const std::string& group,
+        const std::string& name,
+        ULONGLONG size,
+        unsigned threads,
+        ULONGLONG batch,
+        ULONGLONG operations,
+        double seconds,
+        std::vector<double>* samples,
+        const FCL_POOL_STATS& before,
+        const FCL_POOL_STATS& after) {
+        CaseResult result;
+        result.Group = group;
+        result.Name = name;
+        result.Size = size;
+        result.Threads = threads;
+        result.Operations = operations;
+        result.Samples = static_cast<ULONG>(samples->size());
+        result.Batch = batch;
+        result.Seconds = seconds;
+        if (operations != 0 && seconds > 0.0) {
+            result.OpsPerSecond = static_cast<double>(operations) / seconds;
+            result.AllocationsPerOp =
+                static_cast<double>(after.AllocationCount - before.AllocationCount) / static_cast<double>(operations);
+            result.BytesPerOp =
+                static_cast<double>(after.BytesAllocated - before.BytesAllocated) / static_cast<double>(operations);
+        }
+        std::sort(samples->begin(), samples->end());
+        if (!samples->empty()) {
+            double sum = 0.0;
+            for (double sample : *samples) {
+                sum += sample;
+            }
+            result.MeanNs = sum / static_cast<double>(samples->size());
+            result.P50Ns = Percentile(*samples, 0.50);
+            result.P90Ns = Percentile(*samples, 0.90);
+            result.P99Ns = Percentile(*samples, 0.99);
+            result.MaxNs = samples->back();
+        }
+        std::printf("%-40s %8u %12.0f %10.1f %10.1f %10.1f %10.1f %10.2f\n",
+            (group + "/" + name).c_str(),
+            threads,
+            result.OpsPerSecond,
+            result.MeanNs,
+            result.P50Ns,
+            result.P99Ns,
+            result.MaxNs,
+            result.AllocationsPerOp);
+        results_.push_back(std::move(result));
+    }
+
+    const Options& options_;
+    std::vector<CaseResult> results_;
+};
+
+std::string SizeLabel(ULONG count) {
+    if (count >= 1000000 && count % 1000000 == 0) {
+        return std::to_string(count / 1000000) + "m";
+    }
+    if (count >= 1000 && count % 1000 == 0) {
+        return std::to_string(count / 1000) + "k";
+    }
+    return std::to_string(count);
+}
+
+const char* PrimitiveName(PrimitiveKind kind) noexcept {
+    switch (kind) {
+        case PrimitiveKind::Sphere:
+            return "sphere";
+        case PrimitiveKind::Box:
+            return "box";
+        case PrimitiveKind::Capsule:
+            return "capsule";
+        case PrimitiveKind::Cylinder:
+        default:
+            return "cylinder";
+    }
+}
+
+bool CreateMesh(const MeshData& mesh, GeometryHolder* holder) {
+    const FCL_MESH_GEOMETRY_DESC desc = mesh.Desc();
+    return NT_SUCCESS(FclCreateGeometry(FCL_GEOMETRY_MESH, &desc, &holder->Handle));
+}
+
+// object1 固定在原点，object2 按预生成位姿轮换（约一半位姿相交）。
+template <typename Query>
+auto PoseQuery(FCL_GEOMETRY_HANDLE object1, FCL_GEOMETRY_HANDLE object2, const std::vector<FCL_TRANSFORM>& poses,
+    Query query) {
+    return [object1, object2, &poses, query](ULONGLONG i) {
+        query(object1, object2, poses[i % poses.size()]);
+    };
+}
+
+void Collide(FCL_GEOMETRY_HANDLE object1, FCL_GEOMETRY_HANDLE object2, const FCL_TRANSFORM& pose) noexcept {
+    BOOLEAN hit = FALSE;
+    FCL_CONTACT_INFO contact = {};
+    FclCollisionDetect(object1, nullptr, object2, &pose, &hit, &contact);
+    KeepAlive(hit);
+}
+
+void Distance(FCL_GEOMETRY_HANDLE object1, FCL_GEOMETRY_HANDLE object2, const FCL_TRANSFORM& pose) noexcept {
+    FCL_DISTANCE_RESULT result = {};
+    FclDistanceCompute(object1, nullptr, object2, &pose, &result);
+    KeepAlive(result.Distance > 0.0f);
+}
+
+void RunPrimitiveGroup(BenchSuite& suite) {
+    const char* group = "primitive";
+    suite.BeginGroup(group);
+    const PrimitiveKind pairs[][2] = {
+        {PrimitiveKind::Sphere, PrimitiveKind::Sphere},
+        {PrimitiveKind::Sphere, PrimitiveKind::Box},
+        {PrimitiveKind::Box, PrimitiveKind::Box},
+        {PrimitiveKind::Capsule, PrimitiveKind::Box},
+        {PrimitiveKind::Capsule, PrimitiveKind::Capsule},
+        {PrimitiveKind::Cylinder, PrimitiveKind::Sphere},
+    };
+    for (const auto& pair : pairs) {
+        const std::string pairName = std::string(PrimitiveName(pair[0])) + "/" + PrimitiveName(pair[1]);
+        SceneRandom random(suite.SeedFor(group, pairName));
+        GeometryHolder object1;
+        GeometryHolder object2;
+        if (!NT_SUCCESS(CreateRandomPrimitive(random, pair[0], 0.3f, 0.6f, &object1.Handle)) ||
+            !NT_SUCCESS(CreateRandomPrimitive(random, pair[1], 0.3f, 0.6f, &object2.Handle))) {
+            std::fprintf(stderr, "%s/%s: failed to create geometry\n", group, pairName.c_str());
+            continue;
+        }
+        const std::vector<FCL_TRANSFORM> poses = RandomPoses(random, kPoseCount, 1.0f);
+        suite.Run(group, pairName + " collide", 1, PoseQuery(object1.Handle, object2.Handle, poses, Collide));
+        suite.Run(group, pairName + " distance", 1, PoseQuery(object1.Handle, object2.Handle, poses, Distance));
+    }
+}
+
+void RunMeshGroup(BenchSuite& suite, const Options& options) {
+    const char* group = "mesh";
+    suite.BeginGroup(group);
+    for (ULONG triangles : kMeshSizes) {
+        if (triangles > options.MaxTriangles) {
+            continue;
+        }
+        const std::string label = SizeLabel(triangles);
+        const std::string names[] = {
+            "sphere/mesh" + label + " collide",
+            "box/mesh" + label + " collide",
+            "mesh/mesh" + label + " collide",
+            "sphere/mesh" + label + " distance",
+            "mesh/mesh" + label + " distance",
+        };
+        if (!suite.AnySelected(group, {std::begin(names), std::end(names)})) {
+            continue;
+        }
+        SceneRandom random(suite.SeedFor(group, label));
+        const MeshData meshData = MakeSphereMesh(random, triangles, 1.0f, 0.02f);
+        GeometryHolder mesh;
+        GeometryHolder other;
+        GeometryHolder sphere;
+        GeometryHolder box;
+        if (!CreateMesh(meshData, &mesh) || !CreateMesh(meshData, &other) ||
+            !NT_SUCCESS(CreateRandomPrimitive(random, PrimitiveKind::Sphere, 0.2f, 0.4f, &sphere.Handle)) ||
+            !NT_SUCCESS(CreateRandomPrimitive(random, PrimitiveKind::Box, 0.2f, 0.4f, &box.Handle))) {
+            std::fprintf(stderr, "%s/%s: failed to create geometry\n", group, label.c_str());
+            continue;
+        }
+        // 小物体位姿落在球面附近，Mesh 间位姿为部分重叠。
+        const std::vector<FCL_TRANSFORM> shellPoses = RandomPoses(random, kPoseCount, 1.2f);
+        const std::vector<FCL_TRANSFORM> meshPoses = RandomPoses(random, kPoseCount, 1.5f);
+        const ULONGLONG size = meshData.TriangleCount();
+        suite.Run(group, names[0], size, PoseQuery(mesh.Handle, sphere.Handle, shellPoses, Collide));
+        suite.Run(group, names[1], size, PoseQuery(mesh.Handle, box.Handle, shellPoses, Collide));
+        suite.Run(group, names[2], size, PoseQuery(mesh.Handle, other.Handle, meshPoses, Collide));
+        suite.Run(group, names[3], size, PoseQuery(mesh.Handle, sphere.Handle, shellPoses, Distance));
+        suite.Run(group, names[4], size, PoseQuery(mesh.Handle, other.Handle, meshPoses, Distance));
+    }
+}
+
+void RunCcdGroup(BenchSuite& suite, const Options& options) {
+    const char* group = "ccd";
+    suite.BeginGroup(group);
+    SceneRandom random(suite.SeedFor(group, "scene"));
+    GeometryHolder sphere;
+    GeometryHolder boxA;
+    GeometryHolder boxB;
+    GeometryHolder mesh;
+    const bool meshEnabled = options.MaxTriangles >= kMeshSizes[0];
+    if (!NT_SUCCESS(CreateRandomPrimitive(random, PrimitiveKind::Sphere, 0.3f, 0.5f, &sphere.Handle)) ||
+        !NT_SUCCESS(CreateRandomPrimitive(random, PrimitiveKind::Box, 0.3f, 0.5f, &boxA.Handle)) ||
+        !NT_SUCCESS(CreateRandomPrimitive(random, PrimitiveKind::Box, 0.3f, 0.5f, &boxB.Handle)) ||
+        (meshEnabled && !CreateMesh(MakeSphereMesh(random, kMeshSizes[0], 1.0f, 0.02f), &mesh))) {
+        std::fprintf(stderr, "%s: failed to create geometry\n", group);
+        return;
+    }
+
+    // object1 静止在原点，object2 从一侧随机位置运动到另一侧随机位置，约一半轨迹穿过 object1。
+    std::vector<FCL_INTERP_MOTION> motions(kPoseCount);
+    for (FCL_INTERP_MOTION& motion : motions) {
+        FCL_INTERP_MOTION_DESC desc = {};
+        desc.Start = RandomPose(random, 1.0f);
+        desc.End = RandomPose(random, 1.0f);
+        desc.Start.Translation.X -= 2.5f;
+        desc.End.Translation.X += 2.5f;
+        FclInterpMotionInitialize(&desc, &motion);
+    }
+    FCL_INTERP_MOTION stationary = {};
+    FCL_INTERP_MOTION_DESC stationaryDesc = {};
+    stationaryDesc.Start = IdentityTransform();
+    stationaryDesc.End = IdentityTransform();
+    FclInterpMotionInitialize(&stationaryDesc, &stationary);
+
+    auto ccd = [&motions, stationary](FCL_GEOMETRY_HANDLE object1, FCL_GEOMETRY_HANDLE object2) {
+        return [&motions, stationary, object1, object2](ULONGLONG i) {
+            FCL_CONTINUOUS_COLLISION_QUERY query = {};
+            query.Object1 = object1;
+            query.Motion1 = stationary;
+            query.Object2 = object2;
+            query.Motion2 = motions[i % motions.size()];
+            query.Tolerance = 1.0e-4;
+            query.MaxIterations = 64;
+            FCL_CONTINUOUS_COLLISION_RESULT result = {};
+            FclContinuousCollision(&query, &result);
+            KeepAlive(result.Intersecting);
+        };
+    };
+    suite.Run(group, "sphere/sphere linear", 1, ccd(sphere.Handle, sphere.Handle));
+    suite.Run(group, "box/box linear", 1, ccd(boxA.Handle, boxB.Handle));
+    suite.Run(group, "sphere/box linear", 1, ccd(boxA.Handle, sphere.Handle));
+    if (meshEnabled) {
+        suite.Run(group, "sphere/mesh1k linear", kMeshSizes[0], ccd(mesh.Handle, sphere.Handle));
+    }
+}
+
+void RunBroadphaseGroup(BenchSuite& suite, const Options& options) {
+    const char* group = "broadphase";
+    suite.BeginGroup(group);
+    for (ULONG count : kBroadphaseSizes) {
+        if (count > options.MaxObjects) {
+            continue;
+        }
+        const std::string name = SizeLabel(count) + " objects";
+        if (!suite.Selected(group, name)) {
+            continue;
+        }
+        // 边长随 cbrt(count) 增长，平均每个物体的候选对数量与场景规模无关。
+        SceneRandom random(suite.SeedFor(group, name));
+        const float extent = 0.75f * static_cast<float>(std::cbrt(static_cast<double>(count)));
+        std::vector<GeometryHolder> holders(count);
+        std::vector<FCL_TRANSFORM> poses(count);
+        std::vector<FCL_BROADPHASE_OBJECT> objects(count);
+        bool created = true;
+        for (ULONG i = 0; i < count && created; ++i) {
+            const PrimitiveKind kind = (i & 1) ? PrimitiveKind::Box : PrimitiveKind::Sphere;
+            created = NT_SUCCESS(CreateRandomPrimitive(random, kind, 0.2f, 0.5f, &holders[i].Handle));
+            poses[i] = RandomPose(random, extent);
+            objects[i].Handle = holders[i].Handle;
+            objects[i].Transform = &poses[i];
+        }
+        if (!created) {
+            std::fprintf(stderr, "%s/%s: failed to create geometry\n", group, name.c_str());
+            continue;
+        }
+        std::vector<FCL_BROADPHASE_PAIR> pairs(static_cast<size_t>(count) * 8);
+        suite.Run(group, name, count, [&](ULONGLONG) {
+            ULONG pairCount = 0;
+            FclBroadphaseDetect(
+                objects.data(), count, pairs.data(), static_cast<ULONG>(pairs.size()), &pairCount);
+            KeepAlive(pairCount);
+        });
+    }
+}
+
+void RunBvhGroup(BenchSuite& suite, const Options& options) {
+    const char* group = "bvh";
+    suite.BeginGroup(group);
+    for (ULONG triangles : kMeshSizes) {
+        if (triangles > options.MaxTriangles) {
+            continue;
+        }
+        const std::string label = SizeLabel(triangles);
+        if (!suite.AnySelected(group, {"build mesh" + label, "update mesh" + label})) {
+            continue;
+        }
+        SceneRandom random(suite.SeedFor(group, label));
+        const MeshData meshData = MakeSphereMesh(random, triangles, 1.0f, 0.02f);
+        const ULONGLONG size = meshData.TriangleCount();
+        suite.Run(group, "build mesh" + label, size, [&](ULONGLONG) {
+            GeometryHolder mesh;
+            KeepAlive(CreateMesh(meshData, &mesh));
+        });
+
+        // 在两组同拓扑的扰动顶点之间交替更新，每次都触发 refit。
+        GeometryHolder mesh;
+        if (!CreateMesh(meshData, &mesh)) {
+            std::fprintf(stderr, "%s/%s: failed to create geometry\n", group, label.c_str());
+            continue;
+        }
+        const std::vector<FCL_VECTOR3> deformed[2] = {
+            PerturbVertices(random, meshData.Vertices, 0.01f),
+            PerturbVertices(random, meshData.Vertices, 0.01f),
+        };
+        suite.Run(group, "update mesh" + label, size, [&](ULONGLONG i) {
+            FCL_MESH_GEOMETRY_DESC desc = meshData.Desc();
+            desc.Vertices = deformed[i & 1].data();
+            KeepAlive(NT_SUCCESS(FclUpdateMeshGeometry(mesh.Handle, &desc)));
+        });
+    }
+}
+
+void RunChurnGroup(BenchSuite& suite, const Options& options) {
+    const char* group = "churn";
+    suite.BeginGroup(group);
+    SceneRandom random(suite.SeedFor(group, "scene"));
+    for (PrimitiveKind kind : {PrimitiveKind::Sphere, PrimitiveKind::Box, PrimitiveKind::Capsule}) {
+        suite.Run(group, std::string(PrimitiveName(kind)) + " create+destroy", 1, [&random, kind](ULONGLONG) {
+            GeometryHolder holder;
+            KeepAlive(NT_SUCCESS(CreateRandomPrimitive(random, kind, 0.2f, 0.5f, &holder.Handle)));
+        });
+    }
+    if (options.MaxTriangles >= kMeshSizes[0]) {
+        const MeshData meshData = MakeSphereMesh(random, kMeshSizes[0], 1.0f, 0.02f);
+        suite.Run(group, "mesh1k create+destroy", meshData.TriangleCount(), [&meshData](ULONGLONG) {
+            GeometryHolder holder;
+            KeepAlive(CreateMesh(meshData, &holder));
+        });
+    }
+
+    // 固定数量的存活句柄，每次销毁最旧的一个并创建随机类型的新几何（句柄表与 slab 的稳态轮换）。
+    std::vector<GeometryHolder> ring(kChurnLiveCount);
+    for (GeometryHolder& holder : ring) {
+        CreateRandomPrimitive(random, PrimitiveKind::Sphere, 0.2f, 0.5f, &holder.Handle);
+    }
+    suite.Run(group, "mixed ring (256 live)", kChurnLiveCount, [&](ULONGLONG i) {
+        GeometryHolder& slot = ring[i % ring.size()];
+        slot.Reset();
+        const PrimitiveKind kind = static_cast<PrimitiveKind>(random.Next() % 4);
+        KeepAlive(NT_SUCCESS(CreateRandomPrimitive(random, kind, 0.2f, 0.5f, &slot.Handle)));
+    });
+}
+
+void RunThreadGroup(BenchSuite& suite, const Options& options) {
+    const char* group = "threads";
+    suite.BeginGroup(group);
+    unsigned maxThreads = options.MaxThreads;
+    if (maxThreads == 0) {
+        maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    SceneRandom random(suite.SeedFor(group, "scene"));
+    GeometryHolder boxA;
+    GeometryHolder boxB;
+    GeometryHolder sphere;
+    GeometryHolder mesh;
+    const ULONG meshTriangles = (options.MaxTriangles >= kMeshSizes[1]) ? kMeshSizes[1] : kMeshSizes[0];
+    const MeshData meshData = MakeSphereMesh(random, meshTriangles, 1.0f, 0.02f);
+    if (!NT_SUCCESS(CreateRandomPrimitive(random, PrimitiveKind::Box, 0.3f, 0.6f, &boxA.Handle)) ||
+        !NT_SUCCESS(CreateRandomPrimitive(random, PrimitiveKind::Box, 0.3f, 0.6f, &boxB.Handle)) ||
+        !NT_SUCCESS(CreateRandomPrimitive(random, PrimitiveKind::Sphere, 0.2f, 0.4f, &sphere.Handle)) ||
+        !CreateMesh(meshData, &mesh)) {
+        std::fprintf(stderr, "%s: failed to create geometry\n", group);
+        return;
+    }
+    const std::vector<FCL_TRANSFORM> poses = RandomPoses(random, kPoseCount, 1.2f);
+    const std::string meshName = "sphere/mesh" + SizeLabel(meshTriangles) + " collide";
+
+    // 各线程从不同位姿下标开始，避免所有线程始终查询同一位姿。
+    for (unsigned threads : threadCounts) {
+        suite.RunThreaded(group, "box/box collide", 1, threads, [&](unsigned thread, ULONGLONG i) {
+            Collide(boxA.Handle, boxB.Handle, poses[(i + thread * 7) % poses.size()]);
+        });
+    }
+    for (unsigned threads : threadCounts) {
+        suite.RunThreaded(group, meshName, meshData.TriangleCount(), threads, [&](unsigned thread, ULONGLONG i) {
+            Collide(mesh.Handle, sphere.Handle, poses[(i + thread * 7) % poses.size()]);
+        });
+    }
+}
+
+void WriteJsonString(std::ofstream& out, const std::string& value) {
+    out << '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+bool WriteJson(const std::string& path, const Options& options, const std::vector<CaseResult>& results) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    char version[64] = {};
+    std::snprintf(version, sizeof(version), "%u.%u.%u.%u",
+        FCL_MUSA_DRIVER_VERSION_MAJOR,
+        FCL_MUSA_DRIVER_VERSION_MINOR,
+        FCL_MUSA_DRIVER_VERSION_PATCH,
+        FCL_MUSA_DRIVER_VERSION_BUILD);
+    out.precision(17);
+    out << "{\n  \"suite\": \"FclMusaBenchSuite\",\n  \"schemaVersion\": 1,\n  \"version\": \"" << version
+        << "\",\n  \"seed\": " << options.Seed << ",\n  \"quick\": " << (options.Quick ? "true" : "false")
+        << ",\n  \"minSeconds\": " << options.MinSeconds << ",\n  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const CaseResult& result = results[i];
+        out << ((i == 0) ? "\n" : ",\n") << "    {\"group\": ";
+        WriteJsonString(out, result.Group);
+        out << ", \"name\": ";
+        WriteJsonString(out, result.Name);
+        out << ", \"size\": " << result.Size << ", \"threads\": " << result.Threads
+            << ", \"operations\": " << result.Operations << ", \"samples\": " << result.Samples
+            << ", \"batch\": " << result.Batch << ", \"seconds\": " << result.Seconds
+            << ", \"opsPerSecond\": " << result.OpsPerSecond << ", \"latencyNs\": {\"mean\": " << result.MeanNs
+            << ", \"p50\": " << result.P50Ns << ", \"p90\": " << result.P90Ns << ", \"p99\": " << result.P99Ns
+            << ", \"max\": " << result.MaxNs << "}, \"allocationsPerOp\": " << result.AllocationsPerOp
+            << ", \"bytesPerOp\": " << result.BytesPerOp << "}";
+    }
+    out << "\n  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+void PrintUsage(const char* program) {
+    std::fprintf(stderr,
+        "usage: %s [--json <path>] [--seed <n>] [--quick] [--min-time <seconds>] [--filter <substring>]\n"
+        "          [--max-triangles <n>] [--max-objects <n>] [--threads <n>]\n",
+        program);
+}
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--quick") {
+            options->Quick = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--json") {
+            options->JsonPath = value;
+        } else if (arg == "--seed") {
+            options->Seed = std::strtoull(value, nullptr, 0);
+        } else if (arg == "--min-time") {
+            options->MinSeconds = std::strtod(value, nullptr);
+        } else if (arg == "--filter") {
+            options->Filter = value;
+        } else if (arg == "--max-triangles") {
+            options->MaxTriangles = static_cast<ULONG>(std::strtoul(value, nullptr, 10));
+        } else if (arg == "--max-objects") {
+            options->MaxObjects = static_cast<ULONG>(std::strtoul(value, nullptr, 10));
+        } else if (arg == "--threads") {
+            options->MaxThreads = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        } else {
+            return false;
+        }
+    }
+    return options->MinSeconds > 0.0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, &options)) {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    // --quick：CI / 冒烟用，规模上限与采样时长分别与显式参数取较小值。
+    if (options.Quick) {
+        options.MaxTriangles = std::min<ULONG>(options.MaxTriangles, 10000);
+        options.MaxObjects = std::min<ULONG>(options.MaxObjects, 10000);
+        options.MinSeconds = std::min(options.MinSeconds, 0.05);
+    }
+
+    if (!NT_SUCCESS(FclGeometrySubsystemInitialize())) {
+        std::fprintf(stderr, "FclGeometrySubsystemInitialize failed\n");
+        return EXIT_FAILURE;
+    }
+    fclmusa::memory::EnablePoolTracking(TRUE);
+
+    std::vector<CaseResult> results;
+    {
+        BenchSuite suite(options);
+        std::printf("FclMusaBenchSuite seed %llu, min %.2f s per case%s\n",
+            options.Seed,
+            options.MinSeconds,
+            options.Quick ? " (quick)" : "");
+        RunPrimitiveGroup(suite);
+        RunMeshGroup(suite, options);
+        RunCcdGroup(suite, options);
+        RunBroadphaseGroup(suite, options);
+        RunBvhGroup(suite, options);
+        RunChurnGroup(suite, options);
+        RunThreadGroup(suite, options);
+        results = suite.Results();
+    }
+
+    fclmusa::memory::EnablePoolTracking(FALSE);
+    FclGeometrySubsystemShutdown();
+
+    if (!options.JsonPath.empty()) {
+        if (!WriteJson(options.JsonPath, options, results)) {
+            std::fprintf(stderr, "failed to write %s\n", options.JsonPath.c_str());
+            return EXIT_FAILURE;
+        }
+        std::printf("wrote %zu results to %s\n", results.size(), options.JsonPath.c_str());
+    }
+    return EXIT_SUCCESS;
+}
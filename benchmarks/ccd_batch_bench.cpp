@@ -0,0 +1,166 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "bench_common.h"
+
+#include "fclmusa/collision.h"
+#include "fclmusa/geometry.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/platform.h"
+
+//
+// 批量 CCD 基准：N 个运动对象每帧一次，对比逐对 N(N-1)/2 次 CCD 与扫掠 AABB 宽阶段 + 候选对 CCD。
+// 对象排成网格，球 / 盒交替，每帧以确定性伪随机速度运动；部分盒体带旋转以覆盖保守推进路径。
+// 用法：FclMusaCcdBatchBench [ticks] [objects]
+//
+
+namespace {
+
+using fclmusa::bench::KeepAlive;
+using fclmusa::bench::Measure;
+using fclmusa::bench::PrintHeader;
+using fclmusa::bench::PrintResult;
+using fclmusa::geom::IdentityTransform;
+
+constexpr float kGridSpacing = 2.0f;
+constexpr float kMaxStep = 1.2f;
+
+struct ShapeHolder {
+    FCL_GEOMETRY_HANDLE Handle = {};
+    FCL_GEOMETRY_REFERENCE Reference = {};
+    FCL_GEOMETRY_SNAPSHOT Snapshot = {};
+
+    ~ShapeHolder() {
+        FclReleaseGeometryReference(&Reference);
+        if (Handle.Value != 0) {
+            FclDestroyGeometry(Handle);
+        }
+    }
+};
+
+bool Acquire(FCL_GEOMETRY_TYPE type, const void* desc, ShapeHolder* holder) {
+    return NT_SUCCESS(FclCreateGeometry(type, desc, &holder->Handle)) &&
+           NT_SUCCESS(FclAcquireGeometryReference(holder->Handle, &holder->Reference, &holder->Snapshot));
+}
+
+float NextUnit(ULONG* state) noexcept {
+    *state = *state * 1664525u + 1013904223u;
+    return static_cast<float>(*state >> 8) / static_cast<float>(1u << 24) * 2.0f - 1.0f;
+}
+
+void BuildScene(
+    ULONG objectCount,
+    const ShapeHolder& sphere,
+    const ShapeHolder& box,
+    std::vector<FCL_CONTINUOUS_BATCH_OBJECT>* objects,
+    std::vector<const FCL_GEOMETRY_SNAPSHOT*>* snapshots) {
+    ULONG columns = 1;
+    while (columns * columns < objectCount) {
+        ++columns;
+    }
+    ULONG state = 12345u;
+    objects->resize(objectCount);
+    snapshots->resize(objectCount);
+    for (ULONG i = 0; i < objectCount; ++i) {
+        const bool isBox = (i % 2) != 0;
+        const FCL_VECTOR3 origin = {
+            static_cast<float>(i % columns) * kGridSpacing,
+            static_cast<float>(i / columns) * kGridSpacing,
+            0.0f};
+        const FCL_VECTOR3 step = {NextUnit(&state) * kMaxStep, NextUnit(&state) * kMaxStep, 0.0f};
+        FCL_CONTINUOUS_BATCH_OBJECT& object = (*objects)[i];
+        object.Handle = isBox ? box.Handle : sphere.Handle;
+        object.Motion.Start = IdentityTransform();
+        object.Motion.Start.Translation = origin;
+        object.Motion.End = object.Motion.Start;
+        object.Motion.End.Translation = fclmusa::geom::Add(origin, step);
+        if (isBox && (i % 8) == 1) {
+            object.Motion.End.Rotation = fclmusa::geom::RotationMatrixFromAxisAngle({0.0f, 0.0f, 1.0f}, 0.5f);
+        }
+        (*snapshots)[i] = isBox ? &box.Snapshot : &sphere.Snapshot;
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ULONGLONG ticks = 20;
+    ULONG objectCount = 500;
+    if (argc > 1) {
+        ticks = std::strtoull(argv[1], nullptr, 10);
+    }
+    if (argc > 2) {
+        objectCount = static_cast<ULONG>(std::strtoul(argv[2], nullptr, 10));
+    }
+    if (ticks == 0 || objectCount < 2) {
+        std::fprintf(stderr, "usage: %s [ticks] [objects]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (!NT_SUCCESS(FclGeometrySubsystemInitialize())) {
+        std::fprintf(stderr, "FclGeometrySubsystemInitialize failed\n");
+        return EXIT_FAILURE;
+    }
+
+    int exitCode = EXIT_SUCCESS;
+    {
+        ShapeHolder sphere;
+        ShapeHolder box;
+        FCL_SPHERE_GEOMETRY_DESC sphereDesc = {};
+        sphereDesc.Radius = 0.5f;
+        FCL_OBB_GEOMETRY_DESC boxDesc = {};
+        boxDesc.Extents = {0.4f, 0.4f, 0.4f};
+        boxDesc.Rotation = IdentityTransform().Rotation;
+        if (!Acquire(FCL_GEOMETRY_SPHERE, &sphereDesc, &sphere) || !Acquire(FCL_GEOMETRY_OBB, &boxDesc, &box)) {
+            std::fprintf(stderr, "failed to create benchmark geometry\n");
+            exitCode = EXIT_FAILURE;
+        } else {
+            std::vector<FCL_CONTINUOUS_BATCH_OBJECT> objects;
+            std::vector<const FCL_GEOMETRY_SNAPSHOT*> snapshots;
+            BuildScene(objectCount, sphere, box, &objects, &snapshots);
+
+            FCL_CONTINUOUS_BATCH_QUERY query = {};
+            query.Objects = objects.data();
+            query.ObjectCount = objectCount;
+            std::vector<FCL_CONTINUOUS_BATCH_HIT> hits(objectCount);
+            FCL_CONTINUOUS_BATCH_RESULT summary = {};
+            if (!NT_SUCCESS(FclContinuousCollisionBatch(&query, hits.data(), &summary))) {
+                std::fprintf(stderr, "FclContinuousCollisionBatch failed\n");
+                exitCode = EXIT_FAILURE;
+            } else {
+                char title[128] = {};
+                std::snprintf(
+                    title,
+                    sizeof(title),
+                    "batched CCD: %lu objects, %lu candidate pairs, %lu hits",
+                    objectCount,
+                    summary.CandidatePairCount,
+                    summary.HitPairCount);
+                PrintHeader(title);
+
+                PrintResult(Measure("pairwise N^2 CCD", ticks, [&](ULONGLONG) {
+                    ULONG hitCount = 0;
+                    for (ULONG i = 0; i < objectCount; ++i) {
+                        for (ULONG j = i + 1; j < objectCount; ++j) {
+                            FCL_CONTINUOUS_COLLISION_RESULT result = {};
+                            FclContinuousCollisionCoreFromSnapshots(
+                                snapshots[i], &objects[i].Motion, snapshots[j], &objects[j].Motion, 0.0, 0, &result);
+                            hitCount += result.Intersecting ? 1 : 0;
+                        }
+                    }
+                    KeepAlive(hitCount);
+                }));
+
+                PrintResult(Measure("swept AABB + batch CCD", ticks, [&](ULONGLONG) {
+                    FCL_CONTINUOUS_BATCH_RESULT result = {};
+                    FclContinuousCollisionBatch(&query, hits.data(), &result);
+                    KeepAlive(result.HitPairCount);
+                }));
+            }
+        }
+    }
+
+    FclGeometrySubsystemShutdown();
+    return exitCode;
+}
@@ -0,0 +1,209 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "bench_common.h"
+
+#include "fclmusa/collision.h"
+#include "fclmusa/geometry.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/memory/pool_allocator.h"
+#include "fclmusa/memory/query_arena.h"
+#include "fclmusa/narrowphase/libccd_memory.h"
+#include "fclmusa/platform.h"
+#include "fclmusa/solver.h"
+#include "fclmusa/upstream/upstream_bridge.h"
+
+//
+// libccd 对象池基准：
+// 1. 经 libccd 钩子按 EPA 多面体扩张的模式分配 / 释放顶点、边、面（每步删 1 个面、加 1 个顶点、3 条边、3 个面），
+//    对象池关闭 / 启用时的耗时与每次查询的池分配次数
+// 2. 深穿透的凸包 / 凸包、凸包 / 盒体 upstream 碰撞（libccd 求解器，带接触信息）在对象池关闭 / 启用时的耗时、
+//    每次查询的池分配次数与对象池复用情况
+// 两组都关闭查询 arena，使每次分配直接体现为池分配。
+// 用法：FclMusaCcdObjectPoolBench [iterations]
+//
+
+namespace {
+
+using fclmusa::bench::KeepAlive;
+using fclmusa::bench::Measure;
+using fclmusa::bench::PrintHeader;
+using fclmusa::bench::PrintResult;
+using fclmusa::geom::IdentityTransform;
+
+constexpr ULONG kEpaSteps = 64;
+constexpr ULONG kSphereSegments = 12;
+constexpr ULONGLONG kPoseCount = 64;
+constexpr size_t kVertexBytes = 152;
+constexpr size_t kEdgeBytes = 120;
+constexpr size_t kFaceBytes = 80;
+
+struct ShapeHolder {
+    FCL_GEOMETRY_HANDLE Handle = {};
+    FCL_GEOMETRY_REFERENCE Reference = {};
+    FCL_GEOMETRY_SNAPSHOT Snapshot = {};
+
+    ~ShapeHolder() {
+        FclReleaseGeometryReference(&Reference);
+        if (Handle.Value != 0) {
+            FclDestroyGeometry(Handle);
+        }
+    }
+};
+
+bool Acquire(FCL_GEOMETRY_TYPE type, const void* desc, ShapeHolder* holder) {
+    return NT_SUCCESS(FclCreateGeometry(type, desc, &holder->Handle)) &&
+           NT_SUCCESS(FclAcquireGeometryReference(holder->Handle, &holder->Reference, &holder->Snapshot));
+}
+
+bool CreateSphereHull(float radius, ShapeHolder* holder) {
+    std::vector<FCL_VECTOR3> points;
+    const float pi = 3.14159265f;
+    for (ULONG i = 0; i <= kSphereSegments; ++i) {
+        const float theta = pi * static_cast<float>(i) / static_cast<float>(kSphereSegments);
+        for (ULONG j = 0; j < kSphereSegments; ++j) {
+            const float phi = 2.0f * pi * static_cast<float>(j) / static_cast<float>(kSphereSegments);
+            points.push_back({radius * std::sin(theta) * std::cos(phi),
+                radius * std::sin(theta) * std::sin(phi),
+                radius * std::cos(theta)});
+        }
+    }
+    FCL_CONVEX_GEOMETRY_DESC desc = {};
+    desc.Points = points.data();
+    desc.PointCount = static_cast<ULONG>(points.size());
+    return Acquire(FCL_GEOMETRY_CONVEX, &desc, holder);
+}
+
+bool CreateBox(float halfExtent, ShapeHolder* holder) {
+    FCL_OBB_GEOMETRY_DESC desc = {};
+    desc.Extents = {halfExtent, halfExtent, halfExtent};
+    desc.Rotation = IdentityTransform().Rotation;
+    return Acquire(FCL_GEOMETRY_OBB, &desc, holder);
+}
+
+// 中心距离不超过半径之和的一半，穿透深度远大于求解器容差。
+FCL_TRANSFORM DeepPose(ULONGLONG iteration) noexcept {
+    FCL_TRANSFORM transform = IdentityTransform();
+    const float angle = 2.0f * 3.14159265f * static_cast<float>(iteration % kPoseCount) / static_cast<float>(kPoseCount);
+    transform.Translation = {0.3f * std::cos(angle), 0.3f * std::sin(angle), 0.1f};
+    return transform;
+}
+
+// 一次查询内的 EPA 多面体生命周期：初始四面体，逐步扩张，结束时全部释放。
+void SimulateEpa() {
+    fclmusa::narrowphase::CcdObjectPoolScope scope;
+    std::vector<void*> live;
+    live.reserve(4 + 6 + 4 + kEpaSteps * 7);
+    std::vector<void*> faces;
+    faces.reserve(4 + kEpaSteps * 3);
+    for (int i = 0; i < 4; ++i) {
+        live.push_back(FclCcdRealloc(nullptr, kVertexBytes));
+    }
+    for (int i = 0; i < 6; ++i) {
+        live.push_back(FclCcdRealloc(nullptr, kEdgeBytes));
+    }
+    for (int i = 0; i < 4; ++i) {
+        faces.push_back(FclCcdRealloc(nullptr, kFaceBytes));
+    }
+    for (ULONG step = 0; step < kEpaSteps; ++step) {
+        FclCcdFree(faces.back());
+        faces.pop_back();
+        live.push_back(FclCcdRealloc(nullptr, kVertexBytes));
+        for (int i = 0; i < 3; ++i) {
+            live.push_back(FclCcdRealloc(nullptr, kEdgeBytes));
+            faces.push_back(FclCcdRealloc(nullptr, kFaceBytes));
+        }
+    }
+    for (void* face : faces) {
+        FclCcdFree(face);
+    }
+    for (void* object : live) {
+        FclCcdFree(object);
+    }
+}
+
+template <typename Fn>
+void RunCase(const char* label, ULONGLONG iterations, Fn&& query) {
+    char name[96] = {};
+    for (int enabled = 0; enabled < 2; ++enabled) {
+        fclmusa::narrowphase::EnableCcdObjectPool(enabled ? TRUE : FALSE);
+        std::snprintf(name, sizeof(name), "%s (ccd pool %s)", label, enabled ? "on" : "off");
+        PrintResult(Measure(name, iterations, query));
+
+        fclmusa::narrowphase::ResetCcdObjectPoolStats();
+        const FCL_POOL_STATS before = fclmusa::memory::QueryStats();
+        for (ULONGLONG i = 0; i < kPoseCount; ++i) {
+            query(i);
+        }
+        const FCL_POOL_STATS after = fclmusa::memory::QueryStats();
+        const FCL_CCD_POOL_STATS pool = fclmusa::narrowphase::QueryCcdObjectPoolStats();
+        std::printf("  %-44s pool allocations/query = %.2f, pooled objects/query = %.2f (%.0f%% recycled)\n",
+            name,
+            static_cast<double>(after.AllocationCount - before.AllocationCount) / static_cast<double>(kPoseCount),
+            static_cast<double>(pool.ObjectAllocations) / static_cast<double>(kPoseCount),
+            (pool.ObjectAllocations != 0)
+                ? 100.0 * static_cast<double>(pool.RecycledAllocations) / static_cast<double>(pool.ObjectAllocations)
+                : 0.0);
+    }
+    fclmusa::narrowphase::EnableCcdObjectPool(TRUE);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ULONGLONG iterations = 20000;
+    if (argc > 1) {
+        iterations = std::strtoull(argv[1], nullptr, 10);
+        if (iterations == 0) {
+            std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!NT_SUCCESS(FclGeometrySubsystemInitialize())) {
+        std::fprintf(stderr, "FclGeometrySubsystemInitialize failed\n");
+        return EXIT_FAILURE;
+    }
+    fclmusa::memory::EnablePoolTracking(TRUE);
+    fclmusa::memory::EnableQueryArena(FALSE);
+
+    int exitCode = EXIT_SUCCESS;
+    {
+        ShapeHolder hull;
+        ShapeHolder box;
+        if (!CreateSphereHull(0.6f, &hull) || !CreateBox(0.5f, &box)) {
+            std::fprintf(stderr, "failed to create benchmark geometry\n");
+            exitCode = EXIT_FAILURE;
+        } else {
+            const FCL_TRANSFORM origin = IdentityTransform();
+            FCL_SOLVER_OPTIONS solver = {};
+            solver.Solver = FCL_GJK_SOLVER_LIBCCD;
+            PrintHeader("libccd object pool: EPA polytope allocations with / without the per-query pool");
+
+            RunCase("simulated EPA polytope", iterations, [&](ULONGLONG) {
+                SimulateEpa();
+            });
+
+            RunCase("hull/hull deep contact", iterations, [&](ULONGLONG i) {
+                BOOLEAN hit = FALSE;
+                FCL_CONTACT_INFO contact = {};
+                FclUpstreamCollide(hull.Snapshot, origin, hull.Snapshot, DeepPose(i), &hit, &contact, &solver);
+                KeepAlive(hit);
+            });
+
+            RunCase("hull/box deep contact", iterations, [&](ULONGLONG i) {
+                BOOLEAN hit = FALSE;
+                FCL_CONTACT_INFO contact = {};
+                FclUpstreamCollide(hull.Snapshot, origin, box.Snapshot, DeepPose(i), &hit, &contact, &solver);
+                KeepAlive(hit);
+            });
+        }
+    }
+
+    fclmusa::memory::EnableQueryArena(TRUE);
+    fclmusa::memory::EnablePoolTracking(FALSE);
+    FclGeometrySubsystemShutdown();
+    return exitCode;
+}
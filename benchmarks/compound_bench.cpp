@@ -0,0 +1,184 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "bench_common.h"
+
+#include "fclmusa/collision.h"
+#include "fclmusa/distance.h"
+#include "fclmusa/geometry.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/platform.h"
+
+//
+// 复合几何基准：30 个刚性连接的基本体（夹爪）分别以 30 个独立句柄和 1 个 FCL_GEOMETRY_COMPOUND 注册，
+// 对一个移动的盒体执行碰撞与距离查询。独立句柄每帧需要为每个零件合成世界变换并逐个查询。
+// 用法：FclMusaCompoundBench [iterations]
+//
+
+namespace {
+
+using fclmusa::bench::KeepAlive;
+using fclmusa::bench::Measure;
+using fclmusa::bench::PrintHeader;
+using fclmusa::bench::PrintResult;
+using fclmusa::geom::IdentityTransform;
+using fclmusa::geom::MultiplyMatrix;
+using fclmusa::geom::TransformPoint;
+
+constexpr ULONG kPartCount = 30;
+constexpr ULONG kPoseCount = 64;
+
+struct GeometryHolder {
+    FCL_GEOMETRY_HANDLE Handle = {};
+
+    ~GeometryHolder() {
+        if (Handle.Value != 0) {
+            FclDestroyGeometry(Handle);
+        }
+    }
+};
+
+FCL_TRANSFORM Compose(const FCL_TRANSFORM& outer, const FCL_TRANSFORM& inner) {
+    FCL_TRANSFORM result = {};
+    result.Rotation = MultiplyMatrix(outer.Rotation, inner.Rotation);
+    result.Translation = TransformPoint(outer, inner.Translation);
+    return result;
+}
+
+// 两根 15 节的手指：偶数零件为盒体指节，奇数零件为关节球。
+bool CreateParts(GeometryHolder (&parts)[kPartCount], FCL_COMPOUND_CHILD_DESC (&children)[kPartCount]) {
+    for (ULONG i = 0; i < kPartCount; ++i) {
+        const ULONG finger = i / 15;
+        const ULONG joint = i % 15;
+        NTSTATUS status = STATUS_SUCCESS;
+        if ((joint % 2) == 0) {
+            FCL_OBB_GEOMETRY_DESC desc = {};
+            desc.Extents = {0.05f, 0.05f, 0.04f};
+            desc.Rotation = IdentityTransform().Rotation;
+            status = FclCreateGeometry(FCL_GEOMETRY_OBB, &desc, &parts[i].Handle);
+        } else {
+            FCL_SPHERE_GEOMETRY_DESC desc = {};
+            desc.Radius = 0.04f;
+            status = FclCreateGeometry(FCL_GEOMETRY_SPHERE, &desc, &parts[i].Handle);
+        }
+        if (!NT_SUCCESS(status)) {
+            return false;
+        }
+        children[i].Geometry = parts[i].Handle;
+        children[i].LocalTransform = IdentityTransform();
+        children[i].LocalTransform.Translation = {finger == 0 ? -0.15f : 0.15f, 0.0f, 0.08f * static_cast<float>(joint)};
+    }
+    return true;
+}
+
+// 夹爪绕 Z 轴摆动并沿 X 往返，盒体障碍物固定在原点附近，约一半位姿与某根手指相交。
+std::vector<FCL_TRANSFORM> BuildPoses() {
+    std::vector<FCL_TRANSFORM> poses(kPoseCount);
+    for (ULONG i = 0; i < kPoseCount; ++i) {
+        const float angle = 6.2831853f * static_cast<float>(i) / static_cast<float>(kPoseCount);
+        const float c = std::cos(angle * 0.5f);
+        const float s = std::sin(angle * 0.5f);
+        poses[i] = IdentityTransform();
+        poses[i].Rotation = {{{c, -s, 0.0f}, {s, c, 0.0f}, {0.0f, 0.0f, 1.0f}}};
+        poses[i].Translation = {0.3f * std::sin(angle), 0.0f, -0.5f};
+    }
+    return poses;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ULONGLONG iterations = 200;
+    if (argc > 1) {
+        iterations = std::strtoull(argv[1], nullptr, 10);
+        if (iterations == 0) {
+            std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!NT_SUCCESS(FclGeometrySubsystemInitialize())) {
+        std::fprintf(stderr, "FclGeometrySubsystemInitialize failed\n");
+        return EXIT_FAILURE;
+    }
+
+    int exitCode = EXIT_SUCCESS;
+    {
+        GeometryHolder parts[kPartCount];
+        FCL_COMPOUND_CHILD_DESC children[kPartCount] = {};
+        GeometryHolder compound;
+        GeometryHolder obstacle;
+        FCL_OBB_GEOMETRY_DESC obstacleDesc = {};
+        obstacleDesc.Extents = {0.1f, 0.1f, 0.1f};
+        obstacleDesc.Rotation = IdentityTransform().Rotation;
+        FCL_COMPOUND_GEOMETRY_DESC compoundDesc = {};
+        compoundDesc.Children = children;
+        compoundDesc.ChildCount = kPartCount;
+        if (!CreateParts(parts, children) ||
+            !NT_SUCCESS(FclCreateGeometry(FCL_GEOMETRY_COMPOUND, &compoundDesc, &compound.Handle)) ||
+            !NT_SUCCESS(FclCreateGeometry(FCL_GEOMETRY_OBB, &obstacleDesc, &obstacle.Handle))) {
+            std::fprintf(stderr, "failed to create benchmark geometry\n");
+            exitCode = EXIT_FAILURE;
+        } else {
+            const std::vector<FCL_TRANSFORM> poses = BuildPoses();
+            const FCL_TRANSFORM identity = IdentityTransform();
+
+            char title[96] = {};
+            std::snprintf(title, sizeof(title), "compound vs %lu handles: %lu gripper poses per iteration", kPartCount, kPoseCount);
+            PrintHeader(title);
+
+            PrintResult(Measure("collision (separate handles)", iterations, [&](ULONGLONG) {
+                ULONG hits = 0;
+                for (const FCL_TRANSFORM& pose : poses) {
+                    BOOLEAN any = FALSE;
+                    for (ULONG i = 0; i < kPartCount && !any; ++i) {
+                        const FCL_TRANSFORM world = Compose(pose, children[i].LocalTransform);
+                        FclCollisionDetect(parts[i].Handle, &world, obstacle.Handle, &identity, &any, nullptr);
+                    }
+                    hits += any ? 1 : 0;
+                }
+                KeepAlive(hits);
+            }));
+
+            PrintResult(Measure("collision (compound)", iterations, [&](ULONGLONG) {
+                ULONG hits = 0;
+                for (const FCL_TRANSFORM& pose : poses) {
+                    BOOLEAN isColliding = FALSE;
+                    FclCollisionDetect(compound.Handle, &pose, obstacle.Handle, &identity, &isColliding, nullptr);
+                    hits += isColliding ? 1 : 0;
+                }
+                KeepAlive(hits);
+            }));
+
+            PrintResult(Measure("distance (separate handles)", iterations, [&](ULONGLONG) {
+                float sum = 0.0f;
+                for (const FCL_TRANSFORM& pose : poses) {
+                    float nearest = 1e30f;
+                    for (ULONG i = 0; i < kPartCount; ++i) {
+                        const FCL_TRANSFORM world = Compose(pose, children[i].LocalTransform);
+                        FCL_DISTANCE_RESULT result = {};
+                        FclDistanceCompute(parts[i].Handle, &world, obstacle.Handle, &identity, &result);
+                        nearest = (result.Distance < nearest) ? result.Distance : nearest;
+                    }
+                    sum += nearest;
+                }
+                KeepAlive(sum);
+            }));
+
+            PrintResult(Measure("distance (compound)", iterations, [&](ULONGLONG) {
+                float sum = 0.0f;
+                for (const FCL_TRANSFORM& pose : poses) {
+                    FCL_DISTANCE_RESULT result = {};
+                    FclDistanceCompute(compound.Handle, &pose, obstacle.Handle, &identity, &result);
+                    sum += result.Distance;
+                }
+                KeepAlive(sum);
+            }));
+        }
+    }
+
+    FclGeometrySubsystemShutdown();
+    return exitCode;
+}
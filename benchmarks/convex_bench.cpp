@@ -0,0 +1,150 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include "bench_common.h"
+
+#include "fclmusa/collision.h"
+#include "fclmusa/distance.h"
+#include "fclmusa/geometry.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/platform.h"
+
+//
+// 凸包基准：同一个细分球面分别以 Mesh（BVH）与 FCL_GEOMETRY_CONVEX（FclCreateConvexFromMesh）创建，
+// 对一个沿圆周运动的盒体执行碰撞与距离查询。球面顶点数取 MPR 凸包预判上限之外，Mesh 只能走 BVH 路径。
+// 用法：FclMusaConvexBench [iterations]
+//
+
+namespace {
+
+using fclmusa::bench::KeepAlive;
+using fclmusa::bench::Measure;
+using fclmusa::bench::PrintHeader;
+using fclmusa::bench::PrintResult;
+using fclmusa::geom::IdentityTransform;
+
+constexpr ULONG kLatitudeSegments = 24;
+constexpr ULONG kLongitudeSegments = 24;
+constexpr ULONG kPoseCount = 64;
+
+struct GeometryHolder {
+    FCL_GEOMETRY_HANDLE Handle = {};
+
+    ~GeometryHolder() {
+        if (Handle.Value != 0) {
+            FclDestroyGeometry(Handle);
+        }
+    }
+};
+
+bool CreateSphereMesh(GeometryHolder* holder) {
+    std::vector<FCL_VECTOR3> vertices;
+    std::vector<UINT32> indices;
+    const float pi = 3.14159265f;
+    for (ULONG i = 0; i <= kLatitudeSegments; ++i) {
+        const float theta = pi * static_cast<float>(i) / static_cast<float>(kLatitudeSegments);
+        for (ULONG j = 0; j <= kLongitudeSegments; ++j) {
+            const float phi = 2.0f * pi * static_cast<float>(j) / static_cast<float>(kLongitudeSegments);
+            vertices.push_back({std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta)});
+        }
+    }
+    for (ULONG i = 0; i < kLatitudeSegments; ++i) {
+        for (ULONG j = 0; j < kLongitudeSegments; ++j) {
+            const UINT32 a = i * (kLongitudeSegments + 1) + j;
+            const UINT32 b = a + 1;
+            const UINT32 c = a + kLongitudeSegments + 1;
+            const UINT32 d = c + 1;
+            indices.insert(indices.end(), {a, c, b, b, c, d});
+        }
+    }
+    FCL_MESH_GEOMETRY_DESC desc = {};
+    desc.Vertices = vertices.data();
+    desc.VertexCount = static_cast<ULONG>(vertices.size());
+    desc.Indices = indices.data();
+    desc.IndexCount = static_cast<ULONG>(indices.size());
+    return NT_SUCCESS(FclCreateGeometry(FCL_GEOMETRY_MESH, &desc, &holder->Handle));
+}
+
+// 盒体绕球面运动，距球心 0.9 ~ 1.5，约一半位姿与球面相交。
+std::vector<FCL_TRANSFORM> BuildPoses() {
+    std::vector<FCL_TRANSFORM> poses(kPoseCount);
+    for (ULONG i = 0; i < kPoseCount; ++i) {
+        const float angle = 6.2831853f * static_cast<float>(i) / static_cast<float>(kPoseCount);
+        const float radius = 1.2f + 0.3f * std::sin(angle * 3.0f);
+        poses[i] = IdentityTransform();
+        poses[i].Translation = {radius * std::cos(angle), radius * std::sin(angle), 0.1f};
+    }
+    return poses;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ULONGLONG iterations = 200;
+    if (argc > 1) {
+        iterations = std::strtoull(argv[1], nullptr, 10);
+        if (iterations == 0) {
+            std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!NT_SUCCESS(FclGeometrySubsystemInitialize())) {
+        std::fprintf(stderr, "FclGeometrySubsystemInitialize failed\n");
+        return EXIT_FAILURE;
+    }
+
+    int exitCode = EXIT_SUCCESS;
+    {
+        GeometryHolder mesh;
+        GeometryHolder convex;
+        GeometryHolder box;
+        FCL_OBB_GEOMETRY_DESC boxDesc = {};
+        boxDesc.Extents = {0.25f, 0.25f, 0.25f};
+        boxDesc.Rotation = IdentityTransform().Rotation;
+        if (!CreateSphereMesh(&mesh) ||
+            !NT_SUCCESS(FclCreateConvexFromMesh(mesh.Handle, &convex.Handle)) ||
+            !NT_SUCCESS(FclCreateGeometry(FCL_GEOMETRY_OBB, &boxDesc, &box.Handle))) {
+            std::fprintf(stderr, "failed to create benchmark geometry\n");
+            exitCode = EXIT_FAILURE;
+        } else {
+            const std::vector<FCL_TRANSFORM> poses = BuildPoses();
+            const FCL_TRANSFORM identity = IdentityTransform();
+
+            char title[96] = {};
+            std::snprintf(title, sizeof(title), "convex vs mesh: %lu box poses per iteration", kPoseCount);
+            PrintHeader(title);
+
+            for (const auto& target : {std::make_pair("mesh", &mesh), std::make_pair("convex", &convex)}) {
+                char name[64] = {};
+                std::snprintf(name, sizeof(name), "collision (%s)", target.first);
+                PrintResult(Measure(name, iterations, [&](ULONGLONG) {
+                    ULONG hits = 0;
+                    for (const FCL_TRANSFORM& pose : poses) {
+                        BOOLEAN isColliding = FALSE;
+                        FclCollisionDetect(target.second->Handle, &identity, box.Handle, &pose, &isColliding, nullptr);
+                        hits += isColliding ? 1 : 0;
+                    }
+                    KeepAlive(hits);
+                }));
+
+                std::snprintf(name, sizeof(name), "distance (%s)", target.first);
+                PrintResult(Measure(name, iterations, [&](ULONGLONG) {
+                    float sum = 0.0f;
+                    for (const FCL_TRANSFORM& pose : poses) {
+                        FCL_DISTANCE_RESULT result = {};
+                        FclDistanceCompute(target.second->Handle, &identity, box.Handle, &pose, &result);
+                        sum += result.Distance;
+                    }
+                    KeepAlive(sum);
+                }));
+            }
+        }
+    }
+
+    FclGeometrySubsystemShutdown();
+    return exitCode;
+}
@@ -0,0 +1,145 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include "bench_common.h"
+
+#include "fclmusa/distance.h"
+#include "fclmusa/geometry.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/memory/dpc_reserve.h"
+#include "fclmusa/memory/pool_allocator.h"
+#include "fclmusa/platform.h"
+#include "fclmusa/upstream/upstream_bridge.h"
+
+//
+// DPC 预留池基准：同一组分配 / upstream 查询分别在 PASSIVE_LEVEL（slab + 查询 arena）与模拟的 DISPATCH_LEVEL
+// （预留池 SLIST）下运行，输出耗时、每级预留块的高水位与耗尽次数（默认配置下应为 0）。
+// 用法：FclMusaDpcReserveBench [iterations]
+//
+
+namespace {
+
+using fclmusa::bench::KeepAlive;
+using fclmusa::bench::Measure;
+using fclmusa::bench::PrintHeader;
+using fclmusa::bench::PrintResult;
+using fclmusa::geom::IdentityTransform;
+
+constexpr ULONG kBatchSize = 16;
+constexpr ULONGLONG kPoseCount = 64;
+
+constexpr size_t kSizes[kBatchSize] = {16, 24, 32, 48, 64, 96, 128, 200, 16, 32, 48, 64, 512, 1024, 3000, 40};
+
+struct ShapeHolder {
+    FCL_GEOMETRY_HANDLE Handle = {};
+    FCL_GEOMETRY_REFERENCE Reference = {};
+    FCL_GEOMETRY_SNAPSHOT Snapshot = {};
+
+    ~ShapeHolder() {
+        FclReleaseGeometryReference(&Reference);
+        if (Handle.Value != 0) {
+            FclDestroyGeometry(Handle);
+        }
+    }
+};
+
+bool CreateBox(float halfExtent, ShapeHolder* holder) {
+    FCL_OBB_GEOMETRY_DESC desc = {};
+    desc.Extents = {halfExtent, halfExtent, halfExtent};
+    desc.Rotation = IdentityTransform().Rotation;
+    return NT_SUCCESS(FclCreateGeometry(FCL_GEOMETRY_OBB, &desc, &holder->Handle)) &&
+           NT_SUCCESS(FclAcquireGeometryReference(holder->Handle, &holder->Reference, &holder->Snapshot));
+}
+
+FCL_TRANSFORM PoseForIteration(ULONGLONG iteration) noexcept {
+    FCL_TRANSFORM transform = IdentityTransform();
+    transform.Translation.X = 0.5f + static_cast<float>(iteration % kPoseCount) * 0.03f;
+    transform.Translation.Y = 0.1f;
+    return transform;
+}
+
+template <typename Fn>
+void RunAtBothLevels(const char* label, ULONGLONG iterations, Fn&& body) {
+    char name[96] = {};
+    std::snprintf(name, sizeof(name), "%s (passive)", label);
+    PrintResult(Measure(name, iterations, body));
+
+    KIRQL oldIrql = PASSIVE_LEVEL;
+    KeRaiseIrql(DISPATCH_LEVEL, &oldIrql);
+    std::snprintf(name, sizeof(name), "%s (dispatch, reserve)", label);
+    PrintResult(Measure(name, iterations, body));
+    KeLowerIrql(oldIrql);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ULONGLONG iterations = 100000;
+    if (argc > 1) {
+        iterations = std::strtoull(argv[1], nullptr, 10);
+        if (iterations == 0) {
+            std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!NT_SUCCESS(FclGeometrySubsystemInitialize())) {
+        std::fprintf(stderr, "FclGeometrySubsystemInitialize failed\n");
+        return EXIT_FAILURE;
+    }
+    fclmusa::memory::SetDpcReserveConfig(fclmusa::memory::kDefaultDpcReserveConfig);
+    if (!NT_SUCCESS(fclmusa::memory::InitializeDpcReserve())) {
+        std::fprintf(stderr, "InitializeDpcReserve failed\n");
+        FclGeometrySubsystemShutdown();
+        return EXIT_FAILURE;
+    }
+
+    int exitCode = EXIT_SUCCESS;
+    {
+        ShapeHolder box;
+        if (!CreateBox(0.5f, &box)) {
+            std::fprintf(stderr, "failed to create benchmark geometry\n");
+            exitCode = EXIT_FAILURE;
+        } else {
+            const FCL_TRANSFORM origin = IdentityTransform();
+            PrintHeader("DPC reserve: allocations and upstream queries at passive vs dispatch level");
+
+            RunAtBothLevels("alloc/free 16 blocks", iterations, [&](ULONGLONG) {
+                void* blocks[kBatchSize] = {};
+                for (ULONG i = 0; i < kBatchSize; ++i) {
+                    blocks[i] = fclmusa::memory::Allocate(kSizes[i]);
+                }
+                for (ULONG i = kBatchSize; i > 0; --i) {
+                    fclmusa::memory::Free(blocks[i - 1]);
+                }
+                KeepAlive(blocks[0] != nullptr);
+            });
+
+            RunAtBothLevels("box/box upstream distance", iterations, [&](ULONGLONG i) {
+                FCL_DISTANCE_RESULT result = {};
+                FclUpstreamDistance(box.Snapshot, origin, box.Snapshot, PoseForIteration(i), &result);
+                KeepAlive(result.Distance > 0.0f);
+            });
+
+            const FCL_DPC_RESERVE_STATS stats = fclmusa::memory::QueryDpcReserveStats();
+            std::printf("reserve: %llu bytes, %llu allocations, %llu exhaustions\n",
+                stats.ReserveBytes,
+                stats.Allocations,
+                stats.Exhaustions);
+            for (const FCL_DPC_RESERVE_CLASS_STATS& cls : stats.Classes) {
+                std::printf("  %6lu B blocks: %4lu reserved, high water %4lu, %llu overflows\n",
+                    cls.BlockBytes,
+                    cls.BlockCount,
+                    cls.HighWaterBlocks,
+                    cls.Overflows);
+            }
+            if (stats.Exhaustions != 0) {
+                exitCode = EXIT_FAILURE;
+            }
+        }
+    }
+
+    fclmusa::memory::ShutdownDpcReserve();
+    FclGeometrySubsystemShutdown();
+    return exitCode;
+}
@@ -0,0 +1,199 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "bench_common.h"
+
+#include "fclmusa/collision.h"
+#include "fclmusa/distance.h"
+#include "fclmusa/geometry.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/platform.h"
+#include "fclmusa/solver.h"
+#include "fclmusa/upstream/upstream_bridge.h"
+
+//
+// GJK 求解器矩阵：(几何组合) × (libccd / indep) × (布尔 / 距离)。
+// 直接调用 upstream 桥接层，绕过原生内核，使两种求解器在同一路径上比较；
+// 距离误差以 libccd 紧容差（1e-10、1000 次迭代）结果为参考，在 64 个位姿上取最大绝对误差。
+// 用法：FclMusaGjkSolverBench [iterations]
+//
+
+namespace {
+
+using fclmusa::bench::KeepAlive;
+using fclmusa::bench::Measure;
+using fclmusa::bench::PrintHeader;
+using fclmusa::bench::PrintResult;
+using fclmusa::geom::IdentityTransform;
+
+constexpr ULONGLONG kPoseCount = 64;
+
+struct ShapeHolder {
+    FCL_GEOMETRY_HANDLE Handle = {};
+    FCL_GEOMETRY_REFERENCE Reference = {};
+    FCL_GEOMETRY_SNAPSHOT Snapshot = {};
+
+    ~ShapeHolder() {
+        FclReleaseGeometryReference(&Reference);
+        if (Handle.Value != 0) {
+            FclDestroyGeometry(Handle);
+        }
+    }
+};
+
+struct SolverCase {
+    const char* Label;
+    FCL_SOLVER_OPTIONS Options;
+};
+
+bool Acquire(FCL_GEOMETRY_TYPE type, const void* desc, ShapeHolder* holder) {
+    return NT_SUCCESS(FclCreateGeometry(type, desc, &holder->Handle)) &&
+           NT_SUCCESS(FclAcquireGeometryReference(holder->Handle, &holder->Reference, &holder->Snapshot));
+}
+
+bool CreateSphere(float radius, ShapeHolder* holder) {
+    FCL_SPHERE_GEOMETRY_DESC desc = {};
+    desc.Radius = radius;
+    return Acquire(FCL_GEOMETRY_SPHERE, &desc, holder);
+}
+
+bool CreateBox(float halfExtent, ShapeHolder* holder) {
+    FCL_OBB_GEOMETRY_DESC desc = {};
+    desc.Extents = {halfExtent, halfExtent, halfExtent};
+    desc.Rotation = IdentityTransform().Rotation;
+    return Acquire(FCL_GEOMETRY_OBB, &desc, holder);
+}
+
+bool CreateMesh(float radius, ShapeHolder* holder) {
+    const FCL_VECTOR3 vertices[] = {
+        {radius, 0.0f, 0.0f}, {-radius, 0.0f, 0.0f},
+        {0.0f, radius, 0.0f}, {0.0f, -radius, 0.0f},
+        {0.0f, 0.0f, radius}, {0.0f, 0.0f, -radius},
+    };
+    const UINT32 indices[] = {
+        0, 2, 4, 2, 1, 4, 1, 3, 4, 3, 0, 4,
+        2, 0, 5, 1, 2, 5, 3, 1, 5, 0, 3, 5,
+    };
+    FCL_MESH_GEOMETRY_DESC desc = {};
+    desc.Vertices = vertices;
+    desc.VertexCount = static_cast<ULONG>(sizeof(vertices) / sizeof(vertices[0]));
+    desc.Indices = indices;
+    desc.IndexCount = static_cast<ULONG>(sizeof(indices) / sizeof(indices[0]));
+    return Acquire(FCL_GEOMETRY_MESH, &desc, holder);
+}
+
+// 沿 X 轴往返并带小幅偏移，使相交 / 分离交替出现。
+FCL_TRANSFORM PoseForIteration(ULONGLONG iteration) noexcept {
+    FCL_TRANSFORM transform = IdentityTransform();
+    transform.Translation.X = 0.5f + static_cast<float>(iteration % kPoseCount) * 0.05f;
+    transform.Translation.Y = 0.1f;
+    transform.Translation.Z = 0.05f;
+    return transform;
+}
+
+double MaxDistanceError(
+    const FCL_GEOMETRY_SNAPSHOT& object1,
+    const FCL_GEOMETRY_SNAPSHOT& object2,
+    const FCL_SOLVER_OPTIONS& options,
+    const FCL_SOLVER_OPTIONS& reference) {
+    const FCL_TRANSFORM origin = IdentityTransform();
+    double maxError = 0.0;
+    for (ULONGLONG i = 0; i < kPoseCount; ++i) {
+        FCL_DISTANCE_RESULT expected = {};
+        FCL_DISTANCE_RESULT actual = {};
+        const FCL_TRANSFORM pose = PoseForIteration(i);
+        if (!NT_SUCCESS(FclUpstreamDistance(object1, origin, object2, pose, &expected, &reference)) ||
+            !NT_SUCCESS(FclUpstreamDistance(object1, origin, object2, pose, &actual, &options))) {
+            return -1.0;
+        }
+        const double error = std::fabs(static_cast<double>(actual.Distance) - static_cast<double>(expected.Distance));
+        if (error > maxError) {
+            maxError = error;
+        }
+    }
+    return maxError;
+}
+
+void RunCase(
+    const char* label,
+    const FCL_GEOMETRY_SNAPSHOT& object1,
+    const FCL_GEOMETRY_SNAPSHOT& object2,
+    const SolverCase* solvers,
+    std::size_t solverCount,
+    const FCL_SOLVER_OPTIONS& reference,
+    ULONGLONG iterations) {
+    const FCL_TRANSFORM origin = IdentityTransform();
+    char name[96] = {};
+
+    for (std::size_t s = 0; s < solverCount; ++s) {
+        const SolverCase& solver = solvers[s];
+
+        std::snprintf(name, sizeof(name), "%s bool %s", label, solver.Label);
+        PrintResult(Measure(name, iterations, [&](ULONGLONG i) {
+            BOOLEAN hit = FALSE;
+            FclUpstreamCollide(object1, origin, object2, PoseForIteration(i), &hit, nullptr, &solver.Options);
+            KeepAlive(hit);
+        }));
+
+        std::snprintf(name, sizeof(name), "%s distance %s", label, solver.Label);
+        PrintResult(Measure(name, iterations, [&](ULONGLONG i) {
+            FCL_DISTANCE_RESULT result = {};
+            FclUpstreamDistance(object1, origin, object2, PoseForIteration(i), &result, &solver.Options);
+            KeepAlive(result.Distance > 0.0f);
+        }));
+
+        std::printf(
+            "  %-40s max |error| = %.3e\n",
+            name,
+            MaxDistanceError(object1, object2, solver.Options, reference));
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ULONGLONG iterations = 100000;
+    if (argc > 1) {
+        iterations = std::strtoull(argv[1], nullptr, 10);
+        if (iterations == 0) {
+            std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!NT_SUCCESS(FclGeometrySubsystemInitialize())) {
+        std::fprintf(stderr, "FclGeometrySubsystemInitialize failed\n");
+        return EXIT_FAILURE;
+    }
+
+    const SolverCase solvers[] = {
+        {"libccd", {FCL_GJK_SOLVER_LIBCCD, 0.0, 0}},
+        {"indep", {FCL_GJK_SOLVER_INDEP, 0.0, 0}},
+        {"libccd tol=1e-3", {FCL_GJK_SOLVER_LIBCCD, 1e-3, 0}},
+        {"indep tol=1e-3", {FCL_GJK_SOLVER_INDEP, 1e-3, 0}},
+    };
+    const FCL_SOLVER_OPTIONS reference = {FCL_GJK_SOLVER_LIBCCD, 1e-10, 1000};
+    const std::size_t solverCount = sizeof(solvers) / sizeof(solvers[0]);
+
+    int exitCode = EXIT_SUCCESS;
+    {
+        ShapeHolder sphere;
+        ShapeHolder box;
+        ShapeHolder mesh;
+        if (!CreateSphere(0.75f, &sphere) || !CreateBox(0.5f, &box) || !CreateMesh(0.8f, &mesh)) {
+            std::fprintf(stderr, "failed to create benchmark geometry\n");
+            exitCode = EXIT_FAILURE;
+        } else {
+            PrintHeader("GJK solver selection: libccd vs indep");
+            RunCase("sphere/box", sphere.Snapshot, box.Snapshot, solvers, solverCount, reference, iterations);
+            RunCase("box/box", box.Snapshot, box.Snapshot, solvers, solverCount, reference, iterations);
+            RunCase("sphere/mesh", sphere.Snapshot, mesh.Snapshot, solvers, solverCount, reference, iterations);
+            RunCase("box/mesh", box.Snapshot, mesh.Snapshot, solvers, solverCount, reference, iterations);
+            RunCase("mesh/mesh", mesh.Snapshot, mesh.Snapshot, solvers, solverCount, reference, iterations);
+        }
+    }
+
+    FclGeometrySubsystemShutdown();
+    return exitCode;
+}
@@ -0,0 +1,190 @@
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "bench_common.h"
+
+#include "fclmusa/collision.h"
+#include "fclmusa/diagnostics/latency_histogram.h"
+#include "fclmusa/distance.h"
+#include "fclmusa/geometry.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/platform.h"
+
+//
+// 延迟直方图基准：
+// 1. RecordLatency 的单次开销（只计查询类型 / 同时计类型对），以及 1、2、4 个线程并发记录时的单次开销
+// 2. 球 / 球与球 / Mesh 交替的碰撞、距离查询工作负载，按查询类型与几何类型对输出样本数与 p50 / p90 / p99 / p99.9，
+//    用于观察基本体与 Mesh 两种代价叠加出的双峰分布
+// 用法：FclMusaLatencyHistogramBench [iterations]
+//
+
+namespace {
+
+using fclmusa::bench::KeepAlive;
+using fclmusa::bench::Measure;
+using fclmusa::bench::PrintHeader;
+using fclmusa::bench::PrintResult;
+using fclmusa::diagnostics::RecordLatency;
+using fclmusa::geom::IdentityTransform;
+
+constexpr ULONGLONG kPoseCount = 64;
+
+struct GeometryHolder {
+    FCL_GEOMETRY_HANDLE Handle = {};
+
+    ~GeometryHolder() {
+        if (Handle.Value != 0) {
+            FclDestroyGeometry(Handle);
+        }
+    }
+};
+
+bool CreateSphere(float radius, GeometryHolder* holder) {
+    FCL_SPHERE_GEOMETRY_DESC desc = {};
+    desc.Radius = radius;
+    return NT_SUCCESS(FclCreateGeometry(FCL_GEOMETRY_SPHERE, &desc, &holder->Handle));
+}
+
+bool CreateMesh(float radius, GeometryHolder* holder) {
+    const FCL_VECTOR3 vertices[] = {
+        {radius, 0.0f, 0.0f}, {-radius, 0.0f, 0.0f},
+        {0.0f, radius, 0.0f}, {0.0f, -radius, 0.0f},
+        {0.0f, 0.0f, radius}, {0.0f, 0.0f, -radius},
+    };
+    const UINT32 indices[] = {
+        0, 2, 4, 2, 1, 4, 1, 3, 4, 3, 0, 4,
+        2, 0, 5, 1, 2, 5, 3, 1, 5, 0, 3, 5,
+    };
+    FCL_MESH_GEOMETRY_DESC desc = {};
+    desc.Vertices = vertices;
+    desc.VertexCount = static_cast<ULONG>(sizeof(vertices) / sizeof(vertices[0]));
+    desc.Indices = indices;
+    desc.IndexCount = static_cast<ULONG>(sizeof(indices) / sizeof(indices[0]));
+    return NT_SUCCESS(FclCreateGeometry(FCL_GEOMETRY_MESH, &desc, &holder->Handle));
+}
+
+FCL_TRANSFORM PoseForIteration(ULONGLONG iteration) noexcept {
+    FCL_TRANSFORM transform = IdentityTransform();
+    transform.Translation.X = 0.5f + static_cast<float>(iteration % kPoseCount) * 0.03f;
+    transform.Translation.Y = 0.1f;
+    return transform;
+}
+
+void MeasureConcurrentRecording(ULONGLONG iterations) {
+    for (unsigned threads = 1; threads <= 4; threads *= 2) {
+        LARGE_INTEGER frequency = {};
+        LARGE_INTEGER start = {};
+        LARGE_INTEGER end = {};
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&start);
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([iterations, t]() {
+                for (ULONGLONG i = 0; i < iterations; ++i) {
+                    RecordLatency(
+                        FCL_LATENCY_DISTANCE, FCL_GEOMETRY_SPHERE, FCL_GEOMETRY_OBB, 100 + (i & 1023) + t);
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        QueryPerformanceCounter(&end);
+        const double elapsedNs =
+            static_cast<double>(end.QuadPart - start.QuadPart) * 1.0e9 / static_cast<double>(frequency.QuadPart);
+        std::printf("  %u thread(s): %.1f ns per record per thread\n",
+            threads,
+            elapsedNs / static_cast<double>(iterations));
+    }
+}
+
+void PrintHistogram(const char* name, FCL_LATENCY_KIND kind, ULONG type1, ULONG type2) {
+    FCL_LATENCY_HISTOGRAM_QUERY query = {};
+    query.Kind = static_cast<ULONG>(kind);
+    query.Type1 = type1;
+    query.Type2 = type2;
+    static FCL_LATENCY_HISTOGRAM histogram = {};
+    if (!NT_SUCCESS(FclQueryLatencyHistogram(&query, &histogram))) {
+        std::printf("  %-24s query failed\n", name);
+        return;
+    }
+    std::printf("  %-24s count %8llu  min %8llu  p50 %8llu  p90 %8llu  p99 %8llu  p99.9 %8llu  max %8llu ns\n",
+        name,
+        histogram.Count,
+        histogram.MinNanoseconds,
+        histogram.P50Nanoseconds,
+        histogram.P90Nanoseconds,
+        histogram.P99Nanoseconds,
+        histogram.P999Nanoseconds,
+        histogram.MaxNanoseconds);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ULONGLONG iterations = 1000000;
+    if (argc > 1) {
+        iterations = std::strtoull(argv[1], nullptr, 10);
+        if (iterations == 0) {
+            std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!NT_SUCCESS(FclGeometrySubsystemInitialize())) {
+        std::fprintf(stderr, "FclGeometrySubsystemInitialize failed\n");
+        return EXIT_FAILURE;
+    }
+
+    PrintHeader("latency histogram: record cost and percentiles");
+    PrintResult(Measure("record (kind only)", iterations, [](ULONGLONG i) {
+        const FCL_GEOMETRY_TYPE untracked = static_cast<FCL_GEOMETRY_TYPE>(0);
+        RecordLatency(FCL_LATENCY_COLLISION, untracked, untracked, 100 + (i & 1023));
+    }));
+    PrintResult(Measure("record (kind + geometry pair)", iterations, [](ULONGLONG i) {
+        RecordLatency(FCL_LATENCY_COLLISION, FCL_GEOMETRY_SPHERE, FCL_GEOMETRY_MESH, 100 + (i & 1023));
+    }));
+    PrintResult(Measure("stopwatch start + elapsed", iterations, [](ULONGLONG) {
+        const fclmusa::diagnostics::LatencyStopwatch stopwatch;
+        KeepAlive(stopwatch.ElapsedNanoseconds());
+    }));
+    std::printf("concurrent recording:\n");
+    MeasureConcurrentRecording(iterations);
+
+    int exitCode = EXIT_SUCCESS;
+    {
+        GeometryHolder sphereA;
+        GeometryHolder sphereB;
+        GeometryHolder mesh;
+        if (!CreateSphere(0.5f, &sphereA) || !CreateSphere(0.4f, &sphereB) || !CreateMesh(0.6f, &mesh)) {
+            std::fprintf(stderr, "failed to create benchmark geometry\n");
+            exitCode = EXIT_FAILURE;
+        } else {
+            FclResetLatencyHistograms();
+            const ULONGLONG workload = (iterations / 10) + 1;
+            for (ULONGLONG i = 0; i < workload; ++i) {
+                const FCL_TRANSFORM pose = PoseForIteration(i);
+                const FCL_GEOMETRY_HANDLE other = (i & 1) ? mesh.Handle : sphereB.Handle;
+                BOOLEAN hit = FALSE;
+                FCL_CONTACT_INFO contact = {};
+                FCL_DISTANCE_RESULT distance = {};
+                FclCollisionDetect(sphereA.Handle, nullptr, other, &pose, &hit, &contact);
+                FclDistanceCompute(sphereA.Handle, nullptr, other, &pose, &distance);
+                KeepAlive(hit);
+            }
+            std::printf("mixed sphere/sphere + sphere/mesh workload (%llu iterations):\n", workload);
+            PrintHistogram("collision (all)", FCL_LATENCY_COLLISION, 0, 0);
+            PrintHistogram("collision sphere/sphere", FCL_LATENCY_COLLISION, FCL_GEOMETRY_SPHERE, FCL_GEOMETRY_SPHERE);
+            PrintHistogram("collision sphere/mesh", FCL_LATENCY_COLLISION, FCL_GEOMETRY_SPHERE, FCL_GEOMETRY_MESH);
+            PrintHistogram("distance (all)", FCL_LATENCY_DISTANCE, 0, 0);
+            PrintHistogram("distance sphere/sphere", FCL_LATENCY_DISTANCE, FCL_GEOMETRY_SPHERE, FCL_GEOMETRY_SPHERE);
+            PrintHistogram("distance sphere/mesh", FCL_LATENCY_DISTANCE, FCL_GEOMETRY_SPHERE, FCL_GEOMETRY_MESH);
+        }
+    }
+
+    FclResetLatencyHistograms();
+    FclGeometrySubsystemShutdown();
+    return exitCode;
+}
@@ -0,0 +1,149 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include "bench_common.h"
+
+#include "fclmusa/collision.h"
+#include "fclmusa/geometry.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/narrowphase/mpr_intersect.h"
+#include "fclmusa/narrowphase/query_dispatch.h"
+#include "fclmusa/platform.h"
+#include "fclmusa/upstream/upstream_bridge.h"
+
+//
+// 纯布尔相交微基准：对比 upstream FCL（GJK 求解器路径）、libccd MPR 与 query_dispatch。
+// 凸 Mesh 通过几何管理层创建，以获得与驱动一致的快照（含 BVH）。
+// 用法：FclMusaMprIntersectBench [iterations]
+//
+
+namespace {
+
+using fclmusa::bench::KeepAlive;
+using fclmusa::bench::Measure;
+using fclmusa::bench::PrintHeader;
+using fclmusa::bench::PrintResult;
+using fclmusa::geom::IdentityTransform;
+
+struct ShapeHolder {
+    FCL_GEOMETRY_HANDLE Handle = {};
+    FCL_GEOMETRY_REFERENCE Reference = {};
+    FCL_GEOMETRY_SNAPSHOT Snapshot = {};
+
+    ~ShapeHolder() {
+        FclReleaseGeometryReference(&Reference);
+        if (Handle.Value != 0) {
+            FclDestroyGeometry(Handle);
+        }
+    }
+};
+
+bool Acquire(FCL_GEOMETRY_TYPE type, const void* desc, ShapeHolder* holder) {
+    return NT_SUCCESS(FclCreateGeometry(type, desc, &holder->Handle)) &&
+           NT_SUCCESS(FclAcquireGeometryReference(holder->Handle, &holder->Reference, &holder->Snapshot));
+}
+
+bool CreateSphere(float radius, ShapeHolder* holder) {
+    FCL_SPHERE_GEOMETRY_DESC desc = {};
+    desc.Radius = radius;
+    return Acquire(FCL_GEOMETRY_SPHERE, &desc, holder);
+}
+
+bool CreateBox(float halfExtent, ShapeHolder* holder) {
+    FCL_OBB_GEOMETRY_DESC desc = {};
+    desc.Extents = {halfExtent, halfExtent, halfExtent};
+    desc.Rotation = IdentityTransform().Rotation;
+    return Acquire(FCL_GEOMETRY_OBB, &desc, holder);
+}
+
+// 八面体：小型凸 Mesh 的代表。
+bool CreateConvexMesh(float radius, ShapeHolder* holder) {
+    const FCL_VECTOR3 vertices[] = {
+        {radius, 0.0f, 0.0f}, {-radius, 0.0f, 0.0f},
+        {0.0f, radius, 0.0f}, {0.0f, -radius, 0.0f},
+        {0.0f, 0.0f, radius}, {0.0f, 0.0f, -radius},
+    };
+    const UINT32 indices[] = {
+        0, 2, 4, 2, 1, 4, 1, 3, 4, 3, 0, 4,
+        2, 0, 5, 1, 2, 5, 3, 1, 5, 0, 3, 5,
+    };
+    FCL_MESH_GEOMETRY_DESC desc = {};
+    desc.Vertices = vertices;
+    desc.VertexCount = static_cast<ULONG>(sizeof(vertices) / sizeof(vertices[0]));
+    desc.Indices = indices;
+    desc.IndexCount = static_cast<ULONG>(sizeof(indices) / sizeof(indices[0]));
+    return Acquire(FCL_GEOMETRY_MESH, &desc, holder);
+}
+
+// 沿 X 轴往返移动对象 2，使相交 / 分离交替出现。
+FCL_TRANSFORM PoseForIteration(ULONGLONG iteration) noexcept {
+    FCL_TRANSFORM transform = IdentityTransform();
+    transform.Translation.X = 0.5f + static_cast<float>(iteration % 64) * 0.05f;
+    transform.Translation.Y = 0.1f;
+    return transform;
+}
+
+void RunCase(const char* label, const FCL_GEOMETRY_SNAPSHOT& object1, const FCL_GEOMETRY_SNAPSHOT& object2, ULONGLONG iterations) {
+    const FCL_TRANSFORM origin = IdentityTransform();
+    char name[96] = {};
+
+    std::snprintf(name, sizeof(name), "%s upstream gjk", label);
+    PrintResult(Measure(name, iterations, [&](ULONGLONG i) {
+        BOOLEAN hit = FALSE;
+        FclUpstreamCollide(object1, origin, object2, PoseForIteration(i), &hit, nullptr);
+        KeepAlive(hit);
+    }));
+
+    std::snprintf(name, sizeof(name), "%s mpr", label);
+    PrintResult(Measure(name, iterations, [&](ULONGLONG i) {
+        BOOLEAN hit = FALSE;
+        fclmusa::narrowphase::MprIntersect(object1, origin, object2, PoseForIteration(i), &hit);
+        KeepAlive(hit);
+    }));
+
+    std::snprintf(name, sizeof(name), "%s dispatch", label);
+    PrintResult(Measure(name, iterations, [&](ULONGLONG i) {
+        BOOLEAN hit = FALSE;
+        fclmusa::narrowphase::DispatchCollision(object1, origin, object2, PoseForIteration(i), &hit, nullptr);
+        KeepAlive(hit);
+    }));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ULONGLONG iterations = 100000;
+    if (argc > 1) {
+        iterations = std::strtoull(argv[1], nullptr, 10);
+        if (iterations == 0) {
+            std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!NT_SUCCESS(FclGeometrySubsystemInitialize())) {
+        std::fprintf(stderr, "FclGeometrySubsystemInitialize failed\n");
+        return EXIT_FAILURE;
+    }
+
+    int exitCode = EXIT_SUCCESS;
+    {
+        ShapeHolder sphere;
+        ShapeHolder box;
+        ShapeHolder convex;
+        if (!CreateSphere(0.75f, &sphere) || !CreateBox(0.5f, &box) || !CreateConvexMesh(0.8f, &convex)) {
+            std::fprintf(stderr, "failed to create benchmark geometry\n");
+            exitCode = EXIT_FAILURE;
+        } else {
+            PrintHeader("boolean intersection: GJK vs MPR");
+            RunCase("sphere/sphere", sphere.Snapshot, sphere.Snapshot, iterations);
+            RunCase("box/box", box.Snapshot, box.Snapshot, iterations);
+            RunCase("sphere/convex", sphere.Snapshot, convex.Snapshot, iterations);
+            RunCase("box/convex", box.Snapshot, convex.Snapshot, iterations);
+            RunCase("convex/convex", convex.Snapshot, convex.Snapshot, iterations);
+        }
+    }
+
+    FclGeometrySubsystemShutdown();
+    return exitCode;
+}
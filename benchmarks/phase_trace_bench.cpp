@@ -0,0 +1,165 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include "bench_common.h"
+
+#include "fclmusa/collision.h"
+#include "fclmusa/diagnostics/phase_trace.h"
+#include "fclmusa/geometry.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/platform.h"
+
+//
+// 阶段追踪基准：
+// 1. 球 / 球与球 / Mesh 碰撞（公开接口，含句柄获取）的耗时；分别以 FCLMUSA_ENABLE_PHASE_TRACING=ON / OFF 构建，
+//    ON 时再对比环形缓冲区关闭 / 开启，得到插桩本身的开销
+// 2. ON 时对两组工作负载按阶段输出次数、平均 / 最小 / 最大周期以及占 upstream 入口总周期的比例，
+//    用于区分 Mesh 查询中绑定构建与窄阶段各占多少
+// 用法：FclMusaPhaseTraceBench [iterations]
+//
+
+namespace {
+
+using fclmusa::bench::KeepAlive;
+using fclmusa::bench::Measure;
+using fclmusa::bench::PrintHeader;
+using fclmusa::bench::PrintResult;
+using fclmusa::geom::IdentityTransform;
+
+constexpr ULONGLONG kPoseCount = 64;
+
+struct GeometryHolder {
+    FCL_GEOMETRY_HANDLE Handle = {};
+
+    ~GeometryHolder() {
+        if (Handle.Value != 0) {
+            FclDestroyGeometry(Handle);
+        }
+    }
+};
+
+bool CreateSphere(float radius, GeometryHolder* holder) {
+    FCL_SPHERE_GEOMETRY_DESC desc = {};
+    desc.Radius = radius;
+    return NT_SUCCESS(FclCreateGeometry(FCL_GEOMETRY_SPHERE, &desc, &holder->Handle));
+}
+
+bool CreateMesh(float radius, GeometryHolder* holder) {
+    const FCL_VECTOR3 vertices[] = {
+        {radius, 0.0f, 0.0f}, {-radius, 0.0f, 0.0f},
+        {0.0f, radius, 0.0f}, {0.0f, -radius, 0.0f},
+        {0.0f, 0.0f, radius}, {0.0f, 0.0f, -radius},
+    };
+    const UINT32 indices[] = {
+        0, 2, 4, 2, 1, 4, 1, 3, 4, 3, 0, 4,
+        2, 0, 5, 1, 2, 5, 3, 1, 5, 0, 3, 5,
+    };
+    FCL_MESH_GEOMETRY_DESC desc = {};
+    desc.Vertices = vertices;
+    desc.VertexCount = static_cast<ULONG>(sizeof(vertices) / sizeof(vertices[0]));
+    desc.Indices = indices;
+    desc.IndexCount = static_cast<ULONG>(sizeof(indices) / sizeof(indices[0]));
+    return NT_SUCCESS(FclCreateGeometry(FCL_GEOMETRY_MESH, &desc, &holder->Handle));
+}
+
+FCL_TRANSFORM PoseForIteration(ULONGLONG iteration) noexcept {
+    FCL_TRANSFORM transform = IdentityTransform();
+    transform.Translation.X = 0.5f + static_cast<float>(iteration % kPoseCount) * 0.03f;
+    transform.Translation.Y = 0.1f;
+    return transform;
+}
+
+#if FCL_MUSA_ENABLE_PHASE_TRACING
+void PrintPhaseBreakdown(const char* label) {
+    static const char* const kPhaseNames[FCL_TRACE_PHASE_COUNT] = {
+        "handle acquire", "binding build", "narrowphase", "result conversion", "upstream query"};
+    static FCL_PHASE_TRACE_SNAPSHOT snapshot = {};
+    FCL_PHASE_TRACE_QUERY query = {};
+    query.Flags = FCL_PHASE_TRACE_FLAG_RESET;
+    if (!NT_SUCCESS(FclQueryPhaseTrace(&query, &snapshot))) {
+        std::printf("  %s: phase trace query failed\n", label);
+        return;
+    }
+    const ULONGLONG upstream = snapshot.Phases[FCL_TRACE_PHASE_UPSTREAM_QUERY].TotalCycles;
+    std::printf("%s (%.2f GHz cycle counter):\n", label, static_cast<double>(snapshot.CyclesPerSecond) * 1.0e-9);
+    for (ULONG phase = 0; phase < FCL_TRACE_PHASE_COUNT; ++phase) {
+        const FCL_PHASE_STATS& stats = snapshot.Phases[phase];
+        std::printf("  %-18s count %8llu  mean %10.1f  min %8llu  max %10llu cycles  %5.1f%% of upstream\n",
+            kPhaseNames[phase],
+            stats.Count,
+            (stats.Count != 0) ? static_cast<double>(stats.TotalCycles) / static_cast<double>(stats.Count) : 0.0,
+            stats.MinCycles,
+            stats.MaxCycles,
+            (upstream != 0) ? 100.0 * static_cast<double>(stats.TotalCycles) / static_cast<double>(upstream) : 0.0);
+    }
+}
+#endif
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ULONGLONG iterations = 100000;
+    if (argc > 1) {
+        iterations = std::strtoull(argv[1], nullptr, 10);
+        if (iterations == 0) {
+            std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!NT_SUCCESS(FclGeometrySubsystemInitialize())) {
+        std::fprintf(stderr, "FclGeometrySubsystemInitialize failed\n");
+        return EXIT_FAILURE;
+    }
+
+    int exitCode = EXIT_SUCCESS;
+    {
+        GeometryHolder sphereA;
+        GeometryHolder sphereB;
+        GeometryHolder mesh;
+        if (!CreateSphere(0.5f, &sphereA) || !CreateSphere(0.4f, &sphereB) || !CreateMesh(0.6f, &mesh)) {
+            std::fprintf(stderr, "failed to create benchmark geometry\n");
+            exitCode = EXIT_FAILURE;
+        } else {
+            auto collide = [&](FCL_GEOMETRY_HANDLE other) {
+                return [&, other](ULONGLONG i) {
+                    const FCL_TRANSFORM pose = PoseForIteration(i);
+                    BOOLEAN hit = FALSE;
+                    FCL_CONTACT_INFO contact = {};
+                    FclCollisionDetect(sphereA.Handle, nullptr, other, &pose, &hit, &contact);
+                    KeepAlive(hit);
+                };
+            };
+
+            FclResetPhaseTrace();
+            PrintHeader(FCL_MUSA_ENABLE_PHASE_TRACING ? "phase tracing: compiled in (ring off)"
+                                                      : "phase tracing: compiled out");
+            PrintResult(Measure("sphere/sphere collision", iterations, collide(sphereB.Handle)));
+            PrintResult(Measure("sphere/mesh collision", iterations, collide(mesh.Handle)));
+
+#if FCL_MUSA_ENABLE_PHASE_TRACING
+            FclEnablePhaseTraceRing(TRUE);
+            PrintHeader("phase tracing: compiled in (ring on)");
+            PrintResult(Measure("sphere/sphere collision", iterations, collide(sphereB.Handle)));
+            PrintResult(Measure("sphere/mesh collision", iterations, collide(mesh.Handle)));
+            FclEnablePhaseTraceRing(FALSE);
+
+            FclResetPhaseTrace();
+            const auto sphereWorkload = collide(sphereB.Handle);
+            for (ULONGLONG i = 0; i < iterations; ++i) {
+                sphereWorkload(i);
+            }
+            PrintPhaseBreakdown("sphere/sphere phase breakdown");
+            const auto meshWorkload = collide(mesh.Handle);
+            for (ULONGLONG i = 0; i < iterations; ++i) {
+                meshWorkload(i);
+            }
+            PrintPhaseBreakdown("sphere/mesh phase breakdown");
+#endif
+        }
+    }
+
+    FclResetPhaseTrace();
+    FclGeometrySubsystemShutdown();
+    return exitCode;
+}
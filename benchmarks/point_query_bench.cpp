@@ -0,0 +1,146 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "bench_common.h"
+
+#include "fclmusa/distance.h"
+#include "fclmusa/geometry.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/platform.h"
+#include "fclmusa/point_query.h"
+
+//
+// 点查询基准：细分球面 Mesh（约 2 万三角形）上对比
+// “每个点一个微小球体 + FclDistanceCompute” 与 FclMeshPointQuery 批量查询（无符号 / 带内外符号）。
+// 点沿一条穿过 Mesh 的螺旋线分布，相邻点空间相干。
+// 用法：FclMusaPointQueryBench [batches]
+//
+
+namespace {
+
+using fclmusa::bench::KeepAlive;
+using fclmusa::bench::Measure;
+using fclmusa::bench::PrintHeader;
+using fclmusa::bench::PrintResult;
+using fclmusa::geom::IdentityTransform;
+
+constexpr ULONG kPointsPerBatch = 256;
+constexpr ULONG kLatitudeSegments = 100;
+constexpr ULONG kLongitudeSegments = 100;
+constexpr float kProbeRadius = 1e-3f;
+
+struct GeometryHolder {
+    FCL_GEOMETRY_HANDLE Handle = {};
+
+    ~GeometryHolder() {
+        if (Handle.Value != 0) {
+            FclDestroyGeometry(Handle);
+        }
+    }
+};
+
+bool CreateSphereMesh(GeometryHolder* holder) {
+    std::vector<FCL_VECTOR3> vertices;
+    std::vector<UINT32> indices;
+    const float pi = 3.14159265f;
+    for (ULONG i = 0; i <= kLatitudeSegments; ++i) {
+        const float theta = pi * static_cast<float>(i) / static_cast<float>(kLatitudeSegments);
+        for (ULONG j = 0; j <= kLongitudeSegments; ++j) {
+            const float phi = 2.0f * pi * static_cast<float>(j) / static_cast<float>(kLongitudeSegments);
+            vertices.push_back({std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta)});
+        }
+    }
+    for (ULONG i = 0; i < kLatitudeSegments; ++i) {
+        for (ULONG j = 0; j < kLongitudeSegments; ++j) {
+            const UINT32 a = i * (kLongitudeSegments + 1) + j;
+            const UINT32 b = a + 1;
+            const UINT32 c = a + kLongitudeSegments + 1;
+            const UINT32 d = c + 1;
+            indices.insert(indices.end(), {a, c, b, b, c, d});
+        }
+    }
+    FCL_MESH_GEOMETRY_DESC desc = {};
+    desc.Vertices = vertices.data();
+    desc.VertexCount = static_cast<ULONG>(vertices.size());
+    desc.Indices = indices.data();
+    desc.IndexCount = static_cast<ULONG>(indices.size());
+    return NT_SUCCESS(FclCreateGeometry(FCL_GEOMETRY_MESH, &desc, &holder->Handle));
+}
+
+std::vector<FCL_VECTOR3> BuildPoints(ULONG count) {
+    std::vector<FCL_VECTOR3> points(count);
+    for (ULONG i = 0; i < count; ++i) {
+        const float t = static_cast<float>(i) / static_cast<float>(count);
+        const float angle = t * 12.0f;
+        const float radius = 0.6f + 0.8f * t;
+        points[i] = {radius * std::cos(angle), radius * std::sin(angle), 1.2f - 2.4f * t};
+    }
+    return points;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ULONGLONG batches = 200;
+    if (argc > 1) {
+        batches = std::strtoull(argv[1], nullptr, 10);
+        if (batches == 0) {
+            std::fprintf(stderr, "usage: %s [batches]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!NT_SUCCESS(FclGeometrySubsystemInitialize())) {
+        std::fprintf(stderr, "FclGeometrySubsystemInitialize failed\n");
+        return EXIT_FAILURE;
+    }
+
+    int exitCode = EXIT_SUCCESS;
+    {
+        GeometryHolder mesh;
+        GeometryHolder probe;
+        FCL_SPHERE_GEOMETRY_DESC probeDesc = {};
+        probeDesc.Radius = kProbeRadius;
+        if (!CreateSphereMesh(&mesh) || !NT_SUCCESS(FclCreateGeometry(FCL_GEOMETRY_SPHERE, &probeDesc, &probe.Handle))) {
+            std::fprintf(stderr, "failed to create benchmark geometry\n");
+            exitCode = EXIT_FAILURE;
+        } else {
+            const std::vector<FCL_VECTOR3> points = BuildPoints(kPointsPerBatch);
+            std::vector<FCL_POINT_QUERY_RESULT> results(points.size());
+            const FCL_TRANSFORM meshPose = IdentityTransform();
+
+            char title[96] = {};
+            std::snprintf(title, sizeof(title), "mesh point query: %lu points per batch", kPointsPerBatch);
+            PrintHeader(title);
+
+            PrintResult(Measure("probe sphere + FclDistanceCompute", batches, [&](ULONGLONG) {
+                float sum = 0.0f;
+                for (const FCL_VECTOR3& point : points) {
+                    FCL_TRANSFORM probePose = IdentityTransform();
+                    probePose.Translation = point;
+                    FCL_DISTANCE_RESULT result = {};
+                    FclDistanceCompute(probe.Handle, &probePose, mesh.Handle, &meshPose, &result);
+                    sum += result.Distance;
+                }
+                KeepAlive(sum);
+            }));
+
+            PrintResult(Measure("FclMeshPointQuery", batches, [&](ULONGLONG) {
+                FclMeshPointQuery(
+                    mesh.Handle, &meshPose, points.data(), kPointsPerBatch, 0.0f, 0, results.data());
+                KeepAlive(results[0].TriangleIndex);
+            }));
+
+            PrintResult(Measure("FclMeshPointQuery signed", batches, [&](ULONGLONG) {
+                FclMeshPointQuery(
+                    mesh.Handle, &meshPose, points.data(), kPointsPerBatch, 0.0f, FCL_POINT_QUERY_FLAG_SIGNED, results.data());
+                KeepAlive(results[0].Inside);
+            }));
+        }
+    }
+
+    FclGeometrySubsystemShutdown();
+    return exitCode;
+}
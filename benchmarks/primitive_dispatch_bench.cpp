@@ -0,0 +1,146 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include "bench_common.h"
+
+#include "fclmusa/collision.h"
+#include "fclmusa/distance.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/narrowphase/query_dispatch.h"
+#include "fclmusa/platform.h"
+#include "fclmusa/upstream/upstream_bridge.h"
+
+//
+// 基本体窄阶段微基准：对比 upstream FCL（虚函数 + 每次构造 CollisionObject）
+// 与 query_dispatch 编译期分派的原生内核。
+// 用法：FclMusaPrimitiveDispatchBench [iterations]
+//
+
+namespace {
+
+using fclmusa::bench::KeepAlive;
+using fclmusa::bench::Measure;
+using fclmusa::bench::PrintHeader;
+using fclmusa::bench::PrintResult;
+using fclmusa::geom::IdentityTransform;
+
+struct PairCase {
+    const char* Label;
+    FCL_GEOMETRY_SNAPSHOT Object1;
+    FCL_GEOMETRY_SNAPSHOT Object2;
+};
+
+FCL_GEOMETRY_SNAPSHOT MakeSphere(float radius) noexcept {
+    FCL_GEOMETRY_SNAPSHOT snapshot = {};
+    snapshot.Type = FCL_GEOMETRY_SPHERE;
+    snapshot.Data.Sphere.Radius = radius;
+    return snapshot;
+}
+
+FCL_GEOMETRY_SNAPSHOT MakeBox(float x, float y, float z) noexcept {
+    FCL_GEOMETRY_SNAPSHOT snapshot = {};
+    snapshot.Type = FCL_GEOMETRY_OBB;
+    snapshot.Data.Obb.Extents = {x, y, z};
+    snapshot.Data.Obb.Rotation = IdentityTransform().Rotation;
+    return snapshot;
+}
+
+FCL_GEOMETRY_SNAPSHOT MakeCapsule(float radius, float halfLength) noexcept {
+    FCL_GEOMETRY_SNAPSHOT snapshot = {};
+    snapshot.Type = FCL_GEOMETRY_CAPSULE;
+    snapshot.Data.Capsule.Rotation = IdentityTransform().Rotation;
+    snapshot.Data.Capsule.Radius = radius;
+    snapshot.Data.Capsule.HalfLength = halfLength;
+    return snapshot;
+}
+
+// 沿 X 轴往返移动对象 2，使命中 / 未命中交替出现，避免分支预测过于理想。
+FCL_TRANSFORM PoseForIteration(ULONGLONG iteration) noexcept {
+    FCL_TRANSFORM transform = IdentityTransform();
+    transform.Translation.X = 0.5f + static_cast<float>(iteration % 64) * 0.05f;
+    transform.Translation.Y = 0.1f;
+    return transform;
+}
+
+void RunCase(const PairCase& pair, ULONGLONG iterations) {
+    const FCL_TRANSFORM origin = IdentityTransform();
+    char name[96] = {};
+
+    std::snprintf(name, sizeof(name), "%s bool upstream", pair.Label);
+    PrintResult(Measure(name, iterations, [&](ULONGLONG i) {
+        BOOLEAN hit = FALSE;
+        const FCL_TRANSFORM pose = PoseForIteration(i);
+        FclUpstreamCollide(pair.Object1, origin, pair.Object2, pose, &hit, nullptr);
+        KeepAlive(hit);
+    }));
+
+    std::snprintf(name, sizeof(name), "%s bool dispatch", pair.Label);
+    PrintResult(Measure(name, iterations, [&](ULONGLONG i) {
+        BOOLEAN hit = FALSE;
+        const FCL_TRANSFORM pose = PoseForIteration(i);
+        fclmusa::narrowphase::DispatchCollision(pair.Object1, origin, pair.Object2, pose, &hit, nullptr);
+        KeepAlive(hit);
+    }));
+
+    std::snprintf(name, sizeof(name), "%s contact upstream", pair.Label);
+    PrintResult(Measure(name, iterations, [&](ULONGLONG i) {
+        BOOLEAN hit = FALSE;
+        FCL_CONTACT_INFO contact = {};
+        const FCL_TRANSFORM pose = PoseForIteration(i);
+        FclUpstreamCollide(pair.Object1, origin, pair.Object2, pose, &hit, &contact);
+        KeepAlive(hit);
+    }));
+
+    std::snprintf(name, sizeof(name), "%s contact dispatch", pair.Label);
+    PrintResult(Measure(name, iterations, [&](ULONGLONG i) {
+        BOOLEAN hit = FALSE;
+        FCL_CONTACT_INFO contact = {};
+        const FCL_TRANSFORM pose = PoseForIteration(i);
+        fclmusa::narrowphase::DispatchCollision(pair.Object1, origin, pair.Object2, pose, &hit, &contact);
+        KeepAlive(hit);
+    }));
+
+    std::snprintf(name, sizeof(name), "%s distance upstream", pair.Label);
+    PrintResult(Measure(name, iterations, [&](ULONGLONG i) {
+        FCL_DISTANCE_RESULT result = {};
+        const FCL_TRANSFORM pose = PoseForIteration(i);
+        FclUpstreamDistance(pair.Object1, origin, pair.Object2, pose, &result);
+        KeepAlive(result.Distance > 0.0f);
+    }));
+
+    std::snprintf(name, sizeof(name), "%s distance dispatch", pair.Label);
+    PrintResult(Measure(name, iterations, [&](ULONGLONG i) {
+        FCL_DISTANCE_RESULT result = {};
+        const FCL_TRANSFORM pose = PoseForIteration(i);
+        fclmusa::narrowphase::DispatchDistance(pair.Object1, origin, pair.Object2, pose, &result);
+        KeepAlive(result.Distance > 0.0f);
+    }));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ULONGLONG iterations = 200000;
+    if (argc > 1) {
+        iterations = std::strtoull(argv[1], nullptr, 10);
+        if (iterations == 0) {
+            std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    const PairCase cases[] = {
+        {"sphere/sphere", MakeSphere(0.5f), MakeSphere(0.75f)},
+        {"sphere/box", MakeSphere(0.5f), MakeBox(0.5f, 0.5f, 0.5f)},
+        {"box/box", MakeBox(0.5f, 0.25f, 0.5f), MakeBox(0.5f, 0.5f, 0.25f)},
+        {"capsule/capsule", MakeCapsule(0.25f, 0.5f), MakeCapsule(0.3f, 0.4f)},
+        {"capsule/sphere", MakeCapsule(0.25f, 0.5f), MakeSphere(0.5f)},
+        {"capsule/box", MakeCapsule(0.25f, 0.5f), MakeBox(0.5f, 0.5f, 0.25f)},
+    };
+
+    PrintHeader("primitive narrowphase dispatch");
+    for (const PairCase& pair : cases) {
+        RunCase(pair, iterations);
+    }
+    return EXIT_SUCCESS;
+}
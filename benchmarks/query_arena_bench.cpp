@@ -0,0 +1,174 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include "bench_common.h"
+
+#include "fclmusa/collision.h"
+#include "fclmusa/distance.h"
+#include "fclmusa/geometry.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/memory/pool_allocator.h"
+#include "fclmusa/memory/query_arena.h"
+#include "fclmusa/platform.h"
+#include "fclmusa/upstream/upstream_bridge.h"
+
+//
+// 查询 arena 基准：同一组 upstream 查询分别在关闭 / 启用查询 arena 时运行，
+// 输出耗时以及每次查询经 fclmusa::memory 的池分配次数（启用后稳态应为 0）。
+// 直接调用 upstream 桥接层，绕过原生内核，保证每次查询都构建 fcl 几何并进入 GJK / EPA。
+// 用法：FclMusaQueryArenaBench [iterations]
+//
+
+namespace {
+
+using fclmusa::bench::KeepAlive;
+using fclmusa::bench::Measure;
+using fclmusa::bench::PrintHeader;
+using fclmusa::bench::PrintResult;
+using fclmusa::geom::IdentityTransform;
+
+constexpr ULONGLONG kPoseCount = 64;
+
+struct ShapeHolder {
+    FCL_GEOMETRY_HANDLE Handle = {};
+    FCL_GEOMETRY_REFERENCE Reference = {};
+    FCL_GEOMETRY_SNAPSHOT Snapshot = {};
+
+    ~ShapeHolder() {
+        FclReleaseGeometryReference(&Reference);
+        if (Handle.Value != 0) {
+            FclDestroyGeometry(Handle);
+        }
+    }
+};
+
+bool Acquire(FCL_GEOMETRY_TYPE type, const void* desc, ShapeHolder* holder) {
+    return NT_SUCCESS(FclCreateGeometry(type, desc, &holder->Handle)) &&
+           NT_SUCCESS(FclAcquireGeometryReference(holder->Handle, &holder->Reference, &holder->Snapshot));
+}
+
+bool CreateBox(float halfExtent, ShapeHolder* holder) {
+    FCL_OBB_GEOMETRY_DESC desc = {};
+    desc.Extents = {halfExtent, halfExtent, halfExtent};
+    desc.Rotation = IdentityTransform().Rotation;
+    return Acquire(FCL_GEOMETRY_OBB, &desc, holder);
+}
+
+bool CreateMesh(float radius, ShapeHolder* holder) {
+    const FCL_VECTOR3 vertices[] = {
+        {radius, 0.0f, 0.0f}, {-radius, 0.0f, 0.0f},
+        {0.0f, radius, 0.0f}, {0.0f, -radius, 0.0f},
+        {0.0f, 0.0f, radius}, {0.0f, 0.0f, -radius},
+    };
+    const UINT32 indices[] = {
+        0, 2, 4, 2, 1, 4, 1, 3, 4, 3, 0, 4,
+        2, 0, 5, 1, 2, 5, 3, 1, 5, 0, 3, 5,
+    };
+    FCL_MESH_GEOMETRY_DESC desc = {};
+    desc.Vertices = vertices;
+    desc.VertexCount = static_cast<ULONG>(sizeof(vertices) / sizeof(vertices[0]));
+    desc.Indices = indices;
+    desc.IndexCount = static_cast<ULONG>(sizeof(indices) / sizeof(indices[0]));
+    return Acquire(FCL_GEOMETRY_MESH, &desc, holder);
+}
+
+// 沿 X 轴往返，使相交（EPA）与分离（GJK 距离）交替出现。
+FCL_TRANSFORM PoseForIteration(ULONGLONG iteration) noexcept {
+    FCL_TRANSFORM transform = IdentityTransform();
+    transform.Translation.X = 0.5f + static_cast<float>(iteration % kPoseCount) * 0.03f;
+    transform.Translation.Y = 0.1f;
+    transform.Translation.Z = 0.05f;
+    return transform;
+}
+
+template <typename Fn>
+void RunCase(const char* label, ULONGLONG iterations, Fn&& query) {
+    char name[96] = {};
+    for (int enabled = 0; enabled < 2; ++enabled) {
+        fclmusa::memory::EnableQueryArena(enabled ? TRUE : FALSE);
+        std::snprintf(name, sizeof(name), "%s (arena %s)", label, enabled ? "on" : "off");
+        PrintResult(Measure(name, iterations, query));
+
+        const FCL_POOL_STATS before = fclmusa::memory::QueryStats();
+        for (ULONGLONG i = 0; i < kPoseCount; ++i) {
+            query(i);
+        }
+        const FCL_POOL_STATS after = fclmusa::memory::QueryStats();
+        std::printf(
+            "  %-40s pool allocations/query = %.2f\n",
+            name,
+            static_cast<double>(after.AllocationCount - before.AllocationCount) / static_cast<double>(kPoseCount));
+    }
+    fclmusa::memory::EnableQueryArena(TRUE);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ULONGLONG iterations = 100000;
+    if (argc > 1) {
+        iterations = std::strtoull(argv[1], nullptr, 10);
+        if (iterations == 0) {
+            std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!NT_SUCCESS(FclGeometrySubsystemInitialize())) {
+        std::fprintf(stderr, "FclGeometrySubsystemInitialize failed\n");
+        return EXIT_FAILURE;
+    }
+    fclmusa::memory::EnablePoolTracking(TRUE);
+
+    int exitCode = EXIT_SUCCESS;
+    {
+        ShapeHolder box;
+        ShapeHolder mesh;
+        if (!CreateBox(0.5f, &box) || !CreateMesh(0.8f, &mesh)) {
+            std::fprintf(stderr, "failed to create benchmark geometry\n");
+            exitCode = EXIT_FAILURE;
+        } else {
+            const FCL_TRANSFORM origin = IdentityTransform();
+            PrintHeader("query arena: upstream queries with / without per-query arena");
+
+            RunCase("box/box contact", iterations, [&](ULONGLONG i) {
+                BOOLEAN hit = FALSE;
+                FCL_CONTACT_INFO contact = {};
+                FclUpstreamCollide(box.Snapshot, origin, box.Snapshot, PoseForIteration(i), &hit, &contact);
+                KeepAlive(hit);
+            });
+
+            RunCase("box/box distance", iterations, [&](ULONGLONG i) {
+                FCL_DISTANCE_RESULT result = {};
+                FclUpstreamDistance(box.Snapshot, origin, box.Snapshot, PoseForIteration(i), &result);
+                KeepAlive(result.Distance > 0.0f);
+            });
+
+            RunCase("box/mesh contact", iterations, [&](ULONGLONG i) {
+                BOOLEAN hit = FALSE;
+                FCL_CONTACT_INFO contact = {};
+                FclUpstreamCollide(box.Snapshot, origin, mesh.Snapshot, PoseForIteration(i), &hit, &contact);
+                KeepAlive(hit);
+            });
+
+            RunCase("mesh/mesh distance", iterations, [&](ULONGLONG i) {
+                FCL_DISTANCE_RESULT result = {};
+                FclUpstreamDistance(mesh.Snapshot, origin, mesh.Snapshot, PoseForIteration(i), &result);
+                KeepAlive(result.Distance > 0.0f);
+            });
+
+            const FCL_QUERY_ARENA_STATS stats = fclmusa::memory::QueryArenaStats();
+            std::printf(
+                "arena: %llu scopes, %llu allocations, %llu fallbacks, %llu chunks, peak %llu bytes/scope\n",
+                stats.ScopeCount,
+                stats.ArenaAllocations,
+                stats.FallbackAllocations,
+                stats.ChunkAllocations,
+                stats.PeakScopeBytes);
+        }
+    }
+
+    fclmusa::memory::EnablePoolTracking(FALSE);
+    FclGeometrySubsystemShutdown();
+    return exitCode;
+}
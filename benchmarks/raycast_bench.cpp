@@ -0,0 +1,178 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "bench_common.h"
+
+#include "fclmusa/geometry.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/platform.h"
+#include "fclmusa/raycast.h"
+
+//
+// 射线查询基准：细分球面 Mesh（约 2 万三角形）上对比单射线遍历、8 射线包遍历与 any-hit。
+// 相干组为同一相机发出的扫描线射线，非相干组为随机起点 / 方向；每次迭代提交 kRaysPerBatch 条射线。
+// 用法：FclMusaRaycastBench [batches]
+//
+
+namespace {
+
+using fclmusa::bench::BenchResult;
+using fclmusa::bench::KeepAlive;
+using fclmusa::bench::Measure;
+using fclmusa::bench::PrintHeader;
+using fclmusa::bench::PrintResult;
+using fclmusa::geom::IdentityTransform;
+
+constexpr ULONG kRaysPerBatch = 256;
+constexpr ULONG kLatitudeSegments = 100;
+constexpr ULONG kLongitudeSegments = 100;
+
+struct ShapeHolder {
+    FCL_GEOMETRY_HANDLE Handle = {};
+    FCL_GEOMETRY_REFERENCE Reference = {};
+    FCL_GEOMETRY_SNAPSHOT Snapshot = {};
+
+    ~ShapeHolder() {
+        FclReleaseGeometryReference(&Reference);
+        if (Handle.Value != 0) {
+            FclDestroyGeometry(Handle);
+        }
+    }
+};
+
+bool CreateSphereMesh(ShapeHolder* holder) {
+    std::vector<FCL_VECTOR3> vertices;
+    std::vector<UINT32> indices;
+    const float pi = 3.14159265f;
+    for (ULONG i = 0; i <= kLatitudeSegments; ++i) {
+        const float theta = pi * static_cast<float>(i) / static_cast<float>(kLatitudeSegments);
+        for (ULONG j = 0; j <= kLongitudeSegments; ++j) {
+            const float phi = 2.0f * pi * static_cast<float>(j) / static_cast<float>(kLongitudeSegments);
+            vertices.push_back({std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta)});
+        }
+    }
+    for (ULONG i = 0; i < kLatitudeSegments; ++i) {
+        for (ULONG j = 0; j < kLongitudeSegments; ++j) {
+            const UINT32 a = i * (kLongitudeSegments + 1) + j;
+            const UINT32 b = a + 1;
+            const UINT32 c = a + kLongitudeSegments + 1;
+            const UINT32 d = c + 1;
+            indices.insert(indices.end(), {a, c, b, b, c, d});
+        }
+    }
+    FCL_MESH_GEOMETRY_DESC desc = {};
+    desc.Vertices = vertices.data();
+    desc.VertexCount = static_cast<ULONG>(vertices.size());
+    desc.Indices = indices.data();
+    desc.IndexCount = static_cast<ULONG>(indices.size());
+    return NT_SUCCESS(FclCreateGeometry(FCL_GEOMETRY_MESH, &desc, &holder->Handle)) &&
+           NT_SUCCESS(FclAcquireGeometryReference(holder->Handle, &holder->Reference, &holder->Snapshot));
+}
+
+float NextUnit(ULONG* state) noexcept {
+    *state = *state * 1664525u + 1013904223u;
+    return static_cast<float>(*state >> 8) / static_cast<float>(1u << 24) * 2.0f - 1.0f;
+}
+
+// 相干射线：相机位于 z = 3，按扫描线顺序覆盖 [-1.2, 1.2]^2 的像平面。
+std::vector<FCL_RAY> BuildCoherentRays(ULONG count) {
+    std::vector<FCL_RAY> rays(count);
+    ULONG side = 1;
+    while (side * side < count) {
+        ++side;
+    }
+    for (ULONG i = 0; i < count; ++i) {
+        const float u = (static_cast<float>(i % side) / static_cast<float>(side)) * 2.4f - 1.2f;
+        const float v = (static_cast<float>(i / side) / static_cast<float>(side)) * 2.4f - 1.2f;
+        rays[i].Origin = {0.0f, 0.0f, 3.0f};
+        rays[i].Direction = {u, v, -3.0f};
+        rays[i].MaxDistance = 0.0f;
+    }
+    return rays;
+}
+
+std::vector<FCL_RAY> BuildIncoherentRays(ULONG count) {
+    std::vector<FCL_RAY> rays(count);
+    ULONG state = 4242u;
+    for (ULONG i = 0; i < count; ++i) {
+        rays[i].Origin = {NextUnit(&state) * 3.0f, NextUnit(&state) * 3.0f, NextUnit(&state) * 3.0f};
+        const FCL_VECTOR3 target = {NextUnit(&state) * 0.8f, NextUnit(&state) * 0.8f, NextUnit(&state) * 0.8f};
+        rays[i].Direction = fclmusa::geom::Subtract(target, rays[i].Origin);
+        rays[i].MaxDistance = 0.0f;
+    }
+    return rays;
+}
+
+void PrintThroughput(const BenchResult& result) {
+    PrintResult(result);
+    if (result.NanosecondsPerOp > 0.0) {
+        std::printf("%-44s %12.2f Mrays/s\n", "", static_cast<double>(kRaysPerBatch) * 1.0e3 / result.NanosecondsPerOp);
+    }
+}
+
+void RunGroup(const char* label, const FCL_GEOMETRY_SNAPSHOT& mesh, const std::vector<FCL_RAY>& rays, ULONGLONG batches) {
+    const FCL_TRANSFORM transform = IdentityTransform();
+    std::vector<FCL_RAY_HIT> hits(rays.size());
+    const struct {
+        const char* Name;
+        ULONG Flags;
+    } modes[] = {
+        {"single ray", 0},
+        {"packet x8", FCL_RAYCAST_FLAG_PACKET},
+        {"single ray any-hit", FCL_RAYCAST_FLAG_ANY_HIT},
+        {"packet x8 any-hit", FCL_RAYCAST_FLAG_PACKET | FCL_RAYCAST_FLAG_ANY_HIT},
+    };
+
+    char name[96] = {};
+    for (const auto& mode : modes) {
+        std::snprintf(name, sizeof(name), "%s %s", label, mode.Name);
+        PrintThroughput(Measure(name, batches, [&](ULONGLONG) {
+            FclRaycastCoreFromSnapshot(
+                &mesh, &transform, rays.data(), static_cast<ULONG>(rays.size()), mode.Flags, hits.data());
+            KeepAlive(hits[0].Hit);
+        }));
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ULONGLONG batches = 2000;
+    if (argc > 1) {
+        batches = std::strtoull(argv[1], nullptr, 10);
+        if (batches == 0) {
+            std::fprintf(stderr, "usage: %s [batches]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!NT_SUCCESS(FclGeometrySubsystemInitialize())) {
+        std::fprintf(stderr, "FclGeometrySubsystemInitialize failed\n");
+        return EXIT_FAILURE;
+    }
+
+    int exitCode = EXIT_SUCCESS;
+    {
+        ShapeHolder mesh;
+        if (!CreateSphereMesh(&mesh)) {
+            std::fprintf(stderr, "failed to create benchmark mesh\n");
+            exitCode = EXIT_FAILURE;
+        } else {
+            char title[128] = {};
+            std::snprintf(
+                title,
+                sizeof(title),
+                "raycast: %lu triangles, %lu rays per batch",
+                mesh.Snapshot.Data.Mesh.IndexCount / 3,
+                kRaysPerBatch);
+            PrintHeader(title);
+            RunGroup("coherent", mesh.Snapshot, BuildCoherentRays(kRaysPerBatch), batches);
+            RunGroup("incoherent", mesh.Snapshot, BuildIncoherentRays(kRaysPerBatch), batches);
+        }
+    }
+
+    FclGeometrySubsystemShutdown();
+    return exitCode;
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+#include "fclmusa/geometry.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/platform.h"
+
+//
+// 基准场景生成器（仅用户态构建）
+// - 全部由 SceneRandom（SplitMix64）按种子生成，不依赖标准库分布的实现细节，同一种子在不同编译器 / 版本间得到相同场景
+// - 每个基准用例以 (全局种子, 用例名) 派生独立种子，增删用例不会改变其他用例的场景
+//
+
+namespace fclmusa::bench::scene {
+
+class SceneRandom {
+public:
+    explicit SceneRandom(ULONGLONG seed) noexcept : state_(seed) {}
+
+    ULONGLONG Next() noexcept {
+        state_ += 0x9E3779B97F4A7C15ULL;
+        ULONGLONG z = state_;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // [0, 1) 上的均匀分布，取高 24 位保证 float 精确表示。
+    float NextUnit() noexcept {
+        return static_cast<float>(Next() >> 40) * (1.0f / 16777216.0f);
+    }
+
+    float Uniform(float low, float high) noexcept {
+        return low + (high - low) * NextUnit();
+    }
+
+private:
+    ULONGLONG state_;
+};
+
+// FNV-1a：把用例名混入全局种子。
+inline ULONGLONG DeriveSeed(ULONGLONG seed, const char* name) noexcept {
+    ULONGLONG hash = 0xCBF29CE484222325ULL;
+    for (const char* p = name; *p != '\0'; ++p) {
+        hash = (hash ^ static_cast<unsigned char>(*p)) * 0x100000001B3ULL;
+    }
+    return seed ^ hash;
+}
+
+// 均匀随机旋转（随机单位四元数转矩阵）。
+inline FCL_MATRIX3X3 RandomRotation(SceneRandom& random) noexcept {
+    const float u1 = random.NextUnit();
+    const float u2 = random.Uniform(0.0f, 6.28318531f);
+    const float u3 = random.Uniform(0.0f, 6.28318531f);
+    const float a = std::sqrt(1.0f - u1);
+    const float b = std::sqrt(u1);
+    const float x = a * std::sin(u2);
+    const float y = a * std::cos(u2);
+    const float z = b * std::sin(u3);
+    const float w = b * std::cos(u3);
+    FCL_MATRIX3X3 m = {};
+    m.M[0][0] = 1.0f - 2.0f * (y * y + z * z);
+    m.M[0][1] = 2.0f * (x * y - z * w);
+    m.M[0][2] = 2.0f * (x * z + y * w);
+    m.M[1][0] = 2.0f * (x * y + z * w);
+    m.M[1][1] = 1.0f - 2.0f * (x * x + z * z);
+    m.M[1][2] = 2.0f * (y * z - x * w);
+    m.M[2][0] = 2.0f * (x * z - y * w);
+    m.M[2][1] = 2.0f * (y * z + x * w);
+    m.M[2][2] = 1.0f - 2.0f * (x * x + y * y);
+    return m;
+}
+
+// 平移在 [-extent, extent]^3 内均匀分布、旋转均匀随机的位姿。
+inline FCL_TRANSFORM RandomPose(SceneRandom& random, float extent) noexcept {
+    FCL_TRANSFORM transform = {};
+    transform.Rotation = RandomRotation(random);
+    transform.Translation = {
+        random.Uniform(-extent, extent), random.Uniform(-extent, extent), random.Uniform(-extent, extent)};
+    return transform;
+}
+
+// count 个随机位姿，供查询循环按下标取模复用（生成代价不计入计时）。
+inline std::vector<FCL_TRANSFORM> RandomPoses(SceneRandom& random, size_t count, float extent) {
+    std::vector<FCL_TRANSFORM> poses(count);
+    for (FCL_TRANSFORM& pose : poses) {
+        pose = RandomPose(random, extent);
+    }
+    return poses;
+}
+
+struct MeshData {
+    std::vector<FCL_VECTOR3> Vertices;
+    std::vector<UINT32> Indices;
+
+    ULONG TriangleCount() const noexcept {
+        return static_cast<ULONG>(Indices.size() / 3);
+    }
+
+    FCL_MESH_GEOMETRY_DESC Desc() const noexcept {
+        FCL_MESH_GEOMETRY_DESC desc = {};
+        desc.Vertices = Vertices.data();
+        desc.VertexCount = static_cast<ULONG>(Vertices.size());
+        desc.Indices = Indices.data();
+        desc.IndexCount = static_cast<ULONG>(Indices.size());
+        return desc;
+    }
+};
+
+// 经纬细分的闭合球面，rings 个纬度带、2 * rings 个经度段，共 4 * rings * (rings - 1) 个三角形，
+// 取最接近 targetTriangles 的 rings；每个顶点的半径按 roughness 做随机扰动，使不同种子的网格不完全对称。
+inline MeshData MakeSphereMesh(SceneRandom& random, ULONG targetTriangles, float radius, float roughness) {
+    ULONG rings = static_cast<ULONG>(std::lround(0.5 + std::sqrt(static_cast<double>(targetTriangles) / 4.0)));
+    rings = (rings < 3) ? 3 : rings;
+    const ULONG segments = rings * 2;
+    const float pi = 3.14159265f;
+
+    MeshData mesh;
+    mesh.Vertices.reserve(static_cast<size_t>(rings - 1) * segments + 2);
+    mesh.Indices.reserve(static_cast<size_t>(rings - 1) * segments * 6);
+    auto jitter = [&]() {
+        return radius * (1.0f + random.Uniform(-roughness, roughness));
+    };
+    mesh.Vertices.push_back({0.0f, 0.0f, jitter()});
+    for (ULONG ring = 1; ring < rings; ++ring) {
+        const float theta = pi * static_cast<float>(ring) / static_cast<float>(rings);
+        for (ULONG segment = 0; segment < segments; ++segment) {
+            const float phi = 2.0f * pi * static_cast<float>(segment) / static_cast<float>(segments);
+            const float r = jitter();
+            mesh.Vertices.push_back(
+                {r * std::sin(theta) * std::cos(phi), r * std::sin(theta) * std::sin(phi), r * std::cos(theta)});
+        }
+    }
+    mesh.Vertices.push_back({0.0f, 0.0f, -jitter()});
+
+    const UINT32 south = static_cast<UINT32>(mesh.Vertices.size() - 1);
+    auto ringVertex = [segments](ULONG ring, ULONG segment) {
+        return static_cast<UINT32>(1 + (ring - 1) * segments + (segment % segments));
+    };
+    for (ULONG segment = 0; segment < segments; ++segment) {
+        mesh.Indices.insert(mesh.Indices.end(), {0, ringVertex(1, segment), ringVertex(1, segment + 1)});
+    }
+    for (ULONG ring = 1; ring + 1 < rings; ++ring) {
+        for (ULONG segment = 0; segment < segments; ++segment) {
+            const UINT32 a = ringVertex(ring, segment);
+            const UINT32 b = ringVertex(ring + 1, segment);
+            const UINT32 c = ringVertex(ring + 1, segment + 1);
+            const UINT32 d = ringVertex(ring, segment + 1);
+            mesh.Indices.insert(mesh.Indices.end(), {a, b, c, a, c, d});
+        }
+    }
+    for (ULONG segment = 0; segment < segments; ++segment) {
+        mesh.Indices.insert(
+            mesh.Indices.end(), {south, ringVertex(rings - 1, segment + 1), ringVertex(rings - 1, segment)});
+    }
+    return mesh;
+}
+
+// 同拓扑的顶点扰动（模拟形变），用于 FclUpdateMeshGeometry 基准。
+inline std::vector<FCL_VECTOR3> PerturbVertices(
+    SceneRandom& random, const std::vector<FCL_VECTOR3>& vertices, float amplitude) {
+    std::vector<FCL_VECTOR3> result(vertices);
+    for (FCL_VECTOR3& vertex : result) {
+        vertex.X += random.Uniform(-amplitude, amplitude);
+        vertex.Y += random.Uniform(-amplitude, amplitude);
+        vertex.Z += random.Uniform(-amplitude, amplitude);
+    }
+    return result;
+}
+
+enum class PrimitiveKind {
+    Sphere,
+    Box,
+    Capsule,
+    Cylinder,
+};
+
+// 以局部原点为中心的基本体，尺寸在 [minSize, maxSize] 内随机。
+inline NTSTATUS CreateRandomPrimitive(
+    SceneRandom& random, PrimitiveKind kind, float minSize, float maxSize, PFCL_GEOMETRY_HANDLE handle) noexcept {
+    const FCL_MATRIX3X3 identity = fclmusa::geom::IdentityTransform().Rotation;
+    switch (kind) {
+        case PrimitiveKind::Sphere: {
+            FCL_SPHERE_GEOMETRY_DESC desc = {};
+            desc.Radius = random.Uniform(minSize, maxSize);
+            return FclCreateGeometry(FCL_GEOMETRY_SPHERE, &desc, handle);
+        }
+        case PrimitiveKind::Box: {
+            FCL_OBB_GEOMETRY_DESC desc = {};
+            desc.Extents = {
+                random.Uniform(minSize, maxSize), random.Uniform(minSize, maxSize), random.Uniform(minSize, maxSize)};
+            desc.Rotation = identity;
+            return FclCreateGeometry(FCL_GEOMETRY_OBB, &desc, handle);
+        }
+        case PrimitiveKind::Capsule: {
+            FCL_CAPSULE_GEOMETRY_DESC desc = {};
+            desc.Rotation = identity;
+            desc.Radius = random.Uniform(minSize, maxSize) * 0.5f;
+            desc.HalfLength = random.Uniform(minSize, maxSize);
+            return FclCreateGeometry(FCL_GEOMETRY_CAPSULE, &desc, handle);
+        }
+        case PrimitiveKind::Cylinder:
+        default: {
+            FCL_CYLINDER_GEOMETRY_DESC desc = {};
+            desc.Rotation = identity;
+            desc.Radius = random.Uniform(minSize, maxSize) * 0.5f;
+            desc.HalfLength = random.Uniform(minSize, maxSize);
+            return FclCreateGeometry(FCL_GEOMETRY_CYLINDER, &desc, handle);
+        }
+    }
+}
+
+}  // namespace fclmusa::bench::scene
@@ -0,0 +1,155 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include "bench_common.h"
+
+#include "fclmusa/collision.h"
+#include "fclmusa/geometry.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/platform.h"
+#include "fclmusa/shape_cast.h"
+
+//
+// 形状扫掠基准：对比“对 FclCollisionCoreFromSnapshots 二分 20 次”与 FclShapeCastCoreFromSnapshots。
+// 扫掠形状从左侧以不同高度穿过目标，命中 / 掠过交替出现。
+// 用法：FclMusaShapeCastBench [iterations]
+//
+
+namespace {
+
+using fclmusa::bench::KeepAlive;
+using fclmusa::bench::Measure;
+using fclmusa::bench::PrintHeader;
+using fclmusa::bench::PrintResult;
+using fclmusa::geom::IdentityTransform;
+
+constexpr int kBisectionSteps = 20;
+
+struct ShapeHolder {
+    FCL_GEOMETRY_HANDLE Handle = {};
+    FCL_GEOMETRY_REFERENCE Reference = {};
+    FCL_GEOMETRY_SNAPSHOT Snapshot = {};
+
+    ~ShapeHolder() {
+        FclReleaseGeometryReference(&Reference);
+        if (Handle.Value != 0) {
+            FclDestroyGeometry(Handle);
+        }
+    }
+};
+
+bool Acquire(FCL_GEOMETRY_TYPE type, const void* desc, ShapeHolder* holder) {
+    return NT_SUCCESS(FclCreateGeometry(type, desc, &holder->Handle)) &&
+           NT_SUCCESS(FclAcquireGeometryReference(holder->Handle, &holder->Reference, &holder->Snapshot));
+}
+
+bool CreateMesh(float halfExtent, ShapeHolder* holder) {
+    const float h = halfExtent;
+    const FCL_VECTOR3 vertices[] = {
+        {-h, -h, -h}, {h, -h, -h}, {h, h, -h}, {-h, h, -h},
+        {-h, -h, h}, {h, -h, h}, {h, h, h}, {-h, h, h},
+    };
+    const UINT32 indices[] = {
+        0, 2, 1, 0, 3, 2, 4, 5, 6, 4, 6, 7, 0, 1, 5, 0, 5, 4,
+        1, 2, 6, 1, 6, 5, 2, 3, 7, 2, 7, 6, 3, 0, 4, 3, 4, 7,
+    };
+    FCL_MESH_GEOMETRY_DESC desc = {};
+    desc.Vertices = vertices;
+    desc.VertexCount = sizeof(vertices) / sizeof(vertices[0]);
+    desc.Indices = indices;
+    desc.IndexCount = sizeof(indices) / sizeof(indices[0]);
+    return Acquire(FCL_GEOMETRY_MESH, &desc, holder);
+}
+
+FCL_TRANSFORM StartForIteration(ULONGLONG iteration) noexcept {
+    FCL_TRANSFORM start = IdentityTransform();
+    start.Translation = {-4.0f, static_cast<float>(iteration % 32) * 0.05f, 0.0f};
+    return start;
+}
+
+// 现有做法：只知道终点相交时，在 [0,1] 上二分查找首次相交时刻。
+double Bisect(
+    const FCL_GEOMETRY_SNAPSHOT& shape,
+    const FCL_TRANSFORM& start,
+    const FCL_VECTOR3& translation,
+    const FCL_GEOMETRY_SNAPSHOT& target,
+    const FCL_TRANSFORM& targetTransform) noexcept {
+    double low = 0.0;
+    double high = 1.0;
+    for (int step = 0; step < kBisectionSteps; ++step) {
+        const double middle = 0.5 * (low + high);
+        FCL_TRANSFORM pose = start;
+        pose.Translation = fclmusa::geom::Add(start.Translation, fclmusa::geom::Scale(translation, static_cast<float>(middle)));
+        BOOLEAN colliding = FALSE;
+        FclCollisionCoreFromSnapshots(&shape, &pose, &target, &targetTransform, &colliding, nullptr);
+        if (colliding) {
+            high = middle;
+        } else {
+            low = middle;
+        }
+    }
+    return high;
+}
+
+void RunCase(const char* label, const FCL_GEOMETRY_SNAPSHOT& shape, const FCL_GEOMETRY_SNAPSHOT& target, ULONGLONG iterations) {
+    const FCL_TRANSFORM targetTransform = IdentityTransform();
+    const FCL_VECTOR3 translation = {4.0f, 0.0f, 0.0f};
+    char name[96] = {};
+
+    std::snprintf(name, sizeof(name), "%s bisection x%d", label, kBisectionSteps);
+    PrintResult(Measure(name, iterations, [&](ULONGLONG i) {
+        KeepAlive(Bisect(shape, StartForIteration(i), translation, target, targetTransform));
+    }));
+
+    std::snprintf(name, sizeof(name), "%s shape cast", label);
+    PrintResult(Measure(name, iterations, [&](ULONGLONG i) {
+        const FCL_TRANSFORM start = StartForIteration(i);
+        FCL_SHAPE_CAST_RESULT result = {};
+        FclShapeCastCoreFromSnapshots(&shape, &start, &translation, &target, &targetTransform, 0.0f, 0, &result);
+        KeepAlive(result.Fraction);
+    }));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ULONGLONG iterations = 20000;
+    if (argc > 1) {
+        iterations = std::strtoull(argv[1], nullptr, 10);
+        if (iterations == 0) {
+            std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!NT_SUCCESS(FclGeometrySubsystemInitialize())) {
+        std::fprintf(stderr, "FclGeometrySubsystemInitialize failed\n");
+        return EXIT_FAILURE;
+    }
+
+    int exitCode = EXIT_SUCCESS;
+    {
+        ShapeHolder sphere;
+        ShapeHolder box;
+        ShapeHolder mesh;
+        FCL_SPHERE_GEOMETRY_DESC sphereDesc = {};
+        sphereDesc.Radius = 0.25f;
+        FCL_OBB_GEOMETRY_DESC boxDesc = {};
+        boxDesc.Extents = {0.5f, 0.5f, 0.5f};
+        boxDesc.Rotation = IdentityTransform().Rotation;
+        if (!Acquire(FCL_GEOMETRY_SPHERE, &sphereDesc, &sphere) ||
+            !Acquire(FCL_GEOMETRY_OBB, &boxDesc, &box) ||
+            !CreateMesh(0.5f, &mesh)) {
+            std::fprintf(stderr, "failed to create benchmark geometry\n");
+            exitCode = EXIT_FAILURE;
+        } else {
+            PrintHeader("shape cast: bisection over collision vs sweep query");
+            RunCase("sphere/box", sphere.Snapshot, box.Snapshot, iterations);
+            RunCase("sphere/mesh", sphere.Snapshot, mesh.Snapshot, iterations);
+            RunCase("box/mesh", box.Snapshot, mesh.Snapshot, iterations);
+        }
+    }
+
+    FclGeometrySubsystemShutdown();
+    return exitCode;
+}
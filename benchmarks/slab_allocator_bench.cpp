@@ -0,0 +1,119 @@
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "bench_common.h"
+
+#include "fclmusa/memory/pool_allocator.h"
+#include "fclmusa/memory/slab_allocator.h"
+#include "fclmusa/platform.h"
+
+//
+// 多线程分配基准：每个线程循环「分配 64 个 16..2000 字节的块，再全部释放」，
+// 分别在 slab 缓存关闭（直接 malloc）与启用时，按 1、2、4 … 个线程统计总吞吐（Mops/s）与相对单线程的加速比。
+// 启用时小块只命中线程本地 magazine，吞吐应随线程数近似线性增长。
+// 用法：FclMusaSlabAllocatorBench [rounds] [maxThreads]
+//
+
+namespace {
+
+using fclmusa::bench::KeepAlive;
+
+constexpr ULONG kBatchSize = 64;
+
+// 大小分布偏向 libccd / shared_ptr 控制块一类的小对象，少量接近 slab 上限。
+constexpr size_t kSizes[kBatchSize] = {
+    16, 24, 32, 48, 64, 40, 96, 128, 24, 32, 56, 72, 200, 16, 48, 300,
+    16, 24, 32, 48, 64, 40, 96, 128, 24, 32, 56, 72, 512, 16, 48, 800,
+    16, 24, 32, 48, 64, 40, 96, 128, 24, 32, 56, 72, 200, 16, 48, 1200,
+    16, 24, 32, 48, 64, 40, 96, 128, 24, 32, 56, 72, 512, 16, 48, 2000,
+};
+
+void Worker(ULONGLONG rounds, ULONGLONG* failures) {
+    void* blocks[kBatchSize] = {};
+    ULONGLONG failed = 0;
+    for (ULONGLONG round = 0; round < rounds; ++round) {
+        for (ULONG i = 0; i < kBatchSize; ++i) {
+            blocks[i] = fclmusa::memory::Allocate(kSizes[i]);
+            failed += (blocks[i] == nullptr) ? 1 : 0;
+        }
+        for (ULONG i = kBatchSize; i > 0; --i) {
+            fclmusa::memory::Free(blocks[i - 1]);
+        }
+    }
+    *failures = failed;
+}
+
+double RunThreads(ULONG threadCount, ULONGLONG rounds) {
+    std::vector<std::thread> threads;
+    std::vector<ULONGLONG> failures(threadCount, 0);
+    threads.reserve(threadCount);
+
+    LARGE_INTEGER frequency = {};
+    LARGE_INTEGER start = {};
+    LARGE_INTEGER end = {};
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&start);
+    for (ULONG t = 0; t < threadCount; ++t) {
+        threads.emplace_back(Worker, rounds, &failures[t]);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    QueryPerformanceCounter(&end);
+
+    for (ULONGLONG failed : failures) {
+        KeepAlive(failed);
+    }
+    const double seconds =
+        static_cast<double>(end.QuadPart - start.QuadPart) / static_cast<double>(frequency.QuadPart);
+    const double operations = static_cast<double>(threadCount) * static_cast<double>(rounds) * kBatchSize * 2.0;
+    return (seconds > 0.0) ? operations / seconds / 1.0e6 : 0.0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ULONGLONG rounds = 50000;
+    ULONG maxThreads = std::thread::hardware_concurrency();
+    if (argc > 1) {
+        rounds = std::strtoull(argv[1], nullptr, 10);
+    }
+    if (argc > 2) {
+        maxThreads = static_cast<ULONG>(std::strtoul(argv[2], nullptr, 10));
+    }
+    if (rounds == 0 || maxThreads == 0) {
+        std::fprintf(stderr, "usage: %s [rounds] [maxThreads]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    fclmusa::memory::EnablePoolTracking(TRUE);
+
+    std::printf("== slab allocator: %llu rounds x %lu blocks per thread ==\n",
+        static_cast<unsigned long long>(rounds), kBatchSize);
+    std::printf("%-12s %8s %12s %10s\n", "mode", "threads", "Mops/s", "speedup");
+    for (int enabled = 0; enabled < 2; ++enabled) {
+        fclmusa::memory::EnableSlabCache(enabled ? TRUE : FALSE);
+        const char* mode = enabled ? "slab" : "system";
+        RunThreads(1, rounds / 10 + 1);
+        double baseline = 0.0;
+        for (ULONG threads = 1; threads <= maxThreads; threads *= 2) {
+            const double throughput = RunThreads(threads, rounds);
+            if (threads == 1) {
+                baseline = throughput;
+            }
+            std::printf("%-12s %8lu %12.1f %9.2fx\n", mode, threads, throughput,
+                (baseline > 0.0) ? throughput / baseline : 0.0);
+        }
+    }
+    fclmusa::memory::EnableSlabCache(TRUE);
+
+    const FCL_POOL_STATS pool = fclmusa::memory::QueryStats();
+    const FCL_SLAB_STATS slab = fclmusa::memory::QuerySlabStats();
+    std::printf("pool: %llu allocations, %llu bytes in use; slab: %llu pages, %llu refills, %llu flushes\n",
+        pool.AllocationCount, pool.BytesInUse, slab.SlabPages, slab.DepotRefills, slab.DepotFlushes);
+
+    fclmusa::memory::EnablePoolTracking(FALSE);
+    return EXIT_SUCCESS;
+}
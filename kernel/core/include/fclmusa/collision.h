@@ -3,6 +3,7 @@
 #include "fclmusa/platform.h"
 
 #include "fclmusa/geometry.h"
+#include "fclmusa/solver.h"
 
 EXTERN_C_START
 
@@ -21,12 +22,14 @@ typedef struct _FCL_COLLISION_OBJECT_DESC {
 typedef struct _FCL_COLLISION_QUERY_REQUEST {
     ULONG MaxContacts;
     BOOLEAN EnableContactInfo;
+    PFCL_CONTACT_INFO Contacts;   // 可选：调用方提供的接触点数组（容量 MaxContacts），为 NULL 时仅输出 Result.Contact
+    FCL_SOLVER_OPTIONS Solver;    // 零初始化时使用全局默认求解器
 } FCL_COLLISION_QUERY_REQUEST, *PFCL_COLLISION_QUERY_REQUEST;
 
 typedef struct _FCL_COLLISION_QUERY_RESULT {
     BOOLEAN Intersecting;
-    ULONG ContactCount;
-    FCL_CONTACT_INFO Contact;
+    ULONG ContactCount;           // 写入 request->Contacts 的接触点数量
+    FCL_CONTACT_INFO Contact;     // 穿透最深的接触点（与 Contacts[0] 相同）
 } FCL_COLLISION_QUERY_RESULT, *PFCL_COLLISION_QUERY_RESULT;
 
 typedef struct _FCL_INTERP_MOTION_DESC {
@@ -44,6 +47,8 @@ typedef struct _FCL_SCREW_MOTION_DESC {
     FCL_TRANSFORM End;
 } FCL_SCREW_MOTION_DESC, *PFCL_SCREW_MOTION_DESC;
 
+// 螺旋运动：绕过某点的 Axis 旋转 AngularVelocity 弧度，同时沿 Axis 平移 LinearVelocity；
+// OrthogonalTranslation 为区间内垂直于轴的位移分量，用于确定轴线位置。量纲均为“每个区间 [0, 1]”。
 typedef struct _FCL_SCREW_MOTION {
     FCL_TRANSFORM Start;
     FCL_VECTOR3 Axis;
@@ -57,16 +62,69 @@ typedef struct _FCL_CONTINUOUS_COLLISION_QUERY {
     FCL_INTERP_MOTION Motion1;
     FCL_GEOMETRY_HANDLE Object2;
     FCL_INTERP_MOTION Motion2;
+    double Tolerance;             // TOI 容差（toc_err），不是 GJK 收敛容差
+    ULONG MaxIterations;          // 保守推进迭代上限，不是 GJK 迭代上限
+    FCL_GJK_SOLVER_TYPE Solver;   // 保守推进内部使用的 GJK 实现，DEFAULT 表示全局默认（GJK 容差 / 迭代次数取求解器默认值）
+} FCL_CONTINUOUS_COLLISION_QUERY, *PFCL_CONTINUOUS_COLLISION_QUERY;
+
+typedef struct _FCL_SCREW_CONTINUOUS_COLLISION_QUERY {
+    FCL_GEOMETRY_HANDLE Object1;
+    FCL_SCREW_MOTION Motion1;
+    FCL_GEOMETRY_HANDLE Object2;
+    FCL_SCREW_MOTION Motion2;
     double Tolerance;
     ULONG MaxIterations;
-} FCL_CONTINUOUS_COLLISION_QUERY, *PFCL_CONTINUOUS_COLLISION_QUERY;
+    FCL_GJK_SOLVER_TYPE Solver;
+} FCL_SCREW_CONTINUOUS_COLLISION_QUERY, *PFCL_SCREW_CONTINUOUS_COLLISION_QUERY;
 
 typedef struct _FCL_CONTINUOUS_COLLISION_RESULT {
     BOOLEAN Intersecting;
     double TimeOfImpact;
+    // TOI 时刻的接触点与法线（对象 1 指向对象 2），解析路径与 upstream 路径语义相同；
+    // 在 TOI 位姿下既无正距离也检测不到接触时 Normal 为零向量。
     FCL_CONTACT_INFO Contact;
 } FCL_CONTINUOUS_COLLISION_RESULT, *PFCL_CONTINUOUS_COLLISION_RESULT;
 
+#define FCL_CONTINUOUS_BATCH_NO_HIT 0xFFFFFFFFUL
+
+typedef struct _FCL_CONTINUOUS_BATCH_OBJECT {
+    FCL_GEOMETRY_HANDLE Handle;
+    FCL_INTERP_MOTION Motion;
+} FCL_CONTINUOUS_BATCH_OBJECT, *PFCL_CONTINUOUS_BATCH_OBJECT;
+
+typedef struct _FCL_CONTINUOUS_BATCH_QUERY {
+    const FCL_CONTINUOUS_BATCH_OBJECT* Objects;
+    ULONG ObjectCount;
+    double Tolerance;
+    ULONG MaxIterations;
+    FCL_GJK_SOLVER_TYPE Solver;
+} FCL_CONTINUOUS_BATCH_QUERY, *PFCL_CONTINUOUS_BATCH_QUERY;
+
+// 单个对象的最早碰撞：Partner 为对方在 Objects 中的索引；Result.Contact 以本对象为 Object1。
+typedef struct _FCL_CONTINUOUS_BATCH_HIT {
+    ULONG Partner;                // 未碰撞时为 FCL_CONTINUOUS_BATCH_NO_HIT，TimeOfImpact = 1
+    FCL_CONTINUOUS_COLLISION_RESULT Result;
+} FCL_CONTINUOUS_BATCH_HIT, *PFCL_CONTINUOUS_BATCH_HIT;
+
+typedef struct _FCL_CONTINUOUS_BATCH_RESULT {
+    ULONG Object1;                // 全局最早碰撞对的索引（Object1 < Object2），无碰撞时为 FCL_CONTINUOUS_BATCH_NO_HIT
+    ULONG Object2;
+    FCL_CONTINUOUS_COLLISION_RESULT Earliest;
+    ULONG CandidatePairCount;     // 扫掠 AABB 重叠、进入窄阶段的对数
+    ULONG HitPairCount;
+} FCL_CONTINUOUS_BATCH_RESULT, *PFCL_CONTINUOUS_BATCH_RESULT;
+
+typedef struct _FCL_COHERENCE_CACHE_STATS {
+    ULONG Capacity;
+    ULONG EntryCount;
+    ULONGLONG Lookups;
+    ULONGLONG SeparatingAxisHits;
+    ULONGLONG Misses;
+    ULONGLONG Evictions;
+    ULONGLONG ContendedBypasses;
+    ULONGLONG DistanceReuses;       // 距离查询直接复用缓存最近点的次数
+} FCL_COHERENCE_CACHE_STATS, *PFCL_COHERENCE_CACHE_STATS;
+
 NTSTATUS
 FclCollisionDetect(
     _In_ FCL_GEOMETRY_HANDLE object1,
@@ -76,6 +134,17 @@ FclCollisionDetect(
     _Out_ PBOOLEAN isColliding,
     _Out_opt_ PFCL_CONTACT_INFO contactInfo) noexcept;
 
+// 与 FclCollisionDetect 相同，另外输出命中的子形状序号（见 FCL_COMPOUND_CHILD_PAIR）；不使用相干性缓存。
+NTSTATUS
+FclCompoundCollisionDetect(
+    _In_ FCL_GEOMETRY_HANDLE object1,
+    _In_opt_ const FCL_TRANSFORM* transform1,
+    _In_ FCL_GEOMETRY_HANDLE object2,
+    _In_opt_ const FCL_TRANSFORM* transform2,
+    _Out_ PBOOLEAN isColliding,
+    _Out_opt_ PFCL_CONTACT_INFO contactInfo,
+    _Out_ PFCL_COMPOUND_CHILD_PAIR children) noexcept;
+
 NTSTATUS
 FclCollideObjects(
     _In_ const FCL_COLLISION_OBJECT_DESC* object1,
@@ -110,10 +179,45 @@ FclContinuousCollision(
     _In_ const FCL_CONTINUOUS_COLLISION_QUERY* query,
     _Out_ PFCL_CONTINUOUS_COLLISION_RESULT result) noexcept;
 
+// 螺旋运动 CCD：upstream CCDM_SCREW 保守推进，扫掠包围球不相交时直接返回未碰撞。
+NTSTATUS
+FclScrewContinuousCollision(
+    _In_ const FCL_SCREW_CONTINUOUS_COLLISION_QUERY* query,
+    _Out_ PFCL_CONTINUOUS_COLLISION_RESULT result) noexcept;
+
+// 批量 CCD：由起止位姿构建扫掠 AABB，排序扫描得到候选对后只对候选对做窄阶段 CCD。
+// perObjectHits 可选（容量 ObjectCount）；用户态下窄阶段分发到线程池并行执行。
+NTSTATUS
+FclContinuousCollisionBatch(
+    _In_ const FCL_CONTINUOUS_BATCH_QUERY* query,
+    _Out_writes_opt_(query->ObjectCount) PFCL_CONTINUOUS_BATCH_HIT perObjectHits,
+    _Out_ PFCL_CONTINUOUS_BATCH_RESULT result) noexcept;
+
+//
+// 时间相干性缓存（可选，默认关闭）
+// - capacity 为缓存的句柄对上限，0 表示关闭并释放缓存；需在 PASSIVE_LEVEL 调用
+// - 开启后 FclCollisionDetect / FclDistanceQuery / FclCollisionCoreFromSnapshotsCoherent 先查询缓存再进入窄阶段；
+//   FclDistanceCompute 只把结果写入缓存，不读取
+// - 条目记录两侧快照的 Generation，几何版本变化后的旧条目不会被采用
+// - 销毁几何或更新 Mesh 时会自动失效对应条目；几何子系统关闭时释放缓存
+//
+NTSTATUS
+FclCoherenceCacheConfigure(
+    _In_ ULONG capacity) noexcept;
+
+VOID
+FclCoherenceCacheInvalidateGeometry(
+    _In_ FCL_GEOMETRY_HANDLE handle) noexcept;
+
+NTSTATUS
+FclCoherenceCacheQueryStats(
+    _Out_ PFCL_COHERENCE_CACHE_STATS stats) noexcept;
+
 //
 // 内部 Snapshot Core API（IRQL <= DISPATCH_LEVEL，可在 DPC 中调用）
 // - 仅使用几何快照 / 变换 / 运动描述，不执行句柄查找或加锁
 // - 外部调用方负责确保所有指针指向 NonPagedPool 中的有效数据
+// - 在 DISPATCH_LEVEL 调用时 upstream 路径的临时分配只从 DPC 预留池取块，预留池耗尽时返回 STATUS_INSUFFICIENT_RESOURCES
 //
 NTSTATUS
 FclCollisionCoreFromSnapshots(
@@ -124,6 +228,31 @@ FclCollisionCoreFromSnapshots(
     _Out_ PBOOLEAN isColliding,
     _Out_opt_ PFCL_CONTACT_INFO contactInfo) noexcept;
 
+// 与 FclCollisionCoreFromSnapshots 相同，但以句柄对为键使用时间相干性缓存（句柄仅作缓存键，不做查找）。
+NTSTATUS
+FclCollisionCoreFromSnapshotsCoherent(
+    _In_ FCL_GEOMETRY_HANDLE handle1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object1,
+    _In_ const FCL_TRANSFORM* transform1,
+    _In_ FCL_GEOMETRY_HANDLE handle2,
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object2,
+    _In_ const FCL_TRANSFORM* transform2,
+    _Out_ PBOOLEAN isColliding,
+    _Out_opt_ PFCL_CONTACT_INFO contactInfo) noexcept;
+
+// 多接触点版本：一次窄阶段输出至多 maxContacts 个接触点，写入调用方数组，不额外分配。
+// Mesh 接触按“最深点 + 最远点采样”约简为代表性集合，contacts[0] 始终为最深接触点。
+NTSTATUS
+FclCollisionManifoldCoreFromSnapshots(
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object1,
+    _In_ const FCL_TRANSFORM* transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object2,
+    _In_ const FCL_TRANSFORM* transform2,
+    _In_ ULONG maxContacts,
+    _Out_ PBOOLEAN isColliding,
+    _Out_writes_(maxContacts) PFCL_CONTACT_INFO contacts,
+    _Out_ PULONG contactCount) noexcept;
+
 NTSTATUS
 FclContinuousCollisionCoreFromSnapshots(
     _In_ const FCL_GEOMETRY_SNAPSHOT* object1,
@@ -134,4 +263,14 @@ FclContinuousCollisionCoreFromSnapshots(
     _In_ ULONG maxIterations,
     _Out_ PFCL_CONTINUOUS_COLLISION_RESULT result) noexcept;
 
+NTSTATUS
+FclScrewContinuousCollisionCoreFromSnapshots(
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object1,
+    _In_ const FCL_SCREW_MOTION* motion1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object2,
+    _In_ const FCL_SCREW_MOTION* motion2,
+    _In_ double tolerance,
+    _In_ ULONG maxIterations,
+    _Out_ PFCL_CONTINUOUS_COLLISION_RESULT result) noexcept;
+
 EXTERN_C_END
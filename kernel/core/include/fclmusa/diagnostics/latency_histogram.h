@@ -0,0 +1,103 @@
+﻿#pragma once
+
+#include "fclmusa/platform.h"
+
+#include "fclmusa/geometry.h"
+
+//
+// 查询延迟直方图（log-linear，HDR 风格）
+// - 单位为纳秒：[0, 8) 每纳秒一个桶，此后每个 2 的幂区间 [2^k, 2^(k+1)) 等分为 8 个子桶，桶宽不超过下界的 12.5%；
+//   2^30 ns（约 1.07 s）及以上都计入最后一个桶，最大值仍精确记录
+// - 按查询类型与按（查询类型, 无序几何类型对）各累计一份；按查询类型的直方图按 CPU 分片（内核态按处理器编号、
+//   用户态按线程取模），几何类型对直方图不分片（112 个表项本身把并发更新分散到不同缓存行）；记录只做 Interlocked 加法，无锁
+// - 百分位在查询时由桶计数求得：取目标秩所在桶的上界并截断到记录到的最大值，即只会高估、不会低估
+// - FCL_LATENCY_QUERY_FLAG_RESET 在读取的同时把所读的直方图清零（逐计数器原子交换，并发写入不会丢失，只会落入下一个窗口），
+//   用于按固定窗口监控尾延迟
+//
+
+#define FCL_LATENCY_SUB_BUCKET_BITS 3
+#define FCL_LATENCY_SUB_BUCKETS (1u << FCL_LATENCY_SUB_BUCKET_BITS)
+#define FCL_LATENCY_MAX_EXPONENT 30
+// 桶 b < 8 统计恰为 b ns 的样本；其余桶 b 的下界为 (8 + b % 8) << (b / 8 - 1) ns，上界为下一个桶的下界减 1。
+#define FCL_LATENCY_HISTOGRAM_BUCKETS \
+    (FCL_LATENCY_SUB_BUCKETS + (FCL_LATENCY_MAX_EXPONENT - FCL_LATENCY_SUB_BUCKET_BITS) * FCL_LATENCY_SUB_BUCKETS)
+// 几何类型取值 1..FCL_LATENCY_GEOMETRY_TYPES（与 FCL_GEOMETRY_TYPE 一致），无序类型对共 28 个。
+#define FCL_LATENCY_GEOMETRY_TYPES 7
+#define FCL_LATENCY_GEOMETRY_PAIRS (FCL_LATENCY_GEOMETRY_TYPES * (FCL_LATENCY_GEOMETRY_TYPES + 1) / 2)
+
+// 读取后清零所读的直方图。
+#define FCL_LATENCY_QUERY_FLAG_RESET 0x00000001u
+
+typedef enum _FCL_LATENCY_KIND {
+    FCL_LATENCY_COLLISION = 0,
+    FCL_LATENCY_DISTANCE = 1,
+    FCL_LATENCY_CONTINUOUS_COLLISION = 2,
+    FCL_LATENCY_DPC_COLLISION = 3,  // DISPATCH_LEVEL 下的碰撞查询（同时计入 FCL_LATENCY_COLLISION）
+    FCL_LATENCY_KIND_COUNT = 4,
+} FCL_LATENCY_KIND;
+
+typedef struct _FCL_LATENCY_HISTOGRAM_QUERY {
+    ULONG Kind;   // FCL_LATENCY_KIND
+    ULONG Type1;  // Type1 / Type2 同为 0 时读取该查询类型的汇总直方图，否则读取对应几何类型对（顺序无关）
+    ULONG Type2;
+    ULONG Flags;  // FCL_LATENCY_QUERY_FLAG_*
+} FCL_LATENCY_HISTOGRAM_QUERY, *PFCL_LATENCY_HISTOGRAM_QUERY;
+
+typedef struct _FCL_LATENCY_HISTOGRAM {
+    ULONG Kind;
+    ULONG Type1;  // 规范化为 Type1 <= Type2
+    ULONG Type2;
+    ULONG Reserved;
+    ULONGLONG Count;
+    ULONGLONG TotalNanoseconds;
+    ULONGLONG MinNanoseconds;
+    ULONGLONG MaxNanoseconds;
+    ULONGLONG P50Nanoseconds;
+    ULONGLONG P90Nanoseconds;
+    ULONGLONG P99Nanoseconds;
+    ULONGLONG P999Nanoseconds;
+    ULONGLONG Buckets[FCL_LATENCY_HISTOGRAM_BUCKETS];
+} FCL_LATENCY_HISTOGRAM, *PFCL_LATENCY_HISTOGRAM;
+
+EXTERN_C_START
+
+// Kind 越界、类型对只给出一侧或类型不在 1..FCL_LATENCY_GEOMETRY_TYPES 内时返回 STATUS_INVALID_PARAMETER。任意 IRQL。
+NTSTATUS
+FclQueryLatencyHistogram(
+    _In_ const FCL_LATENCY_HISTOGRAM_QUERY* query,
+    _Out_ PFCL_LATENCY_HISTOGRAM histogram) noexcept;
+
+// 清零全部查询类型与几何类型对直方图。
+VOID
+FclResetLatencyHistograms() noexcept;
+
+EXTERN_C_END
+
+namespace fclmusa::diagnostics {
+
+// 查询计时：记录起点的性能计数器值，结束时先求计数差再换算为纳秒，系统长时间运行后换算也不会溢出。
+class LatencyStopwatch {
+public:
+    LatencyStopwatch() noexcept;
+
+    ULONGLONG ElapsedNanoseconds() const noexcept;
+
+private:
+    LONGLONG start_;
+};
+
+// 计入查询类型直方图；type1 / type2 都是有效几何类型时同时计入对应的类型对直方图。
+void RecordLatency(
+    _In_ FCL_LATENCY_KIND kind,
+    _In_ FCL_GEOMETRY_TYPE type1,
+    _In_ FCL_GEOMETRY_TYPE type2,
+    _In_ ULONGLONG durationNanoseconds) noexcept;
+
+ULONG LatencyBucketIndex(_In_ ULONGLONG durationNanoseconds) noexcept;
+
+ULONGLONG LatencyBucketLowerBound(_In_ ULONG bucket) noexcept;
+
+// 最后一个桶没有上界，返回 ULONGLONG 最大值。
+ULONGLONG LatencyBucketUpperBound(_In_ ULONG bucket) noexcept;
+
+}  // namespace fclmusa::diagnostics
@@ -0,0 +1,125 @@
+﻿#pragma once
+
+#include "fclmusa/platform.h"
+
+//
+// 查询阶段追踪（周期计数器计时）
+// - 编译开关 FCL_MUSA_ENABLE_PHASE_TRACING（CMake 选项 FCLMUSA_ENABLE_PHASE_TRACING，默认关闭）；
+//   关闭时 FCL_TRACE_PHASE_SCOPE 展开为空，查询路径没有任何额外开销，查询接口返回 STATUS_NOT_SUPPORTED
+// - 开启时在句柄获取、BuildGeometryBinding、窄阶段（fcl::collide / distance / continuousCollide）、结果转换
+//   以及 FclUpstream* 入口整体上各取一对 ReadTimeStampCounter 时间戳，按阶段累计次数 / 总周期 / 最小 / 最大
+//   （按 CPU 分片，内核态按处理器编号、用户态按线程取模，只做 Interlocked 操作）
+// - 环形缓冲区可在运行时开关（默认关闭）：开启后每个阶段额外写入一条事件，固定 FCL_PHASE_TRACE_RING_CAPACITY 项，
+//   写满后覆盖最旧的事件；写入者以 Interlocked 自增领取槽位、写完后发布序号，读取者只保留读取前后序号一致的事件，
+//   无锁、任意 IRQL
+// - 周期与时间的换算由 CyclesPerSecond 给出（以首次重置 / 查询为校准起点，对照性能计数器估算，运行越久越准）；
+//   samples/cli_demo 的 trace 命令把快照导出为 Chrome trace JSON（chrome://tracing / Perfetto）
+//
+
+#ifndef FCL_MUSA_ENABLE_PHASE_TRACING
+#define FCL_MUSA_ENABLE_PHASE_TRACING 0
+#endif
+
+#define FCL_PHASE_TRACE_RING_CAPACITY 4096
+
+// 读取后清零阶段统计并丢弃已读出的事件。
+#define FCL_PHASE_TRACE_FLAG_RESET 0x00000001u
+// 读取后开启 / 关闭环形缓冲区写入（同时给出时以关闭为准）。
+#define FCL_PHASE_TRACE_FLAG_ENABLE_RING 0x00000002u
+#define FCL_PHASE_TRACE_FLAG_DISABLE_RING 0x00000004u
+
+typedef enum _FCL_TRACE_PHASE {
+    FCL_TRACE_PHASE_HANDLE_ACQUIRE = 0,     // FclAcquireGeometryReference：句柄查找与引用获取
+    FCL_TRACE_PHASE_BINDING_BUILD = 1,      // BuildGeometryBinding：快照转换为 upstream 几何（Mesh 含 BVH 构建）
+    FCL_TRACE_PHASE_NARROWPHASE = 2,        // fcl::collide / distance / continuousCollide
+    FCL_TRACE_PHASE_RESULT_CONVERSION = 3,  // upstream 结果写回 FCL_* 结构
+    FCL_TRACE_PHASE_UPSTREAM_QUERY = 4,     // FclUpstream* 入口整体（包含 1–3）
+    FCL_TRACE_PHASE_COUNT = 5,
+} FCL_TRACE_PHASE;
+
+typedef struct _FCL_PHASE_STATS {
+    ULONGLONG Count;
+    ULONGLONG TotalCycles;
+    ULONGLONG MinCycles;  // Count 为 0 时为 0
+    ULONGLONG MaxCycles;
+} FCL_PHASE_STATS, *PFCL_PHASE_STATS;
+
+typedef struct _FCL_PHASE_TRACE_EVENT {
+    ULONGLONG StartCycles;
+    ULONGLONG DurationCycles;
+    ULONG Phase;      // FCL_TRACE_PHASE
+    ULONG Processor;  // 内核态为处理器编号，用户态为进程内线程序号
+    ULONGLONG Sequence;  // 自最近一次重置起的写入序号，从 1 开始；不连续说明中间的事件已被覆盖
+} FCL_PHASE_TRACE_EVENT, *PFCL_PHASE_TRACE_EVENT;
+
+typedef struct _FCL_PHASE_TRACE_QUERY {
+    ULONG Flags;  // FCL_PHASE_TRACE_FLAG_*
+    ULONG Reserved;
+} FCL_PHASE_TRACE_QUERY, *PFCL_PHASE_TRACE_QUERY;
+
+typedef struct _FCL_PHASE_TRACE_SNAPSHOT {
+    BOOLEAN Enabled;      // 是否编译了阶段追踪支持
+    BOOLEAN RingEnabled;  // 读取时环形缓冲区是否在写入
+    UCHAR Reserved[2];
+    ULONG EventCount;     // Events 中的有效项，按序号从旧到新排列
+    ULONGLONG TotalEvents;       // 自最近一次重置起写入的事件总数（含已被覆盖的）
+    ULONGLONG CyclesPerSecond;   // 0 表示距校准起点不足 1 ms、尚无法估算
+    FCL_PHASE_STATS Phases[FCL_TRACE_PHASE_COUNT];  // 下标即 FCL_TRACE_PHASE
+    FCL_PHASE_TRACE_EVENT Events[FCL_PHASE_TRACE_RING_CAPACITY];
+} FCL_PHASE_TRACE_SNAPSHOT, *PFCL_PHASE_TRACE_SNAPSHOT;
+
+EXTERN_C_START
+
+// 未编译阶段追踪支持时返回 STATUS_NOT_SUPPORTED（snapshot->Enabled 为 FALSE）。任意 IRQL。
+NTSTATUS
+FclQueryPhaseTrace(
+    _In_ const FCL_PHASE_TRACE_QUERY* query,
+    _Out_ PFCL_PHASE_TRACE_SNAPSHOT snapshot) noexcept;
+
+// 清零阶段统计并丢弃环形缓冲区中的事件；首次调用时同时取周期计数器的校准起点。不改变环形缓冲区开关。
+VOID
+FclResetPhaseTrace() noexcept;
+
+// 开启 / 关闭环形缓冲区写入；未编译阶段追踪支持时返回 STATUS_NOT_SUPPORTED。
+NTSTATUS
+FclEnablePhaseTraceRing(
+    _In_ BOOLEAN enable) noexcept;
+
+EXTERN_C_END
+
+#define FCL_TRACE_PHASE_CONCAT_INNER(a, b) a##b
+#define FCL_TRACE_PHASE_CONCAT(a, b) FCL_TRACE_PHASE_CONCAT_INNER(a, b)
+
+#if FCL_MUSA_ENABLE_PHASE_TRACING
+
+namespace fclmusa::diagnostics {
+
+void RecordPhase(_In_ FCL_TRACE_PHASE phase, _In_ ULONGLONG startCycles, _In_ ULONGLONG endCycles) noexcept;
+
+// 构造时取起点，析构时记录所在作用域的耗时。
+class PhaseScope {
+public:
+    explicit PhaseScope(_In_ FCL_TRACE_PHASE phase) noexcept : phase_(phase), start_(ReadTimeStampCounter()) {}
+
+    ~PhaseScope() noexcept {
+        RecordPhase(phase_, start_, ReadTimeStampCounter());
+    }
+
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+
+private:
+    FCL_TRACE_PHASE phase_;
+    ULONGLONG start_;
+};
+
+}  // namespace fclmusa::diagnostics
+
+#define FCL_TRACE_PHASE_SCOPE(phase) \
+    ::fclmusa::diagnostics::PhaseScope FCL_TRACE_PHASE_CONCAT(fclPhaseScope_, __LINE__)(phase)
+
+#else
+
+#define FCL_TRACE_PHASE_SCOPE(phase) ((void)0)
+
+#endif  // FCL_MUSA_ENABLE_PHASE_TRACING
@@ -0,0 +1,318 @@
+﻿#pragma once
+
+#include "fclmusa/platform.h"
+
+#include "fclmusa/broadphase.h"
+#include "fclmusa/collision.h"
+#include "fclmusa/distance.h"
+#include "fclmusa/geometry.h"
+
+//
+// 查询工作负载录制（运行时开关，默认关闭）
+// - 录制期间按调用顺序记录几何创建（含 Mesh 顶点 / 索引、凸包顶点、复合子形状）、销毁、Mesh 更新，
+//   以及 FclCollisionDetect / FclCollideObjects / FclCompoundCollisionDetect / FclDistanceCompute /
+//   FclCompoundDistanceCompute / FclContinuousCollision / FclScrewContinuousCollision / FclContinuousCollisionBatch /
+//   FclBroadphaseDetect 的参数、结果、返回码、相对录制起点的时间戳与耗时；未录制时每个入口只多一次标志读取
+// - 开始录制时先把已存在的几何按句柄升序写为 FCL_WORKLOAD_RECORD_FLAG_EXISTING 记录（可用 SKIP_EXISTING 跳过），
+//   与开始录制并发的创建可能重复出现，回放按句柄去重
+// - 记录写入开始录制时一次性分配的缓冲区：写入者以 Interlocked 领取偏移、直接复制，无锁；缓冲区写满后丢弃后续记录
+//   并计数（DroppedRecords），已写入的前缀仍是完整的轨迹
+// - 停止后缓冲区即为完整的轨迹文件（FCL_WORKLOAD_TRACE_HEADER + 记录序列），由 FclReadWorkloadRecording 分段读出；
+//   samples/workload_replay 在用户态库上按原速或尽快回放，并按调用类型输出 / 对比延迟分布
+//
+
+#define FCL_WORKLOAD_TRACE_MAGIC 0x574C4346u  // "FCLW"
+#define FCL_WORKLOAD_TRACE_VERSION 2u
+
+#define FCL_WORKLOAD_RECORDING_DEFAULT_CAPACITY (64u * 1024u * 1024u)
+#define FCL_WORKLOAD_RECORDING_MAX_CAPACITY (1024u * 1024u * 1024u)
+
+// 开始录制时不写出已存在的几何。
+#define FCL_WORKLOAD_RECORDING_FLAG_SKIP_EXISTING 0x00000001u
+
+// 记录头 Flags：录制开始时已存在的几何（Timestamp / Duration 为 0）。
+#define FCL_WORKLOAD_RECORD_FLAG_EXISTING 0x0001u
+// FCL_WORKLOAD_PAIR_RECORD::Flags：调用时给出了对应的变换（否则为单位变换，回放时传 NULL）。
+#define FCL_WORKLOAD_PAIR_FLAG_TRANSFORM1 0x00000001u
+#define FCL_WORKLOAD_PAIR_FLAG_TRANSFORM2 0x00000002u
+// FCL_WORKLOAD_COLLIDE_OBJECTS_RECORD::Flags：调用时给出了 request（否则回放时传 NULL）、request->Contacts 非 NULL。
+#define FCL_WORKLOAD_COLLIDE_FLAG_REQUEST 0x00000001u
+#define FCL_WORKLOAD_COLLIDE_FLAG_CONTACT_ARRAY 0x00000002u
+
+typedef enum _FCL_WORKLOAD_RECORD_TYPE {
+    FCL_WORKLOAD_RECORD_GEOMETRY = 1,              // FCL_WORKLOAD_GEOMETRY_RECORD
+    FCL_WORKLOAD_RECORD_DESTROY = 2,               // FCL_WORKLOAD_DESTROY_RECORD
+    FCL_WORKLOAD_RECORD_UPDATE_MESH = 3,           // FCL_WORKLOAD_GEOMETRY_RECORD（GeometryType 为 MESH）
+    FCL_WORKLOAD_RECORD_COLLISION = 4,             // FCL_WORKLOAD_PAIR_RECORD
+    FCL_WORKLOAD_RECORD_DISTANCE = 5,              // FCL_WORKLOAD_PAIR_RECORD
+    FCL_WORKLOAD_RECORD_CONTINUOUS_COLLISION = 6,  // FCL_WORKLOAD_CCD_RECORD
+    FCL_WORKLOAD_RECORD_BROADPHASE = 7,            // FCL_WORKLOAD_BROADPHASE_RECORD
+    FCL_WORKLOAD_RECORD_COLLIDE_OBJECTS = 8,       // FCL_WORKLOAD_COLLIDE_OBJECTS_RECORD
+    FCL_WORKLOAD_RECORD_COMPOUND_COLLISION = 9,    // FCL_WORKLOAD_PAIR_RECORD
+    FCL_WORKLOAD_RECORD_COMPOUND_DISTANCE = 10,    // FCL_WORKLOAD_PAIR_RECORD
+    FCL_WORKLOAD_RECORD_SCREW_CONTINUOUS_COLLISION = 11,  // FCL_WORKLOAD_SCREW_CCD_RECORD
+    FCL_WORKLOAD_RECORD_CONTINUOUS_BATCH = 12,     // FCL_WORKLOAD_CCD_BATCH_RECORD
+    FCL_WORKLOAD_RECORD_TYPE_COUNT = 13,
+} FCL_WORKLOAD_RECORD_TYPE;
+
+// 轨迹文件头，位于偏移 0；RecordCount / DroppedRecords / TraceBytes 在停止录制时写入。
+typedef struct _FCL_WORKLOAD_TRACE_HEADER {
+    ULONG Magic;
+    ULONG Version;
+    ULONG HeaderSize;  // sizeof(FCL_WORKLOAD_TRACE_HEADER)，首条记录的偏移
+    ULONG Reserved;
+    ULONGLONG TimestampFrequency;  // 记录中 Timestamp / Duration 的计数频率（Hz）
+    ULONGLONG RecordCount;
+    ULONGLONG DroppedRecords;
+    ULONGLONG TraceBytes;  // 含文件头的有效长度
+} FCL_WORKLOAD_TRACE_HEADER, *PFCL_WORKLOAD_TRACE_HEADER;
+
+// 每条记录的公共头；Size 含本头部与变长数据，按 8 字节对齐，下一条记录紧随其后。
+typedef struct _FCL_WORKLOAD_RECORD_HEADER {
+    USHORT Type;   // FCL_WORKLOAD_RECORD_TYPE
+    USHORT Flags;  // FCL_WORKLOAD_RECORD_FLAG_*
+    ULONG Size;
+    ULONGLONG Timestamp;  // 调用开始时刻，相对录制起点
+    ULONGLONG Duration;   // 调用耗时（不含录制本身）
+    NTSTATUS Status;      // 调用返回值
+    ULONG Reserved;
+} FCL_WORKLOAD_RECORD_HEADER, *PFCL_WORKLOAD_RECORD_HEADER;
+
+// 几何创建 / Mesh 更新。其后的变长数据：
+// - MESH / CONVEX：FCL_VECTOR3[ElementCount0]，随后 UINT32[ElementCount1]（凸包为凸包顶点，ElementCount1 为 0）
+// - COMPOUND：FCL_COMPOUND_CHILD_DESC[ElementCount0]（子形状以录制时的句柄引用）
+// 创建失败时 Handle 为 0 且没有变长数据。
+typedef struct _FCL_WORKLOAD_GEOMETRY_RECORD {
+    FCL_WORKLOAD_RECORD_HEADER Header;
+    FCL_GEOMETRY_HANDLE Handle;
+    ULONG GeometryType;  // FCL_GEOMETRY_TYPE
+    ULONG ElementCount0;
+    ULONG ElementCount1;
+    ULONG Reserved;
+    union {
+        FCL_SPHERE_GEOMETRY_DESC Sphere;
+        FCL_OBB_GEOMETRY_DESC Obb;
+        FCL_CAPSULE_GEOMETRY_DESC Capsule;
+        FCL_CYLINDER_GEOMETRY_DESC Cylinder;
+    } Shape;
+} FCL_WORKLOAD_GEOMETRY_RECORD, *PFCL_WORKLOAD_GEOMETRY_RECORD;
+
+typedef struct _FCL_WORKLOAD_DESTROY_RECORD {
+    FCL_WORKLOAD_RECORD_HEADER Header;
+    FCL_GEOMETRY_HANDLE Handle;
+} FCL_WORKLOAD_DESTROY_RECORD, *PFCL_WORKLOAD_DESTROY_RECORD;
+
+// 碰撞（Intersecting 有效）与距离（Distance 有效）查询，含复合体版本。
+typedef struct _FCL_WORKLOAD_PAIR_RECORD {
+    FCL_WORKLOAD_RECORD_HEADER Header;
+    FCL_GEOMETRY_HANDLE Handle1;
+    FCL_GEOMETRY_HANDLE Handle2;
+    ULONG Flags;  // FCL_WORKLOAD_PAIR_FLAG_*
+    float Distance;
+    BOOLEAN Intersecting;
+    UCHAR Reserved[7];
+    FCL_TRANSFORM Transform1;
+    FCL_TRANSFORM Transform2;
+} FCL_WORKLOAD_PAIR_RECORD, *PFCL_WORKLOAD_PAIR_RECORD;
+
+typedef struct _FCL_WORKLOAD_CCD_RECORD {
+    FCL_WORKLOAD_RECORD_HEADER Header;
+    FCL_CONTINUOUS_COLLISION_QUERY Query;
+    double TimeOfImpact;
+    BOOLEAN Intersecting;
+    UCHAR Reserved[7];
+} FCL_WORKLOAD_CCD_RECORD, *PFCL_WORKLOAD_CCD_RECORD;
+
+// FclCollideObjects：request 的数组指针不录制，回放时按 MaxContacts 重新分配。
+typedef struct _FCL_WORKLOAD_COLLIDE_OBJECTS_RECORD {
+    FCL_WORKLOAD_RECORD_HEADER Header;
+    FCL_COLLISION_OBJECT_DESC Object1;
+    FCL_COLLISION_OBJECT_DESC Object2;
+    FCL_SOLVER_OPTIONS Solver;
+    ULONG Flags;  // FCL_WORKLOAD_COLLIDE_FLAG_*
+    ULONG MaxContacts;
+    ULONG ContactCount;
+    BOOLEAN EnableContactInfo;
+    BOOLEAN Intersecting;
+    UCHAR Reserved[2];
+} FCL_WORKLOAD_COLLIDE_OBJECTS_RECORD, *PFCL_WORKLOAD_COLLIDE_OBJECTS_RECORD;
+
+typedef struct _FCL_WORKLOAD_SCREW_CCD_RECORD {
+    FCL_WORKLOAD_RECORD_HEADER Header;
+    FCL_SCREW_CONTINUOUS_COLLISION_QUERY Query;
+    double TimeOfImpact;
+    BOOLEAN Intersecting;
+    UCHAR Reserved[7];
+} FCL_WORKLOAD_SCREW_CCD_RECORD, *PFCL_WORKLOAD_SCREW_CCD_RECORD;
+
+// 其后为 FCL_CONTINUOUS_BATCH_OBJECT[ObjectCount]；Object1 / Object2 / TimeOfImpact 为全局最早碰撞对。
+typedef struct _FCL_WORKLOAD_CCD_BATCH_RECORD {
+    FCL_WORKLOAD_RECORD_HEADER Header;
+    double Tolerance;
+    ULONG ObjectCount;
+    ULONG MaxIterations;
+    ULONG Solver;          // FCL_GJK_SOLVER_TYPE
+    ULONG HasPerObjectHits;
+    ULONG Object1;
+    ULONG Object2;
+    double TimeOfImpact;
+    ULONG CandidatePairCount;
+    ULONG HitPairCount;
+} FCL_WORKLOAD_CCD_BATCH_RECORD, *PFCL_WORKLOAD_CCD_BATCH_RECORD;
+
+typedef struct _FCL_WORKLOAD_BROADPHASE_OBJECT {
+    FCL_GEOMETRY_HANDLE Handle;
+    ULONG HasTransform;
+    ULONG Reserved;
+    FCL_TRANSFORM Transform;
+} FCL_WORKLOAD_BROADPHASE_OBJECT, *PFCL_WORKLOAD_BROADPHASE_OBJECT;
+
+// 其后为 FCL_WORKLOAD_BROADPHASE_OBJECT[ObjectCount]。
+typedef struct _FCL_WORKLOAD_BROADPHASE_RECORD {
+    FCL_WORKLOAD_RECORD_HEADER Header;
+    ULONG ObjectCount;
+    ULONG PairCapacity;  // 调用时 pairs 为 NULL 则为 0
+    ULONG PairCount;
+    ULONG Reserved;
+} FCL_WORKLOAD_BROADPHASE_RECORD, *PFCL_WORKLOAD_BROADPHASE_RECORD;
+
+typedef struct _FCL_WORKLOAD_RECORDING_CONFIG {
+    ULONG CapacityBytes;  // 0 表示 FCL_WORKLOAD_RECORDING_DEFAULT_CAPACITY
+    ULONG Flags;          // FCL_WORKLOAD_RECORDING_FLAG_*
+} FCL_WORKLOAD_RECORDING_CONFIG, *PFCL_WORKLOAD_RECORDING_CONFIG;
+
+typedef struct _FCL_WORKLOAD_RECORDING_STATUS {
+    BOOLEAN Recording;
+    BOOLEAN HasTrace;  // 已停止且缓冲区中保留着轨迹
+    UCHAR Reserved[2];
+    ULONG CapacityBytes;
+    ULONGLONG TraceBytes;  // 当前有效长度（含文件头）
+    ULONGLONG RecordCount;
+    ULONGLONG DroppedRecords;
+} FCL_WORKLOAD_RECORDING_STATUS, *PFCL_WORKLOAD_RECORDING_STATUS;
+
+EXTERN_C_START
+
+// 丢弃上一次的轨迹并开始录制；已在录制时返回 STATUS_DEVICE_BUSY，容量超过 FCL_WORKLOAD_RECORDING_MAX_CAPACITY 或
+// 小于一页时返回 STATUS_INVALID_PARAMETER。PASSIVE_LEVEL。
+NTSTATUS
+FclStartWorkloadRecording(
+    _In_opt_ const FCL_WORKLOAD_RECORDING_CONFIG* config) noexcept;
+
+// 停止录制并等待进行中的写入结束，轨迹保留到下一次开始或丢弃；未在录制时返回 STATUS_INVALID_DEVICE_STATE。PASSIVE_LEVEL。
+NTSTATUS
+FclStopWorkloadRecording() noexcept;
+
+VOID
+FclQueryWorkloadRecording(
+    _Out_ PFCL_WORKLOAD_RECORDING_STATUS status) noexcept;
+
+// 从轨迹偏移 offset 处复制最多 bufferSize 字节；录制中或没有轨迹时返回 STATUS_INVALID_DEVICE_STATE，
+// offset 达到 TraceBytes 时返回 STATUS_SUCCESS 且 bytesRead 为 0。PASSIVE_LEVEL。
+NTSTATUS
+FclReadWorkloadRecording(
+    _In_ ULONGLONG offset,
+    _Out_writes_bytes_to_(bufferSize, *bytesRead) PVOID buffer,
+    _In_ ULONG bufferSize,
+    _Out_ PULONG bytesRead) noexcept;
+
+// 停止录制（如在录制）并释放缓冲区。PASSIVE_LEVEL。
+VOID
+FclDiscardWorkloadRecording() noexcept;
+
+EXTERN_C_END
+
+namespace fclmusa::diagnostics {
+
+// 以下由各公开入口调用：先 IsWorkloadRecording()，录制中才取起点时间戳，调用结束后写入记录。
+bool IsWorkloadRecording() noexcept;
+
+ULONGLONG WorkloadTimestamp() noexcept;
+
+void RecordGeometryCreate(
+    _In_ ULONGLONG start,
+    _In_ FCL_GEOMETRY_TYPE type,
+    _In_opt_ const VOID* geometryDesc,
+    _In_ FCL_GEOMETRY_HANDLE handle,
+    _In_ NTSTATUS status) noexcept;
+
+void RecordGeometryDestroy(_In_ ULONGLONG start, _In_ FCL_GEOMETRY_HANDLE handle, _In_ NTSTATUS status) noexcept;
+
+void RecordMeshUpdate(
+    _In_ ULONGLONG start,
+    _In_ FCL_GEOMETRY_HANDLE handle,
+    _In_opt_ const FCL_MESH_GEOMETRY_DESC* geometryDesc,
+    _In_ NTSTATUS status) noexcept;
+
+void RecordCollision(
+    _In_ ULONGLONG start,
+    _In_ FCL_GEOMETRY_HANDLE object1,
+    _In_opt_ const FCL_TRANSFORM* transform1,
+    _In_ FCL_GEOMETRY_HANDLE object2,
+    _In_opt_ const FCL_TRANSFORM* transform2,
+    _In_ BOOLEAN intersecting,
+    _In_ NTSTATUS status) noexcept;
+
+void RecordDistance(
+    _In_ ULONGLONG start,
+    _In_ FCL_GEOMETRY_HANDLE object1,
+    _In_opt_ const FCL_TRANSFORM* transform1,
+    _In_ FCL_GEOMETRY_HANDLE object2,
+    _In_opt_ const FCL_TRANSFORM* transform2,
+    _In_ float distance,
+    _In_ NTSTATUS status) noexcept;
+
+void RecordCompoundCollision(
+    _In_ ULONGLONG start,
+    _In_ FCL_GEOMETRY_HANDLE object1,
+    _In_opt_ const FCL_TRANSFORM* transform1,
+    _In_ FCL_GEOMETRY_HANDLE object2,
+    _In_opt_ const FCL_TRANSFORM* transform2,
+    _In_ BOOLEAN intersecting,
+    _In_ NTSTATUS status) noexcept;
+
+void RecordCompoundDistance(
+    _In_ ULONGLONG start,
+    _In_ FCL_GEOMETRY_HANDLE object1,
+    _In_opt_ const FCL_TRANSFORM* transform1,
+    _In_ FCL_GEOMETRY_HANDLE object2,
+    _In_opt_ const FCL_TRANSFORM* transform2,
+    _In_ float distance,
+    _In_ NTSTATUS status) noexcept;
+
+void RecordCollideObjects(
+    _In_ ULONGLONG start,
+    _In_ const FCL_COLLISION_OBJECT_DESC* object1,
+    _In_ const FCL_COLLISION_OBJECT_DESC* object2,
+    _In_opt_ const FCL_COLLISION_QUERY_REQUEST* request,
+    _In_ const FCL_COLLISION_QUERY_RESULT* result,
+    _In_ NTSTATUS status) noexcept;
+
+void RecordContinuousCollision(
+    _In_ ULONGLONG start,
+    _In_ const FCL_CONTINUOUS_COLLISION_QUERY* query,
+    _In_ const FCL_CONTINUOUS_COLLISION_RESULT* result,
+    _In_ NTSTATUS status) noexcept;
+
+void RecordScrewContinuousCollision(
+    _In_ ULONGLONG start,
+    _In_ const FCL_SCREW_CONTINUOUS_COLLISION_QUERY* query,
+    _In_ const FCL_CONTINUOUS_COLLISION_RESULT* result,
+    _In_ NTSTATUS status) noexcept;
+
+void RecordContinuousBatch(
+    _In_ ULONGLONG start,
+    _In_ const FCL_CONTINUOUS_BATCH_QUERY* query,
+    _In_ BOOLEAN hasPerObjectHits,
+    _In_ const FCL_CONTINUOUS_BATCH_RESULT* result,
+    _In_ NTSTATUS status) noexcept;
+
+void RecordBroadphase(
+    _In_ ULONGLONG start,
+    _In_reads_(objectCount) const FCL_BROADPHASE_OBJECT* objects,
+    _In_ ULONG objectCount,
+    _In_ ULONG pairCapacity,
+    _In_ ULONG pairCount,
+    _In_ NTSTATUS status) noexcept;
+
+}  // namespace fclmusa::diagnostics
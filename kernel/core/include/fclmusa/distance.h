@@ -3,6 +3,7 @@
 #include "fclmusa/platform.h"
 
 #include "fclmusa/geometry.h"
+#include "fclmusa/solver.h"
 
 EXTERN_C_START
 
@@ -12,6 +13,23 @@ typedef struct _FCL_DISTANCE_RESULT {
     FCL_VECTOR3 ClosestPoint2;
 } FCL_DISTANCE_RESULT, *PFCL_DISTANCE_RESULT;
 
+// 跳过最近点计算：结果中的 ClosestPoint1/2 置零，仅返回距离。
+#define FCL_DISTANCE_FLAG_SKIP_NEAREST_POINTS 0x00000001UL
+
+typedef struct _FCL_DISTANCE_REQUEST {
+    float DistanceThreshold;   // > 0 时启用：距离 >= 阈值即提前返回“远于阈值”；<= 0 表示精确计算
+    float RelativeError;       // 对应 fcl::DistanceRequest::rel_err，BVH 遍历按相对误差剪枝
+    float AbsoluteError;       // 对应 fcl::DistanceRequest::abs_err
+    ULONG Flags;               // FCL_DISTANCE_FLAG_*
+    FCL_SOLVER_OPTIONS Solver; // 零初始化时使用全局默认求解器
+} FCL_DISTANCE_REQUEST, *PFCL_DISTANCE_REQUEST;
+
+typedef struct _FCL_DISTANCE_QUERY_RESULT {
+    FCL_DISTANCE_RESULT Result;     // BeyondThreshold 时 Distance 为不小于阈值的下界
+    BOOLEAN BeyondThreshold;        // 两物体距离不小于 DistanceThreshold
+    BOOLEAN NearestPointsValid;     // ClosestPoint1/2 是否有效
+} FCL_DISTANCE_QUERY_RESULT, *PFCL_DISTANCE_QUERY_RESULT;
+
 NTSTATUS
 FclDistanceCompute(
     _In_ FCL_GEOMETRY_HANDLE object1,
@@ -20,9 +38,35 @@ FclDistanceCompute(
     _In_opt_ const FCL_TRANSFORM* transform2,
     _Out_ PFCL_DISTANCE_RESULT result) noexcept;
 
+// 与 FclDistanceCompute 相同，另外输出最近的子形状序号（见 FCL_COMPOUND_CHILD_PAIR）；不使用相干性缓存。
+NTSTATUS
+FclCompoundDistanceCompute(
+    _In_ FCL_GEOMETRY_HANDLE object1,
+    _In_opt_ const FCL_TRANSFORM* transform1,
+    _In_ FCL_GEOMETRY_HANDLE object2,
+    _In_opt_ const FCL_TRANSFORM* transform2,
+    _Out_ PFCL_DISTANCE_RESULT result,
+    _Out_ PFCL_COMPOUND_CHILD_PAIR children) noexcept;
+
+//
+// 带请求选项的距离查询（IRQL == PASSIVE_LEVEL）
+// - 设置 DistanceThreshold 后先做包围体下界测试，能确认远于阈值时直接返回，不进入窄阶段
+// - 否则将阈值作为 BVH 遍历的初始上界，包围体距离超过阈值的子树直接剪枝
+// - request 为 NULL 时等价于 FclDistanceCompute
+//
+NTSTATUS
+FclDistanceQuery(
+    _In_ FCL_GEOMETRY_HANDLE object1,
+    _In_opt_ const FCL_TRANSFORM* transform1,
+    _In_ FCL_GEOMETRY_HANDLE object2,
+    _In_opt_ const FCL_TRANSFORM* transform2,
+    _In_opt_ const FCL_DISTANCE_REQUEST* request,
+    _Out_ PFCL_DISTANCE_QUERY_RESULT result) noexcept;
+
 //
 // 内部 Snapshot Core API（IRQL <= DISPATCH_LEVEL，可在 DPC 中调用）
 // - 仅使用几何快照 / 变换，不执行句柄查找或加锁
+// - 在 DISPATCH_LEVEL 调用时 upstream 路径的临时分配只从 DPC 预留池取块，预留池耗尽时返回 STATUS_INSUFFICIENT_RESOURCES
 //
 NTSTATUS
 FclDistanceCoreFromSnapshots(
@@ -32,4 +76,13 @@ FclDistanceCoreFromSnapshots(
     _In_ const FCL_TRANSFORM* transform2,
     _Out_ PFCL_DISTANCE_RESULT result) noexcept;
 
+NTSTATUS
+FclDistanceQueryCoreFromSnapshots(
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object1,
+    _In_ const FCL_TRANSFORM* transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object2,
+    _In_ const FCL_TRANSFORM* transform2,
+    _In_opt_ const FCL_DISTANCE_REQUEST* request,
+    _Out_ PFCL_DISTANCE_QUERY_RESULT result) noexcept;
+
 EXTERN_C_END
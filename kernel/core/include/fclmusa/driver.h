@@ -15,22 +15,36 @@ VOID FclCleanup();
 NTSTATUS FclQueryHealth(_Out_ FCL_PING_RESPONSE* response);
 
 VOID
-FclDiagnosticsRecordCollisionDuration(_In_ ULONGLONG durationMicroseconds) noexcept;
+FclDiagnosticsRecordCollisionDuration(
+    _In_ FCL_GEOMETRY_TYPE type1,
+    _In_ FCL_GEOMETRY_TYPE type2,
+    _In_ ULONGLONG durationNanoseconds) noexcept;
 
 VOID
-FclDiagnosticsRecordDpcCollisionDuration(_In_ ULONGLONG durationMicroseconds) noexcept;
+FclDiagnosticsRecordDpcCollisionDuration(
+    _In_ FCL_GEOMETRY_TYPE type1,
+    _In_ FCL_GEOMETRY_TYPE type2,
+    _In_ ULONGLONG durationNanoseconds) noexcept;
 
 VOID
-FclDiagnosticsRecordDistanceDuration(_In_ ULONGLONG durationMicroseconds) noexcept;
+FclDiagnosticsRecordDistanceDuration(
+    _In_ FCL_GEOMETRY_TYPE type1,
+    _In_ FCL_GEOMETRY_TYPE type2,
+    _In_ ULONGLONG durationNanoseconds) noexcept;
 
 VOID
-FclDiagnosticsRecordContinuousCollisionDuration(_In_ ULONGLONG durationMicroseconds) noexcept;
+FclDiagnosticsRecordContinuousCollisionDuration(
+    _In_ FCL_GEOMETRY_TYPE type1,
+    _In_ FCL_GEOMETRY_TYPE type2,
+    _In_ ULONGLONG durationNanoseconds) noexcept;
 
 NTSTATUS
 FclQueryDiagnostics(_Out_ FCL_DIAGNOSTICS_RESPONSE* response) noexcept;
 
 #else  // FCL_MUSA_KERNEL_MODE == 0 (user-mode stubs)
 
+// 用户态没有驱动级计时汇总（FclQueryDiagnostics 不可用），查询耗时只计入延迟直方图。
+
 static inline NTSTATUS FclInitialize() { return STATUS_NOT_SUPPORTED; }
 static inline VOID FclCleanup() {}
 
@@ -39,16 +53,36 @@ static inline NTSTATUS FclQueryHealth(_Out_ FCL_PING_RESPONSE* /*response*/) {
 }
 
 static inline VOID
-FclDiagnosticsRecordCollisionDuration(_In_ ULONGLONG /*durationMicroseconds*/) noexcept {}
+FclDiagnosticsRecordCollisionDuration(
+    _In_ FCL_GEOMETRY_TYPE type1,
+    _In_ FCL_GEOMETRY_TYPE type2,
+    _In_ ULONGLONG durationNanoseconds) noexcept {
+    fclmusa::diagnostics::RecordLatency(FCL_LATENCY_COLLISION, type1, type2, durationNanoseconds);
+}
 
 static inline VOID
-FclDiagnosticsRecordDpcCollisionDuration(_In_ ULONGLONG /*durationMicroseconds*/) noexcept {}
+FclDiagnosticsRecordDpcCollisionDuration(
+    _In_ FCL_GEOMETRY_TYPE type1,
+    _In_ FCL_GEOMETRY_TYPE type2,
+    _In_ ULONGLONG durationNanoseconds) noexcept {
+    fclmusa::diagnostics::RecordLatency(FCL_LATENCY_DPC_COLLISION, type1, type2, durationNanoseconds);
+}
 
 static inline VOID
-FclDiagnosticsRecordDistanceDuration(_In_ ULONGLONG /*durationMicroseconds*/) noexcept {}
+FclDiagnosticsRecordDistanceDuration(
+    _In_ FCL_GEOMETRY_TYPE type1,
+    _In_ FCL_GEOMETRY_TYPE type2,
+    _In_ ULONGLONG durationNanoseconds) noexcept {
+    fclmusa::diagnostics::RecordLatency(FCL_LATENCY_DISTANCE, type1, type2, durationNanoseconds);
+}
 
 static inline VOID
-FclDiagnosticsRecordContinuousCollisionDuration(_In_ ULONGLONG /*durationMicroseconds*/) noexcept {}
+FclDiagnosticsRecordContinuousCollisionDuration(
+    _In_ FCL_GEOMETRY_TYPE type1,
+    _In_ FCL_GEOMETRY_TYPE type2,
+    _In_ ULONGLONG durationNanoseconds) noexcept {
+    fclmusa::diagnostics::RecordLatency(FCL_LATENCY_CONTINUOUS_COLLISION, type1, type2, durationNanoseconds);
+}
 
 static inline NTSTATUS
 FclQueryDiagnostics(_Out_ FCL_DIAGNOSTICS_RESPONSE* /*response*/) noexcept {
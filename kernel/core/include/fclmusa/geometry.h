@@ -9,6 +9,8 @@
 EXTERN_C_START
 
 struct FCL_BVH_MODEL;
+struct FCL_CONVEX_HULL;
+struct FCL_COMPOUND_MODEL;
 
 typedef struct _FCL_VECTOR3 {
     float X;
@@ -28,6 +30,10 @@ typedef enum _FCL_GEOMETRY_TYPE {
     FCL_GEOMETRY_SPHERE = 1,
     FCL_GEOMETRY_OBB = 2,
     FCL_GEOMETRY_MESH = 3,
+    FCL_GEOMETRY_CONVEX = 4,
+    FCL_GEOMETRY_CAPSULE = 5,
+    FCL_GEOMETRY_CYLINDER = 6,
+    FCL_GEOMETRY_COMPOUND = 7,
 } FCL_GEOMETRY_TYPE;
 
 typedef struct _FCL_SPHERE_GEOMETRY_DESC {
@@ -41,6 +47,22 @@ typedef struct _FCL_OBB_GEOMETRY_DESC {
     FCL_MATRIX3X3 Rotation;
 } FCL_OBB_GEOMETRY_DESC, *PFCL_OBB_GEOMETRY_DESC;
 
+// 胶囊体：局部 Z 轴上长 2 * HalfLength 的线段向外扩张 Radius（与 fcl::Capsule 一致）。
+typedef struct _FCL_CAPSULE_GEOMETRY_DESC {
+    FCL_VECTOR3 Center;
+    FCL_MATRIX3X3 Rotation;
+    float Radius;
+    float HalfLength;
+} FCL_CAPSULE_GEOMETRY_DESC, *PFCL_CAPSULE_GEOMETRY_DESC;
+
+// 圆柱体：轴沿局部 Z，高 2 * HalfLength（与 fcl::Cylinder 一致）。
+typedef struct _FCL_CYLINDER_GEOMETRY_DESC {
+    FCL_VECTOR3 Center;
+    FCL_MATRIX3X3 Rotation;
+    float Radius;
+    float HalfLength;
+} FCL_CYLINDER_GEOMETRY_DESC, *PFCL_CYLINDER_GEOMETRY_DESC;
+
 typedef struct _FCL_MESH_GEOMETRY_DESC {
     const FCL_VECTOR3* Vertices;
     ULONG VertexCount;
@@ -48,16 +70,44 @@ typedef struct _FCL_MESH_GEOMETRY_DESC {
     ULONG IndexCount;
 } FCL_MESH_GEOMETRY_DESC, *PFCL_MESH_GEOMETRY_DESC;
 
+// 凸包描述：任意点集（至少 4 个不共面的点），创建时计算凸包，内部点被丢弃。
+typedef struct _FCL_CONVEX_GEOMETRY_DESC {
+    const FCL_VECTOR3* Points;
+    ULONG PointCount;
+} FCL_CONVEX_GEOMETRY_DESC, *PFCL_CONVEX_GEOMETRY_DESC;
+
 typedef struct _FCL_TRANSFORM {
     FCL_MATRIX3X3 Rotation;
     FCL_VECTOR3 Translation;
 } FCL_TRANSFORM, *PFCL_TRANSFORM;
 
+#define FCL_COMPOUND_NO_CHILD 0xFFFFFFFFUL
+
+// 复合几何的子形状：引用已有几何句柄，LocalTransform 为子形状相对复合体的刚性位姿。
+typedef struct _FCL_COMPOUND_CHILD_DESC {
+    FCL_GEOMETRY_HANDLE Geometry;
+    FCL_TRANSFORM LocalTransform;
+} FCL_COMPOUND_CHILD_DESC, *PFCL_COMPOUND_CHILD_DESC;
+
+// 复合几何：一组刚性连接的子形状共用一个句柄与一个变换；子形状不能是复合几何。
+typedef struct _FCL_COMPOUND_GEOMETRY_DESC {
+    const FCL_COMPOUND_CHILD_DESC* Children;
+    ULONG ChildCount;
+} FCL_COMPOUND_GEOMETRY_DESC, *PFCL_COMPOUND_GEOMETRY_DESC;
+
+// 查询命中的子形状（Children 下标）；对象不是复合几何或未命中时为 FCL_COMPOUND_NO_CHILD。
+typedef struct _FCL_COMPOUND_CHILD_PAIR {
+    ULONG Child1;
+    ULONG Child2;
+} FCL_COMPOUND_CHILD_PAIR, *PFCL_COMPOUND_CHILD_PAIR;
+
 typedef struct _FCL_GEOMETRY_SNAPSHOT {
     FCL_GEOMETRY_TYPE Type;
     union {
         FCL_SPHERE_GEOMETRY_DESC Sphere;
         FCL_OBB_GEOMETRY_DESC Obb;
+        FCL_CAPSULE_GEOMETRY_DESC Capsule;
+        FCL_CYLINDER_GEOMETRY_DESC Cylinder;
         struct {
             const FCL_VECTOR3* Vertices;
             ULONG VertexCount;
@@ -65,7 +115,19 @@ typedef struct _FCL_GEOMETRY_SNAPSHOT {
             ULONG IndexCount;
             const FCL_BVH_MODEL* Bvh;
         } Mesh;
+        struct {
+            const FCL_VECTOR3* Vertices;    // 凸包顶点
+            ULONG VertexCount;
+            const UINT32* Indices;          // 凸包三角化面
+            ULONG IndexCount;
+            const FCL_CONVEX_HULL* Hull;    // 邻接表 / 支撑函数
+        } Convex;
+        struct {
+            const FCL_COMPOUND_MODEL* Model;  // 子形状快照与包围盒树
+            ULONG ChildCount;
+        } Compound;
     } Data;
+    ULONG Generation;  // 几何数据版本，FclUpdateMeshGeometry 成功后递增；派生缓存据此识别过期条目
 } FCL_GEOMETRY_SNAPSHOT, *PFCL_GEOMETRY_SNAPSHOT;
 
 typedef struct _FCL_GEOMETRY_REFERENCE {
@@ -93,6 +155,12 @@ FclUpdateMeshGeometry(
     _In_ FCL_GEOMETRY_HANDLE handle,
     _In_ const FCL_MESH_GEOMETRY_DESC* geometryDesc) noexcept;
 
+// 以 Mesh 的顶点创建凸包几何（用于把凸零件从 Mesh 批量切换为 FCL_GEOMETRY_CONVEX）。
+NTSTATUS
+FclCreateConvexFromMesh(
+    _In_ FCL_GEOMETRY_HANDLE mesh,
+    _Out_ PFCL_GEOMETRY_HANDLE handle) noexcept;
+
 BOOLEAN
 FclIsGeometryHandleValid(
     _In_ FCL_GEOMETRY_HANDLE handle) noexcept;
@@ -107,4 +175,17 @@ VOID
 FclReleaseGeometryReference(
     _Inout_opt_ PFCL_GEOMETRY_REFERENCE reference) noexcept;
 
+// 枚举回调：snapshot 只在回调期间有效。回调在几何锁之外执行，枚举期间每个条目各持有一个引用，
+// 因此对已枚举句柄的销毁/网格更新会返回 STATUS_DEVICE_BUSY。
+typedef VOID (*PFCL_GEOMETRY_ENUM_CALLBACK)(
+    _In_opt_ PVOID context,
+    _In_ FCL_GEOMETRY_HANDLE handle,
+    _In_ const FCL_GEOMETRY_SNAPSHOT* snapshot);
+
+// 按句柄升序枚举全部存活几何（复合几何总在其子形状之后）。PASSIVE_LEVEL。
+NTSTATUS
+FclEnumerateGeometries(
+    _In_ PFCL_GEOMETRY_ENUM_CALLBACK callback,
+    _In_opt_ PVOID context) noexcept;
+
 EXTERN_C_END
@@ -23,6 +23,19 @@ FclBuildBvhModel(
     _In_ ULONG indexCount,
     _Outptr_ FCL_BVH_MODEL** model) noexcept;
 
+// 采用预先构建的 BVH（如预编译 Mesh 映像中的节点与三角形顺序）：复制并校验树结构，不重新构建。
+// 与 FclBuildBvhModel 相同，vertices / indices 由调用方持有且须在模型存续期间有效。
+NTSTATUS
+FclAdoptBvhModel(
+    _In_reads_(vertexCount) const FCL_VECTOR3* vertices,
+    _In_ ULONG vertexCount,
+    _In_reads_(indexCount) const UINT32* indices,
+    _In_ ULONG indexCount,
+    _In_reads_(nodeCount) const FCL_BVH_NODE* nodes,
+    _In_ ULONG nodeCount,
+    _In_reads_(indexCount / 3) const UINT32* triangleOrder,
+    _Outptr_ FCL_BVH_MODEL** model) noexcept;
+
 NTSTATUS
 FclBvhUpdateModel(
     _Inout_ FCL_BVH_MODEL* model,
@@ -0,0 +1,50 @@
+﻿#pragma once
+
+#include "fclmusa/platform.h"
+
+#include "fclmusa/geometry.h"
+
+EXTERN_C_START
+
+//
+// 复合几何模型：保存子形状快照与局部位姿，并在复合体局部坐标下按子形状 AABB 建立二叉包围盒树。
+// 子形状句柄的引用由几何管理器持有，模型只保存快照，不负责归还引用。
+//
+
+typedef struct _FCL_COMPOUND_CHILD {
+    FCL_GEOMETRY_HANDLE Geometry;
+    FCL_GEOMETRY_SNAPSHOT Snapshot;
+    FCL_TRANSFORM LocalTransform;
+} FCL_COMPOUND_CHILD, *PFCL_COMPOUND_CHILD;
+
+// Child 不为 FCL_COMPOUND_NO_CHILD 时为叶节点（每个叶节点一个子形状），否则子节点为 Left / Right。
+typedef struct _FCL_COMPOUND_NODE {
+    FCL_VECTOR3 Min;
+    FCL_VECTOR3 Max;
+    ULONG Left;
+    ULONG Right;
+    ULONG Child;
+} FCL_COMPOUND_NODE, *PFCL_COMPOUND_NODE;
+
+NTSTATUS
+FclBuildCompoundModel(
+    _In_reads_(childCount) const FCL_COMPOUND_CHILD* children,
+    _In_ ULONG childCount,
+    _Outptr_ FCL_COMPOUND_MODEL** model) noexcept;
+
+VOID
+FclDestroyCompoundModel(
+    _In_opt_ FCL_COMPOUND_MODEL* model) noexcept;
+
+const FCL_COMPOUND_CHILD*
+FclCompoundGetChildren(
+    _In_opt_ const FCL_COMPOUND_MODEL* model,
+    _Out_opt_ ULONG* childCount) noexcept;
+
+// 节点 0 为根节点，其包围盒即整个复合体在局部坐标下的 AABB。
+const FCL_COMPOUND_NODE*
+FclCompoundGetNodes(
+    _In_opt_ const FCL_COMPOUND_MODEL* model,
+    _Out_opt_ ULONG* nodeCount) noexcept;
+
+EXTERN_C_END
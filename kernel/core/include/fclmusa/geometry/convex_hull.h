@@ -0,0 +1,56 @@
+﻿#pragma once
+
+#include "fclmusa/platform.h"
+
+#include "fclmusa/geometry.h"
+
+EXTERN_C_START
+
+//
+// 凸包模型：创建时对输入点集执行 quickhull，保存凸包顶点、三角化面（外法线按右手定则朝外）
+// 与顶点邻接表（CSR 布局）。共面面片不合并，面数不超过 2V - 4。
+// 支撑函数在顶点邻接图上爬山：凸多面体的邻接图上不存在局部极大，从任意起点出发都能到达全局极值。
+//
+NTSTATUS
+FclBuildConvexHull(
+    _In_reads_(pointCount) const FCL_VECTOR3* points,
+    _In_ ULONG pointCount,
+    _Outptr_ FCL_CONVEX_HULL** hull) noexcept;
+
+VOID
+FclDestroyConvexHull(
+    _In_opt_ FCL_CONVEX_HULL* hull) noexcept;
+
+const FCL_VECTOR3*
+FclConvexHullGetVertices(
+    _In_opt_ const FCL_CONVEX_HULL* hull,
+    _Out_opt_ ULONG* vertexCount) noexcept;
+
+const UINT32*
+FclConvexHullGetIndices(
+    _In_opt_ const FCL_CONVEX_HULL* hull,
+    _Out_opt_ ULONG* indexCount) noexcept;
+
+// 与 vertex 相邻（共享凸包边）的顶点序号。
+const UINT32*
+FclConvexHullGetNeighbors(
+    _In_opt_ const FCL_CONVEX_HULL* hull,
+    _In_ ULONG vertex,
+    _Out_opt_ ULONG* neighborCount) noexcept;
+
+// 顶点平均值，严格位于凸包内部（MPR 参考点）。
+FCL_VECTOR3
+FclConvexHullGetCentroid(
+    _In_opt_ const FCL_CONVEX_HULL* hull) noexcept;
+
+//
+// 局部坐标下沿 direction 的支撑顶点序号（IRQL <= DISPATCH_LEVEL，不分配内存）。
+// hint 为上一次查询的结果时，时间相干的查询通常只需检查少量邻居。
+//
+ULONG
+FclConvexHullSupport(
+    _In_ const FCL_CONVEX_HULL* hull,
+    _In_ const FCL_VECTOR3* direction,
+    _In_ ULONG hint) noexcept;
+
+EXTERN_C_END
@@ -0,0 +1,83 @@
+﻿#pragma once
+
+#include "fclmusa/platform.h"
+
+#include "fclmusa/geometry.h"
+#include "fclmusa/geometry/bvh_model.h"
+
+//
+// 预编译 Mesh 映像：顶点、索引与已构建的 BVH（FCL_BVH_NODE 数组与 TriangleOrder）的版本化二进制容器
+// - 由 FclSerializeMeshGeometry 从已创建的 Mesh 导出（samples/mesh_compiler 把 OBJ / raw 网格离线转换为映像文件）
+// - FclCreateMeshGeometryFromImage 校验映像（长度、偏移、校验和、树结构）后直接采用其中的 BVH，不再重新构建；
+//   映像由调用方持有，顶点 / 索引 / 节点仍各复制一份，加载开销是一次与映像等大的复制而不是 BVH 构建
+// - 各段按 8 字节对齐并按顶点、索引、节点、三角形顺序依次排列；Checksum 为文件头之后全部字节的 FNV-1a 64
+// - FCL_BVH_NODE / FCL_OBBRSS 布局变化时须提升 Version，旧映像以 STATUS_REVISION_MISMATCH 拒绝，重新转换即可
+// - 上游 fcl::BVHModel 在查询时由快照构建、不随几何缓存，因此映像中没有上游模型数据
+//
+
+EXTERN_C_START
+
+#define FCL_PRECOMPILED_MESH_MAGIC 0x4D504346u  // "FCPM"
+#define FCL_PRECOMPILED_MESH_VERSION 1u
+
+typedef struct _FCL_PRECOMPILED_MESH_HEADER {
+    ULONG Magic;
+    ULONG Version;
+    ULONG HeaderSize;  // sizeof(FCL_PRECOMPILED_MESH_HEADER)
+    ULONG NodeSize;    // sizeof(FCL_BVH_NODE)
+    ULONG VertexCount;
+    ULONG IndexCount;  // TriangleOrder 长度为 IndexCount / 3
+    ULONG NodeCount;
+    ULONG Reserved;
+    ULONGLONG VerticesOffset;       // FCL_VECTOR3[VertexCount]
+    ULONGLONG IndicesOffset;        // UINT32[IndexCount]
+    ULONGLONG NodesOffset;          // FCL_BVH_NODE[NodeCount]
+    ULONGLONG TriangleOrderOffset;  // UINT32[IndexCount / 3]
+    ULONGLONG ImageBytes;           // 含文件头的总长度
+    ULONGLONG Checksum;
+} FCL_PRECOMPILED_MESH_HEADER, *PFCL_PRECOMPILED_MESH_HEADER;
+
+// 映像各段的只读视图，指针指向映像内部。
+typedef struct _FCL_PRECOMPILED_MESH_VIEW {
+    const FCL_VECTOR3* Vertices;
+    ULONG VertexCount;
+    const UINT32* Indices;
+    ULONG IndexCount;
+    const FCL_BVH_NODE* Nodes;
+    ULONG NodeCount;
+    const UINT32* TriangleOrder;
+} FCL_PRECOMPILED_MESH_VIEW, *PFCL_PRECOMPILED_MESH_VIEW;
+
+// 校验文件头、各段边界与校验和并返回视图；不检查 BVH 的树结构（由 FclAdoptBvhModel 检查）。
+// 返回 STATUS_INVALID_IMAGE_FORMAT（截断、魔数或偏移错误）、STATUS_REVISION_MISMATCH、STATUS_DATA_ERROR（校验和不符）。
+NTSTATUS
+FclParsePrecompiledMesh(
+    _In_reads_bytes_(imageBytes) const VOID* image,
+    _In_ size_t imageBytes,
+    _Out_ PFCL_PRECOMPILED_MESH_VIEW view) noexcept;
+
+// 把视图写为映像；buffer 为 NULL 或 bufferBytes 不足时返回 STATUS_BUFFER_TOO_SMALL，requiredBytes 给出所需长度。
+NTSTATUS
+FclWritePrecompiledMesh(
+    _In_ const FCL_PRECOMPILED_MESH_VIEW* view,
+    _Out_writes_bytes_opt_(bufferBytes) VOID* buffer,
+    _In_ size_t bufferBytes,
+    _Out_ size_t* requiredBytes) noexcept;
+
+// 导出已创建 Mesh 的映像（语义同 FclWritePrecompiledMesh）。PASSIVE_LEVEL。
+NTSTATUS
+FclSerializeMeshGeometry(
+    _In_ FCL_GEOMETRY_HANDLE mesh,
+    _Out_writes_bytes_opt_(bufferBytes) VOID* buffer,
+    _In_ size_t bufferBytes,
+    _Out_ size_t* requiredBytes) noexcept;
+
+// 从映像创建 Mesh：复制顶点 / 索引与 BVH 节点，校验树结构后直接使用（不重新构建）；返回后映像即可释放。PASSIVE_LEVEL。
+// 树结构不合法（越界、环、三角形缺失或重复、深度超限）时返回 STATUS_INVALID_PARAMETER。
+NTSTATUS
+FclCreateMeshGeometryFromImage(
+    _In_reads_bytes_(imageBytes) const VOID* image,
+    _In_ size_t imageBytes,
+    _Out_ PFCL_GEOMETRY_HANDLE handle) noexcept;
+
+EXTERN_C_END
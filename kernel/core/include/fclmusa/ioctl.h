@@ -3,7 +3,11 @@
 #include "fclmusa/platform.h"
 
 #include "fclmusa/collision.h"
+#include "fclmusa/diagnostics/latency_histogram.h"
+#include "fclmusa/diagnostics/phase_trace.h"
+#include "fclmusa/diagnostics/workload_recorder.h"
 #include "fclmusa/geometry.h"
+#include "fclmusa/memory/alloc_profiler.h"
 #include "fclmusa/memory/pool_allocator.h"
 #include "fclmusa/version.h"
 
@@ -24,6 +28,14 @@
 #define IOCTL_FCL_SELF_TEST_SCENARIO CTL_CODE(FILE_DEVICE_UNKNOWN, 0x802, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
 // R0 �ں˲��Խ�����ز�ͳ�Ƽ��
 #define IOCTL_FCL_QUERY_DIAGNOSTICS CTL_CODE(FILE_DEVICE_UNKNOWN, 0x803, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
+// 按池标记 / 调用点的分配剖析（输出 FCL_ALLOC_PROFILE；未编译剖析支持时返回 STATUS_NOT_SUPPORTED）
+#define IOCTL_FCL_QUERY_ALLOCATION_PROFILE CTL_CODE(FILE_DEVICE_UNKNOWN, 0x804, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
+// 按查询类型 / 几何类型对的延迟直方图与百分位（输入 FCL_LATENCY_HISTOGRAM_QUERY，输出 FCL_LATENCY_HISTOGRAM，可读后清零）
+#define IOCTL_FCL_QUERY_LATENCY_HISTOGRAM CTL_CODE(FILE_DEVICE_UNKNOWN, 0x805, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
+// 按阶段的周期统计与环形缓冲区事件（输入 FCL_PHASE_TRACE_QUERY，输出 FCL_PHASE_TRACE_SNAPSHOT，可读后清零 / 开关环形缓冲区）
+#define IOCTL_FCL_QUERY_PHASE_TRACE CTL_CODE(FILE_DEVICE_UNKNOWN, 0x806, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
+// 工作负载录制控制与轨迹读取（输入 FCL_WORKLOAD_RECORDING_REQUEST，输出 FCL_WORKLOAD_RECORDING_RESPONSE [+ 轨迹数据]）
+#define IOCTL_FCL_WORKLOAD_RECORDING CTL_CODE(FILE_DEVICE_UNKNOWN, 0x807, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
 
 // 正式几何 / 碰撞 / 距离 IOCTL
 #define IOCTL_FCL_QUERY_COLLISION CTL_CODE(FILE_DEVICE_UNKNOWN, 0x810, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
@@ -32,6 +44,8 @@
 #define IOCTL_FCL_DESTROY_GEOMETRY CTL_CODE(FILE_DEVICE_UNKNOWN, 0x813, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
 #define IOCTL_FCL_CREATE_MESH CTL_CODE(FILE_DEVICE_UNKNOWN, 0x814, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
 #define IOCTL_FCL_CONVEX_CCD CTL_CODE(FILE_DEVICE_UNKNOWN, 0x815, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
+// 从预编译 Mesh 映像创建几何（输入为映像字节，见 fclmusa/geometry/precompiled_mesh.h；输出 FCL_CREATE_PRECOMPILED_MESH_OUTPUT）
+#define IOCTL_FCL_CREATE_PRECOMPILED_MESH CTL_CODE(FILE_DEVICE_UNKNOWN, 0x816, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
 
 //
 // 周期性（DPC）碰撞检测控制 IOCTL
@@ -242,7 +256,34 @@ typedef struct _FCL_CREATE_MESH_BUFFER {
     // Followed by VertexCount FCL_VECTOR3 entries and IndexCount UINT32 entries.
 } FCL_CREATE_MESH_BUFFER, *PFCL_CREATE_MESH_BUFFER;
 
+typedef struct _FCL_CREATE_PRECOMPILED_MESH_OUTPUT {
+    FCL_GEOMETRY_HANDLE Handle;
+} FCL_CREATE_PRECOMPILED_MESH_OUTPUT, *PFCL_CREATE_PRECOMPILED_MESH_OUTPUT;
+
+typedef enum _FCL_WORKLOAD_RECORDING_OPERATION {
+    FCL_WORKLOAD_RECORDING_OP_QUERY = 0,
+    FCL_WORKLOAD_RECORDING_OP_START = 1,    // 使用 Config
+    FCL_WORKLOAD_RECORDING_OP_STOP = 2,
+    FCL_WORKLOAD_RECORDING_OP_READ = 3,     // 从 Offset 读取，长度受输出缓冲区限制
+    FCL_WORKLOAD_RECORDING_OP_DISCARD = 4,
+} FCL_WORKLOAD_RECORDING_OPERATION;
+
+typedef struct _FCL_WORKLOAD_RECORDING_REQUEST {
+    ULONG Operation;  // FCL_WORKLOAD_RECORDING_OPERATION
+    ULONG Reserved;
+    FCL_WORKLOAD_RECORDING_CONFIG Config;
+    ULONGLONG Offset;
+} FCL_WORKLOAD_RECORDING_REQUEST, *PFCL_WORKLOAD_RECORDING_REQUEST;
+
+// 操作完成后的录制状态；READ 时其后紧跟 DataBytes 字节轨迹数据。
+typedef struct _FCL_WORKLOAD_RECORDING_RESPONSE {
+    FCL_WORKLOAD_RECORDING_STATUS Status;
+    ULONG DataBytes;
+    ULONG Reserved;
+} FCL_WORKLOAD_RECORDING_RESPONSE, *PFCL_WORKLOAD_RECORDING_RESPONSE;
+
 static_assert((sizeof(FCL_COLLISION_IO_BUFFER) % sizeof(ULONG)) == 0, "Collision IO buffer must align to ULONG");
 static_assert((sizeof(FCL_DISTANCE_IO_BUFFER) % sizeof(ULONG)) == 0, "Distance IO buffer must align to ULONG");
 static_assert((sizeof(FCL_CREATE_MESH_BUFFER) % sizeof(ULONG)) == 0, "Mesh buffer must align to ULONG");
 static_assert((sizeof(FCL_PERIODIC_COLLISION_CONFIG) % sizeof(ULONG)) == 0, "Periodic collision config must align to ULONG");
+static_assert((sizeof(FCL_WORKLOAD_RECORDING_RESPONSE) % sizeof(ULONGLONG)) == 0, "Workload recording response must align to ULONGLONG");
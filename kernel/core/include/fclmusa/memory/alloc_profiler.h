@@ -0,0 +1,113 @@
+﻿#pragma once
+
+#include "fclmusa/platform.h"
+
+#include <cstddef>
+
+//
+// 分配剖析（按池标记 / 调用点）
+// - 编译开关 FCL_MUSA_ENABLE_ALLOC_PROFILING（CMake 选项 FCLMUSA_ENABLE_ALLOC_PROFILING，默认关闭）；
+//   关闭时 AllocationHeader 不含调用点字段、FCL_ALLOCATION_SITE 展开为空，Allocate / Free 路径没有任何额外开销
+// - 开启时 fclmusa::memory::Allocate / Free 按池标记与当前调用点分别累计：次数、总字节、当前存活字节、峰值、
+//   按 2 的幂分桶的大小直方图；统计的是调用方请求的字节数，与底层来自 slab / arena / 预留池无关
+// - 调用点由 FCL_ALLOCATION_SITE 在作用域内设置（内核态按 (线程, IRQL) 绑定槽位，用户态按线程），嵌套时内层优先；
+//   释放按分配时记录在块头中的标记与调用点回退，可在任意线程 / IRQL 释放
+// - 池标记表固定 FCL_ALLOC_PROFILE_MAX_TAGS 项，写满后新标记只计入 UntrackedTagAllocations
+//
+
+#ifndef FCL_MUSA_ENABLE_ALLOC_PROFILING
+#define FCL_MUSA_ENABLE_ALLOC_PROFILING 0
+#endif
+
+#define FCL_ALLOC_PROFILE_MAX_TAGS 16
+#define FCL_ALLOC_PROFILE_MAX_SITES 16
+// 桶 i（i < 15）统计 (16 << (i - 1), 16 << i] 字节的请求，桶 0 为 [0, 16]，桶 15 为 256 KB 以上。
+#define FCL_ALLOC_PROFILE_HISTOGRAM_BUCKETS 16
+
+// 调用点编号；FCL_ALLOC_SITE_USER_FIRST 起供调用方自定义，超出 FCL_ALLOC_PROFILE_MAX_SITES 的编号计入 UNKNOWN。
+typedef enum _FCL_ALLOC_SITE {
+    FCL_ALLOC_SITE_UNKNOWN = 0,
+    FCL_ALLOC_SITE_GEOMETRY = 1,         // 几何管理器：Mesh 顶点 / 索引副本、复合体子形状数组
+    FCL_ALLOC_SITE_BVH = 2,              // upstream BVHModel 构建
+    FCL_ALLOC_SITE_UPSTREAM_MODEL = 3,   // upstream 基本体 / 凸包对象
+    FCL_ALLOC_SITE_UPSTREAM_QUERY = 4,   // upstream 查询过程中的临时对象
+    FCL_ALLOC_SITE_LIBCCD = 5,           // libccd 单纯形 / EPA 多面体
+    FCL_ALLOC_SITE_BROADPHASE = 6,       // 宽阶段 CollisionObject 与管理器
+    FCL_ALLOC_SITE_COHERENCE_CACHE = 7,  // 时间相干性缓存表
+    FCL_ALLOC_SITE_USER_FIRST = 8,
+} FCL_ALLOC_SITE;
+
+typedef struct _FCL_ALLOC_PROFILE_ENTRY {
+    ULONG Key;  // 池标记或调用点编号
+    ULONG Reserved;
+    ULONGLONG AllocationCount;
+    ULONGLONG FreeCount;
+    ULONGLONG BytesAllocated;
+    ULONGLONG LiveBytes;
+    ULONGLONG PeakLiveBytes;
+    ULONGLONG SizeHistogram[FCL_ALLOC_PROFILE_HISTOGRAM_BUCKETS];
+} FCL_ALLOC_PROFILE_ENTRY, *PFCL_ALLOC_PROFILE_ENTRY;
+
+typedef struct _FCL_ALLOC_PROFILE {
+    BOOLEAN Enabled;
+    UCHAR Reserved[3];
+    ULONG TagCount;
+    ULONGLONG UntrackedTagAllocations;
+    FCL_ALLOC_PROFILE_ENTRY Tags[FCL_ALLOC_PROFILE_MAX_TAGS];
+    FCL_ALLOC_PROFILE_ENTRY Sites[FCL_ALLOC_PROFILE_MAX_SITES];  // 下标即调用点编号
+} FCL_ALLOC_PROFILE, *PFCL_ALLOC_PROFILE;
+
+EXTERN_C_START
+
+// 未编译剖析支持时返回 STATUS_NOT_SUPPORTED（profile->Enabled 为 FALSE）。任意 IRQL。
+NTSTATUS
+FclQueryAllocationProfile(
+    _Out_ PFCL_ALLOC_PROFILE profile) noexcept;
+
+// 清零次数 / 字节 / 直方图并把峰值重置为当前存活字节；保留已登记的池标记。
+VOID
+FclResetAllocationProfile() noexcept;
+
+EXTERN_C_END
+
+#define FCL_ALLOC_SITE_CONCAT_INNER(a, b) a##b
+#define FCL_ALLOC_SITE_CONCAT(a, b) FCL_ALLOC_SITE_CONCAT_INNER(a, b)
+
+#if FCL_MUSA_ENABLE_ALLOC_PROFILING
+
+namespace fclmusa::memory {
+
+class AllocationSiteScope {
+public:
+    explicit AllocationSiteScope(_In_ ULONG site) noexcept;
+    ~AllocationSiteScope() noexcept;
+
+    AllocationSiteScope(const AllocationSiteScope&) = delete;
+    AllocationSiteScope& operator=(const AllocationSiteScope&) = delete;
+
+private:
+    void* slot_;
+    ULONG previous_;
+    bool ownsSlot_;
+};
+
+namespace detail {
+
+ULONG CurrentAllocationSite() noexcept;
+
+void ProfileAllocation(_In_ ULONG poolTag, _In_ ULONG site, _In_ size_t size) noexcept;
+
+void ProfileFree(_In_ ULONG poolTag, _In_ ULONG site, _In_ size_t size) noexcept;
+
+}  // namespace detail
+
+}  // namespace fclmusa::memory
+
+#define FCL_ALLOCATION_SITE(site) \
+    ::fclmusa::memory::AllocationSiteScope FCL_ALLOC_SITE_CONCAT(fclAllocationSite_, __LINE__)(static_cast<ULONG>(site))
+
+#else
+
+#define FCL_ALLOCATION_SITE(site) ((void)0)
+
+#endif  // FCL_MUSA_ENABLE_ALLOC_PROFILING
@@ -0,0 +1,84 @@
+﻿#pragma once
+
+#include "fclmusa/platform.h"
+
+#include <cstddef>
+
+#include "fclmusa/version.h"
+
+//
+// DPC 预留池
+// - IRQL >= DISPATCH_LEVEL 时（周期碰撞 DPC、在 DPC 中调用的 Snapshot Core API）经 fclmusa::memory::Allocate 的
+//   全部分配（upstream 桥接的 FclDpcNonPagedAllocator、libccd 钩子、内核态全局 operator new）只从预留池取块，
+//   不触碰 slab 页申请与系统池；查询 arena 在该 IRQL 下不绑定
+// - 预留池在 InitializePoolTracking 时按配置一次性申请，分 3 个固定块大小级别，每级一条无锁 SLIST 空闲链表
+// - 请求按块大小（含 AllocationHeader）选最小的级别，该级别为空时依次溢出到更大的级别；全部为空或请求超过
+//   最大块时返回 NULL 并计入 Exhaustions，不再退回系统池
+// - 预留块可以在任意 IRQL 释放；用户态通过 KeRaiseIrql / KeLowerIrql（platform.h 中按线程模拟）进入同一路径
+//
+
+#define FCL_DPC_RESERVE_CLASS_COUNT 3
+
+typedef struct _FCL_DPC_RESERVE_CONFIG {
+    ULONG SmallBlockCount;   // 256 字节块
+    ULONG MediumBlockCount;  // 4 KiB 块
+    ULONG LargeBlockCount;   // 64 KiB 块
+} FCL_DPC_RESERVE_CONFIG, *PFCL_DPC_RESERVE_CONFIG;
+
+typedef struct _FCL_DPC_RESERVE_CLASS_STATS {
+    ULONG BlockBytes;
+    ULONG BlockCount;
+    ULONG BlocksInUse;
+    ULONG HighWaterBlocks;
+    ULONGLONG Allocations;
+    ULONGLONG Overflows;  // 本级别为空、请求溢出到更大级别（或失败）的次数
+} FCL_DPC_RESERVE_CLASS_STATS, *PFCL_DPC_RESERVE_CLASS_STATS;
+
+typedef struct _FCL_DPC_RESERVE_STATS {
+    ULONGLONG ReserveBytes;
+    ULONGLONG Allocations;
+    ULONGLONG Exhaustions;
+    FCL_DPC_RESERVE_CLASS_STATS Classes[FCL_DPC_RESERVE_CLASS_COUNT];
+} FCL_DPC_RESERVE_STATS, *PFCL_DPC_RESERVE_STATS;
+
+namespace fclmusa::memory {
+
+constexpr size_t kDpcReserveBlockBytes[FCL_DPC_RESERVE_CLASS_COUNT] = {256, 4 * 1024, 64 * 1024};
+
+// 默认约 576 KiB 非分页内存。
+constexpr FCL_DPC_RESERVE_CONFIG kDefaultDpcReserveConfig = {256, 64, 4};
+
+// 记录下次 InitializeDpcReserve（InitializePoolTracking）使用的配置；驱动在 DriverEntry 中从注册表 Parameters 读取。
+void SetDpcReserveConfig(_In_ const FCL_DPC_RESERVE_CONFIG& config) noexcept;
+
+FCL_DPC_RESERVE_CONFIG GetDpcReserveConfig() noexcept;
+
+// PASSIVE_LEVEL，调用方保证期间没有 DISPATCH_LEVEL 查询。已有预留池时先释放再按当前配置重建；
+// 仍有块未归还时返回 STATUS_DEVICE_BUSY 并保留原预留池。全部级别为 0 时不申请内存。
+_IRQL_requires_(PASSIVE_LEVEL)
+NTSTATUS InitializeDpcReserve() noexcept;
+
+// 仍有块未归还时保留内存（记录错误日志），避免悬空指针；由 ShutdownPoolTracking 调用。
+_IRQL_requires_(PASSIVE_LEVEL)
+void ShutdownDpcReserve() noexcept;
+
+FCL_DPC_RESERVE_STATS QueryDpcReserveStats() noexcept;
+
+// 清零分配 / 溢出 / 耗尽计数，并把高水位重置为当前占用。
+void ResetDpcReserveCounters() noexcept;
+
+inline bool IsDpcReserveIrql() noexcept {
+    return KeGetCurrentIrql() >= DISPATCH_LEVEL;
+}
+
+namespace detail {
+
+// 预留池为空、未初始化或请求过大时返回 NULL。返回的块已写好 AllocationHeader。
+_Must_inspect_result_
+void* ReserveAllocate(_In_ size_t size, _In_ ULONG poolTag) noexcept;
+
+void ReserveFree(_In_ void* buffer) noexcept;
+
+}  // namespace detail
+
+}  // namespace fclmusa::memory
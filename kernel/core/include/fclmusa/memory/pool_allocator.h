@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <memory>
 
+#include "fclmusa/memory/alloc_profiler.h"
 #include "fclmusa/version.h"
 
 typedef struct _FCL_POOL_STATS {
@@ -17,8 +18,10 @@ typedef struct _FCL_POOL_STATS {
     ULONGLONG PeakBytesInUse;
 } FCL_POOL_STATS, *PFCL_POOL_STATS;
 
+
 namespace fclmusa::memory {
 
+// 同时按 SetDpcReserveConfig 记录的配置建立 DPC 预留池（见 dpc_reserve.h）。
 void InitializePoolTracking();
 void ShutdownPoolTracking();
 void EnablePoolTracking(BOOLEAN enable);
@@ -33,8 +36,39 @@ void* Reallocate(_Inout_opt_ void* buffer, _In_ size_t size, _In_ ULONG poolTag
 
 size_t QueryAllocationSize(_In_opt_ const void* buffer) noexcept;
 
+// 计数按 CPU（内核态）/ 线程（用户态）分片累加，只在 QueryStats 中汇总；
+// PeakBytesInUse 在大块分配与 QueryStats 时采样，可能低于真实的瞬时峰值。
 FCL_POOL_STATS QueryStats() noexcept;
 
+namespace detail {
+
+// 每个分配块前的头部；Origin 区分系统池、slab（见 slab_allocator.h）、查询 arena（见 query_arena.h）
+// 与 DPC 预留池（见 dpc_reserve.h）分配，Free 据此分流。开启分配剖析时额外记录分配时的调用点（见 alloc_profiler.h）。
+struct alignas(16) AllocationHeader {
+    size_t Size;
+    ULONG Tag;
+    ULONG Origin;
+#if FCL_MUSA_ENABLE_ALLOC_PROFILING
+    ULONG Site;
+#endif
+};
+
+constexpr ULONG kPoolOrigin = 0;
+constexpr ULONG kSlabOrigin = 'balS';
+constexpr ULONG kArenaOrigin = 'anrA';
+constexpr ULONG kReserveOrigin = 'vseR';
+// libccd 定长对象池中的对象（见 libccd_memory.h），只经 FclCcdFree / FclCcdRealloc 释放。
+constexpr ULONG kCcdPoolOrigin = 'dccP';
+
+// 走 slab / 系统池并计入池统计，不经过查询 arena；供 arena 申请自身的内存块。
+// IRQL >= DISPATCH_LEVEL 时只从 DPC 预留池取块，预留池耗尽即返回 NULL。
+_Must_inspect_result_
+void* AllocateFromPool(_In_ size_t size, _In_ ULONG poolTag) noexcept;
+
+void FreeToPool(_Inout_opt_ void* buffer, _In_ ULONG poolTag) noexcept;
+
+}  // namespace detail
+
 template <typename T>
 struct PoolDeleter {
     void operator()(_Inout_opt_ T* ptr) const noexcept {
@@ -0,0 +1,73 @@
+﻿#pragma once
+
+#include "fclmusa/platform.h"
+
+#include <cstddef>
+
+#include "fclmusa/version.h"
+
+//
+// 查询级单调 arena
+// - QueryArenaScope 存续期间，当前线程经 fclmusa::memory::Allocate 的分配（FclDpcNonPagedAllocator、
+//   libccd 钩子 FclCcdCalloc / FclCcdRealloc、内核态全局 operator new）按指针递增从 arena 切出
+// - Free 对 arena 块只在其位于栈顶时回退指针，其余为空操作；作用域结束时整体复位，单块时为 O(1)
+// - arena 块在作用域之间保留（内核态按槽位、用户态按线程），稳态下每次查询不再触碰池分配与池统计
+// - 作用域内分配的对象不得越过作用域存活；嵌套作用域不生效，由最外层负责复位
+// - 单次请求超过 kQueryArenaMaxBlockBytes、arena 被禁用或槽位耗尽时退回池分配
+// - IRQL >= DISPATCH_LEVEL 时作用域不绑定 arena，分配改由 DPC 预留池提供（见 dpc_reserve.h）
+//
+
+typedef struct _FCL_QUERY_ARENA_STATS {
+    ULONGLONG ScopeCount;
+    ULONGLONG ArenaAllocations;
+    ULONGLONG ArenaBytes;
+    ULONGLONG FallbackAllocations;
+    ULONGLONG ChunkAllocations;
+    ULONGLONG PeakScopeBytes;
+} FCL_QUERY_ARENA_STATS, *PFCL_QUERY_ARENA_STATS;
+
+namespace fclmusa::memory {
+
+constexpr size_t kQueryArenaInitialChunkBytes = 16 * 1024;
+constexpr size_t kQueryArenaMaxRetainedBytes = 256 * 1024;
+constexpr size_t kQueryArenaMaxBlockBytes = 64 * 1024;
+
+// 默认启用；关闭后新的作用域不再绑定 arena（已激活的作用域不受影响）。
+void EnableQueryArena(_In_ BOOLEAN enable) noexcept;
+
+BOOLEAN IsQueryArenaEnabled() noexcept;
+
+FCL_QUERY_ARENA_STATS QueryArenaStats() noexcept;
+
+void ResetQueryArenaStats() noexcept;
+
+// 归还空闲 arena 保留的内存块（内核态为全部槽位，用户态为当前线程）；由 ShutdownPoolTracking 调用。
+void ReleaseQueryArenas() noexcept;
+
+class QueryArenaScope {
+public:
+    QueryArenaScope() noexcept;
+    ~QueryArenaScope() noexcept;
+
+    QueryArenaScope(const QueryArenaScope&) = delete;
+    QueryArenaScope& operator=(const QueryArenaScope&) = delete;
+
+    bool Active() const noexcept {
+        return arena_ != nullptr;
+    }
+
+private:
+    void* arena_;
+};
+
+namespace detail {
+
+// 当前线程没有激活的 arena 或请求过大时返回 NULL，由调用方退回池分配。
+_Must_inspect_result_
+void* ArenaAllocate(_In_ size_t size, _In_ ULONG poolTag) noexcept;
+
+void ArenaFree(_In_ void* buffer) noexcept;
+
+}  // namespace detail
+
+}  // namespace fclmusa::memory
@@ -0,0 +1,53 @@
+﻿#pragma once
+
+#include "fclmusa/platform.h"
+
+#include <cstddef>
+
+#include "fclmusa/version.h"
+
+//
+// 小块分级缓存（slab + magazine）
+// - 块大小（含 AllocationHeader）不超过 kSlabMaxBlockBytes 的请求按大小级别从 slab 分配，更大的请求直接走系统池
+// - 每个级别在每个 CPU（内核态，操作期间提升到 DISPATCH_LEVEL）/ 每个线程（用户态）上有一个 magazine，
+//   命中时只操作本地数组；magazine 空 / 满时与全局 depot 成批交换 kSlabTransferCount 个块，depot 再不足时整页申请
+// - slab 页在运行期间不归还系统；ShutdownPoolTracking 时若所有块都已回到 depot 才释放全部页面
+// - 块可以在任意线程 / CPU 上释放，释放时进入当前线程 / CPU 的 magazine
+//
+
+typedef struct _FCL_SLAB_STATS {
+    ULONGLONG SlabPages;
+    ULONGLONG SlabBytes;
+    ULONGLONG DepotRefills;
+    ULONGLONG DepotFlushes;
+} FCL_SLAB_STATS, *PFCL_SLAB_STATS;
+
+namespace fclmusa::memory {
+
+constexpr size_t kSlabMaxBlockBytes = 2048;
+constexpr size_t kSlabPageBytes = 64 * 1024;
+constexpr ULONG kSlabMagazineCapacity = 32;
+constexpr ULONG kSlabTransferCount = kSlabMagazineCapacity / 2;
+
+// 默认启用；关闭后新的小块请求直接走系统池，已分配的 slab 块仍按来源正常释放。
+void EnableSlabCache(_In_ BOOLEAN enable) noexcept;
+
+BOOLEAN IsSlabCacheEnabled() noexcept;
+
+FCL_SLAB_STATS QuerySlabStats() noexcept;
+
+namespace detail {
+
+void InitializeSlabCaches() noexcept;
+
+void ShutdownSlabCaches() noexcept;
+
+// 请求过大、缓存被禁用或申请 slab 页失败时返回 NULL，由调用方退回系统池。返回的块已写好 AllocationHeader。
+_Must_inspect_result_
+void* SlabAllocate(_In_ size_t size, _In_ ULONG poolTag) noexcept;
+
+void SlabFree(_In_ void* buffer) noexcept;
+
+}  // namespace detail
+
+}  // namespace fclmusa::memory
@@ -0,0 +1,33 @@
+﻿#pragma once
+
+#include "fclmusa/platform.h"
+
+#include "fclmusa/collision.h"
+
+//
+// 解析连续碰撞（TOI）内核
+// - 仅处理平移运动：两端旋转相同，或球心与运动参考点重合的球体（旋转不改变其位置）
+// - Sphere/Sphere：相对运动下的一元二次方程闭式解
+// - Sphere/OBB：在盒局部坐标下把球扫掠转化为线段 vs 圆角盒（Ericson 5.5.7）
+// - OBB/OBB：15 轴扫掠分离轴，取各轴进入时刻的最大值
+// 其余情况返回 FALSE，由调用方回退到 upstream 保守推进。
+// 除起始即相交的 OBB/OBB 需要 upstream 生成接触信息外不做分配，可在 DISPATCH_LEVEL 调用。
+//
+
+namespace fclmusa::narrowphase {
+
+BOOLEAN
+AnalyticCcdSupportsPair(
+    _In_ FCL_GEOMETRY_TYPE type1,
+    _In_ FCL_GEOMETRY_TYPE type2) noexcept;
+
+// 已处理时返回 TRUE 并写入 result：Contact 为 TOI 时刻的接触点与法线（对象 1 指向对象 2）。
+BOOLEAN
+TryAnalyticContinuousCollision(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_INTERP_MOTION& motion1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_INTERP_MOTION& motion2,
+    _Out_ PFCL_CONTINUOUS_COLLISION_RESULT result) noexcept;
+
+}  // namespace fclmusa::narrowphase
@@ -0,0 +1,91 @@
+﻿#pragma once
+
+#include "fclmusa/platform.h"
+
+#include "fclmusa/collision.h"
+#include "fclmusa/distance.h"
+
+//
+// 时间相干性缓存（按句柄对索引）
+// - 记录上一帧的分离轴、最近点 / 支撑点与距离
+// - 下一次查询先用缓存的分离轴做区间投影测试，仍然分离则直接确认“未碰撞”，跳过窄阶段
+// - 距离查询另用缓存的最近点给出上界，与分离轴下界之差落在请求误差内时直接复用
+// - 固定容量、4 路组相联，组内按 LRU 淘汰；组锁为 try-lock，竞争时直接旁路，可在 DISPATCH_LEVEL 调用
+//
+
+namespace fclmusa::narrowphase {
+
+struct CoherenceKey {
+    ULONGLONG Handle1;
+    ULONGLONG Handle2;
+};
+
+struct CoherenceDistanceBound {
+    float LowerBound;                // 缓存分离轴上的间隙；轴已失效时为 0
+    BOOLEAN HasUpperBound;
+    BOOLEAN WithinError;             // 上下界之差满足请求的 abs / rel 误差，UpperBound 可直接作为结果
+    FCL_DISTANCE_RESULT UpperBound;  // 上一次最近点随当前位姿移动后的位置与间距
+};
+
+BOOLEAN
+CoherenceCacheIsEnabled() noexcept;
+
+// 缓存的分离轴仍然有效时返回 TRUE；separation 输出沿该轴的间隙（世界坐标，>= 0）。
+BOOLEAN
+CoherenceCacheTryConfirmSeparated(
+    _In_ const CoherenceKey& key,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _Out_opt_ float* separation) noexcept;
+
+// 用缓存的分离轴与最近点在当前位姿下给出距离的上下界；没有可用条目时返回 FALSE。
+BOOLEAN
+CoherenceCacheQueryDistanceBound(
+    _In_ const CoherenceKey& key,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _In_ float absoluteError,
+    _In_ float relativeError,
+    _Out_ CoherenceDistanceBound* bound) noexcept;
+
+VOID
+CoherenceCacheRecordCollision(
+    _In_ const CoherenceKey& key,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _In_ BOOLEAN isColliding) noexcept;
+
+VOID
+CoherenceCacheRecordDistance(
+    _In_ const CoherenceKey& key,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _In_ const FCL_DISTANCE_RESULT& result) noexcept;
+
+// 沿 axis 投影几何体，得到保守的区间 [minValue, maxValue]；Mesh 使用 BVH 根节点包围体，复合几何使用其局部 AABB。
+BOOLEAN
+ProjectSnapshotOntoAxis(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& snapshot,
+    _In_ const FCL_TRANSFORM& transform,
+    _In_ const FCL_VECTOR3& axis,
+    _Out_ float* minValue,
+    _Out_ float* maxValue) noexcept;
+
+// 在中心连线与两物体包围体局部轴中搜索最大间隙，作为两物体距离的保守下界；投影均重叠时返回 FALSE。
+BOOLEAN
+EstimateSeparation(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _Out_ float* separation) noexcept;
+
+}  // namespace fclmusa::narrowphase
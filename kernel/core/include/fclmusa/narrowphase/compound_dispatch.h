@@ -0,0 +1,58 @@
+﻿#pragma once
+
+#include "fclmusa/platform.h"
+
+#include "fclmusa/collision.h"
+#include "fclmusa/distance.h"
+
+//
+// 复合几何查询
+// - 把另一物体的包围体变换到复合体局部坐标，在子形状包围盒树上遍历，只对重叠的子形状分派窄阶段
+// - 子形状位姿 = 复合体变换 ∘ LocalTransform，子形状查询仍走 query_dispatch（原生内核 / MPR / upstream）
+// - 两个物体都不是复合几何时直接转发 DispatchCollision / DispatchDistance
+// children 可选，输出命中的子形状序号；不分配内存，可在 DISPATCH_LEVEL 调用。
+//
+
+namespace fclmusa::narrowphase {
+
+inline bool IsCompoundPair(const FCL_GEOMETRY_SNAPSHOT& object1, const FCL_GEOMETRY_SNAPSHOT& object2) noexcept {
+    return object1.Type == FCL_GEOMETRY_COMPOUND || object2.Type == FCL_GEOMETRY_COMPOUND;
+}
+
+// 布尔查询在首个相交的子形状处返回；请求接触信息时遍历全部重叠子形状，返回穿透最深的接触。
+NTSTATUS
+CompoundCollide(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _Out_ PBOOLEAN isColliding,
+    _Out_opt_ PFCL_CONTACT_INFO contactInfo,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver,
+    _Out_opt_ PFCL_COMPOUND_CHILD_PAIR children) noexcept;
+
+// 接触点按子形状遍历顺序依次填充，数组写满即停止；contacts[0] 为其中穿透最深的接触点。
+NTSTATUS
+CompoundCollideManifold(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _In_ ULONG maxContacts,
+    _Out_ PBOOLEAN isColliding,
+    _Out_writes_(maxContacts) PFCL_CONTACT_INFO contacts,
+    _Out_ PULONG contactCount,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver) noexcept;
+
+// 子形状按包围盒间隙由近到远访问，间隙不小于当前最近距离的子树直接剪枝；出现穿透即停止。
+NTSTATUS
+CompoundDistance(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _Out_ PFCL_DISTANCE_RESULT result,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver,
+    _Out_opt_ PFCL_COMPOUND_CHILD_PAIR children) noexcept;
+
+}  // namespace fclmusa::narrowphase
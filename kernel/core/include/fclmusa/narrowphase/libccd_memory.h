@@ -2,6 +2,18 @@
 
 #include "fclmusa/platform.h"
 
+//
+// libccd 内存钩子（third_party/libccd/alloc.h 把 CCD_ALLOC / CCD_CALLOC / CCD_FREE 映射到这里）
+// - 默认转发到 fclmusa::memory 的 Allocate / Reallocate / Free
+// - CcdObjectPoolScope 存续期间，当前线程上不超过 kCcdPoolMaxObjectBytes 的请求（EPA 多面体的顶点 / 边 / 面、
+//   单纯形支撑点）从定长对象池分配：按 64 字节粒度分 4 个级别，每级一条空闲链表，释放的对象在同一作用域内直接复用
+// - 对象从 4 KB 块中切出，块经 fclmusa::memory::Allocate 申请（查询 arena 激活时来自 arena，
+//   DISPATCH_LEVEL 时来自 DPC 预留池的 4 KB 级别）；作用域结束时整块归还，不逐个释放对象
+// - 作用域内分配的对象不得越过作用域存活；嵌套作用域不生效，由最外层负责释放
+// - 内核态按 (线程, IRQL) 绑定槽位，用户态按线程；槽位耗尽或对象池被禁用时退回 fclmusa::memory
+//
+
+// 此头文件同时被 libccd 的 C 源文件包含，C++ 部分放在 __cplusplus 之内。
 EXTERN_C_START
 
 void* FclCcdRealloc(_Inout_opt_ void* buffer, _In_ size_t size);
@@ -9,3 +21,52 @@ void* FclCcdCalloc(_In_ size_t count, _In_ size_t size);
 void FclCcdFree(_In_opt_ void* buffer);
 
 EXTERN_C_END
+
+#ifdef __cplusplus
+
+#include <cstddef>
+
+typedef struct _FCL_CCD_POOL_STATS {
+    ULONGLONG ScopeCount;
+    ULONGLONG ObjectAllocations;    // 由对象池满足的分配
+    ULONGLONG RecycledAllocations;  // 其中直接复用空闲链表的次数
+    ULONGLONG ObjectFrees;
+    ULONGLONG ChunkAllocations;     // 向 fclmusa::memory 申请的 4 KB 块
+    ULONGLONG FallbackAllocations;  // 作用域内因请求过大或块申请失败而转发到 fclmusa::memory 的分配
+    ULONGLONG PeakScopeObjects;     // 单个作用域内同时存活对象数的峰值
+} FCL_CCD_POOL_STATS, *PFCL_CCD_POOL_STATS;
+
+namespace fclmusa::narrowphase {
+
+constexpr size_t kCcdPoolChunkBytes = 4096 - 64;
+constexpr size_t kCcdPoolMaxObjectBytes = 192;
+
+// 默认启用；关闭后新的作用域不再绑定对象池（已激活的作用域不受影响）。
+void EnableCcdObjectPool(_In_ BOOLEAN enable) noexcept;
+
+BOOLEAN IsCcdObjectPoolEnabled() noexcept;
+
+FCL_CCD_POOL_STATS QueryCcdObjectPoolStats() noexcept;
+
+void ResetCcdObjectPoolStats() noexcept;
+
+// upstream 桥接层在 QueryArenaScope 之后声明，保证对象池的块先于 arena 复位归还。
+class CcdObjectPoolScope {
+public:
+    CcdObjectPoolScope() noexcept;
+    ~CcdObjectPoolScope() noexcept;
+
+    CcdObjectPoolScope(const CcdObjectPoolScope&) = delete;
+    CcdObjectPoolScope& operator=(const CcdObjectPoolScope&) = delete;
+
+    bool Active() const noexcept {
+        return pool_ != nullptr;
+    }
+
+private:
+    void* pool_;
+};
+
+}  // namespace fclmusa::narrowphase
+
+#endif  // __cplusplus
@@ -0,0 +1,29 @@
+﻿#pragma once
+
+#include "fclmusa/platform.h"
+
+#include "fclmusa/geometry.h"
+
+//
+// 基于 libccd MPR（Minkowski Portal Refinement）的纯布尔相交测试
+// - 直接在 FCL_GEOMETRY_SNAPSHOT 上提供 support / center 回调，不构造 fcl::CollisionObject
+// - 只回答“是否相交”，不计算穿透深度与接触点，比 GJK + EPA 路径更短
+// - Mesh 以其顶点凸包参与测试：凸包不相交即可确认 Mesh 不相交，相交时调用方需回退到 BVH 精确检测
+//
+
+namespace fclmusa::narrowphase {
+
+BOOLEAN
+MprSupportsGeometry(
+    _In_ FCL_GEOMETRY_TYPE type) noexcept;
+
+// object 为凸体（Mesh 视为凸包）时的 MPR 相交测试；类型不支持时返回 STATUS_NOT_SUPPORTED。
+NTSTATUS
+MprIntersect(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _Out_ PBOOLEAN isIntersecting) noexcept;
+
+}  // namespace fclmusa::narrowphase
@@ -0,0 +1,773 @@
+﻿#pragma once
+
+#include "fclmusa/platform.h"
+
+#include "fclmusa/collision.h"
+#include "fclmusa/distance.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/geometry/obb.h"
+
+//
+// 基本体窄阶段内核（header-only）
+// - ShapeTraits<Type> 把 FCL_GEOMETRY_TYPE 映射到对应的描述结构
+// - PairKernel<A, B> 为具体形状对提供 Intersect / Contact / Distance 实现
+// - 未特化的组合 kXxx 为 false，由 query_dispatch 回退到 upstream FCL
+// 结果约定与 upstream FCL 保持一致：法线由对象 1 指向对象 2，穿透时距离为 -1。
+//
+
+namespace fclmusa::narrowphase {
+
+struct KernelContact {
+    FCL_VECTOR3 Normal;
+    FCL_VECTOR3 Position;
+    float PenetrationDepth;
+};
+
+template <FCL_GEOMETRY_TYPE Type>
+struct ShapeTraits {
+    static constexpr bool kIsPrimitive = false;
+};
+
+template <>
+struct ShapeTraits<FCL_GEOMETRY_SPHERE> {
+    using Desc = FCL_SPHERE_GEOMETRY_DESC;
+    static constexpr bool kIsPrimitive = true;
+
+    static const Desc& From(const FCL_GEOMETRY_SNAPSHOT& snapshot) noexcept {
+        return snapshot.Data.Sphere;
+    }
+
+    static bool IsValid(const Desc& desc) noexcept {
+        return geom::IsValidVector(desc.Center) && geom::IsFiniteFloat(desc.Radius) && desc.Radius > 0.0f;
+    }
+};
+
+template <>
+struct ShapeTraits<FCL_GEOMETRY_OBB> {
+    using Desc = FCL_OBB_GEOMETRY_DESC;
+    static constexpr bool kIsPrimitive = true;
+
+    static const Desc& From(const FCL_GEOMETRY_SNAPSHOT& snapshot) noexcept {
+        return snapshot.Data.Obb;
+    }
+
+    static bool IsValid(const Desc& desc) noexcept {
+        return geom::IsValidVector(desc.Center) &&
+               geom::IsValidVector(desc.Extents) &&
+               geom::IsValidMatrix(desc.Rotation) &&
+               desc.Extents.X > 0.0f && desc.Extents.Y > 0.0f && desc.Extents.Z > 0.0f;
+    }
+};
+
+template <>
+struct ShapeTraits<FCL_GEOMETRY_CAPSULE> {
+    using Desc = FCL_CAPSULE_GEOMETRY_DESC;
+    static constexpr bool kIsPrimitive = true;
+
+    static const Desc& From(const FCL_GEOMETRY_SNAPSHOT& snapshot) noexcept {
+        return snapshot.Data.Capsule;
+    }
+
+    static bool IsValid(const Desc& desc) noexcept {
+        return geom::IsValidVector(desc.Center) &&
+               geom::IsValidMatrix(desc.Rotation) &&
+               geom::IsFiniteFloat(desc.Radius) && desc.Radius > 0.0f &&
+               geom::IsFiniteFloat(desc.HalfLength) && desc.HalfLength > 0.0f;
+    }
+};
+
+namespace detail {
+
+struct WorldSphere {
+    FCL_VECTOR3 Center;
+    float Radius;
+};
+
+inline WorldSphere BuildWorldSphere(const FCL_SPHERE_GEOMETRY_DESC& desc, const FCL_TRANSFORM& transform) noexcept {
+    return {geom::TransformPoint(transform, desc.Center), desc.Radius};
+}
+
+// 胶囊体的世界轴线段（Start -> End）与半径。
+struct WorldCapsule {
+    FCL_VECTOR3 Start;
+    FCL_VECTOR3 End;
+    float Radius;
+};
+
+inline WorldCapsule BuildWorldCapsule(const FCL_CAPSULE_GEOMETRY_DESC& desc, const FCL_TRANSFORM& transform) noexcept {
+    const FCL_VECTOR3 center = geom::TransformPoint(transform, desc.Center);
+    const FCL_VECTOR3 axis = geom::MatrixVectorMultiply(
+        geom::MultiplyMatrix(transform.Rotation, desc.Rotation), {0.0f, 0.0f, 1.0f});
+    const FCL_VECTOR3 halfAxis = geom::Scale(axis, desc.HalfLength);
+    return {geom::Subtract(center, halfAxis), geom::Add(center, halfAxis), desc.Radius};
+}
+
+// 与 direction 垂直的任一单位向量（球心落在胶囊轴线上时的推出方向）。
+inline FCL_VECTOR3 AnyPerpendicular(const FCL_VECTOR3& direction) noexcept {
+    const FCL_VECTOR3 reference = (fabs(direction.X) < 0.6f) ? FCL_VECTOR3{1.0f, 0.0f, 0.0f} : FCL_VECTOR3{0.0f, 1.0f, 0.0f};
+    return geom::Normalize(geom::Cross(direction, reference));
+}
+
+inline FCL_VECTOR3 ClosestPointOnSegment(const FCL_VECTOR3& point, const FCL_VECTOR3& start, const FCL_VECTOR3& end) noexcept {
+    const FCL_VECTOR3 direction = geom::Subtract(end, start);
+    const float lengthSquared = geom::Dot(direction, direction);
+    if (lengthSquared <= geom::kSingularityEpsilon) {
+        return start;
+    }
+    const float t = geom::Clamp(geom::Dot(geom::Subtract(point, start), direction) / lengthSquared, 0.0f, 1.0f);
+    return geom::Add(start, geom::Scale(direction, t));
+}
+
+// 两线段最近点对，参考 Ericson《Real-Time Collision Detection》5.1.9。
+inline void ClosestPointsOnSegments(
+    const FCL_VECTOR3& start1,
+    const FCL_VECTOR3& end1,
+    const FCL_VECTOR3& start2,
+    const FCL_VECTOR3& end2,
+    _Out_ FCL_VECTOR3* point1,
+    _Out_ FCL_VECTOR3* point2) noexcept {
+    const FCL_VECTOR3 d1 = geom::Subtract(end1, start1);
+    const FCL_VECTOR3 d2 = geom::Subtract(end2, start2);
+    const FCL_VECTOR3 r = geom::Subtract(start1, start2);
+    const float a = geom::Dot(d1, d1);
+    const float e = geom::Dot(d2, d2);
+    const float f = geom::Dot(d2, r);
+    float s = 0.0f;
+    float t = 0.0f;
+    if (a <= geom::kSingularityEpsilon && e <= geom::kSingularityEpsilon) {
+        s = 0.0f;
+        t = 0.0f;
+    } else if (a <= geom::kSingularityEpsilon) {
+        t = geom::Clamp(f / e, 0.0f, 1.0f);
+    } else {
+        const float c = geom::Dot(d1, r);
+        if (e <= geom::kSingularityEpsilon) {
+            s = geom::Clamp(-c / a, 0.0f, 1.0f);
+        } else {
+            const float b = geom::Dot(d1, d2);
+            const float denominator = a * e - b * b;
+            // 平行线段任取 s = 0，随后按 t 的截断回代。
+            s = (denominator > geom::kSingularityEpsilon * a * e) ? geom::Clamp((b * f - c * e) / denominator, 0.0f, 1.0f) : 0.0f;
+            t = (b * s + f) / e;
+            if (t < 0.0f) {
+                t = 0.0f;
+                s = geom::Clamp(-c / a, 0.0f, 1.0f);
+            } else if (t > 1.0f) {
+                t = 1.0f;
+                s = geom::Clamp((b - c) / a, 0.0f, 1.0f);
+            }
+        }
+    }
+    *point1 = geom::Add(start1, geom::Scale(d1, s));
+    *point2 = geom::Add(start2, geom::Scale(d2, t));
+}
+
+// 球-球接触 / 距离；胶囊体组合先取轴线最近点再归约到这里。
+// 球心重合时法线取 fallbackNormal。
+inline bool SphereSphereContact(
+    const WorldSphere& s1,
+    const WorldSphere& s2,
+    const FCL_VECTOR3& fallbackNormal,
+    _Out_ KernelContact* contact) noexcept {
+    const FCL_VECTOR3 diff = geom::Subtract(s2.Center, s1.Center);
+    const float length = geom::Length(diff);
+    const float radiusSum = s1.Radius + s2.Radius;
+    if (length > radiusSum) {
+        return false;
+    }
+    contact->Normal = (length > 0.0f) ? geom::Scale(diff, 1.0f / length) : fallbackNormal;
+    contact->Position = geom::Add(s1.Center, geom::Scale(diff, s1.Radius / radiusSum));
+    contact->PenetrationDepth = radiusSum - length;
+    return true;
+}
+
+inline void SphereSphereDistance(
+    const WorldSphere& s1,
+    const WorldSphere& s2,
+    _Out_ PFCL_DISTANCE_RESULT result) noexcept {
+    const FCL_VECTOR3 diff = geom::Subtract(s2.Center, s1.Center);
+    const float length = geom::Length(diff);
+    if (length <= s1.Radius + s2.Radius) {
+        result->Distance = -1.0f;
+        result->ClosestPoint1 = {0.0f, 0.0f, 0.0f};
+        result->ClosestPoint2 = {0.0f, 0.0f, 0.0f};
+        return;
+    }
+    const FCL_VECTOR3 direction = geom::Scale(diff, 1.0f / length);
+    result->Distance = length - s1.Radius - s2.Radius;
+    result->ClosestPoint1 = geom::Add(s1.Center, geom::Scale(direction, s1.Radius));
+    result->ClosestPoint2 = geom::Subtract(s2.Center, geom::Scale(direction, s2.Radius));
+}
+
+inline float ExtentAt(const FCL_VECTOR3& extents, int axis) noexcept {
+    return (&extents.X)[axis];
+}
+
+// 球心位于盒内时，选择穿透最浅的面作为推出方向。
+inline void ResolveInteriorSphere(
+    const geom::OrientedBox& box,
+    const WorldSphere& sphere,
+    _Out_ KernelContact* contact) noexcept {
+    const FCL_VECTOR3 delta = geom::Subtract(sphere.Center, box.Center);
+    int bestAxis = 0;
+    float bestSign = 1.0f;
+    float bestDepth = FLT_MAX;
+    for (int axis = 0; axis < 3; ++axis) {
+        const float local = geom::Dot(delta, box.Axes[axis]);
+        const float faceDepth = ExtentAt(box.Extents, axis) - static_cast<float>(fabs(local));
+        if (faceDepth < bestDepth) {
+            bestDepth = faceDepth;
+            bestAxis = axis;
+            bestSign = (local >= 0.0f) ? 1.0f : -1.0f;
+        }
+    }
+    contact->Normal = geom::Scale(box.Axes[bestAxis], -bestSign);
+    contact->PenetrationDepth = sphere.Radius + bestDepth;
+    contact->Position = sphere.Center;
+}
+
+// Gottschalk 15 轴分离轴测试，参考 Ericson《Real-Time Collision Detection》4.4.1。
+inline bool ObbObbOverlap(const geom::OrientedBox& a, const geom::OrientedBox& b) noexcept {
+    float rotation[3][3];
+    float absRotation[3][3];
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            rotation[i][j] = geom::Dot(a.Axes[i], b.Axes[j]);
+            absRotation[i][j] = static_cast<float>(fabs(rotation[i][j])) + geom::kAxisEpsilon;
+        }
+    }
+
+    const FCL_VECTOR3 offset = geom::Subtract(b.Center, a.Center);
+    const float t[3] = {
+        geom::Dot(offset, a.Axes[0]),
+        geom::Dot(offset, a.Axes[1]),
+        geom::Dot(offset, a.Axes[2])};
+    const float ea[3] = {a.Extents.X, a.Extents.Y, a.Extents.Z};
+    const float eb[3] = {b.Extents.X, b.Extents.Y, b.Extents.Z};
+
+    for (int i = 0; i < 3; ++i) {
+        const float ra = ea[i];
+        const float rb = eb[0] * absRotation[i][0] + eb[1] * absRotation[i][1] + eb[2] * absRotation[i][2];
+        if (fabs(t[i]) > ra + rb) {
+            return false;
+        }
+    }
+
+    for (int j = 0; j < 3; ++j) {
+        const float ra = ea[0] * absRotation[0][j] + ea[1] * absRotation[1][j] + ea[2] * absRotation[2][j];
+        const float rb = eb[j];
+        const float projected = t[0] * rotation[0][j] + t[1] * rotation[1][j] + t[2] * rotation[2][j];
+        if (fabs(projected) > ra + rb) {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        const int i1 = (i + 1) % 3;
+        const int i2 = (i + 2) % 3;
+        for (int j = 0; j < 3; ++j) {
+            const int j1 = (j + 1) % 3;
+            const int j2 = (j + 2) % 3;
+            const float ra = ea[i1] * absRotation[i2][j] + ea[i2] * absRotation[i1][j];
+            const float rb = eb[j1] * absRotation[i][j2] + eb[j2] * absRotation[i][j1];
+            const float projected = t[i2] * rotation[i1][j] - t[i1] * rotation[i2][j];
+            if (fabs(projected) > ra + rb) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// 线段与 OBB 的最近点对，返回距离平方；线段穿过盒体时返回 0，两点均取进入点。
+// 不相交时最近点对必然出现在“端点-盒体”或“线段-盒体棱”之间（线段内部点对应面内点时线段与面平行，
+// 可沿线段滑动到端点或棱上而距离不变），因此只需比较 2 个端点与 12 条棱。
+inline float ClosestPointsSegmentObb(
+    const FCL_VECTOR3& start,
+    const FCL_VECTOR3& end,
+    const geom::OrientedBox& box,
+    _Out_ FCL_VECTOR3* onSegment,
+    _Out_ FCL_VECTOR3* onBox) noexcept {
+    float localStart[3];
+    float localDirection[3];
+    const FCL_VECTOR3 offset = geom::Subtract(start, box.Center);
+    const FCL_VECTOR3 direction = geom::Subtract(end, start);
+    for (int axis = 0; axis < 3; ++axis) {
+        localStart[axis] = geom::Dot(offset, box.Axes[axis]);
+        localDirection[axis] = geom::Dot(direction, box.Axes[axis]);
+    }
+
+    float enter = 0.0f;
+    float exit = 1.0f;
+    bool crosses = true;
+    for (int axis = 0; axis < 3 && crosses; ++axis) {
+        const float extent = ExtentAt(box.Extents, axis);
+        if (fabs(localDirection[axis]) <= geom::kSingularityEpsilon) {
+            crosses = fabs(localStart[axis]) <= extent;
+            continue;
+        }
+        float t0 = (-extent - localStart[axis]) / localDirection[axis];
+        float t1 = (extent - localStart[axis]) / localDirection[axis];
+        if (t0 > t1) {
+            const float swap = t0;
+            t0 = t1;
+            t1 = swap;
+        }
+        enter = (t0 > enter) ? t0 : enter;
+        exit = (t1 < exit) ? t1 : exit;
+        crosses = enter <= exit;
+    }
+    if (crosses) {
+        *onSegment = geom::Add(start, geom::Scale(direction, enter));
+        *onBox = *onSegment;
+        return 0.0f;
+    }
+
+    float best = FLT_MAX;
+    const FCL_VECTOR3 endpoints[2] = {start, end};
+    for (const FCL_VECTOR3& endpoint : endpoints) {
+        const FCL_VECTOR3 closest = geom::ClosestPointOnObb(box, endpoint);
+        const FCL_VECTOR3 delta = geom::Subtract(closest, endpoint);
+        const float distanceSquared = geom::Dot(delta, delta);
+        if (distanceSquared < best) {
+            best = distanceSquared;
+            *onSegment = endpoint;
+            *onBox = closest;
+        }
+    }
+
+    for (int axis = 0; axis < 3; ++axis) {
+        const int axis1 = (axis + 1) % 3;
+        const int axis2 = (axis + 2) % 3;
+        const FCL_VECTOR3 halfEdge = geom::Scale(box.Axes[axis], ExtentAt(box.Extents, axis));
+        for (int corner = 0; corner < 4; ++corner) {
+            const float sign1 = (corner & 1) ? 1.0f : -1.0f;
+            const float sign2 = (corner & 2) ? 1.0f : -1.0f;
+            const FCL_VECTOR3 edgeCenter = geom::Add(
+                box.Center,
+                geom::Add(
+                    geom::Scale(box.Axes[axis1], sign1 * ExtentAt(box.Extents, axis1)),
+                    geom::Scale(box.Axes[axis2], sign2 * ExtentAt(box.Extents, axis2))));
+            FCL_VECTOR3 pointOnSegment = {};
+            FCL_VECTOR3 pointOnEdge = {};
+            ClosestPointsOnSegments(
+                start, end, geom::Subtract(edgeCenter, halfEdge), geom::Add(edgeCenter, halfEdge), &pointOnSegment, &pointOnEdge);
+            const FCL_VECTOR3 delta = geom::Subtract(pointOnEdge, pointOnSegment);
+            const float distanceSquared = geom::Dot(delta, delta);
+            if (distanceSquared < best) {
+                best = distanceSquared;
+                *onSegment = pointOnSegment;
+                *onBox = pointOnEdge;
+            }
+        }
+    }
+    return best;
+}
+
+// 胶囊轴线穿过盒体时，沿 6 个面法线求把胶囊完全推出所需的最小平移。
+inline void ResolveInteriorCapsule(
+    const geom::OrientedBox& box,
+    const WorldCapsule& capsule,
+    _Out_ KernelContact* contact) noexcept {
+    const FCL_VECTOR3 endpoints[2] = {capsule.Start, capsule.End};
+    float local[2][3];
+    for (int i = 0; i < 2; ++i) {
+        const FCL_VECTOR3 offset = geom::Subtract(endpoints[i], box.Center);
+        for (int axis = 0; axis < 3; ++axis) {
+            local[i][axis] = geom::Dot(offset, box.Axes[axis]);
+        }
+    }
+
+    float bestDepth = FLT_MAX;
+    for (int axis = 0; axis < 3; ++axis) {
+        for (float sign = 1.0f; sign >= -1.0f; sign -= 2.0f) {
+            const int deepest = (sign * local[0][axis] <= sign * local[1][axis]) ? 0 : 1;
+            const float depth = ExtentAt(box.Extents, axis) + capsule.Radius - sign * local[deepest][axis];
+            if (depth < bestDepth) {
+                bestDepth = depth;
+                contact->Normal = geom::Scale(box.Axes[axis], -sign);
+                contact->Position = endpoints[deepest];
+            }
+        }
+    }
+    contact->PenetrationDepth = bestDepth;
+}
+
+}  // namespace detail
+
+template <FCL_GEOMETRY_TYPE A, FCL_GEOMETRY_TYPE B>
+struct PairKernel {
+    static constexpr bool kIntersect = false;
+    static constexpr bool kContact = false;
+    static constexpr bool kDistance = false;
+};
+
+template <>
+struct PairKernel<FCL_GEOMETRY_SPHERE, FCL_GEOMETRY_SPHERE> {
+    static constexpr bool kIntersect = true;
+    static constexpr bool kContact = true;
+    static constexpr bool kDistance = true;
+
+    static bool Intersect(
+        const FCL_SPHERE_GEOMETRY_DESC& desc1,
+        const FCL_TRANSFORM& transform1,
+        const FCL_SPHERE_GEOMETRY_DESC& desc2,
+        const FCL_TRANSFORM& transform2) noexcept {
+        const detail::WorldSphere s1 = detail::BuildWorldSphere(desc1, transform1);
+        const detail::WorldSphere s2 = detail::BuildWorldSphere(desc2, transform2);
+        const FCL_VECTOR3 diff = geom::Subtract(s2.Center, s1.Center);
+        const float radiusSum = s1.Radius + s2.Radius;
+        return geom::Dot(diff, diff) <= radiusSum * radiusSum;
+    }
+
+    static bool Contact(
+        const FCL_SPHERE_GEOMETRY_DESC& desc1,
+        const FCL_TRANSFORM& transform1,
+        const FCL_SPHERE_GEOMETRY_DESC& desc2,
+        const FCL_TRANSFORM& transform2,
+        _Out_ KernelContact* contact) noexcept {
+        return detail::SphereSphereContact(
+            detail::BuildWorldSphere(desc1, transform1),
+            detail::BuildWorldSphere(desc2, transform2),
+            {0.0f, 0.0f, 0.0f},
+            contact);
+    }
+
+    static void Distance(
+        const FCL_SPHERE_GEOMETRY_DESC& desc1,
+        const FCL_TRANSFORM& transform1,
+        const FCL_SPHERE_GEOMETRY_DESC& desc2,
+        const FCL_TRANSFORM& transform2,
+        _Out_ PFCL_DISTANCE_RESULT result) noexcept {
+        detail::SphereSphereDistance(
+            detail::BuildWorldSphere(desc1, transform1),
+            detail::BuildWorldSphere(desc2, transform2),
+            result);
+    }
+};
+
+template <>
+struct PairKernel<FCL_GEOMETRY_SPHERE, FCL_GEOMETRY_OBB> {
+    static constexpr bool kIntersect = true;
+    static constexpr bool kContact = true;
+    static constexpr bool kDistance = true;
+
+    static bool Intersect(
+        const FCL_SPHERE_GEOMETRY_DESC& desc1,
+        const FCL_TRANSFORM& transform1,
+        const FCL_OBB_GEOMETRY_DESC& desc2,
+        const FCL_TRANSFORM& transform2) noexcept {
+        const detail::WorldSphere sphere = detail::BuildWorldSphere(desc1, transform1);
+        const geom::OrientedBox box = geom::BuildWorldObb(desc2, transform2);
+        const FCL_VECTOR3 delta = geom::Subtract(geom::ClosestPointOnObb(box, sphere.Center), sphere.Center);
+        return geom::Dot(delta, delta) <= sphere.Radius * sphere.Radius;
+    }
+
+    static bool Contact(
+        const FCL_SPHERE_GEOMETRY_DESC& desc1,
+        const FCL_TRANSFORM& transform1,
+        const FCL_OBB_GEOMETRY_DESC& desc2,
+        const FCL_TRANSFORM& transform2,
+        _Out_ KernelContact* contact) noexcept {
+        const detail::WorldSphere sphere = detail::BuildWorldSphere(desc1, transform1);
+        const geom::OrientedBox box = geom::BuildWorldObb(desc2, transform2);
+        const FCL_VECTOR3 closest = geom::ClosestPointOnObb(box, sphere.Center);
+        const FCL_VECTOR3 delta = geom::Subtract(closest, sphere.Center);
+        const float distanceSquared = geom::Dot(delta, delta);
+        if (distanceSquared > sphere.Radius * sphere.Radius) {
+            return false;
+        }
+
+        const float distance = static_cast<float>(sqrt(distanceSquared));
+        if (distance <= geom::kSingularityEpsilon) {
+            detail::ResolveInteriorSphere(box, sphere, contact);
+            return true;
+        }
+        contact->Normal = geom::Scale(delta, 1.0f / distance);
+        contact->PenetrationDepth = sphere.Radius - distance;
+        contact->Position = closest;
+        return true;
+    }
+
+    static void Distance(
+        const FCL_SPHERE_GEOMETRY_DESC& desc1,
+        const FCL_TRANSFORM& transform1,
+        const FCL_OBB_GEOMETRY_DESC& desc2,
+        const FCL_TRANSFORM& transform2,
+        _Out_ PFCL_DISTANCE_RESULT result) noexcept {
+        const detail::WorldSphere sphere = detail::BuildWorldSphere(desc1, transform1);
+        const geom::OrientedBox box = geom::BuildWorldObb(desc2, transform2);
+        const FCL_VECTOR3 closest = geom::ClosestPointOnObb(box, sphere.Center);
+        const FCL_VECTOR3 delta = geom::Subtract(closest, sphere.Center);
+        const float distance = geom::Length(delta);
+        if (distance <= sphere.Radius) {
+            result->Distance = -1.0f;
+            result->ClosestPoint1 = {0.0f, 0.0f, 0.0f};
+            result->ClosestPoint2 = {0.0f, 0.0f, 0.0f};
+            return;
+        }
+        result->Distance = distance - sphere.Radius;
+        result->ClosestPoint1 = geom::Add(sphere.Center, geom::Scale(delta, sphere.Radius / distance));
+        result->ClosestPoint2 = closest;
+    }
+};
+
+template <>
+struct PairKernel<FCL_GEOMETRY_OBB, FCL_GEOMETRY_OBB> {
+    static constexpr bool kIntersect = true;
+    static constexpr bool kContact = false;
+    static constexpr bool kDistance = false;
+
+    static bool Intersect(
+        const FCL_OBB_GEOMETRY_DESC& desc1,
+        const FCL_TRANSFORM& transform1,
+        const FCL_OBB_GEOMETRY_DESC& desc2,
+        const FCL_TRANSFORM& transform2) noexcept {
+        return detail::ObbObbOverlap(
+            geom::BuildWorldObb(desc1, transform1),
+            geom::BuildWorldObb(desc2, transform2));
+    }
+};
+
+template <>
+struct PairKernel<FCL_GEOMETRY_SPHERE, FCL_GEOMETRY_CAPSULE> {
+    static constexpr bool kIntersect = true;
+    static constexpr bool kContact = true;
+    static constexpr bool kDistance = true;
+
+    // 胶囊体等价于以轴线最近点为球心的球。
+    static detail::WorldSphere NearestSphere(const detail::WorldSphere& sphere, const detail::WorldCapsule& capsule) noexcept {
+        return {detail::ClosestPointOnSegment(sphere.Center, capsule.Start, capsule.End), capsule.Radius};
+    }
+
+    static bool Intersect(
+        const FCL_SPHERE_GEOMETRY_DESC& desc1,
+        const FCL_TRANSFORM& transform1,
+        const FCL_CAPSULE_GEOMETRY_DESC& desc2,
+        const FCL_TRANSFORM& transform2) noexcept {
+        const detail::WorldSphere sphere = detail::BuildWorldSphere(desc1, transform1);
+        const detail::WorldSphere nearest = NearestSphere(sphere, detail::BuildWorldCapsule(desc2, transform2));
+        const FCL_VECTOR3 diff = geom::Subtract(nearest.Center, sphere.Center);
+        const float radiusSum = sphere.Radius + nearest.Radius;
+        return geom::Dot(diff, diff) <= radiusSum * radiusSum;
+    }
+
+    static bool Contact(
+        const FCL_SPHERE_GEOMETRY_DESC& desc1,
+        const FCL_TRANSFORM& transform1,
+        const FCL_CAPSULE_GEOMETRY_DESC& desc2,
+        const FCL_TRANSFORM& transform2,
+        _Out_ KernelContact* contact) noexcept {
+        const detail::WorldSphere sphere = detail::BuildWorldSphere(desc1, transform1);
+        const detail::WorldCapsule capsule = detail::BuildWorldCapsule(desc2, transform2);
+        return detail::SphereSphereContact(
+            sphere,
+            NearestSphere(sphere, capsule),
+            detail::AnyPerpendicular(geom::Subtract(capsule.End, capsule.Start)),
+            contact);
+    }
+
+    static void Distance(
+        const FCL_SPHERE_GEOMETRY_DESC& desc1,
+        const FCL_TRANSFORM& transform1,
+        const FCL_CAPSULE_GEOMETRY_DESC& desc2,
+        const FCL_TRANSFORM& transform2,
+        _Out_ PFCL_DISTANCE_RESULT result) noexcept {
+        const detail::WorldSphere sphere = detail::BuildWorldSphere(desc1, transform1);
+        detail::SphereSphereDistance(sphere, NearestSphere(sphere, detail::BuildWorldCapsule(desc2, transform2)), result);
+    }
+};
+
+template <>
+struct PairKernel<FCL_GEOMETRY_CAPSULE, FCL_GEOMETRY_CAPSULE> {
+    static constexpr bool kIntersect = true;
+    static constexpr bool kContact = true;
+    static constexpr bool kDistance = true;
+
+    // 两条轴线的最近点对，各自作为等效球心。
+    static void NearestSpheres(
+        const detail::WorldCapsule& capsule1,
+        const detail::WorldCapsule& capsule2,
+        _Out_ detail::WorldSphere* sphere1,
+        _Out_ detail::WorldSphere* sphere2) noexcept {
+        detail::ClosestPointsOnSegments(
+            capsule1.Start, capsule1.End, capsule2.Start, capsule2.End, &sphere1->Center, &sphere2->Center);
+        sphere1->Radius = capsule1.Radius;
+        sphere2->Radius = capsule2.Radius;
+    }
+
+    static bool Intersect(
+        const FCL_CAPSULE_GEOMETRY_DESC& desc1,
+        const FCL_TRANSFORM& transform1,
+        const FCL_CAPSULE_GEOMETRY_DESC& desc2,
+        const FCL_TRANSFORM& transform2) noexcept {
+        detail::WorldSphere sphere1 = {};
+        detail::WorldSphere sphere2 = {};
+        NearestSpheres(detail::BuildWorldCapsule(desc1, transform1), detail::BuildWorldCapsule(desc2, transform2), &sphere1, &sphere2);
+        const FCL_VECTOR3 diff = geom::Subtract(sphere2.Center, sphere1.Center);
+        const float radiusSum = sphere1.Radius + sphere2.Radius;
+        return geom::Dot(diff, diff) <= radiusSum * radiusSum;
+    }
+
+    static bool Contact(
+        const FCL_CAPSULE_GEOMETRY_DESC& desc1,
+        const FCL_TRANSFORM& transform1,
+        const FCL_CAPSULE_GEOMETRY_DESC& desc2,
+        const FCL_TRANSFORM& transform2,
+        _Out_ KernelContact* contact) noexcept {
+        const detail::WorldCapsule capsule1 = detail::BuildWorldCapsule(desc1, transform1);
+        const detail::WorldCapsule capsule2 = detail::BuildWorldCapsule(desc2, transform2);
+        detail::WorldSphere sphere1 = {};
+        detail::WorldSphere sphere2 = {};
+        NearestSpheres(capsule1, capsule2, &sphere1, &sphere2);
+        // 轴线相交时取两轴的公垂方向；平行重合时取任一垂直方向。
+        const FCL_VECTOR3 axis1 = geom::Subtract(capsule1.End, capsule1.Start);
+        const FCL_VECTOR3 normal = geom::Cross(axis1, geom::Subtract(capsule2.End, capsule2.Start));
+        const FCL_VECTOR3 fallback = (geom::Length(normal) > geom::kSingularityEpsilon)
+            ? geom::Normalize(normal)
+            : detail::AnyPerpendicular(axis1);
+        return detail::SphereSphereContact(sphere1, sphere2, fallback, contact);
+    }
+
+    static void Distance(
+        const FCL_CAPSULE_GEOMETRY_DESC& desc1,
+        const FCL_TRANSFORM& transform1,
+        const FCL_CAPSULE_GEOMETRY_DESC& desc2,
+        const FCL_TRANSFORM& transform2,
+        _Out_ PFCL_DISTANCE_RESULT result) noexcept {
+        detail::WorldSphere sphere1 = {};
+        detail::WorldSphere sphere2 = {};
+        NearestSpheres(detail::BuildWorldCapsule(desc1, transform1), detail::BuildWorldCapsule(desc2, transform2), &sphere1, &sphere2);
+        detail::SphereSphereDistance(sphere1, sphere2, result);
+    }
+};
+
+template <>
+struct PairKernel<FCL_GEOMETRY_CAPSULE, FCL_GEOMETRY_OBB> {
+    static constexpr bool kIntersect = true;
+    static constexpr bool kContact = true;
+    static constexpr bool kDistance = true;
+
+    static bool Intersect(
+        const FCL_CAPSULE_GEOMETRY_DESC& desc1,
+        const FCL_TRANSFORM& transform1,
+        const FCL_OBB_GEOMETRY_DESC& desc2,
+        const FCL_TRANSFORM& transform2) noexcept {
+        const detail::WorldCapsule capsule = detail::BuildWorldCapsule(desc1, transform1);
+        FCL_VECTOR3 onSegment = {};
+        FCL_VECTOR3 onBox = {};
+        const float distanceSquared = detail::ClosestPointsSegmentObb(
+            capsule.Start, capsule.End, geom::BuildWorldObb(desc2, transform2), &onSegment, &onBox);
+        return distanceSquared <= capsule.Radius * capsule.Radius;
+    }
+
+    static bool Contact(
+        const FCL_CAPSULE_GEOMETRY_DESC& desc1,
+        const FCL_TRANSFORM& transform1,
+        const FCL_OBB_GEOMETRY_DESC& desc2,
+        const FCL_TRANSFORM& transform2,
+        _Out_ KernelContact* contact) noexcept {
+        const detail::WorldCapsule capsule = detail::BuildWorldCapsule(desc1, transform1);
+        const geom::OrientedBox box = geom::BuildWorldObb(desc2, transform2);
+        FCL_VECTOR3 onSegment = {};
+        FCL_VECTOR3 onBox = {};
+        const float distanceSquared = detail::ClosestPointsSegmentObb(capsule.Start, capsule.End, box, &onSegment, &onBox);
+        if (distanceSquared > capsule.Radius * capsule.Radius) {
+            return false;
+        }
+
+        // 轴线在盒外时与“以轴线最近点为球心的球-盒”接触一致。
+        const float distance = static_cast<float>(sqrt(distanceSquared));
+        if (distance <= geom::kSingularityEpsilon) {
+            detail::ResolveInteriorCapsule(box, capsule, contact);
+            return true;
+        }
+        contact->Normal = geom::Scale(geom::Subtract(onBox, onSegment), 1.0f / distance);
+        contact->PenetrationDepth = capsule.Radius - distance;
+        contact->Position = onBox;
+        return true;
+    }
+
+    static void Distance(
+        const FCL_CAPSULE_GEOMETRY_DESC& desc1,
+        const FCL_TRANSFORM& transform1,
+        const FCL_OBB_GEOMETRY_DESC& desc2,
+        const FCL_TRANSFORM& transform2,
+        _Out_ PFCL_DISTANCE_RESULT result) noexcept {
+        const detail::WorldCapsule capsule = detail::BuildWorldCapsule(desc1, transform1);
+        FCL_VECTOR3 onSegment = {};
+        FCL_VECTOR3 onBox = {};
+        const float distance = static_cast<float>(sqrt(detail::ClosestPointsSegmentObb(
+            capsule.Start, capsule.End, geom::BuildWorldObb(desc2, transform2), &onSegment, &onBox)));
+        if (distance <= capsule.Radius) {
+            result->Distance = -1.0f;
+            result->ClosestPoint1 = {0.0f, 0.0f, 0.0f};
+            result->ClosestPoint2 = {0.0f, 0.0f, 0.0f};
+            return;
+        }
+        result->Distance = distance - capsule.Radius;
+        result->ClosestPoint1 = geom::Add(onSegment, geom::Scale(geom::Subtract(onBox, onSegment), capsule.Radius / distance));
+        result->ClosestPoint2 = onBox;
+    }
+};
+
+//
+// 交换参数顺序的组合复用 PairKernel<B, A>，并翻转法线 / 最近点，保证对象 1/2 语义不变。
+//
+template <FCL_GEOMETRY_TYPE A, FCL_GEOMETRY_TYPE B>
+struct SwappedPairKernel {
+    using Forward = PairKernel<B, A>;
+    using Desc1 = typename ShapeTraits<A>::Desc;
+    using Desc2 = typename ShapeTraits<B>::Desc;
+
+    static constexpr bool kIntersect = Forward::kIntersect;
+    static constexpr bool kContact = Forward::kContact;
+    static constexpr bool kDistance = Forward::kDistance;
+
+    static bool Intersect(
+        const Desc1& desc1,
+        const FCL_TRANSFORM& transform1,
+        const Desc2& desc2,
+        const FCL_TRANSFORM& transform2) noexcept {
+        return Forward::Intersect(desc2, transform2, desc1, transform1);
+    }
+
+    static bool Contact(
+        const Desc1& desc1,
+        const FCL_TRANSFORM& transform1,
+        const Desc2& desc2,
+        const FCL_TRANSFORM& transform2,
+        _Out_ KernelContact* contact) noexcept {
+        if (!Forward::Contact(desc2, transform2, desc1, transform1, contact)) {
+            return false;
+        }
+        contact->Normal = geom::Scale(contact->Normal, -1.0f);
+        return true;
+    }
+
+    static void Distance(
+        const Desc1& desc1,
+        const FCL_TRANSFORM& transform1,
+        const Desc2& desc2,
+        const FCL_TRANSFORM& transform2,
+        _Out_ PFCL_DISTANCE_RESULT result) noexcept {
+        Forward::Distance(desc2, transform2, desc1, transform1, result);
+        const FCL_VECTOR3 point1 = result->ClosestPoint2;
+        result->ClosestPoint2 = result->ClosestPoint1;
+        result->ClosestPoint1 = point1;
+    }
+};
+
+template <>
+struct PairKernel<FCL_GEOMETRY_OBB, FCL_GEOMETRY_SPHERE>
+    : SwappedPairKernel<FCL_GEOMETRY_OBB, FCL_GEOMETRY_SPHERE> {};
+
+template <>
+struct PairKernel<FCL_GEOMETRY_CAPSULE, FCL_GEOMETRY_SPHERE>
+    : SwappedPairKernel<FCL_GEOMETRY_CAPSULE, FCL_GEOMETRY_SPHERE> {};
+
+template <>
+struct PairKernel<FCL_GEOMETRY_OBB, FCL_GEOMETRY_CAPSULE>
+    : SwappedPairKernel<FCL_GEOMETRY_OBB, FCL_GEOMETRY_CAPSULE> {};
+
+}  // namespace fclmusa::narrowphase
@@ -0,0 +1,72 @@
+﻿#pragma once
+
+#include "fclmusa/platform.h"
+
+#include "fclmusa/collision.h"
+#include "fclmusa/distance.h"
+
+//
+// 窄阶段编译期分派
+// - (形状 A, 形状 B, 查询类型) 三元组在编译期生成 constexpr 内核矩阵
+// - 命中原生内核时直接调用 primitive_kernels.h 中的实现，不构造 fcl::CollisionObject
+// - 未命中的组合回退到 FclUpstreamCollide / FclUpstreamDistance，solver 仅作用于该回退路径
+// 类型擦除仅发生在 C API 边界（FCL_GEOMETRY_SNAPSHOT → 模板参数），可在 DISPATCH_LEVEL 调用。
+//
+
+namespace fclmusa::narrowphase {
+
+enum class QueryKind : ULONG {
+    Intersect = 0,
+    Contact = 1,
+    Distance = 2,
+};
+
+BOOLEAN
+HasNativeKernel(
+    _In_ FCL_GEOMETRY_TYPE type1,
+    _In_ FCL_GEOMETRY_TYPE type2,
+    _In_ QueryKind kind) noexcept;
+
+NTSTATUS
+DispatchCollision(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _Out_ PBOOLEAN isColliding,
+    _Out_opt_ PFCL_CONTACT_INFO contactInfo,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver = nullptr) noexcept;
+
+// 多接触点：原生内核覆盖的组合（含球体）只有单个接触点，其余组合走 upstream 并约简。
+NTSTATUS
+DispatchCollisionManifold(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _In_ ULONG maxContacts,
+    _Out_ PBOOLEAN isColliding,
+    _Out_writes_(maxContacts) PFCL_CONTACT_INFO contacts,
+    _Out_ PULONG contactCount,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver = nullptr) noexcept;
+
+NTSTATUS
+DispatchDistance(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _Out_ PFCL_DISTANCE_RESULT result,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver = nullptr) noexcept;
+
+// 带阈值 / 误差 / 最近点选项的距离查询：先做包围体下界测试，再分派原生内核或 upstream。
+NTSTATUS
+DispatchDistance(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _In_ const FCL_DISTANCE_REQUEST& request,
+    _Out_ PFCL_DISTANCE_QUERY_RESULT result) noexcept;
+
+}  // namespace fclmusa::narrowphase
@@ -0,0 +1,18 @@
+﻿#pragma once
+
+#include "fclmusa/platform.h"
+
+#include "fclmusa/solver.h"
+
+namespace fclmusa::narrowphase {
+
+BOOLEAN
+IsValidSolverOptions(
+    _In_ const FCL_SOLVER_OPTIONS& options) noexcept;
+
+// 合并请求与全局默认：返回值的 Solver 一定为 LIBCCD / INDEP；Tolerance / MaxIterations 为 0 表示使用求解器自身默认。
+FCL_SOLVER_OPTIONS
+ResolveSolverOptions(
+    _In_opt_ const FCL_SOLVER_OPTIONS* requested) noexcept;
+
+}  // namespace fclmusa::narrowphase
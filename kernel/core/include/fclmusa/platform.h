@@ -91,7 +91,30 @@ typedef unsigned char KIRQL;
 #ifndef PASSIVE_LEVEL
 #define PASSIVE_LEVEL 0
 #endif
-inline KIRQL KeGetCurrentIrql() { return PASSIVE_LEVEL; }
+#ifndef APC_LEVEL
+#define APC_LEVEL 1
+#endif
+#ifndef DISPATCH_LEVEL
+#define DISPATCH_LEVEL 2
+#endif
+
+// IRQL is simulated per thread so user-mode tests can exercise the DISPATCH_LEVEL paths
+// (DPC reserve, IRQL checks in the handle APIs). It defaults to PASSIVE_LEVEL.
+// C translation units (libccd through the allocation hooks) only ever see PASSIVE_LEVEL.
+#ifdef __cplusplus
+inline KIRQL& FclUserModeIrql() {
+    static thread_local KIRQL irql = PASSIVE_LEVEL;
+    return irql;
+}
+inline KIRQL KeGetCurrentIrql() { return FclUserModeIrql(); }
+inline VOID KeRaiseIrql(KIRQL newIrql, KIRQL* oldIrql) {
+    *oldIrql = FclUserModeIrql();
+    FclUserModeIrql() = newIrql;
+}
+inline VOID KeLowerIrql(KIRQL newIrql) { FclUserModeIrql() = newIrql; }
+#else
+static inline KIRQL KeGetCurrentIrql(void) { return PASSIVE_LEVEL; }
+#endif
 inline VOID KeEnterCriticalRegion() {}
 inline VOID KeLeaveCriticalRegion() {}
 
@@ -0,0 +1,50 @@
+﻿#pragma once
+
+#include "fclmusa/platform.h"
+
+#include "fclmusa/geometry.h"
+
+EXTERN_C_START
+
+#define FCL_POINT_QUERY_NO_TRIANGLE 0xFFFFFFFFUL
+
+// 计算内外符号：要求 Mesh 封闭且三角形绕序一致（外法线按右手定则朝外）。
+#define FCL_POINT_QUERY_FLAG_SIGNED 0x00000001UL
+
+typedef struct _FCL_POINT_QUERY_RESULT {
+    FCL_VECTOR3 ClosestPoint;     // 世界坐标下 Mesh 表面上的最近点
+    float Distance;               // 到最近点的距离（非负）
+    float SignedDistance;         // 设置 FCL_POINT_QUERY_FLAG_SIGNED 时内部为负，否则等于 Distance
+    ULONG TriangleIndex;          // 最近三角形序号（对应原始索引数组），超出 maxDistance 时为 FCL_POINT_QUERY_NO_TRIANGLE
+    BOOLEAN Inside;               // 仅 FCL_POINT_QUERY_FLAG_SIGNED 时有效
+} FCL_POINT_QUERY_RESULT, *PFCL_POINT_QUERY_RESULT;
+
+//
+// 批量点查询（IRQL == PASSIVE_LEVEL）
+// - 一次获取句柄引用，对所有点执行查询；点在 Mesh 局部坐标下按 BVH 包围体距离下界剪枝
+// - 相邻点的最近三角形作为下一个点的初始上界，空间相干的点序列遍历节点更少
+// - maxDistance > 0 时只搜索该半径内的表面，超出的点返回 FCL_POINT_QUERY_NO_TRIANGLE
+// - 内外判定使用最近特征（面 / 边 / 顶点）的角度加权伪法线；距表面小于 1e-5 倍 Mesh 尺度的点视为在表面上（Inside = FALSE）
+//
+NTSTATUS
+FclMeshPointQuery(
+    _In_ FCL_GEOMETRY_HANDLE mesh,
+    _In_opt_ const FCL_TRANSFORM* transform,
+    _In_reads_(pointCount) const FCL_VECTOR3* points,
+    _In_ ULONG pointCount,
+    _In_ float maxDistance,
+    _In_ ULONG flags,
+    _Out_writes_(pointCount) PFCL_POINT_QUERY_RESULT results) noexcept;
+
+// 内部 Snapshot Core API（IRQL <= DISPATCH_LEVEL）：不执行句柄查找、加锁或内存分配。
+NTSTATUS
+FclMeshPointQueryCoreFromSnapshot(
+    _In_ const FCL_GEOMETRY_SNAPSHOT* mesh,
+    _In_ const FCL_TRANSFORM* transform,
+    _In_reads_(pointCount) const FCL_VECTOR3* points,
+    _In_ ULONG pointCount,
+    _In_ float maxDistance,
+    _In_ ULONG flags,
+    _Out_writes_(pointCount) PFCL_POINT_QUERY_RESULT results) noexcept;
+
+EXTERN_C_END
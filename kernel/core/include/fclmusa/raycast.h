@@ -0,0 +1,72 @@
+﻿#pragma once
+
+#include "fclmusa/platform.h"
+
+#include "fclmusa/broadphase.h"
+#include "fclmusa/geometry.h"
+
+EXTERN_C_START
+
+#define FCL_RAYCAST_NO_HIT 0xFFFFFFFFUL
+#define FCL_RAYCAST_NO_TRIANGLE 0xFFFFFFFFUL
+
+// 任一命中即返回（遮挡 / 可见性判断），命中信息不保证是最近的。
+#define FCL_RAYCAST_FLAG_ANY_HIT 0x00000001UL
+// 包遍历：批量接口中每 8 条连续射线共享一次 BVH 遍历，适合相干射线束（同一相机 / 扫描线）。
+#define FCL_RAYCAST_FLAG_PACKET 0x00000002UL
+
+typedef struct _FCL_RAY {
+    FCL_VECTOR3 Origin;
+    FCL_VECTOR3 Direction;        // 不要求单位化，命中参数 t 以 Direction 的长度为单位
+    float MaxDistance;            // t 的上限，<= 0 表示不限
+} FCL_RAY, *PFCL_RAY;
+
+typedef struct _FCL_RAY_HIT {
+    BOOLEAN Hit;
+    float Distance;               // 命中参数 t：Point = Origin + t * Direction
+    FCL_VECTOR3 Point;
+    FCL_VECTOR3 Normal;           // 世界坐标单位法线；Mesh 为按三角形绕序的几何法线，基本体为外法线
+    ULONG TriangleIndex;          // Mesh 三角形序号（对应原始索引数组）/ 凸包三角化面序号，其余为 FCL_RAYCAST_NO_TRIANGLE
+    float BarycentricU;           // Point = (1 - U - V) * v0 + U * v1 + V * v2
+    float BarycentricV;
+    ULONG ObjectIndex;            // 命中目标在 targets 中的索引，未命中为 FCL_RAYCAST_NO_HIT
+    FCL_GEOMETRY_HANDLE Handle;
+    ULONG ChildIndex;             // 复合体命中的子形状下标，其它类型或未命中为 FCL_COMPOUND_NO_CHILD
+} FCL_RAY_HIT, *PFCL_RAY_HIT;
+
+//
+// 射线查询（IRQL == PASSIVE_LEVEL）
+// - Mesh 在局部坐标下遍历 FCL_BVH_MODEL（OBB 包围体，近子树优先），三角形使用 watertight 相交测试，
+//   共享边 / 顶点上不会漏检；三角形为双面
+// - Sphere / OBB / Capsule / Cylinder 使用解析相交，凸包对三角化面线性求交；起点位于基本体内部时返回出射点
+// - 复合体逐个子形状求交，ChildIndex 报告命中的子形状
+// - Transform 为 NULL 的目标使用单位变换
+//
+NTSTATUS
+FclRaycast(
+    _In_ const FCL_RAY* ray,
+    _In_reads_(targetCount) const FCL_BROADPHASE_OBJECT* targets,
+    _In_ ULONG targetCount,
+    _In_ ULONG flags,
+    _Out_ PFCL_RAY_HIT hit) noexcept;
+
+NTSTATUS
+FclRaycastBatch(
+    _In_reads_(rayCount) const FCL_RAY* rays,
+    _In_ ULONG rayCount,
+    _In_reads_(targetCount) const FCL_BROADPHASE_OBJECT* targets,
+    _In_ ULONG targetCount,
+    _In_ ULONG flags,
+    _Out_writes_(rayCount) PFCL_RAY_HIT hits) noexcept;
+
+// 内部 Snapshot Core API（IRQL <= DISPATCH_LEVEL）：单个对象，不分配内存；ObjectIndex 为 0，Handle 置零。
+NTSTATUS
+FclRaycastCoreFromSnapshot(
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object,
+    _In_ const FCL_TRANSFORM* transform,
+    _In_reads_(rayCount) const FCL_RAY* rays,
+    _In_ ULONG rayCount,
+    _In_ ULONG flags,
+    _Out_writes_(rayCount) PFCL_RAY_HIT hits) noexcept;
+
+EXTERN_C_END
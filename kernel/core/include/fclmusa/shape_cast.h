@@ -0,0 +1,56 @@
+﻿#pragma once
+
+#include "fclmusa/platform.h"
+
+#include "fclmusa/broadphase.h"
+#include "fclmusa/geometry.h"
+
+EXTERN_C_START
+
+#define FCL_SHAPE_CAST_NO_HIT 0xFFFFFFFFUL
+
+typedef struct _FCL_SHAPE_CAST_REQUEST {
+    FCL_GEOMETRY_HANDLE Shape;
+    FCL_TRANSFORM Start;
+    FCL_VECTOR3 Translation;      // 整个扫掠的位移，Fraction 以其为单位
+    float Tolerance;              // 保守推进的收敛距离，<= 0 使用默认值
+    ULONG MaxIterations;          // 保守推进的迭代上限，0 使用默认值
+} FCL_SHAPE_CAST_REQUEST, *PFCL_SHAPE_CAST_REQUEST;
+
+typedef struct _FCL_SHAPE_CAST_RESULT {
+    BOOLEAN Hit;
+    BOOLEAN IterationLimited;     // 命中来自保守推进迭代耗尽：Fraction 之前确认无接触，但该时刻未必真正接触
+    double Fraction;              // 命中时刻（[0,1]），未命中时为 1
+    FCL_VECTOR3 Point;            // 命中点（目标表面，世界坐标）
+    FCL_VECTOR3 Normal;           // 命中点处的法线，由目标指向扫掠形状
+    FCL_GEOMETRY_HANDLE HitHandle;
+    ULONG HitIndex;               // 命中目标在 targets 中的索引，未命中时为 FCL_SHAPE_CAST_NO_HIT
+} FCL_SHAPE_CAST_RESULT, *PFCL_SHAPE_CAST_RESULT;
+
+//
+// 形状扫掠（shape cast）：形状从 Start 沿 Translation 平移，返回最先命中的目标。
+// - 先用扫掠 AABB 与目标 AABB（Mesh 为 BVH 根包围体）求可能接触的时间区间，按进入时刻排序并剪枝
+// - Sphere / OBB 组合走解析 TOI 内核；其余组合做保守推进（Sphere / OBB / Capsule / Cylinder / Convex 之间
+//   按分离方向上的速度分量步进，含 Mesh 时按位移长度步进）
+// - Transform 为 NULL 的目标使用单位变换；需在 PASSIVE_LEVEL 调用
+//
+NTSTATUS
+FclShapeCast(
+    _In_ const FCL_SHAPE_CAST_REQUEST* request,
+    _In_reads_(targetCount) const FCL_BROADPHASE_OBJECT* targets,
+    _In_ ULONG targetCount,
+    _Out_ PFCL_SHAPE_CAST_RESULT result) noexcept;
+
+// 内部 Snapshot Core API（IRQL <= DISPATCH_LEVEL）：单个目标，HitHandle 置零、HitIndex 为 FCL_SHAPE_CAST_NO_HIT。
+NTSTATUS
+FclShapeCastCoreFromSnapshots(
+    _In_ const FCL_GEOMETRY_SNAPSHOT* shape,
+    _In_ const FCL_TRANSFORM* start,
+    _In_ const FCL_VECTOR3* translation,
+    _In_ const FCL_GEOMETRY_SNAPSHOT* target,
+    _In_ const FCL_TRANSFORM* targetTransform,
+    _In_ float tolerance,
+    _In_ ULONG maxIterations,
+    _Out_ PFCL_SHAPE_CAST_RESULT result) noexcept;
+
+EXTERN_C_END
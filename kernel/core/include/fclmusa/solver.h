@@ -0,0 +1,34 @@
+﻿#pragma once
+
+#include "fclmusa/platform.h"
+
+EXTERN_C_START
+
+typedef enum _FCL_GJK_SOLVER_TYPE {
+    FCL_GJK_SOLVER_DEFAULT = 0,   // 使用全局默认（FclSetDefaultSolverOptions）
+    FCL_GJK_SOLVER_LIBCCD = 1,    // fcl::GST_LIBCCD
+    FCL_GJK_SOLVER_INDEP = 2,     // fcl::GST_INDEP（FCL 自带 GJK / EPA 实现）
+} FCL_GJK_SOLVER_TYPE;
+
+typedef struct _FCL_SOLVER_OPTIONS {
+    FCL_GJK_SOLVER_TYPE Solver;
+    double Tolerance;             // <= 0 时沿用全局默认 / 求解器默认
+    ULONG MaxIterations;          // 0 时沿用全局默认 / 求解器默认
+} FCL_SOLVER_OPTIONS, *PFCL_SOLVER_OPTIONS;
+
+//
+// 全局默认求解器选项（驱动 / 进程范围）
+// - 请求中 Solver == FCL_GJK_SOLVER_DEFAULT 或 Tolerance / MaxIterations 未设置时回落到此处
+// - 仅影响走 upstream FCL 的组合；原生解析内核与 MPR 不使用 GJK
+// - CCD 的保守推进只取 Solver；Tolerance / MaxIterations 仅用于 TOI 位姿下补算接触
+// - Set 需在 PASSIVE_LEVEL 调用；读取无锁，可在 DISPATCH_LEVEL 使用
+//
+NTSTATUS
+FclSetDefaultSolverOptions(
+    _In_opt_ const FCL_SOLVER_OPTIONS* options) noexcept;
+
+NTSTATUS
+FclQueryDefaultSolverOptions(
+    _Out_ PFCL_SOLVER_OPTIONS options) noexcept;
+
+EXTERN_C_END
@@ -7,6 +7,11 @@
 
 #include "fclmusa/collision.h"
 #include "fclmusa/distance.h"
+#include "fclmusa/solver.h"
+
+// solver 为 NULL 时使用全局默认求解器（FclSetDefaultSolverOptions）。
+// 每个入口都在 QueryArenaScope 内执行：几何绑定、shared_ptr 控制块与 libccd 临时缓冲从查询 arena 分配，返回时整体复位。
+// 同时处于 CcdObjectPoolScope 内：libccd EPA 多面体的顶点 / 边 / 面从定长对象池分配并在查询内复用（见 libccd_memory.h）。
 
 NTSTATUS
 FclUpstreamCollide(
@@ -15,7 +20,20 @@ FclUpstreamCollide(
     _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
     _In_ const FCL_TRANSFORM& transform2,
     _Out_ PBOOLEAN isColliding,
-    _Out_opt_ PFCL_CONTACT_INFO contactInfo) noexcept;
+    _Out_opt_ PFCL_CONTACT_INFO contactInfo,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver = nullptr) noexcept;
+
+NTSTATUS
+FclUpstreamCollideManifold(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _In_ ULONG maxContacts,
+    _Out_ PBOOLEAN isColliding,
+    _Out_writes_(maxContacts) PFCL_CONTACT_INFO contacts,
+    _Out_ PULONG contactCount,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver = nullptr) noexcept;
 
 NTSTATUS
 FclUpstreamDistance(
@@ -23,7 +41,18 @@ FclUpstreamDistance(
     _In_ const FCL_TRANSFORM& transform1,
     _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
     _In_ const FCL_TRANSFORM& transform2,
-    _Out_ PFCL_DISTANCE_RESULT result) noexcept;
+    _Out_ PFCL_DISTANCE_RESULT result,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver = nullptr) noexcept;
+
+// 阈值作为 fcl::DistanceResult::min_distance 的初始值传入，BVH 遍历据此剪枝；求解器取自 request.Solver。
+NTSTATUS
+FclUpstreamDistanceQuery(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _In_ const FCL_DISTANCE_REQUEST& request,
+    _Out_ PFCL_DISTANCE_QUERY_RESULT result) noexcept;
 
 NTSTATUS
 FclUpstreamContinuousCollision(
@@ -33,4 +62,17 @@ FclUpstreamContinuousCollision(
     _In_ const FCL_INTERP_MOTION& motion2,
     double tolerance,
     ULONG maxIterations,
-    _Out_ PFCL_CONTINUOUS_COLLISION_RESULT result) noexcept;
+    _Out_ PFCL_CONTINUOUS_COLLISION_RESULT result,
+    FCL_GJK_SOLVER_TYPE solver = FCL_GJK_SOLVER_DEFAULT) noexcept;
+
+// CCDM_SCREW 保守推进；转角超过 π/2 时按等角分段（至多 64 段），更大的转角返回 STATUS_NOT_SUPPORTED。
+NTSTATUS
+FclUpstreamScrewContinuousCollision(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_SCREW_MOTION& motion1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_SCREW_MOTION& motion2,
+    double tolerance,
+    ULONG maxIterations,
+    _Out_ PFCL_CONTINUOUS_COLLISION_RESULT result,
+    FCL_GJK_SOLVER_TYPE solver = FCL_GJK_SOLVER_DEFAULT) noexcept;
@@ -10,7 +10,9 @@
 #include <fcl/broadphase/broadphase_dynamic_AABB_tree.h>
 
 #include "fclmusa/broadphase.h"
+#include "fclmusa/diagnostics/workload_recorder.h"
 #include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/memory/alloc_profiler.h"
 
 #include "fclmusa/upstream/geometry_bridge.h"
 
@@ -106,11 +108,7 @@ void ReleaseManagedObjects(std::vector<ManagedObject>& objects) noexcept {
     }
 }
 
-}  // namespace
-
-extern "C"
-NTSTATUS
-FclBroadphaseDetect(
+NTSTATUS DetectPairs(
     _In_reads_(objectCount) const FCL_BROADPHASE_OBJECT* objects,
     _In_ ULONG objectCount,
     _Out_writes_opt_(pairCapacity) PFCL_BROADPHASE_PAIR pairs,
@@ -128,6 +126,7 @@ FclBroadphaseDetect(
     if (KeGetCurrentIrql() != PASSIVE_LEVEL) {
         return STATUS_INVALID_DEVICE_STATE;
     }
+    FCL_ALLOCATION_SITE(FCL_ALLOC_SITE_BROADPHASE);
 
     std::vector<ManagedObject> managedObjects;
     try {
@@ -170,3 +169,24 @@ FclBroadphaseDetect(
     return STATUS_SUCCESS;
 }
 
+}  // namespace
+
+extern "C"
+NTSTATUS
+FclBroadphaseDetect(
+    _In_reads_(objectCount) const FCL_BROADPHASE_OBJECT* objects,
+    _In_ ULONG objectCount,
+    _Out_writes_opt_(pairCapacity) PFCL_BROADPHASE_PAIR pairs,
+    _In_ ULONG pairCapacity,
+    _Out_ PULONG pairCount) noexcept {
+    if (!fclmusa::diagnostics::IsWorkloadRecording() || pairCount == nullptr ||
+        (objects == nullptr && objectCount > 0)) {
+        return DetectPairs(objects, objectCount, pairs, pairCapacity, pairCount);
+    }
+    const ULONGLONG start = fclmusa::diagnostics::WorkloadTimestamp();
+    const NTSTATUS status = DetectPairs(objects, objectCount, pairs, pairCapacity, pairCount);
+    fclmusa::diagnostics::RecordBroadphase(
+        start, objects, objectCount, (pairs != nullptr) ? pairCapacity : 0, *pairCount, status);
+    return status;
+}
+
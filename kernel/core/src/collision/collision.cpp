@@ -1,32 +1,20 @@
 #include "fclmusa/platform.h"
 
 #include "fclmusa/collision.h"
+#include "fclmusa/diagnostics/latency_histogram.h"
+#include "fclmusa/diagnostics/workload_recorder.h"
 #include "fclmusa/driver.h"
 #include "fclmusa/geometry/math_utils.h"
 #include "fclmusa/logging.h"
-#include "fclmusa/upstream/upstream_bridge.h"
+#include "fclmusa/narrowphase/coherence_cache.h"
+#include "fclmusa/narrowphase/compound_dispatch.h"
+#include "fclmusa/narrowphase/query_dispatch.h"
+#include "fclmusa/narrowphase/solver_options.h"
 
 namespace {
 
 using namespace fclmusa::geom;
 
-ULONGLONG QueryTimeMicroseconds() noexcept {
-    LARGE_INTEGER frequency = {};
-    const LARGE_INTEGER counter = KeQueryPerformanceCounter(&frequency);
-    if (frequency.QuadPart == 0) {
-        return 0;
-    }
-    const LONGLONG ticks = counter.QuadPart;
-    const ULONGLONG absoluteTicks = (ticks >= 0)
-        ? static_cast<ULONGLONG>(ticks)
-        : static_cast<ULONGLONG>(-ticks);
-    return (absoluteTicks * 1'000'000ULL) / static_cast<ULONGLONG>(frequency.QuadPart);
-}
-
-ULONGLONG AbsoluteDifference(ULONGLONG a, ULONGLONG b) noexcept {
-    return (a > b) ? (a - b) : (b - a);
-}
-
 struct CollisionObject {
     FCL_GEOMETRY_REFERENCE Reference = {};
     FCL_GEOMETRY_SNAPSHOT Snapshot = {};
@@ -56,58 +44,91 @@ NTSTATUS InitializeCollisionObject(
     return FclAcquireGeometryReference(handle, &object->Reference, &object->Snapshot);
 }
 
-}  // namespace
-
-extern "C"
-NTSTATUS
-FclCollisionCoreFromSnapshots(
+// contactInfo 为容量 maxContacts 的数组；maxContacts > 1 时走多接触点分派并通过 contactCount 返回数量。
+NTSTATUS RunCollisionCore(
+    _In_opt_ const fclmusa::narrowphase::CoherenceKey* cacheKey,
     _In_ const FCL_GEOMETRY_SNAPSHOT* object1,
     _In_ const FCL_TRANSFORM* transform1,
     _In_ const FCL_GEOMETRY_SNAPSHOT* object2,
     _In_ const FCL_TRANSFORM* transform2,
     _Out_ PBOOLEAN isColliding,
-    _Out_opt_ PFCL_CONTACT_INFO contactInfo) noexcept {
+    _Out_writes_opt_(maxContacts) PFCL_CONTACT_INFO contactInfo,
+    _In_ ULONG maxContacts = 1,
+    _Out_opt_ PULONG contactCount = nullptr,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver = nullptr) noexcept {
     if (isColliding == nullptr || object1 == nullptr || object2 == nullptr || transform1 == nullptr || transform2 == nullptr) {
         return STATUS_INVALID_PARAMETER;
     }
 
     *isColliding = FALSE;
+    if (contactCount != nullptr) {
+        *contactCount = 0;
+    }
     if (contactInfo != nullptr) {
         RtlZeroMemory(contactInfo, sizeof(*contactInfo));
     }
 
-    const ULONGLONG start = QueryTimeMicroseconds();
-    NTSTATUS status = FclUpstreamCollide(
-        *object1,
-        *transform1,
-        *object2,
-        *transform2,
-        isColliding,
-        contactInfo);
-    const ULONGLONG end = QueryTimeMicroseconds();
-
-    if (NT_SUCCESS(status) && start != 0 && end != 0) {
-        const ULONGLONG elapsed = AbsoluteDifference(end, start);
-        if (elapsed != 0) {
-            FclDiagnosticsRecordCollisionDuration(elapsed);
-            if (KeGetCurrentIrql() == DISPATCH_LEVEL) {
-                FclDiagnosticsRecordDpcCollisionDuration(elapsed);
+    const fclmusa::diagnostics::LatencyStopwatch stopwatch;
+    NTSTATUS status = STATUS_SUCCESS;
+    // 缓存的分离轴仍然分离两物体时结果确定为未碰撞，无需进入窄阶段。
+    const bool cachedSeparated = cacheKey != nullptr &&
+        fclmusa::narrowphase::CoherenceCacheTryConfirmSeparated(
+            *cacheKey, *object1, *transform1, *object2, *transform2, nullptr);
+    if (!cachedSeparated) {
+        if (contactInfo != nullptr && maxContacts > 1) {
+            ULONG written = 0;
+            status = fclmusa::narrowphase::DispatchCollisionManifold(
+                *object1,
+                *transform1,
+                *object2,
+                *transform2,
+                maxContacts,
+                isColliding,
+                contactInfo,
+                &written,
+                solver);
+            if (contactCount != nullptr) {
+                *contactCount = written;
             }
+        } else {
+            status = fclmusa::narrowphase::DispatchCollision(
+                *object1,
+                *transform1,
+                *object2,
+                *transform2,
+                isColliding,
+                contactInfo,
+                solver);
+            if (NT_SUCCESS(status) && contactCount != nullptr) {
+                *contactCount = (*isColliding && contactInfo != nullptr) ? 1 : 0;
+            }
+        }
+        if (NT_SUCCESS(status) && cacheKey != nullptr) {
+            fclmusa::narrowphase::CoherenceCacheRecordCollision(
+                *cacheKey, *object1, *transform1, *object2, *transform2, *isColliding);
+        }
+    }
+    if (NT_SUCCESS(status)) {
+        const ULONGLONG elapsed = stopwatch.ElapsedNanoseconds();
+        FclDiagnosticsRecordCollisionDuration(object1->Type, object2->Type, elapsed);
+        if (KeGetCurrentIrql() == DISPATCH_LEVEL) {
+            FclDiagnosticsRecordDpcCollisionDuration(object1->Type, object2->Type, elapsed);
         }
     }
 
     return status;
 }
 
-extern "C"
-NTSTATUS
-FclCollisionDetect(
-    _In_ FCL_GEOMETRY_HANDLE object1,
+NTSTATUS CollideHandles(
+    FCL_GEOMETRY_HANDLE object1,
     _In_opt_ const FCL_TRANSFORM* transform1,
-    _In_ FCL_GEOMETRY_HANDLE object2,
+    FCL_GEOMETRY_HANDLE object2,
     _In_opt_ const FCL_TRANSFORM* transform2,
     _Out_ PBOOLEAN isColliding,
-    _Out_opt_ PFCL_CONTACT_INFO contactInfo) noexcept {
+    _Out_writes_opt_(maxContacts) PFCL_CONTACT_INFO contactInfo,
+    ULONG maxContacts,
+    _Out_opt_ PULONG contactCount,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver = nullptr) noexcept {
     if (isColliding == nullptr) {
         return STATUS_INVALID_PARAMETER;
     }
@@ -128,18 +149,136 @@ FclCollisionDetect(
         return status;
     }
 
-    return FclCollisionCoreFromSnapshots(
+    const fclmusa::narrowphase::CoherenceKey key = {object1.Value, object2.Value};
+    return RunCollisionCore(
+        &key,
         &objectA.Snapshot,
         &objectA.Transform,
         &objectB.Snapshot,
         &objectB.Transform,
         isColliding,
-        contactInfo);
+        contactInfo,
+        maxContacts,
+        contactCount,
+        solver);
 }
 
+}  // namespace
+
 extern "C"
 NTSTATUS
-FclCollideObjects(
+FclCollisionCoreFromSnapshots(
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object1,
+    _In_ const FCL_TRANSFORM* transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object2,
+    _In_ const FCL_TRANSFORM* transform2,
+    _Out_ PBOOLEAN isColliding,
+    _Out_opt_ PFCL_CONTACT_INFO contactInfo) noexcept {
+    return RunCollisionCore(nullptr, object1, transform1, object2, transform2, isColliding, contactInfo);
+}
+
+extern "C"
+NTSTATUS
+FclCollisionCoreFromSnapshotsCoherent(
+    _In_ FCL_GEOMETRY_HANDLE handle1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object1,
+    _In_ const FCL_TRANSFORM* transform1,
+    _In_ FCL_GEOMETRY_HANDLE handle2,
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object2,
+    _In_ const FCL_TRANSFORM* transform2,
+    _Out_ PBOOLEAN isColliding,
+    _Out_opt_ PFCL_CONTACT_INFO contactInfo) noexcept {
+    const fclmusa::narrowphase::CoherenceKey key = {handle1.Value, handle2.Value};
+    return RunCollisionCore(&key, object1, transform1, object2, transform2, isColliding, contactInfo);
+}
+
+extern "C"
+NTSTATUS
+FclCollisionManifoldCoreFromSnapshots(
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object1,
+    _In_ const FCL_TRANSFORM* transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object2,
+    _In_ const FCL_TRANSFORM* transform2,
+    _In_ ULONG maxContacts,
+    _Out_ PBOOLEAN isColliding,
+    _Out_writes_(maxContacts) PFCL_CONTACT_INFO contacts,
+    _Out_ PULONG contactCount) noexcept {
+    if (contacts == nullptr || contactCount == nullptr || maxContacts == 0) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    return RunCollisionCore(
+        nullptr, object1, transform1, object2, transform2, isColliding, contacts, maxContacts, contactCount);
+}
+
+extern "C"
+NTSTATUS
+FclCollisionDetect(
+    _In_ FCL_GEOMETRY_HANDLE object1,
+    _In_opt_ const FCL_TRANSFORM* transform1,
+    _In_ FCL_GEOMETRY_HANDLE object2,
+    _In_opt_ const FCL_TRANSFORM* transform2,
+    _Out_ PBOOLEAN isColliding,
+    _Out_opt_ PFCL_CONTACT_INFO contactInfo) noexcept {
+    if (!fclmusa::diagnostics::IsWorkloadRecording()) {
+        return CollideHandles(object1, transform1, object2, transform2, isColliding, contactInfo, 1, nullptr);
+    }
+    const ULONGLONG start = fclmusa::diagnostics::WorkloadTimestamp();
+    const NTSTATUS status =
+        CollideHandles(object1, transform1, object2, transform2, isColliding, contactInfo, 1, nullptr);
+    fclmusa::diagnostics::RecordCollision(start,
+        object1,
+        transform1,
+        object2,
+        transform2,
+        (NT_SUCCESS(status) && isColliding != nullptr) ? *isColliding : FALSE,
+        status);
+    return status;
+}
+
+namespace {
+
+NTSTATUS CompoundCollideHandles(
+    _In_ FCL_GEOMETRY_HANDLE object1,
+    _In_opt_ const FCL_TRANSFORM* transform1,
+    _In_ FCL_GEOMETRY_HANDLE object2,
+    _In_opt_ const FCL_TRANSFORM* transform2,
+    _Out_ PBOOLEAN isColliding,
+    _Out_opt_ PFCL_CONTACT_INFO contactInfo,
+    _Out_ PFCL_COMPOUND_CHILD_PAIR children) noexcept {
+    if (isColliding == nullptr || children == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    children->Child1 = FCL_COMPOUND_NO_CHILD;
+    children->Child2 = FCL_COMPOUND_NO_CHILD;
+
+    if (KeGetCurrentIrql() != PASSIVE_LEVEL) {
+        return STATUS_INVALID_DEVICE_STATE;
+    }
+
+    CollisionObject objectA;
+    NTSTATUS status = InitializeCollisionObject(object1, transform1, &objectA);
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+
+    CollisionObject objectB;
+    status = InitializeCollisionObject(object2, transform2, &objectB);
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+
+    return fclmusa::narrowphase::CompoundCollide(
+        objectA.Snapshot,
+        objectA.Transform,
+        objectB.Snapshot,
+        objectB.Transform,
+        isColliding,
+        contactInfo,
+        nullptr,
+        children);
+}
+
+NTSTATUS CollideObjects(
     _In_ const FCL_COLLISION_OBJECT_DESC* object1,
     _In_ const FCL_COLLISION_OBJECT_DESC* object2,
     _In_opt_ const FCL_COLLISION_QUERY_REQUEST* request,
@@ -154,28 +293,87 @@ FclCollideObjects(
         localRequest.EnableContactInfo = TRUE;
         request = &localRequest;
     }
+    if (!fclmusa::narrowphase::IsValidSolverOptions(request->Solver)) {
+        return STATUS_INVALID_PARAMETER;
+    }
 
+    // 未提供接触数组时退化为单接触点，结果只写入 result->Contact。
     BOOLEAN isColliding = FALSE;
     FCL_CONTACT_INFO contact = {};
-    PFCL_CONTACT_INFO contactPtr = request->EnableContactInfo ? &contact : nullptr;
+    PFCL_CONTACT_INFO contacts = nullptr;
+    ULONG capacity = 1;
+    if (request->EnableContactInfo) {
+        const bool useArray = request->Contacts != nullptr && request->MaxContacts > 0;
+        contacts = useArray ? request->Contacts : &contact;
+        capacity = useArray ? request->MaxContacts : 1;
+    }
 
-    NTSTATUS status = FclCollisionDetect(
+    ULONG contactCount = 0;
+    NTSTATUS status = CollideHandles(
         object1->Geometry,
         &object1->Transform,
         object2->Geometry,
         &object2->Transform,
         &isColliding,
-        contactPtr);
+        contacts,
+        capacity,
+        &contactCount,
+        &request->Solver);
     if (!NT_SUCCESS(status)) {
         return status;
     }
 
     result->Intersecting = isColliding;
-    result->ContactCount = (isColliding && contactPtr != nullptr) ? 1 : 0;
-    if (result->ContactCount == 1) {
-        result->Contact = contact;
+    result->ContactCount = contactCount;
+    if (contactCount > 0) {
+        result->Contact = contacts[0];
     } else {
         RtlZeroMemory(&result->Contact, sizeof(result->Contact));
     }
     return STATUS_SUCCESS;
 }
+
+}  // namespace
+
+extern "C"
+NTSTATUS
+FclCompoundCollisionDetect(
+    _In_ FCL_GEOMETRY_HANDLE object1,
+    _In_opt_ const FCL_TRANSFORM* transform1,
+    _In_ FCL_GEOMETRY_HANDLE object2,
+    _In_opt_ const FCL_TRANSFORM* transform2,
+    _Out_ PBOOLEAN isColliding,
+    _Out_opt_ PFCL_CONTACT_INFO contactInfo,
+    _Out_ PFCL_COMPOUND_CHILD_PAIR children) noexcept {
+    if (!fclmusa::diagnostics::IsWorkloadRecording()) {
+        return CompoundCollideHandles(object1, transform1, object2, transform2, isColliding, contactInfo, children);
+    }
+    const ULONGLONG start = fclmusa::diagnostics::WorkloadTimestamp();
+    const NTSTATUS status =
+        CompoundCollideHandles(object1, transform1, object2, transform2, isColliding, contactInfo, children);
+    fclmusa::diagnostics::RecordCompoundCollision(start,
+        object1,
+        transform1,
+        object2,
+        transform2,
+        (NT_SUCCESS(status) && isColliding != nullptr) ? *isColliding : FALSE,
+        status);
+    return status;
+}
+
+extern "C"
+NTSTATUS
+FclCollideObjects(
+    _In_ const FCL_COLLISION_OBJECT_DESC* object1,
+    _In_ const FCL_COLLISION_OBJECT_DESC* object2,
+    _In_opt_ const FCL_COLLISION_QUERY_REQUEST* request,
+    _Out_ PFCL_COLLISION_QUERY_RESULT result) noexcept {
+    if (!fclmusa::diagnostics::IsWorkloadRecording() || object1 == nullptr || object2 == nullptr ||
+        result == nullptr) {
+        return CollideObjects(object1, object2, request, result);
+    }
+    const ULONGLONG start = fclmusa::diagnostics::WorkloadTimestamp();
+    const NTSTATUS status = CollideObjects(object1, object2, request, result);
+    fclmusa::diagnostics::RecordCollideObjects(start, object1, object2, request, result, status);
+    return status;
+}
@@ -1,8 +1,18 @@
 #include "fclmusa/platform.h"
 
+#include <algorithm>
+#include <new>
+#include <vector>
+
 #include "fclmusa/collision.h"
+#include "fclmusa/diagnostics/latency_histogram.h"
+#include "fclmusa/diagnostics/workload_recorder.h"
 #include "fclmusa/driver.h"
 #include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/narrowphase/analytic_ccd.h"
+#include "fclmusa/narrowphase/coherence_cache.h"
+#include "fclmusa/narrowphase/query_dispatch.h"
+#include "fclmusa/narrowphase/solver_options.h"
 #include "fclmusa/upstream/upstream_bridge.h"
 
 namespace {
@@ -11,6 +21,9 @@ using namespace fclmusa::geom;
 
 constexpr double kDefaultTolerance = 1e-4;
 constexpr ULONG kDefaultIterations = 64;
+constexpr float kScrewAngleEpsilon = 1e-6f;
+constexpr float kScrewAxisTolerance = 1e-3f;
+constexpr LONG kParallelPairThreshold = 16;
 
 double Clamp01(double value) noexcept {
     if (value < 0.0) {
@@ -43,63 +56,440 @@ NTSTATUS InitializeMotionObject(
     return FclAcquireGeometryReference(handle, &object->Reference, &object->Snapshot);
 }
 
-ULONGLONG QueryTimeMicroseconds() noexcept {
-    LARGE_INTEGER frequency = {};
-    const LARGE_INTEGER counter = KeQueryPerformanceCounter(&frequency);
-    if (frequency.QuadPart == 0) {
-        return 0;
+// upstream CCD 只给出 TOI 时刻的位姿；在该位姿下补算接触点与法线（对象 1 指向对象 2），与解析路径一致。
+// 先取最近点连线（保守推进停在容差之内，通常仍有正距离），已接触 / 穿透时改用碰撞查询的接触；都得不到时法线为零。
+void ResolveContactAtImpact(
+    const FCL_GEOMETRY_SNAPSHOT& object1,
+    const FCL_TRANSFORM& pose1,
+    const FCL_GEOMETRY_SNAPSHOT& object2,
+    const FCL_TRANSFORM& pose2,
+    const FCL_SOLVER_OPTIONS& solver,
+    _Inout_ PFCL_CONTINUOUS_COLLISION_RESULT result) noexcept {
+    RtlZeroMemory(&result->Contact, sizeof(result->Contact));
+
+    FCL_DISTANCE_RESULT distance = {};
+    if (NT_SUCCESS(fclmusa::narrowphase::DispatchDistance(object1, pose1, object2, pose2, &distance, &solver)) &&
+        distance.Distance > 0.0f) {
+        const FCL_VECTOR3 gap = Subtract(distance.ClosestPoint2, distance.ClosestPoint1);
+        if (Length(gap) > kSingularityEpsilon) {
+            result->Contact.Normal = Normalize(gap);
+            result->Contact.PointOnObject1 = distance.ClosestPoint1;
+            result->Contact.PointOnObject2 = distance.ClosestPoint2;
+            return;
+        }
     }
-    const LONGLONG ticks = counter.QuadPart;
-    const ULONGLONG absoluteTicks = (ticks >= 0)
-        ? static_cast<ULONGLONG>(ticks)
-        : static_cast<ULONGLONG>(-ticks);
-    return (absoluteTicks * 1'000'000ULL) / static_cast<ULONGLONG>(frequency.QuadPart);
-}
 
-ULONGLONG AbsoluteDifference(ULONGLONG a, ULONGLONG b) noexcept {
-    return (a > b) ? (a - b) : (b - a);
+    BOOLEAN colliding = FALSE;
+    FCL_CONTACT_INFO contact = {};
+    if (NT_SUCCESS(fclmusa::narrowphase::DispatchCollision(object1, pose1, object2, pose2, &colliding, &contact, &solver)) &&
+        colliding) {
+        result->Contact = contact;
+    }
 }
 
-}  // namespace
-
-extern "C"
-NTSTATUS
-FclContinuousCollisionCoreFromSnapshots(
+NTSTATUS RunContinuousCollisionCore(
     _In_ const FCL_GEOMETRY_SNAPSHOT* object1,
     _In_ const FCL_INTERP_MOTION* motion1,
     _In_ const FCL_GEOMETRY_SNAPSHOT* object2,
     _In_ const FCL_INTERP_MOTION* motion2,
     _In_ double tolerance,
     _In_ ULONG maxIterations,
+    _In_ FCL_GJK_SOLVER_TYPE solver,
     _Out_ PFCL_CONTINUOUS_COLLISION_RESULT result) noexcept {
     if (object1 == nullptr || object2 == nullptr || motion1 == nullptr || motion2 == nullptr || result == nullptr) {
         return STATUS_INVALID_PARAMETER;
     }
 
+    FCL_SOLVER_OPTIONS solverOptions = {};
+    solverOptions.Solver = solver;
+    if (!fclmusa::narrowphase::IsValidSolverOptions(solverOptions)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
     const double resolvedTolerance = (tolerance > 0.0) ? tolerance : kDefaultTolerance;
     const ULONG resolvedIterations = (maxIterations > 0) ? maxIterations : kDefaultIterations;
 
-    const ULONGLONG start = QueryTimeMicroseconds();
-    NTSTATUS status = FclUpstreamContinuousCollision(
-        *object1,
-        *motion1,
-        *object2,
-        *motion2,
-        resolvedTolerance,
-        resolvedIterations,
-        result);
-    const ULONGLONG end = QueryTimeMicroseconds();
+    const fclmusa::diagnostics::LatencyStopwatch stopwatch;
+    // 平移运动下的基本体组合有闭式 TOI，只有涉及旋转时才进入保守推进。
+    NTSTATUS status = STATUS_SUCCESS;
+    if (!fclmusa::narrowphase::TryAnalyticContinuousCollision(*object1, *motion1, *object2, *motion2, result)) {
+        status = FclUpstreamContinuousCollision(
+            *object1,
+            *motion1,
+            *object2,
+            *motion2,
+            resolvedTolerance,
+            resolvedIterations,
+            result,
+            solver);
+        if (NT_SUCCESS(status) && result->Intersecting) {
+            FCL_TRANSFORM pose1 = {};
+            FCL_TRANSFORM pose2 = {};
+            FclInterpMotionEvaluate(motion1, result->TimeOfImpact, &pose1);
+            FclInterpMotionEvaluate(motion2, result->TimeOfImpact, &pose2);
+            ResolveContactAtImpact(*object1, pose1, *object2, pose2, solverOptions, result);
+        }
+    }
+    if (NT_SUCCESS(status)) {
+        FclDiagnosticsRecordContinuousCollisionDuration(object1->Type, object2->Type, stopwatch.ElapsedNanoseconds());
+    }
+
+    return status;
+}
+
+bool IsValidScrewMotion(const FCL_SCREW_MOTION& motion) noexcept {
+    if (!IsValidTransform(motion.Start) ||
+        !IsValidVector(motion.Axis) ||
+        !IsValidVector(motion.OrthogonalTranslation) ||
+        !IsFiniteFloat(motion.AngularVelocity) ||
+        !IsFiniteFloat(motion.LinearVelocity)) {
+        return false;
+    }
+    if (motion.AngularVelocity == 0.0f && motion.LinearVelocity == 0.0f) {
+        return true;
+    }
+    return fabs(Length(motion.Axis) - 1.0f) <= kScrewAxisTolerance;
+}
 
-    if (NT_SUCCESS(status) && start != 0 && end != 0) {
-        const ULONGLONG elapsed = AbsoluteDifference(end, start);
-        if (elapsed != 0) {
-            FclDiagnosticsRecordContinuousCollisionDuration(elapsed);
+// 轴线上垂直于轴的点 p：满足 (I - R(θ)) p = u，闭式解 p = (u + cot(θ/2) · axis × u) / 2。
+FCL_VECTOR3 ScrewAxisPoint(const FCL_SCREW_MOTION& motion) noexcept {
+    const double halfAngle = 0.5 * motion.AngularVelocity;
+    const float cotHalf = static_cast<float>(cos(halfAngle) / sin(halfAngle));
+    const FCL_VECTOR3& u = motion.OrthogonalTranslation;
+    return Scale(Add(u, Scale(Cross(motion.Axis, u), cotHalf)), 0.5f);
+}
+
+// 几何局部坐标系下的包围球（由三轴投影区间得到的 AABB 外接球）。
+bool LocalBoundingSphere(const FCL_GEOMETRY_SNAPSHOT& object, _Out_ FCL_VECTOR3* center, _Out_ float* radius) noexcept {
+    const FCL_TRANSFORM identity = IdentityTransform();
+    const FCL_VECTOR3 axes[3] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+    FCL_VECTOR3 minimum = {};
+    FCL_VECTOR3 maximum = {};
+    for (int axis = 0; axis < 3; ++axis) {
+        if (!fclmusa::narrowphase::ProjectSnapshotOntoAxis(object, identity, axes[axis], &(&minimum.X)[axis], &(&maximum.X)[axis])) {
+            return false;
         }
     }
+    *center = Scale(Add(minimum, maximum), 0.5f);
+    *radius = 0.5f * Length(Subtract(maximum, minimum));
+    return true;
+}
+
+// 螺旋运动下包围球能够到达的范围：轴向平移 + 弦长（不超过 min(|θ|, 2) 乘以到轴距离）。
+float SweptReach(const FCL_SCREW_MOTION& motion, const FCL_VECTOR3& worldCenter, float radius) noexcept {
+    if (fabs(motion.AngularVelocity) <= kScrewAngleEpsilon) {
+        return radius + Length(Add(Scale(motion.Axis, motion.LinearVelocity), motion.OrthogonalTranslation));
+    }
+    const FCL_VECTOR3 offset = Subtract(worldCenter, ScrewAxisPoint(motion));
+    const FCL_VECTOR3 radial = Subtract(offset, Scale(motion.Axis, Dot(offset, motion.Axis)));
+    const float angle = static_cast<float>(fabs(motion.AngularVelocity));
+    const float chordScale = (angle < 2.0f) ? angle : 2.0f;
+    return radius + static_cast<float>(fabs(motion.LinearVelocity)) + chordScale * (Length(radial) + radius);
+}
+
+// 两物体扫掠包围球不相交时整个区间内不可能碰撞；包围球不可得时保守地返回 TRUE。
+bool SweptBoundsMayOverlap(
+    const FCL_GEOMETRY_SNAPSHOT& object1,
+    const FCL_SCREW_MOTION& motion1,
+    const FCL_GEOMETRY_SNAPSHOT& object2,
+    const FCL_SCREW_MOTION& motion2) noexcept {
+    FCL_VECTOR3 center1 = {};
+    FCL_VECTOR3 center2 = {};
+    float radius1 = 0.0f;
+    float radius2 = 0.0f;
+    if (!LocalBoundingSphere(object1, &center1, &radius1) || !LocalBoundingSphere(object2, &center2, &radius2)) {
+        return true;
+    }
+    const FCL_VECTOR3 world1 = TransformPoint(motion1.Start, center1);
+    const FCL_VECTOR3 world2 = TransformPoint(motion2.Start, center2);
+    const float reach = SweptReach(motion1, world1, radius1) + SweptReach(motion2, world2, radius2);
+    return Length(Subtract(world2, world1)) <= reach;
+}
+
+NTSTATUS RunScrewContinuousCollisionCore(
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object1,
+    _In_ const FCL_SCREW_MOTION* motion1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object2,
+    _In_ const FCL_SCREW_MOTION* motion2,
+    _In_ double tolerance,
+    _In_ ULONG maxIterations,
+    _In_ FCL_GJK_SOLVER_TYPE solver,
+    _Out_ PFCL_CONTINUOUS_COLLISION_RESULT result) noexcept {
+    if (object1 == nullptr || object2 == nullptr || motion1 == nullptr || motion2 == nullptr || result == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    if (!IsValidScrewMotion(*motion1) || !IsValidScrewMotion(*motion2)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    FCL_SOLVER_OPTIONS solverOptions = {};
+    solverOptions.Solver = solver;
+    if (!fclmusa::narrowphase::IsValidSolverOptions(solverOptions)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    const double resolvedTolerance = (tolerance > 0.0) ? tolerance : kDefaultTolerance;
+    const ULONG resolvedIterations = (maxIterations > 0) ? maxIterations : kDefaultIterations;
+
+    const fclmusa::diagnostics::LatencyStopwatch stopwatch;
+    NTSTATUS status = STATUS_SUCCESS;
+    if (SweptBoundsMayOverlap(*object1, *motion1, *object2, *motion2)) {
+        status = FclUpstreamScrewContinuousCollision(
+            *object1,
+            *motion1,
+            *object2,
+            *motion2,
+            resolvedTolerance,
+            resolvedIterations,
+            result,
+            solver);
+        if (NT_SUCCESS(status) && result->Intersecting) {
+            FCL_TRANSFORM pose1 = {};
+            FCL_TRANSFORM pose2 = {};
+            FclScrewMotionEvaluate(motion1, result->TimeOfImpact, &pose1);
+            FclScrewMotionEvaluate(motion2, result->TimeOfImpact, &pose2);
+            ResolveContactAtImpact(*object1, pose1, *object2, pose2, solverOptions, result);
+        }
+    } else {
+        RtlZeroMemory(result, sizeof(*result));
+        result->TimeOfImpact = 1.0;
+    }
+    if (NT_SUCCESS(status)) {
+        FclDiagnosticsRecordContinuousCollisionDuration(object1->Type, object2->Type, stopwatch.ElapsedNanoseconds());
+    }
 
     return status;
 }
 
+struct BatchEntry {
+    FCL_GEOMETRY_REFERENCE Reference = {};
+    FCL_GEOMETRY_SNAPSHOT Snapshot = {};
+    FCL_VECTOR3 SweptMin = {};
+    FCL_VECTOR3 SweptMax = {};
+};
+
+struct BatchPair {
+    ULONG First = 0;
+    ULONG Second = 0;
+    NTSTATUS Status = STATUS_SUCCESS;
+    FCL_CONTINUOUS_COLLISION_RESULT Result = {};
+};
+
+struct BatchContext {
+    const FCL_CONTINUOUS_BATCH_QUERY* Query;
+    const BatchEntry* Entries;
+    BatchPair* Pairs;
+    LONG PairCount;
+    volatile LONG NextPair;
+};
+
+void ReleaseBatchEntries(std::vector<BatchEntry>& entries) noexcept {
+    for (auto& entry : entries) {
+        FclReleaseGeometryReference(&entry.Reference);
+    }
+}
+
+// 与 geometry_bridge 中 LocalTransform 的平移一致：基本体为中心，Mesh / 凸包为原点。
+FCL_VECTOR3 GeometryReferencePoint(const FCL_GEOMETRY_SNAPSHOT& snapshot) noexcept {
+    switch (snapshot.Type) {
+    case FCL_GEOMETRY_SPHERE:
+        return snapshot.Data.Sphere.Center;
+    case FCL_GEOMETRY_OBB:
+        return snapshot.Data.Obb.Center;
+    case FCL_GEOMETRY_CAPSULE:
+        return snapshot.Data.Capsule.Center;
+    case FCL_GEOMETRY_CYLINDER:
+        return snapshot.Data.Cylinder.Center;
+    default:
+        return {0.0f, 0.0f, 0.0f};
+    }
+}
+
+bool WorldAabb(
+    const FCL_GEOMETRY_SNAPSHOT& snapshot,
+    const FCL_TRANSFORM& transform,
+    _Out_ FCL_VECTOR3* minimum,
+    _Out_ FCL_VECTOR3* maximum) noexcept {
+    const FCL_VECTOR3 axes[3] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+    for (int axis = 0; axis < 3; ++axis) {
+        if (!fclmusa::narrowphase::ProjectSnapshotOntoAxis(snapshot, transform, axes[axis], &(&minimum->X)[axis], &(&maximum->X)[axis])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SameRotation(const FCL_MATRIX3X3& lhs, const FCL_MATRIX3X3& rhs) noexcept {
+    for (int row = 0; row < 3; ++row) {
+        for (int column = 0; column < 3; ++column) {
+            if (lhs.M[row][column] != rhs.M[row][column]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// 纯平移时扫掠 AABB 即起止 AABB 的并集；有旋转时几何上任一点到参考点的距离不变而参考点沿直线运动，
+// 取以参考点轨迹为轴的胶囊体包围盒。
+bool BuildSweptAabb(const FCL_INTERP_MOTION& motion, _Inout_ BatchEntry* entry) noexcept {
+    FCL_VECTOR3 startMin = {};
+    FCL_VECTOR3 startMax = {};
+    FCL_VECTOR3 endMin = {};
+    FCL_VECTOR3 endMax = {};
+    if (SameRotation(motion.Start.Rotation, motion.End.Rotation)) {
+        if (!WorldAabb(entry->Snapshot, motion.Start, &startMin, &startMax) ||
+            !WorldAabb(entry->Snapshot, motion.End, &endMin, &endMax)) {
+            return false;
+        }
+        entry->SweptMin = {std::min(startMin.X, endMin.X), std::min(startMin.Y, endMin.Y), std::min(startMin.Z, endMin.Z)};
+        entry->SweptMax = {std::max(startMax.X, endMax.X), std::max(startMax.Y, endMax.Y), std::max(startMax.Z, endMax.Z)};
+        return true;
+    }
+
+    FCL_VECTOR3 center = {};
+    float radius = 0.0f;
+    if (!LocalBoundingSphere(entry->Snapshot, &center, &radius)) {
+        return false;
+    }
+    const FCL_VECTOR3 reference = GeometryReferencePoint(entry->Snapshot);
+    const float reach = Length(Subtract(center, reference)) + radius;
+    const FCL_VECTOR3 from = TransformPoint(motion.Start, reference);
+    const FCL_VECTOR3 to = TransformPoint(motion.End, reference);
+    entry->SweptMin = {std::min(from.X, to.X) - reach, std::min(from.Y, to.Y) - reach, std::min(from.Z, to.Z) - reach};
+    entry->SweptMax = {std::max(from.X, to.X) + reach, std::max(from.Y, to.Y) + reach, std::max(from.Z, to.Z) + reach};
+    return true;
+}
+
+// 排序扫描：按扫掠 AABB 的 X 下界排序后只比较 X 区间重叠的对象，候选对按索引排序以保证结果确定。
+NTSTATUS CollectCandidatePairs(const std::vector<BatchEntry>& entries, _Inout_ std::vector<BatchPair>* pairs) noexcept {
+    try {
+        std::vector<ULONG> order(entries.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = static_cast<ULONG>(i);
+        }
+        std::sort(order.begin(), order.end(), [&entries](ULONG lhs, ULONG rhs) {
+            return entries[lhs].SweptMin.X < entries[rhs].SweptMin.X;
+        });
+
+        for (size_t i = 0; i < order.size(); ++i) {
+            const BatchEntry& lhs = entries[order[i]];
+            for (size_t j = i + 1; j < order.size(); ++j) {
+                const BatchEntry& rhs = entries[order[j]];
+                if (rhs.SweptMin.X > lhs.SweptMax.X) {
+                    break;
+                }
+                if (rhs.SweptMin.Y > lhs.SweptMax.Y || lhs.SweptMin.Y > rhs.SweptMax.Y ||
+                    rhs.SweptMin.Z > lhs.SweptMax.Z || lhs.SweptMin.Z > rhs.SweptMax.Z) {
+                    continue;
+                }
+                BatchPair pair = {};
+                pair.First = std::min(order[i], order[j]);
+                pair.Second = std::max(order[i], order[j]);
+                pairs->push_back(pair);
+            }
+        }
+
+        std::sort(pairs->begin(), pairs->end(), [](const BatchPair& lhs, const BatchPair& rhs) {
+            return (lhs.First != rhs.First) ? (lhs.First < rhs.First) : (lhs.Second < rhs.Second);
+        });
+    } catch (const std::bad_alloc&) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    if (pairs->size() > static_cast<size_t>(MAXLONG)) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+    return STATUS_SUCCESS;
+}
+
+void DrainBatchPairs(_Inout_ BatchContext* context) noexcept {
+    const FCL_CONTINUOUS_BATCH_OBJECT* objects = context->Query->Objects;
+    for (;;) {
+        const LONG index = InterlockedIncrement(&context->NextPair) - 1;
+        if (index >= context->PairCount) {
+            return;
+        }
+        BatchPair& pair = context->Pairs[index];
+        pair.Status = RunContinuousCollisionCore(
+            &context->Entries[pair.First].Snapshot,
+            &objects[pair.First].Motion,
+            &context->Entries[pair.Second].Snapshot,
+            &objects[pair.Second].Motion,
+            context->Query->Tolerance,
+            context->Query->MaxIterations,
+            context->Query->Solver,
+            &pair.Result);
+    }
+}
+
+#if !FCL_MUSA_KERNEL_MODE
+VOID CALLBACK BatchWorkCallback(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_WORK work) {
+    UNREFERENCED_PARAMETER(instance);
+    UNREFERENCED_PARAMETER(work);
+    DrainBatchPairs(static_cast<BatchContext*>(context));
+}
+#endif
+
+// 用户态：线程池 + 原子游标分发，调用线程同时参与；内核态或线程池不可用时串行执行。
+void RunBatchNarrowphase(_Inout_ BatchContext* context) noexcept {
+#if !FCL_MUSA_KERNEL_MODE
+    const DWORD processors = GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+    if (context->PairCount >= kParallelPairThreshold && processors > 1) {
+        PTP_WORK work = CreateThreadpoolWork(&BatchWorkCallback, context, nullptr);
+        if (work != nullptr) {
+            const DWORD helpers = std::min<DWORD>(
+                processors - 1,
+                static_cast<DWORD>(context->PairCount / kParallelPairThreshold));
+            for (DWORD i = 0; i < helpers; ++i) {
+                SubmitThreadpoolWork(work);
+            }
+            DrainBatchPairs(context);
+            WaitForThreadpoolWorkCallbacks(work, FALSE);
+            CloseThreadpoolWork(work);
+            return;
+        }
+    }
+#endif
+    DrainBatchPairs(context);
+}
+
+void RecordObjectHit(
+    _Inout_ PFCL_CONTINUOUS_BATCH_HIT hit,
+    ULONG partner,
+    const FCL_CONTINUOUS_COLLISION_RESULT& result,
+    bool swapped) noexcept {
+    if (hit->Partner != FCL_CONTINUOUS_BATCH_NO_HIT && hit->Result.TimeOfImpact <= result.TimeOfImpact) {
+        return;
+    }
+    hit->Partner = partner;
+    hit->Result = result;
+    if (swapped) {
+        hit->Result.Contact.PointOnObject1 = result.Contact.PointOnObject2;
+        hit->Result.Contact.PointOnObject2 = result.Contact.PointOnObject1;
+        // 零法线表示没有可用的接触方向，不翻转。
+        if (Length(result.Contact.Normal) > kSingularityEpsilon) {
+            hit->Result.Contact.Normal = Scale(result.Contact.Normal, -1.0f);
+        }
+    }
+}
+
+}  // namespace
+
+extern "C"
+NTSTATUS
+FclContinuousCollisionCoreFromSnapshots(
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object1,
+    _In_ const FCL_INTERP_MOTION* motion1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object2,
+    _In_ const FCL_INTERP_MOTION* motion2,
+    _In_ double tolerance,
+    _In_ ULONG maxIterations,
+    _Out_ PFCL_CONTINUOUS_COLLISION_RESULT result) noexcept {
+    return RunContinuousCollisionCore(
+        object1, motion1, object2, motion2, tolerance, maxIterations, FCL_GJK_SOLVER_DEFAULT, result);
+}
+
 extern "C"
 NTSTATUS
 FclInterpMotionInitialize(
@@ -143,11 +533,153 @@ FclInterpMotionEvaluate(
     return STATUS_SUCCESS;
 }
 
+extern "C"
+NTSTATUS
+FclScrewMotionInitialize(
+    _In_ const FCL_SCREW_MOTION_DESC* desc,
+    _Out_ PFCL_SCREW_MOTION motion) noexcept {
+    if (desc == nullptr || motion == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    if (!IsValidTransform(desc->Start) || !IsValidTransform(desc->End)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    // 相对位移 End * Start^-1 分解为绕轴转角 + 轴向平移 + 垂直于轴的平移（Chasles 定理）。
+    const FCL_MATRIX3X3 deltaRotation = MultiplyMatrix(desc->End.Rotation, TransposeMatrix(desc->Start.Rotation));
+    const FCL_VECTOR3 deltaTranslation = Subtract(
+        desc->End.Translation,
+        MatrixVectorMultiply(deltaRotation, desc->Start.Translation));
+
+    FCL_QUATERNION quaternion = QuaternionNormalize(QuaternionFromMatrix(deltaRotation));
+    if (quaternion.W < 0.0f) {
+        quaternion = {-quaternion.W, -quaternion.X, -quaternion.Y, -quaternion.Z};
+    }
+    const FCL_VECTOR3 vectorPart = {quaternion.X, quaternion.Y, quaternion.Z};
+    const float sinHalf = Length(vectorPart);
+    const float angle = 2.0f * static_cast<float>(atan2(sinHalf, quaternion.W));
+
+    motion->Start = desc->Start;
+    if (angle <= kScrewAngleEpsilon || sinHalf <= kSingularityEpsilon) {
+        const float distance = Length(deltaTranslation);
+        motion->Axis = (distance > kSingularityEpsilon)
+            ? Scale(deltaTranslation, 1.0f / distance)
+            : FCL_VECTOR3{1.0f, 0.0f, 0.0f};
+        motion->AngularVelocity = 0.0f;
+        motion->LinearVelocity = distance;
+        motion->OrthogonalTranslation = {0.0f, 0.0f, 0.0f};
+        return STATUS_SUCCESS;
+    }
+
+    motion->Axis = Scale(vectorPart, 1.0f / sinHalf);
+    motion->AngularVelocity = angle;
+    motion->LinearVelocity = Dot(deltaTranslation, motion->Axis);
+    motion->OrthogonalTranslation = Subtract(deltaTranslation, Scale(motion->Axis, motion->LinearVelocity));
+    return STATUS_SUCCESS;
+}
+
+extern "C"
+NTSTATUS
+FclScrewMotionEvaluate(
+    _In_ const FCL_SCREW_MOTION* motion,
+    _In_ double t,
+    _Out_ PFCL_TRANSFORM transform) noexcept {
+    if (motion == nullptr || transform == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    const double clamped = Clamp01(t);
+    const float scale = static_cast<float>(clamped);
+    if (fabs(motion->AngularVelocity) <= kScrewAngleEpsilon) {
+        const FCL_VECTOR3 displacement = Add(Scale(motion->Axis, motion->LinearVelocity), motion->OrthogonalTranslation);
+        transform->Rotation = motion->Start.Rotation;
+        transform->Translation = Add(motion->Start.Translation, Scale(displacement, scale));
+        return STATUS_SUCCESS;
+    }
+
+    // 绕过 p 的轴旋转 θt，再沿轴平移 vt。
+    const FCL_VECTOR3 pivot = ScrewAxisPoint(*motion);
+    const FCL_MATRIX3X3 rotation = RotationMatrixFromAxisAngle(
+        motion->Axis,
+        static_cast<float>(motion->AngularVelocity * clamped));
+    transform->Rotation = MultiplyMatrix(rotation, motion->Start.Rotation);
+    transform->Translation = Add(
+        Add(MatrixVectorMultiply(rotation, Subtract(motion->Start.Translation, pivot)), pivot),
+        Scale(motion->Axis, motion->LinearVelocity * scale));
+    return STATUS_SUCCESS;
+}
+
+namespace {
+
+NTSTATUS ContinuousCollisionHandles(
+    _In_ const FCL_CONTINUOUS_COLLISION_QUERY* query,
+    _Out_ PFCL_CONTINUOUS_COLLISION_RESULT result) noexcept {
+    if (query == nullptr || result == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (KeGetCurrentIrql() != PASSIVE_LEVEL) {
+        return STATUS_INVALID_DEVICE_STATE;
+    }
+
+    MotionObject objectA;
+    NTSTATUS status = InitializeMotionObject(query->Object1, &objectA);
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+
+    MotionObject objectB;
+    status = InitializeMotionObject(query->Object2, &objectB);
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+
+    return RunContinuousCollisionCore(
+        &objectA.Snapshot,
+        &query->Motion1,
+        &objectB.Snapshot,
+        &query->Motion2,
+        query->Tolerance,
+        query->MaxIterations,
+        query->Solver,
+        result);
+}
+
+}  // namespace
+
 extern "C"
 NTSTATUS
 FclContinuousCollision(
     _In_ const FCL_CONTINUOUS_COLLISION_QUERY* query,
     _Out_ PFCL_CONTINUOUS_COLLISION_RESULT result) noexcept {
+    if (!fclmusa::diagnostics::IsWorkloadRecording() || query == nullptr || result == nullptr) {
+        return ContinuousCollisionHandles(query, result);
+    }
+    const ULONGLONG start = fclmusa::diagnostics::WorkloadTimestamp();
+    const NTSTATUS status = ContinuousCollisionHandles(query, result);
+    fclmusa::diagnostics::RecordContinuousCollision(start, query, result, status);
+    return status;
+}
+
+extern "C"
+NTSTATUS
+FclScrewContinuousCollisionCoreFromSnapshots(
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object1,
+    _In_ const FCL_SCREW_MOTION* motion1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object2,
+    _In_ const FCL_SCREW_MOTION* motion2,
+    _In_ double tolerance,
+    _In_ ULONG maxIterations,
+    _Out_ PFCL_CONTINUOUS_COLLISION_RESULT result) noexcept {
+    return RunScrewContinuousCollisionCore(
+        object1, motion1, object2, motion2, tolerance, maxIterations, FCL_GJK_SOLVER_DEFAULT, result);
+}
+
+namespace {
+
+NTSTATUS ScrewContinuousCollisionHandles(
+    _In_ const FCL_SCREW_CONTINUOUS_COLLISION_QUERY* query,
+    _Out_ PFCL_CONTINUOUS_COLLISION_RESULT result) noexcept {
     if (query == nullptr || result == nullptr) {
         return STATUS_INVALID_PARAMETER;
     }
@@ -168,12 +700,144 @@ FclContinuousCollision(
         return status;
     }
 
-    return FclContinuousCollisionCoreFromSnapshots(
+    return RunScrewContinuousCollisionCore(
         &objectA.Snapshot,
         &query->Motion1,
         &objectB.Snapshot,
         &query->Motion2,
         query->Tolerance,
         query->MaxIterations,
+        query->Solver,
         result);
 }
+
+NTSTATUS ContinuousCollisionBatch(
+    _In_ const FCL_CONTINUOUS_BATCH_QUERY* query,
+    _Out_writes_opt_(query->ObjectCount) PFCL_CONTINUOUS_BATCH_HIT perObjectHits,
+    _Out_ PFCL_CONTINUOUS_BATCH_RESULT result) noexcept {
+    if (query == nullptr || result == nullptr || (query->Objects == nullptr && query->ObjectCount > 0)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (KeGetCurrentIrql() != PASSIVE_LEVEL) {
+        return STATUS_INVALID_DEVICE_STATE;
+    }
+
+    FCL_SOLVER_OPTIONS solverOptions = {};
+    solverOptions.Solver = query->Solver;
+    if (!fclmusa::narrowphase::IsValidSolverOptions(solverOptions)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    RtlZeroMemory(result, sizeof(*result));
+    result->Object1 = FCL_CONTINUOUS_BATCH_NO_HIT;
+    result->Object2 = FCL_CONTINUOUS_BATCH_NO_HIT;
+    result->Earliest.TimeOfImpact = 1.0;
+    if (perObjectHits != nullptr) {
+        for (ULONG i = 0; i < query->ObjectCount; ++i) {
+            RtlZeroMemory(&perObjectHits[i], sizeof(perObjectHits[i]));
+            perObjectHits[i].Partner = FCL_CONTINUOUS_BATCH_NO_HIT;
+            perObjectHits[i].Result.TimeOfImpact = 1.0;
+        }
+    }
+
+    std::vector<BatchEntry> entries;
+    std::vector<BatchPair> pairs;
+    try {
+        entries.reserve(query->ObjectCount);
+    } catch (const std::bad_alloc&) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    NTSTATUS status = STATUS_SUCCESS;
+    for (ULONG i = 0; i < query->ObjectCount; ++i) {
+        const FCL_CONTINUOUS_BATCH_OBJECT& object = query->Objects[i];
+        if (!IsValidTransform(object.Motion.Start) || !IsValidTransform(object.Motion.End)) {
+            status = STATUS_INVALID_PARAMETER;
+            break;
+        }
+        if (!FclIsGeometryHandleValid(object.Handle)) {
+            status = STATUS_INVALID_HANDLE;
+            break;
+        }
+        BatchEntry entry = {};
+        status = FclAcquireGeometryReference(object.Handle, &entry.Reference, &entry.Snapshot);
+        if (!NT_SUCCESS(status)) {
+            break;
+        }
+        entries.push_back(entry);
+        if (!BuildSweptAabb(object.Motion, &entries.back())) {
+            status = STATUS_NOT_SUPPORTED;
+            break;
+        }
+    }
+
+    if (NT_SUCCESS(status)) {
+        status = CollectCandidatePairs(entries, &pairs);
+    }
+
+    if (NT_SUCCESS(status) && !pairs.empty()) {
+        BatchContext context = {query, entries.data(), pairs.data(), static_cast<LONG>(pairs.size()), 0};
+        RunBatchNarrowphase(&context);
+    }
+
+    if (NT_SUCCESS(status)) {
+        result->CandidatePairCount = static_cast<ULONG>(pairs.size());
+        // 按候选对顺序归约，TOI 相同时保留索引较小的对，结果与并行调度无关。
+        for (const BatchPair& pair : pairs) {
+            if (!NT_SUCCESS(pair.Status)) {
+                status = pair.Status;
+                break;
+            }
+            if (!pair.Result.Intersecting) {
+                continue;
+            }
+            ++result->HitPairCount;
+            if (result->Object1 == FCL_CONTINUOUS_BATCH_NO_HIT ||
+                pair.Result.TimeOfImpact < result->Earliest.TimeOfImpact) {
+                result->Object1 = pair.First;
+                result->Object2 = pair.Second;
+                result->Earliest = pair.Result;
+            }
+            if (perObjectHits != nullptr) {
+                RecordObjectHit(&perObjectHits[pair.First], pair.Second, pair.Result, false);
+                RecordObjectHit(&perObjectHits[pair.Second], pair.First, pair.Result, true);
+            }
+        }
+    }
+
+    ReleaseBatchEntries(entries);
+    return status;
+}
+
+}  // namespace
+
+extern "C"
+NTSTATUS
+FclScrewContinuousCollision(
+    _In_ const FCL_SCREW_CONTINUOUS_COLLISION_QUERY* query,
+    _Out_ PFCL_CONTINUOUS_COLLISION_RESULT result) noexcept {
+    if (!fclmusa::diagnostics::IsWorkloadRecording() || query == nullptr || result == nullptr) {
+        return ScrewContinuousCollisionHandles(query, result);
+    }
+    const ULONGLONG start = fclmusa::diagnostics::WorkloadTimestamp();
+    const NTSTATUS status = ScrewContinuousCollisionHandles(query, result);
+    fclmusa::diagnostics::RecordScrewContinuousCollision(start, query, result, status);
+    return status;
+}
+
+extern "C"
+NTSTATUS
+FclContinuousCollisionBatch(
+    _In_ const FCL_CONTINUOUS_BATCH_QUERY* query,
+    _Out_writes_opt_(query->ObjectCount) PFCL_CONTINUOUS_BATCH_HIT perObjectHits,
+    _Out_ PFCL_CONTINUOUS_BATCH_RESULT result) noexcept {
+    if (!fclmusa::diagnostics::IsWorkloadRecording() || query == nullptr || result == nullptr ||
+        (query->Objects == nullptr && query->ObjectCount > 0)) {
+        return ContinuousCollisionBatch(query, perObjectHits, result);
+    }
+    const ULONGLONG start = fclmusa::diagnostics::WorkloadTimestamp();
+    const NTSTATUS status = ContinuousCollisionBatch(query, perObjectHits, result);
+    fclmusa::diagnostics::RecordContinuousBatch(start, query, perObjectHits != nullptr, result, status);
+    return status;
+}
@@ -0,0 +1,397 @@
+#include "fclmusa/platform.h"
+
+#include <algorithm>
+#include <new>
+#include <vector>
+
+#include "fclmusa/collision.h"
+#include "fclmusa/distance.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/narrowphase/analytic_ccd.h"
+#include "fclmusa/narrowphase/coherence_cache.h"
+#include "fclmusa/narrowphase/query_dispatch.h"
+#include "fclmusa/shape_cast.h"
+
+namespace {
+
+using namespace fclmusa::geom;
+
+constexpr float kDefaultTolerance = 1e-4f;
+constexpr ULONG kDefaultIterations = 64;
+constexpr float kMotionEpsilon = 1e-9f;
+
+struct CastTarget {
+    FCL_GEOMETRY_REFERENCE Reference = {};
+    FCL_GEOMETRY_SNAPSHOT Snapshot = {};
+    FCL_TRANSFORM Transform = {};
+    ULONG Index = 0;
+    double Enter = 0.0;
+    double Exit = 1.0;
+};
+
+void ReleaseCastTargets(std::vector<CastTarget>& targets) noexcept {
+    for (auto& target : targets) {
+        FclReleaseGeometryReference(&target.Reference);
+    }
+}
+
+bool IsConvexGeometry(const FCL_GEOMETRY_SNAPSHOT& snapshot) noexcept {
+    switch (snapshot.Type) {
+        case FCL_GEOMETRY_SPHERE:
+        case FCL_GEOMETRY_OBB:
+        case FCL_GEOMETRY_CAPSULE:
+        case FCL_GEOMETRY_CYLINDER:
+        case FCL_GEOMETRY_CONVEX:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool WorldAabb(
+    const FCL_GEOMETRY_SNAPSHOT& snapshot,
+    const FCL_TRANSFORM& transform,
+    _Out_ FCL_VECTOR3* minimum,
+    _Out_ FCL_VECTOR3* maximum) noexcept {
+    const FCL_VECTOR3 axes[3] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+    for (int axis = 0; axis < 3; ++axis) {
+        if (!fclmusa::narrowphase::ProjectSnapshotOntoAxis(snapshot, transform, axes[axis], &(&minimum->X)[axis], &(&maximum->X)[axis])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 目标 AABB 按形状 AABB 做 Minkowski 扩张后与位移线段做 slab 求交，得到两包围盒可能重叠的时间区间。
+// 包围体不可得时保守地返回整个 [0,1]。
+bool SweptAabbInterval(
+    const FCL_GEOMETRY_SNAPSHOT& shape,
+    const FCL_TRANSFORM& start,
+    const FCL_VECTOR3& translation,
+    const FCL_GEOMETRY_SNAPSHOT& target,
+    const FCL_TRANSFORM& targetTransform,
+    _Out_ double* enter,
+    _Out_ double* exit) noexcept {
+    *enter = 0.0;
+    *exit = 1.0;
+    FCL_VECTOR3 shapeMin = {};
+    FCL_VECTOR3 shapeMax = {};
+    FCL_VECTOR3 targetMin = {};
+    FCL_VECTOR3 targetMax = {};
+    if (!WorldAabb(shape, start, &shapeMin, &shapeMax) || !WorldAabb(target, targetTransform, &targetMin, &targetMax)) {
+        return true;
+    }
+
+    for (int axis = 0; axis < 3; ++axis) {
+        const double lower = static_cast<double>((&targetMin.X)[axis]) - (&shapeMax.X)[axis];
+        const double upper = static_cast<double>((&targetMax.X)[axis]) - (&shapeMin.X)[axis];
+        const double delta = (&translation.X)[axis];
+        if (fabs(delta) <= kMotionEpsilon) {
+            if (lower > 0.0 || upper < 0.0) {
+                return false;
+            }
+            continue;
+        }
+        double entryTime = lower / delta;
+        double exitTime = upper / delta;
+        if (entryTime > exitTime) {
+            const double swap = entryTime;
+            entryTime = exitTime;
+            exitTime = swap;
+        }
+        *enter = (entryTime > *enter) ? entryTime : *enter;
+        *exit = (exitTime < *exit) ? exitTime : *exit;
+        if (*enter > *exit) {
+            return false;
+        }
+    }
+    return true;
+}
+
+FCL_TRANSFORM PoseAt(const FCL_TRANSFORM& start, const FCL_VECTOR3& translation, double t) noexcept {
+    FCL_TRANSFORM pose = start;
+    pose.Translation = Add(start.Translation, Scale(translation, static_cast<float>(t)));
+    return pose;
+}
+
+// 命中法线：优先使用最近点连线，最近点重合时取接触法线，再退化为位移反方向。
+FCL_VECTOR3 ResolveHitNormal(
+    const FCL_GEOMETRY_SNAPSHOT& shape,
+    const FCL_TRANSFORM& pose,
+    const FCL_GEOMETRY_SNAPSHOT& target,
+    const FCL_TRANSFORM& targetTransform,
+    const FCL_VECTOR3& translation,
+    const FCL_DISTANCE_RESULT* distance,
+    _Out_ FCL_VECTOR3* point) noexcept {
+    if (distance != nullptr) {
+        const FCL_VECTOR3 offset = Subtract(distance->ClosestPoint1, distance->ClosestPoint2);
+        const float length = Length(offset);
+        *point = distance->ClosestPoint2;
+        if (length > kSingularityEpsilon) {
+            return Scale(offset, 1.0f / length);
+        }
+    }
+
+    BOOLEAN colliding = FALSE;
+    FCL_CONTACT_INFO contact = {};
+    if (NT_SUCCESS(fclmusa::narrowphase::DispatchCollision(shape, pose, target, targetTransform, &colliding, &contact)) &&
+        colliding && Length(contact.Normal) > kSingularityEpsilon) {
+        *point = contact.PointOnObject2;
+        return Scale(contact.Normal, -1.0f);
+    }
+    if (distance == nullptr) {
+        *point = pose.Translation;
+    }
+    const float travel = Length(translation);
+    return (travel > kSingularityEpsilon) ? Scale(translation, -1.0f / travel) : FCL_VECTOR3{0.0f, 0.0f, 1.0f};
+}
+
+void SetHit(
+    double fraction,
+    const FCL_VECTOR3& point,
+    const FCL_VECTOR3& normal,
+    bool iterationLimited,
+    _Inout_ PFCL_SHAPE_CAST_RESULT result) noexcept {
+    result->Hit = TRUE;
+    result->IterationLimited = iterationLimited ? TRUE : FALSE;
+    result->Fraction = fraction;
+    result->Point = point;
+    result->Normal = normal;
+}
+
+// 单目标扫掠；只在 [enter, min(exit, maxFraction)] 内搜索，命中时覆盖 result。
+NTSTATUS CastAgainstTarget(
+    const FCL_GEOMETRY_SNAPSHOT& shape,
+    const FCL_TRANSFORM& start,
+    const FCL_VECTOR3& translation,
+    const FCL_GEOMETRY_SNAPSHOT& target,
+    const FCL_TRANSFORM& targetTransform,
+    double enter,
+    double exit,
+    float tolerance,
+    ULONG maxIterations,
+    double maxFraction,
+    _Inout_ PFCL_SHAPE_CAST_RESULT result) noexcept {
+    const double limit = (exit < maxFraction) ? exit : maxFraction;
+    if (enter > limit) {
+        return STATUS_SUCCESS;
+    }
+
+    if (fclmusa::narrowphase::AnalyticCcdSupportsPair(shape.Type, target.Type)) {
+        FCL_INTERP_MOTION sweep = {start, PoseAt(start, translation, 1.0)};
+        const FCL_INTERP_MOTION still = {targetTransform, targetTransform};
+        FCL_CONTINUOUS_COLLISION_RESULT analytic = {};
+        if (fclmusa::narrowphase::TryAnalyticContinuousCollision(shape, sweep, target, still, &analytic)) {
+            if (analytic.Intersecting && analytic.TimeOfImpact <= limit) {
+                SetHit(analytic.TimeOfImpact, analytic.Contact.PointOnObject2, Scale(analytic.Contact.Normal, -1.0f), false, result);
+            }
+            return STATUS_SUCCESS;
+        }
+    }
+
+    // 保守推进：两凸体之间距离沿分离方向的闭合速度不超过位移在该方向上的分量；
+    // Mesh 可能非凸（复合几何不参与扫掠），退化为位移长度。
+    const bool convex = IsConvexGeometry(shape) && IsConvexGeometry(target);
+    const float travel = Length(translation);
+    double t = enter;
+    FCL_TRANSFORM pose = {};
+    FCL_DISTANCE_RESULT distance = {};
+    for (ULONG iteration = 0; iteration < maxIterations; ++iteration) {
+        pose = PoseAt(start, translation, t);
+        NTSTATUS status = fclmusa::narrowphase::DispatchDistance(shape, pose, target, targetTransform, &distance);
+        if (!NT_SUCCESS(status)) {
+            return status;
+        }
+        if (distance.Distance <= tolerance) {
+            FCL_VECTOR3 point = {};
+            const FCL_VECTOR3 normal = ResolveHitNormal(
+                shape, pose, target, targetTransform, translation, (distance.Distance > 0.0f) ? &distance : nullptr, &point);
+            SetHit(t, point, normal, false, result);
+            return STATUS_SUCCESS;
+        }
+
+        float closingSpeed = travel;
+        if (convex) {
+            const FCL_VECTOR3 separation = Subtract(distance.ClosestPoint2, distance.ClosestPoint1);
+            closingSpeed = Dot(translation, separation) / distance.Distance;
+        }
+        if (closingSpeed <= kMotionEpsilon) {
+            return STATUS_SUCCESS;
+        }
+        t += static_cast<double>(distance.Distance) / closingSpeed;
+        if (t > limit) {
+            return STATUS_SUCCESS;
+        }
+    }
+
+    // 迭代耗尽时 t 之前已确认无接触，按 t 保守报告命中，并标记为未收敛。
+    FCL_VECTOR3 point = {};
+    const FCL_VECTOR3 normal = ResolveHitNormal(shape, pose, target, targetTransform, translation, &distance, &point);
+    SetHit(t, point, normal, true, result);
+    return STATUS_SUCCESS;
+}
+
+void ResetResult(_Out_ PFCL_SHAPE_CAST_RESULT result) noexcept {
+    RtlZeroMemory(result, sizeof(*result));
+    result->Fraction = 1.0;
+    result->HitIndex = FCL_SHAPE_CAST_NO_HIT;
+}
+
+bool IsValidCastInput(const FCL_TRANSFORM& start, const FCL_VECTOR3& translation) noexcept {
+    return IsValidTransform(start) && IsValidVector(translation);
+}
+
+}  // namespace
+
+extern "C"
+NTSTATUS
+FclShapeCastCoreFromSnapshots(
+    _In_ const FCL_GEOMETRY_SNAPSHOT* shape,
+    _In_ const FCL_TRANSFORM* start,
+    _In_ const FCL_VECTOR3* translation,
+    _In_ const FCL_GEOMETRY_SNAPSHOT* target,
+    _In_ const FCL_TRANSFORM* targetTransform,
+    _In_ float tolerance,
+    _In_ ULONG maxIterations,
+    _Out_ PFCL_SHAPE_CAST_RESULT result) noexcept {
+    if (shape == nullptr || start == nullptr || translation == nullptr || target == nullptr ||
+        targetTransform == nullptr || result == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    if (!IsValidCastInput(*start, *translation) || !IsValidTransform(*targetTransform)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    ResetResult(result);
+    double enter = 0.0;
+    double exit = 1.0;
+    if (!SweptAabbInterval(*shape, *start, *translation, *target, *targetTransform, &enter, &exit)) {
+        return STATUS_SUCCESS;
+    }
+    return CastAgainstTarget(
+        *shape,
+        *start,
+        *translation,
+        *target,
+        *targetTransform,
+        enter,
+        exit,
+        (tolerance > 0.0f) ? tolerance : kDefaultTolerance,
+        (maxIterations > 0) ? maxIterations : kDefaultIterations,
+        1.0,
+        result);
+}
+
+extern "C"
+NTSTATUS
+FclShapeCast(
+    _In_ const FCL_SHAPE_CAST_REQUEST* request,
+    _In_reads_(targetCount) const FCL_BROADPHASE_OBJECT* targets,
+    _In_ ULONG targetCount,
+    _Out_ PFCL_SHAPE_CAST_RESULT result) noexcept {
+    if (request == nullptr || result == nullptr || (targets == nullptr && targetCount > 0)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    if (!IsValidCastInput(request->Start, request->Translation)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (KeGetCurrentIrql() != PASSIVE_LEVEL) {
+        return STATUS_INVALID_DEVICE_STATE;
+    }
+
+    ResetResult(result);
+    if (!FclIsGeometryHandleValid(request->Shape)) {
+        return STATUS_INVALID_HANDLE;
+    }
+
+    FCL_GEOMETRY_REFERENCE shapeReference = {};
+    FCL_GEOMETRY_SNAPSHOT shape = {};
+    NTSTATUS status = FclAcquireGeometryReference(request->Shape, &shapeReference, &shape);
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+
+    std::vector<CastTarget> candidates;
+    try {
+        candidates.reserve(targetCount);
+    } catch (const std::bad_alloc&) {
+        FclReleaseGeometryReference(&shapeReference);
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    // 宽阶段：包围盒时间区间为空的目标直接丢弃，其余按进入时刻排序。
+    for (ULONG i = 0; i < targetCount; ++i) {
+        const FCL_BROADPHASE_OBJECT& source = targets[i];
+        CastTarget candidate = {};
+        candidate.Index = i;
+        candidate.Transform = (source.Transform != nullptr) ? *source.Transform : IdentityTransform();
+        if (!IsValidTransform(candidate.Transform)) {
+            status = STATUS_INVALID_PARAMETER;
+            break;
+        }
+        if (!FclIsGeometryHandleValid(source.Handle)) {
+            status = STATUS_INVALID_HANDLE;
+            break;
+        }
+        status = FclAcquireGeometryReference(source.Handle, &candidate.Reference, &candidate.Snapshot);
+        if (!NT_SUCCESS(status)) {
+            break;
+        }
+        if (!SweptAabbInterval(
+                shape,
+                request->Start,
+                request->Translation,
+                candidate.Snapshot,
+                candidate.Transform,
+                &candidate.Enter,
+                &candidate.Exit)) {
+            FclReleaseGeometryReference(&candidate.Reference);
+            continue;
+        }
+        candidates.push_back(candidate);
+    }
+
+    if (NT_SUCCESS(status)) {
+        std::sort(candidates.begin(), candidates.end(), [](const CastTarget& lhs, const CastTarget& rhs) {
+            return (lhs.Enter != rhs.Enter) ? (lhs.Enter < rhs.Enter) : (lhs.Index < rhs.Index);
+        });
+
+        const float tolerance = (request->Tolerance > 0.0f) ? request->Tolerance : kDefaultTolerance;
+        const ULONG maxIterations = (request->MaxIterations > 0) ? request->MaxIterations : kDefaultIterations;
+        for (const CastTarget& candidate : candidates) {
+            if (result->Hit && candidate.Enter >= result->Fraction) {
+                break;
+            }
+            FCL_SHAPE_CAST_RESULT local = *result;
+            local.Hit = FALSE;
+            status = CastAgainstTarget(
+                shape,
+                request->Start,
+                request->Translation,
+                candidate.Snapshot,
+                candidate.Transform,
+                candidate.Enter,
+                candidate.Exit,
+                tolerance,
+                maxIterations,
+                result->Fraction,
+                &local);
+            if (!NT_SUCCESS(status)) {
+                break;
+            }
+            if (local.Hit && (!result->Hit || local.Fraction < result->Fraction)) {
+                *result = local;
+                result->HitHandle = targets[candidate.Index].Handle;
+                result->HitIndex = candidate.Index;
+            }
+        }
+    }
+
+    if (!NT_SUCCESS(status)) {
+        ResetResult(result);
+    }
+    ReleaseCastTargets(candidates);
+    FclReleaseGeometryReference(&shapeReference);
+    return status;
+}
@@ -0,0 +1,344 @@
+﻿#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include "fclmusa/diagnostics/latency_histogram.h"
+
+#include "fclmusa/platform.h"
+#if !FCL_MUSA_KERNEL_MODE
+    #include <atomic>
+#endif
+
+namespace {
+
+constexpr ULONG kBucketCount = FCL_LATENCY_HISTOGRAM_BUCKETS;
+constexpr ULONG kSubBucketBits = FCL_LATENCY_SUB_BUCKET_BITS;
+constexpr ULONG kSubBuckets = FCL_LATENCY_SUB_BUCKETS;
+constexpr ULONG kMaxExponent = FCL_LATENCY_MAX_EXPONENT;
+constexpr ULONG kKindCount = FCL_LATENCY_KIND_COUNT;
+constexpr ULONG kPairCount = FCL_LATENCY_GEOMETRY_PAIRS;
+// 记录前把时长截断到 2^62 ns，累加与 Min 的 +1 偏置都不会越过 LONG64 范围。
+constexpr ULONGLONG kMaxRecordedNanoseconds = 1ULL << 62;
+
+// 查询类型直方图分片：内核态按 CPU 编号、用户态按线程取模，每片从缓存行边界开始。
+// 样本数不单独计数，查询时由桶计数求和，读取时清零也不会出现样本数与桶计数不一致。
+constexpr ULONG kShardCount = 16;
+
+#if FCL_MUSA_KERNEL_MODE
+struct alignas(64) HistogramCounters {
+    volatile LONG64 TotalNanoseconds;
+    volatile LONG64 MinNanosecondsPlusOne;  // 0 表示尚无样本
+    volatile LONG64 MaxNanoseconds;
+    volatile LONG64 Buckets[kBucketCount];
+};
+#else
+struct alignas(64) HistogramCounters {
+    std::atomic<long long> TotalNanoseconds{0};
+    std::atomic<long long> MinNanosecondsPlusOne{0};
+    std::atomic<long long> MaxNanoseconds{0};
+    std::atomic<long long> Buckets[kBucketCount] = {};
+};
+
+std::atomic<ULONG> g_NextShard{0};
+thread_local ULONG t_ShardIndex = kShardCount;
+#endif
+
+HistogramCounters g_KindShards[kKindCount][kShardCount];
+HistogramCounters g_Pairs[kKindCount][kPairCount];
+
+// LowerCounter 把 0 视为“尚无样本”，任何值都可以替换它。
+#if FCL_MUSA_KERNEL_MODE
+inline void AddCounter(volatile LONG64& counter, long long value) noexcept {
+    InterlockedAdd64(&counter, value);
+}
+
+inline long long ReadCounter(const volatile LONG64& counter) noexcept {
+    return counter;
+}
+
+inline long long ExchangeCounter(volatile LONG64& counter, long long value) noexcept {
+    return InterlockedExchange64(&counter, value);
+}
+
+void LowerCounter(volatile LONG64& counter, long long value) noexcept {
+    LONG64 previous = counter;
+    while (previous == 0 || value < previous) {
+        const LONG64 observed = InterlockedCompareExchange64(&counter, value, previous);
+        if (observed == previous) {
+            break;
+        }
+        previous = observed;
+    }
+}
+
+void RaiseCounter(volatile LONG64& counter, long long value) noexcept {
+    LONG64 previous = counter;
+    while (value > previous) {
+        const LONG64 observed = InterlockedCompareExchange64(&counter, value, previous);
+        if (observed == previous) {
+            break;
+        }
+        previous = observed;
+    }
+}
+#else
+inline void AddCounter(std::atomic<long long>& counter, long long value) noexcept {
+    counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+inline long long ReadCounter(const std::atomic<long long>& counter) noexcept {
+    return counter.load(std::memory_order_relaxed);
+}
+
+inline long long ExchangeCounter(std::atomic<long long>& counter, long long value) noexcept {
+    return counter.exchange(value, std::memory_order_relaxed);
+}
+
+void LowerCounter(std::atomic<long long>& counter, long long value) noexcept {
+    long long previous = counter.load(std::memory_order_relaxed);
+    while ((previous == 0 || value < previous) &&
+           !counter.compare_exchange_weak(previous, value, std::memory_order_relaxed)) {
+    }
+}
+
+void RaiseCounter(std::atomic<long long>& counter, long long value) noexcept {
+    long long previous = counter.load(std::memory_order_relaxed);
+    while (value > previous && !counter.compare_exchange_weak(previous, value, std::memory_order_relaxed)) {
+    }
+}
+#endif
+
+HistogramCounters& CurrentShard(ULONG kind) noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    return g_KindShards[kind][KeGetCurrentProcessorNumberEx(nullptr) % kShardCount];
+#else
+    if (t_ShardIndex == kShardCount) {
+        t_ShardIndex = g_NextShard.fetch_add(1, std::memory_order_relaxed) % kShardCount;
+    }
+    return g_KindShards[kind][t_ShardIndex];
+#endif
+}
+
+bool IsTrackedGeometryType(ULONG type) noexcept {
+    return type >= 1 && type <= FCL_LATENCY_GEOMETRY_TYPES;
+}
+
+// 无序类型对 (a, b)（1 <= a <= b <= 7）按行优先展开到 [0, 28)。
+ULONG PairIndex(ULONG low, ULONG high) noexcept {
+    const ULONG row = low - 1;
+    return row * FCL_LATENCY_GEOMETRY_TYPES - row * (row - 1) / 2 + (high - low);
+}
+
+ULONG HighestSetBit(ULONGLONG value) noexcept {
+    ULONG bit = 0;
+    for (ULONG step = 32; step != 0; step >>= 1) {
+        if ((value >> step) != 0) {
+            value >>= step;
+            bit += step;
+        }
+    }
+    return bit;
+}
+
+void RecordInto(HistogramCounters& counters, ULONG bucket, ULONGLONG durationNanoseconds) noexcept {
+    const long long clamped = static_cast<long long>(
+        (durationNanoseconds > kMaxRecordedNanoseconds) ? kMaxRecordedNanoseconds : durationNanoseconds);
+    AddCounter(counters.Buckets[bucket], 1);
+    AddCounter(counters.TotalNanoseconds, clamped);
+    LowerCounter(counters.MinNanosecondsPlusOne, clamped + 1);
+    RaiseCounter(counters.MaxNanoseconds, clamped);
+}
+
+// 把一组计数器累加进 histogram；reset 时逐项原子交换为 0。Min 以 +1 偏置暂存，由 FinishHistogram 还原。
+void MergeCounters(HistogramCounters& counters, bool reset, PFCL_LATENCY_HISTOGRAM histogram) noexcept {
+    for (ULONG bucket = 0; bucket < kBucketCount; ++bucket) {
+        const long long count =
+            reset ? ExchangeCounter(counters.Buckets[bucket], 0) : ReadCounter(counters.Buckets[bucket]);
+        histogram->Buckets[bucket] += static_cast<ULONGLONG>(count);
+    }
+    const long long total =
+        reset ? ExchangeCounter(counters.TotalNanoseconds, 0) : ReadCounter(counters.TotalNanoseconds);
+    const long long minimum =
+        reset ? ExchangeCounter(counters.MinNanosecondsPlusOne, 0) : ReadCounter(counters.MinNanosecondsPlusOne);
+    const long long maximum =
+        reset ? ExchangeCounter(counters.MaxNanoseconds, 0) : ReadCounter(counters.MaxNanoseconds);
+    histogram->TotalNanoseconds += static_cast<ULONGLONG>(total);
+    if (minimum != 0 && (histogram->MinNanoseconds == 0 || static_cast<ULONGLONG>(minimum) < histogram->MinNanoseconds)) {
+        histogram->MinNanoseconds = static_cast<ULONGLONG>(minimum);
+    }
+    if (static_cast<ULONGLONG>(maximum) > histogram->MaxNanoseconds) {
+        histogram->MaxNanoseconds = static_cast<ULONGLONG>(maximum);
+    }
+}
+
+void ClearCounters(HistogramCounters& counters) noexcept {
+    for (ULONG bucket = 0; bucket < kBucketCount; ++bucket) {
+        ExchangeCounter(counters.Buckets[bucket], 0);
+    }
+    ExchangeCounter(counters.TotalNanoseconds, 0);
+    ExchangeCounter(counters.MinNanosecondsPlusOne, 0);
+    ExchangeCounter(counters.MaxNanoseconds, 0);
+}
+
+// 第 rank 个样本（从 1 起）所在桶的上界，截断到 [Min, Max]。
+ULONGLONG ValueAtRank(const FCL_LATENCY_HISTOGRAM& histogram, ULONGLONG rank) noexcept {
+    ULONGLONG seen = 0;
+    for (ULONG bucket = 0; bucket < kBucketCount; ++bucket) {
+        seen += histogram.Buckets[bucket];
+        if (seen >= rank) {
+            ULONGLONG value = fclmusa::diagnostics::LatencyBucketUpperBound(bucket);
+            if (value > histogram.MaxNanoseconds) {
+                value = histogram.MaxNanoseconds;
+            }
+            return (value < histogram.MinNanoseconds) ? histogram.MinNanoseconds : value;
+        }
+    }
+    return histogram.MaxNanoseconds;
+}
+
+ULONGLONG Percentile(const FCL_LATENCY_HISTOGRAM& histogram, ULONGLONG perMille) noexcept {
+    const ULONGLONG rank = (histogram.Count * perMille + 999) / 1000;
+    return ValueAtRank(histogram, (rank == 0) ? 1 : rank);
+}
+
+void FinishHistogram(PFCL_LATENCY_HISTOGRAM histogram) noexcept {
+    ULONGLONG count = 0;
+    for (ULONG bucket = 0; bucket < kBucketCount; ++bucket) {
+        count += histogram->Buckets[bucket];
+    }
+    histogram->Count = count;
+    if (histogram->MinNanoseconds != 0) {
+        histogram->MinNanoseconds -= 1;
+    }
+    if (count == 0) {
+        histogram->TotalNanoseconds = 0;
+        histogram->MinNanoseconds = 0;
+        histogram->MaxNanoseconds = 0;
+        return;
+    }
+    histogram->P50Nanoseconds = Percentile(*histogram, 500);
+    histogram->P90Nanoseconds = Percentile(*histogram, 900);
+    histogram->P99Nanoseconds = Percentile(*histogram, 990);
+    histogram->P999Nanoseconds = Percentile(*histogram, 999);
+}
+
+}  // namespace
+
+namespace fclmusa::diagnostics {
+
+LatencyStopwatch::LatencyStopwatch() noexcept : start_(KeQueryPerformanceCounter(nullptr).QuadPart) {}
+
+ULONGLONG LatencyStopwatch::ElapsedNanoseconds() const noexcept {
+    LARGE_INTEGER frequency = {};
+    const LARGE_INTEGER now = KeQueryPerformanceCounter(&frequency);
+    if (frequency.QuadPart <= 0 || now.QuadPart <= start_) {
+        return 0;
+    }
+    const ULONGLONG ticks = static_cast<ULONGLONG>(now.QuadPart - start_);
+    const ULONGLONG rate = static_cast<ULONGLONG>(frequency.QuadPart);
+    return (ticks / rate) * 1'000'000'000ULL + ((ticks % rate) * 1'000'000'000ULL) / rate;
+}
+
+ULONG LatencyBucketIndex(_In_ ULONGLONG durationNanoseconds) noexcept {
+    if (durationNanoseconds < kSubBuckets) {
+        return static_cast<ULONG>(durationNanoseconds);
+    }
+    const ULONG exponent = HighestSetBit(durationNanoseconds);
+    if (exponent >= kMaxExponent) {
+        return kBucketCount - 1;
+    }
+    const ULONG subBucket = static_cast<ULONG>(durationNanoseconds >> (exponent - kSubBucketBits)) - kSubBuckets;
+    return (exponent - kSubBucketBits + 1) * kSubBuckets + subBucket;
+}
+
+ULONGLONG LatencyBucketLowerBound(_In_ ULONG bucket) noexcept {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+    if (bucket >= kBucketCount) {
+        bucket = kBucketCount - 1;
+    }
+    const ULONG group = bucket / kSubBuckets;
+    return static_cast<ULONGLONG>(kSubBuckets + bucket % kSubBuckets) << (group - 1);
+}
+
+ULONGLONG LatencyBucketUpperBound(_In_ ULONG bucket) noexcept {
+    if (bucket + 1 >= kBucketCount) {
+        return ~0ULL;
+    }
+    return LatencyBucketLowerBound(bucket + 1) - 1;
+}
+
+void RecordLatency(
+    _In_ FCL_LATENCY_KIND kind,
+    _In_ FCL_GEOMETRY_TYPE type1,
+    _In_ FCL_GEOMETRY_TYPE type2,
+    _In_ ULONGLONG durationNanoseconds) noexcept {
+    const ULONG kindIndex = static_cast<ULONG>(kind);
+    if (kindIndex >= kKindCount) {
+        return;
+    }
+
+    const ULONG bucket = LatencyBucketIndex(durationNanoseconds);
+    RecordInto(CurrentShard(kindIndex), bucket, durationNanoseconds);
+
+    ULONG low = static_cast<ULONG>(type1);
+    ULONG high = static_cast<ULONG>(type2);
+    if (IsTrackedGeometryType(low) && IsTrackedGeometryType(high)) {
+        if (low > high) {
+            const ULONG swap = low;
+            low = high;
+            high = swap;
+        }
+        RecordInto(g_Pairs[kindIndex][PairIndex(low, high)], bucket, durationNanoseconds);
+    }
+}
+
+}  // namespace fclmusa::diagnostics
+
+extern "C"
+NTSTATUS
+FclQueryLatencyHistogram(
+    _In_ const FCL_LATENCY_HISTOGRAM_QUERY* query,
+    _Out_ PFCL_LATENCY_HISTOGRAM histogram) noexcept {
+    if (query == nullptr || histogram == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    // query 可能与 histogram 共用同一块缓冲区（IOCTL），先取出全部字段。
+    const FCL_LATENCY_HISTOGRAM_QUERY request = *query;
+    const bool aggregate = (request.Type1 == 0 && request.Type2 == 0);
+    if (request.Kind >= kKindCount ||
+        (request.Flags & ~FCL_LATENCY_QUERY_FLAG_RESET) != 0 ||
+        (!aggregate && (!IsTrackedGeometryType(request.Type1) || !IsTrackedGeometryType(request.Type2)))) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    RtlZeroMemory(histogram, sizeof(*histogram));
+    histogram->Kind = request.Kind;
+    const bool reset = (request.Flags & FCL_LATENCY_QUERY_FLAG_RESET) != 0;
+    if (aggregate) {
+        for (HistogramCounters& shard : g_KindShards[request.Kind]) {
+            MergeCounters(shard, reset, histogram);
+        }
+    } else {
+        histogram->Type1 = (request.Type1 <= request.Type2) ? request.Type1 : request.Type2;
+        histogram->Type2 = (request.Type1 <= request.Type2) ? request.Type2 : request.Type1;
+        MergeCounters(g_Pairs[request.Kind][PairIndex(histogram->Type1, histogram->Type2)], reset, histogram);
+    }
+    FinishHistogram(histogram);
+    return STATUS_SUCCESS;
+}
+
+extern "C"
+VOID
+FclResetLatencyHistograms() noexcept {
+    for (ULONG kind = 0; kind < kKindCount; ++kind) {
+        for (HistogramCounters& shard : g_KindShards[kind]) {
+            ClearCounters(shard);
+        }
+        for (HistogramCounters& pair : g_Pairs[kind]) {
+            ClearCounters(pair);
+        }
+    }
+}
@@ -0,0 +1,402 @@
+﻿#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include "fclmusa/diagnostics/phase_trace.h"
+
+#include "fclmusa/platform.h"
+#if FCL_MUSA_ENABLE_PHASE_TRACING && !FCL_MUSA_KERNEL_MODE
+    #include <atomic>
+#endif
+
+#if FCL_MUSA_ENABLE_PHASE_TRACING
+
+namespace {
+
+constexpr ULONG kPhaseCount = FCL_TRACE_PHASE_COUNT;
+constexpr ULONGLONG kRingCapacity = FCL_PHASE_TRACE_RING_CAPACITY;
+// 记录前把时长截断到 2^62 周期，累加与 Min 的 +1 偏置都不会越过 LONG64 范围。
+constexpr ULONGLONG kMaxRecordedCycles = 1ULL << 62;
+constexpr ULONG kShardCount = 16;
+
+#if FCL_MUSA_KERNEL_MODE
+struct alignas(64) PhaseCounters {
+    volatile LONG64 Count;
+    volatile LONG64 TotalCycles;
+    volatile LONG64 MinCyclesPlusOne;  // 0 表示尚无样本
+    volatile LONG64 MaxCycles;
+};
+
+// Sequence 为 0 表示正在写入；发布后为写入下标 + 1。
+struct RingSlot {
+    volatile LONG64 Sequence;
+    volatile LONG64 StartCycles;
+    volatile LONG64 DurationCycles;
+    volatile LONG Phase;
+    volatile LONG Processor;
+};
+
+volatile LONG64 g_WriteIndex = 0;
+volatile LONG64 g_ReadBase = 0;  // 重置时的写入下标，之前的事件不再读出
+volatile LONG g_RingEnabled = 0;
+volatile LONG64 g_CalibrationCycles = 0;
+volatile LONG64 g_CalibrationTicks = 0;  // 0 表示尚未校准
+#else
+struct alignas(64) PhaseCounters {
+    std::atomic<long long> Count{0};
+    std::atomic<long long> TotalCycles{0};
+    std::atomic<long long> MinCyclesPlusOne{0};
+    std::atomic<long long> MaxCycles{0};
+};
+
+struct RingSlot {
+    std::atomic<long long> Sequence{0};
+    std::atomic<long long> StartCycles{0};
+    std::atomic<long long> DurationCycles{0};
+    std::atomic<ULONG> Phase{0};
+    std::atomic<ULONG> Processor{0};
+};
+
+std::atomic<long long> g_WriteIndex{0};
+std::atomic<long long> g_ReadBase{0};
+std::atomic<bool> g_RingEnabled{false};
+std::atomic<long long> g_CalibrationCycles{0};
+std::atomic<long long> g_CalibrationTicks{0};
+std::atomic<ULONG> g_NextThread{0};
+thread_local ULONG t_ThreadIndex = ~0u;
+#endif
+
+PhaseCounters g_Shards[kShardCount][kPhaseCount];
+RingSlot g_Ring[kRingCapacity];
+
+// LowerCounter 把 0 视为“尚无样本”，任何值都可以替换它。
+#if FCL_MUSA_KERNEL_MODE
+inline void AddCounter(volatile LONG64& counter, long long value) noexcept {
+    InterlockedAdd64(&counter, value);
+}
+
+inline long long ReadCounter(const volatile LONG64& counter) noexcept {
+    return counter;
+}
+
+inline long long ExchangeCounter(volatile LONG64& counter, long long value) noexcept {
+    return InterlockedExchange64(&counter, value);
+}
+
+void LowerCounter(volatile LONG64& counter, long long value) noexcept {
+    LONG64 previous = counter;
+    while (previous == 0 || value < previous) {
+        const LONG64 observed = InterlockedCompareExchange64(&counter, value, previous);
+        if (observed == previous) {
+            break;
+        }
+        previous = observed;
+    }
+}
+
+void RaiseCounter(volatile LONG64& counter, long long value) noexcept {
+    LONG64 previous = counter;
+    while (value > previous) {
+        const LONG64 observed = InterlockedCompareExchange64(&counter, value, previous);
+        if (observed == previous) {
+            break;
+        }
+        previous = observed;
+    }
+}
+
+inline ULONG CurrentProcessor() noexcept {
+    return KeGetCurrentProcessorNumberEx(nullptr);
+}
+
+inline bool RingEnabled() noexcept {
+    return g_RingEnabled != 0;
+}
+
+inline void SetRingEnabled(bool enable) noexcept {
+    InterlockedExchange(&g_RingEnabled, enable ? 1 : 0);
+}
+
+// 领取下一个写入下标。
+inline long long ClaimIndex() noexcept {
+    return InterlockedIncrement64(&g_WriteIndex) - 1;
+}
+
+void WriteSlot(RingSlot& slot, long long sequence, ULONG phase, ULONGLONG start, ULONGLONG duration) noexcept {
+    InterlockedExchange64(&slot.Sequence, 0);
+    slot.StartCycles = static_cast<LONG64>(start);
+    slot.DurationCycles = static_cast<LONG64>(duration);
+    slot.Phase = static_cast<LONG>(phase);
+    slot.Processor = static_cast<LONG>(CurrentProcessor());
+    InterlockedExchange64(&slot.Sequence, sequence);
+}
+
+// 读取前后序号都等于 expected 时才认为 event 完整。
+bool ReadSlot(const RingSlot& slot, long long expected, PFCL_PHASE_TRACE_EVENT event) noexcept {
+    if (slot.Sequence != expected) {
+        return false;
+    }
+    MemoryBarrier();
+    event->StartCycles = static_cast<ULONGLONG>(slot.StartCycles);
+    event->DurationCycles = static_cast<ULONGLONG>(slot.DurationCycles);
+    event->Phase = static_cast<ULONG>(slot.Phase);
+    event->Processor = static_cast<ULONG>(slot.Processor);
+    MemoryBarrier();
+    return slot.Sequence == expected;
+}
+#else
+inline void AddCounter(std::atomic<long long>& counter, long long value) noexcept {
+    counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+inline long long ReadCounter(const std::atomic<long long>& counter) noexcept {
+    return counter.load(std::memory_order_relaxed);
+}
+
+inline long long ExchangeCounter(std::atomic<long long>& counter, long long value) noexcept {
+    return counter.exchange(value, std::memory_order_relaxed);
+}
+
+void LowerCounter(std::atomic<long long>& counter, long long value) noexcept {
+    long long previous = counter.load(std::memory_order_relaxed);
+    while ((previous == 0 || value < previous) &&
+           !counter.compare_exchange_weak(previous, value, std::memory_order_relaxed)) {
+    }
+}
+
+void RaiseCounter(std::atomic<long long>& counter, long long value) noexcept {
+    long long previous = counter.load(std::memory_order_relaxed);
+    while (value > previous && !counter.compare_exchange_weak(previous, value, std::memory_order_relaxed)) {
+    }
+}
+
+inline ULONG CurrentProcessor() noexcept {
+    if (t_ThreadIndex == ~0u) {
+        t_ThreadIndex = g_NextThread.fetch_add(1, std::memory_order_relaxed);
+    }
+    return t_ThreadIndex;
+}
+
+inline bool RingEnabled() noexcept {
+    return g_RingEnabled.load(std::memory_order_relaxed);
+}
+
+inline void SetRingEnabled(bool enable) noexcept {
+    g_RingEnabled.store(enable, std::memory_order_relaxed);
+}
+
+inline long long ClaimIndex() noexcept {
+    return g_WriteIndex.fetch_add(1, std::memory_order_relaxed);
+}
+
+void WriteSlot(RingSlot& slot, long long sequence, ULONG phase, ULONGLONG start, ULONGLONG duration) noexcept {
+    slot.Sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.StartCycles.store(static_cast<long long>(start), std::memory_order_relaxed);
+    slot.DurationCycles.store(static_cast<long long>(duration), std::memory_order_relaxed);
+    slot.Phase.store(phase, std::memory_order_relaxed);
+    slot.Processor.store(CurrentProcessor(), std::memory_order_relaxed);
+    slot.Sequence.store(sequence, std::memory_order_release);
+}
+
+bool ReadSlot(const RingSlot& slot, long long expected, PFCL_PHASE_TRACE_EVENT event) noexcept {
+    if (slot.Sequence.load(std::memory_order_acquire) != expected) {
+        return false;
+    }
+    event->StartCycles = static_cast<ULONGLONG>(slot.StartCycles.load(std::memory_order_relaxed));
+    event->DurationCycles = static_cast<ULONGLONG>(slot.DurationCycles.load(std::memory_order_relaxed));
+    event->Phase = slot.Phase.load(std::memory_order_relaxed);
+    event->Processor = slot.Processor.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.Sequence.load(std::memory_order_relaxed) == expected;
+}
+#endif
+
+PhaseCounters* CurrentShard() noexcept {
+    return g_Shards[CurrentProcessor() % kShardCount];
+}
+
+// 首次调用时记录 (周期计数器, 性能计数器) 校准起点；并发首次调用时只有一个生效。
+void EnsureCalibrated() noexcept {
+    if (ReadCounter(g_CalibrationTicks) != 0) {
+        return;
+    }
+    const long long cycles = static_cast<long long>(ReadTimeStampCounter());
+    const long long ticks = KeQueryPerformanceCounter(nullptr).QuadPart;
+#if FCL_MUSA_KERNEL_MODE
+    if (InterlockedCompareExchange64(&g_CalibrationTicks, (ticks != 0) ? ticks : 1, 0) == 0) {
+        InterlockedExchange64(&g_CalibrationCycles, cycles);
+    }
+#else
+    long long expected = 0;
+    if (g_CalibrationTicks.compare_exchange_strong(expected, (ticks != 0) ? ticks : 1)) {
+        g_CalibrationCycles.store(cycles, std::memory_order_relaxed);
+    }
+#endif
+}
+
+// 以校准起点到当前的周期差 / 计数差估算周期频率；间隔不足 1 ms 时返回 0。
+ULONGLONG EstimateCyclesPerSecond() noexcept {
+    const long long startTicks = ReadCounter(g_CalibrationTicks);
+    const long long startCycles = ReadCounter(g_CalibrationCycles);
+    LARGE_INTEGER frequency = {};
+    const long long nowCycles = static_cast<long long>(ReadTimeStampCounter());
+    const LARGE_INTEGER now = KeQueryPerformanceCounter(&frequency);
+    if (startTicks == 0 || frequency.QuadPart <= 0 || now.QuadPart - startTicks < frequency.QuadPart / 1000 ||
+        nowCycles <= startCycles) {
+        return 0;
+    }
+    const double seconds =
+        static_cast<double>(now.QuadPart - startTicks) / static_cast<double>(frequency.QuadPart);
+    return static_cast<ULONGLONG>(static_cast<double>(nowCycles - startCycles) / seconds);
+}
+
+void SnapshotPhases(bool reset, PFCL_PHASE_TRACE_SNAPSHOT snapshot) noexcept {
+    for (ULONG phase = 0; phase < kPhaseCount; ++phase) {
+        FCL_PHASE_STATS& stats = snapshot->Phases[phase];
+        for (ULONG shard = 0; shard < kShardCount; ++shard) {
+            PhaseCounters& counters = g_Shards[shard][phase];
+            const long long count = reset ? ExchangeCounter(counters.Count, 0) : ReadCounter(counters.Count);
+            const long long total =
+                reset ? ExchangeCounter(counters.TotalCycles, 0) : ReadCounter(counters.TotalCycles);
+            const long long minimum =
+                reset ? ExchangeCounter(counters.MinCyclesPlusOne, 0) : ReadCounter(counters.MinCyclesPlusOne);
+            const long long maximum =
+                reset ? ExchangeCounter(counters.MaxCycles, 0) : ReadCounter(counters.MaxCycles);
+            stats.Count += static_cast<ULONGLONG>(count);
+            stats.TotalCycles += static_cast<ULONGLONG>(total);
+            if (minimum != 0 && (stats.MinCycles == 0 || static_cast<ULONGLONG>(minimum) < stats.MinCycles)) {
+                stats.MinCycles = static_cast<ULONGLONG>(minimum);
+            }
+            if (static_cast<ULONGLONG>(maximum) > stats.MaxCycles) {
+                stats.MaxCycles = static_cast<ULONGLONG>(maximum);
+            }
+        }
+        if (stats.MinCycles != 0) {
+            stats.MinCycles -= 1;
+        }
+    }
+}
+
+// 读出 [base, end) 中仍留在环形缓冲区里的事件，返回本次读到的写入下标上界。
+long long SnapshotRing(PFCL_PHASE_TRACE_SNAPSHOT snapshot) noexcept {
+    const long long end = ReadCounter(g_WriteIndex);
+    const long long base = ReadCounter(g_ReadBase);
+    long long begin = base;
+    if (end - begin > static_cast<long long>(kRingCapacity)) {
+        begin = end - static_cast<long long>(kRingCapacity);
+    }
+    ULONG count = 0;
+    for (long long index = begin; index < end; ++index) {
+        PFCL_PHASE_TRACE_EVENT event = &snapshot->Events[count];
+        if (ReadSlot(g_Ring[static_cast<ULONGLONG>(index) % kRingCapacity], index + 1, event)) {
+            event->Sequence = static_cast<ULONGLONG>(index + 1 - base);
+            ++count;
+        }
+    }
+    snapshot->EventCount = count;
+    snapshot->TotalEvents = (end > base) ? static_cast<ULONGLONG>(end - base) : 0;
+    return end;
+}
+
+}  // namespace
+
+namespace fclmusa::diagnostics {
+
+void RecordPhase(_In_ FCL_TRACE_PHASE phase, _In_ ULONGLONG startCycles, _In_ ULONGLONG endCycles) noexcept {
+    const ULONG phaseIndex = static_cast<ULONG>(phase);
+    if (phaseIndex >= kPhaseCount) {
+        return;
+    }
+    // 线程在两次读数之间迁移到周期计数器不同步的 CPU 时，差值可能为负，按 0 计。
+    ULONGLONG duration = (endCycles > startCycles) ? endCycles - startCycles : 0;
+    if (duration > kMaxRecordedCycles) {
+        duration = kMaxRecordedCycles;
+    }
+
+    PhaseCounters& counters = CurrentShard()[phaseIndex];
+    AddCounter(counters.Count, 1);
+    AddCounter(counters.TotalCycles, static_cast<long long>(duration));
+    LowerCounter(counters.MinCyclesPlusOne, static_cast<long long>(duration) + 1);
+    RaiseCounter(counters.MaxCycles, static_cast<long long>(duration));
+
+    if (RingEnabled()) {
+        const long long index = ClaimIndex();
+        WriteSlot(g_Ring[static_cast<ULONGLONG>(index) % kRingCapacity], index + 1, phaseIndex, startCycles, duration);
+    }
+}
+
+}  // namespace fclmusa::diagnostics
+
+#endif  // FCL_MUSA_ENABLE_PHASE_TRACING
+
+extern "C"
+NTSTATUS
+FclQueryPhaseTrace(
+    _In_ const FCL_PHASE_TRACE_QUERY* query,
+    _Out_ PFCL_PHASE_TRACE_SNAPSHOT snapshot) noexcept {
+    if (query == nullptr || snapshot == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    // query 可能与 snapshot 共用同一块缓冲区（IOCTL），先取出全部字段。
+    const FCL_PHASE_TRACE_QUERY request = *query;
+    constexpr ULONG kKnownFlags =
+        FCL_PHASE_TRACE_FLAG_RESET | FCL_PHASE_TRACE_FLAG_ENABLE_RING | FCL_PHASE_TRACE_FLAG_DISABLE_RING;
+    if ((request.Flags & ~kKnownFlags) != 0) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    RtlZeroMemory(snapshot, sizeof(*snapshot));
+
+#if FCL_MUSA_ENABLE_PHASE_TRACING
+    EnsureCalibrated();
+    const bool reset = (request.Flags & FCL_PHASE_TRACE_FLAG_RESET) != 0;
+    snapshot->Enabled = TRUE;
+    snapshot->RingEnabled = RingEnabled() ? TRUE : FALSE;
+    snapshot->CyclesPerSecond = EstimateCyclesPerSecond();
+    SnapshotPhases(reset, snapshot);
+    const long long end = SnapshotRing(snapshot);
+    if (reset) {
+        // 只丢弃已读过的范围，读取期间写入的事件留给下一次读取。
+        ExchangeCounter(g_ReadBase, end);
+    }
+    if ((request.Flags & FCL_PHASE_TRACE_FLAG_DISABLE_RING) != 0) {
+        SetRingEnabled(false);
+    } else if ((request.Flags & FCL_PHASE_TRACE_FLAG_ENABLE_RING) != 0) {
+        SetRingEnabled(true);
+    }
+    return STATUS_SUCCESS;
+#else
+    return STATUS_NOT_SUPPORTED;
+#endif
+}
+
+extern "C"
+VOID
+FclResetPhaseTrace() noexcept {
+#if FCL_MUSA_ENABLE_PHASE_TRACING
+    EnsureCalibrated();
+    for (auto& shard : g_Shards) {
+        for (PhaseCounters& counters : shard) {
+            ExchangeCounter(counters.Count, 0);
+            ExchangeCounter(counters.TotalCycles, 0);
+            ExchangeCounter(counters.MinCyclesPlusOne, 0);
+            ExchangeCounter(counters.MaxCycles, 0);
+        }
+    }
+    ExchangeCounter(g_ReadBase, ReadCounter(g_WriteIndex));
+#endif
+}
+
+extern "C"
+NTSTATUS
+FclEnablePhaseTraceRing(
+    _In_ BOOLEAN enable) noexcept {
+#if FCL_MUSA_ENABLE_PHASE_TRACING
+    SetRingEnabled(enable != FALSE);
+    return STATUS_SUCCESS;
+#else
+    UNREFERENCED_PARAMETER(enable);
+    return STATUS_NOT_SUPPORTED;
+#endif
+}
@@ -0,0 +1,777 @@
+﻿#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include "fclmusa/diagnostics/workload_recorder.h"
+
+#include "fclmusa/platform.h"
+#if !FCL_MUSA_KERNEL_MODE
+    #include <cstring>
+#endif
+
+#include "fclmusa/geometry/compound_model.h"
+#include "fclmusa/memory/pool_allocator.h"
+
+namespace {
+
+constexpr ULONG kMinimumCapacity = 4096;
+constexpr ULONGLONG kRecordAlignment = 8;
+constexpr LONG64 kNoDrop = LLONG_MAX;
+
+// Start / Stop / Read / Discard 互斥（全零即已初始化）；写入路径不取锁。
+EX_PUSH_LOCK g_ControlLock = {};
+
+UCHAR* g_Buffer = nullptr;
+ULONG g_Capacity = 0;
+ULONGLONG g_StartTicks = 0;
+BOOLEAN g_HasTrace = FALSE;
+
+volatile LONG g_Recording = 0;
+// 正在写入的调用数；停止录制先清除 g_Recording，再等它归零后才读取或释放缓冲区。
+volatile LONG g_ActiveWriters = 0;
+volatile LONG64 g_WriteOffset = 0;
+// 第一条因空间不足而丢弃的记录的偏移；之后领取到的偏移即使放得下也不算有效（保证轨迹是无空洞的前缀）。
+volatile LONG64 g_FirstDropOffset = kNoDrop;
+volatile LONG64 g_RecordCount = 0;
+volatile LONG64 g_DroppedRecords = 0;
+
+// 用户态没有 ExEnterCriticalRegionAndAcquirePushLock* 组合函数，两种构建都用分开的调用。
+void LockControl(bool exclusive) noexcept {
+    KeEnterCriticalRegion();
+    if (exclusive) {
+        ExAcquirePushLockExclusive(&g_ControlLock);
+    } else {
+        ExAcquirePushLockShared(&g_ControlLock);
+    }
+}
+
+void UnlockControl(bool exclusive) noexcept {
+    if (exclusive) {
+        ExReleasePushLockExclusive(&g_ControlLock);
+    } else {
+        ExReleasePushLockShared(&g_ControlLock);
+    }
+    KeLeaveCriticalRegion();
+}
+
+class WriterScope {
+public:
+    WriterScope() noexcept {
+        InterlockedIncrement(&g_ActiveWriters);
+        active_ = InterlockedCompareExchange(&g_Recording, 0, 0) != 0;
+    }
+
+    ~WriterScope() noexcept {
+        InterlockedDecrement(&g_ActiveWriters);
+    }
+
+    WriterScope(const WriterScope&) = delete;
+    WriterScope& operator=(const WriterScope&) = delete;
+
+    bool Active() const noexcept {
+        return active_;
+    }
+
+private:
+    bool active_ = false;
+};
+
+void WaitForWriters() noexcept {
+    while (InterlockedCompareExchange(&g_ActiveWriters, 0, 0) != 0) {
+        YieldProcessor();
+    }
+}
+
+ULONGLONG ValidTraceBytes() noexcept {
+    LONG64 length = InterlockedCompareExchange64(&g_WriteOffset, 0, 0);
+    const LONG64 firstDrop = InterlockedCompareExchange64(&g_FirstDropOffset, kNoDrop, kNoDrop);
+    if (firstDrop < length) {
+        length = firstDrop;
+    }
+    if (length > static_cast<LONG64>(g_Capacity)) {
+        length = static_cast<LONG64>(g_Capacity);
+    }
+    return static_cast<ULONGLONG>(length);
+}
+
+void CountDrop(LONG64 offset) noexcept {
+    InterlockedIncrement64(&g_DroppedRecords);
+    LONG64 current = InterlockedCompareExchange64(&g_FirstDropOffset, kNoDrop, kNoDrop);
+    while (offset < current) {
+        const LONG64 observed = InterlockedCompareExchange64(&g_FirstDropOffset, offset, current);
+        if (observed == current) {
+            break;
+        }
+        current = observed;
+    }
+}
+
+// 领取 size 字节；放不下时计入丢弃并返回 nullptr。调用方须处于 WriterScope 内。
+UCHAR* Reserve(ULONGLONG size) noexcept {
+    if (size > g_Capacity) {
+        CountDrop(InterlockedCompareExchange64(&g_WriteOffset, 0, 0));
+        return nullptr;
+    }
+    const LONG64 offset = InterlockedExchangeAdd64(&g_WriteOffset, static_cast<LONG64>(size));
+    if (static_cast<ULONGLONG>(offset) + size > g_Capacity) {
+        CountDrop(offset);
+        return nullptr;
+    }
+    InterlockedIncrement64(&g_RecordCount);
+    return g_Buffer + offset;
+}
+
+template <typename Record>
+Record* BeginRecord(
+    FCL_WORKLOAD_RECORD_TYPE type,
+    USHORT flags,
+    ULONGLONG payloadBytes,
+    ULONGLONG start,
+    ULONGLONG end,
+    NTSTATUS status) noexcept {
+    const ULONGLONG size = (sizeof(Record) + payloadBytes + kRecordAlignment - 1) & ~(kRecordAlignment - 1);
+    auto* record = reinterpret_cast<Record*>(Reserve(size));
+    if (record == nullptr) {
+        return nullptr;
+    }
+    RtlZeroMemory(record, sizeof(Record));
+    record->Header.Type = static_cast<USHORT>(type);
+    record->Header.Flags = flags;
+    record->Header.Size = static_cast<ULONG>(size);
+    if ((flags & FCL_WORKLOAD_RECORD_FLAG_EXISTING) == 0) {
+        record->Header.Timestamp = (start > g_StartTicks) ? start - g_StartTicks : 0;
+        record->Header.Duration = (end > start) ? end - start : 0;
+    }
+    record->Header.Status = status;
+    return record;
+}
+
+// 几何记录的数据来源：创建描述（调用方的数组）或已有几何的快照。
+struct GeometrySource {
+    FCL_GEOMETRY_TYPE Type = FCL_GEOMETRY_SPHERE;
+    const VOID* Shape = nullptr;  // 基本体描述，与快照联合体中的对应成员布局相同
+    size_t ShapeBytes = 0;
+    const FCL_VECTOR3* Vertices = nullptr;
+    ULONG VertexCount = 0;
+    const UINT32* Indices = nullptr;
+    ULONG IndexCount = 0;
+    const FCL_COMPOUND_CHILD_DESC* ChildDescs = nullptr;
+    const FCL_COMPOUND_CHILD* Children = nullptr;
+    ULONG ChildCount = 0;
+};
+
+bool SourceFromDesc(FCL_GEOMETRY_TYPE type, const VOID* geometryDesc, GeometrySource* source) noexcept {
+    if (geometryDesc == nullptr) {
+        return false;
+    }
+    source->Type = type;
+    switch (type) {
+        case FCL_GEOMETRY_SPHERE:
+            source->Shape = geometryDesc;
+            source->ShapeBytes = sizeof(FCL_SPHERE_GEOMETRY_DESC);
+            return true;
+        case FCL_GEOMETRY_OBB:
+            source->Shape = geometryDesc;
+            source->ShapeBytes = sizeof(FCL_OBB_GEOMETRY_DESC);
+            return true;
+        case FCL_GEOMETRY_CAPSULE:
+            source->Shape = geometryDesc;
+            source->ShapeBytes = sizeof(FCL_CAPSULE_GEOMETRY_DESC);
+            return true;
+        case FCL_GEOMETRY_CYLINDER:
+            source->Shape = geometryDesc;
+            source->ShapeBytes = sizeof(FCL_CYLINDER_GEOMETRY_DESC);
+            return true;
+        case FCL_GEOMETRY_MESH: {
+            const auto* desc = static_cast<const FCL_MESH_GEOMETRY_DESC*>(geometryDesc);
+            source->Vertices = desc->Vertices;
+            source->VertexCount = desc->VertexCount;
+            source->Indices = desc->Indices;
+            source->IndexCount = desc->IndexCount;
+            return true;
+        }
+        case FCL_GEOMETRY_CONVEX: {
+            const auto* desc = static_cast<const FCL_CONVEX_GEOMETRY_DESC*>(geometryDesc);
+            source->Vertices = desc->Points;
+            source->VertexCount = desc->PointCount;
+            return true;
+        }
+        case FCL_GEOMETRY_COMPOUND: {
+            const auto* desc = static_cast<const FCL_COMPOUND_GEOMETRY_DESC*>(geometryDesc);
+            source->ChildDescs = desc->Children;
+            source->ChildCount = desc->ChildCount;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+bool SourceFromSnapshot(const FCL_GEOMETRY_SNAPSHOT& snapshot, GeometrySource* source) noexcept {
+    source->Type = snapshot.Type;
+    switch (snapshot.Type) {
+        case FCL_GEOMETRY_SPHERE:
+            return SourceFromDesc(snapshot.Type, &snapshot.Data.Sphere, source);
+        case FCL_GEOMETRY_OBB:
+            return SourceFromDesc(snapshot.Type, &snapshot.Data.Obb, source);
+        case FCL_GEOMETRY_CAPSULE:
+            return SourceFromDesc(snapshot.Type, &snapshot.Data.Capsule, source);
+        case FCL_GEOMETRY_CYLINDER:
+            return SourceFromDesc(snapshot.Type, &snapshot.Data.Cylinder, source);
+        case FCL_GEOMETRY_MESH:
+            source->Vertices = snapshot.Data.Mesh.Vertices;
+            source->VertexCount = snapshot.Data.Mesh.VertexCount;
+            source->Indices = snapshot.Data.Mesh.Indices;
+            source->IndexCount = snapshot.Data.Mesh.IndexCount;
+            return true;
+        case FCL_GEOMETRY_CONVEX:
+            // 凸包顶点重新求凸包得到同一个凸包，回放不需要原始点集。
+            source->Vertices = snapshot.Data.Convex.Vertices;
+            source->VertexCount = snapshot.Data.Convex.VertexCount;
+            return true;
+        case FCL_GEOMETRY_COMPOUND:
+            source->Children = FclCompoundGetChildren(snapshot.Data.Compound.Model, &source->ChildCount);
+            return source->Children != nullptr || source->ChildCount == 0;
+        default:
+            return false;
+    }
+}
+
+void WriteGeometryRecord(
+    FCL_WORKLOAD_RECORD_TYPE type,
+    USHORT flags,
+    ULONGLONG start,
+    ULONGLONG end,
+    NTSTATUS status,
+    FCL_GEOMETRY_HANDLE handle,
+    const GeometrySource* source) noexcept {
+    ULONGLONG payloadBytes = 0;
+    if (source != nullptr) {
+        payloadBytes = static_cast<ULONGLONG>(source->VertexCount) * sizeof(FCL_VECTOR3) +
+                       static_cast<ULONGLONG>(source->IndexCount) * sizeof(UINT32) +
+                       static_cast<ULONGLONG>(source->ChildCount) * sizeof(FCL_COMPOUND_CHILD_DESC);
+    }
+    auto* record = BeginRecord<FCL_WORKLOAD_GEOMETRY_RECORD>(type, flags, payloadBytes, start, end, status);
+    if (record == nullptr) {
+        return;
+    }
+    record->Handle = handle;
+    if (source == nullptr) {
+        return;
+    }
+
+    record->GeometryType = static_cast<ULONG>(source->Type);
+    if (source->Shape != nullptr) {
+        RtlCopyMemory(&record->Shape, source->Shape, source->ShapeBytes);
+    }
+    UCHAR* payload = reinterpret_cast<UCHAR*>(record + 1);
+    if (source->ChildCount != 0) {
+        record->ElementCount0 = source->ChildCount;
+        auto* children = reinterpret_cast<FCL_COMPOUND_CHILD_DESC*>(payload);
+        for (ULONG i = 0; i < source->ChildCount; ++i) {
+            if (source->ChildDescs != nullptr) {
+                children[i] = source->ChildDescs[i];
+            } else {
+                children[i].Geometry = source->Children[i].Geometry;
+                children[i].LocalTransform = source->Children[i].LocalTransform;
+            }
+        }
+        return;
+    }
+    record->ElementCount0 = source->VertexCount;
+    record->ElementCount1 = source->IndexCount;
+    if (source->VertexCount != 0) {
+        RtlCopyMemory(payload, source->Vertices, static_cast<size_t>(source->VertexCount) * sizeof(FCL_VECTOR3));
+        payload += static_cast<size_t>(source->VertexCount) * sizeof(FCL_VECTOR3);
+    }
+    if (source->IndexCount != 0) {
+        RtlCopyMemory(payload, source->Indices, static_cast<size_t>(source->IndexCount) * sizeof(UINT32));
+    }
+}
+
+void WritePairRecord(
+    FCL_WORKLOAD_RECORD_TYPE type,
+    ULONGLONG start,
+    FCL_GEOMETRY_HANDLE object1,
+    const FCL_TRANSFORM* transform1,
+    FCL_GEOMETRY_HANDLE object2,
+    const FCL_TRANSFORM* transform2,
+    BOOLEAN intersecting,
+    float distance,
+    NTSTATUS status) noexcept {
+    const ULONGLONG end = fclmusa::diagnostics::WorkloadTimestamp();
+    WriterScope writer;
+    if (!writer.Active()) {
+        return;
+    }
+    auto* record = BeginRecord<FCL_WORKLOAD_PAIR_RECORD>(type, 0, 0, start, end, status);
+    if (record == nullptr) {
+        return;
+    }
+    record->Handle1 = object1;
+    record->Handle2 = object2;
+    record->Intersecting = intersecting;
+    record->Distance = distance;
+    if (transform1 != nullptr) {
+        record->Flags |= FCL_WORKLOAD_PAIR_FLAG_TRANSFORM1;
+        record->Transform1 = *transform1;
+    }
+    if (transform2 != nullptr) {
+        record->Flags |= FCL_WORKLOAD_PAIR_FLAG_TRANSFORM2;
+        record->Transform2 = *transform2;
+    }
+}
+
+VOID RecordExistingGeometry(PVOID context, FCL_GEOMETRY_HANDLE handle, const FCL_GEOMETRY_SNAPSHOT* snapshot) {
+    UNREFERENCED_PARAMETER(context);
+    WriterScope writer;
+    if (!writer.Active() || snapshot == nullptr) {
+        return;
+    }
+    GeometrySource source;
+    if (!SourceFromSnapshot(*snapshot, &source)) {
+        return;
+    }
+    WriteGeometryRecord(FCL_WORKLOAD_RECORD_GEOMETRY,
+        FCL_WORKLOAD_RECORD_FLAG_EXISTING,
+        0,
+        0,
+        STATUS_SUCCESS,
+        handle,
+        &source);
+}
+
+void ReleaseBufferLocked() noexcept {
+    if (g_Buffer != nullptr) {
+        fclmusa::memory::Free(g_Buffer);
+    }
+    g_Buffer = nullptr;
+    g_Capacity = 0;
+    g_HasTrace = FALSE;
+    InterlockedExchange64(&g_WriteOffset, 0);
+    InterlockedExchange64(&g_FirstDropOffset, kNoDrop);
+    InterlockedExchange64(&g_RecordCount, 0);
+    InterlockedExchange64(&g_DroppedRecords, 0);
+}
+
+// 清除录制标志并等待进行中的写入结束，随后补全文件头。
+void StopLocked() noexcept {
+    InterlockedExchange(&g_Recording, 0);
+    WaitForWriters();
+
+    auto* header = reinterpret_cast<FCL_WORKLOAD_TRACE_HEADER*>(g_Buffer);
+    const ULONGLONG traceBytes = ValidTraceBytes();
+    ULONGLONG recordCount = 0;
+    for (ULONGLONG offset = sizeof(FCL_WORKLOAD_TRACE_HEADER); offset < traceBytes;) {
+        offset += reinterpret_cast<const FCL_WORKLOAD_RECORD_HEADER*>(g_Buffer + offset)->Size;
+        ++recordCount;
+    }
+    // 首次丢弃之后仍放得下的记录不在有效前缀内，同样计为丢弃。
+    const ULONGLONG reserved = static_cast<ULONGLONG>(InterlockedCompareExchange64(&g_RecordCount, 0, 0));
+    header->RecordCount = recordCount;
+    header->DroppedRecords =
+        static_cast<ULONGLONG>(InterlockedCompareExchange64(&g_DroppedRecords, 0, 0)) + (reserved - recordCount);
+    header->TraceBytes = traceBytes;
+    InterlockedExchange64(&g_RecordCount, static_cast<LONG64>(header->RecordCount));
+    InterlockedExchange64(&g_DroppedRecords, static_cast<LONG64>(header->DroppedRecords));
+    g_HasTrace = TRUE;
+}
+
+}  // namespace
+
+namespace fclmusa::diagnostics {
+
+bool IsWorkloadRecording() noexcept {
+    return g_Recording != 0;
+}
+
+ULONGLONG WorkloadTimestamp() noexcept {
+    return static_cast<ULONGLONG>(KeQueryPerformanceCounter(nullptr).QuadPart);
+}
+
+void RecordGeometryCreate(
+    _In_ ULONGLONG start,
+    _In_ FCL_GEOMETRY_TYPE type,
+    _In_opt_ const VOID* geometryDesc,
+    _In_ FCL_GEOMETRY_HANDLE handle,
+    _In_ NTSTATUS status) noexcept {
+    const ULONGLONG end = WorkloadTimestamp();
+    WriterScope writer;
+    if (!writer.Active()) {
+        return;
+    }
+    GeometrySource source;
+    if (!NT_SUCCESS(status) || !SourceFromDesc(type, geometryDesc, &source)) {
+        WriteGeometryRecord(FCL_WORKLOAD_RECORD_GEOMETRY, 0, start, end, status, FCL_GEOMETRY_HANDLE{}, nullptr);
+        return;
+    }
+    WriteGeometryRecord(FCL_WORKLOAD_RECORD_GEOMETRY, 0, start, end, status, handle, &source);
+}
+
+void RecordGeometryDestroy(_In_ ULONGLONG start, _In_ FCL_GEOMETRY_HANDLE handle, _In_ NTSTATUS status) noexcept {
+    const ULONGLONG end = WorkloadTimestamp();
+    WriterScope writer;
+    if (!writer.Active()) {
+        return;
+    }
+    auto* record = BeginRecord<FCL_WORKLOAD_DESTROY_RECORD>(FCL_WORKLOAD_RECORD_DESTROY, 0, 0, start, end, status);
+    if (record != nullptr) {
+        record->Handle = handle;
+    }
+}
+
+void RecordMeshUpdate(
+    _In_ ULONGLONG start,
+    _In_ FCL_GEOMETRY_HANDLE handle,
+    _In_opt_ const FCL_MESH_GEOMETRY_DESC* geometryDesc,
+    _In_ NTSTATUS status) noexcept {
+    const ULONGLONG end = WorkloadTimestamp();
+    WriterScope writer;
+    if (!writer.Active()) {
+        return;
+    }
+    GeometrySource source;
+    const bool hasPayload = NT_SUCCESS(status) && SourceFromDesc(FCL_GEOMETRY_MESH, geometryDesc, &source);
+    WriteGeometryRecord(FCL_WORKLOAD_RECORD_UPDATE_MESH, 0, start, end, status, handle, hasPayload ? &source : nullptr);
+}
+
+void RecordCollision(
+    _In_ ULONGLONG start,
+    _In_ FCL_GEOMETRY_HANDLE object1,
+    _In_opt_ const FCL_TRANSFORM* transform1,
+    _In_ FCL_GEOMETRY_HANDLE object2,
+    _In_opt_ const FCL_TRANSFORM* transform2,
+    _In_ BOOLEAN intersecting,
+    _In_ NTSTATUS status) noexcept {
+    WritePairRecord(
+        FCL_WORKLOAD_RECORD_COLLISION, start, object1, transform1, object2, transform2, intersecting, 0.0f, status);
+}
+
+void RecordDistance(
+    _In_ ULONGLONG start,
+    _In_ FCL_GEOMETRY_HANDLE object1,
+    _In_opt_ const FCL_TRANSFORM* transform1,
+    _In_ FCL_GEOMETRY_HANDLE object2,
+    _In_opt_ const FCL_TRANSFORM* transform2,
+    _In_ float distance,
+    _In_ NTSTATUS status) noexcept {
+    WritePairRecord(
+        FCL_WORKLOAD_RECORD_DISTANCE, start, object1, transform1, object2, transform2, FALSE, distance, status);
+}
+
+void RecordCompoundCollision(
+    _In_ ULONGLONG start,
+    _In_ FCL_GEOMETRY_HANDLE object1,
+    _In_opt_ const FCL_TRANSFORM* transform1,
+    _In_ FCL_GEOMETRY_HANDLE object2,
+    _In_opt_ const FCL_TRANSFORM* transform2,
+    _In_ BOOLEAN intersecting,
+    _In_ NTSTATUS status) noexcept {
+    WritePairRecord(FCL_WORKLOAD_RECORD_COMPOUND_COLLISION,
+        start,
+        object1,
+        transform1,
+        object2,
+        transform2,
+        intersecting,
+        0.0f,
+        status);
+}
+
+void RecordCompoundDistance(
+    _In_ ULONGLONG start,
+    _In_ FCL_GEOMETRY_HANDLE object1,
+    _In_opt_ const FCL_TRANSFORM* transform1,
+    _In_ FCL_GEOMETRY_HANDLE object2,
+    _In_opt_ const FCL_TRANSFORM* transform2,
+    _In_ float distance,
+    _In_ NTSTATUS status) noexcept {
+    WritePairRecord(FCL_WORKLOAD_RECORD_COMPOUND_DISTANCE,
+        start,
+        object1,
+        transform1,
+        object2,
+        transform2,
+        FALSE,
+        distance,
+        status);
+}
+
+void RecordCollideObjects(
+    _In_ ULONGLONG start,
+    _In_ const FCL_COLLISION_OBJECT_DESC* object1,
+    _In_ const FCL_COLLISION_OBJECT_DESC* object2,
+    _In_opt_ const FCL_COLLISION_QUERY_REQUEST* request,
+    _In_ const FCL_COLLISION_QUERY_RESULT* result,
+    _In_ NTSTATUS status) noexcept {
+    const ULONGLONG end = WorkloadTimestamp();
+    WriterScope writer;
+    if (!writer.Active()) {
+        return;
+    }
+    auto* record = BeginRecord<FCL_WORKLOAD_COLLIDE_OBJECTS_RECORD>(
+        FCL_WORKLOAD_RECORD_COLLIDE_OBJECTS, 0, 0, start, end, status);
+    if (record == nullptr) {
+        return;
+    }
+    record->Object1 = *object1;
+    record->Object2 = *object2;
+    if (request != nullptr) {
+        record->Flags |= FCL_WORKLOAD_COLLIDE_FLAG_REQUEST;
+        if (request->Contacts != nullptr) {
+            record->Flags |= FCL_WORKLOAD_COLLIDE_FLAG_CONTACT_ARRAY;
+        }
+        record->MaxContacts = request->MaxContacts;
+        record->EnableContactInfo = request->EnableContactInfo;
+        record->Solver = request->Solver;
+    }
+    if (NT_SUCCESS(status)) {
+        record->Intersecting = result->Intersecting;
+        record->ContactCount = result->ContactCount;
+    }
+}
+
+void RecordContinuousCollision(
+    _In_ ULONGLONG start,
+    _In_ const FCL_CONTINUOUS_COLLISION_QUERY* query,
+    _In_ const FCL_CONTINUOUS_COLLISION_RESULT* result,
+    _In_ NTSTATUS status) noexcept {
+    const ULONGLONG end = WorkloadTimestamp();
+    WriterScope writer;
+    if (!writer.Active()) {
+        return;
+    }
+    auto* record = BeginRecord<FCL_WORKLOAD_CCD_RECORD>(
+        FCL_WORKLOAD_RECORD_CONTINUOUS_COLLISION, 0, 0, start, end, status);
+    if (record == nullptr) {
+        return;
+    }
+    record->Query = *query;
+    if (NT_SUCCESS(status)) {
+        record->TimeOfImpact = result->TimeOfImpact;
+        record->Intersecting = result->Intersecting;
+    }
+}
+
+void RecordScrewContinuousCollision(
+    _In_ ULONGLONG start,
+    _In_ const FCL_SCREW_CONTINUOUS_COLLISION_QUERY* query,
+    _In_ const FCL_CONTINUOUS_COLLISION_RESULT* result,
+    _In_ NTSTATUS status) noexcept {
+    const ULONGLONG end = WorkloadTimestamp();
+    WriterScope writer;
+    if (!writer.Active()) {
+        return;
+    }
+    auto* record = BeginRecord<FCL_WORKLOAD_SCREW_CCD_RECORD>(
+        FCL_WORKLOAD_RECORD_SCREW_CONTINUOUS_COLLISION, 0, 0, start, end, status);
+    if (record == nullptr) {
+        return;
+    }
+    record->Query = *query;
+    if (NT_SUCCESS(status)) {
+        record->TimeOfImpact = result->TimeOfImpact;
+        record->Intersecting = result->Intersecting;
+    }
+}
+
+void RecordContinuousBatch(
+    _In_ ULONGLONG start,
+    _In_ const FCL_CONTINUOUS_BATCH_QUERY* query,
+    _In_ BOOLEAN hasPerObjectHits,
+    _In_ const FCL_CONTINUOUS_BATCH_RESULT* result,
+    _In_ NTSTATUS status) noexcept {
+    const ULONGLONG end = WorkloadTimestamp();
+    WriterScope writer;
+    if (!writer.Active()) {
+        return;
+    }
+    auto* record = BeginRecord<FCL_WORKLOAD_CCD_BATCH_RECORD>(FCL_WORKLOAD_RECORD_CONTINUOUS_BATCH,
+        0,
+        static_cast<ULONGLONG>(query->ObjectCount) * sizeof(FCL_CONTINUOUS_BATCH_OBJECT),
+        start,
+        end,
+        status);
+    if (record == nullptr) {
+        return;
+    }
+    record->Tolerance = query->Tolerance;
+    record->ObjectCount = query->ObjectCount;
+    record->MaxIterations = query->MaxIterations;
+    record->Solver = static_cast<ULONG>(query->Solver);
+    record->HasPerObjectHits = hasPerObjectHits ? 1 : 0;
+    record->Object1 = FCL_CONTINUOUS_BATCH_NO_HIT;
+    record->Object2 = FCL_CONTINUOUS_BATCH_NO_HIT;
+    if (NT_SUCCESS(status)) {
+        record->Object1 = result->Object1;
+        record->Object2 = result->Object2;
+        record->TimeOfImpact = result->Earliest.TimeOfImpact;
+        record->CandidatePairCount = result->CandidatePairCount;
+        record->HitPairCount = result->HitPairCount;
+    }
+    auto* recorded = reinterpret_cast<FCL_CONTINUOUS_BATCH_OBJECT*>(record + 1);
+    for (ULONG i = 0; i < query->ObjectCount; ++i) {
+        recorded[i] = query->Objects[i];
+    }
+}
+
+void RecordBroadphase(
+    _In_ ULONGLONG start,
+    _In_reads_(objectCount) const FCL_BROADPHASE_OBJECT* objects,
+    _In_ ULONG objectCount,
+    _In_ ULONG pairCapacity,
+    _In_ ULONG pairCount,
+    _In_ NTSTATUS status) noexcept {
+    const ULONGLONG end = WorkloadTimestamp();
+    WriterScope writer;
+    if (!writer.Active()) {
+        return;
+    }
+    auto* record = BeginRecord<FCL_WORKLOAD_BROADPHASE_RECORD>(FCL_WORKLOAD_RECORD_BROADPHASE,
+        0,
+        static_cast<ULONGLONG>(objectCount) * sizeof(FCL_WORKLOAD_BROADPHASE_OBJECT),
+        start,
+        end,
+        status);
+    if (record == nullptr) {
+        return;
+    }
+    record->ObjectCount = objectCount;
+    record->PairCapacity = pairCapacity;
+    record->PairCount = pairCount;
+    auto* recorded = reinterpret_cast<FCL_WORKLOAD_BROADPHASE_OBJECT*>(record + 1);
+    for (ULONG i = 0; i < objectCount; ++i) {
+        recorded[i] = {};
+        recorded[i].Handle = objects[i].Handle;
+        if (objects[i].Transform != nullptr) {
+            recorded[i].HasTransform = 1;
+            recorded[i].Transform = *objects[i].Transform;
+        }
+    }
+}
+
+}  // namespace fclmusa::diagnostics
+
+extern "C"
+NTSTATUS
+FclStartWorkloadRecording(
+    _In_opt_ const FCL_WORKLOAD_RECORDING_CONFIG* config) noexcept {
+    if (KeGetCurrentIrql() != PASSIVE_LEVEL) {
+        return STATUS_INVALID_DEVICE_STATE;
+    }
+    const ULONG capacity = (config != nullptr && config->CapacityBytes != 0) ? config->CapacityBytes
+                                                                             : FCL_WORKLOAD_RECORDING_DEFAULT_CAPACITY;
+    const ULONG flags = (config != nullptr) ? config->Flags : 0;
+    if (capacity < kMinimumCapacity || capacity > FCL_WORKLOAD_RECORDING_MAX_CAPACITY) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    LockControl(true);
+    if (g_Recording != 0) {
+        UnlockControl(true);
+        return STATUS_DEVICE_BUSY;
+    }
+    ReleaseBufferLocked();
+    g_Buffer = static_cast<UCHAR*>(fclmusa::memory::Allocate(capacity));
+    if (g_Buffer == nullptr) {
+        UnlockControl(true);
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+    g_Capacity = capacity;
+
+    LARGE_INTEGER frequency = {};
+    g_StartTicks = static_cast<ULONGLONG>(KeQueryPerformanceCounter(&frequency).QuadPart);
+    auto* header = reinterpret_cast<FCL_WORKLOAD_TRACE_HEADER*>(g_Buffer);
+    RtlZeroMemory(header, sizeof(*header));
+    header->Magic = FCL_WORKLOAD_TRACE_MAGIC;
+    header->Version = FCL_WORKLOAD_TRACE_VERSION;
+    header->HeaderSize = sizeof(FCL_WORKLOAD_TRACE_HEADER);
+    header->TimestampFrequency = static_cast<ULONGLONG>(frequency.QuadPart);
+    InterlockedExchange64(&g_WriteOffset, sizeof(FCL_WORKLOAD_TRACE_HEADER));
+    InterlockedExchange(&g_Recording, 1);
+    UnlockControl(true);
+
+    // 先开启录制再枚举：枚举期间新建的几何要么已在表中，要么由创建入口记录，不会遗漏。
+    if ((flags & FCL_WORKLOAD_RECORDING_FLAG_SKIP_EXISTING) == 0) {
+        (void)FclEnumerateGeometries(&RecordExistingGeometry, nullptr);
+    }
+    return STATUS_SUCCESS;
+}
+
+extern "C"
+NTSTATUS
+FclStopWorkloadRecording() noexcept {
+    if (KeGetCurrentIrql() != PASSIVE_LEVEL) {
+        return STATUS_INVALID_DEVICE_STATE;
+    }
+    LockControl(true);
+    if (g_Recording == 0) {
+        UnlockControl(true);
+        return STATUS_INVALID_DEVICE_STATE;
+    }
+    StopLocked();
+    UnlockControl(true);
+    return STATUS_SUCCESS;
+}
+
+extern "C"
+VOID
+FclQueryWorkloadRecording(
+    _Out_ PFCL_WORKLOAD_RECORDING_STATUS status) noexcept {
+    if (status == nullptr) {
+        return;
+    }
+    RtlZeroMemory(status, sizeof(*status));
+    status->Recording = (g_Recording != 0) ? TRUE : FALSE;
+    status->HasTrace = g_HasTrace;
+    status->CapacityBytes = g_Capacity;
+    status->TraceBytes = (g_Buffer != nullptr) ? ValidTraceBytes() : 0;
+    status->RecordCount = static_cast<ULONGLONG>(InterlockedCompareExchange64(&g_RecordCount, 0, 0));
+    status->DroppedRecords = static_cast<ULONGLONG>(InterlockedCompareExchange64(&g_DroppedRecords, 0, 0));
+}
+
+extern "C"
+NTSTATUS
+FclReadWorkloadRecording(
+    _In_ ULONGLONG offset,
+    _Out_writes_bytes_to_(bufferSize, *bytesRead) PVOID buffer,
+    _In_ ULONG bufferSize,
+    _Out_ PULONG bytesRead) noexcept {
+    if (bytesRead == nullptr || (buffer == nullptr && bufferSize != 0)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    *bytesRead = 0;
+    if (KeGetCurrentIrql() != PASSIVE_LEVEL) {
+        return STATUS_INVALID_DEVICE_STATE;
+    }
+
+    LockControl(false);
+    if (g_Recording != 0 || !g_HasTrace) {
+        UnlockControl(false);
+        return STATUS_INVALID_DEVICE_STATE;
+    }
+    const ULONGLONG traceBytes = reinterpret_cast<const FCL_WORKLOAD_TRACE_HEADER*>(g_Buffer)->TraceBytes;
+    if (offset < traceBytes) {
+        const ULONGLONG remaining = traceBytes - offset;
+        const ULONG copyBytes = (remaining < bufferSize) ? static_cast<ULONG>(remaining) : bufferSize;
+        RtlCopyMemory(buffer, g_Buffer + offset, copyBytes);
+        *bytesRead = copyBytes;
+    }
+    UnlockControl(false);
+    return STATUS_SUCCESS;
+}
+
+extern "C"
+VOID
+FclDiscardWorkloadRecording() noexcept {
+    if (KeGetCurrentIrql() != PASSIVE_LEVEL) {
+        return;
+    }
+    LockControl(true);
+    if (g_Recording != 0) {
+        InterlockedExchange(&g_Recording, 0);
+        WaitForWriters();
+    }
+    ReleaseBufferLocked();
+    UnlockControl(true);
+}
@@ -1,31 +1,19 @@
 #include "fclmusa/platform.h"
 
 #include "fclmusa/distance.h"
+#include "fclmusa/diagnostics/latency_histogram.h"
+#include "fclmusa/diagnostics/workload_recorder.h"
 #include "fclmusa/driver.h"
 #include "fclmusa/geometry/math_utils.h"
-#include "fclmusa/upstream/upstream_bridge.h"
+#include "fclmusa/narrowphase/coherence_cache.h"
+#include "fclmusa/narrowphase/compound_dispatch.h"
+#include "fclmusa/narrowphase/query_dispatch.h"
+#include "fclmusa/narrowphase/solver_options.h"
 
 namespace {
 
 using namespace fclmusa::geom;
 
-ULONGLONG QueryTimeMicroseconds() noexcept {
-    LARGE_INTEGER frequency = {};
-    const LARGE_INTEGER counter = KeQueryPerformanceCounter(&frequency);
-    if (frequency.QuadPart == 0) {
-        return 0;
-    }
-    const LONGLONG ticks = counter.QuadPart;
-    const ULONGLONG absoluteTicks = (ticks >= 0)
-        ? static_cast<ULONGLONG>(ticks)
-        : static_cast<ULONGLONG>(-ticks);
-    return (absoluteTicks * 1'000'000ULL) / static_cast<ULONGLONG>(frequency.QuadPart);
-}
-
-ULONGLONG AbsoluteDifference(ULONGLONG a, ULONGLONG b) noexcept {
-    return (a > b) ? (a - b) : (b - a);
-}
-
 struct DistanceObject {
     FCL_GEOMETRY_REFERENCE Reference = {};
     FCL_GEOMETRY_SNAPSHOT Snapshot = {};
@@ -54,6 +42,51 @@ NTSTATUS InitializeDistanceObject(
     return FclAcquireGeometryReference(handle, &object->Reference, &object->Snapshot);
 }
 
+FCL_DISTANCE_REQUEST DefaultDistanceRequest() noexcept {
+    FCL_DISTANCE_REQUEST request = {};
+    return request;
+}
+
+bool IsValidDistanceRequest(const FCL_DISTANCE_REQUEST& request) noexcept {
+    return IsFiniteFloat(request.DistanceThreshold) &&
+           IsFiniteFloat(request.RelativeError) && request.RelativeError >= 0.0f &&
+           IsFiniteFloat(request.AbsoluteError) && request.AbsoluteError >= 0.0f &&
+           (request.Flags & ~FCL_DISTANCE_FLAG_SKIP_NEAREST_POINTS) == 0 &&
+           fclmusa::narrowphase::IsValidSolverOptions(request.Solver);
+}
+
+void RecordDistanceDuration(
+    const fclmusa::diagnostics::LatencyStopwatch& stopwatch,
+    const FCL_GEOMETRY_SNAPSHOT& object1,
+    const FCL_GEOMETRY_SNAPSHOT& object2) noexcept {
+    FclDiagnosticsRecordDistanceDuration(object1.Type, object2.Type, stopwatch.ElapsedNanoseconds());
+}
+
+// 把本次结果写回相干性缓存：仅有距离（无最近点）时退化为记录分离轴。
+void RecordCoherence(
+    const fclmusa::narrowphase::CoherenceKey& key,
+    const DistanceObject& objectA,
+    const DistanceObject& objectB,
+    const FCL_DISTANCE_QUERY_RESULT& result) noexcept {
+    if (result.NearestPointsValid) {
+        fclmusa::narrowphase::CoherenceCacheRecordDistance(
+            key,
+            objectA.Snapshot,
+            objectA.Transform,
+            objectB.Snapshot,
+            objectB.Transform,
+            result.Result);
+        return;
+    }
+    fclmusa::narrowphase::CoherenceCacheRecordCollision(
+        key,
+        objectA.Snapshot,
+        objectA.Transform,
+        objectB.Snapshot,
+        objectB.Transform,
+        (!result.BeyondThreshold && result.Result.Distance <= 0.0f) ? TRUE : FALSE);
+}
+
 }  // namespace
 
 extern "C"
@@ -68,25 +101,69 @@ FclDistanceCoreFromSnapshots(
         return STATUS_INVALID_PARAMETER;
     }
 
-    const ULONGLONG start = QueryTimeMicroseconds();
-    NTSTATUS status = FclUpstreamDistance(
+    const fclmusa::diagnostics::LatencyStopwatch stopwatch;
+    NTSTATUS status = fclmusa::narrowphase::DispatchDistance(
         *object1,
         *transform1,
         *object2,
         *transform2,
         result);
-    const ULONGLONG end = QueryTimeMicroseconds();
+    if (NT_SUCCESS(status)) {
+        RecordDistanceDuration(stopwatch, *object1, *object2);
+    }
 
-    if (NT_SUCCESS(status) && start != 0 && end != 0) {
-        const ULONGLONG elapsed = AbsoluteDifference(end, start);
-        if (elapsed != 0) {
-            FclDiagnosticsRecordDistanceDuration(elapsed);
-        }
+    return status;
+}
+
+namespace {
+
+NTSTATUS DistanceHandles(
+    FCL_GEOMETRY_HANDLE object1,
+    _In_opt_ const FCL_TRANSFORM* transform1,
+    FCL_GEOMETRY_HANDLE object2,
+    _In_opt_ const FCL_TRANSFORM* transform2,
+    _Out_ PFCL_DISTANCE_RESULT result) noexcept {
+    if (result == nullptr) {
+        return STATUS_INVALID_PARAMETER;
     }
 
+    if (KeGetCurrentIrql() != PASSIVE_LEVEL) {
+        return STATUS_INVALID_DEVICE_STATE;
+    }
+
+    DistanceObject objectA;
+    NTSTATUS status = InitializeDistanceObject(object1, transform1, &objectA);
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+
+    DistanceObject objectB;
+    status = InitializeDistanceObject(object2, transform2, &objectB);
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+
+    status = FclDistanceCoreFromSnapshots(
+        &objectA.Snapshot,
+        &objectA.Transform,
+        &objectB.Snapshot,
+        &objectB.Transform,
+        result);
+    if (NT_SUCCESS(status)) {
+        const fclmusa::narrowphase::CoherenceKey key = {object1.Value, object2.Value};
+        fclmusa::narrowphase::CoherenceCacheRecordDistance(
+            key,
+            objectA.Snapshot,
+            objectA.Transform,
+            objectB.Snapshot,
+            objectB.Transform,
+            *result);
+    }
     return status;
 }
 
+}  // namespace
+
 extern "C"
 NTSTATUS
 FclDistanceCompute(
@@ -95,6 +172,134 @@ FclDistanceCompute(
     _In_ FCL_GEOMETRY_HANDLE object2,
     _In_opt_ const FCL_TRANSFORM* transform2,
     _Out_ PFCL_DISTANCE_RESULT result) noexcept {
+    if (!fclmusa::diagnostics::IsWorkloadRecording()) {
+        return DistanceHandles(object1, transform1, object2, transform2, result);
+    }
+    const ULONGLONG start = fclmusa::diagnostics::WorkloadTimestamp();
+    const NTSTATUS status = DistanceHandles(object1, transform1, object2, transform2, result);
+    fclmusa::diagnostics::RecordDistance(start,
+        object1,
+        transform1,
+        object2,
+        transform2,
+        (NT_SUCCESS(status) && result != nullptr) ? result->Distance : 0.0f,
+        status);
+    return status;
+}
+
+namespace {
+
+NTSTATUS CompoundDistanceHandles(
+    _In_ FCL_GEOMETRY_HANDLE object1,
+    _In_opt_ const FCL_TRANSFORM* transform1,
+    _In_ FCL_GEOMETRY_HANDLE object2,
+    _In_opt_ const FCL_TRANSFORM* transform2,
+    _Out_ PFCL_DISTANCE_RESULT result,
+    _Out_ PFCL_COMPOUND_CHILD_PAIR children) noexcept {
+    if (result == nullptr || children == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    children->Child1 = FCL_COMPOUND_NO_CHILD;
+    children->Child2 = FCL_COMPOUND_NO_CHILD;
+
+    if (KeGetCurrentIrql() != PASSIVE_LEVEL) {
+        return STATUS_INVALID_DEVICE_STATE;
+    }
+
+    DistanceObject objectA;
+    NTSTATUS status = InitializeDistanceObject(object1, transform1, &objectA);
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+
+    DistanceObject objectB;
+    status = InitializeDistanceObject(object2, transform2, &objectB);
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+
+    const fclmusa::diagnostics::LatencyStopwatch stopwatch;
+    status = fclmusa::narrowphase::CompoundDistance(
+        objectA.Snapshot,
+        objectA.Transform,
+        objectB.Snapshot,
+        objectB.Transform,
+        result,
+        nullptr,
+        children);
+    if (NT_SUCCESS(status)) {
+        RecordDistanceDuration(stopwatch, objectA.Snapshot, objectB.Snapshot);
+    }
+    return status;
+}
+
+}  // namespace
+
+extern "C"
+NTSTATUS
+FclCompoundDistanceCompute(
+    _In_ FCL_GEOMETRY_HANDLE object1,
+    _In_opt_ const FCL_TRANSFORM* transform1,
+    _In_ FCL_GEOMETRY_HANDLE object2,
+    _In_opt_ const FCL_TRANSFORM* transform2,
+    _Out_ PFCL_DISTANCE_RESULT result,
+    _Out_ PFCL_COMPOUND_CHILD_PAIR children) noexcept {
+    if (!fclmusa::diagnostics::IsWorkloadRecording()) {
+        return CompoundDistanceHandles(object1, transform1, object2, transform2, result, children);
+    }
+    const ULONGLONG start = fclmusa::diagnostics::WorkloadTimestamp();
+    const NTSTATUS status = CompoundDistanceHandles(object1, transform1, object2, transform2, result, children);
+    fclmusa::diagnostics::RecordCompoundDistance(start,
+        object1,
+        transform1,
+        object2,
+        transform2,
+        (NT_SUCCESS(status) && result != nullptr) ? result->Distance : 0.0f,
+        status);
+    return status;
+}
+
+extern "C"
+NTSTATUS
+FclDistanceQueryCoreFromSnapshots(
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object1,
+    _In_ const FCL_TRANSFORM* transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object2,
+    _In_ const FCL_TRANSFORM* transform2,
+    _In_opt_ const FCL_DISTANCE_REQUEST* request,
+    _Out_ PFCL_DISTANCE_QUERY_RESULT result) noexcept {
+    if (result == nullptr || object1 == nullptr || object2 == nullptr || transform1 == nullptr || transform2 == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    const FCL_DISTANCE_REQUEST resolved = (request != nullptr) ? *request : DefaultDistanceRequest();
+    if (!IsValidDistanceRequest(resolved)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    const fclmusa::diagnostics::LatencyStopwatch stopwatch;
+    const NTSTATUS status = fclmusa::narrowphase::DispatchDistance(
+        *object1,
+        *transform1,
+        *object2,
+        *transform2,
+        resolved,
+        result);
+    if (NT_SUCCESS(status)) {
+        RecordDistanceDuration(stopwatch, *object1, *object2);
+    }
+    return status;
+}
+
+extern "C"
+NTSTATUS
+FclDistanceQuery(
+    _In_ FCL_GEOMETRY_HANDLE object1,
+    _In_opt_ const FCL_TRANSFORM* transform1,
+    _In_ FCL_GEOMETRY_HANDLE object2,
+    _In_opt_ const FCL_TRANSFORM* transform2,
+    _In_opt_ const FCL_DISTANCE_REQUEST* request,
+    _Out_ PFCL_DISTANCE_QUERY_RESULT result) noexcept {
     if (result == nullptr) {
         return STATUS_INVALID_PARAMETER;
     }
@@ -103,6 +308,11 @@ FclDistanceCompute(
         return STATUS_INVALID_DEVICE_STATE;
     }
 
+    const FCL_DISTANCE_REQUEST resolved = (request != nullptr) ? *request : DefaultDistanceRequest();
+    if (!IsValidDistanceRequest(resolved)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
     DistanceObject objectA;
     NTSTATUS status = InitializeDistanceObject(object1, transform1, &objectA);
     if (!NT_SUCCESS(status)) {
@@ -115,10 +325,53 @@ FclDistanceCompute(
         return status;
     }
 
-    return FclDistanceCoreFromSnapshots(
+    // 缓存的分离轴只需两次投影，间隙已超过阈值时连包围体搜索都可省去；
+    // 缓存的最近点给出上界，与下界之差满足请求误差时直接作为结果。
+    const fclmusa::narrowphase::CoherenceKey key = {object1.Value, object2.Value};
+    {
+        const fclmusa::diagnostics::LatencyStopwatch stopwatch;
+        const bool hasThreshold = resolved.DistanceThreshold > 0.0f;
+        fclmusa::narrowphase::CoherenceDistanceBound bound = {};
+        if (fclmusa::narrowphase::CoherenceCacheQueryDistanceBound(
+                key,
+                objectA.Snapshot,
+                objectA.Transform,
+                objectB.Snapshot,
+                objectB.Transform,
+                resolved.AbsoluteError,
+                resolved.RelativeError,
+                &bound)) {
+            if (hasThreshold && bound.LowerBound >= resolved.DistanceThreshold) {
+                RtlZeroMemory(result, sizeof(*result));
+                result->Result.Distance = bound.LowerBound;
+                result->BeyondThreshold = TRUE;
+                RecordDistanceDuration(stopwatch, objectA.Snapshot, objectB.Snapshot);
+                return STATUS_SUCCESS;
+            }
+            if (bound.WithinError && (!hasThreshold || bound.UpperBound.Distance < resolved.DistanceThreshold)) {
+                RtlZeroMemory(result, sizeof(*result));
+                result->Result = bound.UpperBound;
+                if ((resolved.Flags & FCL_DISTANCE_FLAG_SKIP_NEAREST_POINTS) != 0) {
+                    result->Result.ClosestPoint1 = {};
+                    result->Result.ClosestPoint2 = {};
+                } else {
+                    result->NearestPointsValid = TRUE;
+                }
+                RecordDistanceDuration(stopwatch, objectA.Snapshot, objectB.Snapshot);
+                return STATUS_SUCCESS;
+            }
+        }
+    }
+
+    status = FclDistanceQueryCoreFromSnapshots(
         &objectA.Snapshot,
         &objectA.Transform,
         &objectB.Snapshot,
         &objectB.Transform,
+        &resolved,
         result);
+    if (NT_SUCCESS(status)) {
+        RecordCoherence(key, objectA, objectB, *result);
+    }
+    return status;
 }
@@ -0,0 +1,358 @@
+#include "fclmusa/platform.h"
+
+#include <float.h>
+
+#include "fclmusa/geometry/bvh_model.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/point_query.h"
+
+namespace {
+
+using namespace fclmusa::geom;
+
+constexpr ULONG kTraversalStackDepth = 64;
+constexpr float kPi = 3.14159265358979323846f;
+// 判定“同一最近点”的容差：相对 Mesh 尺度的绝对项 + 相对查询距离的项。
+// 单精度下距离只能分辨到若干 ulp，最近点相距 ~sqrt(2·d·ulp(d)) ≈ 1e-3·d 以内的候选无法区分，需一并计入伪法线。
+constexpr float kFeatureTolerance = 1e-5f;
+constexpr float kFeatureRelativeTolerance = 1e-3f;
+
+struct MeshView {
+    const FCL_VECTOR3* Vertices;
+    const UINT32* Indices;
+    ULONG TriangleCount;
+    const FCL_BVH_NODE* Nodes;
+    ULONG NodeCount;
+    const UINT32* Order;
+};
+
+struct NearestTriangle {
+    float DistanceSquared;
+    ULONG Triangle;
+    FCL_VECTOR3 Point;
+};
+
+float DistanceSquared(const FCL_VECTOR3& a, const FCL_VECTOR3& b) noexcept {
+    const FCL_VECTOR3 delta = Subtract(a, b);
+    return Dot(delta, delta);
+}
+
+// Ericson，《Real-Time Collision Detection》5.1.5：按 Voronoi 区域求三角形上的最近点。
+FCL_VECTOR3 ClosestPointOnTriangle(
+    const FCL_VECTOR3& p,
+    const FCL_VECTOR3& a,
+    const FCL_VECTOR3& b,
+    const FCL_VECTOR3& c) noexcept {
+    const FCL_VECTOR3 ab = Subtract(b, a);
+    const FCL_VECTOR3 ac = Subtract(c, a);
+    const FCL_VECTOR3 ap = Subtract(p, a);
+    const float d1 = Dot(ab, ap);
+    const float d2 = Dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) {
+        return a;
+    }
+
+    const FCL_VECTOR3 bp = Subtract(p, b);
+    const float d3 = Dot(ab, bp);
+    const float d4 = Dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) {
+        return b;
+    }
+
+    const float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        return Add(a, Scale(ab, d1 / (d1 - d3)));
+    }
+
+    const FCL_VECTOR3 cp = Subtract(p, c);
+    const float d5 = Dot(ab, cp);
+    const float d6 = Dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) {
+        return c;
+    }
+
+    const float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        return Add(a, Scale(ac, d2 / (d2 - d6)));
+    }
+
+    const float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        return Add(b, Scale(Subtract(c, b), (d4 - d3) / ((d4 - d3) + (d5 - d6))));
+    }
+
+    const float denominator = va + vb + vc;
+    if (denominator == 0.0f) {
+        return a;
+    }
+    const float inverse = 1.0f / denominator;
+    return Add(a, Add(Scale(ab, vb * inverse), Scale(ac, vc * inverse)));
+}
+
+// 点到 OBB 包围体距离平方：包围体距离的下界，用于剪枝。
+float VolumeDistanceSquared(const FCL_OBBRSS& volume, const FCL_VECTOR3& p) noexcept {
+    const FCL_VECTOR3 offset = Subtract(p, volume.Center);
+    const float extents[3] = {volume.Extents.X, volume.Extents.Y, volume.Extents.Z};
+    float sum = 0.0f;
+    for (int axis = 0; axis < 3; ++axis) {
+        const float excess = fabsf(Dot(offset, volume.Axis[axis])) - extents[axis];
+        if (excess > 0.0f) {
+            sum += excess * excess;
+        }
+    }
+    return sum;
+}
+
+const FCL_VECTOR3* TriangleVertex(const MeshView& mesh, ULONG triangle, int corner) noexcept {
+    return &mesh.Vertices[mesh.Indices[static_cast<size_t>(triangle) * 3 + corner]];
+}
+
+void TestTriangle(const MeshView& mesh, ULONG triangle, const FCL_VECTOR3& p, _Inout_ NearestTriangle* best) noexcept {
+    const FCL_VECTOR3 closest = ClosestPointOnTriangle(
+        p, *TriangleVertex(mesh, triangle, 0), *TriangleVertex(mesh, triangle, 1), *TriangleVertex(mesh, triangle, 2));
+    const float distanceSquared = DistanceSquared(p, closest);
+    if (distanceSquared < best->DistanceSquared) {
+        best->DistanceSquared = distanceSquared;
+        best->Triangle = triangle;
+        best->Point = closest;
+    }
+}
+
+bool IsLeaf(const FCL_BVH_NODE& node) noexcept {
+    return node.LeftChild == ULONG_MAX;
+}
+
+// 近子树优先的深度遍历，包围体下界不小于当前最优距离的子树直接剪枝。
+template <typename LeafFn>
+void TraverseWithin(const MeshView& mesh, const FCL_VECTOR3& p, const float* boundSquared, LeafFn&& visitLeaf) noexcept {
+    struct StackEntry {
+        ULONG Node;
+        float LowerBound;
+    };
+    StackEntry stack[kTraversalStackDepth];
+    ULONG depth = 0;
+    stack[depth++] = {0, VolumeDistanceSquared(mesh.Nodes[0].Volume, p)};
+
+    while (depth > 0) {
+        const StackEntry current = stack[--depth];
+        if (current.LowerBound > *boundSquared) {
+            continue;
+        }
+        const FCL_BVH_NODE& node = mesh.Nodes[current.Node];
+        if (IsLeaf(node)) {
+            for (ULONG k = 0; k < node.TriangleCount; ++k) {
+                visitLeaf(mesh.Order[node.FirstTriangle + k]);
+            }
+            continue;
+        }
+        if (depth + 2 > kTraversalStackDepth) {
+            return;
+        }
+        const float leftBound = VolumeDistanceSquared(mesh.Nodes[node.LeftChild].Volume, p);
+        const float rightBound = VolumeDistanceSquared(mesh.Nodes[node.RightChild].Volume, p);
+        if (leftBound <= rightBound) {
+            stack[depth++] = {node.RightChild, rightBound};
+            stack[depth++] = {node.LeftChild, leftBound};
+        } else {
+            stack[depth++] = {node.LeftChild, leftBound};
+            stack[depth++] = {node.RightChild, rightBound};
+        }
+    }
+}
+
+bool HasBvh(const MeshView& mesh) noexcept {
+    return mesh.NodeCount != 0 && mesh.Nodes != nullptr && mesh.Order != nullptr;
+}
+
+void FindNearest(const MeshView& mesh, const FCL_VECTOR3& p, _Inout_ NearestTriangle* best) noexcept {
+    if (!HasBvh(mesh)) {
+        for (ULONG triangle = 0; triangle < mesh.TriangleCount; ++triangle) {
+            TestTriangle(mesh, triangle, p, best);
+        }
+        return;
+    }
+    TraverseWithin(mesh, p, &best->DistanceSquared, [&](ULONG triangle) {
+        TestTriangle(mesh, triangle, p, best);
+    });
+}
+
+float CornerAngle(const FCL_VECTOR3& corner, const FCL_VECTOR3& a, const FCL_VECTOR3& b) noexcept {
+    const FCL_VECTOR3 u = Normalize(Subtract(a, corner));
+    const FCL_VECTOR3 v = Normalize(Subtract(b, corner));
+    return acosf(Clamp(Dot(u, v), -1.0f, 1.0f));
+}
+
+// 角度加权伪法线（Bærentzen & Aanæs 2005）：收集最近点相同的所有三角形，
+// 最近点为顶点时按该顶点处的内角加权，为边 / 面内部时等权。封闭流形上 Dot(p - q, n) 的符号即内外。
+FCL_VECTOR3 PseudoNormal(
+    const MeshView& mesh,
+    const FCL_VECTOR3& p,
+    const NearestTriangle& nearest,
+    float baseTolerance) noexcept {
+    FCL_VECTOR3 accumulated = {};
+    const float tolerance = baseTolerance + kFeatureRelativeTolerance * sqrtf(nearest.DistanceSquared);
+    const float toleranceSquared = tolerance * tolerance;
+    const float bound = nearest.DistanceSquared + 2.0f * tolerance * sqrtf(nearest.DistanceSquared) + toleranceSquared;
+
+    auto accumulate = [&](ULONG triangle) {
+        const FCL_VECTOR3& a = *TriangleVertex(mesh, triangle, 0);
+        const FCL_VECTOR3& b = *TriangleVertex(mesh, triangle, 1);
+        const FCL_VECTOR3& c = *TriangleVertex(mesh, triangle, 2);
+        const FCL_VECTOR3 closest = ClosestPointOnTriangle(p, a, b, c);
+        if (DistanceSquared(closest, nearest.Point) > toleranceSquared) {
+            return;
+        }
+        const FCL_VECTOR3 cross = Cross(Subtract(b, a), Subtract(c, a));
+        if (Dot(cross, cross) == 0.0f) {
+            return;
+        }
+        float weight = kPi;
+        if (DistanceSquared(a, nearest.Point) <= toleranceSquared) {
+            weight = CornerAngle(a, b, c);
+        } else if (DistanceSquared(b, nearest.Point) <= toleranceSquared) {
+            weight = CornerAngle(b, c, a);
+        } else if (DistanceSquared(c, nearest.Point) <= toleranceSquared) {
+            weight = CornerAngle(c, a, b);
+        }
+        accumulated = Add(accumulated, Scale(Normalize(cross), weight));
+    };
+
+    if (!HasBvh(mesh)) {
+        for (ULONG triangle = 0; triangle < mesh.TriangleCount; ++triangle) {
+            accumulate(triangle);
+        }
+    } else {
+        TraverseWithin(mesh, p, &bound, accumulate);
+    }
+    return accumulated;
+}
+
+bool BuildMeshView(const FCL_GEOMETRY_SNAPSHOT& object, _Out_ MeshView* mesh) noexcept {
+    mesh->Vertices = object.Data.Mesh.Vertices;
+    mesh->Indices = object.Data.Mesh.Indices;
+    mesh->TriangleCount = object.Data.Mesh.IndexCount / 3;
+    mesh->Nodes = FclBvhGetNodes(object.Data.Mesh.Bvh, &mesh->NodeCount);
+    mesh->Order = FclBvhGetTriangleOrder(object.Data.Mesh.Bvh, nullptr);
+    return mesh->Vertices != nullptr && mesh->Indices != nullptr && mesh->TriangleCount != 0;
+}
+
+float MeshScale(const MeshView& mesh) noexcept {
+    if (HasBvh(mesh)) {
+        const FCL_VECTOR3& extents = mesh.Nodes[0].Volume.Extents;
+        return fmaxf(extents.X, fmaxf(extents.Y, extents.Z));
+    }
+    float scale = 0.0f;
+    for (ULONG triangle = 0; triangle < mesh.TriangleCount; ++triangle) {
+        for (int corner = 0; corner < 3; ++corner) {
+            const FCL_VECTOR3& v = *TriangleVertex(mesh, triangle, corner);
+            scale = fmaxf(scale, fmaxf(fabsf(v.X), fmaxf(fabsf(v.Y), fabsf(v.Z))));
+        }
+    }
+    return scale;
+}
+
+}  // namespace
+
+extern "C"
+NTSTATUS
+FclMeshPointQueryCoreFromSnapshot(
+    _In_ const FCL_GEOMETRY_SNAPSHOT* mesh,
+    _In_ const FCL_TRANSFORM* transform,
+    _In_reads_(pointCount) const FCL_VECTOR3* points,
+    _In_ ULONG pointCount,
+    _In_ float maxDistance,
+    _In_ ULONG flags,
+    _Out_writes_(pointCount) PFCL_POINT_QUERY_RESULT results) noexcept {
+    if (mesh == nullptr || transform == nullptr || results == nullptr || (points == nullptr && pointCount > 0)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    if (!IsValidTransform(*transform) || !IsFiniteFloat(maxDistance)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    if (mesh->Type != FCL_GEOMETRY_MESH) {
+        return STATUS_NOT_SUPPORTED;
+    }
+
+    MeshView view = {};
+    if (!BuildMeshView(*mesh, &view)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    for (ULONG i = 0; i < pointCount; ++i) {
+        if (!IsValidVector(points[i])) {
+            return STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    const bool computeSign = (flags & FCL_POINT_QUERY_FLAG_SIGNED) != 0;
+    const float limitSquared = (maxDistance > 0.0f) ? maxDistance * maxDistance : FLT_MAX;
+    const float tolerance = kFeatureTolerance * (1.0f + MeshScale(view));
+    const FCL_MATRIX3X3 inverseRotation = TransposeMatrix(transform->Rotation);
+    ULONG previous = FCL_POINT_QUERY_NO_TRIANGLE;
+
+    for (ULONG i = 0; i < pointCount; ++i) {
+        FCL_POINT_QUERY_RESULT& result = results[i];
+        RtlZeroMemory(&result, sizeof(result));
+        result.TriangleIndex = FCL_POINT_QUERY_NO_TRIANGLE;
+
+        const FCL_VECTOR3 local = MatrixVectorMultiply(inverseRotation, Subtract(points[i], transform->Translation));
+        NearestTriangle nearest = {limitSquared, FCL_POINT_QUERY_NO_TRIANGLE, {}};
+        // 上一个点的最近三角形给出初始上界，相干点序列下大部分子树在第一层即被剪掉。
+        if (previous != FCL_POINT_QUERY_NO_TRIANGLE) {
+            TestTriangle(view, previous, local, &nearest);
+        }
+        FindNearest(view, local, &nearest);
+        if (nearest.Triangle == FCL_POINT_QUERY_NO_TRIANGLE) {
+            result.Distance = maxDistance;
+            result.SignedDistance = maxDistance;
+            continue;
+        }
+        previous = nearest.Triangle;
+
+        result.TriangleIndex = nearest.Triangle;
+        result.ClosestPoint = TransformPoint(*transform, nearest.Point);
+        result.Distance = sqrtf(nearest.DistanceSquared);
+        result.SignedDistance = result.Distance;
+        if (computeSign && result.Distance > tolerance) {
+            const FCL_VECTOR3 normal = PseudoNormal(view, local, nearest, tolerance);
+            if (Dot(Subtract(local, nearest.Point), normal) < 0.0f) {
+                result.Inside = TRUE;
+                result.SignedDistance = -result.Distance;
+            }
+        }
+    }
+    return STATUS_SUCCESS;
+}
+
+extern "C"
+NTSTATUS
+FclMeshPointQuery(
+    _In_ FCL_GEOMETRY_HANDLE mesh,
+    _In_opt_ const FCL_TRANSFORM* transform,
+    _In_reads_(pointCount) const FCL_VECTOR3* points,
+    _In_ ULONG pointCount,
+    _In_ float maxDistance,
+    _In_ ULONG flags,
+    _Out_writes_(pointCount) PFCL_POINT_QUERY_RESULT results) noexcept {
+    if (results == nullptr || (points == nullptr && pointCount > 0)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (KeGetCurrentIrql() != PASSIVE_LEVEL) {
+        return STATUS_INVALID_DEVICE_STATE;
+    }
+
+    if (!FclIsGeometryHandleValid(mesh)) {
+        return STATUS_INVALID_HANDLE;
+    }
+
+    const FCL_TRANSFORM pose = (transform != nullptr) ? *transform : IdentityTransform();
+    FCL_GEOMETRY_REFERENCE reference = {};
+    FCL_GEOMETRY_SNAPSHOT snapshot = {};
+    NTSTATUS status = FclAcquireGeometryReference(mesh, &reference, &snapshot);
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+    status = FclMeshPointQueryCoreFromSnapshot(&snapshot, &pose, points, pointCount, maxDistance, flags, results);
+    FclReleaseGeometryReference(&reference);
+    return status;
+}
@@ -1,6 +1,9 @@
 ﻿#include "fclmusa/platform.h"
 
 #include "fclmusa/driver.h"
+#include "fclmusa/diagnostics/latency_histogram.h"
+#include "fclmusa/diagnostics/phase_trace.h"
+#include "fclmusa/diagnostics/workload_recorder.h"
 #include "fclmusa/logging.h"
 #include "fclmusa/geometry.h"
 #include "fclmusa/geometry/math_utils.h"
@@ -125,6 +128,11 @@ void RecordDuration(DetectionTimingAccumulator& acc, ULONGLONG durationMicroseco
     }
 }
 
+// 汇总计时沿用微秒，不足 1 us 的查询按 1 us 计入（与此前跳过 0 us 样本相比，调用次数不再偏少）。
+ULONGLONG NanosecondsToMicroseconds(ULONGLONG durationNanoseconds) noexcept {
+    return (durationNanoseconds + 999) / 1000;
+}
+
 void SnapshotTiming(const DetectionTimingAccumulator& acc, PFCL_DETECTION_TIMING_STATS snapshot) noexcept {
     if (snapshot == nullptr) {
         return;
@@ -165,6 +173,8 @@ FclInitialize() {
 
     fclmusa::memory::InitializePoolTracking();
     ResetDetectionTimingUnsafe();
+    FclResetLatencyHistograms();
+    FclResetPhaseTrace();
 
     status = FclGeometrySubsystemInitialize();
     if (!NT_SUCCESS(status)) {
@@ -196,6 +206,7 @@ Cleanup:
 extern "C"
 VOID
 FclCleanup() {
+    FclDiscardWorkloadRecording();
     FclGeometrySubsystemShutdown();
     fclmusa::memory::ShutdownPoolTracking();
 
@@ -236,26 +247,42 @@ FclQueryHealth(_Out_ FCL_PING_RESPONSE* response) {
 
 extern "C"
 VOID
-FclDiagnosticsRecordCollisionDuration(_In_ ULONGLONG durationMicroseconds) noexcept {
-    RecordDuration(g_CollisionTiming, durationMicroseconds);
+FclDiagnosticsRecordCollisionDuration(
+    _In_ FCL_GEOMETRY_TYPE type1,
+    _In_ FCL_GEOMETRY_TYPE type2,
+    _In_ ULONGLONG durationNanoseconds) noexcept {
+    RecordDuration(g_CollisionTiming, NanosecondsToMicroseconds(durationNanoseconds));
+    fclmusa::diagnostics::RecordLatency(FCL_LATENCY_COLLISION, type1, type2, durationNanoseconds);
 }
 
 extern "C"
 VOID
-FclDiagnosticsRecordDpcCollisionDuration(_In_ ULONGLONG durationMicroseconds) noexcept {
-    RecordDuration(g_DpcCollisionTiming, durationMicroseconds);
+FclDiagnosticsRecordDpcCollisionDuration(
+    _In_ FCL_GEOMETRY_TYPE type1,
+    _In_ FCL_GEOMETRY_TYPE type2,
+    _In_ ULONGLONG durationNanoseconds) noexcept {
+    RecordDuration(g_DpcCollisionTiming, NanosecondsToMicroseconds(durationNanoseconds));
+    fclmusa::diagnostics::RecordLatency(FCL_LATENCY_DPC_COLLISION, type1, type2, durationNanoseconds);
 }
 
 extern "C"
 VOID
-FclDiagnosticsRecordDistanceDuration(_In_ ULONGLONG durationMicroseconds) noexcept {
-    RecordDuration(g_DistanceTiming, durationMicroseconds);
+FclDiagnosticsRecordDistanceDuration(
+    _In_ FCL_GEOMETRY_TYPE type1,
+    _In_ FCL_GEOMETRY_TYPE type2,
+    _In_ ULONGLONG durationNanoseconds) noexcept {
+    RecordDuration(g_DistanceTiming, NanosecondsToMicroseconds(durationNanoseconds));
+    fclmusa::diagnostics::RecordLatency(FCL_LATENCY_DISTANCE, type1, type2, durationNanoseconds);
 }
 
 extern "C"
 VOID
-FclDiagnosticsRecordContinuousCollisionDuration(_In_ ULONGLONG durationMicroseconds) noexcept {
-    RecordDuration(g_ContinuousCollisionTiming, durationMicroseconds);
+FclDiagnosticsRecordContinuousCollisionDuration(
+    _In_ FCL_GEOMETRY_TYPE type1,
+    _In_ FCL_GEOMETRY_TYPE type2,
+    _In_ ULONGLONG durationNanoseconds) noexcept {
+    RecordDuration(g_ContinuousCollisionTiming, NanosecondsToMicroseconds(durationNanoseconds));
+    fclmusa::diagnostics::RecordLatency(FCL_LATENCY_CONTINUOUS_COLLISION, type1, type2, durationNanoseconds);
 }
 
 extern "C"
@@ -5,6 +5,7 @@
 #include "fclmusa/geometry/bvh_model.h"
 
 #include <algorithm>
+#include <float.h>
 #include <new>
 #include <vector>
 
@@ -22,6 +23,8 @@ struct FCL_BVH_MODEL {
 namespace {
 
 constexpr ULONG kLeafTriangleThreshold = 4;
+// 采用外部 BVH 时允许的最大深度：查询遍历栈为 64 层，中位数划分的树远低于此值。
+constexpr ULONG kMaxAdoptedDepth = 48;
 
 struct TriangleInfo {
     FCL_OBBRSS Volume;
@@ -184,6 +187,98 @@ NTSTATUS BuildModelInternal(FCL_BVH_MODEL* model) noexcept {
     return STATUS_SUCCESS;
 }
 
+bool IsFiniteFloat(float value) noexcept {
+    return (value == value) && (value < FLT_MAX) && (value > -FLT_MAX);
+}
+
+bool IsFiniteVolume(const FCL_OBBRSS& volume) noexcept {
+    const float* values = &volume.Center.X;
+    for (size_t i = 0; i < sizeof(FCL_OBBRSS) / sizeof(float); ++i) {
+        if (!IsFiniteFloat(values[i])) {
+            return false;
+        }
+    }
+    return volume.Extents.X >= 0.0f && volume.Extents.Y >= 0.0f && volume.Extents.Z >= 0.0f && volume.Radius >= 0.0f;
+}
+
+// 外部 BVH 的结构校验：从根出发每个节点恰好到达一次（无环、无共享子树、无孤立节点），深度不超过 kMaxAdoptedDepth，
+// 叶节点的三角形区间互不重叠且覆盖全部三角形，TriangleOrder 是三角形编号的排列。包围体只检查数值有效性。
+NTSTATUS ValidateAdoptedModel(const FCL_BVH_MODEL& model) noexcept {
+    const ULONG triangleCount = model.IndexCount / 3;
+    const ULONG nodeCount = static_cast<ULONG>(model.Nodes.size());
+    if (nodeCount == 0 || static_cast<ULONGLONG>(nodeCount) > 2ull * triangleCount - 1 ||
+        model.TriangleOrder.size() != triangleCount) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    std::vector<UCHAR> visited;
+    std::vector<UCHAR> seen;
+    try {
+        visited.resize(nodeCount, 0);
+        seen.resize(triangleCount, 0);
+    } catch (const std::bad_alloc&) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    for (UINT32 triangle : model.TriangleOrder) {
+        if (triangle >= triangleCount || seen[triangle] != 0) {
+            return STATUS_INVALID_PARAMETER;
+        }
+        seen[triangle] = 1;
+    }
+    std::fill(seen.begin(), seen.end(), static_cast<UCHAR>(0));
+
+    struct StackEntry {
+        ULONG Node;
+        ULONG Depth;
+    };
+    // 每弹出一个内部节点压入两个子节点，栈深不超过树深 + 1。
+    StackEntry stack[kMaxAdoptedDepth + 2];
+    ULONG depth = 0;
+    ULONG visitedCount = 0;
+    ULONGLONG coveredTriangles = 0;
+    stack[depth++] = {0, 0};
+
+    while (depth > 0) {
+        const StackEntry current = stack[--depth];
+        if (current.Node >= nodeCount || visited[current.Node] != 0 || current.Depth > kMaxAdoptedDepth) {
+            return STATUS_INVALID_PARAMETER;
+        }
+        visited[current.Node] = 1;
+        ++visitedCount;
+
+        const FCL_BVH_NODE& node = model.Nodes[current.Node];
+        if (!IsFiniteVolume(node.Volume)) {
+            return STATUS_INVALID_PARAMETER;
+        }
+        if (node.LeftChild == ULONG_MAX) {
+            if (node.RightChild != ULONG_MAX || node.TriangleCount == 0 || node.FirstTriangle >= triangleCount ||
+                node.TriangleCount > triangleCount - node.FirstTriangle) {
+                return STATUS_INVALID_PARAMETER;
+            }
+            for (ULONG k = 0; k < node.TriangleCount; ++k) {
+                UCHAR& slot = seen[node.FirstTriangle + k];
+                if (slot != 0) {
+                    return STATUS_INVALID_PARAMETER;
+                }
+                slot = 1;
+            }
+            coveredTriangles += node.TriangleCount;
+            continue;
+        }
+        if (node.RightChild == ULONG_MAX || depth + 2 > RTL_NUMBER_OF(stack)) {
+            return STATUS_INVALID_PARAMETER;
+        }
+        stack[depth++] = {node.RightChild, current.Depth + 1};
+        stack[depth++] = {node.LeftChild, current.Depth + 1};
+    }
+
+    if (visitedCount != nodeCount || coveredTriangles != triangleCount) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    return STATUS_SUCCESS;
+}
+
 }  // namespace
 
 extern "C"
@@ -226,6 +321,59 @@ FclBuildBvhModel(
     return STATUS_SUCCESS;
 }
 
+extern "C"
+NTSTATUS
+FclAdoptBvhModel(
+    _In_reads_(vertexCount) const FCL_VECTOR3* vertices,
+    _In_ ULONG vertexCount,
+    _In_reads_(indexCount) const UINT32* indices,
+    _In_ ULONG indexCount,
+    _In_reads_(nodeCount) const FCL_BVH_NODE* nodes,
+    _In_ ULONG nodeCount,
+    _In_reads_(indexCount / 3) const UINT32* triangleOrder,
+    _Outptr_ FCL_BVH_MODEL** model) noexcept {
+    if (model == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    *model = nullptr;
+
+    if (vertices == nullptr || indices == nullptr || vertexCount == 0 || indexCount < 3 ||
+        nodes == nullptr || nodeCount == 0 || triangleOrder == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    if (!ValidateIndices(vertices, vertexCount, indices, indexCount)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    auto* instance = new (std::nothrow) FCL_BVH_MODEL();
+    if (instance == nullptr) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    instance->Vertices = vertices;
+    instance->Indices = indices;
+    instance->VertexCount = vertexCount;
+    instance->IndexCount = indexCount;
+
+    // 先复制再校验，校验结果不受调用方随后修改源数据的影响。
+    try {
+        instance->Nodes.assign(nodes, nodes + nodeCount);
+        instance->TriangleOrder.assign(triangleOrder, triangleOrder + indexCount / 3);
+    } catch (const std::bad_alloc&) {
+        delete instance;
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    const NTSTATUS status = ValidateAdoptedModel(*instance);
+    if (!NT_SUCCESS(status)) {
+        delete instance;
+        return status;
+    }
+
+    *model = instance;
+    return STATUS_SUCCESS;
+}
+
 extern "C"
 NTSTATUS
 FclBvhUpdateModel(
@@ -0,0 +1,176 @@
+﻿#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include "fclmusa/geometry/compound_model.h"
+
+#include <algorithm>
+#include <new>
+#include <vector>
+
+#include "fclmusa/narrowphase/coherence_cache.h"
+
+struct FCL_COMPOUND_MODEL {
+    std::vector<FCL_COMPOUND_CHILD> Children;
+    std::vector<FCL_COMPOUND_NODE> Nodes;
+};
+
+namespace {
+
+struct ChildBounds {
+    FCL_VECTOR3 Min;
+    FCL_VECTOR3 Max;
+    ULONG Child;
+};
+
+float Component(const FCL_VECTOR3& value, int axis) noexcept {
+    return (&value.X)[axis];
+}
+
+float CenterOnAxis(const ChildBounds& bounds, int axis) noexcept {
+    return 0.5f * (Component(bounds.Min, axis) + Component(bounds.Max, axis));
+}
+
+// 子形状在复合体局部坐标下的 AABB（与一致性缓存使用同一套投影，Mesh 取 BVH 根包围体）。
+bool ComputeChildBounds(const FCL_COMPOUND_CHILD& child, ChildBounds* bounds) noexcept {
+    const FCL_VECTOR3 axes[3] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+    for (int axis = 0; axis < 3; ++axis) {
+        if (!fclmusa::narrowphase::ProjectSnapshotOntoAxis(
+                child.Snapshot, child.LocalTransform, axes[axis], &(&bounds->Min.X)[axis], &(&bounds->Max.X)[axis])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 自顶向下按子形状中心在最长轴上的中位数二分；节点按先序存放，根节点为 0。
+ULONG BuildNode(std::vector<ChildBounds>& bounds, size_t begin, size_t end, std::vector<FCL_COMPOUND_NODE>* nodes) {
+    const ULONG index = static_cast<ULONG>(nodes->size());
+    nodes->push_back({});
+
+    FCL_COMPOUND_NODE node = {};
+    node.Min = bounds[begin].Min;
+    node.Max = bounds[begin].Max;
+    FCL_VECTOR3 centerMin = {};
+    FCL_VECTOR3 centerMax = {};
+    for (int axis = 0; axis < 3; ++axis) {
+        (&centerMin.X)[axis] = CenterOnAxis(bounds[begin], axis);
+        (&centerMax.X)[axis] = CenterOnAxis(bounds[begin], axis);
+    }
+    for (size_t i = begin + 1; i < end; ++i) {
+        for (int axis = 0; axis < 3; ++axis) {
+            (&node.Min.X)[axis] = (std::min)(Component(node.Min, axis), Component(bounds[i].Min, axis));
+            (&node.Max.X)[axis] = (std::max)(Component(node.Max, axis), Component(bounds[i].Max, axis));
+            (&centerMin.X)[axis] = (std::min)(Component(centerMin, axis), CenterOnAxis(bounds[i], axis));
+            (&centerMax.X)[axis] = (std::max)(Component(centerMax, axis), CenterOnAxis(bounds[i], axis));
+        }
+    }
+
+    if (end - begin == 1) {
+        node.Left = FCL_COMPOUND_NO_CHILD;
+        node.Right = FCL_COMPOUND_NO_CHILD;
+        node.Child = bounds[begin].Child;
+        (*nodes)[index] = node;
+        return index;
+    }
+
+    int splitAxis = 0;
+    for (int axis = 1; axis < 3; ++axis) {
+        if (Component(centerMax, axis) - Component(centerMin, axis) >
+            Component(centerMax, splitAxis) - Component(centerMin, splitAxis)) {
+            splitAxis = axis;
+        }
+    }
+    const size_t middle = begin + (end - begin) / 2;
+    std::nth_element(
+        bounds.begin() + begin,
+        bounds.begin() + middle,
+        bounds.begin() + end,
+        [splitAxis](const ChildBounds& lhs, const ChildBounds& rhs) {
+            return CenterOnAxis(lhs, splitAxis) < CenterOnAxis(rhs, splitAxis);
+        });
+
+    node.Child = FCL_COMPOUND_NO_CHILD;
+    node.Left = BuildNode(bounds, begin, middle, nodes);
+    node.Right = BuildNode(bounds, middle, end, nodes);
+    (*nodes)[index] = node;
+    return index;
+}
+
+}  // namespace
+
+extern "C"
+NTSTATUS
+FclBuildCompoundModel(
+    _In_reads_(childCount) const FCL_COMPOUND_CHILD* children,
+    _In_ ULONG childCount,
+    _Outptr_ FCL_COMPOUND_MODEL** model) noexcept {
+    if (model == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    *model = nullptr;
+
+    if (children == nullptr || childCount == 0) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    auto* instance = new (std::nothrow) FCL_COMPOUND_MODEL();
+    if (instance == nullptr) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    NTSTATUS status = STATUS_SUCCESS;
+    try {
+        std::vector<ChildBounds> bounds(childCount);
+        for (ULONG i = 0; i < childCount && NT_SUCCESS(status); ++i) {
+            bounds[i].Child = i;
+            if (!ComputeChildBounds(children[i], &bounds[i])) {
+                status = STATUS_INVALID_PARAMETER;
+            }
+        }
+        if (NT_SUCCESS(status)) {
+            instance->Children.assign(children, children + childCount);
+            instance->Nodes.reserve(static_cast<size_t>(childCount) * 2 - 1);
+            BuildNode(bounds, 0, bounds.size(), &instance->Nodes);
+        }
+    } catch (const std::bad_alloc&) {
+        status = STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    if (!NT_SUCCESS(status)) {
+        delete instance;
+        return status;
+    }
+
+    *model = instance;
+    return STATUS_SUCCESS;
+}
+
+extern "C"
+VOID
+FclDestroyCompoundModel(
+    _In_opt_ FCL_COMPOUND_MODEL* model) noexcept {
+    delete model;
+}
+
+extern "C"
+const FCL_COMPOUND_CHILD*
+FclCompoundGetChildren(
+    _In_opt_ const FCL_COMPOUND_MODEL* model,
+    _Out_opt_ ULONG* childCount) noexcept {
+    if (childCount != nullptr) {
+        *childCount = (model != nullptr) ? static_cast<ULONG>(model->Children.size()) : 0;
+    }
+    return (model != nullptr && !model->Children.empty()) ? model->Children.data() : nullptr;
+}
+
+extern "C"
+const FCL_COMPOUND_NODE*
+FclCompoundGetNodes(
+    _In_opt_ const FCL_COMPOUND_MODEL* model,
+    _Out_opt_ ULONG* nodeCount) noexcept {
+    if (nodeCount != nullptr) {
+        *nodeCount = (model != nullptr) ? static_cast<ULONG>(model->Nodes.size()) : 0;
+    }
+    return (model != nullptr && !model->Nodes.empty()) ? model->Nodes.data() : nullptr;
+}
@@ -0,0 +1,515 @@
+﻿#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include "fclmusa/geometry/convex_hull.h"
+
+#include <float.h>
+
+#include <algorithm>
+#include <new>
+#include <vector>
+
+#include "fclmusa/geometry/math_utils.h"
+
+struct FCL_CONVEX_HULL {
+    std::vector<FCL_VECTOR3> Vertices;
+    std::vector<UINT32> Indices;
+    std::vector<UINT32> NeighborOffsets;
+    std::vector<UINT32> Neighbors;
+    FCL_VECTOR3 Centroid = {};
+};
+
+namespace {
+
+// 顶点数不超过该值时线性扫描比爬山更快（邻接表访问不连续）。
+constexpr ULONG kLinearSupportThreshold = 32;
+constexpr ULONG kNoFace = ULONG_MAX;
+
+struct Point3 {
+    double X;
+    double Y;
+    double Z;
+};
+
+Point3 Sub(const Point3& a, const Point3& b) noexcept {
+    return {a.X - b.X, a.Y - b.Y, a.Z - b.Z};
+}
+
+double Dot3(const Point3& a, const Point3& b) noexcept {
+    return a.X * b.X + a.Y * b.Y + a.Z * b.Z;
+}
+
+Point3 Cross3(const Point3& a, const Point3& b) noexcept {
+    return {a.Y * b.Z - a.Z * b.Y, a.Z * b.X - a.X * b.Z, a.X * b.Y - a.Y * b.X};
+}
+
+double Length3(const Point3& a) noexcept {
+    return sqrt(Dot3(a, a));
+}
+
+// 三角面：Neighbor[i] 为跨边 (Vertex[i], Vertex[(i + 1) % 3]) 的相邻面。
+struct HullFace {
+    ULONG Vertex[3];
+    ULONG Neighbor[3];
+    Point3 Normal;
+    double Offset;
+    std::vector<ULONG> Outside;
+    bool Alive;
+    bool Visible;
+};
+
+struct HorizonEdge {
+    ULONG From;
+    ULONG To;
+    ULONG Outer;
+    ULONG NewFace;
+};
+
+// 标准 quickhull（Barber 等，1996）：每次取某个面外侧最远的点，删除其可见面，
+// 以地平线边与该点构成新面，再把被删面的外侧点重新分配给新面。
+class QuickHullBuilder {
+public:
+    QuickHullBuilder(const FCL_VECTOR3* points, ULONG pointCount) : m_Input(points), m_Count(pointCount) {}
+
+    NTSTATUS Build(FCL_CONVEX_HULL* hull) {
+        m_Points.resize(m_Count);
+        double scale = 0.0;
+        double maxAbs[3] = {};
+        for (ULONG i = 0; i < m_Count; ++i) {
+            m_Points[i] = {m_Input[i].X, m_Input[i].Y, m_Input[i].Z};
+            maxAbs[0] = std::max(maxAbs[0], fabs(m_Points[i].X));
+            maxAbs[1] = std::max(maxAbs[1], fabs(m_Points[i].Y));
+            maxAbs[2] = std::max(maxAbs[2], fabs(m_Points[i].Z));
+        }
+        scale = maxAbs[0] + maxAbs[1] + maxAbs[2];
+        // 输入为单精度：容差取单精度舍入误差量级（与 qhull 的默认估计一致）。
+        m_Epsilon = 3.0 * FLT_EPSILON * scale;
+
+        ULONG simplex[4] = {};
+        if (!FindInitialSimplex(simplex)) {
+            return STATUS_INVALID_PARAMETER;
+        }
+        BuildInitialFaces(simplex);
+        AssignInitialOutside(simplex);
+
+        for (ULONG face = 0; face < m_Faces.size(); ++face) {
+            if (!m_Faces[face].Alive || m_Faces[face].Outside.empty()) {
+                continue;
+            }
+            if (!AddPoint(face)) {
+                return STATUS_INTERNAL_ERROR;
+            }
+        }
+        return Export(hull);
+    }
+
+private:
+    double Distance(ULONG face, ULONG point) const noexcept {
+        return Dot3(m_Faces[face].Normal, m_Points[point]) - m_Faces[face].Offset;
+    }
+
+    ULONG AddFace(ULONG a, ULONG b, ULONG c) {
+        HullFace face = {};
+        face.Vertex[0] = a;
+        face.Vertex[1] = b;
+        face.Vertex[2] = c;
+        face.Neighbor[0] = face.Neighbor[1] = face.Neighbor[2] = kNoFace;
+        Point3 normal = Cross3(Sub(m_Points[b], m_Points[a]), Sub(m_Points[c], m_Points[a]));
+        const double length = Length3(normal);
+        if (length > 0.0) {
+            normal = {normal.X / length, normal.Y / length, normal.Z / length};
+        }
+        face.Normal = normal;
+        face.Offset = Dot3(normal, m_Points[a]);
+        face.Alive = true;
+        face.Visible = false;
+        m_Faces.push_back(std::move(face));
+        return static_cast<ULONG>(m_Faces.size() - 1);
+    }
+
+    bool FindInitialSimplex(ULONG simplex[4]) const noexcept {
+        ULONG extremes[6] = {};
+        for (ULONG i = 1; i < m_Count; ++i) {
+            const Point3& p = m_Points[i];
+            if (p.X < m_Points[extremes[0]].X) extremes[0] = i;
+            if (p.X > m_Points[extremes[1]].X) extremes[1] = i;
+            if (p.Y < m_Points[extremes[2]].Y) extremes[2] = i;
+            if (p.Y > m_Points[extremes[3]].Y) extremes[3] = i;
+            if (p.Z < m_Points[extremes[4]].Z) extremes[4] = i;
+            if (p.Z > m_Points[extremes[5]].Z) extremes[5] = i;
+        }
+
+        double bestLength = -1.0;
+        for (int axis = 0; axis < 3; ++axis) {
+            const double length = Length3(Sub(m_Points[extremes[axis * 2 + 1]], m_Points[extremes[axis * 2]]));
+            if (length > bestLength) {
+                bestLength = length;
+                simplex[0] = extremes[axis * 2];
+                simplex[1] = extremes[axis * 2 + 1];
+            }
+        }
+        if (bestLength <= m_Epsilon) {
+            return false;
+        }
+
+        const Point3 line = Sub(m_Points[simplex[1]], m_Points[simplex[0]]);
+        double bestArea = 0.0;
+        for (ULONG i = 0; i < m_Count; ++i) {
+            const double area = Length3(Cross3(line, Sub(m_Points[i], m_Points[simplex[0]])));
+            if (area > bestArea) {
+                bestArea = area;
+                simplex[2] = i;
+            }
+        }
+        if (bestArea / bestLength <= m_Epsilon) {
+            return false;
+        }
+
+        Point3 normal = Cross3(line, Sub(m_Points[simplex[2]], m_Points[simplex[0]]));
+        const double normalLength = Length3(normal);
+        normal = {normal.X / normalLength, normal.Y / normalLength, normal.Z / normalLength};
+        double bestHeight = 0.0;
+        for (ULONG i = 0; i < m_Count; ++i) {
+            const double height = fabs(Dot3(normal, Sub(m_Points[i], m_Points[simplex[0]])));
+            if (height > bestHeight) {
+                bestHeight = height;
+                simplex[3] = i;
+            }
+        }
+        return bestHeight > m_Epsilon;
+    }
+
+    void BuildInitialFaces(const ULONG simplex[4]) {
+        ULONG a = simplex[0];
+        ULONG b = simplex[1];
+        const ULONG c = simplex[2];
+        const ULONG d = simplex[3];
+        // 底面 (a, b, c) 的法线需背离 d。
+        const Point3 normal = Cross3(Sub(m_Points[b], m_Points[a]), Sub(m_Points[c], m_Points[a]));
+        if (Dot3(normal, Sub(m_Points[d], m_Points[a])) > 0.0) {
+            std::swap(a, b);
+        }
+        const ULONG faces[4] = {AddFace(a, b, c), AddFace(b, a, d), AddFace(c, b, d), AddFace(a, c, d)};
+        for (ULONG f : faces) {
+            for (int edge = 0; edge < 3; ++edge) {
+                const ULONG from = m_Faces[f].Vertex[edge];
+                const ULONG to = m_Faces[f].Vertex[(edge + 1) % 3];
+                for (ULONG g : faces) {
+                    if (g != f && FindEdge(g, to, from) >= 0) {
+                        m_Faces[f].Neighbor[edge] = g;
+                    }
+                }
+            }
+        }
+    }
+
+    int FindEdge(ULONG face, ULONG from, ULONG to) const noexcept {
+        for (int edge = 0; edge < 3; ++edge) {
+            if (m_Faces[face].Vertex[edge] == from && m_Faces[face].Vertex[(edge + 1) % 3] == to) {
+                return edge;
+            }
+        }
+        return -1;
+    }
+
+    // 分配到距离最远的可见面；不在任何面外侧的点位于凸包内部，直接丢弃。
+    void AssignPoint(ULONG point, const ULONG* faces, ULONG faceCount) {
+        double best = m_Epsilon;
+        ULONG target = kNoFace;
+        for (ULONG i = 0; i < faceCount; ++i) {
+            const double distance = Distance(faces[i], point);
+            if (distance > best) {
+                best = distance;
+                target = faces[i];
+            }
+        }
+        if (target != kNoFace) {
+            m_Faces[target].Outside.push_back(point);
+        }
+    }
+
+    void AssignInitialOutside(const ULONG simplex[4]) {
+        const ULONG faces[4] = {0, 1, 2, 3};
+        for (ULONG i = 0; i < m_Count; ++i) {
+            if (i == simplex[0] || i == simplex[1] || i == simplex[2] || i == simplex[3]) {
+                continue;
+            }
+            AssignPoint(i, faces, RTL_NUMBER_OF(faces));
+        }
+    }
+
+    bool AddPoint(ULONG seedFace) {
+        ULONG eye = m_Faces[seedFace].Outside[0];
+        double farthest = Distance(seedFace, eye);
+        for (ULONG point : m_Faces[seedFace].Outside) {
+            const double distance = Distance(seedFace, point);
+            if (distance > farthest) {
+                farthest = distance;
+                eye = point;
+            }
+        }
+
+        // 从种子面出发沿邻接关系扩展可见面，保证可见区域连通、地平线为单一环。
+        m_Visible.clear();
+        m_Horizon.clear();
+        m_Faces[seedFace].Visible = true;
+        m_Visible.push_back(seedFace);
+        for (size_t cursor = 0; cursor < m_Visible.size(); ++cursor) {
+            const ULONG face = m_Visible[cursor];
+            for (int edge = 0; edge < 3; ++edge) {
+                const ULONG neighbor = m_Faces[face].Neighbor[edge];
+                if (neighbor == kNoFace) {
+                    return false;
+                }
+                if (m_Faces[neighbor].Visible) {
+                    continue;
+                }
+                if (Distance(neighbor, eye) > m_Epsilon) {
+                    m_Faces[neighbor].Visible = true;
+                    m_Visible.push_back(neighbor);
+                } else {
+                    m_Horizon.push_back({m_Faces[face].Vertex[edge], m_Faces[face].Vertex[(edge + 1) % 3], neighbor, kNoFace});
+                }
+            }
+        }
+
+        // 地平线边与视点构成新面：边 0 连接外侧旧面，边 1 / 边 2 连接相邻新面。
+        for (HorizonEdge& horizon : m_Horizon) {
+            horizon.NewFace = AddFace(horizon.From, horizon.To, eye);
+            const int outerEdge = FindEdge(horizon.Outer, horizon.To, horizon.From);
+            if (outerEdge < 0) {
+                return false;
+            }
+            m_Faces[horizon.Outer].Neighbor[outerEdge] = horizon.NewFace;
+            m_Faces[horizon.NewFace].Neighbor[0] = horizon.Outer;
+        }
+        for (const HorizonEdge& horizon : m_Horizon) {
+            for (const HorizonEdge& other : m_Horizon) {
+                if (other.From == horizon.To) {
+                    m_Faces[horizon.NewFace].Neighbor[1] = other.NewFace;
+                }
+                if (other.To == horizon.From) {
+                    m_Faces[horizon.NewFace].Neighbor[2] = other.NewFace;
+                }
+            }
+            if (m_Faces[horizon.NewFace].Neighbor[1] == kNoFace || m_Faces[horizon.NewFace].Neighbor[2] == kNoFace) {
+                return false;
+            }
+        }
+
+        m_NewFaces.clear();
+        for (const HorizonEdge& horizon : m_Horizon) {
+            m_NewFaces.push_back(horizon.NewFace);
+        }
+        for (ULONG face : m_Visible) {
+            std::vector<ULONG> orphans;
+            orphans.swap(m_Faces[face].Outside);
+            m_Faces[face].Alive = false;
+            for (ULONG point : orphans) {
+                if (point != eye) {
+                    AssignPoint(point, m_NewFaces.data(), static_cast<ULONG>(m_NewFaces.size()));
+                }
+            }
+        }
+        return true;
+    }
+
+    NTSTATUS Export(FCL_CONVEX_HULL* hull) {
+        std::vector<ULONG> remap(m_Count, ULONG_MAX);
+        hull->Vertices.clear();
+        hull->Indices.clear();
+        for (const HullFace& face : m_Faces) {
+            if (!face.Alive) {
+                continue;
+            }
+            for (ULONG vertex : face.Vertex) {
+                if (remap[vertex] == ULONG_MAX) {
+                    remap[vertex] = static_cast<ULONG>(hull->Vertices.size());
+                    hull->Vertices.push_back(m_Input[vertex]);
+                }
+                hull->Indices.push_back(remap[vertex]);
+            }
+        }
+
+        const ULONG vertexCount = static_cast<ULONG>(hull->Vertices.size());
+        double sum[3] = {};
+        for (const FCL_VECTOR3& vertex : hull->Vertices) {
+            sum[0] += vertex.X;
+            sum[1] += vertex.Y;
+            sum[2] += vertex.Z;
+        }
+        hull->Centroid = {
+            static_cast<float>(sum[0] / vertexCount),
+            static_cast<float>(sum[1] / vertexCount),
+            static_cast<float>(sum[2] / vertexCount)};
+
+        // 每条凸包边在两个面中以相反方向各出现一次，按起点登记终点即得到无重复的邻接表。
+        hull->NeighborOffsets.assign(vertexCount + 1, 0);
+        for (size_t i = 0; i < hull->Indices.size(); ++i) {
+            ++hull->NeighborOffsets[hull->Indices[i] + 1];
+        }
+        for (ULONG v = 0; v < vertexCount; ++v) {
+            hull->NeighborOffsets[v + 1] += hull->NeighborOffsets[v];
+        }
+        hull->Neighbors.resize(hull->Indices.size());
+        std::vector<UINT32> cursor(hull->NeighborOffsets.begin(), hull->NeighborOffsets.end() - 1);
+        for (size_t face = 0; face < hull->Indices.size(); face += 3) {
+            for (int edge = 0; edge < 3; ++edge) {
+                const UINT32 from = hull->Indices[face + edge];
+                const UINT32 to = hull->Indices[face + (edge + 1) % 3];
+                hull->Neighbors[cursor[from]++] = to;
+            }
+        }
+        return STATUS_SUCCESS;
+    }
+
+    const FCL_VECTOR3* m_Input;
+    ULONG m_Count;
+    double m_Epsilon = 0.0;
+    std::vector<Point3> m_Points;
+    std::vector<HullFace> m_Faces;
+    std::vector<ULONG> m_Visible;
+    std::vector<HorizonEdge> m_Horizon;
+    std::vector<ULONG> m_NewFaces;
+};
+
+}  // namespace
+
+extern "C"
+NTSTATUS
+FclBuildConvexHull(
+    _In_reads_(pointCount) const FCL_VECTOR3* points,
+    _In_ ULONG pointCount,
+    _Outptr_ FCL_CONVEX_HULL** hull) noexcept {
+    if (hull == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    *hull = nullptr;
+
+    if (points == nullptr || pointCount < 4) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    for (ULONG i = 0; i < pointCount; ++i) {
+        if (!fclmusa::geom::IsValidVector(points[i])) {
+            return STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    auto* instance = new (std::nothrow) FCL_CONVEX_HULL();
+    if (instance == nullptr) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    NTSTATUS status = STATUS_SUCCESS;
+    try {
+        QuickHullBuilder builder(points, pointCount);
+        status = builder.Build(instance);
+    } catch (const std::bad_alloc&) {
+        status = STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    if (!NT_SUCCESS(status)) {
+        delete instance;
+        return status;
+    }
+
+    *hull = instance;
+    return STATUS_SUCCESS;
+}
+
+extern "C"
+VOID
+FclDestroyConvexHull(
+    _In_opt_ FCL_CONVEX_HULL* hull) noexcept {
+    delete hull;
+}
+
+extern "C"
+const FCL_VECTOR3*
+FclConvexHullGetVertices(
+    _In_opt_ const FCL_CONVEX_HULL* hull,
+    _Out_opt_ ULONG* vertexCount) noexcept {
+    if (vertexCount != nullptr) {
+        *vertexCount = (hull != nullptr) ? static_cast<ULONG>(hull->Vertices.size()) : 0;
+    }
+    return (hull != nullptr && !hull->Vertices.empty()) ? hull->Vertices.data() : nullptr;
+}
+
+extern "C"
+const UINT32*
+FclConvexHullGetIndices(
+    _In_opt_ const FCL_CONVEX_HULL* hull,
+    _Out_opt_ ULONG* indexCount) noexcept {
+    if (indexCount != nullptr) {
+        *indexCount = (hull != nullptr) ? static_cast<ULONG>(hull->Indices.size()) : 0;
+    }
+    return (hull != nullptr && !hull->Indices.empty()) ? hull->Indices.data() : nullptr;
+}
+
+extern "C"
+const UINT32*
+FclConvexHullGetNeighbors(
+    _In_opt_ const FCL_CONVEX_HULL* hull,
+    _In_ ULONG vertex,
+    _Out_opt_ ULONG* neighborCount) noexcept {
+    if (hull == nullptr || vertex >= hull->Vertices.size()) {
+        if (neighborCount != nullptr) {
+            *neighborCount = 0;
+        }
+        return nullptr;
+    }
+    const UINT32 begin = hull->NeighborOffsets[vertex];
+    if (neighborCount != nullptr) {
+        *neighborCount = hull->NeighborOffsets[vertex + 1] - begin;
+    }
+    return hull->Neighbors.data() + begin;
+}
+
+extern "C"
+FCL_VECTOR3
+FclConvexHullGetCentroid(
+    _In_opt_ const FCL_CONVEX_HULL* hull) noexcept {
+    return (hull != nullptr) ? hull->Centroid : FCL_VECTOR3{0.0f, 0.0f, 0.0f};
+}
+
+extern "C"
+ULONG
+FclConvexHullSupport(
+    _In_ const FCL_CONVEX_HULL* hull,
+    _In_ const FCL_VECTOR3* direction,
+    _In_ ULONG hint) noexcept {
+    const ULONG vertexCount = static_cast<ULONG>(hull->Vertices.size());
+    const FCL_VECTOR3* vertices = hull->Vertices.data();
+    if (vertexCount <= kLinearSupportThreshold) {
+        ULONG best = 0;
+        float bestDot = fclmusa::geom::Dot(vertices[0], *direction);
+        for (ULONG i = 1; i < vertexCount; ++i) {
+            const float value = fclmusa::geom::Dot(vertices[i], *direction);
+            if (value > bestDot) {
+                bestDot = value;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    ULONG current = (hint < vertexCount) ? hint : 0;
+    float currentDot = fclmusa::geom::Dot(vertices[current], *direction);
+    for (;;) {
+        ULONG next = current;
+        const UINT32* neighbors = hull->Neighbors.data() + hull->NeighborOffsets[current];
+        const UINT32 neighborCount = hull->NeighborOffsets[current + 1] - hull->NeighborOffsets[current];
+        for (UINT32 i = 0; i < neighborCount; ++i) {
+            const float value = fclmusa::geom::Dot(vertices[neighbors[i]], *direction);
+            if (value > currentDot) {
+                currentDot = value;
+                next = neighbors[i];
+            }
+        }
+        if (next == current) {
+            return current;
+        }
+        current = next;
+    }
+}
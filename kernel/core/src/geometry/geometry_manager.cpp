@@ -4,15 +4,23 @@
     #include <atomic>
     #include <mutex>
     #include <unordered_map>
+    #include <vector>
 #endif
 
 #include <float.h>
 #include <new>
 #include <algorithm>
 
+#include "fclmusa/collision.h"
+#include "fclmusa/diagnostics/phase_trace.h"
+#include "fclmusa/diagnostics/workload_recorder.h"
 #include "fclmusa/geometry.h"
 #include "fclmusa/geometry/bvh_model.h"
+#include "fclmusa/geometry/compound_model.h"
+#include "fclmusa/geometry/convex_hull.h"
+#include "fclmusa/geometry/precompiled_mesh.h"
 #include "fclmusa/logging.h"
+#include "fclmusa/memory/alloc_profiler.h"
 #include "fclmusa/memory/pool_allocator.h"
 
 namespace {
@@ -28,6 +36,14 @@ struct ObbPayload {
     FCL_MATRIX3X3 Rotation;
 };
 
+// 胶囊体与圆柱体共用：中心、朝向、半径与半长。
+struct AxialPayload {
+    FCL_VECTOR3 Center;
+    FCL_MATRIX3X3 Rotation;
+    float Radius;
+    float HalfLength;
+};
+
 struct MeshPayload {
     FCL_VECTOR3* Vertices;
     ULONG VertexCount;
@@ -36,14 +52,29 @@ struct MeshPayload {
     FCL_BVH_MODEL* Bvh;
 };
 
+struct ConvexPayload {
+    FCL_CONVEX_HULL* Hull;
+};
+
+// 复合几何：模型保存子形状快照；子形状句柄的引用在创建时获取，销毁复合体时归还。
+struct CompoundPayload {
+    FCL_COMPOUND_MODEL* Model;
+};
+
+constexpr ULONG kMaxCompoundChildren = 4096;
+
 struct GeometryEntry {
     ULONGLONG HandleValue;
     FCL_GEOMETRY_TYPE Type;
     volatile LONG ActiveReferences;
+    ULONG Generation;
     union {
         SpherePayload Sphere;
         ObbPayload Obb;
+        AxialPayload Axial;
         MeshPayload Mesh;
+        ConvexPayload Convex;
+        CompoundPayload Compound;
     } Payload;
 };
 
@@ -107,6 +138,35 @@ NTSTATUS ValidateObbDesc(const FCL_OBB_GEOMETRY_DESC* desc) noexcept {
     return STATUS_SUCCESS;
 }
 
+template <typename Desc>
+NTSTATUS ValidateAxialDesc(const Desc* desc) noexcept {
+    if (desc == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    if (!IsValidVector(desc->Center) || !IsValidMatrix(desc->Rotation)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    if (!IsFiniteFloat(desc->Radius) || desc->Radius <= 0.0f ||
+        !IsFiniteFloat(desc->HalfLength) || desc->HalfLength <= 0.0f) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    return STATUS_SUCCESS;
+}
+
+template <typename Desc>
+NTSTATUS CopyAxialPayload(const VOID* geometryDesc, AxialPayload* payload) noexcept {
+    auto* desc = reinterpret_cast<const Desc*>(geometryDesc);
+    const NTSTATUS status = ValidateAxialDesc(desc);
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+    payload->Center = desc->Center;
+    payload->Rotation = desc->Rotation;
+    payload->Radius = desc->Radius;
+    payload->HalfLength = desc->HalfLength;
+    return STATUS_SUCCESS;
+}
+
 NTSTATUS ValidateMeshDesc(const FCL_MESH_GEOMETRY_DESC* desc) noexcept {
     if (desc == nullptr) {
         return STATUS_INVALID_PARAMETER;
@@ -120,6 +180,93 @@ NTSTATUS ValidateMeshDesc(const FCL_MESH_GEOMETRY_DESC* desc) noexcept {
     return STATUS_SUCCESS;
 }
 
+NTSTATUS ValidateConvexDesc(const FCL_CONVEX_GEOMETRY_DESC* desc) noexcept {
+    if (desc == nullptr || desc->Points == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    if (desc->PointCount < 4) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS ValidateCompoundDesc(const FCL_COMPOUND_GEOMETRY_DESC* desc) noexcept {
+    if (desc == nullptr || desc->Children == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    if (desc->ChildCount == 0 || desc->ChildCount > kMaxCompoundChildren) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    for (ULONG i = 0; i < desc->ChildCount; ++i) {
+        const FCL_TRANSFORM& local = desc->Children[i].LocalTransform;
+        if (!IsValidVector(local.Translation) || !IsValidMatrix(local.Rotation)) {
+            return STATUS_INVALID_PARAMETER;
+        }
+    }
+    return STATUS_SUCCESS;
+}
+
+void ReleaseChildReferences(const FCL_COMPOUND_CHILD* children, ULONG count) noexcept {
+    for (ULONG i = 0; i < count; ++i) {
+        FCL_GEOMETRY_REFERENCE reference = {children[i].Geometry.Value};
+        FclReleaseGeometryReference(&reference);
+    }
+}
+
+// 需在不持有几何锁时调用：逐个获取子形状引用（引用期间子形状不可销毁或更新），再建立包围盒树。
+NTSTATUS CreateCompoundPayload(const FCL_COMPOUND_GEOMETRY_DESC* desc, CompoundPayload* payload) noexcept {
+    NTSTATUS status = ValidateCompoundDesc(desc);
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+
+    size_t childrenSize = 0;
+    if (!SafeSizeMult(desc->ChildCount, sizeof(FCL_COMPOUND_CHILD), &childrenSize)) {
+        return STATUS_INTEGER_OVERFLOW;
+    }
+    FCL_ALLOCATION_SITE(FCL_ALLOC_SITE_GEOMETRY);
+    auto* children = static_cast<FCL_COMPOUND_CHILD*>(fclmusa::memory::Allocate(childrenSize));
+    if (children == nullptr) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    ULONG acquired = 0;
+    for (; acquired < desc->ChildCount; ++acquired) {
+        FCL_COMPOUND_CHILD& child = children[acquired];
+        FCL_GEOMETRY_REFERENCE reference = {};
+        status = FclAcquireGeometryReference(desc->Children[acquired].Geometry, &reference, &child.Snapshot);
+        if (!NT_SUCCESS(status)) {
+            break;
+        }
+        child.Geometry = desc->Children[acquired].Geometry;
+        child.LocalTransform = desc->Children[acquired].LocalTransform;
+        if (child.Snapshot.Type == FCL_GEOMETRY_COMPOUND) {
+            FclReleaseGeometryReference(&reference);
+            status = STATUS_NOT_SUPPORTED;
+            break;
+        }
+    }
+
+    if (NT_SUCCESS(status)) {
+        status = FclBuildCompoundModel(children, desc->ChildCount, &payload->Model);
+    }
+    if (!NT_SUCCESS(status)) {
+        ReleaseChildReferences(children, acquired);
+    }
+    fclmusa::memory::Free(children);
+    return status;
+}
+
+// 归还复合几何持有的子形状引用；需在不持有几何锁时调用，且先于 ReleasePayload。
+void ReleaseCompoundReferences(const GeometryEntry& entry) noexcept {
+    if (entry.Type != FCL_GEOMETRY_COMPOUND) {
+        return;
+    }
+    ULONG childCount = 0;
+    const FCL_COMPOUND_CHILD* children = FclCompoundGetChildren(entry.Payload.Compound.Model, &childCount);
+    ReleaseChildReferences(children, childCount);
+}
+
 void ReleasePayload(GeometryEntry& entry) noexcept {
     if (entry.Type == FCL_GEOMETRY_MESH) {
         auto& mesh = entry.Payload.Mesh;
@@ -137,13 +284,22 @@ void ReleasePayload(GeometryEntry& entry) noexcept {
             FclDestroyBvhModel(mesh.Bvh);
             mesh.Bvh = nullptr;
         }
+    } else if (entry.Type == FCL_GEOMETRY_CONVEX) {
+        FclDestroyConvexHull(entry.Payload.Convex.Hull);
+        entry.Payload.Convex.Hull = nullptr;
+    } else if (entry.Type == FCL_GEOMETRY_COMPOUND) {
+        FclDestroyCompoundModel(entry.Payload.Compound.Model);
+        entry.Payload.Compound.Model = nullptr;
     }
 }
 
-NTSTATUS CopyMeshPayload(const FCL_MESH_GEOMETRY_DESC* desc, MeshPayload* payload) noexcept {
-    if (payload == nullptr) {
-        return STATUS_INVALID_PARAMETER;
-    }
+// 复制 Mesh 顶点与索引到新分配的缓冲区；成功时由调用方负责释放。
+NTSTATUS CopyMeshArrays(
+    const FCL_MESH_GEOMETRY_DESC* desc,
+    _Outptr_ FCL_VECTOR3** verticesOut,
+    _Outptr_ UINT32** indicesOut) noexcept {
+    *verticesOut = nullptr;
+    *indicesOut = nullptr;
 
     size_t verticesSize = 0;
     if (!SafeSizeMult(desc->VertexCount, sizeof(FCL_VECTOR3), &verticesSize)) {
@@ -155,6 +311,7 @@ NTSTATUS CopyMeshPayload(const FCL_MESH_GEOMETRY_DESC* desc, MeshPayload* payloa
         return STATUS_INTEGER_OVERFLOW;
     }
 
+    FCL_ALLOCATION_SITE(FCL_ALLOC_SITE_GEOMETRY);
     auto* vertices = static_cast<FCL_VECTOR3*>(fclmusa::memory::Allocate(verticesSize));
     if (vertices == nullptr) {
         return STATUS_INSUFFICIENT_RESOURCES;
@@ -175,6 +332,23 @@ NTSTATUS CopyMeshPayload(const FCL_MESH_GEOMETRY_DESC* desc, MeshPayload* payloa
         return GetExceptionCode();
     }
 
+    *verticesOut = vertices;
+    *indicesOut = indices;
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS CopyMeshPayload(const FCL_MESH_GEOMETRY_DESC* desc, MeshPayload* payload) noexcept {
+    if (payload == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    FCL_VECTOR3* vertices = nullptr;
+    UINT32* indices = nullptr;
+    NTSTATUS status = CopyMeshArrays(desc, &vertices, &indices);
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+
     FCL_VECTOR3* oldVertices = payload->Vertices;
     UINT32* oldIndices = payload->Indices;
     ULONG oldVertexCount = payload->VertexCount;
@@ -186,7 +360,7 @@ NTSTATUS CopyMeshPayload(const FCL_MESH_GEOMETRY_DESC* desc, MeshPayload* payloa
     payload->Indices = indices;
     payload->IndexCount = desc->IndexCount;
 
-    NTSTATUS status = STATUS_SUCCESS;
+    FCL_ALLOCATION_SITE(FCL_ALLOC_SITE_GEOMETRY);
     if (existingModel != nullptr) {
         status = FclBvhUpdateModel(
             existingModel,
@@ -224,6 +398,45 @@ NTSTATUS CopyMeshPayload(const FCL_MESH_GEOMETRY_DESC* desc, MeshPayload* payloa
     return STATUS_SUCCESS;
 }
 
+// 从预编译映像填充新 Mesh 的载荷。映像缓冲区归调用方（IOCTL 时为 I/O 管理器的系统缓冲区），
+// 返回后即可能释放，因此顶点、索引与 BVH 节点都复制一份；省下的只是 BVH 构建，不是复制。
+NTSTATUS CopyPrecompiledMeshPayload(const FCL_PRECOMPILED_MESH_VIEW& view, MeshPayload* payload) noexcept {
+    FCL_MESH_GEOMETRY_DESC desc = {};
+    desc.Vertices = view.Vertices;
+    desc.VertexCount = view.VertexCount;
+    desc.Indices = view.Indices;
+    desc.IndexCount = view.IndexCount;
+
+    FCL_VECTOR3* vertices = nullptr;
+    UINT32* indices = nullptr;
+    NTSTATUS status = CopyMeshArrays(&desc, &vertices, &indices);
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+
+    FCL_ALLOCATION_SITE(FCL_ALLOC_SITE_GEOMETRY);
+    status = FclAdoptBvhModel(
+        vertices,
+        view.VertexCount,
+        indices,
+        view.IndexCount,
+        view.Nodes,
+        view.NodeCount,
+        view.TriangleOrder,
+        &payload->Bvh);
+    if (!NT_SUCCESS(status)) {
+        fclmusa::memory::Free(vertices);
+        fclmusa::memory::Free(indices);
+        return status;
+    }
+
+    payload->Vertices = vertices;
+    payload->VertexCount = view.VertexCount;
+    payload->Indices = indices;
+    payload->IndexCount = view.IndexCount;
+    return STATUS_SUCCESS;
+}
+
 GeometryEntry MakeEntryTemplate(FCL_GEOMETRY_TYPE type) noexcept {
     GeometryEntry entry = {};
     entry.HandleValue = 0;
@@ -234,6 +447,8 @@ GeometryEntry MakeEntryTemplate(FCL_GEOMETRY_TYPE type) noexcept {
     entry.Payload.Mesh.VertexCount = 0;
     entry.Payload.Mesh.IndexCount = 0;
     entry.Payload.Mesh.Bvh = nullptr;
+    entry.Payload.Convex.Hull = nullptr;
+    entry.Payload.Compound.Model = nullptr;
     return entry;
 }
 
@@ -243,6 +458,7 @@ void CopyEntryToSnapshot(const GeometryEntry& entry, PFCL_GEOMETRY_SNAPSHOT snap
     }
 
     snapshot->Type = entry.Type;
+    snapshot->Generation = entry.Generation;
     switch (entry.Type) {
         case FCL_GEOMETRY_SPHERE:
             snapshot->Data.Sphere.Center = entry.Payload.Sphere.Center;
@@ -253,6 +469,18 @@ void CopyEntryToSnapshot(const GeometryEntry& entry, PFCL_GEOMETRY_SNAPSHOT snap
             snapshot->Data.Obb.Extents = entry.Payload.Obb.Extents;
             snapshot->Data.Obb.Rotation = entry.Payload.Obb.Rotation;
             break;
+        case FCL_GEOMETRY_CAPSULE:
+            snapshot->Data.Capsule.Center = entry.Payload.Axial.Center;
+            snapshot->Data.Capsule.Rotation = entry.Payload.Axial.Rotation;
+            snapshot->Data.Capsule.Radius = entry.Payload.Axial.Radius;
+            snapshot->Data.Capsule.HalfLength = entry.Payload.Axial.HalfLength;
+            break;
+        case FCL_GEOMETRY_CYLINDER:
+            snapshot->Data.Cylinder.Center = entry.Payload.Axial.Center;
+            snapshot->Data.Cylinder.Rotation = entry.Payload.Axial.Rotation;
+            snapshot->Data.Cylinder.Radius = entry.Payload.Axial.Radius;
+            snapshot->Data.Cylinder.HalfLength = entry.Payload.Axial.HalfLength;
+            break;
         case FCL_GEOMETRY_MESH:
             snapshot->Data.Mesh.Vertices = entry.Payload.Mesh.Vertices;
             snapshot->Data.Mesh.VertexCount = entry.Payload.Mesh.VertexCount;
@@ -260,11 +488,28 @@ void CopyEntryToSnapshot(const GeometryEntry& entry, PFCL_GEOMETRY_SNAPSHOT snap
             snapshot->Data.Mesh.IndexCount = entry.Payload.Mesh.IndexCount;
             snapshot->Data.Mesh.Bvh = entry.Payload.Mesh.Bvh;
             break;
+        case FCL_GEOMETRY_CONVEX: {
+            const FCL_CONVEX_HULL* hull = entry.Payload.Convex.Hull;
+            snapshot->Data.Convex.Vertices = FclConvexHullGetVertices(hull, &snapshot->Data.Convex.VertexCount);
+            snapshot->Data.Convex.Indices = FclConvexHullGetIndices(hull, &snapshot->Data.Convex.IndexCount);
+            snapshot->Data.Convex.Hull = hull;
+            break;
+        }
+        case FCL_GEOMETRY_COMPOUND:
+            snapshot->Data.Compound.Model = entry.Payload.Compound.Model;
+            FclCompoundGetChildren(entry.Payload.Compound.Model, &snapshot->Data.Compound.ChildCount);
+            break;
         default:
             break;
     }
 }
 
+// 枚举时在锁内登记的条目：持有一个引用，回调在锁外读取快照。
+struct EnumeratedGeometry {
+    ULONGLONG HandleValue;
+    FCL_GEOMETRY_SNAPSHOT Snapshot;
+};
+
 }  // namespace
 
 #if FCL_MUSA_KERNEL_MODE
@@ -304,6 +549,7 @@ AllocateEntry(
     _In_ PRTL_AVL_TABLE table,
     _In_ CLONG byteSize) {
     UNREFERENCED_PARAMETER(table);
+    FCL_ALLOCATION_SITE(FCL_ALLOC_SITE_GEOMETRY);
     return fclmusa::memory::Allocate(static_cast<size_t>(byteSize));
 }
 
@@ -380,16 +626,22 @@ FclGeometrySubsystemShutdown() noexcept {
         }
         GeometryEntry temp = *entry;
         RtlDeleteElementGenericTableAvl(&g_GeometryTable, entry);
+        // 子形状随之一并销毁，复合几何无需（也不能在持锁时）归还子形状引用。
         ReleasePayload(temp);
     }
 
     ExReleasePushLockExclusiveAndLeaveCriticalRegion(&g_GeometryLock);
     g_GeometryInitialized = FALSE;
+
+    // 句柄计数在重新初始化时归零，缓存键随之失效。
+    FclCoherenceCacheConfigure(0);
 }
 
-extern "C"
+// 公开入口在文件末尾，负责工作负载录制（见 workload_recorder.h）。
+namespace {
+
 NTSTATUS
-FclCreateGeometry(
+CreateGeometryUnrecorded(
     _In_ FCL_GEOMETRY_TYPE type,
     _In_ const VOID* geometryDesc,
     _Out_ PFCL_GEOMETRY_HANDLE handle) noexcept {
@@ -436,6 +688,18 @@ FclCreateGeometry(
             entry.Payload.Obb.Rotation = desc->Rotation;
             break;
         }
+        case FCL_GEOMETRY_CAPSULE:
+            status = CopyAxialPayload<FCL_CAPSULE_GEOMETRY_DESC>(geometryDesc, &entry.Payload.Axial);
+            if (!NT_SUCCESS(status)) {
+                return status;
+            }
+            break;
+        case FCL_GEOMETRY_CYLINDER:
+            status = CopyAxialPayload<FCL_CYLINDER_GEOMETRY_DESC>(geometryDesc, &entry.Payload.Axial);
+            if (!NT_SUCCESS(status)) {
+                return status;
+            }
+            break;
         case FCL_GEOMETRY_MESH: {
             auto* desc = reinterpret_cast<const FCL_MESH_GEOMETRY_DESC*>(geometryDesc);
             status = ValidateMeshDesc(desc);
@@ -448,6 +712,25 @@ FclCreateGeometry(
             }
             break;
         }
+        case FCL_GEOMETRY_CONVEX: {
+            auto* desc = reinterpret_cast<const FCL_CONVEX_GEOMETRY_DESC*>(geometryDesc);
+            status = ValidateConvexDesc(desc);
+            if (!NT_SUCCESS(status)) {
+                return status;
+            }
+            status = FclBuildConvexHull(desc->Points, desc->PointCount, &entry.Payload.Convex.Hull);
+            if (!NT_SUCCESS(status)) {
+                return status;
+            }
+            break;
+        }
+        case FCL_GEOMETRY_COMPOUND:
+            status = CreateCompoundPayload(
+                reinterpret_cast<const FCL_COMPOUND_GEOMETRY_DESC*>(geometryDesc), &entry.Payload.Compound);
+            if (!NT_SUCCESS(status)) {
+                return status;
+            }
+            break;
         default:
             return STATUS_INVALID_PARAMETER;
     }
@@ -457,15 +740,15 @@ FclCreateGeometry(
     ExReleasePushLockExclusiveAndLeaveCriticalRegion(&g_GeometryLock);
 
     if (!NT_SUCCESS(status)) {
+        ReleaseCompoundReferences(entry);
         ReleasePayload(entry);
     }
 
     return status;
 }
 
-extern "C"
 NTSTATUS
-FclDestroyGeometry(
+DestroyGeometryUnrecorded(
     _In_ FCL_GEOMETRY_HANDLE handleValue) noexcept {
     if (!EnsureInitialized()) {
         return STATUS_DEVICE_NOT_READY;
@@ -501,13 +784,14 @@ FclDestroyGeometry(
         return STATUS_INTERNAL_ERROR;
     }
 
+    ReleaseCompoundReferences(temp);
     ReleasePayload(temp);
+    FclCoherenceCacheInvalidateGeometry(handleValue);
     return STATUS_SUCCESS;
 }
 
-extern "C"
 NTSTATUS
-FclUpdateMeshGeometry(
+UpdateMeshGeometryUnrecorded(
     _In_ FCL_GEOMETRY_HANDLE handleValue,
     _In_ const FCL_MESH_GEOMETRY_DESC* geometryDesc) noexcept {
     if (!EnsureInitialized()) {
@@ -546,12 +830,70 @@ FclUpdateMeshGeometry(
     }
 
     status = CopyMeshPayload(geometryDesc, &entry->Payload.Mesh);
+    if (NT_SUCCESS(status)) {
+        ++entry->Generation;
+    }
 
 Exit:
     ExReleasePushLockExclusiveAndLeaveCriticalRegion(&g_GeometryLock);
+    if (NT_SUCCESS(status)) {
+        FclCoherenceCacheInvalidateGeometry(handleValue);
+    }
     return status;
 }
 
+NTSTATUS
+CreateMeshFromImageUnrecorded(
+    _In_reads_bytes_(imageBytes) const VOID* image,
+    _In_ size_t imageBytes,
+    _Out_ PFCL_GEOMETRY_HANDLE handle,
+    _Out_opt_ PFCL_MESH_GEOMETRY_DESC source) noexcept {
+    if (handle == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    handle->Value = 0;
+
+    if (!EnsureInitialized()) {
+        return STATUS_DEVICE_NOT_READY;
+    }
+
+    if (KeGetCurrentIrql() != PASSIVE_LEVEL) {
+        return STATUS_INVALID_DEVICE_STATE;
+    }
+
+    FCL_PRECOMPILED_MESH_VIEW view = {};
+    NTSTATUS status = FclParsePrecompiledMesh(image, imageBytes, &view);
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+
+    GeometryEntry entry = MakeEntryTemplate(FCL_GEOMETRY_MESH);
+    status = CopyPrecompiledMeshPayload(view, &entry.Payload.Mesh);
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+
+    ExEnterCriticalRegionAndAcquirePushLockExclusive(&g_GeometryLock);
+    status = InsertEntryLocked(&entry, handle);
+    ExReleasePushLockExclusiveAndLeaveCriticalRegion(&g_GeometryLock);
+
+    if (!NT_SUCCESS(status)) {
+        ReleasePayload(entry);
+        return status;
+    }
+
+    if (source != nullptr) {
+        source->Vertices = view.Vertices;
+        source->VertexCount = view.VertexCount;
+        source->Indices = view.Indices;
+        source->IndexCount = view.IndexCount;
+    }
+    return STATUS_SUCCESS;
+}
+
+}  // namespace
+
 extern "C"
 BOOLEAN
 FclIsGeometryHandleValid(
@@ -568,6 +910,7 @@ FclAcquireGeometryReference(
     if (reference == nullptr) {
         return STATUS_INVALID_PARAMETER;
     }
+    FCL_TRACE_PHASE_SCOPE(FCL_TRACE_PHASE_HANDLE_ACQUIRE);
 
     reference->HandleValue = 0;
 
@@ -621,6 +964,70 @@ FclReleaseGeometryReference(
     reference->HandleValue = 0;
 }
 
+extern "C"
+NTSTATUS
+FclEnumerateGeometries(
+    _In_ PFCL_GEOMETRY_ENUM_CALLBACK callback,
+    _In_opt_ PVOID context) noexcept {
+    if (callback == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (!EnsureInitialized()) {
+        return STATUS_DEVICE_NOT_READY;
+    }
+
+    if (KeGetCurrentIrql() != PASSIVE_LEVEL) {
+        return STATUS_INVALID_DEVICE_STATE;
+    }
+
+    // 锁内只登记快照并为每个条目加引用（阻止销毁/更新使快照失效），回调在锁外执行。
+    // AVL 表按句柄排序，顺序枚举即为升序。
+    ExEnterCriticalRegionAndAcquirePushLockExclusive(&g_GeometryLock);
+    const ULONG count = RtlNumberGenericTableElementsAvl(&g_GeometryTable);
+    EnumeratedGeometry* entries = nullptr;
+    if (count != 0) {
+        size_t bytes = 0;
+        if (SafeSizeMult(count, sizeof(EnumeratedGeometry), &bytes)) {
+            FCL_ALLOCATION_SITE(FCL_ALLOC_SITE_GEOMETRY);
+            entries = static_cast<EnumeratedGeometry*>(fclmusa::memory::Allocate(bytes));
+        }
+        if (entries == nullptr) {
+            ExReleasePushLockExclusiveAndLeaveCriticalRegion(&g_GeometryLock);
+            return STATUS_INSUFFICIENT_RESOURCES;
+        }
+    }
+    ULONG taken = 0;
+    for (auto* entry = reinterpret_cast<GeometryEntry*>(RtlEnumerateGenericTableAvl(&g_GeometryTable, TRUE));
+         entry != nullptr && taken < count;
+         entry = reinterpret_cast<GeometryEntry*>(RtlEnumerateGenericTableAvl(&g_GeometryTable, FALSE))) {
+        ++entry->ActiveReferences;
+        entries[taken].HandleValue = entry->HandleValue;
+        RtlZeroMemory(&entries[taken].Snapshot, sizeof(entries[taken].Snapshot));
+        CopyEntryToSnapshot(*entry, &entries[taken].Snapshot);
+        ++taken;
+    }
+    ExReleasePushLockExclusiveAndLeaveCriticalRegion(&g_GeometryLock);
+
+    for (ULONG i = 0; i < taken; ++i) {
+        callback(context, FCL_GEOMETRY_HANDLE{entries[i].HandleValue}, &entries[i].Snapshot);
+    }
+
+    ExEnterCriticalRegionAndAcquirePushLockExclusive(&g_GeometryLock);
+    for (ULONG i = 0; i < taken; ++i) {
+        auto* entry = LookupEntryLocked(entries[i].HandleValue);
+        if (entry != nullptr && entry->ActiveReferences > 0) {
+            --entry->ActiveReferences;
+        }
+    }
+    ExReleasePushLockExclusiveAndLeaveCriticalRegion(&g_GeometryLock);
+
+    if (entries != nullptr) {
+        fclmusa::memory::Free(entries);
+    }
+    return STATUS_SUCCESS;
+}
+
 #else  // FCL_MUSA_KERNEL_MODE == 0 (user-mode implementation)
 
 std::mutex g_GeometryMutex;
@@ -672,16 +1079,21 @@ FclGeometrySubsystemShutdown() noexcept {
     if (!g_GeometryInitialized) {
         return;
     }
+    // 子形状随之一并销毁，复合几何无需（也不能在持锁时）归还子形状引用。
     for (auto& kv : g_GeometryMap) {
         ReleasePayload(kv.second);
     }
     g_GeometryMap.clear();
     g_GeometryInitialized = false;
+
+    // 句柄计数在重新初始化时归零，缓存键随之失效。
+    FclCoherenceCacheConfigure(0);
 }
 
-extern "C"
+namespace {
+
 NTSTATUS
-FclCreateGeometry(
+CreateGeometryUnrecorded(
     _In_ FCL_GEOMETRY_TYPE type,
     _In_ const VOID* geometryDesc,
     _Out_ PFCL_GEOMETRY_HANDLE handle) noexcept {
@@ -721,6 +1133,18 @@ FclCreateGeometry(
             entry.Payload.Obb.Rotation = desc->Rotation;
             break;
         }
+        case FCL_GEOMETRY_CAPSULE:
+            status = CopyAxialPayload<FCL_CAPSULE_GEOMETRY_DESC>(geometryDesc, &entry.Payload.Axial);
+            if (!NT_SUCCESS(status)) {
+                return status;
+            }
+            break;
+        case FCL_GEOMETRY_CYLINDER:
+            status = CopyAxialPayload<FCL_CYLINDER_GEOMETRY_DESC>(geometryDesc, &entry.Payload.Axial);
+            if (!NT_SUCCESS(status)) {
+                return status;
+            }
+            break;
         case FCL_GEOMETRY_MESH: {
             auto* desc = reinterpret_cast<const FCL_MESH_GEOMETRY_DESC*>(geometryDesc);
             status = ValidateMeshDesc(desc);
@@ -733,21 +1157,42 @@ FclCreateGeometry(
             }
             break;
         }
+        case FCL_GEOMETRY_CONVEX: {
+            auto* desc = reinterpret_cast<const FCL_CONVEX_GEOMETRY_DESC*>(geometryDesc);
+            status = ValidateConvexDesc(desc);
+            if (!NT_SUCCESS(status)) {
+                return status;
+            }
+            status = FclBuildConvexHull(desc->Points, desc->PointCount, &entry.Payload.Convex.Hull);
+            if (!NT_SUCCESS(status)) {
+                return status;
+            }
+            break;
+        }
+        case FCL_GEOMETRY_COMPOUND:
+            status = CreateCompoundPayload(
+                reinterpret_cast<const FCL_COMPOUND_GEOMETRY_DESC*>(geometryDesc), &entry.Payload.Compound);
+            if (!NT_SUCCESS(status)) {
+                return status;
+            }
+            break;
         default:
             return STATUS_INVALID_PARAMETER;
     }
 
-    std::lock_guard<std::mutex> guard(g_GeometryMutex);
-    status = InsertEntryLocked(entry, handle);
+    {
+        std::lock_guard<std::mutex> guard(g_GeometryMutex);
+        status = InsertEntryLocked(entry, handle);
+    }
     if (!NT_SUCCESS(status)) {
+        ReleaseCompoundReferences(entry);
         ReleasePayload(entry);
     }
     return status;
 }
 
-extern "C"
 NTSTATUS
-FclDestroyGeometry(
+DestroyGeometryUnrecorded(
     _In_ FCL_GEOMETRY_HANDLE handleValue) noexcept {
     if (!EnsureInitialized()) {
         return STATUS_DEVICE_NOT_READY;
@@ -756,23 +1201,28 @@ FclDestroyGeometry(
         return STATUS_INVALID_HANDLE;
     }
 
-    std::lock_guard<std::mutex> guard(g_GeometryMutex);
-    auto it = g_GeometryMap.find(handleValue.Value);
-    if (it == g_GeometryMap.end()) {
-        return STATUS_INVALID_HANDLE;
-    }
-    if (it->second.ActiveReferences != 0) {
-        return STATUS_DEVICE_BUSY;
+    GeometryEntry entry = {};
+    {
+        std::lock_guard<std::mutex> guard(g_GeometryMutex);
+        auto it = g_GeometryMap.find(handleValue.Value);
+        if (it == g_GeometryMap.end()) {
+            return STATUS_INVALID_HANDLE;
+        }
+        if (it->second.ActiveReferences != 0) {
+            return STATUS_DEVICE_BUSY;
+        }
+        entry = std::move(it->second);
+        g_GeometryMap.erase(it);
     }
-    GeometryEntry entry = std::move(it->second);
-    g_GeometryMap.erase(it);
+    // 归还子形状引用需要重新获取几何锁，必须在锁外进行。
+    ReleaseCompoundReferences(entry);
     ReleasePayload(entry);
+    FclCoherenceCacheInvalidateGeometry(handleValue);
     return STATUS_SUCCESS;
 }
 
-extern "C"
 NTSTATUS
-FclUpdateMeshGeometry(
+UpdateMeshGeometryUnrecorded(
     _In_ FCL_GEOMETRY_HANDLE handleValue,
     _In_ const FCL_MESH_GEOMETRY_DESC* geometryDesc) noexcept {
     if (!EnsureInitialized()) {
@@ -797,9 +1247,60 @@ FclUpdateMeshGeometry(
     if (entry->ActiveReferences != 0) {
         return STATUS_DEVICE_BUSY;
     }
-    return CopyMeshPayload(geometryDesc, &entry->Payload.Mesh);
+    status = CopyMeshPayload(geometryDesc, &entry->Payload.Mesh);
+    if (NT_SUCCESS(status)) {
+        ++entry->Generation;
+        FclCoherenceCacheInvalidateGeometry(handleValue);
+    }
+    return status;
+}
+
+NTSTATUS
+CreateMeshFromImageUnrecorded(
+    _In_reads_bytes_(imageBytes) const VOID* image,
+    _In_ size_t imageBytes,
+    _Out_ PFCL_GEOMETRY_HANDLE handle,
+    _Out_opt_ PFCL_MESH_GEOMETRY_DESC source) noexcept {
+    if (handle == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    handle->Value = 0;
+    if (!EnsureInitialized()) {
+        return STATUS_DEVICE_NOT_READY;
+    }
+
+    FCL_PRECOMPILED_MESH_VIEW view = {};
+    NTSTATUS status = FclParsePrecompiledMesh(image, imageBytes, &view);
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+
+    GeometryEntry entry = MakeEntryTemplate(FCL_GEOMETRY_MESH);
+    status = CopyPrecompiledMeshPayload(view, &entry.Payload.Mesh);
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(g_GeometryMutex);
+        status = InsertEntryLocked(entry, handle);
+    }
+    if (!NT_SUCCESS(status)) {
+        ReleasePayload(entry);
+        return status;
+    }
+
+    if (source != nullptr) {
+        source->Vertices = view.Vertices;
+        source->VertexCount = view.VertexCount;
+        source->Indices = view.Indices;
+        source->IndexCount = view.IndexCount;
+    }
+    return STATUS_SUCCESS;
 }
 
+}  // namespace
+
 extern "C"
 BOOLEAN
 FclIsGeometryHandleValid(
@@ -816,6 +1317,7 @@ FclAcquireGeometryReference(
     if (reference == nullptr) {
         return STATUS_INVALID_PARAMETER;
     }
+    FCL_TRACE_PHASE_SCOPE(FCL_TRACE_PHASE_HANDLE_ACQUIRE);
     reference->HandleValue = 0;
     if (!EnsureInitialized()) {
         return STATUS_DEVICE_NOT_READY;
@@ -853,4 +1355,147 @@ FclReleaseGeometryReference(
     reference->HandleValue = 0;
 }
 
+extern "C"
+NTSTATUS
+FclEnumerateGeometries(
+    _In_ PFCL_GEOMETRY_ENUM_CALLBACK callback,
+    _In_opt_ PVOID context) noexcept {
+    if (callback == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    if (!EnsureInitialized()) {
+        return STATUS_DEVICE_NOT_READY;
+    }
+
+    // 锁内只登记快照并加引用，回调在锁外执行。
+    std::vector<EnumeratedGeometry> entries;
+    {
+        std::lock_guard<std::mutex> guard(g_GeometryMutex);
+        try {
+            entries.reserve(g_GeometryMap.size());
+        } catch (const std::bad_alloc&) {
+            return STATUS_INSUFFICIENT_RESOURCES;
+        }
+        for (auto& kv : g_GeometryMap) {
+            EnumeratedGeometry enumerated = {};
+            ++kv.second.ActiveReferences;
+            enumerated.HandleValue = kv.second.HandleValue;
+            CopyEntryToSnapshot(kv.second, &enumerated.Snapshot);
+            entries.push_back(enumerated);
+        }
+    }
+    // unordered_map 无序，按句柄排序。
+    std::sort(entries.begin(), entries.end(), [](const EnumeratedGeometry& lhs, const EnumeratedGeometry& rhs) {
+        return lhs.HandleValue < rhs.HandleValue;
+    });
+    for (const EnumeratedGeometry& enumerated : entries) {
+        callback(context, FCL_GEOMETRY_HANDLE{enumerated.HandleValue}, &enumerated.Snapshot);
+    }
+
+    std::lock_guard<std::mutex> guard(g_GeometryMutex);
+    for (const EnumeratedGeometry& enumerated : entries) {
+        auto* entry = LookupEntryLocked(enumerated.HandleValue);
+        if (entry != nullptr && entry->ActiveReferences > 0) {
+            --entry->ActiveReferences;
+        }
+    }
+    return STATUS_SUCCESS;
+}
+
 #endif  // FCL_MUSA_KERNEL_MODE
+
+extern "C"
+NTSTATUS
+FclCreateGeometry(
+    _In_ FCL_GEOMETRY_TYPE type,
+    _In_ const VOID* geometryDesc,
+    _Out_ PFCL_GEOMETRY_HANDLE handle) noexcept {
+    if (!fclmusa::diagnostics::IsWorkloadRecording()) {
+        return CreateGeometryUnrecorded(type, geometryDesc, handle);
+    }
+    const ULONGLONG start = fclmusa::diagnostics::WorkloadTimestamp();
+    const NTSTATUS status = CreateGeometryUnrecorded(type, geometryDesc, handle);
+    fclmusa::diagnostics::RecordGeometryCreate(
+        start, type, geometryDesc, (handle != nullptr) ? *handle : FCL_GEOMETRY_HANDLE{}, status);
+    return status;
+}
+
+extern "C"
+NTSTATUS
+FclDestroyGeometry(
+    _In_ FCL_GEOMETRY_HANDLE handleValue) noexcept {
+    if (!fclmusa::diagnostics::IsWorkloadRecording()) {
+        return DestroyGeometryUnrecorded(handleValue);
+    }
+    const ULONGLONG start = fclmusa::diagnostics::WorkloadTimestamp();
+    const NTSTATUS status = DestroyGeometryUnrecorded(handleValue);
+    fclmusa::diagnostics::RecordGeometryDestroy(start, handleValue, status);
+    return status;
+}
+
+extern "C"
+NTSTATUS
+FclUpdateMeshGeometry(
+    _In_ FCL_GEOMETRY_HANDLE handleValue,
+    _In_ const FCL_MESH_GEOMETRY_DESC* geometryDesc) noexcept {
+    if (!fclmusa::diagnostics::IsWorkloadRecording()) {
+        return UpdateMeshGeometryUnrecorded(handleValue, geometryDesc);
+    }
+    const ULONGLONG start = fclmusa::diagnostics::WorkloadTimestamp();
+    const NTSTATUS status = UpdateMeshGeometryUnrecorded(handleValue, geometryDesc);
+    fclmusa::diagnostics::RecordMeshUpdate(start, handleValue, geometryDesc, status);
+    return status;
+}
+
+extern "C"
+NTSTATUS
+FclCreateMeshGeometryFromImage(
+    _In_reads_bytes_(imageBytes) const VOID* image,
+    _In_ size_t imageBytes,
+    _Out_ PFCL_GEOMETRY_HANDLE handle) noexcept {
+    if (!fclmusa::diagnostics::IsWorkloadRecording()) {
+        return CreateMeshFromImageUnrecorded(image, imageBytes, handle, nullptr);
+    }
+    // 录制为普通 Mesh 创建（顶点 / 索引取自映像），回放时重新构建 BVH。
+    const ULONGLONG start = fclmusa::diagnostics::WorkloadTimestamp();
+    FCL_MESH_GEOMETRY_DESC source = {};
+    const NTSTATUS status = CreateMeshFromImageUnrecorded(image, imageBytes, handle, &source);
+    fclmusa::diagnostics::RecordGeometryCreate(
+        start,
+        FCL_GEOMETRY_MESH,
+        NT_SUCCESS(status) ? &source : nullptr,
+        (handle != nullptr) ? *handle : FCL_GEOMETRY_HANDLE{},
+        status);
+    return status;
+}
+
+extern "C"
+NTSTATUS
+FclCreateConvexFromMesh(
+    _In_ FCL_GEOMETRY_HANDLE mesh,
+    _Out_ PFCL_GEOMETRY_HANDLE handle) noexcept {
+    if (handle == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    handle->Value = 0;
+
+    FCL_GEOMETRY_REFERENCE reference = {};
+    FCL_GEOMETRY_SNAPSHOT snapshot = {};
+    NTSTATUS status = FclAcquireGeometryReference(mesh, &reference, &snapshot);
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+
+    if (snapshot.Type != FCL_GEOMETRY_MESH) {
+        FclReleaseGeometryReference(&reference);
+        return STATUS_NOT_SUPPORTED;
+    }
+
+    // 引用期间 Mesh 顶点不会被 FclUpdateMeshGeometry 替换，可直接作为凸包输入。
+    FCL_CONVEX_GEOMETRY_DESC desc = {};
+    desc.Points = snapshot.Data.Mesh.Vertices;
+    desc.PointCount = snapshot.Data.Mesh.VertexCount;
+    status = FclCreateGeometry(FCL_GEOMETRY_CONVEX, &desc, handle);
+    FclReleaseGeometryReference(&reference);
+    return status;
+}
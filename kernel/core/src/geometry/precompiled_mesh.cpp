@@ -0,0 +1,177 @@
+﻿#include "fclmusa/geometry/precompiled_mesh.h"
+
+namespace {
+
+constexpr ULONGLONG kFnvOffsetBasis = 14695981039346656037ull;
+constexpr ULONGLONG kFnvPrime = 1099511628211ull;
+
+ULONGLONG ComputeChecksum(const UCHAR* data, size_t size) noexcept {
+    ULONGLONG hash = kFnvOffsetBasis;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+constexpr ULONGLONG AlignSection(ULONGLONG offset) noexcept {
+    return (offset + 7ull) & ~7ull;
+}
+
+struct SectionLayout {
+    ULONGLONG VerticesOffset;
+    ULONGLONG IndicesOffset;
+    ULONGLONG NodesOffset;
+    ULONGLONG TriangleOrderOffset;
+    ULONGLONG ImageBytes;
+};
+
+// 计数均为 ULONG，各段长度在 64 位内不会溢出。
+SectionLayout ComputeLayout(ULONG vertexCount, ULONG indexCount, ULONG nodeCount) noexcept {
+    SectionLayout layout = {};
+    layout.VerticesOffset = AlignSection(sizeof(FCL_PRECOMPILED_MESH_HEADER));
+    layout.IndicesOffset = AlignSection(layout.VerticesOffset + static_cast<ULONGLONG>(vertexCount) * sizeof(FCL_VECTOR3));
+    layout.NodesOffset = AlignSection(layout.IndicesOffset + static_cast<ULONGLONG>(indexCount) * sizeof(UINT32));
+    layout.TriangleOrderOffset = AlignSection(layout.NodesOffset + static_cast<ULONGLONG>(nodeCount) * sizeof(FCL_BVH_NODE));
+    layout.ImageBytes = AlignSection(layout.TriangleOrderOffset + static_cast<ULONGLONG>(indexCount / 3) * sizeof(UINT32));
+    return layout;
+}
+
+}  // namespace
+
+extern "C"
+NTSTATUS
+FclParsePrecompiledMesh(
+    _In_reads_bytes_(imageBytes) const VOID* image,
+    _In_ size_t imageBytes,
+    _Out_ PFCL_PRECOMPILED_MESH_VIEW view) noexcept {
+    if (image == nullptr || view == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    RtlZeroMemory(view, sizeof(*view));
+
+    if (imageBytes < sizeof(FCL_PRECOMPILED_MESH_HEADER)) {
+        return STATUS_INVALID_IMAGE_FORMAT;
+    }
+    FCL_PRECOMPILED_MESH_HEADER header = {};
+    RtlCopyMemory(&header, image, sizeof(header));
+    if (header.Magic != FCL_PRECOMPILED_MESH_MAGIC) {
+        return STATUS_INVALID_IMAGE_FORMAT;
+    }
+    if (header.Version != FCL_PRECOMPILED_MESH_VERSION || header.HeaderSize != sizeof(FCL_PRECOMPILED_MESH_HEADER) ||
+        header.NodeSize != sizeof(FCL_BVH_NODE)) {
+        return STATUS_REVISION_MISMATCH;
+    }
+    if (header.VertexCount == 0 || header.IndexCount < 3 || (header.IndexCount % 3) != 0 || header.NodeCount == 0) {
+        return STATUS_INVALID_IMAGE_FORMAT;
+    }
+
+    // 只接受写入端产生的规范布局：各段偏移与总长度都由计数唯一确定。
+    const SectionLayout layout = ComputeLayout(header.VertexCount, header.IndexCount, header.NodeCount);
+    if (header.VerticesOffset != layout.VerticesOffset || header.IndicesOffset != layout.IndicesOffset ||
+        header.NodesOffset != layout.NodesOffset || header.TriangleOrderOffset != layout.TriangleOrderOffset ||
+        header.ImageBytes != layout.ImageBytes || header.ImageBytes > imageBytes) {
+        return STATUS_INVALID_IMAGE_FORMAT;
+    }
+
+    const auto* bytes = static_cast<const UCHAR*>(image);
+    if (ComputeChecksum(bytes + sizeof(header), static_cast<size_t>(header.ImageBytes - sizeof(header))) != header.Checksum) {
+        return STATUS_DATA_ERROR;
+    }
+
+    view->Vertices = reinterpret_cast<const FCL_VECTOR3*>(bytes + header.VerticesOffset);
+    view->VertexCount = header.VertexCount;
+    view->Indices = reinterpret_cast<const UINT32*>(bytes + header.IndicesOffset);
+    view->IndexCount = header.IndexCount;
+    view->Nodes = reinterpret_cast<const FCL_BVH_NODE*>(bytes + header.NodesOffset);
+    view->NodeCount = header.NodeCount;
+    view->TriangleOrder = reinterpret_cast<const UINT32*>(bytes + header.TriangleOrderOffset);
+    return STATUS_SUCCESS;
+}
+
+extern "C"
+NTSTATUS
+FclWritePrecompiledMesh(
+    _In_ const FCL_PRECOMPILED_MESH_VIEW* view,
+    _Out_writes_bytes_opt_(bufferBytes) VOID* buffer,
+    _In_ size_t bufferBytes,
+    _Out_ size_t* requiredBytes) noexcept {
+    if (requiredBytes == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    *requiredBytes = 0;
+    if (view == nullptr || view->Vertices == nullptr || view->Indices == nullptr || view->Nodes == nullptr ||
+        view->TriangleOrder == nullptr || view->VertexCount == 0 || view->IndexCount < 3 ||
+        (view->IndexCount % 3) != 0 || view->NodeCount == 0) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    const SectionLayout layout = ComputeLayout(view->VertexCount, view->IndexCount, view->NodeCount);
+    if (layout.ImageBytes > static_cast<ULONGLONG>(static_cast<size_t>(-1))) {
+        return STATUS_INTEGER_OVERFLOW;
+    }
+    *requiredBytes = static_cast<size_t>(layout.ImageBytes);
+    if (buffer == nullptr || bufferBytes < *requiredBytes) {
+        return STATUS_BUFFER_TOO_SMALL;
+    }
+
+    auto* bytes = static_cast<UCHAR*>(buffer);
+    RtlZeroMemory(bytes, *requiredBytes);
+    RtlCopyMemory(bytes + layout.VerticesOffset, view->Vertices, view->VertexCount * sizeof(FCL_VECTOR3));
+    RtlCopyMemory(bytes + layout.IndicesOffset, view->Indices, view->IndexCount * sizeof(UINT32));
+    RtlCopyMemory(bytes + layout.NodesOffset, view->Nodes, view->NodeCount * sizeof(FCL_BVH_NODE));
+    RtlCopyMemory(bytes + layout.TriangleOrderOffset, view->TriangleOrder, (view->IndexCount / 3) * sizeof(UINT32));
+
+    FCL_PRECOMPILED_MESH_HEADER header = {};
+    header.Magic = FCL_PRECOMPILED_MESH_MAGIC;
+    header.Version = FCL_PRECOMPILED_MESH_VERSION;
+    header.HeaderSize = sizeof(FCL_PRECOMPILED_MESH_HEADER);
+    header.NodeSize = sizeof(FCL_BVH_NODE);
+    header.VertexCount = view->VertexCount;
+    header.IndexCount = view->IndexCount;
+    header.NodeCount = view->NodeCount;
+    header.VerticesOffset = layout.VerticesOffset;
+    header.IndicesOffset = layout.IndicesOffset;
+    header.NodesOffset = layout.NodesOffset;
+    header.TriangleOrderOffset = layout.TriangleOrderOffset;
+    header.ImageBytes = layout.ImageBytes;
+    header.Checksum = ComputeChecksum(bytes + sizeof(header), *requiredBytes - sizeof(header));
+    RtlCopyMemory(bytes, &header, sizeof(header));
+    return STATUS_SUCCESS;
+}
+
+extern "C"
+NTSTATUS
+FclSerializeMeshGeometry(
+    _In_ FCL_GEOMETRY_HANDLE mesh,
+    _Out_writes_bytes_opt_(bufferBytes) VOID* buffer,
+    _In_ size_t bufferBytes,
+    _Out_ size_t* requiredBytes) noexcept {
+    if (requiredBytes == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    *requiredBytes = 0;
+
+    FCL_GEOMETRY_REFERENCE reference = {};
+    FCL_GEOMETRY_SNAPSHOT snapshot = {};
+    NTSTATUS status = FclAcquireGeometryReference(mesh, &reference, &snapshot);
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+    if (snapshot.Type != FCL_GEOMETRY_MESH) {
+        FclReleaseGeometryReference(&reference);
+        return STATUS_NOT_SUPPORTED;
+    }
+
+    // 引用期间 Mesh 不会被 FclUpdateMeshGeometry 替换，顶点、索引与 BVH 保持一致。
+    FCL_PRECOMPILED_MESH_VIEW view = {};
+    view.Vertices = snapshot.Data.Mesh.Vertices;
+    view.VertexCount = snapshot.Data.Mesh.VertexCount;
+    view.Indices = snapshot.Data.Mesh.Indices;
+    view.IndexCount = snapshot.Data.Mesh.IndexCount;
+    view.Nodes = FclBvhGetNodes(snapshot.Data.Mesh.Bvh, &view.NodeCount);
+    view.TriangleOrder = FclBvhGetTriangleOrder(snapshot.Data.Mesh.Bvh, nullptr);
+    status = FclWritePrecompiledMesh(&view, buffer, bufferBytes, requiredBytes);
+    FclReleaseGeometryReference(&reference);
+    return status;
+}
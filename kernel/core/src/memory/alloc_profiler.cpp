@@ -0,0 +1,370 @@
+﻿#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include "fclmusa/memory/alloc_profiler.h"
+
+#include "fclmusa/platform.h"
+#if FCL_MUSA_ENABLE_ALLOC_PROFILING && !FCL_MUSA_KERNEL_MODE
+    #include <atomic>
+#endif
+
+#if FCL_MUSA_ENABLE_ALLOC_PROFILING
+
+namespace {
+
+constexpr ULONG kHistogramBuckets = FCL_ALLOC_PROFILE_HISTOGRAM_BUCKETS;
+
+#if FCL_MUSA_KERNEL_MODE
+struct ProfileEntry {
+    volatile LONG Key;
+    volatile LONG64 AllocationCount;
+    volatile LONG64 FreeCount;
+    volatile LONG64 BytesAllocated;
+    volatile LONG64 LiveBytes;
+    volatile LONG64 PeakLiveBytes;
+    volatile LONG64 Histogram[kHistogramBuckets];
+};
+
+// 调用点槽位：内核态没有 thread_local，与查询 arena 相同按 (线程, IRQL) 绑定，DPC 不会继承被打断线程的调用点。
+struct SiteSlot {
+    PVOID volatile Owner;
+    KIRQL Irql;
+    ULONG Site;
+};
+
+constexpr ULONG kSiteSlotCount = 64;
+SiteSlot g_SiteSlots[kSiteSlotCount] = {};
+volatile LONG g_ActiveSiteSlots = 0;
+volatile LONG g_TagCount = 0;
+volatile LONG64 g_UntrackedTagAllocations = 0;
+#else
+struct ProfileEntry {
+    std::atomic<ULONG> Key{0};
+    std::atomic<long long> AllocationCount{0};
+    std::atomic<long long> FreeCount{0};
+    std::atomic<long long> BytesAllocated{0};
+    std::atomic<long long> LiveBytes{0};
+    std::atomic<long long> PeakLiveBytes{0};
+    std::atomic<long long> Histogram[kHistogramBuckets] = {};
+};
+
+thread_local ULONG t_Site = FCL_ALLOC_SITE_UNKNOWN;
+std::atomic<ULONG> g_TagCount{0};
+std::atomic<long long> g_UntrackedTagAllocations{0};
+#endif
+
+ProfileEntry g_Tags[FCL_ALLOC_PROFILE_MAX_TAGS];
+ProfileEntry g_Sites[FCL_ALLOC_PROFILE_MAX_SITES];
+
+#if FCL_MUSA_KERNEL_MODE
+inline void AddCounter(volatile LONG64& counter, long long value) noexcept {
+    InterlockedAdd64(&counter, value);
+}
+
+inline long long AddAndFetch(volatile LONG64& counter, long long value) noexcept {
+    return InterlockedAdd64(&counter, value);
+}
+
+inline long long ReadCounter(const volatile LONG64& counter) noexcept {
+    return counter;
+}
+
+inline void StoreCounter(volatile LONG64& counter, long long value) noexcept {
+    InterlockedExchange64(&counter, value);
+}
+
+void RaisePeak(volatile LONG64& peak, long long value) noexcept {
+    LONG64 previous = peak;
+    while (value > previous) {
+        const LONG64 observed = InterlockedCompareExchange64(&peak, value, previous);
+        if (observed == previous) {
+            break;
+        }
+        previous = observed;
+    }
+}
+#else
+inline void AddCounter(std::atomic<long long>& counter, long long value) noexcept {
+    counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+inline long long AddAndFetch(std::atomic<long long>& counter, long long value) noexcept {
+    return counter.fetch_add(value, std::memory_order_relaxed) + value;
+}
+
+inline long long ReadCounter(const std::atomic<long long>& counter) noexcept {
+    return counter.load(std::memory_order_relaxed);
+}
+
+inline void StoreCounter(std::atomic<long long>& counter, long long value) noexcept {
+    counter.store(value, std::memory_order_relaxed);
+}
+
+void RaisePeak(std::atomic<long long>& peak, long long value) noexcept {
+    long long previous = peak.load(std::memory_order_relaxed);
+    while (value > previous && !peak.compare_exchange_weak(previous, value, std::memory_order_relaxed)) {
+    }
+}
+#endif
+
+ULONG BucketFor(size_t size) noexcept {
+    ULONG bucket = 0;
+    size_t limit = 16;
+    while (bucket + 1 < kHistogramBuckets && size > limit) {
+        limit <<= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+// 按标记查找表项，未登记时用 CAS 占用第一个空位；标记 0 与表满时返回 NULL。
+ProfileEntry* FindTag(ULONG poolTag, bool insert) noexcept {
+    if (poolTag == 0) {
+        return nullptr;
+    }
+    for (ProfileEntry& entry : g_Tags) {
+#if FCL_MUSA_KERNEL_MODE
+        const ULONG key = static_cast<ULONG>(entry.Key);
+        if (key == poolTag) {
+            return &entry;
+        }
+        if (key == 0) {
+            if (!insert) {
+                return nullptr;
+            }
+            const LONG observed = InterlockedCompareExchange(&entry.Key, static_cast<LONG>(poolTag), 0);
+            if (observed == 0) {
+                InterlockedIncrement(&g_TagCount);
+                return &entry;
+            }
+            if (static_cast<ULONG>(observed) == poolTag) {
+                return &entry;
+            }
+        }
+#else
+        ULONG key = entry.Key.load(std::memory_order_acquire);
+        if (key == poolTag) {
+            return &entry;
+        }
+        if (key == 0) {
+            if (!insert) {
+                return nullptr;
+            }
+            if (entry.Key.compare_exchange_strong(key, poolTag, std::memory_order_acq_rel)) {
+                g_TagCount.fetch_add(1, std::memory_order_relaxed);
+                return &entry;
+            }
+            if (key == poolTag) {
+                return &entry;
+            }
+        }
+#endif
+    }
+    return nullptr;
+}
+
+ProfileEntry& SiteEntry(ULONG site) noexcept {
+    return g_Sites[(site < FCL_ALLOC_PROFILE_MAX_SITES) ? site : static_cast<ULONG>(FCL_ALLOC_SITE_UNKNOWN)];
+}
+
+void RecordAllocation(ProfileEntry& entry, size_t size) noexcept {
+    const long long bytes = static_cast<long long>(size);
+    AddCounter(entry.AllocationCount, 1);
+    AddCounter(entry.BytesAllocated, bytes);
+    AddCounter(entry.Histogram[BucketFor(size)], 1);
+    RaisePeak(entry.PeakLiveBytes, AddAndFetch(entry.LiveBytes, bytes));
+}
+
+void RecordFree(ProfileEntry& entry, size_t size) noexcept {
+    AddCounter(entry.FreeCount, 1);
+    AddCounter(entry.LiveBytes, -static_cast<long long>(size));
+}
+
+void ResetEntry(ProfileEntry& entry) noexcept {
+    StoreCounter(entry.AllocationCount, 0);
+    StoreCounter(entry.FreeCount, 0);
+    StoreCounter(entry.BytesAllocated, 0);
+    StoreCounter(entry.PeakLiveBytes, ReadCounter(entry.LiveBytes));
+    for (auto& bucket : entry.Histogram) {
+        StoreCounter(bucket, 0);
+    }
+}
+
+void SnapshotEntry(const ProfileEntry& entry, ULONG key, FCL_ALLOC_PROFILE_ENTRY* out) noexcept {
+    out->Key = key;
+    out->AllocationCount = static_cast<ULONGLONG>(ReadCounter(entry.AllocationCount));
+    out->FreeCount = static_cast<ULONGLONG>(ReadCounter(entry.FreeCount));
+    out->BytesAllocated = static_cast<ULONGLONG>(ReadCounter(entry.BytesAllocated));
+    const long long live = ReadCounter(entry.LiveBytes);
+    out->LiveBytes = (live > 0) ? static_cast<ULONGLONG>(live) : 0;
+    out->PeakLiveBytes = static_cast<ULONGLONG>(ReadCounter(entry.PeakLiveBytes));
+    for (ULONG i = 0; i < kHistogramBuckets; ++i) {
+        out->SizeHistogram[i] = static_cast<ULONGLONG>(ReadCounter(entry.Histogram[i]));
+    }
+}
+
+#if FCL_MUSA_KERNEL_MODE
+SiteSlot* FindSiteSlot() noexcept {
+    if (g_ActiveSiteSlots == 0) {
+        return nullptr;
+    }
+    const PVOID self = KeGetCurrentThread();
+    const KIRQL irql = KeGetCurrentIrql();
+    for (SiteSlot& slot : g_SiteSlots) {
+        if (slot.Owner == self && slot.Irql == irql) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+SiteSlot* ClaimSiteSlot() noexcept {
+    const PVOID self = KeGetCurrentThread();
+    for (SiteSlot& slot : g_SiteSlots) {
+        if (slot.Owner == nullptr) {
+            slot.Irql = KeGetCurrentIrql();
+            if (InterlockedCompareExchangePointer(&slot.Owner, self, nullptr) == nullptr) {
+                InterlockedIncrement(&g_ActiveSiteSlots);
+                return &slot;
+            }
+        }
+    }
+    return nullptr;
+}
+#endif
+
+}  // namespace
+
+namespace fclmusa::memory {
+
+#if FCL_MUSA_KERNEL_MODE
+
+AllocationSiteScope::AllocationSiteScope(ULONG site) noexcept
+    : slot_(nullptr), previous_(FCL_ALLOC_SITE_UNKNOWN), ownsSlot_(false) {
+    SiteSlot* slot = FindSiteSlot();
+    if (slot == nullptr) {
+        slot = ClaimSiteSlot();
+        ownsSlot_ = (slot != nullptr);
+    }
+    if (slot != nullptr) {
+        previous_ = ownsSlot_ ? FCL_ALLOC_SITE_UNKNOWN : slot->Site;
+        slot->Site = site;
+    }
+    slot_ = slot;
+}
+
+AllocationSiteScope::~AllocationSiteScope() noexcept {
+    auto* slot = static_cast<SiteSlot*>(slot_);
+    if (slot == nullptr) {
+        return;
+    }
+    slot->Site = previous_;
+    if (ownsSlot_) {
+        InterlockedDecrement(&g_ActiveSiteSlots);
+        InterlockedExchangePointer(&slot->Owner, nullptr);
+    }
+}
+
+namespace detail {
+
+ULONG CurrentAllocationSite() noexcept {
+    const SiteSlot* slot = FindSiteSlot();
+    return (slot != nullptr) ? slot->Site : FCL_ALLOC_SITE_UNKNOWN;
+}
+
+}  // namespace detail
+
+#else
+
+AllocationSiteScope::AllocationSiteScope(ULONG site) noexcept
+    : slot_(&t_Site), previous_(t_Site), ownsSlot_(false) {
+    t_Site = site;
+}
+
+AllocationSiteScope::~AllocationSiteScope() noexcept {
+    *static_cast<ULONG*>(slot_) = previous_;
+}
+
+namespace detail {
+
+ULONG CurrentAllocationSite() noexcept {
+    return t_Site;
+}
+
+}  // namespace detail
+
+#endif
+
+namespace detail {
+
+void ProfileAllocation(ULONG poolTag, ULONG site, size_t size) noexcept {
+    ProfileEntry* tag = FindTag(poolTag, true);
+    if (tag != nullptr) {
+        RecordAllocation(*tag, size);
+    } else {
+        AddCounter(g_UntrackedTagAllocations, 1);
+    }
+    RecordAllocation(SiteEntry(site), size);
+}
+
+void ProfileFree(ULONG poolTag, ULONG site, size_t size) noexcept {
+    ProfileEntry* tag = FindTag(poolTag, false);
+    if (tag != nullptr) {
+        RecordFree(*tag, size);
+    }
+    RecordFree(SiteEntry(site), size);
+}
+
+}  // namespace detail
+
+}  // namespace fclmusa::memory
+
+#endif  // FCL_MUSA_ENABLE_ALLOC_PROFILING
+
+extern "C"
+NTSTATUS
+FclQueryAllocationProfile(
+    _Out_ PFCL_ALLOC_PROFILE profile) noexcept {
+    if (profile == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    RtlZeroMemory(profile, sizeof(*profile));
+
+#if FCL_MUSA_ENABLE_ALLOC_PROFILING
+    profile->Enabled = TRUE;
+    profile->UntrackedTagAllocations = static_cast<ULONGLONG>(ReadCounter(g_UntrackedTagAllocations));
+    ULONG tagCount = 0;
+    for (const ProfileEntry& entry : g_Tags) {
+#if FCL_MUSA_KERNEL_MODE
+        const ULONG key = static_cast<ULONG>(entry.Key);
+#else
+        const ULONG key = entry.Key.load(std::memory_order_acquire);
+#endif
+        if (key != 0) {
+            SnapshotEntry(entry, key, &profile->Tags[tagCount++]);
+        }
+    }
+    profile->TagCount = tagCount;
+    for (ULONG site = 0; site < FCL_ALLOC_PROFILE_MAX_SITES; ++site) {
+        SnapshotEntry(g_Sites[site], site, &profile->Sites[site]);
+    }
+    return STATUS_SUCCESS;
+#else
+    return STATUS_NOT_SUPPORTED;
+#endif
+}
+
+extern "C"
+VOID
+FclResetAllocationProfile() noexcept {
+#if FCL_MUSA_ENABLE_ALLOC_PROFILING
+    for (ProfileEntry& entry : g_Tags) {
+        ResetEntry(entry);
+    }
+    for (ProfileEntry& entry : g_Sites) {
+        ResetEntry(entry);
+    }
+    StoreCounter(g_UntrackedTagAllocations, 0);
+#endif
+}
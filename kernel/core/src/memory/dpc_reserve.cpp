@@ -0,0 +1,361 @@
+﻿#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include "fclmusa/memory/dpc_reserve.h"
+
+#include "fclmusa/platform.h"
+#if !FCL_MUSA_KERNEL_MODE
+    #include <atomic>
+    #include <cstdlib>
+#endif
+
+#include "fclmusa/logging.h"
+#include "fclmusa/memory/pool_allocator.h"
+
+namespace {
+
+using fclmusa::memory::kDefaultDpcReserveConfig;
+using fclmusa::memory::kDpcReserveBlockBytes;
+using fclmusa::memory::detail::AllocationHeader;
+using fclmusa::memory::detail::kReserveOrigin;
+
+constexpr ULONG kClassCount = FCL_DPC_RESERVE_CLASS_COUNT;
+
+// 空闲块的前 16 字节存放 SLIST_ENTRY，分配出去后同一位置写 AllocationHeader；块步长均为 16 的倍数，
+// 区域起始地址由池分配保证 16 字节对齐，满足 SLIST 的对齐要求。
+static_assert(sizeof(AllocationHeader) % 16 == 0, "reserve payloads must stay 16-byte aligned");
+static_assert(sizeof(SLIST_ENTRY) <= sizeof(AllocationHeader), "free-list entry must fit in the block header");
+static_assert(kDpcReserveBlockBytes[0] < kDpcReserveBlockBytes[1] && kDpcReserveBlockBytes[1] < kDpcReserveBlockBytes[2],
+    "reserve classes must be ordered by block size");
+
+#if FCL_MUSA_KERNEL_MODE
+struct ReserveClass {
+    SLIST_HEADER FreeList;
+    unsigned char* Base;
+    size_t BlockBytes;
+    ULONG BlockCount;
+    volatile LONG InUse;
+    volatile LONG HighWater;
+    volatile LONG64 Allocations;
+    volatile LONG64 Overflows;
+};
+
+volatile LONG64 g_Exhaustions = 0;
+#else
+struct ReserveClass {
+    SLIST_HEADER FreeList;
+    unsigned char* Base;
+    size_t BlockBytes;
+    ULONG BlockCount;
+    std::atomic<long> InUse{0};
+    std::atomic<long> HighWater{0};
+    std::atomic<unsigned long long> Allocations{0};
+    std::atomic<unsigned long long> Overflows{0};
+};
+
+std::atomic<unsigned long long> g_Exhaustions{0};
+#endif
+
+ReserveClass g_Classes[kClassCount];
+FCL_DPC_RESERVE_CONFIG g_Config = kDefaultDpcReserveConfig;
+// 初始化 / 关闭只在 PASSIVE_LEVEL 且没有 DISPATCH_LEVEL 查询时进行；分配路径只读 Base。
+bool g_Initialized = false;
+
+ULONG ConfiguredCount(const FCL_DPC_RESERVE_CONFIG& config, ULONG cls) noexcept {
+    switch (cls) {
+        case 0:
+            return config.SmallBlockCount;
+        case 1:
+            return config.MediumBlockCount;
+        default:
+            return config.LargeBlockCount;
+    }
+}
+
+void* AllocateRegion(size_t bytes) noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    #if defined(POOL_FLAG_NON_PAGED)
+        return ExAllocatePool2(POOL_FLAG_NON_PAGED, bytes, FCL_MUSA_POOL_TAG);
+    #else
+        return ExAllocatePoolWithTag(NonPagedPoolNx, bytes, FCL_MUSA_POOL_TAG);
+    #endif
+#else
+    return std::malloc(bytes);
+#endif
+}
+
+void FreeRegion(void* region) noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    ExFreePoolWithTag(region, FCL_MUSA_POOL_TAG);
+#else
+    std::free(region);
+#endif
+}
+
+long ReadInUse(const ReserveClass& cls) noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    return cls.InUse;
+#else
+    return cls.InUse.load(std::memory_order_relaxed);
+#endif
+}
+
+void RaiseHighWater(ReserveClass& cls, long inUse) noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    LONG previous = cls.HighWater;
+    while (inUse > previous) {
+        const LONG observed = InterlockedCompareExchange(&cls.HighWater, inUse, previous);
+        if (observed == previous) {
+            break;
+        }
+        previous = observed;
+    }
+#else
+    long previous = cls.HighWater.load(std::memory_order_relaxed);
+    while (inUse > previous && !cls.HighWater.compare_exchange_weak(previous, inUse, std::memory_order_relaxed)) {
+    }
+#endif
+}
+
+void* PopBlock(ReserveClass& cls) noexcept {
+    if (cls.Base == nullptr) {
+        return nullptr;
+    }
+    PSLIST_ENTRY entry = InterlockedPopEntrySList(&cls.FreeList);
+    if (entry == nullptr) {
+        return nullptr;
+    }
+#if FCL_MUSA_KERNEL_MODE
+    const long inUse = InterlockedIncrement(&cls.InUse);
+    InterlockedIncrement64(&cls.Allocations);
+#else
+    const long inUse = cls.InUse.fetch_add(1, std::memory_order_relaxed) + 1;
+    cls.Allocations.fetch_add(1, std::memory_order_relaxed);
+#endif
+    RaiseHighWater(cls, inUse);
+    return entry;
+}
+
+void RecordOverflow(ReserveClass& cls) noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    InterlockedIncrement64(&cls.Overflows);
+#else
+    cls.Overflows.fetch_add(1, std::memory_order_relaxed);
+#endif
+}
+
+void RecordExhaustion() noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    InterlockedIncrement64(&g_Exhaustions);
+#else
+    g_Exhaustions.fetch_add(1, std::memory_order_relaxed);
+#endif
+}
+
+void ResetClassCounters(ReserveClass& cls) noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    InterlockedExchange(&cls.HighWater, cls.InUse);
+    InterlockedExchange64(&cls.Allocations, 0);
+    InterlockedExchange64(&cls.Overflows, 0);
+#else
+    cls.HighWater.store(cls.InUse.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    cls.Allocations.store(0, std::memory_order_relaxed);
+    cls.Overflows.store(0, std::memory_order_relaxed);
+#endif
+}
+
+void ReleaseClasses() noexcept {
+    for (ReserveClass& cls : g_Classes) {
+        if (cls.Base != nullptr) {
+            FreeRegion(cls.Base);
+        }
+        cls.Base = nullptr;
+        cls.BlockCount = 0;
+        InitializeSListHead(&cls.FreeList);
+        ResetClassCounters(cls);
+    }
+    g_Initialized = false;
+}
+
+bool AnyBlockInUse() noexcept {
+    for (const ReserveClass& cls : g_Classes) {
+        if (ReadInUse(cls) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+ULONG ClassOf(const void* block) noexcept {
+    const auto* address = static_cast<const unsigned char*>(block);
+    for (ULONG i = 0; i < kClassCount; ++i) {
+        const ReserveClass& cls = g_Classes[i];
+        if (cls.Base != nullptr && address >= cls.Base && address < cls.Base + cls.BlockBytes * cls.BlockCount) {
+            return i;
+        }
+    }
+    return kClassCount;
+}
+
+}  // namespace
+
+namespace fclmusa::memory {
+
+void SetDpcReserveConfig(const FCL_DPC_RESERVE_CONFIG& config) noexcept {
+    g_Config = config;
+}
+
+FCL_DPC_RESERVE_CONFIG GetDpcReserveConfig() noexcept {
+    return g_Config;
+}
+
+NTSTATUS InitializeDpcReserve() noexcept {
+    if (g_Initialized) {
+        if (AnyBlockInUse()) {
+            FCL_LOG_ERROR0("DPC reserve reinitialization refused: blocks still in use");
+            return STATUS_DEVICE_BUSY;
+        }
+        ReleaseClasses();
+    }
+
+    for (ULONG i = 0; i < kClassCount; ++i) {
+        ReserveClass& cls = g_Classes[i];
+        InitializeSListHead(&cls.FreeList);
+        cls.BlockBytes = kDpcReserveBlockBytes[i];
+        cls.BlockCount = 0;
+        cls.Base = nullptr;
+        ResetClassCounters(cls);
+
+        const ULONG count = ConfiguredCount(g_Config, i);
+        if (count == 0) {
+            continue;
+        }
+        size_t bytes = 0;
+        if (!NT_SUCCESS(RtlSizeTMult(cls.BlockBytes, count, &bytes))) {
+            ReleaseClasses();
+            return STATUS_INTEGER_OVERFLOW;
+        }
+        auto* region = static_cast<unsigned char*>(AllocateRegion(bytes));
+        if (region == nullptr) {
+            FCL_LOG_ERROR("DPC reserve: failed to allocate %llu bytes for class %lu", static_cast<ULONGLONG>(bytes), i);
+            ReleaseClasses();
+            return STATUS_INSUFFICIENT_RESOURCES;
+        }
+        // 逆序压栈，使低地址的块先被取出。
+        for (ULONG block = count; block > 0; --block) {
+            InterlockedPushEntrySList(&cls.FreeList, reinterpret_cast<PSLIST_ENTRY>(region + (block - 1) * cls.BlockBytes));
+        }
+        cls.BlockCount = count;
+        cls.Base = region;
+    }
+
+#if FCL_MUSA_KERNEL_MODE
+    InterlockedExchange64(&g_Exhaustions, 0);
+#else
+    g_Exhaustions.store(0, std::memory_order_relaxed);
+#endif
+    g_Initialized = true;
+    return STATUS_SUCCESS;
+}
+
+void ShutdownDpcReserve() noexcept {
+    if (!g_Initialized) {
+        return;
+    }
+    if (AnyBlockInUse()) {
+        FCL_LOG_ERROR0("DPC reserve shutdown with blocks still in use; keeping reserve memory");
+        return;
+    }
+    ReleaseClasses();
+}
+
+FCL_DPC_RESERVE_STATS QueryDpcReserveStats() noexcept {
+    FCL_DPC_RESERVE_STATS stats = {};
+    for (ULONG i = 0; i < kClassCount; ++i) {
+        const ReserveClass& cls = g_Classes[i];
+        FCL_DPC_RESERVE_CLASS_STATS& out = stats.Classes[i];
+        out.BlockBytes = static_cast<ULONG>(kDpcReserveBlockBytes[i]);
+        out.BlockCount = cls.BlockCount;
+#if FCL_MUSA_KERNEL_MODE
+        out.BlocksInUse = static_cast<ULONG>(cls.InUse);
+        out.HighWaterBlocks = static_cast<ULONG>(cls.HighWater);
+        out.Allocations = static_cast<ULONGLONG>(cls.Allocations);
+        out.Overflows = static_cast<ULONGLONG>(cls.Overflows);
+#else
+        out.BlocksInUse = static_cast<ULONG>(cls.InUse.load(std::memory_order_relaxed));
+        out.HighWaterBlocks = static_cast<ULONG>(cls.HighWater.load(std::memory_order_relaxed));
+        out.Allocations = cls.Allocations.load(std::memory_order_relaxed);
+        out.Overflows = cls.Overflows.load(std::memory_order_relaxed);
+#endif
+        stats.ReserveBytes += static_cast<ULONGLONG>(out.BlockBytes) * out.BlockCount;
+        stats.Allocations += out.Allocations;
+    }
+#if FCL_MUSA_KERNEL_MODE
+    stats.Exhaustions = static_cast<ULONGLONG>(g_Exhaustions);
+#else
+    stats.Exhaustions = g_Exhaustions.load(std::memory_order_relaxed);
+#endif
+    return stats;
+}
+
+void ResetDpcReserveCounters() noexcept {
+    for (ReserveClass& cls : g_Classes) {
+        ResetClassCounters(cls);
+    }
+#if FCL_MUSA_KERNEL_MODE
+    InterlockedExchange64(&g_Exhaustions, 0);
+#else
+    g_Exhaustions.store(0, std::memory_order_relaxed);
+#endif
+}
+
+namespace detail {
+
+void* ReserveAllocate(size_t size, ULONG poolTag) noexcept {
+    ULONG first = kClassCount;
+    if (size <= kDpcReserveBlockBytes[kClassCount - 1] - sizeof(AllocationHeader)) {
+        first = 0;
+        while (kDpcReserveBlockBytes[first] - sizeof(AllocationHeader) < size) {
+            ++first;
+        }
+    }
+
+    void* block = nullptr;
+    for (ULONG i = first; i < kClassCount && block == nullptr; ++i) {
+        block = PopBlock(g_Classes[i]);
+        if (block == nullptr) {
+            RecordOverflow(g_Classes[i]);
+        }
+    }
+    if (block == nullptr) {
+        RecordExhaustion();
+        return nullptr;
+    }
+
+    auto* header = static_cast<AllocationHeader*>(block);
+    header->Size = size;
+    header->Tag = poolTag;
+    header->Origin = kReserveOrigin;
+    return header + 1;
+}
+
+void ReserveFree(void* buffer) noexcept {
+    auto* header = static_cast<AllocationHeader*>(buffer) - 1;
+    const ULONG index = ClassOf(header);
+    if (index == kClassCount) {
+        FCL_LOG_ERROR("DPC reserve: block %p does not belong to the reserve", header);
+        return;
+    }
+    ReserveClass& cls = g_Classes[index];
+    InterlockedPushEntrySList(&cls.FreeList, reinterpret_cast<PSLIST_ENTRY>(header));
+#if FCL_MUSA_KERNEL_MODE
+    InterlockedDecrement(&cls.InUse);
+#else
+    cls.InUse.fetch_sub(1, std::memory_order_relaxed);
+#endif
+}
+
+}  // namespace detail
+
+}  // namespace fclmusa::memory
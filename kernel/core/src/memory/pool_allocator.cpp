@@ -11,52 +11,114 @@
     #include <cstdlib>
     #include <cstring>
     #include <limits>
-    #include <mutex>
     #include <new>
 #endif
     #include <algorithm>
 
 #include "fclmusa/logging.h"
+#include "fclmusa/memory/dpc_reserve.h"
 #include "fclmusa/memory/pool_allocator.h"
+#include "fclmusa/memory/query_arena.h"
+#include "fclmusa/memory/slab_allocator.h"
 
 namespace {
 
-struct alignas(void*) AllocationHeader {
-    size_t Size;
-    ULONG Tag;
-};
+using fclmusa::memory::detail::AllocationHeader;
+using fclmusa::memory::detail::kArenaOrigin;
+using fclmusa::memory::detail::kPoolOrigin;
+using fclmusa::memory::detail::kReserveOrigin;
+using fclmusa::memory::detail::kSlabOrigin;
+
+// 统计分片：内核态按 CPU 编号、用户态按线程取模，每片独占一条缓存行；
+// 同一片上的更新基本不跨核竞争，QueryStats 时才把所有分片相加。
+constexpr ULONG kStatShardCount = 64;
 
 #if FCL_MUSA_KERNEL_MODE
-EX_PUSH_LOCK g_PoolLock = 0;  // Will be initialized in InitializePoolTracking
-volatile LONG64 g_AllocationCount = 0;
-volatile LONG64 g_FreeCount = 0;
-volatile LONG64 g_BytesAllocated = 0;
-volatile LONG64 g_BytesFreed = 0;
-volatile LONG64 g_BytesInUse = 0;
+struct alignas(64) StatShard {
+    volatile LONG64 AllocationCount;
+    volatile LONG64 FreeCount;
+    volatile LONG64 BytesAllocated;
+    volatile LONG64 BytesFreed;
+    volatile LONG64 BytesInUse;
+};
+
+StatShard g_StatShards[kStatShardCount] = {};
 volatile LONG64 g_PeakBytesInUse = 0;
 BOOLEAN g_TrackingEnabled = FALSE;
 #else
-std::mutex g_PoolMutex;
-std::atomic<long long> g_AllocationCount{0};
-std::atomic<long long> g_FreeCount{0};
-std::atomic<long long> g_BytesAllocated{0};
-std::atomic<long long> g_BytesFreed{0};
-std::atomic<long long> g_BytesInUse{0};
+struct alignas(64) StatShard {
+    std::atomic<long long> AllocationCount{0};
+    std::atomic<long long> FreeCount{0};
+    std::atomic<long long> BytesAllocated{0};
+    std::atomic<long long> BytesFreed{0};
+    std::atomic<long long> BytesInUse{0};
+};
+
+StatShard g_StatShards[kStatShardCount];
 std::atomic<long long> g_PeakBytesInUse{0};
+std::atomic<ULONG> g_NextShard{0};
+thread_local ULONG t_ShardIndex = kStatShardCount;
 bool g_TrackingEnabled = false;
 #endif
 
+StatShard& CurrentShard() noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    return g_StatShards[KeGetCurrentProcessorNumberEx(nullptr) % kStatShardCount];
+#else
+    if (t_ShardIndex == kStatShardCount) {
+        t_ShardIndex = g_NextShard.fetch_add(1, std::memory_order_relaxed) % kStatShardCount;
+    }
+    return g_StatShards[t_ShardIndex];
+#endif
+}
+
+#if FCL_MUSA_KERNEL_MODE
+inline void AddCounter(volatile LONG64& counter, long long value) noexcept {
+    InterlockedAdd64(&counter, value);
+}
+
+inline long long ReadCounter(const volatile LONG64& counter) noexcept {
+    return counter;
+}
+
+inline void ClearCounter(volatile LONG64& counter) noexcept {
+    InterlockedExchange64(&counter, 0);
+}
+#else
+inline void AddCounter(std::atomic<long long>& counter, long long value) noexcept {
+    counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+inline long long ReadCounter(const std::atomic<long long>& counter) noexcept {
+    return counter.load(std::memory_order_relaxed);
+}
+
+inline void ClearCounter(std::atomic<long long>& counter) noexcept {
+    counter.store(0, std::memory_order_relaxed);
+}
+#endif
+
 void ResetStatsUnsafe() {
-    g_AllocationCount = 0;
-    g_FreeCount = 0;
-    g_BytesAllocated = 0;
-    g_BytesFreed = 0;
-    g_BytesInUse = 0;
-    g_PeakBytesInUse = 0;
+    for (StatShard& shard : g_StatShards) {
+        ClearCounter(shard.AllocationCount);
+        ClearCounter(shard.FreeCount);
+        ClearCounter(shard.BytesAllocated);
+        ClearCounter(shard.BytesFreed);
+        ClearCounter(shard.BytesInUse);
+    }
+    ClearCounter(g_PeakBytesInUse);
+}
+
+long long SumBytesInUse() noexcept {
+    long long inUse = 0;
+    for (const StatShard& shard : g_StatShards) {
+        inUse += ReadCounter(shard.BytesInUse);
+    }
+    return inUse;
 }
 
 void UpdatePeak(long long inUse) {
-    long long previous = g_PeakBytesInUse;
+    long long previous = ReadCounter(g_PeakBytesInUse);
     while (inUse > previous) {
 #if FCL_MUSA_KERNEL_MODE
         const long long observed = InterlockedCompareExchange64(&g_PeakBytesInUse, inUse, previous);
@@ -74,6 +136,20 @@ void UpdatePeak(long long inUse) {
     }
 }
 
+void RecordAllocation(size_t size) noexcept {
+    StatShard& shard = CurrentShard();
+    AddCounter(shard.AllocationCount, 1);
+    AddCounter(shard.BytesAllocated, static_cast<long long>(size));
+    AddCounter(shard.BytesInUse, static_cast<long long>(size));
+}
+
+void RecordFree(size_t size) noexcept {
+    StatShard& shard = CurrentShard();
+    AddCounter(shard.FreeCount, 1);
+    AddCounter(shard.BytesFreed, static_cast<long long>(size));
+    AddCounter(shard.BytesInUse, -static_cast<long long>(size));
+}
+
 size_t RequestedSizeWithHeader(size_t payload) {
 #if FCL_MUSA_KERNEL_MODE
     size_t total = 0;
@@ -89,92 +165,139 @@ size_t RequestedSizeWithHeader(size_t payload) {
 #endif
 }
 
+void* AllocateFromSystem(size_t size, ULONG poolTag) noexcept {
+    const size_t totalSize = RequestedSizeWithHeader(size);
+    if (totalSize == 0) {
+        return nullptr;
+    }
+
+    void* raw = nullptr;
+#if FCL_MUSA_KERNEL_MODE
+    #if defined(POOL_FLAG_NON_PAGED)
+        raw = ExAllocatePool2(POOL_FLAG_NON_PAGED, totalSize, poolTag);
+    #else
+        raw = ExAllocatePoolWithTag(NonPagedPoolNx, totalSize, poolTag);
+    #endif
+#else
+    raw = std::malloc(totalSize);
+#endif
+
+    if (raw == nullptr) {
+        return nullptr;
+    }
+
+    auto* header = reinterpret_cast<AllocationHeader*>(raw);
+    header->Size = size;
+    header->Tag = poolTag;
+    header->Origin = kPoolOrigin;
+    return header + 1;
+}
+
 }  // namespace
 
 namespace fclmusa::memory {
 
 void InitializePoolTracking() {
-#if FCL_MUSA_KERNEL_MODE
-    ExInitializePushLock(&g_PoolLock);
-    ExEnterCriticalRegionAndAcquirePushLockExclusive(&g_PoolLock);
+    detail::InitializeSlabCaches();
+    const NTSTATUS reserveStatus = InitializeDpcReserve();
+    if (!NT_SUCCESS(reserveStatus)) {
+        FCL_LOG_WARN("DPC reserve unavailable (0x%X); dispatch-level allocations will fail", reserveStatus);
+    }
     ResetStatsUnsafe();
-    ExReleasePushLockExclusiveAndLeaveCriticalRegion(&g_PoolLock);
     g_TrackingEnabled = TRUE;
-#else
-    std::lock_guard<std::mutex> guard(g_PoolMutex);
-    ResetStatsUnsafe();
-    g_TrackingEnabled = true;
-#endif
 }
 
 void ShutdownPoolTracking() {
-#if FCL_MUSA_KERNEL_MODE
-    ExEnterCriticalRegionAndAcquirePushLockExclusive(&g_PoolLock);
+    ReleaseQueryArenas();
+    detail::ShutdownSlabCaches();
+    ShutdownDpcReserve();
     g_TrackingEnabled = FALSE;
     ResetStatsUnsafe();
-    ExReleasePushLockExclusiveAndLeaveCriticalRegion(&g_PoolLock);
-#else
-    std::lock_guard<std::mutex> guard(g_PoolMutex);
-    g_TrackingEnabled = false;
-    ResetStatsUnsafe();
-#endif
 }
 
 void EnablePoolTracking(BOOLEAN enable) {
     g_TrackingEnabled = enable ? true : false;
 }
 
-void* Allocate(size_t size, ULONG poolTag) noexcept {
+namespace detail {
+
+// 小块优先从 slab 的本地 magazine 取；更大的请求（或 slab 不可用时）直接走 ExAllocatePool2 / malloc。
+// DISPATCH_LEVEL 及以上只从 DPC 预留池取块，避免 slab 申请新页或系统池在 DPC 中失败。
+void* AllocateFromPool(size_t size, ULONG poolTag) noexcept {
     NON_PAGED_CODE;
 
-#if FCL_MUSA_KERNEL_MODE
-    if (g_TrackingEnabled && KeGetCurrentIrql() != PASSIVE_LEVEL) {
-        FCL_LOG_ERROR("Allocate called at IRQL %u with tracking enabled", KeGetCurrentIrql());
-        return nullptr;
+    bool fromSystem = false;
+    void* payload = nullptr;
+    if (IsDpcReserveIrql()) {
+        payload = ReserveAllocate(size, poolTag);
+    } else {
+        payload = SlabAllocate(size, poolTag);
+        if (payload == nullptr) {
+            payload = AllocateFromSystem(size, poolTag);
+            fromSystem = true;
+        }
     }
-#endif
-
-    const size_t totalSize = RequestedSizeWithHeader(size);
-    if (totalSize == 0) {
+    if (payload == nullptr) {
         return nullptr;
     }
 
-    void* raw = nullptr;
-#if FCL_MUSA_KERNEL_MODE
-    #if defined(POOL_FLAG_NON_PAGED)
-        raw = ExAllocatePool2(POOL_FLAG_NON_PAGED, totalSize, poolTag);
-    #else
-        raw = ExAllocatePoolWithTag(NonPagedPoolNx, totalSize, poolTag);
-    #endif
-#else
-    raw = std::malloc(totalSize);
-#endif
-
-    if (raw == nullptr) {
-        return nullptr;
+    if (g_TrackingEnabled) {
+        RecordAllocation(size);
+        if (fromSystem) {
+            UpdatePeak(SumBytesInUse());
+        }
     }
+    return payload;
+}
 
-    auto* header = reinterpret_cast<AllocationHeader*>(raw);
-    header->Size = size;
-    header->Tag = poolTag;
-    void* payload = header + 1;
+void FreeToPool(void* buffer, ULONG poolTag) noexcept {
+    if (buffer == nullptr) {
+        return;
+    }
 
+    auto* header = reinterpret_cast<AllocationHeader*>(buffer) - 1;
     if (g_TrackingEnabled) {
+        RecordFree(header->Size);
+    }
+
+    if (header->Origin == kSlabOrigin) {
+        SlabFree(buffer);
+        return;
+    }
+    if (header->Origin == kReserveOrigin) {
+        ReserveFree(buffer);
+        return;
+    }
 #if FCL_MUSA_KERNEL_MODE
-        ExEnterCriticalRegionAndAcquirePushLockExclusive(&g_PoolLock);
+    ExFreePoolWithTag(header, poolTag);
 #else
-        std::lock_guard<std::mutex> guard(g_PoolMutex);
-#endif
-        g_AllocationCount++;
-        g_BytesAllocated += static_cast<long long>(header->Size);
-        g_BytesInUse += static_cast<long long>(header->Size);
-        UpdatePeak(g_BytesInUse);
-#if FCL_MUSA_KERNEL_MODE
-        ExReleasePushLockExclusiveAndLeaveCriticalRegion(&g_PoolLock);
+    UNREFERENCED_PARAMETER(poolTag);
+    std::free(header);
 #endif
-    }
+}
 
-    return payload;
+}  // namespace detail
+
+// 当前线程处于 QueryArenaScope 内时优先从查询 arena 分配，不触碰池统计；否则走池分配。
+// DISPATCH_LEVEL 及以上不使用 arena（用户态模拟 IRQL 时线程的 arena 可能仍处于绑定状态）。
+void* Allocate(size_t size, ULONG poolTag) noexcept {
+    NON_PAGED_CODE;
+
+    void* buffer = nullptr;
+    if (!IsDpcReserveIrql()) {
+        buffer = detail::ArenaAllocate(size, poolTag);
+    }
+    if (buffer == nullptr) {
+        buffer = detail::AllocateFromPool(size, poolTag);
+    }
+#if FCL_MUSA_ENABLE_ALLOC_PROFILING
+    if (buffer != nullptr) {
+        auto* header = reinterpret_cast<AllocationHeader*>(buffer) - 1;
+        header->Site = detail::CurrentAllocationSite();
+        detail::ProfileAllocation(poolTag, header->Site, size);
+    }
+#endif
+    return buffer;
 }
 
 size_t QueryAllocationSize(const void* buffer) noexcept {
@@ -195,50 +318,15 @@ void* Reallocate(void* buffer, size_t size, ULONG poolTag) noexcept {
         return nullptr;
     }
 
-    const size_t totalSize = RequestedSizeWithHeader(size);
-    if (totalSize == 0) {
-        return nullptr;
-    }
-
     auto* header = reinterpret_cast<AllocationHeader*>(buffer) - 1;
     const size_t bytesToCopy = (std::min)(size, header->Size);
 
-    void* raw = nullptr;
-#if FCL_MUSA_KERNEL_MODE
-    #if defined(POOL_FLAG_NON_PAGED)
-        raw = ExAllocatePool2(POOL_FLAG_NON_PAGED, totalSize, poolTag);
-    #else
-        raw = ExAllocatePoolWithTag(NonPagedPoolNx, totalSize, poolTag);
-    #endif
-#else
-    raw = std::malloc(totalSize);
-#endif
-
-    if (raw == nullptr) {
+    void* newBuffer = Allocate(size, poolTag);
+    if (newBuffer == nullptr) {
         return nullptr;
     }
-
-    auto* newHeader = reinterpret_cast<AllocationHeader*>(raw);
-    newHeader->Size = size;
-    newHeader->Tag = poolTag;
-    void* newBuffer = newHeader + 1;
     std::memcpy(newBuffer, buffer, bytesToCopy);
 
-    if (g_TrackingEnabled) {
-#if FCL_MUSA_KERNEL_MODE
-        ExEnterCriticalRegionAndAcquirePushLockExclusive(&g_PoolLock);
-#else
-        std::lock_guard<std::mutex> guard(g_PoolMutex);
-#endif
-        g_AllocationCount++;
-        g_BytesAllocated += static_cast<long long>(newHeader->Size);
-        g_BytesInUse += static_cast<long long>(newHeader->Size);
-        UpdatePeak(g_BytesInUse);
-#if FCL_MUSA_KERNEL_MODE
-        ExReleasePushLockExclusiveAndLeaveCriticalRegion(&g_PoolLock);
-#endif
-    }
-
     Free(buffer, poolTag);
     return newBuffer;
 }
@@ -252,45 +340,39 @@ void Free(void* buffer, ULONG poolTag) noexcept {
     if (header->Tag != poolTag) {
         FCL_LOG_WARN("PoolAllocator::Free tag mismatch (expected %lu, got %lu)", poolTag, header->Tag);
     }
-
-    if (g_TrackingEnabled) {
-#if FCL_MUSA_KERNEL_MODE
-        ExEnterCriticalRegionAndAcquirePushLockExclusive(&g_PoolLock);
-#else
-        std::lock_guard<std::mutex> guard(g_PoolMutex);
+#if FCL_MUSA_ENABLE_ALLOC_PROFILING
+    detail::ProfileFree(header->Tag, header->Site, header->Size);
 #endif
-        g_FreeCount++;
-        g_BytesFreed += static_cast<long long>(header->Size);
-        g_BytesInUse -= static_cast<long long>(header->Size);
-#if FCL_MUSA_KERNEL_MODE
-        ExReleasePushLockExclusiveAndLeaveCriticalRegion(&g_PoolLock);
-#endif
-    }
 
-#if FCL_MUSA_KERNEL_MODE
-    ExFreePoolWithTag(header, poolTag);
-#else
-    std::free(header);
-#endif
+    if (header->Origin == kArenaOrigin) {
+        detail::ArenaFree(buffer);
+        return;
+    }
+    detail::FreeToPool(buffer, poolTag);
 }
 
 FCL_POOL_STATS QueryStats() noexcept {
     FCL_POOL_STATS stats = {};
     if (g_TrackingEnabled) {
-#if FCL_MUSA_KERNEL_MODE
-        ExEnterCriticalRegionAndAcquirePushLockShared(&g_PoolLock);
-#else
-        std::lock_guard<std::mutex> guard(g_PoolMutex);
-#endif
-        stats.AllocationCount = g_AllocationCount;
-        stats.FreeCount = g_FreeCount;
-        stats.BytesAllocated = g_BytesAllocated;
-        stats.BytesFreed = g_BytesFreed;
-        stats.BytesInUse = g_BytesInUse;
-        stats.PeakBytesInUse = g_PeakBytesInUse;
-#if FCL_MUSA_KERNEL_MODE
-        ExReleasePushLockSharedAndLeaveCriticalRegion(&g_PoolLock);
-#endif
+        long long allocations = 0;
+        long long frees = 0;
+        long long bytesAllocated = 0;
+        long long bytesFreed = 0;
+        long long inUse = 0;
+        for (const StatShard& shard : g_StatShards) {
+            allocations += ReadCounter(shard.AllocationCount);
+            frees += ReadCounter(shard.FreeCount);
+            bytesAllocated += ReadCounter(shard.BytesAllocated);
+            bytesFreed += ReadCounter(shard.BytesFreed);
+            inUse += ReadCounter(shard.BytesInUse);
+        }
+        UpdatePeak(inUse);
+        stats.AllocationCount = static_cast<ULONGLONG>(allocations);
+        stats.FreeCount = static_cast<ULONGLONG>(frees);
+        stats.BytesAllocated = static_cast<ULONGLONG>(bytesAllocated);
+        stats.BytesFreed = static_cast<ULONGLONG>(bytesFreed);
+        stats.BytesInUse = static_cast<ULONGLONG>(inUse);
+        stats.PeakBytesInUse = static_cast<ULONGLONG>(ReadCounter(g_PeakBytesInUse));
     }
     return stats;
 }
@@ -0,0 +1,376 @@
+﻿#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include "fclmusa/memory/query_arena.h"
+
+#include "fclmusa/platform.h"
+#if !FCL_MUSA_KERNEL_MODE
+    #include <atomic>
+#endif
+#include <algorithm>
+
+#include "fclmusa/memory/dpc_reserve.h"
+#include "fclmusa/memory/pool_allocator.h"
+
+namespace {
+
+using fclmusa::memory::kQueryArenaInitialChunkBytes;
+using fclmusa::memory::kQueryArenaMaxBlockBytes;
+using fclmusa::memory::kQueryArenaMaxRetainedBytes;
+using fclmusa::memory::detail::AllocateFromPool;
+using fclmusa::memory::detail::AllocationHeader;
+using fclmusa::memory::detail::FreeToPool;
+using fclmusa::memory::detail::kArenaOrigin;
+
+constexpr size_t kArenaAlignment = 16;
+
+// 数据区紧跟在块头之后；块头按 16 字节对齐，保证每个分配块的负载同样 16 字节对齐。
+struct alignas(16) ArenaChunk {
+    ArenaChunk* Next;
+    size_t Capacity;
+    size_t Offset;
+
+    unsigned char* Data() noexcept {
+        return reinterpret_cast<unsigned char*>(this + 1);
+    }
+};
+
+struct QueryArena {
+    ArenaChunk* Head;
+    size_t RetainCapacity;
+    size_t ScopeBytes;
+    ULONGLONG Allocations;
+    ULONGLONG Bytes;
+    ULONGLONG Fallbacks;
+    ULONGLONG Chunks;
+#if FCL_MUSA_KERNEL_MODE
+    PVOID volatile Owner;
+    volatile BOOLEAN Bound;
+    KIRQL Irql;
+#endif
+};
+
+#if FCL_MUSA_KERNEL_MODE
+// 内核态没有 thread_local：按 (线程, IRQL) 绑定槽位，同一线程上被打断的 DPC 因 IRQL 不同不会误用调用者的 arena。
+constexpr ULONG kArenaSlotCount = 64;
+QueryArena g_ArenaSlots[kArenaSlotCount] = {};
+volatile LONG g_ActiveArenaCount = 0;
+volatile LONG g_ArenaEnabled = 1;
+volatile LONG64 g_ScopeCount = 0;
+volatile LONG64 g_ArenaAllocations = 0;
+volatile LONG64 g_ArenaBytes = 0;
+volatile LONG64 g_FallbackAllocations = 0;
+volatile LONG64 g_ChunkAllocations = 0;
+volatile LONG64 g_PeakScopeBytes = 0;
+#else
+struct ThreadArena {
+    QueryArena Arena = {};
+    bool Bound = false;
+
+    ~ThreadArena();
+};
+
+thread_local ThreadArena t_Arena;
+std::atomic<bool> g_ArenaEnabled{true};
+std::atomic<unsigned long long> g_ScopeCount{0};
+std::atomic<unsigned long long> g_ArenaAllocations{0};
+std::atomic<unsigned long long> g_ArenaBytes{0};
+std::atomic<unsigned long long> g_FallbackAllocations{0};
+std::atomic<unsigned long long> g_ChunkAllocations{0};
+std::atomic<unsigned long long> g_PeakScopeBytes{0};
+#endif
+
+size_t BlockBytes(size_t payload) noexcept {
+    const size_t raw = sizeof(AllocationHeader) + payload;
+    return (raw + kArenaAlignment - 1) & ~(kArenaAlignment - 1);
+}
+
+void ReleaseChunks(QueryArena* arena) noexcept {
+    ArenaChunk* chunk = arena->Head;
+    while (chunk != nullptr) {
+        ArenaChunk* next = chunk->Next;
+        FreeToPool(chunk, FCL_MUSA_POOL_TAG);
+        chunk = next;
+    }
+    arena->Head = nullptr;
+}
+
+// 新块容量取上一块的两倍（首块取上次溢出后记录的总容量），并限制在保留上限内。
+bool Grow(QueryArena* arena, size_t blockBytes) noexcept {
+    size_t capacity = (arena->Head != nullptr) ? arena->Head->Capacity * 2 : arena->RetainCapacity;
+    capacity = (std::max)(capacity, kQueryArenaInitialChunkBytes);
+    capacity = (std::min)(capacity, kQueryArenaMaxRetainedBytes);
+    capacity = (std::max)(capacity, blockBytes);
+
+    void* raw = AllocateFromPool(sizeof(ArenaChunk) + capacity, FCL_MUSA_POOL_TAG);
+    if (raw == nullptr) {
+        return false;
+    }
+
+    auto* chunk = static_cast<ArenaChunk*>(raw);
+    chunk->Next = arena->Head;
+    chunk->Capacity = capacity;
+    chunk->Offset = 0;
+    arena->Head = chunk;
+    arena->Chunks++;
+    return true;
+}
+
+// 单块时只把偏移归零；本次作用域溢出到多个块时全部归还，下次按总容量申请一整块，之后恢复 O(1) 复位。
+void ResetArena(QueryArena* arena) noexcept {
+    if (arena->Head != nullptr && arena->Head->Next != nullptr) {
+        size_t total = 0;
+        for (const ArenaChunk* chunk = arena->Head; chunk != nullptr; chunk = chunk->Next) {
+            total += chunk->Capacity;
+        }
+        ReleaseChunks(arena);
+        arena->RetainCapacity = (std::min)(total, kQueryArenaMaxRetainedBytes);
+    } else if (arena->Head != nullptr) {
+        arena->Head->Offset = 0;
+    }
+    arena->ScopeBytes = 0;
+}
+
+// 统计在作用域结束时一次性汇总，分配路径上不做原子操作。
+void PublishStats(QueryArena* arena) noexcept {
+    const long long scopeBytes = static_cast<long long>(arena->ScopeBytes);
+#if FCL_MUSA_KERNEL_MODE
+    InterlockedIncrement64(&g_ScopeCount);
+    InterlockedAdd64(&g_ArenaAllocations, static_cast<LONG64>(arena->Allocations));
+    InterlockedAdd64(&g_ArenaBytes, static_cast<LONG64>(arena->Bytes));
+    InterlockedAdd64(&g_FallbackAllocations, static_cast<LONG64>(arena->Fallbacks));
+    InterlockedAdd64(&g_ChunkAllocations, static_cast<LONG64>(arena->Chunks));
+    LONG64 previous = g_PeakScopeBytes;
+    while (scopeBytes > previous) {
+        const LONG64 observed = InterlockedCompareExchange64(&g_PeakScopeBytes, scopeBytes, previous);
+        if (observed == previous) {
+            break;
+        }
+        previous = observed;
+    }
+#else
+    g_ScopeCount.fetch_add(1, std::memory_order_relaxed);
+    g_ArenaAllocations.fetch_add(arena->Allocations, std::memory_order_relaxed);
+    g_ArenaBytes.fetch_add(arena->Bytes, std::memory_order_relaxed);
+    g_FallbackAllocations.fetch_add(arena->Fallbacks, std::memory_order_relaxed);
+    g_ChunkAllocations.fetch_add(arena->Chunks, std::memory_order_relaxed);
+    unsigned long long previous = g_PeakScopeBytes.load(std::memory_order_relaxed);
+    while (static_cast<unsigned long long>(scopeBytes) > previous &&
+           !g_PeakScopeBytes.compare_exchange_weak(previous, static_cast<unsigned long long>(scopeBytes))) {
+    }
+#endif
+    arena->Allocations = 0;
+    arena->Bytes = 0;
+    arena->Fallbacks = 0;
+    arena->Chunks = 0;
+}
+
+#if FCL_MUSA_KERNEL_MODE
+
+QueryArena* FindArena() noexcept {
+    if (g_ActiveArenaCount == 0) {
+        return nullptr;
+    }
+    const PVOID self = KeGetCurrentThread();
+    const KIRQL irql = KeGetCurrentIrql();
+    for (ULONG i = 0; i < kArenaSlotCount; ++i) {
+        QueryArena& slot = g_ArenaSlots[i];
+        if (slot.Owner == self && slot.Bound && slot.Irql == irql) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+QueryArena* AcquireArena() noexcept {
+    if (g_ArenaEnabled == 0 || FindArena() != nullptr) {
+        return nullptr;
+    }
+    const PVOID self = KeGetCurrentThread();
+    for (ULONG i = 0; i < kArenaSlotCount; ++i) {
+        QueryArena& slot = g_ArenaSlots[i];
+        if (InterlockedCompareExchangePointer(&slot.Owner, self, nullptr) == nullptr) {
+            slot.Irql = KeGetCurrentIrql();
+            slot.Bound = TRUE;
+            InterlockedIncrement(&g_ActiveArenaCount);
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+void ReleaseArena(QueryArena* arena) noexcept {
+    arena->Bound = FALSE;
+    InterlockedDecrement(&g_ActiveArenaCount);
+    InterlockedExchangePointer(&arena->Owner, nullptr);
+}
+
+#else
+
+ThreadArena::~ThreadArena() {
+    ReleaseChunks(&Arena);
+}
+
+QueryArena* FindArena() noexcept {
+    return t_Arena.Bound ? &t_Arena.Arena : nullptr;
+}
+
+QueryArena* AcquireArena() noexcept {
+    if (!g_ArenaEnabled.load(std::memory_order_relaxed) || t_Arena.Bound) {
+        return nullptr;
+    }
+    t_Arena.Bound = true;
+    return &t_Arena.Arena;
+}
+
+void ReleaseArena(QueryArena*) noexcept {
+    t_Arena.Bound = false;
+}
+
+#endif
+
+}  // namespace
+
+namespace fclmusa::memory {
+
+void EnableQueryArena(BOOLEAN enable) noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    InterlockedExchange(&g_ArenaEnabled, enable ? 1 : 0);
+#else
+    g_ArenaEnabled.store(enable != FALSE, std::memory_order_relaxed);
+#endif
+}
+
+BOOLEAN IsQueryArenaEnabled() noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    return (g_ArenaEnabled != 0) ? TRUE : FALSE;
+#else
+    return g_ArenaEnabled.load(std::memory_order_relaxed) ? TRUE : FALSE;
+#endif
+}
+
+FCL_QUERY_ARENA_STATS QueryArenaStats() noexcept {
+    FCL_QUERY_ARENA_STATS stats = {};
+#if FCL_MUSA_KERNEL_MODE
+    stats.ScopeCount = static_cast<ULONGLONG>(g_ScopeCount);
+    stats.ArenaAllocations = static_cast<ULONGLONG>(g_ArenaAllocations);
+    stats.ArenaBytes = static_cast<ULONGLONG>(g_ArenaBytes);
+    stats.FallbackAllocations = static_cast<ULONGLONG>(g_FallbackAllocations);
+    stats.ChunkAllocations = static_cast<ULONGLONG>(g_ChunkAllocations);
+    stats.PeakScopeBytes = static_cast<ULONGLONG>(g_PeakScopeBytes);
+#else
+    stats.ScopeCount = g_ScopeCount.load(std::memory_order_relaxed);
+    stats.ArenaAllocations = g_ArenaAllocations.load(std::memory_order_relaxed);
+    stats.ArenaBytes = g_ArenaBytes.load(std::memory_order_relaxed);
+    stats.FallbackAllocations = g_FallbackAllocations.load(std::memory_order_relaxed);
+    stats.ChunkAllocations = g_ChunkAllocations.load(std::memory_order_relaxed);
+    stats.PeakScopeBytes = g_PeakScopeBytes.load(std::memory_order_relaxed);
+#endif
+    return stats;
+}
+
+void ResetQueryArenaStats() noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    InterlockedExchange64(&g_ScopeCount, 0);
+    InterlockedExchange64(&g_ArenaAllocations, 0);
+    InterlockedExchange64(&g_ArenaBytes, 0);
+    InterlockedExchange64(&g_FallbackAllocations, 0);
+    InterlockedExchange64(&g_ChunkAllocations, 0);
+    InterlockedExchange64(&g_PeakScopeBytes, 0);
+#else
+    g_ScopeCount.store(0, std::memory_order_relaxed);
+    g_ArenaAllocations.store(0, std::memory_order_relaxed);
+    g_ArenaBytes.store(0, std::memory_order_relaxed);
+    g_FallbackAllocations.store(0, std::memory_order_relaxed);
+    g_ChunkAllocations.store(0, std::memory_order_relaxed);
+    g_PeakScopeBytes.store(0, std::memory_order_relaxed);
+#endif
+}
+
+void ReleaseQueryArenas() noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    // 以槽位数组地址作为占位所有者锁住空闲槽位，避免与正在进入作用域的线程竞争。
+    const PVOID sentinel = g_ArenaSlots;
+    for (ULONG i = 0; i < kArenaSlotCount; ++i) {
+        QueryArena& slot = g_ArenaSlots[i];
+        if (InterlockedCompareExchangePointer(&slot.Owner, sentinel, nullptr) == nullptr) {
+            ReleaseChunks(&slot);
+            slot.RetainCapacity = 0;
+            InterlockedExchangePointer(&slot.Owner, nullptr);
+        }
+    }
+#else
+    if (!t_Arena.Bound) {
+        ReleaseChunks(&t_Arena.Arena);
+        t_Arena.Arena.RetainCapacity = 0;
+    }
+#endif
+}
+
+// DISPATCH_LEVEL 及以上的分配由 DPC 预留池负责，arena 块不从预留池申请也不在 DPC 中保留。
+QueryArenaScope::QueryArenaScope() noexcept
+    : arena_(IsDpcReserveIrql() ? nullptr : AcquireArena()) {}
+
+QueryArenaScope::~QueryArenaScope() noexcept {
+    if (arena_ == nullptr) {
+        return;
+    }
+    auto* arena = static_cast<QueryArena*>(arena_);
+    PublishStats(arena);
+    ResetArena(arena);
+    ReleaseArena(arena);
+}
+
+namespace detail {
+
+void* ArenaAllocate(size_t size, ULONG poolTag) noexcept {
+    QueryArena* arena = FindArena();
+    if (arena == nullptr) {
+        return nullptr;
+    }
+    if (size > kQueryArenaMaxBlockBytes) {
+        arena->Fallbacks++;
+        return nullptr;
+    }
+
+    const size_t blockBytes = BlockBytes(size);
+    ArenaChunk* chunk = arena->Head;
+    if (chunk == nullptr || chunk->Capacity - chunk->Offset < blockBytes) {
+        if (!Grow(arena, blockBytes)) {
+            arena->Fallbacks++;
+            return nullptr;
+        }
+        chunk = arena->Head;
+    }
+
+    auto* header = reinterpret_cast<AllocationHeader*>(chunk->Data() + chunk->Offset);
+    chunk->Offset += blockBytes;
+    header->Size = size;
+    header->Tag = poolTag;
+    header->Origin = kArenaOrigin;
+
+    arena->Allocations++;
+    arena->Bytes += size;
+    arena->ScopeBytes += blockBytes;
+    return header + 1;
+}
+
+// 只回收位于当前块栈顶的块（vector 扩容、libccd 临时缓冲的典型释放顺序），其余留到作用域结束统一复位。
+void ArenaFree(void* buffer) noexcept {
+    QueryArena* arena = FindArena();
+    if (arena == nullptr || arena->Head == nullptr) {
+        return;
+    }
+    auto* header = static_cast<AllocationHeader*>(buffer) - 1;
+    const size_t blockBytes = BlockBytes(header->Size);
+    ArenaChunk* chunk = arena->Head;
+    if (chunk->Offset >= blockBytes &&
+        reinterpret_cast<unsigned char*>(header) == chunk->Data() + chunk->Offset - blockBytes) {
+        chunk->Offset -= blockBytes;
+    }
+}
+
+}  // namespace detail
+
+}  // namespace fclmusa::memory
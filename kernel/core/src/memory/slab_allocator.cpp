@@ -0,0 +1,585 @@
+﻿#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include "fclmusa/memory/slab_allocator.h"
+
+#include "fclmusa/platform.h"
+#if !FCL_MUSA_KERNEL_MODE
+    #include <atomic>
+    #include <cstdlib>
+    #include <mutex>
+#endif
+
+#include "fclmusa/logging.h"
+#include "fclmusa/memory/pool_allocator.h"
+
+namespace {
+
+using fclmusa::memory::kSlabMagazineCapacity;
+using fclmusa::memory::kSlabMaxBlockBytes;
+using fclmusa::memory::kSlabPageBytes;
+using fclmusa::memory::kSlabTransferCount;
+using fclmusa::memory::detail::AllocationHeader;
+using fclmusa::memory::detail::kSlabOrigin;
+
+// 块大小（含 AllocationHeader）按 16 字节递增到 128，之后每翻一倍分 4 档。
+constexpr size_t kClassSizes[] = {
+    32, 48, 64, 80, 96, 112, 128,
+    160, 192, 224, 256,
+    320, 384, 448, 512,
+    640, 768, 896, 1024,
+    1280, 1536, 1792, 2048,
+};
+constexpr ULONG kClassCount = static_cast<ULONG>(sizeof(kClassSizes) / sizeof(kClassSizes[0]));
+constexpr size_t kClassGranularity = 16;
+
+struct ClassTable {
+    unsigned char Index[kSlabMaxBlockBytes / kClassGranularity + 1];
+};
+
+constexpr ClassTable BuildClassTable() {
+    ClassTable table = {};
+    ULONG cls = 0;
+    for (size_t slot = 0; slot <= kSlabMaxBlockBytes / kClassGranularity; ++slot) {
+        while (kClassSizes[cls] < slot * kClassGranularity) {
+            ++cls;
+        }
+        table.Index[slot] = static_cast<unsigned char>(cls);
+    }
+    return table;
+}
+
+constexpr ClassTable kClassTable = BuildClassTable();
+
+static_assert(kClassSizes[kClassCount - 1] == kSlabMaxBlockBytes, "largest class must match kSlabMaxBlockBytes");
+static_assert(sizeof(AllocationHeader) % kClassGranularity == 0, "slab payloads must stay 16-byte aligned");
+
+ULONG ClassForBlock(size_t blockBytes) noexcept {
+    return kClassTable.Index[(blockBytes + kClassGranularity - 1) / kClassGranularity];
+}
+
+struct FreeBlock {
+    FreeBlock* Next;
+};
+
+struct alignas(16) SlabPage {
+    SlabPage* Next;
+    size_t Bytes;
+};
+
+struct Magazine {
+    ULONG Count;
+    void* Blocks[kSlabMagazineCapacity];
+};
+
+struct alignas(64) MagazineSet {
+    Magazine Magazines[kClassCount];
+#if FCL_MUSA_KERNEL_MODE
+    KDPC FlushDpc;  // 关闭时定向到所属 CPU，在该 CPU 上所有 CacheGuard 退出后清空 magazine
+#endif
+};
+
+#if FCL_MUSA_KERNEL_MODE
+struct Depot {
+    KSPIN_LOCK Lock;
+    FreeBlock* Head;
+    ULONGLONG Count;
+    ULONGLONG Carved;
+};
+
+Depot g_Depots[kClassCount] = {};
+KSPIN_LOCK g_PageLock = 0;
+SlabPage* g_Pages = nullptr;
+MagazineSet* volatile g_CpuCaches = nullptr;
+ULONG g_CpuCacheCount = 0;
+volatile LONG g_SlabEnabled = 1;
+volatile LONG64 g_SlabPageCount = 0;
+volatile LONG64 g_SlabBytes = 0;
+volatile LONG64 g_DepotRefills = 0;
+volatile LONG64 g_DepotFlushes = 0;
+#else
+struct Depot {
+    std::mutex Lock;
+    FreeBlock* Head = nullptr;
+    ULONGLONG Count = 0;
+    ULONGLONG Carved = 0;
+};
+
+Depot g_Depots[kClassCount];
+std::mutex g_PageLock;
+SlabPage* g_Pages = nullptr;
+std::atomic<bool> g_SlabEnabled{true};
+std::atomic<unsigned long long> g_SlabPageCount{0};
+std::atomic<unsigned long long> g_SlabBytes{0};
+std::atomic<unsigned long long> g_DepotRefills{0};
+std::atomic<unsigned long long> g_DepotFlushes{0};
+
+// 线程缓存本身是平凡类型，线程退出时由 ThreadCacheFlusher 把块还给 depot 并标记失效，
+// 之后（其它 thread_local 析构期间）的分配 / 释放直接走 depot。
+struct ThreadCache {
+    MagazineSet Set;
+    bool Registered;
+    bool Dead;
+};
+
+thread_local ThreadCache t_Cache;
+
+struct ThreadCacheFlusher {
+    ~ThreadCacheFlusher();
+};
+
+thread_local ThreadCacheFlusher t_Flusher;
+#endif
+
+// ---- depot ----
+
+class DepotLock {
+public:
+    explicit DepotLock(Depot& depot) noexcept
+        : depot_(depot) {
+#if FCL_MUSA_KERNEL_MODE
+        // 调用方已处于 DISPATCH_LEVEL（见 CacheGuard）。
+        KeAcquireSpinLockAtDpcLevel(&depot_.Lock);
+#else
+        depot_.Lock.lock();
+#endif
+    }
+
+    ~DepotLock() {
+#if FCL_MUSA_KERNEL_MODE
+        KeReleaseSpinLockFromDpcLevel(&depot_.Lock);
+#else
+        depot_.Lock.unlock();
+#endif
+    }
+
+    DepotLock(const DepotLock&) = delete;
+    DepotLock& operator=(const DepotLock&) = delete;
+
+private:
+    Depot& depot_;
+};
+
+void* AllocatePage() noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    #if defined(POOL_FLAG_NON_PAGED)
+        return ExAllocatePool2(POOL_FLAG_NON_PAGED, kSlabPageBytes, FCL_MUSA_POOL_TAG);
+    #else
+        return ExAllocatePoolWithTag(NonPagedPoolNx, kSlabPageBytes, FCL_MUSA_POOL_TAG);
+    #endif
+#else
+    return std::malloc(kSlabPageBytes);
+#endif
+}
+
+void FreePage(void* page) noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    ExFreePoolWithTag(page, FCL_MUSA_POOL_TAG);
+#else
+    std::free(page);
+#endif
+}
+
+// 申请一页并切成该级别的块，整体挂入 depot；页头记入全局页链表供关闭时释放。
+bool GrowClass(ULONG cls) noexcept {
+    void* raw = AllocatePage();
+    if (raw == nullptr) {
+        return false;
+    }
+
+    auto* page = static_cast<SlabPage*>(raw);
+    page->Bytes = kSlabPageBytes;
+    {
+#if FCL_MUSA_KERNEL_MODE
+        KeAcquireSpinLockAtDpcLevel(&g_PageLock);
+        page->Next = g_Pages;
+        g_Pages = page;
+        KeReleaseSpinLockFromDpcLevel(&g_PageLock);
+        InterlockedIncrement64(&g_SlabPageCount);
+        InterlockedAdd64(&g_SlabBytes, static_cast<LONG64>(kSlabPageBytes));
+#else
+        std::lock_guard<std::mutex> guard(g_PageLock);
+        page->Next = g_Pages;
+        g_Pages = page;
+        g_SlabPageCount.fetch_add(1, std::memory_order_relaxed);
+        g_SlabBytes.fetch_add(kSlabPageBytes, std::memory_order_relaxed);
+#endif
+    }
+
+    const size_t blockBytes = kClassSizes[cls];
+    const size_t blockCount = (kSlabPageBytes - sizeof(SlabPage)) / blockBytes;
+    auto* base = reinterpret_cast<unsigned char*>(page + 1);
+    FreeBlock* head = nullptr;
+    for (size_t i = blockCount; i > 0; --i) {
+        auto* block = reinterpret_cast<FreeBlock*>(base + (i - 1) * blockBytes);
+        block->Next = head;
+        head = block;
+    }
+    FreeBlock* tail = reinterpret_cast<FreeBlock*>(base + (blockCount - 1) * blockBytes);
+
+    Depot& depot = g_Depots[cls];
+    DepotLock lock(depot);
+    tail->Next = depot.Head;
+    depot.Head = head;
+    depot.Count += blockCount;
+    depot.Carved += blockCount;
+    return true;
+}
+
+// 从 depot 取至多 kSlabTransferCount 个块装入空 magazine；depot 为空时先整页扩充。
+bool RefillMagazine(ULONG cls, Magazine* magazine) noexcept {
+    Depot& depot = g_Depots[cls];
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        {
+            DepotLock lock(depot);
+            while (depot.Head != nullptr && magazine->Count < kSlabTransferCount) {
+                FreeBlock* block = depot.Head;
+                depot.Head = block->Next;
+                depot.Count--;
+                magazine->Blocks[magazine->Count++] = block;
+            }
+        }
+        if (magazine->Count != 0) {
+#if FCL_MUSA_KERNEL_MODE
+            InterlockedIncrement64(&g_DepotRefills);
+#else
+            g_DepotRefills.fetch_add(1, std::memory_order_relaxed);
+#endif
+            return true;
+        }
+        if (!GrowClass(cls)) {
+            return false;
+        }
+    }
+    return false;
+}
+
+// magazine 满时把最早进入的 kSlabTransferCount 个块还给 depot，保留最近释放（缓存仍热）的一半。
+void FlushMagazine(ULONG cls, Magazine* magazine, ULONG count) noexcept {
+    Depot& depot = g_Depots[cls];
+    {
+        DepotLock lock(depot);
+        for (ULONG i = 0; i < count; ++i) {
+            auto* block = static_cast<FreeBlock*>(magazine->Blocks[i]);
+            block->Next = depot.Head;
+            depot.Head = block;
+        }
+        depot.Count += count;
+    }
+    for (ULONG i = count; i < magazine->Count; ++i) {
+        magazine->Blocks[i - count] = magazine->Blocks[i];
+    }
+    magazine->Count -= count;
+#if FCL_MUSA_KERNEL_MODE
+    InterlockedIncrement64(&g_DepotFlushes);
+#else
+    g_DepotFlushes.fetch_add(1, std::memory_order_relaxed);
+#endif
+}
+
+void* PopDepot(ULONG cls) noexcept {
+    Magazine scratch = {};
+    if (!RefillMagazine(cls, &scratch)) {
+        return nullptr;
+    }
+    void* block = scratch.Blocks[--scratch.Count];
+    if (scratch.Count != 0) {
+        FlushMagazine(cls, &scratch, scratch.Count);
+    }
+    return block;
+}
+
+void PushDepot(ULONG cls, void* block) noexcept {
+    Magazine scratch = {};
+    scratch.Blocks[scratch.Count++] = block;
+    FlushMagazine(cls, &scratch, 1);
+}
+
+// ---- 本地缓存 ----
+
+// 内核态：提升到 DISPATCH_LEVEL 固定在当前 CPU 上再取该 CPU 的 magazine；用户态：取线程缓存。
+// 缓存不可用（内核态尚未初始化 / 用户态线程正在退出）时 Set() 为 NULL，调用方直接操作 depot。
+class CacheGuard {
+public:
+    CacheGuard() noexcept {
+#if FCL_MUSA_KERNEL_MODE
+        oldIrql_ = KeGetCurrentIrql();
+        if (oldIrql_ < DISPATCH_LEVEL) {
+            KeRaiseIrql(DISPATCH_LEVEL, &oldIrql_);
+            raised_ = true;
+        }
+        MagazineSet* caches = g_CpuCaches;
+        const ULONG cpu = KeGetCurrentProcessorNumberEx(nullptr);
+        set_ = (caches != nullptr && cpu < g_CpuCacheCount) ? &caches[cpu] : nullptr;
+#else
+        if (!t_Cache.Registered) {
+            t_Cache.Registered = true;
+            static_cast<void>(&t_Flusher);
+        }
+        set_ = t_Cache.Dead ? nullptr : &t_Cache.Set;
+#endif
+    }
+
+    ~CacheGuard() {
+#if FCL_MUSA_KERNEL_MODE
+        if (raised_) {
+            KeLowerIrql(oldIrql_);
+        }
+#endif
+    }
+
+    CacheGuard(const CacheGuard&) = delete;
+    CacheGuard& operator=(const CacheGuard&) = delete;
+
+    MagazineSet* Set() const noexcept {
+        return set_;
+    }
+
+private:
+    MagazineSet* set_ = nullptr;
+#if FCL_MUSA_KERNEL_MODE
+    KIRQL oldIrql_ = PASSIVE_LEVEL;
+    bool raised_ = false;
+#endif
+};
+
+void FlushMagazineSet(MagazineSet* set) noexcept {
+    for (ULONG cls = 0; cls < kClassCount; ++cls) {
+        Magazine& magazine = set->Magazines[cls];
+        if (magazine.Count != 0) {
+            FlushMagazine(cls, &magazine, magazine.Count);
+        }
+    }
+}
+
+#if FCL_MUSA_KERNEL_MODE
+// CacheGuard 全程处于 DISPATCH_LEVEL，定向 DPC 只能在该 CPU 上的 guard 全部退出后运行。
+_Function_class_(KDEFERRED_ROUTINE)
+VOID
+FlushCpuCacheDpc(
+    _In_ PKDPC dpc,
+    _In_opt_ PVOID context,
+    _In_opt_ PVOID argument1,
+    _In_opt_ PVOID argument2) {
+    UNREFERENCED_PARAMETER(dpc);
+    UNREFERENCED_PARAMETER(argument1);
+    UNREFERENCED_PARAMETER(argument2);
+    FlushMagazineSet(static_cast<MagazineSet*>(context));
+}
+#else
+ThreadCacheFlusher::~ThreadCacheFlusher() {
+    FlushMagazineSet(&t_Cache.Set);
+    t_Cache.Dead = true;
+}
+#endif
+
+bool SlabEnabled() noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    return g_SlabEnabled != 0;
+#else
+    return g_SlabEnabled.load(std::memory_order_relaxed);
+#endif
+}
+
+}  // namespace
+
+namespace fclmusa::memory {
+
+void EnableSlabCache(BOOLEAN enable) noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    InterlockedExchange(&g_SlabEnabled, enable ? 1 : 0);
+#else
+    g_SlabEnabled.store(enable != FALSE, std::memory_order_relaxed);
+#endif
+}
+
+BOOLEAN IsSlabCacheEnabled() noexcept {
+    return SlabEnabled() ? TRUE : FALSE;
+}
+
+FCL_SLAB_STATS QuerySlabStats() noexcept {
+    FCL_SLAB_STATS stats = {};
+#if FCL_MUSA_KERNEL_MODE
+    stats.SlabPages = static_cast<ULONGLONG>(g_SlabPageCount);
+    stats.SlabBytes = static_cast<ULONGLONG>(g_SlabBytes);
+    stats.DepotRefills = static_cast<ULONGLONG>(g_DepotRefills);
+    stats.DepotFlushes = static_cast<ULONGLONG>(g_DepotFlushes);
+#else
+    stats.SlabPages = g_SlabPageCount.load(std::memory_order_relaxed);
+    stats.SlabBytes = g_SlabBytes.load(std::memory_order_relaxed);
+    stats.DepotRefills = g_DepotRefills.load(std::memory_order_relaxed);
+    stats.DepotFlushes = g_DepotFlushes.load(std::memory_order_relaxed);
+#endif
+    return stats;
+}
+
+namespace detail {
+
+void InitializeSlabCaches() noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    if (g_CpuCaches != nullptr) {
+        return;
+    }
+    const ULONG cpuCount = KeQueryMaximumProcessorCountEx(ALL_PROCESSOR_GROUPS);
+    const size_t bytes = sizeof(MagazineSet) * cpuCount;
+    #if defined(POOL_FLAG_NON_PAGED)
+        auto* caches = static_cast<MagazineSet*>(ExAllocatePool2(POOL_FLAG_NON_PAGED, bytes, FCL_MUSA_POOL_TAG));
+    #else
+        auto* caches = static_cast<MagazineSet*>(ExAllocatePoolWithTag(NonPagedPoolNx, bytes, FCL_MUSA_POOL_TAG));
+        if (caches != nullptr) {
+            RtlZeroMemory(caches, bytes);
+        }
+    #endif
+    if (caches == nullptr) {
+        FCL_LOG_WARN0("Slab per-CPU caches unavailable; small allocations use the depot directly");
+        return;
+    }
+    g_CpuCacheCount = cpuCount;
+    InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(&g_CpuCaches), caches);
+#endif
+}
+
+// 先把本地 magazine 全部还给 depot；只有每个切出的块都已回到 depot（没有存活的 slab 块）时才释放页面。
+// 内核态须在 PASSIVE_LEVEL 调用：摘下 per-CPU 数组后向每个活动 CPU 排队一个 DPC 并 KeFlushQueuedDpcs，
+// 确保仍持有旧数组指针的 CacheGuard 都已退出，再释放数组。
+void ShutdownSlabCaches() noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    if (KeGetCurrentIrql() != PASSIVE_LEVEL) {
+        FCL_LOG_WARN0("Slab shutdown requires PASSIVE_LEVEL; keeping per-CPU caches");
+        return;
+    }
+    MagazineSet* caches = static_cast<MagazineSet*>(
+        InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(&g_CpuCaches), nullptr));
+    const ULONG cacheCount = g_CpuCacheCount;
+    if (caches != nullptr) {
+        // 活动处理器的索引连续；其余槽位没有 CPU 会访问，直接清空。
+        const ULONG activeCount = KeQueryActiveProcessorCountEx(ALL_PROCESSOR_GROUPS);
+        for (ULONG cpu = 0; cpu < cacheCount; ++cpu) {
+            PROCESSOR_NUMBER processor = {};
+            KeInitializeDpc(&caches[cpu].FlushDpc, FlushCpuCacheDpc, &caches[cpu]);
+            if (cpu < activeCount &&
+                NT_SUCCESS(KeGetProcessorNumberFromIndex(cpu, &processor)) &&
+                NT_SUCCESS(KeSetTargetProcessorDpcEx(&caches[cpu].FlushDpc, &processor))) {
+                KeInsertQueueDpc(&caches[cpu].FlushDpc, nullptr, nullptr);
+            } else {
+                // depot 锁要求 DISPATCH_LEVEL。
+                KIRQL flushIrql = PASSIVE_LEVEL;
+                KeRaiseIrql(DISPATCH_LEVEL, &flushIrql);
+                FlushMagazineSet(&caches[cpu]);
+                KeLowerIrql(flushIrql);
+            }
+        }
+        KeFlushQueuedDpcs();
+    }
+
+    KIRQL oldIrql = PASSIVE_LEVEL;
+    KeRaiseIrql(DISPATCH_LEVEL, &oldIrql);
+#else
+    {
+        CacheGuard guard;
+        if (guard.Set() != nullptr) {
+            FlushMagazineSet(guard.Set());
+        }
+    }
+#endif
+
+    bool allReturned = true;
+    for (ULONG cls = 0; cls < kClassCount && allReturned; ++cls) {
+        DepotLock lock(g_Depots[cls]);
+        allReturned = g_Depots[cls].Count == g_Depots[cls].Carved;
+    }
+
+    SlabPage* pages = nullptr;
+    if (allReturned) {
+        for (ULONG cls = 0; cls < kClassCount; ++cls) {
+            DepotLock lock(g_Depots[cls]);
+            g_Depots[cls].Head = nullptr;
+            g_Depots[cls].Count = 0;
+            g_Depots[cls].Carved = 0;
+        }
+#if FCL_MUSA_KERNEL_MODE
+        KeAcquireSpinLockAtDpcLevel(&g_PageLock);
+        pages = g_Pages;
+        g_Pages = nullptr;
+        KeReleaseSpinLockFromDpcLevel(&g_PageLock);
+#else
+        std::lock_guard<std::mutex> guard(g_PageLock);
+        pages = g_Pages;
+        g_Pages = nullptr;
+#endif
+    } else {
+        FCL_LOG_WARN0("Slab blocks still in use at shutdown; keeping slab pages");
+    }
+
+#if FCL_MUSA_KERNEL_MODE
+    KeLowerIrql(oldIrql);
+    if (caches != nullptr) {
+        ExFreePoolWithTag(caches, FCL_MUSA_POOL_TAG);
+    }
+#endif
+
+    while (pages != nullptr) {
+        SlabPage* next = pages->Next;
+#if FCL_MUSA_KERNEL_MODE
+        InterlockedDecrement64(&g_SlabPageCount);
+        InterlockedAdd64(&g_SlabBytes, -static_cast<LONG64>(pages->Bytes));
+#else
+        g_SlabPageCount.fetch_sub(1, std::memory_order_relaxed);
+        g_SlabBytes.fetch_sub(pages->Bytes, std::memory_order_relaxed);
+#endif
+        FreePage(pages);
+        pages = next;
+    }
+}
+
+void* SlabAllocate(size_t size, ULONG poolTag) noexcept {
+    if (size > kSlabMaxBlockBytes - sizeof(AllocationHeader) || !SlabEnabled()) {
+        return nullptr;
+    }
+    const ULONG cls = ClassForBlock(sizeof(AllocationHeader) + size);
+
+    void* block = nullptr;
+    {
+        CacheGuard guard;
+        MagazineSet* set = guard.Set();
+        if (set != nullptr) {
+            Magazine& magazine = set->Magazines[cls];
+            if (magazine.Count != 0 || RefillMagazine(cls, &magazine)) {
+                block = magazine.Blocks[--magazine.Count];
+            }
+        } else {
+            block = PopDepot(cls);
+        }
+    }
+    if (block == nullptr) {
+        return nullptr;
+    }
+
+    auto* header = static_cast<AllocationHeader*>(block);
+    header->Size = size;
+    header->Tag = poolTag;
+    header->Origin = kSlabOrigin;
+    return header + 1;
+}
+
+void SlabFree(void* buffer) noexcept {
+    auto* header = static_cast<AllocationHeader*>(buffer) - 1;
+    const ULONG cls = ClassForBlock(sizeof(AllocationHeader) + header->Size);
+
+    CacheGuard guard;
+    MagazineSet* set = guard.Set();
+    if (set == nullptr) {
+        PushDepot(cls, header);
+        return;
+    }
+    Magazine& magazine = set->Magazines[cls];
+    if (magazine.Count == kSlabMagazineCapacity) {
+        FlushMagazine(cls, &magazine, kSlabTransferCount);
+    }
+    magazine.Blocks[magazine.Count++] = header;
+}
+
+}  // namespace detail
+
+}  // namespace fclmusa::memory
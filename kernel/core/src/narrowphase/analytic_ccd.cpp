@@ -0,0 +1,483 @@
+#include "fclmusa/narrowphase/analytic_ccd.h"
+
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/geometry/obb.h"
+#include "fclmusa/narrowphase/primitive_kernels.h"
+#include "fclmusa/narrowphase/query_dispatch.h"
+
+namespace {
+
+using namespace fclmusa::geom;
+
+constexpr float kRotationTolerance = 1e-6f;
+constexpr float kDirectionEpsilon = 1e-12f;
+
+struct SweptSphere {
+    FCL_VECTOR3 Center;   // t = 0 时的世界坐标球心
+    float Radius;
+};
+
+bool SameRotation(const FCL_MATRIX3X3& a, const FCL_MATRIX3X3& b) noexcept {
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 3; ++col) {
+            if (fabs(a.M[row][col] - b.M[row][col]) > kRotationTolerance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// 运动期间物体是否只做平移：球心与参考点重合的球体不受旋转影响。
+bool IsTranslational(const FCL_GEOMETRY_SNAPSHOT& object, const FCL_INTERP_MOTION& motion) noexcept {
+    if (SameRotation(motion.Start.Rotation, motion.End.Rotation)) {
+        return true;
+    }
+    if (object.Type != FCL_GEOMETRY_SPHERE) {
+        return false;
+    }
+    const FCL_VECTOR3& center = object.Data.Sphere.Center;
+    return center.X == 0.0f && center.Y == 0.0f && center.Z == 0.0f;
+}
+
+bool IsValidPrimitive(const FCL_GEOMETRY_SNAPSHOT& object) noexcept {
+    using fclmusa::narrowphase::ShapeTraits;
+    return (object.Type == FCL_GEOMETRY_SPHERE)
+        ? ShapeTraits<FCL_GEOMETRY_SPHERE>::IsValid(object.Data.Sphere)
+        : ShapeTraits<FCL_GEOMETRY_OBB>::IsValid(object.Data.Obb);
+}
+
+FCL_VECTOR3 Displacement(const FCL_INTERP_MOTION& motion) noexcept {
+    return Subtract(motion.End.Translation, motion.Start.Translation);
+}
+
+FCL_TRANSFORM PoseAt(const FCL_INTERP_MOTION& motion, double t) noexcept {
+    FCL_TRANSFORM pose = motion.Start;
+    pose.Translation = LerpVector(motion.Start.Translation, motion.End.Translation, t);
+    return pose;
+}
+
+SweptSphere BuildSweptSphere(const FCL_GEOMETRY_SNAPSHOT& object, const FCL_INTERP_MOTION& motion) noexcept {
+    return {TransformPoint(motion.Start, object.Data.Sphere.Center), object.Data.Sphere.Radius};
+}
+
+// 线段 origin + t * direction（t ∈ [0, 1]）与球面的首个交点；起点在球内视为不相交（由调用方先排除）。
+bool SegmentSphere(
+    const FCL_VECTOR3& origin,
+    const FCL_VECTOR3& direction,
+    const FCL_VECTOR3& center,
+    float radius,
+    _Out_ float* t) noexcept {
+    const FCL_VECTOR3 m = Subtract(origin, center);
+    const double a = Dot(direction, direction);
+    const double b = Dot(m, direction);
+    const double c = static_cast<double>(Dot(m, m)) - static_cast<double>(radius) * radius;
+    if (a <= kDirectionEpsilon || (c > 0.0 && b > 0.0)) {
+        return false;
+    }
+    const double discriminant = b * b - a * c;
+    if (discriminant < 0.0) {
+        return false;
+    }
+    const double hit = (-b - sqrt(discriminant)) / a;
+    if (hit > 1.0) {
+        return false;
+    }
+    *t = static_cast<float>((hit > 0.0) ? hit : 0.0);
+    return true;
+}
+
+// 线段与以 p-q 为轴、半径 radius 的圆柱侧面的首个交点（端盖由两端球面负责）。
+bool SegmentCylinderSide(
+    const FCL_VECTOR3& origin,
+    const FCL_VECTOR3& direction,
+    const FCL_VECTOR3& p,
+    const FCL_VECTOR3& q,
+    float radius,
+    _Out_ float* t) noexcept {
+    const FCL_VECTOR3 d = Subtract(q, p);
+    const FCL_VECTOR3 m = Subtract(origin, p);
+    const double dd = Dot(d, d);
+    const double nd = Dot(direction, d);
+    const double md = Dot(m, d);
+    const double nn = Dot(direction, direction);
+    const double mn = Dot(m, direction);
+    const double a = dd * nn - nd * nd;
+    if (fabs(a) <= kDirectionEpsilon * dd) {
+        return false;  // 运动方向与轴平行，只可能撞到端部球面
+    }
+    const double k = static_cast<double>(Dot(m, m)) - static_cast<double>(radius) * radius;
+    const double b = dd * mn - nd * md;
+    const double c = dd * k - md * md;
+    const double discriminant = b * b - a * c;
+    if (discriminant < 0.0) {
+        return false;
+    }
+    const double hit = (-b - sqrt(discriminant)) / a;
+    if (hit < 0.0 || hit > 1.0) {
+        return false;
+    }
+    const double axial = md + hit * nd;
+    if (axial < 0.0 || axial > dd) {
+        return false;
+    }
+    *t = static_cast<float>(hit);
+    return true;
+}
+
+bool SegmentCapsule(
+    const FCL_VECTOR3& origin,
+    const FCL_VECTOR3& direction,
+    const FCL_VECTOR3& p,
+    const FCL_VECTOR3& q,
+    float radius,
+    _Out_ float* t) noexcept {
+    float best = FLT_MAX;
+    float candidate = 0.0f;
+    if (SegmentCylinderSide(origin, direction, p, q, radius, &candidate) && candidate < best) {
+        best = candidate;
+    }
+    if (SegmentSphere(origin, direction, p, radius, &candidate) && candidate < best) {
+        best = candidate;
+    }
+    if (SegmentSphere(origin, direction, q, radius, &candidate) && candidate < best) {
+        best = candidate;
+    }
+    if (best == FLT_MAX) {
+        return false;
+    }
+    *t = best;
+    return true;
+}
+
+// 线段与 AABB [-extents, extents] 的 slab 测试，返回进入时刻与进入点。
+bool SegmentAabb(
+    const FCL_VECTOR3& origin,
+    const FCL_VECTOR3& direction,
+    const FCL_VECTOR3& extents,
+    _Out_ float* t,
+    _Out_ FCL_VECTOR3* point) noexcept {
+    float tMin = 0.0f;
+    float tMax = 1.0f;
+    for (int axis = 0; axis < 3; ++axis) {
+        const float o = (&origin.X)[axis];
+        const float d = (&direction.X)[axis];
+        const float e = (&extents.X)[axis];
+        if (fabs(d) <= kSingularityEpsilon) {
+            if (o < -e || o > e) {
+                return false;
+            }
+            continue;
+        }
+        float t1 = (-e - o) / d;
+        float t2 = (e - o) / d;
+        if (t1 > t2) {
+            const float swap = t1;
+            t1 = t2;
+            t2 = swap;
+        }
+        tMin = (t1 > tMin) ? t1 : tMin;
+        tMax = (t2 < tMax) ? t2 : tMax;
+        if (tMin > tMax) {
+            return false;
+        }
+    }
+    *t = tMin;
+    *point = Add(origin, Scale(direction, tMin));
+    return true;
+}
+
+FCL_VECTOR3 BoxCorner(const FCL_VECTOR3& extents, int mask) noexcept {
+    return {
+        (mask & 1) ? extents.X : -extents.X,
+        (mask & 2) ? extents.Y : -extents.Y,
+        (mask & 4) ? extents.Z : -extents.Z};
+}
+
+// 球沿 sphereMove、盒沿 boxMove 平移时的首次接触时刻；要求 t = 0 时不相交。
+bool SweptSphereObb(
+    const SweptSphere& sphere,
+    const FCL_VECTOR3& sphereMove,
+    const OrientedBox& box,
+    const FCL_VECTOR3& boxMove,
+    _Out_ float* toi) noexcept {
+    const FCL_VECTOR3 offset = Subtract(sphere.Center, box.Center);
+    const FCL_VECTOR3 relative = Subtract(sphereMove, boxMove);
+    const FCL_VECTOR3 origin = {Dot(offset, box.Axes[0]), Dot(offset, box.Axes[1]), Dot(offset, box.Axes[2])};
+    const FCL_VECTOR3 direction = {Dot(relative, box.Axes[0]), Dot(relative, box.Axes[1]), Dot(relative, box.Axes[2])};
+    const FCL_VECTOR3 expanded = {
+        box.Extents.X + sphere.Radius,
+        box.Extents.Y + sphere.Radius,
+        box.Extents.Z + sphere.Radius};
+
+    float t = 0.0f;
+    FCL_VECTOR3 point = {};
+    if (!SegmentAabb(origin, direction, expanded, &t, &point)) {
+        return false;
+    }
+
+    // 进入点位于原盒哪些面之外：只越过一个面为面区域（slab 结果即精确解），否则落在圆角的边 / 顶点区域。
+    int below = 0;
+    int above = 0;
+    for (int axis = 0; axis < 3; ++axis) {
+        const float value = (&point.X)[axis];
+        const float extent = (&box.Extents.X)[axis];
+        if (value < -extent) {
+            below |= (1 << axis);
+        } else if (value > extent) {
+            above |= (1 << axis);
+        }
+    }
+    const int region = below | above;
+    if (region == 7) {
+        float best = FLT_MAX;
+        for (int bit = 1; bit < 8; bit <<= 1) {
+            float candidate = 0.0f;
+            if (SegmentCapsule(origin, direction, BoxCorner(box.Extents, above), BoxCorner(box.Extents, above ^ bit), sphere.Radius, &candidate) &&
+                candidate < best) {
+                best = candidate;
+            }
+        }
+        if (best == FLT_MAX) {
+            return false;
+        }
+        t = best;
+    } else if ((region & (region - 1)) != 0) {
+        if (!SegmentCapsule(origin, direction, BoxCorner(box.Extents, below ^ 7), BoxCorner(box.Extents, above), sphere.Radius, &t)) {
+            return false;
+        }
+    }
+    *toi = t;
+    return true;
+}
+
+bool SweptSphereSphere(
+    const SweptSphere& sphere1,
+    const FCL_VECTOR3& move1,
+    const SweptSphere& sphere2,
+    const FCL_VECTOR3& move2,
+    _Out_ float* toi) noexcept {
+    float t = 0.0f;
+    if (!SegmentSphere(sphere1.Center, Subtract(move1, move2), sphere2.Center, sphere1.Radius + sphere2.Radius, &t)) {
+        return false;
+    }
+    *toi = t;
+    return true;
+}
+
+// 15 轴扫掠分离轴：每根轴上投影区间重叠的时间段取交集，交集非空时其起点即 TOI。
+bool SweptObbObb(
+    const OrientedBox& box1,
+    const FCL_VECTOR3& move1,
+    const OrientedBox& box2,
+    const FCL_VECTOR3& move2,
+    _Out_ float* toi,
+    _Out_ FCL_VECTOR3* normal) noexcept {
+    FCL_VECTOR3 axes[15] = {};
+    int axisCount = 0;
+    for (int i = 0; i < 3; ++i) {
+        axes[axisCount++] = box1.Axes[i];
+        axes[axisCount++] = box2.Axes[i];
+    }
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            const FCL_VECTOR3 cross = Cross(box1.Axes[i], box2.Axes[j]);
+            const float length = Length(cross);
+            if (length > kAxisEpsilon) {
+                axes[axisCount++] = Scale(cross, 1.0f / length);
+            }
+        }
+    }
+
+    const FCL_VECTOR3 offset = Subtract(box2.Center, box1.Center);
+    const FCL_VECTOR3 relative = Subtract(move2, move1);
+    float enter = 0.0f;
+    float leave = 1.0f;
+    FCL_VECTOR3 enterNormal = {0.0f, 0.0f, 0.0f};
+    for (int index = 0; index < axisCount; ++index) {
+        const FCL_VECTOR3& axis = axes[index];
+        float reach = 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            reach += (&box1.Extents.X)[k] * static_cast<float>(fabs(Dot(axis, box1.Axes[k])));
+            reach += (&box2.Extents.X)[k] * static_cast<float>(fabs(Dot(axis, box2.Axes[k])));
+        }
+        const float start = Dot(offset, axis);
+        const float speed = Dot(relative, axis);
+        if (fabs(speed) <= kSingularityEpsilon) {
+            if (fabs(start) > reach) {
+                return false;
+            }
+            continue;
+        }
+        float t1 = (-reach - start) / speed;
+        float t2 = (reach - start) / speed;
+        if (t1 > t2) {
+            const float swap = t1;
+            t1 = t2;
+            t2 = swap;
+        }
+        if (t1 > enter) {
+            enter = t1;
+            enterNormal = (start + speed * t1 >= 0.0f) ? axis : Scale(axis, -1.0f);
+        }
+        leave = (t2 < leave) ? t2 : leave;
+        if (enter > leave) {
+            return false;
+        }
+    }
+    // 所有轴都在 t = 0 前已重叠（仅在与静态测试的容差边界上出现），以中心连线作为法线。
+    if (Length(enterNormal) <= kSingularityEpsilon) {
+        enterNormal = Normalize(offset);
+    }
+    *toi = enter;
+    *normal = enterNormal;
+    return true;
+}
+
+// 接触点：球面上沿法线的点；盒取到对方最近的表面点。法线统一为对象 1 指向对象 2。
+void WriteSphereContact(
+    const FCL_VECTOR3& center1,
+    float radius1,
+    const FCL_VECTOR3& center2,
+    float radius2,
+    _Out_ PFCL_CONTACT_INFO contact) noexcept {
+    const FCL_VECTOR3 normal = Normalize(Subtract(center2, center1));
+    contact->Normal = normal;
+    contact->PointOnObject1 = Add(center1, Scale(normal, radius1));
+    contact->PointOnObject2 = Subtract(center2, Scale(normal, radius2));
+}
+
+void WriteSphereObbContact(
+    const FCL_VECTOR3& center,
+    float radius,
+    const OrientedBox& box,
+    bool sphereFirst,
+    _Out_ PFCL_CONTACT_INFO contact) noexcept {
+    const FCL_VECTOR3 onBox = ClosestPointOnObb(box, center);
+    const FCL_VECTOR3 boxToSphere = Normalize(Subtract(center, onBox));
+    const FCL_VECTOR3 onSphere = Subtract(center, Scale(boxToSphere, radius));
+    contact->Normal = sphereFirst ? Scale(boxToSphere, -1.0f) : boxToSphere;
+    contact->PointOnObject1 = sphereFirst ? onSphere : onBox;
+    contact->PointOnObject2 = sphereFirst ? onBox : onSphere;
+}
+
+void WriteObbObbContact(
+    const OrientedBox& box1,
+    const OrientedBox& box2,
+    const FCL_VECTOR3& normal,
+    _Out_ PFCL_CONTACT_INFO contact) noexcept {
+    contact->Normal = normal;
+    contact->PointOnObject1 = ClosestPointOnObb(box1, SupportPoint(box2, Scale(normal, -1.0f)));
+    contact->PointOnObject2 = ClosestPointOnObb(box2, contact->PointOnObject1);
+}
+
+}  // namespace
+
+namespace fclmusa::narrowphase {
+
+BOOLEAN
+AnalyticCcdSupportsPair(
+    _In_ FCL_GEOMETRY_TYPE type1,
+    _In_ FCL_GEOMETRY_TYPE type2) noexcept {
+    const bool primitive1 = type1 == FCL_GEOMETRY_SPHERE || type1 == FCL_GEOMETRY_OBB;
+    const bool primitive2 = type2 == FCL_GEOMETRY_SPHERE || type2 == FCL_GEOMETRY_OBB;
+    return (primitive1 && primitive2) ? TRUE : FALSE;
+}
+
+BOOLEAN
+TryAnalyticContinuousCollision(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_INTERP_MOTION& motion1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_INTERP_MOTION& motion2,
+    _Out_ PFCL_CONTINUOUS_COLLISION_RESULT result) noexcept {
+    if (result == nullptr ||
+        !AnalyticCcdSupportsPair(object1.Type, object2.Type) ||
+        !IsTranslational(object1, motion1) ||
+        !IsTranslational(object2, motion2)) {
+        return FALSE;
+    }
+    // 非法描述交给 upstream 路径统一报错。
+    if (!IsValidPrimitive(object1) || !IsValidPrimitive(object2) ||
+        !IsValidTransform(motion1.Start) || !IsValidTransform(motion1.End) ||
+        !IsValidTransform(motion2.Start) || !IsValidTransform(motion2.End)) {
+        return FALSE;
+    }
+
+    RtlZeroMemory(result, sizeof(*result));
+
+    // 起始时刻已相交：TOI = 0，接触信息复用静态分派（布尔测试三种组合均为原生内核）。
+    BOOLEAN initiallyColliding = FALSE;
+    if (!NT_SUCCESS(DispatchCollision(object1, motion1.Start, object2, motion2.Start, &initiallyColliding, nullptr))) {
+        return FALSE;
+    }
+    if (initiallyColliding) {
+        if (!NT_SUCCESS(DispatchCollision(
+                object1, motion1.Start, object2, motion2.Start, &initiallyColliding, &result->Contact))) {
+            return FALSE;
+        }
+        result->Intersecting = TRUE;
+        result->TimeOfImpact = 0.0;
+        return TRUE;
+    }
+
+    const FCL_VECTOR3 move1 = Displacement(motion1);
+    const FCL_VECTOR3 move2 = Displacement(motion2);
+    float toi = 0.0f;
+    bool hit = false;
+    FCL_VECTOR3 boxNormal = {};
+
+    if (object1.Type == FCL_GEOMETRY_SPHERE && object2.Type == FCL_GEOMETRY_SPHERE) {
+        hit = SweptSphereSphere(BuildSweptSphere(object1, motion1), move1, BuildSweptSphere(object2, motion2), move2, &toi);
+    } else if (object1.Type == FCL_GEOMETRY_SPHERE) {
+        hit = SweptSphereObb(BuildSweptSphere(object1, motion1), move1, BuildWorldObb(object2.Data.Obb, motion2.Start), move2, &toi);
+    } else if (object2.Type == FCL_GEOMETRY_SPHERE) {
+        hit = SweptSphereObb(BuildSweptSphere(object2, motion2), move2, BuildWorldObb(object1.Data.Obb, motion1.Start), move1, &toi);
+    } else {
+        hit = SweptObbObb(
+            BuildWorldObb(object1.Data.Obb, motion1.Start),
+            move1,
+            BuildWorldObb(object2.Data.Obb, motion2.Start),
+            move2,
+            &toi,
+            &boxNormal);
+    }
+
+    if (!hit) {
+        result->Intersecting = FALSE;
+        result->TimeOfImpact = 1.0;
+        return TRUE;
+    }
+
+    result->Intersecting = TRUE;
+    result->TimeOfImpact = toi;
+    const FCL_TRANSFORM pose1 = PoseAt(motion1, toi);
+    const FCL_TRANSFORM pose2 = PoseAt(motion2, toi);
+    if (object1.Type == FCL_GEOMETRY_SPHERE && object2.Type == FCL_GEOMETRY_SPHERE) {
+        WriteSphereContact(
+            TransformPoint(pose1, object1.Data.Sphere.Center),
+            object1.Data.Sphere.Radius,
+            TransformPoint(pose2, object2.Data.Sphere.Center),
+            object2.Data.Sphere.Radius,
+            &result->Contact);
+    } else if (object1.Type == FCL_GEOMETRY_SPHERE) {
+        WriteSphereObbContact(
+            TransformPoint(pose1, object1.Data.Sphere.Center),
+            object1.Data.Sphere.Radius,
+            BuildWorldObb(object2.Data.Obb, pose2),
+            true,
+            &result->Contact);
+    } else if (object2.Type == FCL_GEOMETRY_SPHERE) {
+        WriteSphereObbContact(
+            TransformPoint(pose2, object2.Data.Sphere.Center),
+            object2.Data.Sphere.Radius,
+            BuildWorldObb(object1.Data.Obb, pose1),
+            false,
+            &result->Contact);
+    } else {
+        WriteObbObbContact(BuildWorldObb(object1.Data.Obb, pose1), BuildWorldObb(object2.Data.Obb, pose2), boxNormal, &result->Contact);
+    }
+    return TRUE;
+}
+
+}  // namespace fclmusa::narrowphase
@@ -0,0 +1,834 @@
+#include "fclmusa/narrowphase/coherence_cache.h"
+
+#include <float.h>
+
+#include "fclmusa/geometry/bvh_model.h"
+#include "fclmusa/geometry/compound_model.h"
+#include "fclmusa/geometry/convex_hull.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/geometry/obb.h"
+#include "fclmusa/memory/alloc_profiler.h"
+#include "fclmusa/memory/pool_allocator.h"
+
+namespace {
+
+using namespace fclmusa::geom;
+using fclmusa::narrowphase::CoherenceKey;
+using fclmusa::narrowphase::ProjectSnapshotOntoAxis;
+
+constexpr ULONG kCoherenceWays = 4;
+constexpr ULONG kMaxCoherenceCapacity = 1u << 16;
+constexpr float kMinimumSeparation = 0.0f;
+
+struct CoherenceEntry {
+    ULONGLONG Handle1;
+    ULONGLONG Handle2;
+    ULONGLONG LastUse;
+    FCL_VECTOR3 SeparatingAxis;
+    FCL_VECTOR3 Witness1;   // 上一次最近点，位于对象 1 的局部坐标
+    FCL_VECTOR3 Witness2;   // 上一次最近点，位于对象 2 的局部坐标
+    ULONG Generation1;      // 记录时两侧快照的 Generation，与本次查询不符的条目视为过期
+    ULONG Generation2;
+    BOOLEAN HasAxis;
+    BOOLEAN HasDistance;
+};
+
+struct CoherenceSet {
+    volatile LONG Lock;
+    CoherenceEntry Ways[kCoherenceWays];
+};
+
+struct CoherenceTable {
+    ULONG SetCount;
+    CoherenceSet Sets[1];
+};
+
+CoherenceTable* volatile g_CoherenceTable = nullptr;
+// 读者按当前纪元的奇偶计入两个计数之一；配置变更翻转纪元后只等待旧纪元的计数归零，
+// 新纪元的读者不会让 Configure 无限等待。
+volatile LONG g_CoherenceEpoch = 0;
+volatile LONG g_CoherenceUsers[2] = {};
+volatile LONG g_CoherenceConfigureLock = 0;
+volatile LONG64 g_CoherenceClock = 0;
+volatile LONG g_CoherenceEntryCount = 0;
+volatile LONG64 g_CoherenceLookups = 0;
+volatile LONG64 g_CoherenceHits = 0;
+volatile LONG64 g_CoherenceMisses = 0;
+volatile LONG64 g_CoherenceEvictions = 0;
+volatile LONG64 g_CoherenceContended = 0;
+volatile LONG64 g_CoherenceDistanceReuses = 0;
+
+// 读者在访问表期间持有所在纪元的计数；登记后纪元已变化则撤销重来，保证读到的表受本纪元计数保护。
+class TableUse {
+public:
+    TableUse() noexcept {
+        for (;;) {
+            const LONG epoch = g_CoherenceEpoch;
+            m_Slot = static_cast<ULONG>(epoch) & 1;
+            InterlockedIncrement(&g_CoherenceUsers[m_Slot]);
+            if (InterlockedCompareExchange(&g_CoherenceEpoch, epoch, epoch) == epoch) {
+                break;
+            }
+            InterlockedDecrement(&g_CoherenceUsers[m_Slot]);
+        }
+        m_Table = g_CoherenceTable;
+    }
+
+    ~TableUse() {
+        InterlockedDecrement(&g_CoherenceUsers[m_Slot]);
+    }
+
+    TableUse(const TableUse&) = delete;
+    TableUse& operator=(const TableUse&) = delete;
+
+    CoherenceTable* Get() const noexcept {
+        return m_Table;
+    }
+
+private:
+    CoherenceTable* m_Table = nullptr;
+    ULONG m_Slot = 0;
+};
+
+class SetLock {
+public:
+    explicit SetLock(CoherenceSet* set) noexcept : m_Set(set) {
+        m_Owned = InterlockedCompareExchange(&m_Set->Lock, 1, 0) == 0;
+        if (!m_Owned) {
+            InterlockedIncrement64(&g_CoherenceContended);
+        }
+    }
+
+    ~SetLock() {
+        if (m_Owned) {
+            InterlockedExchange(&m_Set->Lock, 0);
+        }
+    }
+
+    SetLock(const SetLock&) = delete;
+    SetLock& operator=(const SetLock&) = delete;
+
+    bool Owned() const noexcept {
+        return m_Owned;
+    }
+
+private:
+    CoherenceSet* m_Set;
+    bool m_Owned = false;
+};
+
+ULONG RoundUpPowerOfTwo(ULONG value) noexcept {
+    ULONG result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+CoherenceSet* SelectSet(CoherenceTable* table, const CoherenceKey& key) noexcept {
+    ULONGLONG hash = (key.Handle1 * 0x9E3779B97F4A7C15ULL) ^ (key.Handle2 * 0xC2B2AE3D27D4EB4FULL);
+    hash ^= hash >> 29;
+    return &table->Sets[hash & (table->SetCount - 1)];
+}
+
+CoherenceEntry* FindEntryLocked(CoherenceSet* set, const CoherenceKey& key) noexcept {
+    for (ULONG way = 0; way < kCoherenceWays; ++way) {
+        CoherenceEntry& entry = set->Ways[way];
+        if (entry.Handle1 == key.Handle1 && entry.Handle2 == key.Handle2) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+CoherenceEntry* FindOrInsertEntryLocked(CoherenceSet* set, const CoherenceKey& key) noexcept {
+    CoherenceEntry* entry = FindEntryLocked(set, key);
+    if (entry != nullptr) {
+        return entry;
+    }
+
+    CoherenceEntry* victim = &set->Ways[0];
+    for (ULONG way = 0; way < kCoherenceWays; ++way) {
+        CoherenceEntry& candidate = set->Ways[way];
+        if (candidate.Handle1 == 0) {
+            victim = &candidate;
+            break;
+        }
+        if (candidate.LastUse < victim->LastUse) {
+            victim = &candidate;
+        }
+    }
+
+    if (victim->Handle1 != 0) {
+        InterlockedIncrement64(&g_CoherenceEvictions);
+    } else {
+        InterlockedIncrement(&g_CoherenceEntryCount);
+    }
+    RtlZeroMemory(victim, sizeof(*victim));
+    victim->Handle1 = key.Handle1;
+    victim->Handle2 = key.Handle2;
+    return victim;
+}
+
+// 查找与本次快照版本一致的条目；查询开始于 Mesh 更新之前的写入带着旧版本，不会被后续查询采用。
+CoherenceEntry* FindCurrentEntryLocked(
+    CoherenceSet* set,
+    const CoherenceKey& key,
+    const FCL_GEOMETRY_SNAPSHOT& object1,
+    const FCL_GEOMETRY_SNAPSHOT& object2) noexcept {
+    CoherenceEntry* entry = FindEntryLocked(set, key);
+    if (entry == nullptr || entry->Generation1 != object1.Generation || entry->Generation2 != object2.Generation) {
+        return nullptr;
+    }
+    return entry;
+}
+
+// 写入前对齐版本：版本变化时旧的分离轴与最近点一并作废。
+void StampEntryLocked(
+    CoherenceEntry* entry,
+    const FCL_GEOMETRY_SNAPSHOT& object1,
+    const FCL_GEOMETRY_SNAPSHOT& object2) noexcept {
+    if (entry->Generation1 != object1.Generation || entry->Generation2 != object2.Generation) {
+        entry->HasAxis = FALSE;
+        entry->HasDistance = FALSE;
+        entry->Generation1 = object1.Generation;
+        entry->Generation2 = object2.Generation;
+    }
+}
+
+ULONGLONG NextStamp() noexcept {
+    return static_cast<ULONGLONG>(InterlockedIncrement64(&g_CoherenceClock));
+}
+
+bool IsCacheableKey(const CoherenceKey& key) noexcept {
+    return key.Handle1 != 0 && key.Handle2 != 0;
+}
+
+FCL_VECTOR3 InverseTransformPoint(const FCL_TRANSFORM& transform, const FCL_VECTOR3& point) noexcept {
+    return MatrixVectorMultiply(TransposeMatrix(transform.Rotation), Subtract(point, transform.Translation));
+}
+
+void ProjectBox(
+    const FCL_VECTOR3& center,
+    const FCL_VECTOR3 axes[3],
+    const FCL_VECTOR3& extents,
+    const FCL_VECTOR3& axis,
+    float* minValue,
+    float* maxValue) noexcept {
+    const float mid = Dot(center, axis);
+    const float radius =
+        extents.X * static_cast<float>(fabs(Dot(axes[0], axis))) +
+        extents.Y * static_cast<float>(fabs(Dot(axes[1], axis))) +
+        extents.Z * static_cast<float>(fabs(Dot(axes[2], axis)));
+    *minValue = mid - radius;
+    *maxValue = mid + radius;
+}
+
+// 复合几何根节点包围盒（局部 AABB）的世界中心与半长；轴向即复合体变换的三列。
+bool BuildCompoundBox(
+    const FCL_GEOMETRY_SNAPSHOT& snapshot,
+    const FCL_TRANSFORM& transform,
+    _Out_ FCL_VECTOR3* center,
+    _Out_ FCL_VECTOR3* extents) noexcept {
+    ULONG nodeCount = 0;
+    const FCL_COMPOUND_NODE* nodes = FclCompoundGetNodes(snapshot.Data.Compound.Model, &nodeCount);
+    if (nodes == nullptr || nodeCount == 0) {
+        return false;
+    }
+    *center = TransformPoint(transform, Scale(Add(nodes[0].Min, nodes[0].Max), 0.5f));
+    *extents = Scale(Subtract(nodes[0].Max, nodes[0].Min), 0.5f);
+    return true;
+}
+
+// 胶囊体 / 圆柱体的世界中心与轴向。
+template <typename Desc>
+void BuildAxialFrame(const Desc& desc, const FCL_TRANSFORM& transform, _Out_ FCL_VECTOR3* center, _Out_ FCL_VECTOR3* axis) noexcept {
+    *center = TransformPoint(transform, desc.Center);
+    *axis = MatrixVectorMultiply(MultiplyMatrix(transform.Rotation, desc.Rotation), {0.0f, 0.0f, 1.0f});
+}
+
+// 世界坐标下的参考中心与局部轴，用于生成候选分离轴。
+struct ShapeFrame {
+    FCL_VECTOR3 Center;
+    FCL_VECTOR3 Axes[3];
+    ULONG AxisCount;
+};
+
+bool BuildShapeFrame(
+    const FCL_GEOMETRY_SNAPSHOT& snapshot,
+    const FCL_TRANSFORM& transform,
+    ShapeFrame* frame) noexcept {
+    RtlZeroMemory(frame, sizeof(*frame));
+    switch (snapshot.Type) {
+        case FCL_GEOMETRY_SPHERE:
+            frame->Center = TransformPoint(transform, snapshot.Data.Sphere.Center);
+            return true;
+        case FCL_GEOMETRY_OBB: {
+            const OrientedBox box = BuildWorldObb(snapshot.Data.Obb, transform);
+            frame->Center = box.Center;
+            for (int i = 0; i < 3; ++i) {
+                frame->Axes[i] = box.Axes[i];
+            }
+            frame->AxisCount = 3;
+            return true;
+        }
+        case FCL_GEOMETRY_CAPSULE:
+            BuildAxialFrame(snapshot.Data.Capsule, transform, &frame->Center, &frame->Axes[0]);
+            frame->AxisCount = 1;
+            return true;
+        case FCL_GEOMETRY_CYLINDER:
+            BuildAxialFrame(snapshot.Data.Cylinder, transform, &frame->Center, &frame->Axes[0]);
+            frame->AxisCount = 1;
+            return true;
+        case FCL_GEOMETRY_MESH: {
+            ULONG nodeCount = 0;
+            const FCL_BVH_NODE* nodes = FclBvhGetNodes(snapshot.Data.Mesh.Bvh, &nodeCount);
+            if (nodes == nullptr || nodeCount == 0) {
+                return false;
+            }
+            const FCL_OBBRSS& root = nodes[0].Volume;
+            frame->Center = TransformPoint(transform, root.Center);
+            for (int i = 0; i < 3; ++i) {
+                frame->Axes[i] = MatrixVectorMultiply(transform.Rotation, root.Axis[i]);
+            }
+            frame->AxisCount = 3;
+            return true;
+        }
+        case FCL_GEOMETRY_CONVEX:
+            if (snapshot.Data.Convex.Hull == nullptr) {
+                return false;
+            }
+            frame->Center = TransformPoint(transform, FclConvexHullGetCentroid(snapshot.Data.Convex.Hull));
+            return true;
+        case FCL_GEOMETRY_COMPOUND: {
+            FCL_VECTOR3 extents = {};
+            if (!BuildCompoundBox(snapshot, transform, &frame->Center, &extents)) {
+                return false;
+            }
+            for (int i = 0; i < 3; ++i) {
+                frame->Axes[i] = {transform.Rotation.M[0][i], transform.Rotation.M[1][i], transform.Rotation.M[2][i]};
+            }
+            frame->AxisCount = 3;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+// 沿 axis（由对象 1 指向对象 2）的间隙；返回负值表示投影区间重叠。
+bool MeasureSeparation(
+    const FCL_GEOMETRY_SNAPSHOT& object1,
+    const FCL_TRANSFORM& transform1,
+    const FCL_GEOMETRY_SNAPSHOT& object2,
+    const FCL_TRANSFORM& transform2,
+    const FCL_VECTOR3& axis,
+    float* separation) noexcept {
+    float min1 = 0.0f;
+    float max1 = 0.0f;
+    float min2 = 0.0f;
+    float max2 = 0.0f;
+    if (!ProjectSnapshotOntoAxis(object1, transform1, axis, &min1, &max1) ||
+        !ProjectSnapshotOntoAxis(object2, transform2, axis, &min2, &max2)) {
+        return false;
+    }
+    *separation = min2 - max1;
+    return true;
+}
+
+// 在中心连线与两物体局部轴中挑选间隙最大的分离轴。
+bool FindSeparatingAxis(
+    const FCL_GEOMETRY_SNAPSHOT& object1,
+    const FCL_TRANSFORM& transform1,
+    const FCL_GEOMETRY_SNAPSHOT& object2,
+    const FCL_TRANSFORM& transform2,
+    _In_opt_ const FCL_VECTOR3* preferredAxis,
+    FCL_VECTOR3* axis) noexcept {
+    ShapeFrame frame1 = {};
+    ShapeFrame frame2 = {};
+    if (!BuildShapeFrame(object1, transform1, &frame1) || !BuildShapeFrame(object2, transform2, &frame2)) {
+        return false;
+    }
+
+    FCL_VECTOR3 candidates[8] = {};
+    ULONG candidateCount = 0;
+    if (preferredAxis != nullptr) {
+        candidates[candidateCount++] = *preferredAxis;
+    }
+    candidates[candidateCount++] = Subtract(frame2.Center, frame1.Center);
+    for (ULONG i = 0; i < frame1.AxisCount; ++i) {
+        candidates[candidateCount++] = frame1.Axes[i];
+    }
+    for (ULONG i = 0; i < frame2.AxisCount && candidateCount < 8; ++i) {
+        candidates[candidateCount++] = frame2.Axes[i];
+    }
+
+    bool found = false;
+    float bestSeparation = kMinimumSeparation;
+    for (ULONG i = 0; i < candidateCount; ++i) {
+        if (Length(candidates[i]) <= kSingularityEpsilon) {
+            continue;
+        }
+        const FCL_VECTOR3 unit = Normalize(candidates[i]);
+        for (float sign = 1.0f; sign >= -1.0f; sign -= 2.0f) {
+            const FCL_VECTOR3 oriented = Scale(unit, sign);
+            float separation = 0.0f;
+            if (MeasureSeparation(object1, transform1, object2, transform2, oriented, &separation) &&
+                separation > bestSeparation) {
+                bestSeparation = separation;
+                *axis = oriented;
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+// 先单独验证 preferredAxis（上一帧的分离轴或最近点连线），仍然分离时直接采用，否则才做完整的候选轴搜索。
+bool RefreshSeparatingAxis(
+    const FCL_GEOMETRY_SNAPSHOT& object1,
+    const FCL_TRANSFORM& transform1,
+    const FCL_GEOMETRY_SNAPSHOT& object2,
+    const FCL_TRANSFORM& transform2,
+    _In_opt_ const FCL_VECTOR3* preferredAxis,
+    FCL_VECTOR3* axis) noexcept {
+    if (preferredAxis != nullptr && Length(*preferredAxis) > kSingularityEpsilon) {
+        const FCL_VECTOR3 unit = Normalize(*preferredAxis);
+        float separation = 0.0f;
+        if (MeasureSeparation(object1, transform1, object2, transform2, unit, &separation) &&
+            separation > kMinimumSeparation) {
+            *axis = unit;
+            return true;
+        }
+    }
+    return FindSeparatingAxis(object1, transform1, object2, transform2, preferredAxis, axis);
+}
+
+}  // namespace
+
+namespace fclmusa::narrowphase {
+
+BOOLEAN
+ProjectSnapshotOntoAxis(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& snapshot,
+    _In_ const FCL_TRANSFORM& transform,
+    _In_ const FCL_VECTOR3& axis,
+    _Out_ float* minValue,
+    _Out_ float* maxValue) noexcept {
+    switch (snapshot.Type) {
+        case FCL_GEOMETRY_SPHERE: {
+            const float mid = Dot(TransformPoint(transform, snapshot.Data.Sphere.Center), axis);
+            *minValue = mid - snapshot.Data.Sphere.Radius;
+            *maxValue = mid + snapshot.Data.Sphere.Radius;
+            return TRUE;
+        }
+        case FCL_GEOMETRY_OBB: {
+            const OrientedBox box = BuildWorldObb(snapshot.Data.Obb, transform);
+            ProjectBox(box.Center, box.Axes, box.Extents, axis, minValue, maxValue);
+            return TRUE;
+        }
+        case FCL_GEOMETRY_CAPSULE: {
+            // 线段投影加上半径方向的投影长度。
+            const auto& capsule = snapshot.Data.Capsule;
+            FCL_VECTOR3 center = {};
+            FCL_VECTOR3 direction = {};
+            BuildAxialFrame(capsule, transform, &center, &direction);
+            const float mid = Dot(center, axis);
+            const float reach = capsule.HalfLength * static_cast<float>(fabs(Dot(direction, axis))) + capsule.Radius * Length(axis);
+            *minValue = mid - reach;
+            *maxValue = mid + reach;
+            return TRUE;
+        }
+        case FCL_GEOMETRY_CYLINDER: {
+            // 轴向半长的投影加上端面圆盘的投影半径 r * |axis 在端面内的分量|。
+            const auto& cylinder = snapshot.Data.Cylinder;
+            FCL_VECTOR3 center = {};
+            FCL_VECTOR3 direction = {};
+            BuildAxialFrame(cylinder, transform, &center, &direction);
+            const float mid = Dot(center, axis);
+            const float along = Dot(direction, axis);
+            const float reach = cylinder.HalfLength * static_cast<float>(fabs(along)) +
+                cylinder.Radius * Length(Subtract(axis, Scale(direction, along)));
+            *minValue = mid - reach;
+            *maxValue = mid + reach;
+            return TRUE;
+        }
+        case FCL_GEOMETRY_MESH: {
+            ULONG nodeCount = 0;
+            const FCL_BVH_NODE* nodes = FclBvhGetNodes(snapshot.Data.Mesh.Bvh, &nodeCount);
+            if (nodes == nullptr || nodeCount == 0) {
+                return FALSE;
+            }
+            const FCL_OBBRSS& root = nodes[0].Volume;
+            FCL_VECTOR3 axes[3] = {};
+            for (int i = 0; i < 3; ++i) {
+                axes[i] = MatrixVectorMultiply(transform.Rotation, root.Axis[i]);
+            }
+            ProjectBox(TransformPoint(transform, root.Center), axes, root.Extents, axis, minValue, maxValue);
+            return TRUE;
+        }
+        case FCL_GEOMETRY_CONVEX: {
+            // 凸包投影区间由正反两个方向的支撑顶点精确给出。
+            const auto& convex = snapshot.Data.Convex;
+            if (convex.Hull == nullptr || convex.VertexCount == 0) {
+                return FALSE;
+            }
+            const FCL_VECTOR3 localAxis = MatrixVectorMultiply(TransposeMatrix(transform.Rotation), axis);
+            const FCL_VECTOR3 negatedAxis = Scale(localAxis, -1.0f);
+            const ULONG upper = FclConvexHullSupport(convex.Hull, &localAxis, 0);
+            const ULONG lower = FclConvexHullSupport(convex.Hull, &negatedAxis, 0);
+            const float offset = Dot(transform.Translation, axis);
+            *minValue = offset + Dot(convex.Vertices[lower], localAxis);
+            *maxValue = offset + Dot(convex.Vertices[upper], localAxis);
+            return TRUE;
+        }
+        case FCL_GEOMETRY_COMPOUND: {
+            // 与 Mesh 相同，使用根节点包围盒（局部 AABB）作为保守区间。
+            FCL_VECTOR3 center = {};
+            FCL_VECTOR3 extents = {};
+            if (!BuildCompoundBox(snapshot, transform, &center, &extents)) {
+                return FALSE;
+            }
+            FCL_VECTOR3 axes[3] = {};
+            for (int i = 0; i < 3; ++i) {
+                axes[i] = {transform.Rotation.M[0][i], transform.Rotation.M[1][i], transform.Rotation.M[2][i]};
+            }
+            ProjectBox(center, axes, extents, axis, minValue, maxValue);
+            return TRUE;
+        }
+        default:
+            return FALSE;
+    }
+}
+
+BOOLEAN
+EstimateSeparation(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _Out_ float* separation) noexcept {
+    *separation = 0.0f;
+    FCL_VECTOR3 axis = {};
+    if (!FindSeparatingAxis(object1, transform1, object2, transform2, nullptr, &axis)) {
+        return FALSE;
+    }
+    float gap = 0.0f;
+    if (!MeasureSeparation(object1, transform1, object2, transform2, axis, &gap) || gap <= kMinimumSeparation) {
+        return FALSE;
+    }
+    *separation = gap;
+    return TRUE;
+}
+
+BOOLEAN
+CoherenceCacheIsEnabled() noexcept {
+    return g_CoherenceTable != nullptr ? TRUE : FALSE;
+}
+
+BOOLEAN
+CoherenceCacheTryConfirmSeparated(
+    _In_ const CoherenceKey& key,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _Out_opt_ float* separation) noexcept {
+    if (separation != nullptr) {
+        *separation = 0.0f;
+    }
+    if (!IsCacheableKey(key)) {
+        return FALSE;
+    }
+
+    TableUse use;
+    CoherenceTable* table = use.Get();
+    if (table == nullptr) {
+        return FALSE;
+    }
+
+    InterlockedIncrement64(&g_CoherenceLookups);
+    CoherenceSet* set = SelectSet(table, key);
+    FCL_VECTOR3 axis = {};
+    {
+        SetLock lock(set);
+        if (!lock.Owned()) {
+            return FALSE;
+        }
+        CoherenceEntry* entry = FindCurrentEntryLocked(set, key, object1, object2);
+        if (entry == nullptr || !entry->HasAxis) {
+            InterlockedIncrement64(&g_CoherenceMisses);
+            return FALSE;
+        }
+        entry->LastUse = NextStamp();
+        axis = entry->SeparatingAxis;
+    }
+
+    float gap = 0.0f;
+    if (!MeasureSeparation(object1, transform1, object2, transform2, axis, &gap) || gap <= kMinimumSeparation) {
+        InterlockedIncrement64(&g_CoherenceMisses);
+        return FALSE;
+    }
+
+    InterlockedIncrement64(&g_CoherenceHits);
+    if (separation != nullptr) {
+        *separation = gap;
+    }
+    return TRUE;
+}
+
+BOOLEAN
+CoherenceCacheQueryDistanceBound(
+    _In_ const CoherenceKey& key,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _In_ float absoluteError,
+    _In_ float relativeError,
+    _Out_ CoherenceDistanceBound* bound) noexcept {
+    RtlZeroMemory(bound, sizeof(*bound));
+    if (!IsCacheableKey(key)) {
+        return FALSE;
+    }
+
+    TableUse use;
+    CoherenceTable* table = use.Get();
+    if (table == nullptr) {
+        return FALSE;
+    }
+
+    InterlockedIncrement64(&g_CoherenceLookups);
+    CoherenceSet* set = SelectSet(table, key);
+    CoherenceEntry cached = {};
+    {
+        SetLock lock(set);
+        if (!lock.Owned()) {
+            return FALSE;
+        }
+        CoherenceEntry* entry = FindCurrentEntryLocked(set, key, object1, object2);
+        if (entry == nullptr || (!entry->HasAxis && !entry->HasDistance)) {
+            InterlockedIncrement64(&g_CoherenceMisses);
+            return FALSE;
+        }
+        entry->LastUse = NextStamp();
+        cached = *entry;
+    }
+
+    float gap = 0.0f;
+    if (cached.HasAxis &&
+        MeasureSeparation(object1, transform1, object2, transform2, cached.SeparatingAxis, &gap) &&
+        gap > kMinimumSeparation) {
+        bound->LowerBound = gap;
+        InterlockedIncrement64(&g_CoherenceHits);
+    } else {
+        InterlockedIncrement64(&g_CoherenceMisses);
+    }
+
+    // 最近点分别属于两个物体，把它们随当前位姿移动后的间距就是当前距离的上界。
+    if (cached.HasDistance) {
+        bound->HasUpperBound = TRUE;
+        bound->UpperBound.ClosestPoint1 = TransformPoint(transform1, cached.Witness1);
+        bound->UpperBound.ClosestPoint2 = TransformPoint(transform2, cached.Witness2);
+        bound->UpperBound.Distance = Length(Subtract(bound->UpperBound.ClosestPoint2, bound->UpperBound.ClosestPoint1));
+        // 与 fcl::DistanceRequest 的剪枝条件一致：上界不超过 (下界 + abs_err) * (1 + rel_err)。
+        if (bound->LowerBound > kMinimumSeparation &&
+            bound->UpperBound.Distance <= (bound->LowerBound + absoluteError) * (1.0f + relativeError)) {
+            bound->WithinError = TRUE;
+            InterlockedIncrement64(&g_CoherenceDistanceReuses);
+        }
+    }
+    return TRUE;
+}
+
+VOID
+CoherenceCacheRecordCollision(
+    _In_ const CoherenceKey& key,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _In_ BOOLEAN isColliding) noexcept {
+    if (!IsCacheableKey(key)) {
+        return;
+    }
+
+    TableUse use;
+    CoherenceTable* table = use.Get();
+    if (table == nullptr) {
+        return;
+    }
+
+    CoherenceSet* set = SelectSet(table, key);
+    FCL_VECTOR3 previousAxis = {};
+    bool hasPrevious = false;
+    {
+        SetLock lock(set);
+        if (!lock.Owned()) {
+            return;
+        }
+        CoherenceEntry* entry = FindCurrentEntryLocked(set, key, object1, object2);
+        if (entry != nullptr && entry->HasAxis) {
+            previousAxis = entry->SeparatingAxis;
+            hasPrevious = true;
+        }
+    }
+
+    FCL_VECTOR3 axis = {};
+    const bool separated = !isColliding &&
+        RefreshSeparatingAxis(object1, transform1, object2, transform2, hasPrevious ? &previousAxis : nullptr, &axis);
+
+    SetLock lock(set);
+    if (!lock.Owned()) {
+        return;
+    }
+    CoherenceEntry* entry = FindOrInsertEntryLocked(set, key);
+    StampEntryLocked(entry, object1, object2);
+    entry->LastUse = NextStamp();
+    entry->HasAxis = separated ? TRUE : FALSE;
+    entry->SeparatingAxis = axis;
+    if (isColliding) {
+        entry->HasDistance = FALSE;
+    }
+}
+
+VOID
+CoherenceCacheRecordDistance(
+    _In_ const CoherenceKey& key,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _In_ const FCL_DISTANCE_RESULT& result) noexcept {
+    if (!IsCacheableKey(key) || !CoherenceCacheIsEnabled()) {
+        return;
+    }
+
+    // 最近点连线是凸体间最优的分离方向；Mesh 的包围体投影可能仍重叠，此时退回候选轴。
+    FCL_VECTOR3 axis = {};
+    bool separated = false;
+    if (result.Distance > 0.0f) {
+        const FCL_VECTOR3 witnessAxis = Subtract(result.ClosestPoint2, result.ClosestPoint1);
+        separated = RefreshSeparatingAxis(object1, transform1, object2, transform2, &witnessAxis, &axis);
+    }
+
+    TableUse use;
+    CoherenceTable* table = use.Get();
+    if (table == nullptr) {
+        return;
+    }
+    CoherenceSet* set = SelectSet(table, key);
+    SetLock lock(set);
+    if (!lock.Owned()) {
+        return;
+    }
+    CoherenceEntry* entry = FindOrInsertEntryLocked(set, key);
+    StampEntryLocked(entry, object1, object2);
+    entry->LastUse = NextStamp();
+    entry->HasAxis = separated ? TRUE : FALSE;
+    entry->SeparatingAxis = axis;
+    // 穿透时最近点没有意义，不作为距离上界。
+    entry->HasDistance = (result.Distance > 0.0f) ? TRUE : FALSE;
+    entry->Witness1 = InverseTransformPoint(transform1, result.ClosestPoint1);
+    entry->Witness2 = InverseTransformPoint(transform2, result.ClosestPoint2);
+}
+
+}  // namespace fclmusa::narrowphase
+
+extern "C"
+NTSTATUS
+FclCoherenceCacheConfigure(
+    _In_ ULONG capacity) noexcept {
+    if (KeGetCurrentIrql() != PASSIVE_LEVEL) {
+        return STATUS_INVALID_DEVICE_STATE;
+    }
+    if (capacity > kMaxCoherenceCapacity) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    CoherenceTable* table = nullptr;
+    if (capacity != 0) {
+        const ULONG setCount = RoundUpPowerOfTwo((capacity + kCoherenceWays - 1) / kCoherenceWays);
+        const size_t bytes = sizeof(CoherenceTable) + (static_cast<size_t>(setCount) - 1) * sizeof(CoherenceSet);
+        FCL_ALLOCATION_SITE(FCL_ALLOC_SITE_COHERENCE_CACHE);
+        table = static_cast<CoherenceTable*>(fclmusa::memory::Allocate(bytes));
+        if (table == nullptr) {
+            return STATUS_INSUFFICIENT_RESOURCES;
+        }
+        RtlZeroMemory(table, bytes);
+        table->SetCount = setCount;
+    }
+
+    // 配置变更串行执行：每次翻转前，上一次翻转留下的旧纪元读者都已退出。
+    while (InterlockedCompareExchange(&g_CoherenceConfigureLock, 1, 0) != 0) {
+        YieldProcessor();
+    }
+    auto* previous = static_cast<CoherenceTable*>(
+        InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(&g_CoherenceTable), table));
+    const ULONG oldSlot = static_cast<ULONG>(InterlockedIncrement(&g_CoherenceEpoch) - 1) & 1;
+    while (g_CoherenceUsers[oldSlot] != 0) {
+        YieldProcessor();
+    }
+    InterlockedExchange(&g_CoherenceEntryCount, 0);
+    InterlockedExchange(&g_CoherenceConfigureLock, 0);
+
+    if (previous != nullptr) {
+        fclmusa::memory::Free(previous);
+    }
+    return STATUS_SUCCESS;
+}
+
+extern "C"
+VOID
+FclCoherenceCacheInvalidateGeometry(
+    _In_ FCL_GEOMETRY_HANDLE handle) noexcept {
+    if (handle.Value == 0) {
+        return;
+    }
+
+    TableUse use;
+    CoherenceTable* table = use.Get();
+    if (table == nullptr) {
+        return;
+    }
+
+    for (ULONG setIndex = 0; setIndex < table->SetCount; ++setIndex) {
+        CoherenceSet* set = &table->Sets[setIndex];
+        // 失效必须生效，不能像查询路径一样旁路，因此在 PASSIVE 侧自旋等待组锁。
+        while (InterlockedCompareExchange(&set->Lock, 1, 0) != 0) {
+            YieldProcessor();
+        }
+        for (ULONG way = 0; way < kCoherenceWays; ++way) {
+            CoherenceEntry& entry = set->Ways[way];
+            if (entry.Handle1 != 0 && (entry.Handle1 == handle.Value || entry.Handle2 == handle.Value)) {
+                RtlZeroMemory(&entry, sizeof(entry));
+                InterlockedDecrement(&g_CoherenceEntryCount);
+            }
+        }
+        InterlockedExchange(&set->Lock, 0);
+    }
+}
+
+extern "C"
+NTSTATUS
+FclCoherenceCacheQueryStats(
+    _Out_ PFCL_COHERENCE_CACHE_STATS stats) noexcept {
+    if (stats == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    RtlZeroMemory(stats, sizeof(*stats));
+    {
+        TableUse use;
+        CoherenceTable* table = use.Get();
+        stats->Capacity = (table != nullptr) ? table->SetCount * kCoherenceWays : 0;
+    }
+    stats->EntryCount = static_cast<ULONG>(g_CoherenceEntryCount);
+    stats->Lookups = static_cast<ULONGLONG>(g_CoherenceLookups);
+    stats->SeparatingAxisHits = static_cast<ULONGLONG>(g_CoherenceHits);
+    stats->Misses = static_cast<ULONGLONG>(g_CoherenceMisses);
+    stats->Evictions = static_cast<ULONGLONG>(g_CoherenceEvictions);
+    stats->ContendedBypasses = static_cast<ULONGLONG>(g_CoherenceContended);
+    stats->DistanceReuses = static_cast<ULONGLONG>(g_CoherenceDistanceReuses);
+    return STATUS_SUCCESS;
+}
@@ -0,0 +1,402 @@
+﻿#include "fclmusa/narrowphase/compound_dispatch.h"
+
+#include <float.h>
+#include <math.h>
+
+#include <algorithm>
+
+#include "fclmusa/geometry/compound_model.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/narrowphase/coherence_cache.h"
+#include "fclmusa/narrowphase/query_dispatch.h"
+
+namespace {
+
+using namespace fclmusa::geom;
+
+// 树由中位数二分构建，深度约为 log2(子形状数) + 1，遍历栈不会超过该容量。
+constexpr ULONG kTraversalStackDepth = 64;
+
+struct LocalBox {
+    FCL_VECTOR3 Min;
+    FCL_VECTOR3 Max;
+};
+
+FCL_TRANSFORM Compose(const FCL_TRANSFORM& outer, const FCL_TRANSFORM& inner) noexcept {
+    FCL_TRANSFORM result = {};
+    result.Rotation = MultiplyMatrix(outer.Rotation, inner.Rotation);
+    result.Translation = TransformPoint(outer, inner.Translation);
+    return result;
+}
+
+// frame⁻¹ ∘ world：把世界位姿表示到 frame 的局部坐标下。
+FCL_TRANSFORM RelativeTo(const FCL_TRANSFORM& frame, const FCL_TRANSFORM& world) noexcept {
+    const FCL_MATRIX3X3 inverse = TransposeMatrix(frame.Rotation);
+    FCL_TRANSFORM result = {};
+    result.Rotation = MultiplyMatrix(inverse, world.Rotation);
+    result.Translation = MatrixVectorMultiply(inverse, Subtract(world.Translation, frame.Translation));
+    return result;
+}
+
+// 另一物体在复合体局部坐标下的 AABB；包围体不可得时退化为无界盒，所有子形状都参与窄阶段。
+LocalBox BoundsInFrame(
+    const FCL_GEOMETRY_SNAPSHOT& other,
+    const FCL_TRANSFORM& otherTransform,
+    const FCL_TRANSFORM& compoundTransform) noexcept {
+    const FCL_TRANSFORM relative = RelativeTo(compoundTransform, otherTransform);
+    const FCL_VECTOR3 axes[3] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+    LocalBox box = {};
+    for (int axis = 0; axis < 3; ++axis) {
+        if (!fclmusa::narrowphase::ProjectSnapshotOntoAxis(
+                other, relative, axes[axis], &(&box.Min.X)[axis], &(&box.Max.X)[axis])) {
+            box.Min = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+            box.Max = {FLT_MAX, FLT_MAX, FLT_MAX};
+            return box;
+        }
+    }
+    return box;
+}
+
+// 两个 AABB 的间隙（重叠时为 0），是子树内任一子形状到另一物体距离的下界。
+float BoxGap(const FCL_COMPOUND_NODE& node, const LocalBox& box) noexcept {
+    float squared = 0.0f;
+    for (int axis = 0; axis < 3; ++axis) {
+        const float gap = (std::max)(
+            (&node.Min.X)[axis] - (&box.Max.X)[axis],
+            (&box.Min.X)[axis] - (&node.Max.X)[axis]);
+        if (gap > 0.0f) {
+            squared += gap * gap;
+        }
+    }
+    return sqrtf(squared);
+}
+
+bool Overlaps(const FCL_COMPOUND_NODE& node, const LocalBox& box) noexcept {
+    for (int axis = 0; axis < 3; ++axis) {
+        if ((&node.Min.X)[axis] > (&box.Max.X)[axis] || (&box.Min.X)[axis] > (&node.Max.X)[axis]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 复合体一侧的遍历上下文；CompoundFirst 记录复合体原本是否为对象 1，以保持接触法线与最近点的方向。
+struct CompoundSide {
+    const FCL_COMPOUND_CHILD* Children;
+    const FCL_COMPOUND_NODE* Nodes;
+    ULONG ChildCount;
+    const FCL_TRANSFORM* Transform;
+    const FCL_GEOMETRY_SNAPSHOT* Other;
+    const FCL_TRANSFORM* OtherTransform;
+    bool CompoundFirst;
+};
+
+bool BindCompoundSide(
+    const FCL_GEOMETRY_SNAPSHOT& compound,
+    const FCL_TRANSFORM& transform,
+    const FCL_GEOMETRY_SNAPSHOT& other,
+    const FCL_TRANSFORM& otherTransform,
+    bool compoundFirst,
+    _Out_ CompoundSide* side) noexcept {
+    ULONG nodeCount = 0;
+    side->Children = FclCompoundGetChildren(compound.Data.Compound.Model, &side->ChildCount);
+    side->Nodes = FclCompoundGetNodes(compound.Data.Compound.Model, &nodeCount);
+    side->Transform = &transform;
+    side->Other = &other;
+    side->OtherTransform = &otherTransform;
+    side->CompoundFirst = compoundFirst;
+    return side->Children != nullptr && side->Nodes != nullptr && nodeCount != 0;
+}
+
+// 按深度优先访问与 box 重叠的叶节点；visit 返回 false 时提前结束。
+template <typename Visit>
+void ForEachOverlappingChild(const CompoundSide& side, const LocalBox& box, Visit&& visit) {
+    ULONG stack[kTraversalStackDepth];
+    ULONG depth = 0;
+    stack[depth++] = 0;
+    while (depth > 0) {
+        const FCL_COMPOUND_NODE& node = side.Nodes[stack[--depth]];
+        if (!Overlaps(node, box)) {
+            continue;
+        }
+        if (node.Child != FCL_COMPOUND_NO_CHILD) {
+            if (!visit(node.Child)) {
+                return;
+            }
+            continue;
+        }
+        stack[depth++] = node.Right;
+        stack[depth++] = node.Left;
+    }
+}
+
+// 子形状与另一物体按原始顺序组成查询对；子形状本身不会是复合几何，另一物体是复合几何时在这里递归。
+NTSTATUS CollideChild(
+    const CompoundSide& side,
+    ULONG child,
+    _Out_ PBOOLEAN isColliding,
+    _Out_opt_ PFCL_CONTACT_INFO contactInfo,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver,
+    _Out_ ULONG* otherChild) noexcept {
+    const FCL_TRANSFORM childTransform = Compose(*side.Transform, side.Children[child].LocalTransform);
+    const FCL_GEOMETRY_SNAPSHOT& snapshot = side.Children[child].Snapshot;
+    FCL_COMPOUND_CHILD_PAIR inner = {};
+    const NTSTATUS status = side.CompoundFirst
+        ? fclmusa::narrowphase::CompoundCollide(
+              snapshot, childTransform, *side.Other, *side.OtherTransform, isColliding, contactInfo, solver, &inner)
+        : fclmusa::narrowphase::CompoundCollide(
+              *side.Other, *side.OtherTransform, snapshot, childTransform, isColliding, contactInfo, solver, &inner);
+    *otherChild = side.CompoundFirst ? inner.Child2 : inner.Child1;
+    return status;
+}
+
+NTSTATUS DistanceToChild(
+    const CompoundSide& side,
+    ULONG child,
+    _Out_ PFCL_DISTANCE_RESULT result,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver,
+    _Out_ ULONG* otherChild) noexcept {
+    const FCL_TRANSFORM childTransform = Compose(*side.Transform, side.Children[child].LocalTransform);
+    const FCL_GEOMETRY_SNAPSHOT& snapshot = side.Children[child].Snapshot;
+    FCL_COMPOUND_CHILD_PAIR inner = {};
+    const NTSTATUS status = side.CompoundFirst
+        ? fclmusa::narrowphase::CompoundDistance(
+              snapshot, childTransform, *side.Other, *side.OtherTransform, result, solver, &inner)
+        : fclmusa::narrowphase::CompoundDistance(
+              *side.Other, *side.OtherTransform, snapshot, childTransform, result, solver, &inner);
+    *otherChild = side.CompoundFirst ? inner.Child2 : inner.Child1;
+    return status;
+}
+
+NTSTATUS CollideCompoundSide(
+    const CompoundSide& side,
+    _Out_ PBOOLEAN isColliding,
+    _Out_opt_ PFCL_CONTACT_INFO contactInfo,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver,
+    _Out_ ULONG* compoundChild,
+    _Out_ ULONG* otherChild) noexcept {
+    const LocalBox box = BoundsInFrame(*side.Other, *side.OtherTransform, *side.Transform);
+    NTSTATUS status = STATUS_SUCCESS;
+    ForEachOverlappingChild(side, box, [&](ULONG child) {
+        BOOLEAN hit = FALSE;
+        FCL_CONTACT_INFO contact = {};
+        ULONG innerChild = FCL_COMPOUND_NO_CHILD;
+        status = CollideChild(side, child, &hit, (contactInfo != nullptr) ? &contact : nullptr, solver, &innerChild);
+        if (!NT_SUCCESS(status)) {
+            return false;
+        }
+        if (!hit) {
+            return true;
+        }
+        if (!*isColliding || contact.PenetrationDepth > contactInfo->PenetrationDepth) {
+            *isColliding = TRUE;
+            *compoundChild = child;
+            *otherChild = innerChild;
+            if (contactInfo != nullptr) {
+                *contactInfo = contact;
+            }
+        }
+        return contactInfo != nullptr;
+    });
+    return status;
+}
+
+}  // namespace
+
+namespace fclmusa::narrowphase {
+
+NTSTATUS
+CompoundCollide(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _Out_ PBOOLEAN isColliding,
+    _Out_opt_ PFCL_CONTACT_INFO contactInfo,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver,
+    _Out_opt_ PFCL_COMPOUND_CHILD_PAIR children) noexcept {
+    if (isColliding == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    FCL_COMPOUND_CHILD_PAIR hit = {FCL_COMPOUND_NO_CHILD, FCL_COMPOUND_NO_CHILD};
+    if (children != nullptr) {
+        *children = hit;
+    }
+    if (!IsCompoundPair(object1, object2)) {
+        return DispatchCollision(object1, transform1, object2, transform2, isColliding, contactInfo, solver);
+    }
+
+    *isColliding = FALSE;
+    if (contactInfo != nullptr) {
+        RtlZeroMemory(contactInfo, sizeof(*contactInfo));
+    }
+
+    const bool compoundFirst = object1.Type == FCL_GEOMETRY_COMPOUND;
+    CompoundSide side = {};
+    if (!BindCompoundSide(
+            compoundFirst ? object1 : object2,
+            compoundFirst ? transform1 : transform2,
+            compoundFirst ? object2 : object1,
+            compoundFirst ? transform2 : transform1,
+            compoundFirst,
+            &side)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    const NTSTATUS status = CollideCompoundSide(
+        side,
+        isColliding,
+        contactInfo,
+        solver,
+        compoundFirst ? &hit.Child1 : &hit.Child2,
+        compoundFirst ? &hit.Child2 : &hit.Child1);
+    if (NT_SUCCESS(status) && children != nullptr) {
+        *children = hit;
+    }
+    return status;
+}
+
+NTSTATUS
+CompoundCollideManifold(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _In_ ULONG maxContacts,
+    _Out_ PBOOLEAN isColliding,
+    _Out_writes_(maxContacts) PFCL_CONTACT_INFO contacts,
+    _Out_ PULONG contactCount,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver) noexcept {
+    if (isColliding == nullptr || contacts == nullptr || contactCount == nullptr || maxContacts == 0) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    *isColliding = FALSE;
+    *contactCount = 0;
+
+    const bool compoundFirst = object1.Type == FCL_GEOMETRY_COMPOUND;
+    CompoundSide side = {};
+    if (!BindCompoundSide(
+            compoundFirst ? object1 : object2,
+            compoundFirst ? transform1 : transform2,
+            compoundFirst ? object2 : object1,
+            compoundFirst ? transform2 : transform1,
+            compoundFirst,
+            &side)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    const LocalBox box = BoundsInFrame(*side.Other, *side.OtherTransform, *side.Transform);
+    NTSTATUS status = STATUS_SUCCESS;
+    ULONG written = 0;
+    ForEachOverlappingChild(side, box, [&](ULONG child) {
+        const FCL_TRANSFORM childTransform = Compose(*side.Transform, side.Children[child].LocalTransform);
+        const FCL_GEOMETRY_SNAPSHOT& snapshot = side.Children[child].Snapshot;
+        BOOLEAN hit = FALSE;
+        ULONG added = 0;
+        status = compoundFirst
+            ? DispatchCollisionManifold(
+                  snapshot, childTransform, object2, transform2, maxContacts - written, &hit, contacts + written, &added, solver)
+            : DispatchCollisionManifold(
+                  object1, transform1, snapshot, childTransform, maxContacts - written, &hit, contacts + written, &added, solver);
+        if (!NT_SUCCESS(status)) {
+            return false;
+        }
+        if (hit) {
+            *isColliding = TRUE;
+            written += added;
+        }
+        return written < maxContacts;
+    });
+    if (!NT_SUCCESS(status)) {
+        *contactCount = 0;
+        return status;
+    }
+
+    ULONG deepest = 0;
+    for (ULONG i = 1; i < written; ++i) {
+        if (contacts[i].PenetrationDepth > contacts[deepest].PenetrationDepth) {
+            deepest = i;
+        }
+    }
+    if (deepest != 0) {
+        const FCL_CONTACT_INFO swap = contacts[0];
+        contacts[0] = contacts[deepest];
+        contacts[deepest] = swap;
+    }
+    *contactCount = written;
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS
+CompoundDistance(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _Out_ PFCL_DISTANCE_RESULT result,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver,
+    _Out_opt_ PFCL_COMPOUND_CHILD_PAIR children) noexcept {
+    if (result == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    FCL_COMPOUND_CHILD_PAIR nearest = {FCL_COMPOUND_NO_CHILD, FCL_COMPOUND_NO_CHILD};
+    if (children != nullptr) {
+        *children = nearest;
+    }
+    if (!IsCompoundPair(object1, object2)) {
+        return DispatchDistance(object1, transform1, object2, transform2, result, solver);
+    }
+    RtlZeroMemory(result, sizeof(*result));
+
+    const bool compoundFirst = object1.Type == FCL_GEOMETRY_COMPOUND;
+    CompoundSide side = {};
+    if (!BindCompoundSide(
+            compoundFirst ? object1 : object2,
+            compoundFirst ? transform1 : transform2,
+            compoundFirst ? object2 : object1,
+            compoundFirst ? transform2 : transform1,
+            compoundFirst,
+            &side)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    ULONG* compoundChild = compoundFirst ? &nearest.Child1 : &nearest.Child2;
+    ULONG* otherChild = compoundFirst ? &nearest.Child2 : &nearest.Child1;
+
+    const LocalBox box = BoundsInFrame(*side.Other, *side.OtherTransform, *side.Transform);
+    float best = FLT_MAX;
+    ULONG stack[kTraversalStackDepth];
+    ULONG depth = 0;
+    stack[depth++] = 0;
+    while (depth > 0 && best > 0.0f) {
+        const FCL_COMPOUND_NODE& node = side.Nodes[stack[--depth]];
+        if (BoxGap(node, box) >= best) {
+            continue;
+        }
+        if (node.Child != FCL_COMPOUND_NO_CHILD) {
+            FCL_DISTANCE_RESULT candidate = {};
+            ULONG innerChild = FCL_COMPOUND_NO_CHILD;
+            const NTSTATUS status = DistanceToChild(side, node.Child, &candidate, solver, &innerChild);
+            if (!NT_SUCCESS(status)) {
+                return status;
+            }
+            if (candidate.Distance < best) {
+                best = candidate.Distance;
+                *result = candidate;
+                *compoundChild = node.Child;
+                *otherChild = innerChild;
+            }
+            continue;
+        }
+        // 间隙较小的子节点后入栈、先访问，尽早收紧上界。
+        const bool leftNearer = BoxGap(side.Nodes[node.Left], box) <= BoxGap(side.Nodes[node.Right], box);
+        stack[depth++] = leftNearer ? node.Right : node.Left;
+        stack[depth++] = leftNearer ? node.Left : node.Right;
+    }
+
+    if (children != nullptr) {
+        *children = nearest;
+    }
+    return STATUS_SUCCESS;
+}
+
+}  // namespace fclmusa::narrowphase
@@ -2,17 +2,264 @@
 
 #include "fclmusa/platform.h"
 #if !FCL_MUSA_KERNEL_MODE
+    #include <atomic>
+    #include <cstring>
     #include <limits>
 #endif
+#include <algorithm>
 
+#include "fclmusa/memory/alloc_profiler.h"
 #include "fclmusa/memory/pool_allocator.h"
 
-extern "C"
-void* FclCcdRealloc(_Inout_opt_ void* buffer, _In_ size_t size) {
-    return fclmusa::memory::Reallocate(buffer, size);
+namespace {
+
+using fclmusa::narrowphase::kCcdPoolChunkBytes;
+using fclmusa::narrowphase::kCcdPoolMaxObjectBytes;
+using fclmusa::memory::detail::AllocationHeader;
+using fclmusa::memory::detail::kCcdPoolOrigin;
+
+// 对象块（含 AllocationHeader）按 64 字节取整分级：64 / 128 / 192 / 256。
+constexpr size_t kClassGranularity = 64;
+constexpr ULONG kClassCount =
+    static_cast<ULONG>((sizeof(AllocationHeader) + kCcdPoolMaxObjectBytes + kClassGranularity - 1) / kClassGranularity);
+
+struct alignas(16) PoolChunk {
+    PoolChunk* Next;
+    size_t Offset;
+
+    unsigned char* Data() noexcept {
+        return reinterpret_cast<unsigned char*>(this + 1);
+    }
+};
+
+constexpr size_t kChunkDataBytes = kCcdPoolChunkBytes - sizeof(PoolChunk);
+
+// 空闲对象的链接指针写在负载区，块头保持不变（Size 仍是最近一次请求的大小）。
+struct FreeObject {
+    FreeObject* Next;
+};
+
+struct CcdObjectPool {
+    PoolChunk* Chunks;
+    FreeObject* FreeLists[kClassCount];
+    ULONGLONG LiveObjects;
+    ULONGLONG PeakObjects;
+    ULONGLONG Allocations;
+    ULONGLONG Recycled;
+    ULONGLONG Frees;
+    ULONGLONG ChunkCount;
+    ULONGLONG Fallbacks;
+#if FCL_MUSA_KERNEL_MODE
+    PVOID volatile Owner;
+    volatile BOOLEAN Bound;
+    KIRQL Irql;
+#endif
+};
+
+#if FCL_MUSA_KERNEL_MODE
+// 与查询 arena 相同按 (线程, IRQL) 绑定槽位，打断查询线程的 DPC 不会误用其对象池。
+constexpr ULONG kPoolSlotCount = 64;
+CcdObjectPool g_PoolSlots[kPoolSlotCount] = {};
+volatile LONG g_ActivePoolCount = 0;
+volatile LONG g_PoolEnabled = 1;
+volatile LONG64 g_ScopeCount = 0;
+volatile LONG64 g_ObjectAllocations = 0;
+volatile LONG64 g_RecycledAllocations = 0;
+volatile LONG64 g_ObjectFrees = 0;
+volatile LONG64 g_ChunkAllocations = 0;
+volatile LONG64 g_FallbackAllocations = 0;
+volatile LONG64 g_PeakScopeObjects = 0;
+#else
+struct ThreadPool {
+    CcdObjectPool Pool = {};
+    bool Bound = false;
+};
+
+thread_local ThreadPool t_Pool;
+std::atomic<bool> g_PoolEnabled{true};
+std::atomic<unsigned long long> g_ScopeCount{0};
+std::atomic<unsigned long long> g_ObjectAllocations{0};
+std::atomic<unsigned long long> g_RecycledAllocations{0};
+std::atomic<unsigned long long> g_ObjectFrees{0};
+std::atomic<unsigned long long> g_ChunkAllocations{0};
+std::atomic<unsigned long long> g_FallbackAllocations{0};
+std::atomic<unsigned long long> g_PeakScopeObjects{0};
+#endif
+
+inline ULONG ClassForPayload(size_t size) noexcept {
+    return static_cast<ULONG>((sizeof(AllocationHeader) + size + kClassGranularity - 1) / kClassGranularity) - 1;
 }
 
-namespace {
+inline size_t ClassBytes(ULONG cls) noexcept {
+    return (static_cast<size_t>(cls) + 1) * kClassGranularity;
+}
+
+void* PoolAllocate(CcdObjectPool* pool, size_t size) noexcept {
+    if (size > kCcdPoolMaxObjectBytes) {
+        pool->Fallbacks++;
+        return nullptr;
+    }
+
+    const ULONG cls = ClassForPayload(size);
+    AllocationHeader* header = nullptr;
+    if (pool->FreeLists[cls] != nullptr) {
+        FreeObject* object = pool->FreeLists[cls];
+        pool->FreeLists[cls] = object->Next;
+        header = reinterpret_cast<AllocationHeader*>(object) - 1;
+        pool->Recycled++;
+    } else {
+        const size_t blockBytes = ClassBytes(cls);
+        PoolChunk* chunk = pool->Chunks;
+        if (chunk == nullptr || kChunkDataBytes - chunk->Offset < blockBytes) {
+            // 块经 fclmusa::memory::Allocate 申请：查询 arena 激活时来自 arena，DISPATCH_LEVEL 时来自 DPC 预留池。
+            chunk = static_cast<PoolChunk*>(fclmusa::memory::Allocate(kCcdPoolChunkBytes));
+            if (chunk == nullptr) {
+                pool->Fallbacks++;
+                return nullptr;
+            }
+            chunk->Next = pool->Chunks;
+            chunk->Offset = 0;
+            pool->Chunks = chunk;
+            pool->ChunkCount++;
+        }
+        header = reinterpret_cast<AllocationHeader*>(chunk->Data() + chunk->Offset);
+        chunk->Offset += blockBytes;
+        header->Tag = FCL_MUSA_POOL_TAG;
+        header->Origin = kCcdPoolOrigin;
+    }
+
+    header->Size = size;
+    pool->Allocations++;
+    pool->LiveObjects++;
+    pool->PeakObjects = (std::max)(pool->PeakObjects, pool->LiveObjects);
+    return header + 1;
+}
+
+void PoolFree(CcdObjectPool* pool, void* buffer) noexcept {
+    const auto* header = static_cast<const AllocationHeader*>(buffer) - 1;
+    const ULONG cls = ClassForPayload(header->Size);
+    auto* object = static_cast<FreeObject*>(buffer);
+    object->Next = pool->FreeLists[cls];
+    pool->FreeLists[cls] = object;
+    pool->Frees++;
+    pool->LiveObjects--;
+}
+
+// 作用域结束时整块归还；仍存活的对象随块一起失效。
+void ReleasePool(CcdObjectPool* pool) noexcept {
+    PoolChunk* chunk = pool->Chunks;
+    while (chunk != nullptr) {
+        PoolChunk* next = chunk->Next;
+        fclmusa::memory::Free(chunk);
+        chunk = next;
+    }
+    pool->Chunks = nullptr;
+    for (FreeObject*& head : pool->FreeLists) {
+        head = nullptr;
+    }
+    pool->LiveObjects = 0;
+}
+
+void PublishStats(CcdObjectPool* pool) noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    InterlockedIncrement64(&g_ScopeCount);
+    InterlockedAdd64(&g_ObjectAllocations, static_cast<LONG64>(pool->Allocations));
+    InterlockedAdd64(&g_RecycledAllocations, static_cast<LONG64>(pool->Recycled));
+    InterlockedAdd64(&g_ObjectFrees, static_cast<LONG64>(pool->Frees));
+    InterlockedAdd64(&g_ChunkAllocations, static_cast<LONG64>(pool->ChunkCount));
+    InterlockedAdd64(&g_FallbackAllocations, static_cast<LONG64>(pool->Fallbacks));
+    const LONG64 peak = static_cast<LONG64>(pool->PeakObjects);
+    LONG64 previous = g_PeakScopeObjects;
+    while (peak > previous) {
+        const LONG64 observed = InterlockedCompareExchange64(&g_PeakScopeObjects, peak, previous);
+        if (observed == previous) {
+            break;
+        }
+        previous = observed;
+    }
+#else
+    g_ScopeCount.fetch_add(1, std::memory_order_relaxed);
+    g_ObjectAllocations.fetch_add(pool->Allocations, std::memory_order_relaxed);
+    g_RecycledAllocations.fetch_add(pool->Recycled, std::memory_order_relaxed);
+    g_ObjectFrees.fetch_add(pool->Frees, std::memory_order_relaxed);
+    g_ChunkAllocations.fetch_add(pool->ChunkCount, std::memory_order_relaxed);
+    g_FallbackAllocations.fetch_add(pool->Fallbacks, std::memory_order_relaxed);
+    unsigned long long previous = g_PeakScopeObjects.load(std::memory_order_relaxed);
+    while (pool->PeakObjects > previous &&
+           !g_PeakScopeObjects.compare_exchange_weak(previous, pool->PeakObjects)) {
+    }
+#endif
+    pool->PeakObjects = 0;
+    pool->Allocations = 0;
+    pool->Recycled = 0;
+    pool->Frees = 0;
+    pool->ChunkCount = 0;
+    pool->Fallbacks = 0;
+}
+
+#if FCL_MUSA_KERNEL_MODE
+
+CcdObjectPool* FindPool() noexcept {
+    if (g_ActivePoolCount == 0) {
+        return nullptr;
+    }
+    const PVOID self = KeGetCurrentThread();
+    const KIRQL irql = KeGetCurrentIrql();
+    for (ULONG i = 0; i < kPoolSlotCount; ++i) {
+        CcdObjectPool& slot = g_PoolSlots[i];
+        if (slot.Owner == self && slot.Bound && slot.Irql == irql) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+CcdObjectPool* AcquirePool() noexcept {
+    if (g_PoolEnabled == 0 || FindPool() != nullptr) {
+        return nullptr;
+    }
+    const PVOID self = KeGetCurrentThread();
+    for (ULONG i = 0; i < kPoolSlotCount; ++i) {
+        CcdObjectPool& slot = g_PoolSlots[i];
+        if (InterlockedCompareExchangePointer(&slot.Owner, self, nullptr) == nullptr) {
+            slot.Irql = KeGetCurrentIrql();
+            slot.Bound = TRUE;
+            InterlockedIncrement(&g_ActivePoolCount);
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+void UnbindPool(CcdObjectPool* pool) noexcept {
+    pool->Bound = FALSE;
+    InterlockedDecrement(&g_ActivePoolCount);
+    InterlockedExchangePointer(&pool->Owner, nullptr);
+}
+
+#else
+
+CcdObjectPool* FindPool() noexcept {
+    return t_Pool.Bound ? &t_Pool.Pool : nullptr;
+}
+
+CcdObjectPool* AcquirePool() noexcept {
+    if (!g_PoolEnabled.load(std::memory_order_relaxed) || t_Pool.Bound) {
+        return nullptr;
+    }
+    t_Pool.Bound = true;
+    return &t_Pool.Pool;
+}
+
+void UnbindPool(CcdObjectPool*) noexcept {
+    t_Pool.Bound = false;
+}
+
+#endif
+
+inline bool IsPoolObject(const void* buffer) noexcept {
+    return (static_cast<const AllocationHeader*>(buffer) - 1)->Origin == kCcdPoolOrigin;
+}
 
 inline bool SafeSizeMult(size_t a, size_t b, size_t* out) {
 #if FCL_MUSA_KERNEL_MODE
@@ -26,15 +273,126 @@ inline bool SafeSizeMult(size_t a, size_t b, size_t* out) {
 #endif
 }
 
+void* CcdAllocate(size_t size) noexcept {
+    CcdObjectPool* pool = FindPool();
+    if (pool != nullptr) {
+        void* object = PoolAllocate(pool, size);
+        if (object != nullptr) {
+            return object;
+        }
+    }
+    return fclmusa::memory::Allocate(size);
+}
+
 }  // namespace
 
+namespace fclmusa::narrowphase {
+
+void EnableCcdObjectPool(BOOLEAN enable) noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    InterlockedExchange(&g_PoolEnabled, enable ? 1 : 0);
+#else
+    g_PoolEnabled.store(enable != FALSE, std::memory_order_relaxed);
+#endif
+}
+
+BOOLEAN IsCcdObjectPoolEnabled() noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    return (g_PoolEnabled != 0) ? TRUE : FALSE;
+#else
+    return g_PoolEnabled.load(std::memory_order_relaxed) ? TRUE : FALSE;
+#endif
+}
+
+FCL_CCD_POOL_STATS QueryCcdObjectPoolStats() noexcept {
+    FCL_CCD_POOL_STATS stats = {};
+#if FCL_MUSA_KERNEL_MODE
+    stats.ScopeCount = static_cast<ULONGLONG>(g_ScopeCount);
+    stats.ObjectAllocations = static_cast<ULONGLONG>(g_ObjectAllocations);
+    stats.RecycledAllocations = static_cast<ULONGLONG>(g_RecycledAllocations);
+    stats.ObjectFrees = static_cast<ULONGLONG>(g_ObjectFrees);
+    stats.ChunkAllocations = static_cast<ULONGLONG>(g_ChunkAllocations);
+    stats.FallbackAllocations = static_cast<ULONGLONG>(g_FallbackAllocations);
+    stats.PeakScopeObjects = static_cast<ULONGLONG>(g_PeakScopeObjects);
+#else
+    stats.ScopeCount = g_ScopeCount.load(std::memory_order_relaxed);
+    stats.ObjectAllocations = g_ObjectAllocations.load(std::memory_order_relaxed);
+    stats.RecycledAllocations = g_RecycledAllocations.load(std::memory_order_relaxed);
+    stats.ObjectFrees = g_ObjectFrees.load(std::memory_order_relaxed);
+    stats.ChunkAllocations = g_ChunkAllocations.load(std::memory_order_relaxed);
+    stats.FallbackAllocations = g_FallbackAllocations.load(std::memory_order_relaxed);
+    stats.PeakScopeObjects = g_PeakScopeObjects.load(std::memory_order_relaxed);
+#endif
+    return stats;
+}
+
+void ResetCcdObjectPoolStats() noexcept {
+#if FCL_MUSA_KERNEL_MODE
+    InterlockedExchange64(&g_ScopeCount, 0);
+    InterlockedExchange64(&g_ObjectAllocations, 0);
+    InterlockedExchange64(&g_RecycledAllocations, 0);
+    InterlockedExchange64(&g_ObjectFrees, 0);
+    InterlockedExchange64(&g_ChunkAllocations, 0);
+    InterlockedExchange64(&g_FallbackAllocations, 0);
+    InterlockedExchange64(&g_PeakScopeObjects, 0);
+#else
+    g_ScopeCount.store(0, std::memory_order_relaxed);
+    g_ObjectAllocations.store(0, std::memory_order_relaxed);
+    g_RecycledAllocations.store(0, std::memory_order_relaxed);
+    g_ObjectFrees.store(0, std::memory_order_relaxed);
+    g_ChunkAllocations.store(0, std::memory_order_relaxed);
+    g_FallbackAllocations.store(0, std::memory_order_relaxed);
+    g_PeakScopeObjects.store(0, std::memory_order_relaxed);
+#endif
+}
+
+CcdObjectPoolScope::CcdObjectPoolScope() noexcept
+    : pool_(AcquirePool()) {}
+
+CcdObjectPoolScope::~CcdObjectPoolScope() noexcept {
+    if (pool_ == nullptr) {
+        return;
+    }
+    auto* pool = static_cast<CcdObjectPool*>(pool_);
+    PublishStats(pool);
+    ReleasePool(pool);
+    UnbindPool(pool);
+}
+
+}  // namespace fclmusa::narrowphase
+
+extern "C"
+void* FclCcdRealloc(_Inout_opt_ void* buffer, _In_ size_t size) {
+    FCL_ALLOCATION_SITE(FCL_ALLOC_SITE_LIBCCD);
+    if (buffer == nullptr) {
+        return CcdAllocate(size);
+    }
+    if (!IsPoolObject(buffer)) {
+        return fclmusa::memory::Reallocate(buffer, size);
+    }
+
+    // 对象池中的对象：在池内（或转发到 fclmusa::memory）重新分配后复制，旧对象放回空闲链表。
+    void* resized = nullptr;
+    if (size != 0) {
+        resized = CcdAllocate(size);
+        if (resized == nullptr) {
+            return nullptr;
+        }
+        const size_t oldSize = (static_cast<const AllocationHeader*>(buffer) - 1)->Size;
+        std::memcpy(resized, buffer, (std::min)(size, oldSize));
+    }
+    FclCcdFree(buffer);
+    return resized;
+}
+
 extern "C"
 void* FclCcdCalloc(_In_ size_t count, _In_ size_t size) {
     size_t total = 0;
     if (!SafeSizeMult(count, size, &total)) {
         return nullptr;
     }
-    void* ptr = fclmusa::memory::Allocate(total);
+    FCL_ALLOCATION_SITE(FCL_ALLOC_SITE_LIBCCD);
+    void* ptr = CcdAllocate(total);
     if (ptr != nullptr) {
         RtlZeroMemory(ptr, total);
     }
@@ -43,5 +401,16 @@ void* FclCcdCalloc(_In_ size_t count, _In_ size_t size) {
 
 extern "C"
 void FclCcdFree(_In_opt_ void* buffer) {
+    if (buffer == nullptr) {
+        return;
+    }
+    if (IsPoolObject(buffer)) {
+        // 对象不得越过其作用域；当前没有绑定的对象池时块已整体归还，不再放回空闲链表。
+        CcdObjectPool* pool = FindPool();
+        if (pool != nullptr) {
+            PoolFree(pool, buffer);
+        }
+        return;
+    }
     fclmusa::memory::Free(buffer);
 }
@@ -0,0 +1,223 @@
+#include "fclmusa/narrowphase/mpr_intersect.h"
+
+#include <ccd/ccd.h>
+#include <ccd/vec3.h>
+
+#include "fclmusa/geometry/convex_hull.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/geometry/obb.h"
+
+namespace {
+
+using namespace fclmusa::geom;
+
+// libccd 以 CCD_SINGLE 编译，ccd_real_t 为 float；容差取单精度下稳定的量级。
+constexpr ccd_real_t kMprTolerance = static_cast<ccd_real_t>(1e-5);
+constexpr unsigned long kMprMaxIterations = 128;
+
+// 每次查询在栈上构造，供 libccd 回调读取；世界坐标量提前算好，避免在迭代中重复变换。
+struct MprShape {
+    const FCL_GEOMETRY_SNAPSHOT* Snapshot;
+    FCL_TRANSFORM Transform;
+    FCL_MATRIX3X3 InverseRotation;
+    OrientedBox Box;
+    FCL_VECTOR3 Center;
+    FCL_VECTOR3 Axis;    // 胶囊体 / 圆柱体的世界轴向（单位向量）
+    // 凸包爬山起点：MPR 相邻迭代的方向变化小，沿用上一次的支撑顶点。
+    mutable ULONG SupportHint;
+};
+
+FCL_VECTOR3 FromCcd(const ccd_vec3_t* vector) noexcept {
+    return {
+        static_cast<float>(ccdVec3X(vector)),
+        static_cast<float>(ccdVec3Y(vector)),
+        static_cast<float>(ccdVec3Z(vector))};
+}
+
+void ToCcd(const FCL_VECTOR3& vector, ccd_vec3_t* out) noexcept {
+    ccdVec3Set(out, vector.X, vector.Y, vector.Z);
+}
+
+// Mesh 的凸包支撑点：局部坐标下线性扫描顶点。
+FCL_VECTOR3 MeshSupport(const MprShape& shape, const FCL_VECTOR3& direction) noexcept {
+    const auto& mesh = shape.Snapshot->Data.Mesh;
+    const FCL_VECTOR3 localDirection = MatrixVectorMultiply(shape.InverseRotation, direction);
+    ULONG best = 0;
+    float bestDot = Dot(mesh.Vertices[0], localDirection);
+    for (ULONG i = 1; i < mesh.VertexCount; ++i) {
+        const float value = Dot(mesh.Vertices[i], localDirection);
+        if (value > bestDot) {
+            bestDot = value;
+            best = i;
+        }
+    }
+    return TransformPoint(shape.Transform, mesh.Vertices[best]);
+}
+
+FCL_VECTOR3 ConvexSupport(const MprShape& shape, const FCL_VECTOR3& direction) noexcept {
+    const auto& convex = shape.Snapshot->Data.Convex;
+    const FCL_VECTOR3 localDirection = MatrixVectorMultiply(shape.InverseRotation, direction);
+    shape.SupportHint = FclConvexHullSupport(convex.Hull, &localDirection, shape.SupportHint);
+    return TransformPoint(shape.Transform, convex.Vertices[shape.SupportHint]);
+}
+
+// 胶囊体：端点球的支撑点；圆柱体：端面圆周上的支撑点。
+FCL_VECTOR3 AxialSupport(const MprShape& shape, const FCL_VECTOR3& direction, float radius, float halfLength, bool rounded) noexcept {
+    const float along = Dot(direction, shape.Axis);
+    FCL_VECTOR3 point = Add(shape.Center, Scale(shape.Axis, (along >= 0.0f) ? halfLength : -halfLength));
+    const FCL_VECTOR3 lateral = rounded ? direction : Subtract(direction, Scale(shape.Axis, along));
+    const float length = Length(lateral);
+    if (length > kSingularityEpsilon) {
+        point = Add(point, Scale(lateral, radius / length));
+    }
+    return point;
+}
+
+void SupportCallback(const void* object, const ccd_vec3_t* direction, ccd_vec3_t* out) {
+    const auto& shape = *static_cast<const MprShape*>(object);
+    const FCL_VECTOR3 dir = FromCcd(direction);
+    switch (shape.Snapshot->Type) {
+        case FCL_GEOMETRY_SPHERE: {
+            const float length = Length(dir);
+            const FCL_VECTOR3 unit = (length > kSingularityEpsilon) ? Scale(dir, 1.0f / length) : FCL_VECTOR3{1.0f, 0.0f, 0.0f};
+            ToCcd(Add(shape.Center, Scale(unit, shape.Snapshot->Data.Sphere.Radius)), out);
+            return;
+        }
+        case FCL_GEOMETRY_OBB:
+            ToCcd(SupportPoint(shape.Box, dir), out);
+            return;
+        case FCL_GEOMETRY_CAPSULE:
+            ToCcd(AxialSupport(shape, dir, shape.Snapshot->Data.Capsule.Radius, shape.Snapshot->Data.Capsule.HalfLength, true), out);
+            return;
+        case FCL_GEOMETRY_CYLINDER:
+            ToCcd(AxialSupport(shape, dir, shape.Snapshot->Data.Cylinder.Radius, shape.Snapshot->Data.Cylinder.HalfLength, false), out);
+            return;
+        case FCL_GEOMETRY_MESH:
+            ToCcd(MeshSupport(shape, dir), out);
+            return;
+        case FCL_GEOMETRY_CONVEX:
+            ToCcd(ConvexSupport(shape, dir), out);
+            return;
+        default:
+            ToCcd(shape.Center, out);
+            return;
+    }
+}
+
+void CenterCallback(const void* object, ccd_vec3_t* center) {
+    ToCcd(static_cast<const MprShape*>(object)->Center, center);
+}
+
+// MPR 要求参考点位于形状内部：Mesh 使用顶点质心（必在凸包内）。
+bool InitializeShape(const FCL_GEOMETRY_SNAPSHOT& snapshot, const FCL_TRANSFORM& transform, MprShape* shape) noexcept {
+    shape->Snapshot = &snapshot;
+    shape->Transform = transform;
+    shape->InverseRotation = TransposeMatrix(transform.Rotation);
+    shape->Box = {};
+    shape->Axis = {0.0f, 0.0f, 1.0f};
+    shape->SupportHint = 0;
+    switch (snapshot.Type) {
+        case FCL_GEOMETRY_SPHERE:
+            if (!(snapshot.Data.Sphere.Radius > 0.0f)) {
+                return false;
+            }
+            shape->Center = TransformPoint(transform, snapshot.Data.Sphere.Center);
+            return true;
+        case FCL_GEOMETRY_OBB:
+            shape->Box = BuildWorldObb(snapshot.Data.Obb, transform);
+            shape->Center = shape->Box.Center;
+            return true;
+        case FCL_GEOMETRY_CAPSULE:
+            if (!(snapshot.Data.Capsule.Radius > 0.0f) || !(snapshot.Data.Capsule.HalfLength > 0.0f)) {
+                return false;
+            }
+            shape->Center = TransformPoint(transform, snapshot.Data.Capsule.Center);
+            shape->Axis = Normalize(MatrixVectorMultiply(
+                MultiplyMatrix(transform.Rotation, snapshot.Data.Capsule.Rotation), {0.0f, 0.0f, 1.0f}));
+            return true;
+        case FCL_GEOMETRY_CYLINDER:
+            if (!(snapshot.Data.Cylinder.Radius > 0.0f) || !(snapshot.Data.Cylinder.HalfLength > 0.0f)) {
+                return false;
+            }
+            shape->Center = TransformPoint(transform, snapshot.Data.Cylinder.Center);
+            shape->Axis = Normalize(MatrixVectorMultiply(
+                MultiplyMatrix(transform.Rotation, snapshot.Data.Cylinder.Rotation), {0.0f, 0.0f, 1.0f}));
+            return true;
+        case FCL_GEOMETRY_MESH: {
+            const auto& mesh = snapshot.Data.Mesh;
+            if (mesh.Vertices == nullptr || mesh.VertexCount == 0) {
+                return false;
+            }
+            FCL_VECTOR3 sum = {0.0f, 0.0f, 0.0f};
+            for (ULONG i = 0; i < mesh.VertexCount; ++i) {
+                sum = Add(sum, mesh.Vertices[i]);
+            }
+            shape->Center = TransformPoint(transform, Scale(sum, 1.0f / static_cast<float>(mesh.VertexCount)));
+            return true;
+        }
+        case FCL_GEOMETRY_CONVEX:
+            if (snapshot.Data.Convex.Hull == nullptr || snapshot.Data.Convex.VertexCount == 0) {
+                return false;
+            }
+            shape->Center = TransformPoint(transform, FclConvexHullGetCentroid(snapshot.Data.Convex.Hull));
+            return true;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+namespace fclmusa::narrowphase {
+
+BOOLEAN
+MprSupportsGeometry(
+    _In_ FCL_GEOMETRY_TYPE type) noexcept {
+    switch (type) {
+        case FCL_GEOMETRY_SPHERE:
+        case FCL_GEOMETRY_OBB:
+        case FCL_GEOMETRY_CAPSULE:
+        case FCL_GEOMETRY_CYLINDER:
+        case FCL_GEOMETRY_MESH:
+        case FCL_GEOMETRY_CONVEX:
+            return TRUE;
+        default:
+            return FALSE;
+    }
+}
+
+NTSTATUS
+MprIntersect(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _Out_ PBOOLEAN isIntersecting) noexcept {
+    if (isIntersecting == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    *isIntersecting = FALSE;
+    if (!MprSupportsGeometry(object1.Type) || !MprSupportsGeometry(object2.Type)) {
+        return STATUS_NOT_SUPPORTED;
+    }
+
+    MprShape shape1 = {};
+    MprShape shape2 = {};
+    if (!InitializeShape(object1, transform1, &shape1) || !InitializeShape(object2, transform2, &shape2)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    ccd_t ccd;
+    CCD_INIT(&ccd);
+    ccd.support1 = SupportCallback;
+    ccd.support2 = SupportCallback;
+    ccd.center1 = CenterCallback;
+    ccd.center2 = CenterCallback;
+    ccd.mpr_tolerance = kMprTolerance;
+    ccd.max_iterations = kMprMaxIterations;
+
+    *isIntersecting = ccdMPRIntersect(&shape1, &shape2, &ccd) ? TRUE : FALSE;
+    return STATUS_SUCCESS;
+}
+
+}  // namespace fclmusa::narrowphase
@@ -0,0 +1,399 @@
+#include "fclmusa/narrowphase/query_dispatch.h"
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include "fclmusa/narrowphase/coherence_cache.h"
+#include "fclmusa/narrowphase/compound_dispatch.h"
+#include "fclmusa/narrowphase/mpr_intersect.h"
+#include "fclmusa/narrowphase/primitive_kernels.h"
+#include "fclmusa/upstream/upstream_bridge.h"
+
+namespace {
+
+using fclmusa::narrowphase::KernelContact;
+using fclmusa::narrowphase::PairKernel;
+using fclmusa::narrowphase::QueryKind;
+using fclmusa::narrowphase::ShapeTraits;
+
+// 新增几何类型时需同步更新：矩阵按枚举值直接索引，0 号槽位保留为空。
+constexpr std::size_t kGeometryTypeSlots = static_cast<std::size_t>(FCL_GEOMETRY_CYLINDER) + 1;
+
+using IntersectKernelFn = NTSTATUS (*)(
+    const FCL_GEOMETRY_SNAPSHOT&,
+    const FCL_TRANSFORM&,
+    const FCL_GEOMETRY_SNAPSHOT&,
+    const FCL_TRANSFORM&,
+    PBOOLEAN);
+
+using ContactKernelFn = NTSTATUS (*)(
+    const FCL_GEOMETRY_SNAPSHOT&,
+    const FCL_TRANSFORM&,
+    const FCL_GEOMETRY_SNAPSHOT&,
+    const FCL_TRANSFORM&,
+    PBOOLEAN,
+    PFCL_CONTACT_INFO);
+
+using DistanceKernelFn = NTSTATUS (*)(
+    const FCL_GEOMETRY_SNAPSHOT&,
+    const FCL_TRANSFORM&,
+    const FCL_GEOMETRY_SNAPSHOT&,
+    const FCL_TRANSFORM&,
+    PFCL_DISTANCE_RESULT);
+
+template <FCL_GEOMETRY_TYPE A, FCL_GEOMETRY_TYPE B>
+bool ValidatePair(const FCL_GEOMETRY_SNAPSHOT& object1, const FCL_GEOMETRY_SNAPSHOT& object2) noexcept {
+    return ShapeTraits<A>::IsValid(ShapeTraits<A>::From(object1)) &&
+           ShapeTraits<B>::IsValid(ShapeTraits<B>::From(object2));
+}
+
+template <FCL_GEOMETRY_TYPE A, FCL_GEOMETRY_TYPE B>
+NTSTATUS IntersectTrampoline(
+    const FCL_GEOMETRY_SNAPSHOT& object1,
+    const FCL_TRANSFORM& transform1,
+    const FCL_GEOMETRY_SNAPSHOT& object2,
+    const FCL_TRANSFORM& transform2,
+    PBOOLEAN isColliding) noexcept {
+    if (!ValidatePair<A, B>(object1, object2)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    const bool hit = PairKernel<A, B>::Intersect(
+        ShapeTraits<A>::From(object1),
+        transform1,
+        ShapeTraits<B>::From(object2),
+        transform2);
+    *isColliding = hit ? TRUE : FALSE;
+    return STATUS_SUCCESS;
+}
+
+template <FCL_GEOMETRY_TYPE A, FCL_GEOMETRY_TYPE B>
+NTSTATUS ContactTrampoline(
+    const FCL_GEOMETRY_SNAPSHOT& object1,
+    const FCL_TRANSFORM& transform1,
+    const FCL_GEOMETRY_SNAPSHOT& object2,
+    const FCL_TRANSFORM& transform2,
+    PBOOLEAN isColliding,
+    PFCL_CONTACT_INFO contactInfo) noexcept {
+    if (!ValidatePair<A, B>(object1, object2)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    KernelContact contact = {};
+    const bool hit = PairKernel<A, B>::Contact(
+        ShapeTraits<A>::From(object1),
+        transform1,
+        ShapeTraits<B>::From(object2),
+        transform2,
+        &contact);
+    *isColliding = hit ? TRUE : FALSE;
+    RtlZeroMemory(contactInfo, sizeof(*contactInfo));
+    if (hit) {
+        // 与 upstream_bridge.cpp 中 WriteContact 的输出布局保持一致。
+        contactInfo->Normal = contact.Normal;
+        contactInfo->PenetrationDepth = contact.PenetrationDepth;
+        contactInfo->PointOnObject1 = contact.Position;
+        contactInfo->PointOnObject2 = fclmusa::geom::Add(
+            contact.Position,
+            fclmusa::geom::Scale(contact.Normal, contact.PenetrationDepth));
+    }
+    return STATUS_SUCCESS;
+}
+
+template <FCL_GEOMETRY_TYPE A, FCL_GEOMETRY_TYPE B>
+NTSTATUS DistanceTrampoline(
+    const FCL_GEOMETRY_SNAPSHOT& object1,
+    const FCL_TRANSFORM& transform1,
+    const FCL_GEOMETRY_SNAPSHOT& object2,
+    const FCL_TRANSFORM& transform2,
+    PFCL_DISTANCE_RESULT result) noexcept {
+    if (!ValidatePair<A, B>(object1, object2)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    PairKernel<A, B>::Distance(
+        ShapeTraits<A>::From(object1),
+        transform1,
+        ShapeTraits<B>::From(object2),
+        transform2,
+        result);
+    return STATUS_SUCCESS;
+}
+
+template <QueryKind Kind>
+struct KernelSignature;
+
+template <>
+struct KernelSignature<QueryKind::Intersect> {
+    using Fn = IntersectKernelFn;
+};
+
+template <>
+struct KernelSignature<QueryKind::Contact> {
+    using Fn = ContactKernelFn;
+};
+
+template <>
+struct KernelSignature<QueryKind::Distance> {
+    using Fn = DistanceKernelFn;
+};
+
+template <QueryKind Kind, std::size_t Index>
+constexpr typename KernelSignature<Kind>::Fn KernelAt() noexcept {
+    constexpr auto a = static_cast<FCL_GEOMETRY_TYPE>(Index / kGeometryTypeSlots);
+    constexpr auto b = static_cast<FCL_GEOMETRY_TYPE>(Index % kGeometryTypeSlots);
+    if constexpr (!ShapeTraits<a>::kIsPrimitive || !ShapeTraits<b>::kIsPrimitive) {
+        return nullptr;
+    } else if constexpr (Kind == QueryKind::Intersect) {
+        if constexpr (PairKernel<a, b>::kIntersect) {
+            return &IntersectTrampoline<a, b>;
+        } else {
+            return nullptr;
+        }
+    } else if constexpr (Kind == QueryKind::Contact) {
+        if constexpr (PairKernel<a, b>::kContact) {
+            return &ContactTrampoline<a, b>;
+        } else {
+            return nullptr;
+        }
+    } else {
+        if constexpr (PairKernel<a, b>::kDistance) {
+            return &DistanceTrampoline<a, b>;
+        } else {
+            return nullptr;
+        }
+    }
+}
+
+template <QueryKind Kind, std::size_t... Index>
+constexpr std::array<typename KernelSignature<Kind>::Fn, sizeof...(Index)> MakeKernelMatrix(
+    std::index_sequence<Index...>) noexcept {
+    return {{KernelAt<Kind, Index>()...}};
+}
+
+template <QueryKind Kind>
+constexpr auto MakeKernelMatrix() noexcept {
+    return MakeKernelMatrix<Kind>(std::make_index_sequence<kGeometryTypeSlots * kGeometryTypeSlots>{});
+}
+
+constexpr auto kIntersectKernels = MakeKernelMatrix<QueryKind::Intersect>();
+constexpr auto kContactKernels = MakeKernelMatrix<QueryKind::Contact>();
+constexpr auto kDistanceKernels = MakeKernelMatrix<QueryKind::Distance>();
+
+// MPR 的 Mesh 支撑函数线性扫描顶点：顶点过多时凸包预判的代价会超过 BVH 遍历本身。
+constexpr ULONG kMprMeshVertexLimit = 256;
+
+static_assert(kIntersectKernels[FCL_GEOMETRY_SPHERE * kGeometryTypeSlots + FCL_GEOMETRY_SPHERE] != nullptr);
+static_assert(kIntersectKernels[FCL_GEOMETRY_MESH * kGeometryTypeSlots + FCL_GEOMETRY_MESH] == nullptr);
+static_assert(kDistanceKernels[FCL_GEOMETRY_OBB * kGeometryTypeSlots + FCL_GEOMETRY_CAPSULE] != nullptr);
+
+bool IsMprHullCandidate(const FCL_GEOMETRY_SNAPSHOT& object) noexcept {
+    if (!fclmusa::narrowphase::MprSupportsGeometry(object.Type)) {
+        return false;
+    }
+    return object.Type != FCL_GEOMETRY_MESH || object.Data.Mesh.VertexCount <= kMprMeshVertexLimit;
+}
+
+// 形状本身即为凸体（而非 Mesh 的凸包近似）时，MPR 的相交结论是精确的，两个方向都可直接采用。
+bool IsSolidConvex(const FCL_GEOMETRY_SNAPSHOT& object) noexcept {
+    return object.Type != FCL_GEOMETRY_MESH && fclmusa::narrowphase::MprSupportsGeometry(object.Type);
+}
+
+bool TryGetSlot(FCL_GEOMETRY_TYPE type1, FCL_GEOMETRY_TYPE type2, _Out_ std::size_t* slot) noexcept {
+    const auto index1 = static_cast<std::size_t>(type1);
+    const auto index2 = static_cast<std::size_t>(type2);
+    if (index1 >= kGeometryTypeSlots || index2 >= kGeometryTypeSlots) {
+        return false;
+    }
+    *slot = index1 * kGeometryTypeSlots + index2;
+    return true;
+}
+
+}  // namespace
+
+namespace fclmusa::narrowphase {
+
+BOOLEAN
+HasNativeKernel(
+    _In_ FCL_GEOMETRY_TYPE type1,
+    _In_ FCL_GEOMETRY_TYPE type2,
+    _In_ QueryKind kind) noexcept {
+    std::size_t slot = 0;
+    if (!TryGetSlot(type1, type2, &slot)) {
+        return FALSE;
+    }
+    switch (kind) {
+        case QueryKind::Intersect:
+            return kIntersectKernels[slot] != nullptr ? TRUE : FALSE;
+        case QueryKind::Contact:
+            return kContactKernels[slot] != nullptr ? TRUE : FALSE;
+        case QueryKind::Distance:
+            return kDistanceKernels[slot] != nullptr ? TRUE : FALSE;
+        default:
+            return FALSE;
+    }
+}
+
+NTSTATUS
+DispatchCollision(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _Out_ PBOOLEAN isColliding,
+    _Out_opt_ PFCL_CONTACT_INFO contactInfo,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver) noexcept {
+    if (isColliding == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (IsCompoundPair(object1, object2)) {
+        return CompoundCollide(object1, transform1, object2, transform2, isColliding, contactInfo, solver, nullptr);
+    }
+
+    std::size_t slot = 0;
+    if (TryGetSlot(object1.Type, object2.Type, &slot)) {
+        if (contactInfo == nullptr) {
+            const IntersectKernelFn kernel = kIntersectKernels[slot];
+            if (kernel != nullptr) {
+                return kernel(object1, transform1, object2, transform2, isColliding);
+            }
+            // 布尔查询：先用 MPR 测试凸包，凸包分离即可确定不相交，省去 GJK / BVH 路径。
+            if (IsMprHullCandidate(object1) && IsMprHullCandidate(object2)) {
+                BOOLEAN hullsIntersect = TRUE;
+                if (NT_SUCCESS(MprIntersect(object1, transform1, object2, transform2, &hullsIntersect)) &&
+                    (!hullsIntersect || (IsSolidConvex(object1) && IsSolidConvex(object2)))) {
+                    *isColliding = hullsIntersect;
+                    return STATUS_SUCCESS;
+                }
+            }
+        } else {
+            const ContactKernelFn kernel = kContactKernels[slot];
+            if (kernel != nullptr) {
+                return kernel(object1, transform1, object2, transform2, isColliding, contactInfo);
+            }
+        }
+    }
+
+    return FclUpstreamCollide(object1, transform1, object2, transform2, isColliding, contactInfo, solver);
+}
+
+NTSTATUS
+DispatchCollisionManifold(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _In_ ULONG maxContacts,
+    _Out_ PBOOLEAN isColliding,
+    _Out_writes_(maxContacts) PFCL_CONTACT_INFO contacts,
+    _Out_ PULONG contactCount,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver) noexcept {
+    if (isColliding == nullptr || contacts == nullptr || contactCount == nullptr || maxContacts == 0) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    *contactCount = 0;
+
+    if (IsCompoundPair(object1, object2)) {
+        return CompoundCollideManifold(
+            object1, transform1, object2, transform2, maxContacts, isColliding, contacts, contactCount, solver);
+    }
+
+    std::size_t slot = 0;
+    const ContactKernelFn kernel = TryGetSlot(object1.Type, object2.Type, &slot) ? kContactKernels[slot] : nullptr;
+    if (kernel == nullptr && maxContacts > 1) {
+        return FclUpstreamCollideManifold(
+            object1, transform1, object2, transform2, maxContacts, isColliding, contacts, contactCount, solver);
+    }
+
+    const NTSTATUS status = (kernel != nullptr)
+        ? kernel(object1, transform1, object2, transform2, isColliding, contacts)
+        : FclUpstreamCollide(object1, transform1, object2, transform2, isColliding, contacts, solver);
+    if (NT_SUCCESS(status) && *isColliding) {
+        *contactCount = 1;
+    }
+    return status;
+}
+
+NTSTATUS
+DispatchDistance(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _Out_ PFCL_DISTANCE_RESULT result,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver) noexcept {
+    if (result == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (IsCompoundPair(object1, object2)) {
+        return CompoundDistance(object1, transform1, object2, transform2, result, solver, nullptr);
+    }
+
+    std::size_t slot = 0;
+    if (TryGetSlot(object1.Type, object2.Type, &slot)) {
+        const DistanceKernelFn kernel = kDistanceKernels[slot];
+        if (kernel != nullptr) {
+            return kernel(object1, transform1, object2, transform2, result);
+        }
+    }
+
+    return FclUpstreamDistance(object1, transform1, object2, transform2, result, solver);
+}
+
+NTSTATUS
+DispatchDistance(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _In_ const FCL_DISTANCE_REQUEST& request,
+    _Out_ PFCL_DISTANCE_QUERY_RESULT result) noexcept {
+    if (result == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    RtlZeroMemory(result, sizeof(*result));
+
+    const bool hasThreshold = request.DistanceThreshold > 0.0f;
+    const bool nearestPoints = (request.Flags & FCL_DISTANCE_FLAG_SKIP_NEAREST_POINTS) == 0;
+
+    // 包围体间隙已不小于阈值时无需进入窄阶段。
+    if (hasThreshold) {
+        float bound = 0.0f;
+        if (EstimateSeparation(object1, transform1, object2, transform2, &bound) &&
+            bound >= request.DistanceThreshold) {
+            result->Result.Distance = bound;
+            result->BeyondThreshold = TRUE;
+            return STATUS_SUCCESS;
+        }
+    }
+
+    NTSTATUS status = STATUS_SUCCESS;
+    if (IsCompoundPair(object1, object2)) {
+        // 复合几何逐个子形状求距离，误差选项不下传；之后与原生内核一样套用阈值与最近点选项。
+        status = CompoundDistance(object1, transform1, object2, transform2, &result->Result, &request.Solver, nullptr);
+    } else {
+        std::size_t slot = 0;
+        const DistanceKernelFn kernel = TryGetSlot(object1.Type, object2.Type, &slot) ? kDistanceKernels[slot] : nullptr;
+        if (kernel == nullptr) {
+            return FclUpstreamDistanceQuery(object1, transform1, object2, transform2, request, result);
+        }
+
+        // 原生内核为解析解，误差选项不影响结果；这里只需套用阈值与最近点选项。
+        status = kernel(object1, transform1, object2, transform2, &result->Result);
+    }
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+    if (hasThreshold && result->Result.Distance >= request.DistanceThreshold) {
+        result->BeyondThreshold = TRUE;
+    }
+    if (!nearestPoints || result->BeyondThreshold) {
+        result->Result.ClosestPoint1 = {};
+        result->Result.ClosestPoint2 = {};
+    } else {
+        result->NearestPointsValid = TRUE;
+    }
+    return STATUS_SUCCESS;
+}
+
+}  // namespace fclmusa::narrowphase
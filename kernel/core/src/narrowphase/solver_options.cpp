@@ -0,0 +1,103 @@
+#include "fclmusa/narrowphase/solver_options.h"
+
+namespace {
+
+constexpr double kMaxSolverTolerance = 1.0;
+
+// 顺序锁：写者（PASSIVE_LEVEL，互斥）把序号置为奇数后改写，读者在序号为偶数且前后一致时接受快照。
+volatile LONG g_SolverSequence = 0;
+volatile LONG g_SolverWriter = 0;
+FCL_SOLVER_OPTIONS g_DefaultSolver = {FCL_GJK_SOLVER_LIBCCD, 0.0, 0};
+
+FCL_SOLVER_OPTIONS ReadDefaultSolver() noexcept {
+    for (;;) {
+        const LONG before = InterlockedCompareExchange(&g_SolverSequence, 0, 0);
+        if ((before & 1) == 0) {
+            FCL_SOLVER_OPTIONS snapshot = g_DefaultSolver;
+            MemoryBarrier();
+            if (InterlockedCompareExchange(&g_SolverSequence, 0, 0) == before) {
+                return snapshot;
+            }
+        }
+        YieldProcessor();
+    }
+}
+
+}  // namespace
+
+namespace fclmusa::narrowphase {
+
+BOOLEAN
+IsValidSolverOptions(
+    _In_ const FCL_SOLVER_OPTIONS& options) noexcept {
+    if (options.Solver != FCL_GJK_SOLVER_DEFAULT &&
+        options.Solver != FCL_GJK_SOLVER_LIBCCD &&
+        options.Solver != FCL_GJK_SOLVER_INDEP) {
+        return FALSE;
+    }
+    // 比较式同时拒绝 NaN；大于 1 的收敛容差没有意义。
+    return (options.Tolerance >= 0.0 && options.Tolerance <= kMaxSolverTolerance) ? TRUE : FALSE;
+}
+
+FCL_SOLVER_OPTIONS
+ResolveSolverOptions(
+    _In_opt_ const FCL_SOLVER_OPTIONS* requested) noexcept {
+    const FCL_SOLVER_OPTIONS defaults = ReadDefaultSolver();
+    if (requested == nullptr) {
+        return defaults;
+    }
+
+    FCL_SOLVER_OPTIONS resolved = *requested;
+    if (resolved.Solver == FCL_GJK_SOLVER_DEFAULT) {
+        resolved.Solver = defaults.Solver;
+    }
+    if (!(resolved.Tolerance > 0.0)) {
+        resolved.Tolerance = defaults.Tolerance;
+    }
+    if (resolved.MaxIterations == 0) {
+        resolved.MaxIterations = defaults.MaxIterations;
+    }
+    return resolved;
+}
+
+}  // namespace fclmusa::narrowphase
+
+extern "C"
+NTSTATUS
+FclSetDefaultSolverOptions(
+    _In_opt_ const FCL_SOLVER_OPTIONS* options) noexcept {
+    if (KeGetCurrentIrql() != PASSIVE_LEVEL) {
+        return STATUS_INVALID_DEVICE_STATE;
+    }
+
+    FCL_SOLVER_OPTIONS resolved = {FCL_GJK_SOLVER_LIBCCD, 0.0, 0};
+    if (options != nullptr) {
+        if (!fclmusa::narrowphase::IsValidSolverOptions(*options)) {
+            return STATUS_INVALID_PARAMETER;
+        }
+        resolved = *options;
+        if (resolved.Solver == FCL_GJK_SOLVER_DEFAULT) {
+            resolved.Solver = FCL_GJK_SOLVER_LIBCCD;
+        }
+    }
+
+    while (InterlockedCompareExchange(&g_SolverWriter, 1, 0) != 0) {
+        YieldProcessor();
+    }
+    InterlockedIncrement(&g_SolverSequence);
+    g_DefaultSolver = resolved;
+    InterlockedIncrement(&g_SolverSequence);
+    InterlockedExchange(&g_SolverWriter, 0);
+    return STATUS_SUCCESS;
+}
+
+extern "C"
+NTSTATUS
+FclQueryDefaultSolverOptions(
+    _Out_ PFCL_SOLVER_OPTIONS options) noexcept {
+    if (options == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    *options = ReadDefaultSolver();
+    return STATUS_SUCCESS;
+}
@@ -0,0 +1,908 @@
+#include "fclmusa/platform.h"
+
+#include <float.h>
+
+#include "fclmusa/geometry/bvh_model.h"
+#include "fclmusa/geometry/compound_model.h"
+#include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/geometry/obb.h"
+#include "fclmusa/raycast.h"
+
+namespace {
+
+using namespace fclmusa::geom;
+
+constexpr ULONG kTraversalStackDepth = 64;
+constexpr ULONG kPacketSize = 8;
+constexpr float kVolumePadding = 1e-5f;
+
+float Component(const FCL_VECTOR3& value, int axis) noexcept {
+    return (&value.X)[axis];
+}
+
+// 射线在 Mesh 局部坐标下的表示，以及 watertight 相交所需的剪切常量（Woop / Benthin / Wald 2013）。
+struct PreparedRay {
+    FCL_VECTOR3 Origin;
+    FCL_VECTOR3 Direction;
+    int Kx;
+    int Ky;
+    int Kz;
+    float Sx;
+    float Sy;
+    float Sz;
+    float MaxT;
+};
+
+struct LocalHit {
+    float T;
+    ULONG Triangle;
+    float U;
+    float V;
+};
+
+struct MeshView {
+    const FCL_VECTOR3* Vertices;
+    const UINT32* Indices;
+    ULONG TriangleCount;
+    const FCL_BVH_NODE* Nodes;
+    ULONG NodeCount;
+    const UINT32* Order;
+};
+
+void PrepareRay(const FCL_VECTOR3& origin, const FCL_VECTOR3& direction, float maxT, _Out_ PreparedRay* ray) noexcept {
+    ray->Origin = origin;
+    ray->Direction = direction;
+    ray->MaxT = maxT;
+
+    const float ax = fabsf(direction.X);
+    const float ay = fabsf(direction.Y);
+    const float az = fabsf(direction.Z);
+    ray->Kz = (ax > ay) ? ((ax > az) ? 0 : 2) : ((ay > az) ? 1 : 2);
+    ray->Kx = (ray->Kz + 1) % 3;
+    ray->Ky = (ray->Kx + 1) % 3;
+    if (Component(direction, ray->Kz) < 0.0f) {
+        const int swap = ray->Kx;
+        ray->Kx = ray->Ky;
+        ray->Ky = swap;
+    }
+    ray->Sz = 1.0f / Component(direction, ray->Kz);
+    ray->Sx = Component(direction, ray->Kx) * ray->Sz;
+    ray->Sy = Component(direction, ray->Ky) * ray->Sz;
+}
+
+bool IntersectTriangle(
+    const PreparedRay& ray,
+    const FCL_VECTOR3& v0,
+    const FCL_VECTOR3& v1,
+    const FCL_VECTOR3& v2,
+    _Out_ LocalHit* hit) noexcept {
+    const FCL_VECTOR3 a = Subtract(v0, ray.Origin);
+    const FCL_VECTOR3 b = Subtract(v1, ray.Origin);
+    const FCL_VECTOR3 c = Subtract(v2, ray.Origin);
+
+    const float az = Component(a, ray.Kz);
+    const float bz = Component(b, ray.Kz);
+    const float cz = Component(c, ray.Kz);
+    const float ax = Component(a, ray.Kx) - ray.Sx * az;
+    const float ay = Component(a, ray.Ky) - ray.Sy * az;
+    const float bx = Component(b, ray.Kx) - ray.Sx * bz;
+    const float by = Component(b, ray.Ky) - ray.Sy * bz;
+    const float cx = Component(c, ray.Kx) - ray.Sx * cz;
+    const float cy = Component(c, ray.Ky) - ray.Sy * cz;
+
+    float u = cx * by - cy * bx;
+    float v = ax * cy - ay * cx;
+    float w = bx * ay - by * ax;
+    // 边函数恰为 0 时（射线穿过边 / 顶点）用双精度重算，保证相邻三角形判定一致。
+    if (u == 0.0f || v == 0.0f || w == 0.0f) {
+        u = static_cast<float>(static_cast<double>(cx) * by - static_cast<double>(cy) * bx);
+        v = static_cast<float>(static_cast<double>(ax) * cy - static_cast<double>(ay) * cx);
+        w = static_cast<float>(static_cast<double>(bx) * ay - static_cast<double>(by) * ax);
+    }
+    if ((u < 0.0f || v < 0.0f || w < 0.0f) && (u > 0.0f || v > 0.0f || w > 0.0f)) {
+        return false;
+    }
+
+    const float det = u + v + w;
+    if (det == 0.0f) {
+        return false;
+    }
+
+    const float scaledT = ray.Sz * (u * az + v * bz + w * cz);
+    if (det > 0.0f ? (scaledT < 0.0f || scaledT > ray.MaxT * det) : (scaledT > 0.0f || scaledT < ray.MaxT * det)) {
+        return false;
+    }
+
+    const float inverse = 1.0f / det;
+    hit->T = scaledT * inverse;
+    hit->U = v * inverse;
+    hit->V = w * inverse;
+    return true;
+}
+
+// 射线 vs OBB 包围体（slab），包围体按尺度略微外扩以容忍扁平三角形包围体的舍入误差。
+bool IntersectVolume(const FCL_OBBRSS& volume, const PreparedRay& ray, _Out_ float* entry) noexcept {
+    const FCL_VECTOR3 offset = Subtract(ray.Origin, volume.Center);
+    const float largest = fmaxf(volume.Extents.X, fmaxf(volume.Extents.Y, volume.Extents.Z));
+    const float padding = kVolumePadding * (1.0f + largest);
+    float tMin = 0.0f;
+    float tMax = ray.MaxT;
+    for (int axis = 0; axis < 3; ++axis) {
+        const float extent = Component(volume.Extents, axis) + padding;
+        const float origin = Dot(offset, volume.Axis[axis]);
+        const float direction = Dot(ray.Direction, volume.Axis[axis]);
+        if (direction == 0.0f) {
+            if (origin < -extent || origin > extent) {
+                return false;
+            }
+            continue;
+        }
+        const float inverse = 1.0f / direction;
+        float t0 = (-extent - origin) * inverse;
+        float t1 = (extent - origin) * inverse;
+        if (t0 > t1) {
+            const float swap = t0;
+            t0 = t1;
+            t1 = swap;
+        }
+        tMin = (t0 > tMin) ? t0 : tMin;
+        tMax = (t1 < tMax) ? t1 : tMax;
+        if (tMin > tMax) {
+            return false;
+        }
+    }
+    *entry = tMin;
+    return true;
+}
+
+bool TestTriangle(const MeshView& mesh, UINT32 triangle, _Inout_ PreparedRay* ray, _Inout_ LocalHit* best) noexcept {
+    const UINT32* indices = mesh.Indices + static_cast<size_t>(triangle) * 3;
+    LocalHit candidate = {};
+    if (!IntersectTriangle(*ray, mesh.Vertices[indices[0]], mesh.Vertices[indices[1]], mesh.Vertices[indices[2]], &candidate)) {
+        return false;
+    }
+    candidate.Triangle = triangle;
+    *best = candidate;
+    ray->MaxT = candidate.T;
+    return true;
+}
+
+bool IsLeaf(const FCL_BVH_NODE& node) noexcept {
+    return node.LeftChild == ULONG_MAX;
+}
+
+// 线性扫描全部三角形：无 BVH 时使用，遍历栈溢出时也由此补完（TestTriangle 只接受更近的命中，结果与完整遍历一致）。
+bool ScanTriangles(const MeshView& mesh, _Inout_ PreparedRay* ray, bool anyHit, _Inout_ LocalHit* best) noexcept {
+    bool found = false;
+    for (ULONG triangle = 0; triangle < mesh.TriangleCount; ++triangle) {
+        if (TestTriangle(mesh, triangle, ray, best)) {
+            found = true;
+            if (anyHit) {
+                return true;
+            }
+        }
+    }
+    return found;
+}
+
+// 单射线遍历：近子树优先，出栈时用当前最近命中重新剪枝。
+bool RaycastMesh(const MeshView& mesh, _Inout_ PreparedRay* ray, bool anyHit, _Inout_ LocalHit* best) noexcept {
+    if (mesh.NodeCount == 0 || mesh.Nodes == nullptr || mesh.Order == nullptr) {
+        return ScanTriangles(mesh, ray, anyHit, best);
+    }
+
+    bool found = false;
+
+    struct StackEntry {
+        ULONG Node;
+        float Entry;
+    };
+    StackEntry stack[kTraversalStackDepth];
+    ULONG depth = 0;
+    float rootEntry = 0.0f;
+    if (!IntersectVolume(mesh.Nodes[0].Volume, *ray, &rootEntry)) {
+        return false;
+    }
+    stack[depth++] = {0, rootEntry};
+
+    while (depth > 0) {
+        const StackEntry current = stack[--depth];
+        if (current.Entry > ray->MaxT) {
+            continue;
+        }
+        const FCL_BVH_NODE& node = mesh.Nodes[current.Node];
+        if (IsLeaf(node)) {
+            for (ULONG k = 0; k < node.TriangleCount; ++k) {
+                if (TestTriangle(mesh, mesh.Order[node.FirstTriangle + k], ray, best)) {
+                    found = true;
+                    if (anyHit) {
+                        return true;
+                    }
+                }
+            }
+            continue;
+        }
+
+        float leftEntry = 0.0f;
+        float rightEntry = 0.0f;
+        const bool hitLeft = IntersectVolume(mesh.Nodes[node.LeftChild].Volume, *ray, &leftEntry);
+        const bool hitRight = IntersectVolume(mesh.Nodes[node.RightChild].Volume, *ray, &rightEntry);
+        if (depth + 2 > kTraversalStackDepth) {
+            return ScanTriangles(mesh, ray, anyHit, best) || found;
+        }
+        if (hitLeft && hitRight) {
+            const bool leftFirst = leftEntry <= rightEntry;
+            stack[depth++] = leftFirst ? StackEntry{node.RightChild, rightEntry} : StackEntry{node.LeftChild, leftEntry};
+            stack[depth++] = leftFirst ? StackEntry{node.LeftChild, leftEntry} : StackEntry{node.RightChild, rightEntry};
+        } else if (hitLeft) {
+            stack[depth++] = {node.LeftChild, leftEntry};
+        } else if (hitRight) {
+            stack[depth++] = {node.RightChild, rightEntry};
+        }
+    }
+    return found;
+}
+
+// 包遍历：至多 kPacketSize 条射线共享遍历栈，节点对包内任一射线可见即下降；
+// 每层只做一次节点读取，相干射线束下节点访问次数接近单射线。
+ULONG RaycastMeshPacket(
+    const MeshView& mesh,
+    _Inout_updates_(count) PreparedRay* rays,
+    ULONG count,
+    bool anyHit,
+    _Inout_updates_(count) LocalHit* best) noexcept {
+    ULONG foundMask = 0;
+    if (mesh.NodeCount == 0 || mesh.Nodes == nullptr || mesh.Order == nullptr) {
+        for (ULONG i = 0; i < count; ++i) {
+            if (RaycastMesh(mesh, &rays[i], anyHit, &best[i])) {
+                foundMask |= (1UL << i);
+            }
+        }
+        return foundMask;
+    }
+
+    struct StackEntry {
+        ULONG Node;
+        ULONG Mask;
+    };
+    StackEntry stack[kTraversalStackDepth];
+    ULONG depth = 0;
+    stack[depth++] = {0, (1UL << count) - 1};
+
+    while (depth > 0) {
+        const StackEntry current = stack[--depth];
+        const FCL_BVH_NODE& node = mesh.Nodes[current.Node];
+        ULONG mask = anyHit ? (current.Mask & ~foundMask) : current.Mask;
+        ULONG active = 0;
+        float nearestEntry = FLT_MAX;
+        ULONG nearestRay = 0;
+        for (ULONG i = 0; i < count; ++i) {
+            float entry = 0.0f;
+            if ((mask & (1UL << i)) != 0 && IntersectVolume(node.Volume, rays[i], &entry)) {
+                active |= (1UL << i);
+                if (entry < nearestEntry) {
+                    nearestEntry = entry;
+                    nearestRay = i;
+                }
+            }
+        }
+        if (active == 0) {
+            continue;
+        }
+
+        if (IsLeaf(node)) {
+            for (ULONG k = 0; k < node.TriangleCount; ++k) {
+                const UINT32 triangle = mesh.Order[node.FirstTriangle + k];
+                for (ULONG i = 0; i < count; ++i) {
+                    if ((active & (1UL << i)) != 0 && TestTriangle(mesh, triangle, &rays[i], &best[i])) {
+                        foundMask |= (1UL << i);
+                        if (anyHit) {
+                            active &= ~(1UL << i);
+                        }
+                    }
+                }
+            }
+            continue;
+        }
+
+        if (depth + 2 > kTraversalStackDepth) {
+            // 栈溢出时剩余工作改为逐射线线性扫描；ANY_HIT 下已命中的射线无需再扫。
+            for (ULONG i = 0; i < count; ++i) {
+                if (!(anyHit && (foundMask & (1UL << i)) != 0) && ScanTriangles(mesh, &rays[i], anyHit, &best[i])) {
+                    foundMask |= (1UL << i);
+                }
+            }
+            break;
+        }
+        // 以入射最早的射线决定子树顺序：其方向指向右子树中心时先访问左子树。
+        const FCL_VECTOR3 split = Subtract(mesh.Nodes[node.RightChild].Volume.Center, mesh.Nodes[node.LeftChild].Volume.Center);
+        const bool leftFirst = Dot(rays[nearestRay].Direction, split) >= 0.0f;
+        stack[depth++] = {leftFirst ? node.RightChild : node.LeftChild, active};
+        stack[depth++] = {leftFirst ? node.LeftChild : node.RightChild, active};
+    }
+    return foundMask;
+}
+
+bool RaycastSphere(
+    const FCL_VECTOR3& center,
+    float radius,
+    const FCL_VECTOR3& origin,
+    const FCL_VECTOR3& direction,
+    float maxT,
+    _Out_ float* t,
+    _Out_ FCL_VECTOR3* normal) noexcept {
+    const FCL_VECTOR3 offset = Subtract(origin, center);
+    const float a = Dot(direction, direction);
+    const float b = Dot(offset, direction);
+    const float c = Dot(offset, offset) - radius * radius;
+    const float discriminant = b * b - a * c;
+    if (discriminant < 0.0f) {
+        return false;
+    }
+    const float root = sqrtf(discriminant);
+    float hitT = (-b - root) / a;
+    if (hitT < 0.0f) {
+        hitT = (-b + root) / a;
+    }
+    if (hitT < 0.0f || hitT > maxT) {
+        return false;
+    }
+    *t = hitT;
+    *normal = Normalize(Subtract(Add(origin, Scale(direction, hitT)), center));
+    return true;
+}
+
+bool RaycastBox(
+    const OrientedBox& box,
+    const FCL_VECTOR3& origin,
+    const FCL_VECTOR3& direction,
+    float maxT,
+    _Out_ float* t,
+    _Out_ FCL_VECTOR3* normal) noexcept {
+    const FCL_VECTOR3 offset = Subtract(origin, box.Center);
+    float tEnter = -FLT_MAX;
+    float tExit = FLT_MAX;
+    FCL_VECTOR3 enterNormal = {};
+    FCL_VECTOR3 exitNormal = {};
+    for (int axis = 0; axis < 3; ++axis) {
+        const float extent = Component(box.Extents, axis);
+        const float localOrigin = Dot(offset, box.Axes[axis]);
+        const float localDirection = Dot(direction, box.Axes[axis]);
+        if (localDirection == 0.0f) {
+            if (localOrigin < -extent || localOrigin > extent) {
+                return false;
+            }
+            continue;
+        }
+        const float inverse = 1.0f / localDirection;
+        const float t0 = (-extent - localOrigin) * inverse;
+        const float t1 = (extent - localOrigin) * inverse;
+        // 射线沿 +axis 时从 -axis 面进入、+axis 面离开。
+        const float sign = (localDirection > 0.0f) ? -1.0f : 1.0f;
+        const float nearT = (t0 < t1) ? t0 : t1;
+        const float farT = (t0 < t1) ? t1 : t0;
+        if (nearT > tEnter) {
+            tEnter = nearT;
+            enterNormal = Scale(box.Axes[axis], sign);
+        }
+        if (farT < tExit) {
+            tExit = farT;
+            exitNormal = Scale(box.Axes[axis], -sign);
+        }
+        if (tEnter > tExit) {
+            return false;
+        }
+    }
+    const float hitT = (tEnter >= 0.0f) ? tEnter : tExit;
+    if (hitT < 0.0f || hitT > maxT || hitT == FLT_MAX) {
+        return false;
+    }
+    *t = hitT;
+    *normal = (tEnter >= 0.0f) ? enterNormal : exitNormal;
+    return true;
+}
+
+// 直线与无限长圆柱 x^2 + y^2 <= r^2（局部坐标，轴沿 Z）的参数区间；方向平行于轴时区间无界。
+bool LineInfiniteCylinder(
+    const FCL_VECTOR3& origin,
+    const FCL_VECTOR3& direction,
+    float radius,
+    _Out_ float* t0,
+    _Out_ float* t1) noexcept {
+    const float a = direction.X * direction.X + direction.Y * direction.Y;
+    const float b = origin.X * direction.X + origin.Y * direction.Y;
+    const float c = origin.X * origin.X + origin.Y * origin.Y - radius * radius;
+    if (a == 0.0f) {
+        *t0 = -FLT_MAX;
+        *t1 = FLT_MAX;
+        return c <= 0.0f;
+    }
+    const float discriminant = b * b - a * c;
+    if (discriminant < 0.0f) {
+        return false;
+    }
+    const float root = sqrtf(discriminant);
+    *t0 = (-b - root) / a;
+    *t1 = (-b + root) / a;
+    return true;
+}
+
+// 直线与 |z| <= halfLength 平板的参数区间。
+bool LineSlab(float origin, float direction, float halfLength, _Out_ float* t0, _Out_ float* t1) noexcept {
+    if (direction == 0.0f) {
+        *t0 = -FLT_MAX;
+        *t1 = FLT_MAX;
+        return origin >= -halfLength && origin <= halfLength;
+    }
+    const float inverse = 1.0f / direction;
+    const float lower = (-halfLength - origin) * inverse;
+    const float upper = (halfLength - origin) * inverse;
+    *t0 = (lower < upper) ? lower : upper;
+    *t1 = (lower < upper) ? upper : lower;
+    return true;
+}
+
+bool LineSphere(
+    const FCL_VECTOR3& offset,
+    const FCL_VECTOR3& direction,
+    float radius,
+    _Out_ float* t0,
+    _Out_ float* t1) noexcept {
+    const float a = Dot(direction, direction);
+    const float b = Dot(offset, direction);
+    const float c = Dot(offset, offset) - radius * radius;
+    const float discriminant = b * b - a * c;
+    if (discriminant < 0.0f) {
+        return false;
+    }
+    const float root = sqrtf(discriminant);
+    *t0 = (-b - root) / a;
+    *t1 = (-b + root) / a;
+    return true;
+}
+
+// 凸体的进入 / 离开区间取命中参数：起点在体内时取出射点。
+bool SelectHit(float enter, float exit, float maxT, _Out_ float* t) noexcept {
+    if (enter > exit) {
+        return false;
+    }
+    const float hitT = (enter >= 0.0f) ? enter : exit;
+    if (hitT < 0.0f || hitT > maxT || hitT == FLT_MAX) {
+        return false;
+    }
+    *t = hitT;
+    return true;
+}
+
+// 胶囊与圆柱在局部坐标（轴沿 Z）下求交；world 为形状的世界位姿。
+struct AxialRay {
+    FCL_VECTOR3 Origin;
+    FCL_VECTOR3 Direction;
+};
+
+AxialRay ToAxialFrame(const FCL_TRANSFORM& world, const FCL_VECTOR3& origin, const FCL_VECTOR3& direction) noexcept {
+    const FCL_MATRIX3X3 inverse = TransposeMatrix(world.Rotation);
+    return {
+        MatrixVectorMultiply(inverse, Subtract(origin, world.Translation)),
+        MatrixVectorMultiply(inverse, direction)};
+}
+
+bool RaycastCapsule(
+    const FCL_TRANSFORM& world,
+    float radius,
+    float halfLength,
+    const FCL_VECTOR3& origin,
+    const FCL_VECTOR3& direction,
+    float maxT,
+    _Out_ float* t,
+    _Out_ FCL_VECTOR3* normal) noexcept {
+    const AxialRay ray = ToAxialFrame(world, origin, direction);
+    // 胶囊是凸体：柱身与两端球的参数区间相互衔接，其并即为整体区间。
+    float enter = FLT_MAX;
+    float exit = -FLT_MAX;
+    float t0 = 0.0f;
+    float t1 = 0.0f;
+    float s0 = 0.0f;
+    float s1 = 0.0f;
+    if (LineInfiniteCylinder(ray.Origin, ray.Direction, radius, &t0, &t1) &&
+        LineSlab(ray.Origin.Z, ray.Direction.Z, halfLength, &s0, &s1)) {
+        t0 = fmaxf(t0, s0);
+        t1 = fminf(t1, s1);
+        if (t0 <= t1) {
+            enter = t0;
+            exit = t1;
+        }
+    }
+    for (int side = 0; side < 2; ++side) {
+        const float capZ = (side == 0) ? -halfLength : halfLength;
+        const FCL_VECTOR3 offset = {ray.Origin.X, ray.Origin.Y, ray.Origin.Z - capZ};
+        if (LineSphere(offset, ray.Direction, radius, &t0, &t1)) {
+            enter = fminf(enter, t0);
+            exit = fmaxf(exit, t1);
+        }
+    }
+
+    float hitT = 0.0f;
+    if (!SelectHit(enter, exit, maxT, &hitT)) {
+        return false;
+    }
+    const FCL_VECTOR3 point = Add(ray.Origin, Scale(ray.Direction, hitT));
+    const FCL_VECTOR3 axisPoint = {0.0f, 0.0f, Clamp(point.Z, -halfLength, halfLength)};
+    *t = hitT;
+    *normal = MatrixVectorMultiply(world.Rotation, Normalize(Subtract(point, axisPoint)));
+    return true;
+}
+
+bool RaycastCylinder(
+    const FCL_TRANSFORM& world,
+    float radius,
+    float halfLength,
+    const FCL_VECTOR3& origin,
+    const FCL_VECTOR3& direction,
+    float maxT,
+    _Out_ float* t,
+    _Out_ FCL_VECTOR3* normal) noexcept {
+    const AxialRay ray = ToAxialFrame(world, origin, direction);
+    float c0 = 0.0f;
+    float c1 = 0.0f;
+    float s0 = 0.0f;
+    float s1 = 0.0f;
+    if (!LineInfiniteCylinder(ray.Origin, ray.Direction, radius, &c0, &c1) ||
+        !LineSlab(ray.Origin.Z, ray.Direction.Z, halfLength, &s0, &s1)) {
+        return false;
+    }
+    const float enter = fmaxf(c0, s0);
+    const float exit = fminf(c1, s1);
+    float hitT = 0.0f;
+    if (!SelectHit(enter, exit, maxT, &hitT)) {
+        return false;
+    }
+    // 命中点由端面约束决定时法线沿轴，否则沿径向。
+    const bool capHit = (enter >= 0.0f) ? (s0 >= c0) : (s1 <= c1);
+    const FCL_VECTOR3 point = Add(ray.Origin, Scale(ray.Direction, hitT));
+    const FCL_VECTOR3 localNormal =
+        capHit ? FCL_VECTOR3{0.0f, 0.0f, (point.Z >= 0.0f) ? 1.0f : -1.0f} : Normalize({point.X, point.Y, 0.0f});
+    *t = hitT;
+    *normal = MatrixVectorMultiply(world.Rotation, localNormal);
+    return true;
+}
+
+FCL_TRANSFORM Compose(const FCL_TRANSFORM& outer, const FCL_TRANSFORM& inner) noexcept {
+    FCL_TRANSFORM result = {};
+    result.Rotation = MultiplyMatrix(outer.Rotation, inner.Rotation);
+    result.Translation = TransformPoint(outer, inner.Translation);
+    return result;
+}
+
+bool IsValidRay(const FCL_RAY& ray) noexcept {
+    return IsValidVector(ray.Origin) && IsValidVector(ray.Direction) && IsFiniteFloat(ray.MaxDistance) &&
+           Dot(ray.Direction, ray.Direction) > 0.0f;
+}
+
+float RayLimit(const FCL_RAY& ray, const FCL_RAY_HIT& hit) noexcept {
+    if (hit.Hit) {
+        return hit.Distance;
+    }
+    return (ray.MaxDistance > 0.0f) ? ray.MaxDistance : FLT_MAX;
+}
+
+void ResetHit(_Out_ PFCL_RAY_HIT hit) noexcept {
+    RtlZeroMemory(hit, sizeof(*hit));
+    hit->TriangleIndex = FCL_RAYCAST_NO_TRIANGLE;
+    hit->ObjectIndex = FCL_RAYCAST_NO_HIT;
+    hit->ChildIndex = FCL_COMPOUND_NO_CHILD;
+}
+
+void RecordHit(
+    const FCL_RAY& ray,
+    float t,
+    const FCL_VECTOR3& normal,
+    ULONG triangle,
+    float u,
+    float v,
+    ULONG objectIndex,
+    ULONG childIndex,
+    _Out_ PFCL_RAY_HIT hit) noexcept {
+    hit->Hit = TRUE;
+    hit->Distance = t;
+    hit->Point = Add(ray.Origin, Scale(ray.Direction, t));
+    hit->Normal = normal;
+    hit->TriangleIndex = triangle;
+    hit->BarycentricU = u;
+    hit->BarycentricV = v;
+    hit->ObjectIndex = objectIndex;
+    hit->ChildIndex = childIndex;
+}
+
+void RecordMeshHit(
+    const MeshView& mesh,
+    const FCL_TRANSFORM& transform,
+    const FCL_RAY& ray,
+    const LocalHit& local,
+    ULONG objectIndex,
+    ULONG childIndex,
+    _Out_ PFCL_RAY_HIT hit) noexcept {
+    const UINT32* indices = mesh.Indices + static_cast<size_t>(local.Triangle) * 3;
+    const FCL_VECTOR3& v0 = mesh.Vertices[indices[0]];
+    const FCL_VECTOR3 localNormal = Normalize(Cross(Subtract(mesh.Vertices[indices[1]], v0), Subtract(mesh.Vertices[indices[2]], v0)));
+    RecordHit(
+        ray,
+        local.T,
+        MatrixVectorMultiply(transform.Rotation, localNormal),
+        local.Triangle,
+        local.U,
+        local.V,
+        objectIndex,
+        childIndex,
+        hit);
+}
+
+// 凸包没有 BVH，三角化面按线性扫描求交（面数通常很少）；面按右手定则朝外，法线即外法线。
+bool BuildMeshView(const FCL_GEOMETRY_SNAPSHOT& object, _Out_ MeshView* mesh) noexcept {
+    if (object.Type == FCL_GEOMETRY_CONVEX) {
+        mesh->Vertices = object.Data.Convex.Vertices;
+        mesh->Indices = object.Data.Convex.Indices;
+        mesh->TriangleCount = object.Data.Convex.IndexCount / 3;
+        mesh->Nodes = nullptr;
+        mesh->NodeCount = 0;
+        mesh->Order = nullptr;
+    } else {
+        mesh->Vertices = object.Data.Mesh.Vertices;
+        mesh->Indices = object.Data.Mesh.Indices;
+        mesh->TriangleCount = object.Data.Mesh.IndexCount / 3;
+        mesh->Nodes = FclBvhGetNodes(object.Data.Mesh.Bvh, &mesh->NodeCount);
+        mesh->Order = FclBvhGetTriangleOrder(object.Data.Mesh.Bvh, nullptr);
+    }
+    return mesh->Vertices != nullptr && mesh->Indices != nullptr;
+}
+
+// 射线变换到 Mesh 局部坐标：刚体变换保持 t 不变。
+void PrepareLocalRay(const FCL_TRANSFORM& transform, const FCL_RAY& ray, float maxT, _Out_ PreparedRay* local) noexcept {
+    const FCL_MATRIX3X3 inverseRotation = TransposeMatrix(transform.Rotation);
+    PrepareRay(
+        MatrixVectorMultiply(inverseRotation, Subtract(ray.Origin, transform.Translation)),
+        MatrixVectorMultiply(inverseRotation, ray.Direction),
+        maxT,
+        local);
+}
+
+// 对单个对象更新每条射线的命中（只在更近时覆盖）；ANY_HIT 下已命中的射线直接跳过。
+// 复合体对每个子形状递归，childIndex 为当前子形状下标（非复合体为 FCL_COMPOUND_NO_CHILD）。
+NTSTATUS RaycastObject(
+    const FCL_GEOMETRY_SNAPSHOT& object,
+    const FCL_TRANSFORM& transform,
+    _In_reads_(rayCount) const FCL_RAY* rays,
+    ULONG rayCount,
+    ULONG flags,
+    ULONG objectIndex,
+    ULONG childIndex,
+    _Inout_updates_(rayCount) PFCL_RAY_HIT hits) noexcept {
+    const bool anyHit = (flags & FCL_RAYCAST_FLAG_ANY_HIT) != 0;
+    switch (object.Type) {
+    case FCL_GEOMETRY_SPHERE: {
+        const FCL_VECTOR3 center = TransformPoint(transform, object.Data.Sphere.Center);
+        for (ULONG i = 0; i < rayCount; ++i) {
+            if (anyHit && hits[i].Hit) {
+                continue;
+            }
+            float t = 0.0f;
+            FCL_VECTOR3 normal = {};
+            if (RaycastSphere(center, object.Data.Sphere.Radius, rays[i].Origin, rays[i].Direction, RayLimit(rays[i], hits[i]), &t, &normal)) {
+                RecordHit(rays[i], t, normal, FCL_RAYCAST_NO_TRIANGLE, 0.0f, 0.0f, objectIndex, childIndex, &hits[i]);
+            }
+        }
+        return STATUS_SUCCESS;
+    }
+    case FCL_GEOMETRY_OBB: {
+        const OrientedBox box = BuildWorldObb(object.Data.Obb, transform);
+        for (ULONG i = 0; i < rayCount; ++i) {
+            if (anyHit && hits[i].Hit) {
+                continue;
+            }
+            float t = 0.0f;
+            FCL_VECTOR3 normal = {};
+            if (RaycastBox(box, rays[i].Origin, rays[i].Direction, RayLimit(rays[i], hits[i]), &t, &normal)) {
+                RecordHit(rays[i], t, normal, FCL_RAYCAST_NO_TRIANGLE, 0.0f, 0.0f, objectIndex, childIndex, &hits[i]);
+            }
+        }
+        return STATUS_SUCCESS;
+    }
+    case FCL_GEOMETRY_CAPSULE:
+    case FCL_GEOMETRY_CYLINDER: {
+        const bool capsule = object.Type == FCL_GEOMETRY_CAPSULE;
+        const FCL_CAPSULE_GEOMETRY_DESC& capsuleDesc = object.Data.Capsule;
+        const FCL_CYLINDER_GEOMETRY_DESC& cylinderDesc = object.Data.Cylinder;
+        FCL_TRANSFORM world = {};
+        world.Rotation = MultiplyMatrix(transform.Rotation, capsule ? capsuleDesc.Rotation : cylinderDesc.Rotation);
+        world.Translation = TransformPoint(transform, capsule ? capsuleDesc.Center : cylinderDesc.Center);
+        const float radius = capsule ? capsuleDesc.Radius : cylinderDesc.Radius;
+        const float halfLength = capsule ? capsuleDesc.HalfLength : cylinderDesc.HalfLength;
+        for (ULONG i = 0; i < rayCount; ++i) {
+            if (anyHit && hits[i].Hit) {
+                continue;
+            }
+            float t = 0.0f;
+            FCL_VECTOR3 normal = {};
+            const float limit = RayLimit(rays[i], hits[i]);
+            const bool hit = capsule
+                ? RaycastCapsule(world, radius, halfLength, rays[i].Origin, rays[i].Direction, limit, &t, &normal)
+                : RaycastCylinder(world, radius, halfLength, rays[i].Origin, rays[i].Direction, limit, &t, &normal);
+            if (hit) {
+                RecordHit(rays[i], t, normal, FCL_RAYCAST_NO_TRIANGLE, 0.0f, 0.0f, objectIndex, childIndex, &hits[i]);
+            }
+        }
+        return STATUS_SUCCESS;
+    }
+    case FCL_GEOMETRY_COMPOUND: {
+        // 子形状不会是复合体，递归只有一层。
+        ULONG childCount = 0;
+        const FCL_COMPOUND_CHILD* children = FclCompoundGetChildren(object.Data.Compound.Model, &childCount);
+        if (children == nullptr && childCount > 0) {
+            return STATUS_INVALID_PARAMETER;
+        }
+        for (ULONG child = 0; child < childCount; ++child) {
+            const NTSTATUS status = RaycastObject(children[child].Snapshot,
+                Compose(transform, children[child].LocalTransform),
+                rays,
+                rayCount,
+                flags,
+                objectIndex,
+                child,
+                hits);
+            if (!NT_SUCCESS(status)) {
+                return status;
+            }
+        }
+        return STATUS_SUCCESS;
+    }
+    case FCL_GEOMETRY_MESH:
+    case FCL_GEOMETRY_CONVEX:
+        break;
+    default:
+        return STATUS_NOT_SUPPORTED;
+    }
+
+    MeshView mesh = {};
+    if (!BuildMeshView(object, &mesh)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if ((flags & FCL_RAYCAST_FLAG_PACKET) == 0) {
+        for (ULONG i = 0; i < rayCount; ++i) {
+            if (anyHit && hits[i].Hit) {
+                continue;
+            }
+            PreparedRay local = {};
+            PrepareLocalRay(transform, rays[i], RayLimit(rays[i], hits[i]), &local);
+            LocalHit best = {};
+            if (RaycastMesh(mesh, &local, anyHit, &best)) {
+                RecordMeshHit(mesh, transform, rays[i], best, objectIndex, childIndex, &hits[i]);
+            }
+        }
+        return STATUS_SUCCESS;
+    }
+
+    PreparedRay packet[kPacketSize];
+    LocalHit best[kPacketSize];
+    ULONG members[kPacketSize];
+    ULONG next = 0;
+    while (next < rayCount) {
+        ULONG count = 0;
+        while (next < rayCount && count < kPacketSize) {
+            if (!(anyHit && hits[next].Hit)) {
+                PrepareLocalRay(transform, rays[next], RayLimit(rays[next], hits[next]), &packet[count]);
+                best[count] = {};
+                members[count] = next;
+                ++count;
+            }
+            ++next;
+        }
+        if (count == 0) {
+            continue;
+        }
+        const ULONG foundMask = RaycastMeshPacket(mesh, packet, count, anyHit, best);
+        for (ULONG k = 0; k < count; ++k) {
+            if ((foundMask & (1UL << k)) != 0) {
+                const ULONG index = members[k];
+                RecordMeshHit(mesh, transform, rays[index], best[k], objectIndex, childIndex, &hits[index]);
+            }
+        }
+    }
+    return STATUS_SUCCESS;
+}
+
+}  // namespace
+
+extern "C"
+NTSTATUS
+FclRaycastCoreFromSnapshot(
+    _In_ const FCL_GEOMETRY_SNAPSHOT* object,
+    _In_ const FCL_TRANSFORM* transform,
+    _In_reads_(rayCount) const FCL_RAY* rays,
+    _In_ ULONG rayCount,
+    _In_ ULONG flags,
+    _Out_writes_(rayCount) PFCL_RAY_HIT hits) noexcept {
+    if (object == nullptr || transform == nullptr || hits == nullptr || (rays == nullptr && rayCount > 0)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    if (!IsValidTransform(*transform)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    for (ULONG i = 0; i < rayCount; ++i) {
+        if (!IsValidRay(rays[i])) {
+            return STATUS_INVALID_PARAMETER;
+        }
+        ResetHit(&hits[i]);
+    }
+    return RaycastObject(*object, *transform, rays, rayCount, flags, 0, FCL_COMPOUND_NO_CHILD, hits);
+}
+
+extern "C"
+NTSTATUS
+FclRaycastBatch(
+    _In_reads_(rayCount) const FCL_RAY* rays,
+    _In_ ULONG rayCount,
+    _In_reads_(targetCount) const FCL_BROADPHASE_OBJECT* targets,
+    _In_ ULONG targetCount,
+    _In_ ULONG flags,
+    _Out_writes_(rayCount) PFCL_RAY_HIT hits) noexcept {
+    if (hits == nullptr || (rays == nullptr && rayCount > 0) || (targets == nullptr && targetCount > 0)) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (KeGetCurrentIrql() != PASSIVE_LEVEL) {
+        return STATUS_INVALID_DEVICE_STATE;
+    }
+
+    for (ULONG i = 0; i < rayCount; ++i) {
+        if (!IsValidRay(rays[i])) {
+            return STATUS_INVALID_PARAMETER;
+        }
+        ResetHit(&hits[i]);
+    }
+
+    // 逐对象遍历全部射线：同一 BVH 在缓存中保持热度，ANY_HIT 下已命中的射线不再参与后续对象。
+    for (ULONG objectIndex = 0; objectIndex < targetCount; ++objectIndex) {
+        const FCL_BROADPHASE_OBJECT& target = targets[objectIndex];
+        const FCL_TRANSFORM transform = (target.Transform != nullptr) ? *target.Transform : IdentityTransform();
+        if (!IsValidTransform(transform)) {
+            return STATUS_INVALID_PARAMETER;
+        }
+        if (!FclIsGeometryHandleValid(target.Handle)) {
+            return STATUS_INVALID_HANDLE;
+        }
+
+        FCL_GEOMETRY_REFERENCE reference = {};
+        FCL_GEOMETRY_SNAPSHOT snapshot = {};
+        NTSTATUS status = FclAcquireGeometryReference(target.Handle, &reference, &snapshot);
+        if (!NT_SUCCESS(status)) {
+            return status;
+        }
+        status = RaycastObject(snapshot, transform, rays, rayCount, flags, objectIndex, FCL_COMPOUND_NO_CHILD, hits);
+        FclReleaseGeometryReference(&reference);
+        if (!NT_SUCCESS(status)) {
+            return status;
+        }
+    }
+
+    for (ULONG i = 0; i < rayCount; ++i) {
+        if (hits[i].Hit) {
+            hits[i].Handle = targets[hits[i].ObjectIndex].Handle;
+        }
+    }
+    return STATUS_SUCCESS;
+}
+
+extern "C"
+NTSTATUS
+FclRaycast(
+    _In_ const FCL_RAY* ray,
+    _In_reads_(targetCount) const FCL_BROADPHASE_OBJECT* targets,
+    _In_ ULONG targetCount,
+    _In_ ULONG flags,
+    _Out_ PFCL_RAY_HIT hit) noexcept {
+    if (ray == nullptr || hit == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    return FclRaycastBatch(ray, 1, targets, targetCount, flags & ~FCL_RAYCAST_FLAG_PACKET, hit);
+}
@@ -4,9 +4,14 @@
 
 #include <fcl/geometry/bvh/BVH_model.h>
 #include <fcl/geometry/shape/box.h>
+#include <fcl/geometry/shape/capsule.h>
+#include <fcl/geometry/shape/convex.h>
+#include <fcl/geometry/shape/cylinder.h>
 #include <fcl/geometry/shape/sphere.h>
 
+#include "fclmusa/diagnostics/phase_trace.h"
 #include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/memory/alloc_profiler.h"
 #include "fclmusa/memory/dpc_allocator.h"
 
 namespace fclmusa::upstream {
@@ -81,6 +86,34 @@ NTSTATUS BuildObbBinding(
     return STATUS_SUCCESS;
 }
 
+// fcl::Capsule / fcl::Cylinder 的 lz 为全长，轴沿局部 Z。
+template <typename Shape, typename Desc>
+NTSTATUS BuildAxialBinding(
+    const Desc& desc,
+    GeometryBinding* binding) noexcept {
+    if (binding == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    if (desc.Radius <= 0.0f || desc.HalfLength <= 0.0f) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    try {
+        binding->Geometry = std::allocate_shared<Shape>(
+            FclDpcNonPagedAllocator<Shape>{},
+            static_cast<double>(desc.Radius),
+            static_cast<double>(desc.HalfLength * 2.0f));
+    } catch (const std::bad_alloc&) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    binding->LocalTransform = fclmusa::geom::IdentityTransform();
+    binding->LocalTransform.Rotation = desc.Rotation;
+    binding->LocalTransform.Translation = desc.Center;
+    return STATUS_SUCCESS;
+}
+
 NTSTATUS BuildMeshGeometry(
     const FCL_GEOMETRY_SNAPSHOT& snapshot,
     GeometryPtr* geometry) noexcept {
@@ -95,6 +128,7 @@ NTSTATUS BuildMeshGeometry(
     }
 
     const ULONG triangleCount = mesh.IndexCount / 3;
+    FCL_ALLOCATION_SITE(FCL_ALLOC_SITE_BVH);
 
     try {
         auto model = std::allocate_shared<BVHModeld>(FclDpcNonPagedAllocator<BVHModeld>{});
@@ -145,6 +179,53 @@ NTSTATUS BuildMeshBinding(
     return STATUS_SUCCESS;
 }
 
+// 凸包以 fcl::Convex 参与上游 GJK / EPA / 保守推进；面保持三角化（每个面 "3, i0, i1, i2"）。
+NTSTATUS BuildConvexBinding(
+    const FCL_GEOMETRY_SNAPSHOT& snapshot,
+    GeometryBinding* binding) noexcept {
+    if (binding == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    const auto& convex = snapshot.Data.Convex;
+    if (convex.Vertices == nullptr || convex.Indices == nullptr ||
+        convex.VertexCount < 4 || convex.IndexCount < 12 || (convex.IndexCount % 3) != 0) {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    const ULONG faceCount = convex.IndexCount / 3;
+
+    try {
+        auto vertices = std::allocate_shared<std::vector<fcl::Vector3d>>(
+            FclDpcNonPagedAllocator<std::vector<fcl::Vector3d>>{}, convex.VertexCount);
+        for (ULONG i = 0; i < convex.VertexCount; ++i) {
+            (*vertices)[i] = ToEigenVector(convex.Vertices[i]);
+        }
+
+        auto faces = std::allocate_shared<std::vector<int>>(
+            FclDpcNonPagedAllocator<std::vector<int>>{}, static_cast<size_t>(faceCount) * 4);
+        for (ULONG face = 0; face < faceCount; ++face) {
+            (*faces)[face * 4] = 3;
+            (*faces)[face * 4 + 1] = static_cast<int>(convex.Indices[face * 3]);
+            (*faces)[face * 4 + 2] = static_cast<int>(convex.Indices[face * 3 + 1]);
+            (*faces)[face * 4 + 3] = static_cast<int>(convex.Indices[face * 3 + 2]);
+        }
+
+        binding->Geometry = std::allocate_shared<fcl::Convexd>(
+            FclDpcNonPagedAllocator<fcl::Convexd>{},
+            std::shared_ptr<const std::vector<fcl::Vector3d>>(vertices),
+            static_cast<int>(faceCount),
+            std::shared_ptr<const std::vector<int>>(faces));
+    } catch (const std::bad_alloc&) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    } catch (...) {
+        return STATUS_INTERNAL_ERROR;
+    }
+
+    binding->LocalTransform = fclmusa::geom::IdentityTransform();
+    return STATUS_SUCCESS;
+}
+
 }  // namespace
 
 FCL_TRANSFORM
@@ -174,14 +255,25 @@ BuildGeometryBinding(
     if (binding == nullptr) {
         return STATUS_INVALID_PARAMETER;
     }
+    FCL_ALLOCATION_SITE(FCL_ALLOC_SITE_UPSTREAM_MODEL);
+    FCL_TRACE_PHASE_SCOPE(FCL_TRACE_PHASE_BINDING_BUILD);
 
     switch (snapshot.Type) {
         case FCL_GEOMETRY_SPHERE:
             return BuildSphereBinding(snapshot.Data.Sphere, binding);
         case FCL_GEOMETRY_OBB:
             return BuildObbBinding(snapshot.Data.Obb, binding);
+        case FCL_GEOMETRY_CAPSULE:
+            return BuildAxialBinding<fcl::Capsuled>(snapshot.Data.Capsule, binding);
+        case FCL_GEOMETRY_CYLINDER:
+            return BuildAxialBinding<fcl::Cylinderd>(snapshot.Data.Cylinder, binding);
         case FCL_GEOMETRY_MESH:
             return BuildMeshBinding(snapshot, binding);
+        case FCL_GEOMETRY_CONVEX:
+            return BuildConvexBinding(snapshot, binding);
+        case FCL_GEOMETRY_COMPOUND:
+            // 复合几何在 query_dispatch 中按子形状展开，不会整体进入 upstream；CCD 等直接走 upstream 的查询不支持复合几何。
+            return STATUS_NOT_SUPPORTED;
         default:
             return STATUS_INVALID_PARAMETER;
     }
@@ -1,5 +1,7 @@
 ﻿#include "fclmusa/upstream/upstream_bridge.h"
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <vector>
 
@@ -7,10 +9,17 @@
 #include <fcl/narrowphase/collision.h>
 #include <fcl/narrowphase/continuous_collision.h>
 #include <fcl/narrowphase/distance.h>
+#include <fcl/narrowphase/detail/gjk_solver_indep.h>
+#include <fcl/narrowphase/detail/gjk_solver_libccd.h>
 
 #include "fclmusa/upstream/geometry_bridge.h"
+#include "fclmusa/diagnostics/phase_trace.h"
 #include "fclmusa/geometry/math_utils.h"
 #include "fclmusa/logging.h"
+#include "fclmusa/memory/alloc_profiler.h"
+#include "fclmusa/memory/query_arena.h"
+#include "fclmusa/narrowphase/libccd_memory.h"
+#include "fclmusa/narrowphase/solver_options.h"
 
 namespace {
 
@@ -28,30 +37,90 @@ FCL_VECTOR3 ToVector3(const fcl::Vector3d& vector) noexcept {
         static_cast<float>(vector.z())};
 }
 
+// Mesh 对在单次遍历中可能产生大量三角形接触：按输出容量放大原始上限，再约简为代表性集合。
+constexpr std::size_t kRawContactsPerOutput = 8;
+constexpr std::size_t kMaxRawContacts = 256;
+constexpr float kDuplicateContactDistanceSquared = 1e-10f;
+
+void ToContactInfo(const fcl::Contactd& contact, _Out_ PFCL_CONTACT_INFO contactInfo) noexcept {
+    contactInfo->Normal = ToVector3(contact.normal);
+    contactInfo->PenetrationDepth = static_cast<float>(contact.penetration_depth);
+    contactInfo->PointOnObject1 = ToVector3(contact.pos);
+    const FCL_VECTOR3 pen = fclmusa::geom::Scale(contactInfo->Normal, contactInfo->PenetrationDepth);
+    contactInfo->PointOnObject2 = fclmusa::geom::Add(contactInfo->PointOnObject1, pen);
+}
+
 void WriteContact(
     const fcl::CollisionResultd& upstream,
     _Out_ PFCL_CONTACT_INFO contactInfo) noexcept {
     if (contactInfo == nullptr) {
         return;
     }
+    FCL_TRACE_PHASE_SCOPE(FCL_TRACE_PHASE_RESULT_CONVERSION);
 
     RtlZeroMemory(contactInfo, sizeof(*contactInfo));
     if (upstream.isCollision() && upstream.numContacts() > 0) {
-        const fcl::Contactd& contact = upstream.getContact(0);
-        contactInfo->Normal = ToVector3(contact.normal);
-        contactInfo->PenetrationDepth = static_cast<float>(contact.penetration_depth);
-        contactInfo->PointOnObject1 = ToVector3(contact.pos);
-        const FCL_VECTOR3 pen = fclmusa::geom::Scale(contactInfo->Normal, contactInfo->PenetrationDepth);
-        contactInfo->PointOnObject2 = fclmusa::geom::Add(contactInfo->PointOnObject1, pen);
+        ToContactInfo(upstream.getContact(0), contactInfo);
     }
 }
 
+float SquaredDistance(const FCL_VECTOR3& a, const FCL_VECTOR3& b) noexcept {
+    const FCL_VECTOR3 delta = fclmusa::geom::Subtract(a, b);
+    return fclmusa::geom::Dot(delta, delta);
+}
+
+// 约简策略：先取穿透最深的接触点，再反复挑选离已选集合最远的点（最远点采样），
+// 得到覆盖接触区域极值的代表性集合；与已选点重合的重复接触被自然剔除。
+ULONG WriteContactManifold(
+    const fcl::CollisionResultd& upstream,
+    ULONG maxContacts,
+    _Out_writes_(maxContacts) PFCL_CONTACT_INFO contacts) noexcept {
+    FCL_TRACE_PHASE_SCOPE(FCL_TRACE_PHASE_RESULT_CONVERSION);
+    const std::size_t available = upstream.numContacts();
+    if (!upstream.isCollision() || available == 0 || maxContacts == 0) {
+        return 0;
+    }
+
+    std::size_t deepest = 0;
+    for (std::size_t i = 1; i < available; ++i) {
+        if (upstream.getContact(i).penetration_depth > upstream.getContact(deepest).penetration_depth) {
+            deepest = i;
+        }
+    }
+    ToContactInfo(upstream.getContact(deepest), &contacts[0]);
+
+    ULONG written = 1;
+    while (written < maxContacts) {
+        std::size_t best = available;
+        float bestDistance = kDuplicateContactDistanceSquared;
+        for (std::size_t i = 0; i < available; ++i) {
+            const FCL_VECTOR3 position = ToVector3(upstream.getContact(i).pos);
+            float nearest = SquaredDistance(position, contacts[0].PointOnObject1);
+            for (ULONG j = 1; j < written && nearest > bestDistance; ++j) {
+                const float candidate = SquaredDistance(position, contacts[j].PointOnObject1);
+                nearest = (candidate < nearest) ? candidate : nearest;
+            }
+            if (nearest > bestDistance) {
+                bestDistance = nearest;
+                best = i;
+            }
+        }
+        if (best == available) {
+            break;
+        }
+        ToContactInfo(upstream.getContact(best), &contacts[written]);
+        ++written;
+    }
+    return written;
+}
+
 void WriteDistance(
     const fcl::DistanceResultd& upstream,
     _Out_ PFCL_DISTANCE_RESULT result) noexcept {
     if (result == nullptr) {
         return;
     }
+    FCL_TRACE_PHASE_SCOPE(FCL_TRACE_PHASE_RESULT_CONVERSION);
     result->Distance = static_cast<float>(upstream.min_distance);
     result->ClosestPoint1 = ToVector3(upstream.nearest_points[0]);
     result->ClosestPoint2 = ToVector3(upstream.nearest_points[1]);
@@ -63,17 +132,43 @@ void WriteContinuousContact(
     if (result == nullptr) {
         return;
     }
+    FCL_TRACE_PHASE_SCOPE(FCL_TRACE_PHASE_RESULT_CONVERSION);
 
     result->Intersecting = upstream.is_collide ? TRUE : FALSE;
     result->TimeOfImpact = upstream.time_of_contact;
-    if (upstream.is_collide) {
-        result->Contact.PointOnObject1 = ToVector3(upstream.contact_tf1.translation());
-        result->Contact.PointOnObject2 = ToVector3(upstream.contact_tf2.translation());
-        result->Contact.Normal = {0.0f, 0.0f, 0.0f};
-        result->Contact.PenetrationDepth = 0.0f;
-    } else {
-        RtlZeroMemory(&result->Contact, sizeof(result->Contact));
+    // upstream 只给出 TOI 时刻的位姿（contact_tf1/2），接触点与法线由调用方在该位姿下补算。
+    RtlZeroMemory(&result->Contact, sizeof(result->Contact));
+}
+
+fcl::GJKSolverType ToUpstreamSolverType(FCL_GJK_SOLVER_TYPE solver) noexcept {
+    return (solver == FCL_GJK_SOLVER_INDEP) ? fcl::GJKSolverType::GST_INDEP : fcl::GJKSolverType::GST_LIBCCD;
+}
+
+// 按解析后的选项在栈上构造求解器实例并调用 fn(solver)；容差 / 迭代次数为 0 时保留求解器自身默认值。
+template <typename Fn>
+decltype(auto) InvokeWithSolver(const FCL_SOLVER_OPTIONS& options, Fn&& fn) {
+    FCL_TRACE_PHASE_SCOPE(FCL_TRACE_PHASE_NARROWPHASE);
+    if (options.Solver == FCL_GJK_SOLVER_INDEP) {
+        fcl::detail::GJKSolver_indep<double> solver;
+        if (options.Tolerance > 0.0) {
+            solver.gjk_tolerance = options.Tolerance;
+        }
+        if (options.MaxIterations != 0) {
+            solver.gjk_max_iterations = options.MaxIterations;
+        }
+        return fn(&solver);
+    }
+
+    fcl::detail::GJKSolver_libccd<double> solver;
+    if (options.Tolerance > 0.0) {
+        solver.collision_tolerance = options.Tolerance;
+        solver.distance_tolerance = options.Tolerance;
     }
+    if (options.MaxIterations != 0) {
+        solver.max_collision_iterations = options.MaxIterations;
+        solver.max_distance_iterations = options.MaxIterations;
+    }
+    return fn(&solver);
 }
 
 NTSTATUS HandleException(const std::exception& ex) noexcept {
@@ -81,6 +176,50 @@ NTSTATUS HandleException(const std::exception& ex) noexcept {
     return STATUS_INTERNAL_ERROR;
 }
 
+// fcl::ScrewMotion 由起止位姿分解，单段转角必须小于 π；取 π/2 使每段的运动上界保持紧凑。
+constexpr double kMaxScrewSegmentAngle = 1.5707963267948966;
+constexpr ULONG kMaxScrewSegments = 64;
+
+// fcl::continuousCollide 在内部构造默认参数的 GJK 求解器，请求只能携带求解器类型；
+// 默认选项中的 GJK 容差 / 迭代次数无法传入保守推进。
+fcl::ContinuousCollisionRequestd BuildContinuousRequest(
+    double tolerance,
+    ULONG maxIterations,
+    fcl::CCDMotionType motionType,
+    FCL_GJK_SOLVER_TYPE solver) noexcept {
+    FCL_SOLVER_OPTIONS requestedSolver = {};
+    requestedSolver.Solver = solver;
+    const FCL_SOLVER_OPTIONS solverOptions = fclmusa::narrowphase::ResolveSolverOptions(&requestedSolver);
+    return fcl::ContinuousCollisionRequestd(
+        (maxIterations > 0) ? maxIterations : 64,
+        (tolerance > 0.0) ? tolerance : 1.0e-4,
+        motionType,
+        ToUpstreamSolverType(solverOptions.Solver),
+        fcl::CCDC_CONSERVATIVE_ADVANCEMENT);
+}
+
+// 对已构造的几何绑定执行一次 continuousCollide；位姿为运动参考系，内部叠加几何局部变换。
+void ContinuousCollideBindings(
+    const GeometryBinding& binding1,
+    const FCL_TRANSFORM& start1,
+    const FCL_TRANSFORM& end1,
+    const GeometryBinding& binding2,
+    const FCL_TRANSFORM& start2,
+    const FCL_TRANSFORM& end2,
+    const fcl::ContinuousCollisionRequestd& request,
+    fcl::ContinuousCollisionResultd* upstream) {
+    FCL_TRACE_PHASE_SCOPE(FCL_TRACE_PHASE_NARROWPHASE);
+    fcl::continuousCollide(
+        binding1.Geometry.get(),
+        ToEigenTransform(CombineTransforms(start1, binding1.LocalTransform)),
+        ToEigenTransform(CombineTransforms(end1, binding1.LocalTransform)),
+        binding2.Geometry.get(),
+        ToEigenTransform(CombineTransforms(start2, binding2.LocalTransform)),
+        ToEigenTransform(CombineTransforms(end2, binding2.LocalTransform)),
+        request,
+        *upstream);
+}
+
 }  // namespace
 
 NTSTATUS
@@ -90,11 +229,17 @@ FclUpstreamCollide(
     _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
     _In_ const FCL_TRANSFORM& transform2,
     _Out_ PBOOLEAN isColliding,
-    _Out_opt_ PFCL_CONTACT_INFO contactInfo) noexcept {
+    _Out_opt_ PFCL_CONTACT_INFO contactInfo,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver) noexcept {
     if (isColliding == nullptr) {
         return STATUS_INVALID_PARAMETER;
     }
+    const FCL_SOLVER_OPTIONS solverOptions = fclmusa::narrowphase::ResolveSolverOptions(solver);
 
+    fclmusa::memory::QueryArenaScope arenaScope;
+    fclmusa::narrowphase::CcdObjectPoolScope ccdPoolScope;
+    FCL_ALLOCATION_SITE(FCL_ALLOC_SITE_UPSTREAM_QUERY);
+    FCL_TRACE_PHASE_SCOPE(FCL_TRACE_PHASE_UPSTREAM_QUERY);
     try {
         CollisionObjects objects = {};
         fcl::Transform3d tf1 = fcl::Transform3d::Identity();
@@ -108,13 +253,16 @@ FclUpstreamCollide(
         fcl::CollisionObjectd collisionObject2(objects.Object2.Geometry, tf2);
 
         fcl::CollisionRequestd request;
+        request.gjk_solver_type = ToUpstreamSolverType(solverOptions.Solver);
         if (contactInfo != nullptr) {
             request.enable_contact = true;
             request.num_max_contacts = 1;
         }
 
         fcl::CollisionResultd result;
-        fcl::collide(&collisionObject1, &collisionObject2, request, result);
+        InvokeWithSolver(solverOptions, [&](const auto* narrowphase) {
+            return fcl::collide(&collisionObject1, &collisionObject2, narrowphase, request, result);
+        });
         *isColliding = result.isCollision() ? TRUE : FALSE;
         if (contactInfo != nullptr) {
             WriteContact(result, contactInfo);
@@ -129,17 +277,83 @@ FclUpstreamCollide(
     }
 }
 
+NTSTATUS
+FclUpstreamCollideManifold(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _In_ ULONG maxContacts,
+    _Out_ PBOOLEAN isColliding,
+    _Out_writes_(maxContacts) PFCL_CONTACT_INFO contacts,
+    _Out_ PULONG contactCount,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver) noexcept {
+    if (isColliding == nullptr || contactCount == nullptr || contacts == nullptr || maxContacts == 0) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    const FCL_SOLVER_OPTIONS solverOptions = fclmusa::narrowphase::ResolveSolverOptions(solver);
+    *isColliding = FALSE;
+    *contactCount = 0;
+
+    fclmusa::memory::QueryArenaScope arenaScope;
+    fclmusa::narrowphase::CcdObjectPoolScope ccdPoolScope;
+    FCL_ALLOCATION_SITE(FCL_ALLOC_SITE_UPSTREAM_QUERY);
+    FCL_TRACE_PHASE_SCOPE(FCL_TRACE_PHASE_UPSTREAM_QUERY);
+    try {
+        CollisionObjects objects = {};
+        fcl::Transform3d tf1 = fcl::Transform3d::Identity();
+        fcl::Transform3d tf2 = fcl::Transform3d::Identity();
+        NTSTATUS status = BuildCollisionObjects(object1, transform1, object2, transform2, &objects, tf1, tf2);
+        if (!NT_SUCCESS(status)) {
+            return status;
+        }
+
+        fcl::CollisionObjectd collisionObject1(objects.Object1.Geometry, tf1);
+        fcl::CollisionObjectd collisionObject2(objects.Object2.Geometry, tf2);
+
+        fcl::CollisionRequestd request;
+        request.gjk_solver_type = ToUpstreamSolverType(solverOptions.Solver);
+        request.enable_contact = true;
+        request.num_max_contacts = std::min<std::size_t>(
+            static_cast<std::size_t>(maxContacts) * kRawContactsPerOutput,
+            kMaxRawContacts);
+        if (request.num_max_contacts < maxContacts) {
+            request.num_max_contacts = maxContacts;
+        }
+
+        fcl::CollisionResultd result;
+        InvokeWithSolver(solverOptions, [&](const auto* narrowphase) {
+            return fcl::collide(&collisionObject1, &collisionObject2, narrowphase, request, result);
+        });
+        *isColliding = result.isCollision() ? TRUE : FALSE;
+        *contactCount = WriteContactManifold(result, maxContacts, contacts);
+        return STATUS_SUCCESS;
+    } catch (const std::bad_alloc&) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    } catch (const std::exception& ex) {
+        return HandleException(ex);
+    } catch (...) {
+        return STATUS_INTERNAL_ERROR;
+    }
+}
+
 NTSTATUS
 FclUpstreamDistance(
     _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
     _In_ const FCL_TRANSFORM& transform1,
     _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
     _In_ const FCL_TRANSFORM& transform2,
-    _Out_ PFCL_DISTANCE_RESULT result) noexcept {
+    _Out_ PFCL_DISTANCE_RESULT result,
+    _In_opt_ const FCL_SOLVER_OPTIONS* solver) noexcept {
     if (result == nullptr) {
         return STATUS_INVALID_PARAMETER;
     }
+    const FCL_SOLVER_OPTIONS solverOptions = fclmusa::narrowphase::ResolveSolverOptions(solver);
 
+    fclmusa::memory::QueryArenaScope arenaScope;
+    fclmusa::narrowphase::CcdObjectPoolScope ccdPoolScope;
+    FCL_ALLOCATION_SITE(FCL_ALLOC_SITE_UPSTREAM_QUERY);
+    FCL_TRACE_PHASE_SCOPE(FCL_TRACE_PHASE_UPSTREAM_QUERY);
     try {
         CollisionObjects objects = {};
         fcl::Transform3d tf1 = fcl::Transform3d::Identity();
@@ -155,8 +369,11 @@ FclUpstreamDistance(
         fcl::DistanceRequestd request(true);
         request.enable_nearest_points = true;
         request.enable_signed_distance = false;
+        request.gjk_solver_type = ToUpstreamSolverType(solverOptions.Solver);
         fcl::DistanceResultd distanceResult;
-        fcl::distance(&collisionObject1, &collisionObject2, request, distanceResult);
+        InvokeWithSolver(solverOptions, [&](const auto* narrowphase) {
+            return fcl::distance(&collisionObject1, &collisionObject2, narrowphase, request, distanceResult);
+        });
         WriteDistance(distanceResult, result);
         return STATUS_SUCCESS;
     } catch (const std::bad_alloc&) {
@@ -168,6 +385,76 @@ FclUpstreamDistance(
     }
 }
 
+NTSTATUS
+FclUpstreamDistanceQuery(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_TRANSFORM& transform1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_TRANSFORM& transform2,
+    _In_ const FCL_DISTANCE_REQUEST& request,
+    _Out_ PFCL_DISTANCE_QUERY_RESULT result) noexcept {
+    if (result == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
+    RtlZeroMemory(result, sizeof(*result));
+
+    fclmusa::memory::QueryArenaScope arenaScope;
+    fclmusa::narrowphase::CcdObjectPoolScope ccdPoolScope;
+    FCL_ALLOCATION_SITE(FCL_ALLOC_SITE_UPSTREAM_QUERY);
+    FCL_TRACE_PHASE_SCOPE(FCL_TRACE_PHASE_UPSTREAM_QUERY);
+    try {
+        CollisionObjects objects = {};
+        fcl::Transform3d tf1 = fcl::Transform3d::Identity();
+        fcl::Transform3d tf2 = fcl::Transform3d::Identity();
+        NTSTATUS status = BuildCollisionObjects(object1, transform1, object2, transform2, &objects, tf1, tf2);
+        if (!NT_SUCCESS(status)) {
+            return status;
+        }
+
+        fcl::CollisionObjectd collisionObject1(objects.Object1.Geometry, tf1);
+        fcl::CollisionObjectd collisionObject2(objects.Object2.Geometry, tf2);
+
+        const bool nearestPoints = (request.Flags & FCL_DISTANCE_FLAG_SKIP_NEAREST_POINTS) == 0;
+        const bool hasThreshold = request.DistanceThreshold > 0.0f;
+        const FCL_SOLVER_OPTIONS solverOptions = fclmusa::narrowphase::ResolveSolverOptions(&request.Solver);
+        fcl::DistanceRequestd upstreamRequest(nearestPoints);
+        upstreamRequest.enable_signed_distance = false;
+        upstreamRequest.rel_err = request.RelativeError;
+        upstreamRequest.abs_err = request.AbsoluteError;
+        upstreamRequest.gjk_solver_type = ToUpstreamSolverType(solverOptions.Solver);
+
+        // DistanceResult::update 只接受比当前 min_distance 更小的值：
+        // 预置阈值后，超过阈值的 BV 子树在遍历中被剪枝，叶子结果也不会写入。
+        fcl::DistanceResultd distanceResult;
+        if (hasThreshold) {
+            distanceResult.min_distance = request.DistanceThreshold;
+        }
+        InvokeWithSolver(solverOptions, [&](const auto* narrowphase) {
+            return fcl::distance(&collisionObject1, &collisionObject2, narrowphase, upstreamRequest, distanceResult);
+        });
+
+        if (hasThreshold && distanceResult.min_distance >= request.DistanceThreshold) {
+            result->Result.Distance = static_cast<float>(distanceResult.min_distance);
+            result->BeyondThreshold = TRUE;
+            return STATUS_SUCCESS;
+        }
+
+        WriteDistance(distanceResult, &result->Result);
+        if (!nearestPoints) {
+            result->Result.ClosestPoint1 = {};
+            result->Result.ClosestPoint2 = {};
+        }
+        result->NearestPointsValid = nearestPoints ? TRUE : FALSE;
+        return STATUS_SUCCESS;
+    } catch (const std::bad_alloc&) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    } catch (const std::exception& ex) {
+        return HandleException(ex);
+    } catch (...) {
+        return STATUS_INTERNAL_ERROR;
+    }
+}
+
 NTSTATUS
 FclUpstreamContinuousCollision(
     _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
@@ -176,14 +463,16 @@ FclUpstreamContinuousCollision(
     _In_ const FCL_INTERP_MOTION& motion2,
     double tolerance,
     ULONG maxIterations,
-    _Out_ PFCL_CONTINUOUS_COLLISION_RESULT result) noexcept {
+    _Out_ PFCL_CONTINUOUS_COLLISION_RESULT result,
+    FCL_GJK_SOLVER_TYPE solver) noexcept {
     if (result == nullptr) {
         return STATUS_INVALID_PARAMETER;
     }
 
-    const double resolvedTolerance = (tolerance > 0.0) ? tolerance : 1.0e-4;
-    const std::size_t resolvedIterations = (maxIterations > 0) ? maxIterations : 64;
-
+    fclmusa::memory::QueryArenaScope arenaScope;
+    fclmusa::narrowphase::CcdObjectPoolScope ccdPoolScope;
+    FCL_ALLOCATION_SITE(FCL_ALLOC_SITE_UPSTREAM_QUERY);
+    FCL_TRACE_PHASE_SCOPE(FCL_TRACE_PHASE_UPSTREAM_QUERY);
     try {
         GeometryBinding binding1 = {};
         GeometryBinding binding2 = {};
@@ -196,35 +485,85 @@ FclUpstreamContinuousCollision(
             return status;
         }
 
-        const FCL_TRANSFORM start1 = CombineTransforms(motion1.Start, binding1.LocalTransform);
-        const FCL_TRANSFORM end1 = CombineTransforms(motion1.End, binding1.LocalTransform);
-        const FCL_TRANSFORM start2 = CombineTransforms(motion2.Start, binding2.LocalTransform);
-        const FCL_TRANSFORM end2 = CombineTransforms(motion2.End, binding2.LocalTransform);
+        const fcl::ContinuousCollisionRequestd request =
+            BuildContinuousRequest(tolerance, maxIterations, fcl::CCDM_LINEAR, solver);
+        fcl::ContinuousCollisionResultd upstream;
+        ContinuousCollideBindings(
+            binding1, motion1.Start, motion1.End, binding2, motion2.Start, motion2.End, request, &upstream);
 
-        fcl::Transform3d tfStart1 = ToEigenTransform(start1);
-        fcl::Transform3d tfEnd1 = ToEigenTransform(end1);
-        fcl::Transform3d tfStart2 = ToEigenTransform(start2);
-        fcl::Transform3d tfEnd2 = ToEigenTransform(end2);
+        WriteContinuousContact(upstream, result);
+        return STATUS_SUCCESS;
+    } catch (const std::bad_alloc&) {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    } catch (const std::exception& ex) {
+        return HandleException(ex);
+    } catch (...) {
+        return STATUS_INTERNAL_ERROR;
+    }
+}
+
+NTSTATUS
+FclUpstreamScrewContinuousCollision(
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object1,
+    _In_ const FCL_SCREW_MOTION& motion1,
+    _In_ const FCL_GEOMETRY_SNAPSHOT& object2,
+    _In_ const FCL_SCREW_MOTION& motion2,
+    double tolerance,
+    ULONG maxIterations,
+    _Out_ PFCL_CONTINUOUS_COLLISION_RESULT result,
+    FCL_GJK_SOLVER_TYPE solver) noexcept {
+    if (result == nullptr) {
+        return STATUS_INVALID_PARAMETER;
+    }
 
-        fcl::ContinuousCollisionRequestd request(
-            resolvedIterations,
-            resolvedTolerance,
-            fcl::CCDM_LINEAR,
-            fcl::GJKSolverType::GST_LIBCCD,
-            fcl::CCDC_CONSERVATIVE_ADVANCEMENT);
+    // 转角超过单段上限（如转台整圈）时按等角分段，逐段推进并在首段命中处返回。
+    const double sweep = (std::max)(fabs(motion1.AngularVelocity), fabs(motion2.AngularVelocity));
+    const double required = std::ceil(sweep / kMaxScrewSegmentAngle);
+    if (required > kMaxScrewSegments) {
+        return STATUS_NOT_SUPPORTED;
+    }
+    const ULONG segments = (required > 1.0) ? static_cast<ULONG>(required) : 1;
 
-        fcl::ContinuousCollisionResultd upstream;
-        fcl::continuousCollide(
-            binding1.Geometry.get(),
-            tfStart1,
-            tfEnd1,
-            binding2.Geometry.get(),
-            tfStart2,
-            tfEnd2,
-            request,
-            upstream);
+    fclmusa::memory::QueryArenaScope arenaScope;
+    fclmusa::narrowphase::CcdObjectPoolScope ccdPoolScope;
+    FCL_ALLOCATION_SITE(FCL_ALLOC_SITE_UPSTREAM_QUERY);
+    FCL_TRACE_PHASE_SCOPE(FCL_TRACE_PHASE_UPSTREAM_QUERY);
+    try {
+        GeometryBinding binding1 = {};
+        GeometryBinding binding2 = {};
+        NTSTATUS status = BuildGeometryBinding(object1, &binding1);
+        if (!NT_SUCCESS(status)) {
+            return status;
+        }
+        status = BuildGeometryBinding(object2, &binding2);
+        if (!NT_SUCCESS(status)) {
+            return status;
+        }
 
-        WriteContinuousContact(upstream, result);
+        const fcl::ContinuousCollisionRequestd request =
+            BuildContinuousRequest(tolerance, maxIterations, fcl::CCDM_SCREW, solver);
+
+        FCL_TRANSFORM start1 = {};
+        FCL_TRANSFORM start2 = {};
+        FclScrewMotionEvaluate(&motion1, 0.0, &start1);
+        FclScrewMotionEvaluate(&motion2, 0.0, &start2);
+        for (ULONG segment = 0; segment < segments; ++segment) {
+            const double segmentEnd = static_cast<double>(segment + 1) / segments;
+            FCL_TRANSFORM end1 = {};
+            FCL_TRANSFORM end2 = {};
+            FclScrewMotionEvaluate(&motion1, segmentEnd, &end1);
+            FclScrewMotionEvaluate(&motion2, segmentEnd, &end2);
+
+            fcl::ContinuousCollisionResultd upstream;
+            ContinuousCollideBindings(binding1, start1, end1, binding2, start2, end2, request, &upstream);
+            if (upstream.is_collide || segment + 1 == segments) {
+                WriteContinuousContact(upstream, result);
+                result->TimeOfImpact = (segment + upstream.time_of_contact) / segments;
+                return STATUS_SUCCESS;
+            }
+            start1 = end1;
+            start2 = end2;
+        }
         return STATUS_SUCCESS;
     } catch (const std::bad_alloc&) {
         return STATUS_INSUFFICIENT_RESOURCES;
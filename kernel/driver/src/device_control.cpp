@@ -4,6 +4,7 @@
 #include "fclmusa/distance.h"
 #include "fclmusa/driver.h"
 #include "fclmusa/geometry/math_utils.h"
+#include "fclmusa/geometry/precompiled_mesh.h"
 #include "fclmusa/ioctl.h"
 #include "fclmusa/logging.h"
 #include "fclmusa/self_test.h"
@@ -206,6 +207,8 @@ FclPeriodicCollisionDpc(
     const FCL_GEOMETRY_SNAPSHOT object2 = state->Object2Snapshot;
     const FCL_TRANSFORM transform1 = state->Config.Transform1;
     const FCL_TRANSFORM transform2 = state->Config.Transform2;
+    const FCL_GEOMETRY_HANDLE handle1 = {state->Object1Ref.HandleValue};
+    const FCL_GEOMETRY_HANDLE handle2 = {state->Object2Ref.HandleValue};
 
     FCL_CONTACT_INFO* scratchContact = &state->Scratch.Contact;
     FCL_COLLISION_RESULT* scratchResult = &state->Scratch.Result;
@@ -214,9 +217,11 @@ FclPeriodicCollisionDpc(
         BOOLEAN isColliding = FALSE;
         RtlZeroMemory(scratchContact, sizeof(*scratchContact));
         RtlZeroMemory(scratchResult, sizeof(*scratchResult));
-        NTSTATUS status = FclCollisionCoreFromSnapshots(
+        NTSTATUS status = FclCollisionCoreFromSnapshotsCoherent(
+            handle1,
             &object1,
             &transform1,
+            handle2,
             &object2,
             &transform2,
             &isColliding,
@@ -470,6 +475,97 @@ NTSTATUS HandleDiagnosticsQuery(_Inout_ PIRP irp, _In_ PIO_STACK_LOCATION stack)
     return status;
 }
 
+NTSTATUS HandleAllocationProfileQuery(_Inout_ PIRP irp, _In_ PIO_STACK_LOCATION stack) {
+    if (stack->Parameters.DeviceIoControl.OutputBufferLength < sizeof(FCL_ALLOC_PROFILE)) {
+        return STATUS_BUFFER_TOO_SMALL;
+    }
+
+    auto* profile = reinterpret_cast<FCL_ALLOC_PROFILE*>(irp->AssociatedIrp.SystemBuffer);
+    NTSTATUS status = FclQueryAllocationProfile(profile);
+    if (NT_SUCCESS(status)) {
+        irp->IoStatus.Information = sizeof(*profile);
+    }
+
+    return status;
+}
+
+NTSTATUS HandleLatencyHistogramQuery(_Inout_ PIRP irp, _In_ PIO_STACK_LOCATION stack) {
+    if (stack->Parameters.DeviceIoControl.InputBufferLength < sizeof(FCL_LATENCY_HISTOGRAM_QUERY) ||
+        stack->Parameters.DeviceIoControl.OutputBufferLength < sizeof(FCL_LATENCY_HISTOGRAM)) {
+        return STATUS_BUFFER_TOO_SMALL;
+    }
+
+    // 输入与输出共用 SystemBuffer，FclQueryLatencyHistogram 会先复制查询参数再写结果。
+    auto* query = reinterpret_cast<FCL_LATENCY_HISTOGRAM_QUERY*>(irp->AssociatedIrp.SystemBuffer);
+    auto* histogram = reinterpret_cast<FCL_LATENCY_HISTOGRAM*>(irp->AssociatedIrp.SystemBuffer);
+    NTSTATUS status = FclQueryLatencyHistogram(query, histogram);
+    if (NT_SUCCESS(status)) {
+        irp->IoStatus.Information = sizeof(*histogram);
+    }
+
+    return status;
+}
+
+NTSTATUS HandlePhaseTraceQuery(_Inout_ PIRP irp, _In_ PIO_STACK_LOCATION stack) {
+    if (stack->Parameters.DeviceIoControl.InputBufferLength < sizeof(FCL_PHASE_TRACE_QUERY) ||
+        stack->Parameters.DeviceIoControl.OutputBufferLength < sizeof(FCL_PHASE_TRACE_SNAPSHOT)) {
+        return STATUS_BUFFER_TOO_SMALL;
+    }
+
+    // 输入与输出共用 SystemBuffer，FclQueryPhaseTrace 会先复制查询参数再写结果。
+    auto* query = reinterpret_cast<FCL_PHASE_TRACE_QUERY*>(irp->AssociatedIrp.SystemBuffer);
+    auto* snapshot = reinterpret_cast<FCL_PHASE_TRACE_SNAPSHOT*>(irp->AssociatedIrp.SystemBuffer);
+    NTSTATUS status = FclQueryPhaseTrace(query, snapshot);
+    if (NT_SUCCESS(status)) {
+        irp->IoStatus.Information = sizeof(*snapshot);
+    }
+
+    return status;
+}
+
+NTSTATUS HandleWorkloadRecording(_Inout_ PIRP irp, _In_ PIO_STACK_LOCATION stack) {
+    if (stack->Parameters.DeviceIoControl.InputBufferLength < sizeof(FCL_WORKLOAD_RECORDING_REQUEST) ||
+        stack->Parameters.DeviceIoControl.OutputBufferLength < sizeof(FCL_WORKLOAD_RECORDING_RESPONSE)) {
+        return STATUS_BUFFER_TOO_SMALL;
+    }
+
+    // 输入与输出共用 SystemBuffer，先复制请求再写响应与轨迹数据。
+    const FCL_WORKLOAD_RECORDING_REQUEST request =
+        *reinterpret_cast<const FCL_WORKLOAD_RECORDING_REQUEST*>(irp->AssociatedIrp.SystemBuffer);
+    auto* response = reinterpret_cast<FCL_WORKLOAD_RECORDING_RESPONSE*>(irp->AssociatedIrp.SystemBuffer);
+    RtlZeroMemory(response, sizeof(*response));
+
+    NTSTATUS status = STATUS_SUCCESS;
+    switch (request.Operation) {
+        case FCL_WORKLOAD_RECORDING_OP_QUERY:
+            break;
+        case FCL_WORKLOAD_RECORDING_OP_START:
+            status = FclStartWorkloadRecording(&request.Config);
+            break;
+        case FCL_WORKLOAD_RECORDING_OP_STOP:
+            status = FclStopWorkloadRecording();
+            break;
+        case FCL_WORKLOAD_RECORDING_OP_READ: {
+            const ULONG capacity =
+                stack->Parameters.DeviceIoControl.OutputBufferLength - static_cast<ULONG>(sizeof(*response));
+            status = FclReadWorkloadRecording(request.Offset, response + 1, capacity, &response->DataBytes);
+            break;
+        }
+        case FCL_WORKLOAD_RECORDING_OP_DISCARD:
+            FclDiscardWorkloadRecording();
+            break;
+        default:
+            return STATUS_INVALID_PARAMETER;
+    }
+    if (!NT_SUCCESS(status)) {
+        return status;
+    }
+
+    FclQueryWorkloadRecording(&response->Status);
+    irp->IoStatus.Information = sizeof(*response) + response->DataBytes;
+    return STATUS_SUCCESS;
+}
+
 NTSTATUS HandleCollisionQuery(_Inout_ PIRP irp, _In_ PIO_STACK_LOCATION stack) {
     if (stack->Parameters.DeviceIoControl.InputBufferLength < sizeof(FCL_COLLISION_IO_BUFFER) ||
         stack->Parameters.DeviceIoControl.OutputBufferLength < sizeof(FCL_COLLISION_IO_BUFFER)) {
@@ -620,6 +716,24 @@ NTSTATUS HandleCreateMesh(_Inout_ PIRP irp, _In_ PIO_STACK_LOCATION stack) {
     return status;
 }
 
+// 输入与输出共用系统缓冲区：创建时映像已被复制，之后再写入句柄。
+NTSTATUS HandleCreatePrecompiledMesh(_Inout_ PIRP irp, _In_ PIO_STACK_LOCATION stack) {
+    const ULONG inputLength = stack->Parameters.DeviceIoControl.InputBufferLength;
+    if (inputLength < sizeof(FCL_PRECOMPILED_MESH_HEADER) ||
+        stack->Parameters.DeviceIoControl.OutputBufferLength < sizeof(FCL_CREATE_PRECOMPILED_MESH_OUTPUT)) {
+        return STATUS_BUFFER_TOO_SMALL;
+    }
+
+    FCL_GEOMETRY_HANDLE handle = {};
+    NTSTATUS status = FclCreateMeshGeometryFromImage(irp->AssociatedIrp.SystemBuffer, inputLength, &handle);
+    if (NT_SUCCESS(status)) {
+        auto* output = reinterpret_cast<FCL_CREATE_PRECOMPILED_MESH_OUTPUT*>(irp->AssociatedIrp.SystemBuffer);
+        output->Handle = handle;
+        irp->IoStatus.Information = sizeof(FCL_CREATE_PRECOMPILED_MESH_OUTPUT);
+    }
+    return status;
+}
+
 NTSTATUS HandleConvexCcdDemo(_Inout_ PIRP irp, _In_ PIO_STACK_LOCATION stack) {
     if (stack->Parameters.DeviceIoControl.InputBufferLength < sizeof(FCL_CONVEX_CCD_BUFFER) ||
         stack->Parameters.DeviceIoControl.OutputBufferLength < sizeof(FCL_CONVEX_CCD_BUFFER)) {
@@ -670,6 +784,18 @@ FclDispatchDeviceControl(_In_ PDEVICE_OBJECT deviceObject, _Inout_ PIRP irp) {
         case IOCTL_FCL_QUERY_DIAGNOSTICS:
             status = HandleDiagnosticsQuery(irp, stack);
             break;
+        case IOCTL_FCL_QUERY_ALLOCATION_PROFILE:
+            status = HandleAllocationProfileQuery(irp, stack);
+            break;
+        case IOCTL_FCL_QUERY_LATENCY_HISTOGRAM:
+            status = HandleLatencyHistogramQuery(irp, stack);
+            break;
+        case IOCTL_FCL_QUERY_PHASE_TRACE:
+            status = HandlePhaseTraceQuery(irp, stack);
+            break;
+        case IOCTL_FCL_WORKLOAD_RECORDING:
+            status = HandleWorkloadRecording(irp, stack);
+            break;
         case IOCTL_FCL_QUERY_COLLISION:
             status = HandleCollisionQuery(irp, stack);
             break;
@@ -688,6 +814,9 @@ FclDispatchDeviceControl(_In_ PDEVICE_OBJECT deviceObject, _Inout_ PIRP irp) {
         case IOCTL_FCL_CONVEX_CCD:
             status = HandleConvexCcdDemo(irp, stack);
             break;
+        case IOCTL_FCL_CREATE_PRECOMPILED_MESH:
+            status = HandleCreatePrecompiledMesh(irp, stack);
+            break;
         case IOCTL_FCL_START_PERIODIC_COLLISION:
             status = HandleStartPeriodicCollisionDpc(irp, stack);
             break;
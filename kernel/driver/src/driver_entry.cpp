@@ -2,6 +2,7 @@
 
 #include "fclmusa/driver.h"
 #include "fclmusa/logging.h"
+#include "fclmusa/memory/dpc_reserve.h"
 #include "fclmusa/version.h"
 
 EXTERN_C NTSTATUS FclDispatchDeviceControl(_In_ PDEVICE_OBJECT deviceObject, _Inout_ PIRP irp);
@@ -64,12 +65,52 @@ VOID FclDriverUnload(_In_ PDRIVER_OBJECT /*driverObject*/) {
     FCL_LOG_INFO0("Driver unloaded");
 }
 
+// 可选的 DWORD 配置：<服务键>\Parameters 下的 DpcReserveSmallBlocks / DpcReserveMediumBlocks / DpcReserveLargeBlocks，
+// 缺省项保留默认值；子键不存在或读取失败时整体使用默认配置。
+VOID FclReadDpcReserveConfig(_In_ PUNICODE_STRING registryPath) {
+    FCL_DPC_RESERVE_CONFIG config = fclmusa::memory::kDefaultDpcReserveConfig;
+    if (registryPath == nullptr || registryPath->Buffer == nullptr) {
+        return;
+    }
+
+    constexpr ULONG kDwordTypeCheck = (REG_DWORD << RTL_QUERY_REGISTRY_TYPECHECK_SHIFT) | REG_NONE;
+    RTL_QUERY_REGISTRY_TABLE table[5] = {};
+    table[0].Flags = RTL_QUERY_REGISTRY_SUBKEY;
+    table[0].Name = const_cast<PWSTR>(L"Parameters");
+    table[1].Flags = RTL_QUERY_REGISTRY_DIRECT | RTL_QUERY_REGISTRY_TYPECHECK;
+    table[1].Name = const_cast<PWSTR>(L"DpcReserveSmallBlocks");
+    table[1].EntryContext = &config.SmallBlockCount;
+    table[1].DefaultType = kDwordTypeCheck;
+    table[2].Flags = RTL_QUERY_REGISTRY_DIRECT | RTL_QUERY_REGISTRY_TYPECHECK;
+    table[2].Name = const_cast<PWSTR>(L"DpcReserveMediumBlocks");
+    table[2].EntryContext = &config.MediumBlockCount;
+    table[2].DefaultType = kDwordTypeCheck;
+    table[3].Flags = RTL_QUERY_REGISTRY_DIRECT | RTL_QUERY_REGISTRY_TYPECHECK;
+    table[3].Name = const_cast<PWSTR>(L"DpcReserveLargeBlocks");
+    table[3].EntryContext = &config.LargeBlockCount;
+    table[3].DefaultType = kDwordTypeCheck;
+
+    const NTSTATUS status = RtlQueryRegistryValues(RTL_REGISTRY_ABSOLUTE, registryPath->Buffer, table, nullptr, nullptr);
+    if (!NT_SUCCESS(status)) {
+        if (status != STATUS_OBJECT_NAME_NOT_FOUND) {
+            FCL_LOG_WARN("DPC reserve configuration ignored: 0x%X", status);
+        }
+        return;
+    }
+
+    FCL_LOG_INFO(
+        "DPC reserve configuration: %lu small, %lu medium, %lu large blocks",
+        config.SmallBlockCount,
+        config.MediumBlockCount,
+        config.LargeBlockCount);
+    fclmusa::memory::SetDpcReserveConfig(config);
+}
+
 }  // namespace
 
 extern "C"
 NTSTATUS
 DriverMain(_In_ PDRIVER_OBJECT driverObject, _In_ PUNICODE_STRING registryPath) {
-    UNREFERENCED_PARAMETER(registryPath);
 
     const auto* version = FclGetDriverVersion();
     FCL_LOG_INFO(
@@ -84,6 +125,7 @@ DriverMain(_In_ PDRIVER_OBJECT driverObject, _In_ PUNICODE_STRING registryPath)
         return status;
     }
 
+    FclReadDpcReserveConfig(registryPath);
     status = FclInitialize();
     if (!NT_SUCCESS(status)) {
         FCL_LOG_ERROR("FclInitialize failed: 0x%X", status);
@@ -5,6 +5,7 @@
 #include <cstring>
 
 #include "fclmusa/logging.h"
+#include "fclmusa/memory/dpc_reserve.h"
 #include "fclmusa/memory/pool_allocator.h"
 #include "fclmusa/memory/pool_test.h"
 #include "fclmusa/test/assertions.h"
@@ -133,20 +134,30 @@ NTSTATUS RunZeroSizeReallocateTest() noexcept {
     return STATUS_SUCCESS;
 }
 
-NTSTATUS RunHighIrqlGuardTest() noexcept {
+// DISPATCH_LEVEL 的分配只从 DPC 预留池取块：计入池统计，释放后预留池占用归零。
+NTSTATUS RunDispatchReserveTest() noexcept {
     const auto before = fclmusa::memory::QueryStats();
+    const auto reserveBefore = fclmusa::memory::QueryDpcReserveStats();
+    FCL_TEST_EXPECT_TRUE(reserveBefore.Classes[0].BlockCount > 0, STATUS_DATA_ERROR);
 
     KIRQL oldIrql = PASSIVE_LEVEL;
     KeRaiseIrql(DISPATCH_LEVEL, &oldIrql);
     void* buffer = fclmusa::memory::Allocate(16, kTestPoolTag);
+    const auto reserveDuring = fclmusa::memory::QueryDpcReserveStats();
+    fclmusa::memory::Free(buffer, kTestPoolTag);
     KeLowerIrql(oldIrql);
 
-    FCL_TEST_EXPECT_NULL(buffer, STATUS_DATA_ERROR);
+    FCL_TEST_EXPECT_NOT_NULL(buffer, STATUS_DATA_ERROR);
+    FCL_TEST_EXPECT_TRUE(reserveDuring.Classes[0].BlocksInUse == reserveBefore.Classes[0].BlocksInUse + 1, STATUS_DATA_ERROR);
+    FCL_TEST_EXPECT_TRUE(reserveDuring.Allocations == reserveBefore.Allocations + 1, STATUS_DATA_ERROR);
 
     const auto after = fclmusa::memory::QueryStats();
-    FCL_TEST_EXPECT_TRUE(after.AllocationCount == before.AllocationCount, STATUS_DATA_ERROR);
-    FCL_TEST_EXPECT_TRUE(after.BytesAllocated == before.BytesAllocated, STATUS_DATA_ERROR);
+    const auto reserveAfter = fclmusa::memory::QueryDpcReserveStats();
+    FCL_TEST_EXPECT_TRUE(after.AllocationCount == before.AllocationCount + 1, STATUS_DATA_ERROR);
+    FCL_TEST_EXPECT_TRUE(after.BytesAllocated == before.BytesAllocated + 16, STATUS_DATA_ERROR);
     FCL_TEST_EXPECT_TRUE(after.BytesInUse == before.BytesInUse, STATUS_DATA_ERROR);
+    FCL_TEST_EXPECT_TRUE(reserveAfter.Classes[0].BlocksInUse == reserveBefore.Classes[0].BlocksInUse, STATUS_DATA_ERROR);
+    FCL_TEST_EXPECT_TRUE(reserveAfter.Exhaustions == reserveBefore.Exhaustions, STATUS_DATA_ERROR);
 
     return STATUS_SUCCESS;
 }
@@ -163,7 +174,7 @@ FclRunMemoryPoolTests() noexcept {
     FCL_TEST_EXPECT_NT_SUCCESS(RunAllocationAccountingTest());
     FCL_TEST_EXPECT_NT_SUCCESS(RunReallocatePreservesContentTest());
     FCL_TEST_EXPECT_NT_SUCCESS(RunZeroSizeReallocateTest());
-    FCL_TEST_EXPECT_NT_SUCCESS(RunHighIrqlGuardTest());
+    FCL_TEST_EXPECT_NT_SUCCESS(RunDispatchReserveTest());
 
     const auto finalStats = fclmusa::memory::QueryStats();
     FCL_TEST_EXPECT_TRUE(finalStats.BytesInUse == baseline.BytesInUse, STATUS_DATA_ERROR);
@@ -14,6 +14,7 @@
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <thread>
@@ -24,12 +25,15 @@
 #define IOCTL_FCL_SELF_TEST             CTL_CODE(FILE_DEVICE_UNKNOWN, 0x801, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
 #define IOCTL_FCL_SELF_TEST_SCENARIO    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x802, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
 #define IOCTL_FCL_QUERY_DIAGNOSTICS     CTL_CODE(FILE_DEVICE_UNKNOWN, 0x803, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
+#define IOCTL_FCL_QUERY_PHASE_TRACE     CTL_CODE(FILE_DEVICE_UNKNOWN, 0x806, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
+#define IOCTL_FCL_WORKLOAD_RECORDING    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x807, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
 #define IOCTL_FCL_QUERY_COLLISION       CTL_CODE(FILE_DEVICE_UNKNOWN, 0x810, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
 #define IOCTL_FCL_QUERY_DISTANCE        CTL_CODE(FILE_DEVICE_UNKNOWN, 0x811, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
 #define IOCTL_FCL_CREATE_SPHERE         CTL_CODE(FILE_DEVICE_UNKNOWN, 0x812, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
 #define IOCTL_FCL_DESTROY_GEOMETRY      CTL_CODE(FILE_DEVICE_UNKNOWN, 0x813, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
 #define IOCTL_FCL_CREATE_MESH           CTL_CODE(FILE_DEVICE_UNKNOWN, 0x814, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
 #define IOCTL_FCL_CONVEX_CCD            CTL_CODE(FILE_DEVICE_UNKNOWN, 0x815, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
+#define IOCTL_FCL_CREATE_PRECOMPILED_MESH CTL_CODE(FILE_DEVICE_UNKNOWN, 0x816, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
 #define IOCTL_FCL_START_PERIODIC_COLLISION CTL_CODE(FILE_DEVICE_UNKNOWN, 0x820, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
 #define IOCTL_FCL_STOP_PERIODIC_COLLISION  CTL_CODE(FILE_DEVICE_UNKNOWN, 0x821, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
 #define IOCTL_FCL_DEMO_SPHERE_COLLISION  CTL_CODE(FILE_DEVICE_UNKNOWN, 0x900, METHOD_BUFFERED, FILE_READ_DATA | FILE_WRITE_DATA)
@@ -96,6 +100,79 @@ struct FCL_DIAGNOSTICS_RESPONSE {
     FCL_DETECTION_TIMING_STATS DpcCollision;
 };
 
+constexpr uint32_t FCL_TRACE_PHASE_COUNT = 5;
+constexpr uint32_t FCL_PHASE_TRACE_RING_CAPACITY = 4096;
+constexpr uint32_t FCL_PHASE_TRACE_FLAG_RESET = 0x1;
+constexpr uint32_t FCL_PHASE_TRACE_FLAG_ENABLE_RING = 0x2;
+constexpr uint32_t FCL_PHASE_TRACE_FLAG_DISABLE_RING = 0x4;
+
+struct FCL_PHASE_STATS {
+    uint64_t Count;
+    uint64_t TotalCycles;
+    uint64_t MinCycles;
+    uint64_t MaxCycles;
+};
+
+struct FCL_PHASE_TRACE_EVENT {
+    uint64_t StartCycles;
+    uint64_t DurationCycles;
+    uint32_t Phase;
+    uint32_t Processor;
+    uint64_t Sequence;
+};
+static_assert(sizeof(FCL_PHASE_TRACE_EVENT) == 32, "Unexpected FCL_PHASE_TRACE_EVENT size");
+
+struct FCL_PHASE_TRACE_QUERY {
+    uint32_t Flags;
+    uint32_t Reserved;
+};
+
+struct FCL_PHASE_TRACE_SNAPSHOT {
+    uint8_t Enabled;
+    uint8_t RingEnabled;
+    uint8_t Reserved[2];
+    uint32_t EventCount;
+    uint64_t TotalEvents;
+    uint64_t CyclesPerSecond;
+    FCL_PHASE_STATS Phases[FCL_TRACE_PHASE_COUNT];
+    FCL_PHASE_TRACE_EVENT Events[FCL_PHASE_TRACE_RING_CAPACITY];
+};
+
+constexpr uint32_t FCL_WORKLOAD_RECORDING_OP_QUERY = 0;
+constexpr uint32_t FCL_WORKLOAD_RECORDING_OP_START = 1;
+constexpr uint32_t FCL_WORKLOAD_RECORDING_OP_STOP = 2;
+constexpr uint32_t FCL_WORKLOAD_RECORDING_OP_READ = 3;
+constexpr uint32_t FCL_WORKLOAD_RECORDING_OP_DISCARD = 4;
+
+struct FCL_WORKLOAD_RECORDING_CONFIG {
+    uint32_t CapacityBytes;
+    uint32_t Flags;
+};
+
+struct FCL_WORKLOAD_RECORDING_STATUS {
+    uint8_t Recording;
+    uint8_t HasTrace;
+    uint8_t Reserved[2];
+    uint32_t CapacityBytes;
+    uint64_t TraceBytes;
+    uint64_t RecordCount;
+    uint64_t DroppedRecords;
+};
+
+struct FCL_WORKLOAD_RECORDING_REQUEST {
+    uint32_t Operation;
+    uint32_t Reserved;
+    FCL_WORKLOAD_RECORDING_CONFIG Config;
+    uint64_t Offset;
+};
+
+struct FCL_WORKLOAD_RECORDING_RESPONSE {
+    FCL_WORKLOAD_RECORDING_STATUS Status;
+    uint32_t DataBytes;
+    uint32_t Reserved;
+};
+static_assert(sizeof(FCL_WORKLOAD_RECORDING_RESPONSE) == 40, "Unexpected FCL_WORKLOAD_RECORDING_RESPONSE size");
+
 struct FCL_SPHERE_GEOMETRY_DESC {
     FCL_VECTOR3 Center;
     float Radius;
@@ -190,6 +267,27 @@ struct FCL_CREATE_MESH_BUFFER {
     FCL_GEOMETRY_HANDLE Handle;
 };
 
+constexpr uint32_t FCL_PRECOMPILED_MESH_MAGIC = 0x4D504346u;  // "FCPM"
+
+// 预编译 Mesh 映像文件头（由 FclMusaMeshCompiler 生成），只用于显示与基本检查，完整校验在驱动内进行。
+struct FCL_PRECOMPILED_MESH_HEADER {
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t HeaderSize;
+    uint32_t NodeSize;
+    uint32_t VertexCount;
+    uint32_t IndexCount;
+    uint32_t NodeCount;
+    uint32_t Reserved;
+    uint64_t VerticesOffset;
+    uint64_t IndicesOffset;
+    uint64_t NodesOffset;
+    uint64_t TriangleOrderOffset;
+    uint64_t ImageBytes;
+    uint64_t Checksum;
+};
+static_assert(sizeof(FCL_PRECOMPILED_MESH_HEADER) == 80, "Unexpected FCL_PRECOMPILED_MESH_HEADER size");
+
 struct FCL_PERIODIC_COLLISION_CONFIG {
     FCL_GEOMETRY_HANDLE Object1;
     FCL_TRANSFORM       Transform1;
@@ -579,6 +677,43 @@ bool CreateMesh(HANDLE device,
     return handle.Value != 0;
 }
 
+bool CreatePrecompiledMesh(HANDLE device,
+                           const std::filesystem::path& path,
+                           FCL_GEOMETRY_HANDLE& handle,
+                           FCL_PRECOMPILED_MESH_HEADER& header) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        printf("Failed to open mesh image: %s\n", path.string().c_str());
+        return false;
+    }
+    std::vector<uint8_t> image((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    if (image.size() < sizeof(header)) {
+        printf("Mesh image is truncated.\n");
+        return false;
+    }
+    memcpy(&header, image.data(), sizeof(header));
+    if (header.Magic != FCL_PRECOMPILED_MESH_MAGIC) {
+        printf("Not a precompiled mesh image (convert with FclMusaMeshCompiler).\n");
+        return false;
+    }
+    if (image.size() > std::numeric_limits<DWORD>::max()) {
+        printf("Mesh image exceeds DeviceIoControl limit.\n");
+        return false;
+    }
+
+    FCL_CREATE_SPHERE_OUTPUT output = {};
+    if (!SendIoctl(device,
+                   IOCTL_FCL_CREATE_PRECOMPILED_MESH,
+                   image.data(),
+                   static_cast<DWORD>(image.size()),
+                   &output,
+                   sizeof(output))) {
+        return false;
+    }
+    handle = output.Handle;
+    return handle.Value != 0;
+}
+
 bool DestroyGeometry(HANDLE device, FCL_GEOMETRY_HANDLE handle) {
     if (handle.Value == 0) {
         return true;
@@ -792,6 +927,193 @@ bool PrintDiagDpc(HANDLE device) {
     return true;
 }
 
+const char* const kPhaseNames[FCL_TRACE_PHASE_COUNT] = {
+    "handle acquire", "binding build", "narrowphase", "result conversion", "upstream query"};
+
+bool QueryPhaseTrace(HANDLE device, uint32_t flags, FCL_PHASE_TRACE_SNAPSHOT* snapshot) {
+    FCL_PHASE_TRACE_QUERY query = {};
+    query.Flags = flags;
+    if (!SendIoctl(device, IOCTL_FCL_QUERY_PHASE_TRACE, &query, sizeof(query), snapshot, sizeof(*snapshot))) {
+        printf("  [FAIL] Phase trace IOCTL failed (driver built without FCLMUSA_ENABLE_PHASE_TRACING?).\n");
+        return false;
+    }
+    return true;
+}
+
+void PrintPhaseTrace(const FCL_PHASE_TRACE_SNAPSHOT& snapshot) {
+    const double cyclesPerMicrosecond = static_cast<double>(snapshot.CyclesPerSecond) / 1.0e6;
+    printf("Query phase trace (ring %s, %u/%llu events buffered):\n",
+           snapshot.RingEnabled ? "on" : "off",
+           snapshot.EventCount,
+           static_cast<unsigned long long>(snapshot.TotalEvents));
+    for (uint32_t phase = 0; phase < FCL_TRACE_PHASE_COUNT; ++phase) {
+        const FCL_PHASE_STATS& stats = snapshot.Phases[phase];
+        const double avgCycles =
+            (stats.Count != 0) ? static_cast<double>(stats.TotalCycles) / static_cast<double>(stats.Count) : 0.0;
+        printf("  %-18s count=%llu avg=%.0f cycles (%.3f us) min=%llu max=%llu\n",
+               kPhaseNames[phase],
+               static_cast<unsigned long long>(stats.Count),
+               avgCycles,
+               (cyclesPerMicrosecond > 0.0) ? avgCycles / cyclesPerMicrosecond : 0.0,
+               static_cast<unsigned long long>(stats.MinCycles),
+               static_cast<unsigned long long>(stats.MaxCycles));
+    }
+}
+
+// Chrome trace JSON（chrome://tracing / Perfetto）：每个事件为一个完整区间（ph = X），线程轨道为处理器编号，
+// 时间以微秒计并以首个事件为零点；周期频率未知时直接以周期数作为时间单位。
+bool WriteChromeTrace(const FCL_PHASE_TRACE_SNAPSHOT& snapshot, const std::string& path) {
+    std::ofstream file(path);
+    if (!file) {
+        printf("Failed to open trace output: %s\n", path.c_str());
+        return false;
+    }
+    const double cyclesPerMicrosecond =
+        (snapshot.CyclesPerSecond != 0) ? static_cast<double>(snapshot.CyclesPerSecond) / 1.0e6 : 1.0;
+    const uint64_t origin = (snapshot.EventCount != 0) ? snapshot.Events[0].StartCycles : 0;
+    file.setf(std::ios::fixed);
+    file.precision(3);
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+         << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"FclMusa\"}}";
+    for (uint32_t i = 0; i < snapshot.EventCount; ++i) {
+        const FCL_PHASE_TRACE_EVENT& event = snapshot.Events[i];
+        // 不同 CPU 的周期计数器可能有微小偏差，早于零点的事件保留负时间戳。
+        const double start = static_cast<double>(static_cast<int64_t>(event.StartCycles - origin));
+        file << ",\n{\"name\":\"" << ((event.Phase < FCL_TRACE_PHASE_COUNT) ? kPhaseNames[event.Phase] : "unknown")
+             << "\",\"cat\":\"fclmusa\",\"ph\":\"X\",\"ts\":" << start / cyclesPerMicrosecond
+             << ",\"dur\":" << static_cast<double>(event.DurationCycles) / cyclesPerMicrosecond
+             << ",\"pid\":1,\"tid\":" << event.Processor << ",\"args\":{\"seq\":" << event.Sequence
+             << ",\"cycles\":" << event.DurationCycles << "}}";
+    }
+    file << "\n]}\n";
+    if (!file) {
+        printf("Failed to write trace output: %s\n", path.c_str());
+        return false;
+    }
+    printf("Wrote %u trace events to %s%s\n",
+           snapshot.EventCount,
+           path.c_str(),
+           (snapshot.CyclesPerSecond == 0) ? " (cycle rate unknown, timestamps are raw cycles)" : "");
+    return true;
+}
+
+bool RunTraceCommand(HANDLE device, const std::vector<std::string>& tokens) {
+    auto snapshot = std::make_unique<FCL_PHASE_TRACE_SNAPSHOT>();
+    const std::string action = (tokens.size() >= 2) ? tokens[1] : "show";
+    if (action == "show") {
+        if (QueryPhaseTrace(device, 0, snapshot.get())) {
+            PrintPhaseTrace(*snapshot);
+        }
+    } else if (action == "on" || action == "off") {
+        const uint32_t flags = (action == "on") ? FCL_PHASE_TRACE_FLAG_ENABLE_RING : FCL_PHASE_TRACE_FLAG_DISABLE_RING;
+        if (QueryPhaseTrace(device, flags, snapshot.get())) {
+            printf("Phase trace ring %s.\n", (action == "on") ? "enabled" : "disabled");
+        }
+    } else if (action == "reset") {
+        if (QueryPhaseTrace(device, FCL_PHASE_TRACE_FLAG_RESET, snapshot.get())) {
+            printf("Phase trace statistics and buffered events cleared.\n");
+        }
+    } else if (action == "dump" && tokens.size() == 3) {
+        if (QueryPhaseTrace(device, FCL_PHASE_TRACE_FLAG_RESET, snapshot.get())) {
+            PrintPhaseTrace(*snapshot);
+            WriteChromeTrace(*snapshot, tokens[2]);
+        }
+    } else {
+        printf("Usage: trace [show|on|off|reset|dump <file.json>]\n");
+    }
+    return true;
+}
+
+// output 至少为一个 FCL_WORKLOAD_RECORDING_RESPONSE；READ 时其余空间接收轨迹数据。
+bool SendWorkloadRecording(HANDLE device, const FCL_WORKLOAD_RECORDING_REQUEST& request, std::vector<uint8_t>& output) {
+    if (!SendIoctl(device,
+            IOCTL_FCL_WORKLOAD_RECORDING,
+            &request,
+            static_cast<DWORD>(sizeof(request)),
+            output.data(),
+            static_cast<DWORD>(output.size()))) {
+        printf("  [FAIL] IOCTL_FCL_WORKLOAD_RECORDING failed.\n");
+        return false;
+    }
+    return true;
+}
+
+void PrintWorkloadStatus(const FCL_WORKLOAD_RECORDING_STATUS& status) {
+    printf("Workload recording: %s%s, %llu records, %llu dropped, %llu / %u bytes\n",
+           status.Recording ? "recording" : "stopped",
+           status.HasTrace ? " (trace available)" : "",
+           static_cast<unsigned long long>(status.RecordCount),
+           static_cast<unsigned long long>(status.DroppedRecords),
+           static_cast<unsigned long long>(status.TraceBytes),
+           status.CapacityBytes);
+}
+
+// 分段读出轨迹并原样写入文件，供 FclMusaWorkloadReplay 回放。
+bool SaveWorkloadTrace(HANDLE device, const std::string& path) {
+    constexpr size_t kChunkBytes = 1024 * 1024;
+    std::vector<uint8_t> output(sizeof(FCL_WORKLOAD_RECORDING_RESPONSE) + kChunkBytes);
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        printf("Failed to open trace output: %s\n", path.c_str());
+        return false;
+    }
+
+    FCL_WORKLOAD_RECORDING_REQUEST request = {};
+    request.Operation = FCL_WORKLOAD_RECORDING_OP_READ;
+    for (;;) {
+        if (!SendWorkloadRecording(device, request, output)) {
+            printf("Stop the recording before saving ('record stop').\n");
+            return false;
+        }
+        const auto* response = reinterpret_cast<const FCL_WORKLOAD_RECORDING_RESPONSE*>(output.data());
+        if (response->DataBytes == 0) {
+            break;
+        }
+        file.write(reinterpret_cast<const char*>(response + 1), response->DataBytes);
+        request.Offset += response->DataBytes;
+    }
+    if (!file) {
+        printf("Failed to write trace output: %s\n", path.c_str());
+        return false;
+    }
+    printf("Wrote %llu bytes of workload trace to %s\n", static_cast<unsigned long long>(request.Offset), path.c_str());
+    return true;
+}
+
+bool RunRecordCommand(HANDLE device, const std::vector<std::string>& tokens) {
+    const std::string action = (tokens.size() >= 2) ? tokens[1] : "status";
+    if (action == "save" && tokens.size() == 3) {
+        return SaveWorkloadTrace(device, tokens[2]);
+    }
+
+    FCL_WORKLOAD_RECORDING_REQUEST request = {};
+    if (action == "status") {
+        request.Operation = FCL_WORKLOAD_RECORDING_OP_QUERY;
+    } else if (action == "start" && tokens.size() <= 3) {
+        int megabytes = 0;
+        if (tokens.size() == 3 && (!ParseInt(tokens[2], megabytes) || megabytes <= 0 || megabytes > 1024)) {
+            printf("Capacity must be 1..1024 MB.\n");
+            return false;
+        }
+        request.Operation = FCL_WORKLOAD_RECORDING_OP_START;
+        request.Config.CapacityBytes = static_cast<uint32_t>(megabytes) * 1024u * 1024u;
+    } else if (action == "stop") {
+        request.Operation = FCL_WORKLOAD_RECORDING_OP_STOP;
+    } else if (action == "discard") {
+        request.Operation = FCL_WORKLOAD_RECORDING_OP_DISCARD;
+    } else {
+        printf("Usage: record [status|start [MB]|stop|save <file>|discard]\n");
+        return true;
+    }
+
+    std::vector<uint8_t> output(sizeof(FCL_WORKLOAD_RECORDING_RESPONSE));
+    if (!SendWorkloadRecording(device, request, output)) {
+        return false;
+    }
+    PrintWorkloadStatus(reinterpret_cast<const FCL_WORKLOAD_RECORDING_RESPONSE*>(output.data())->Status);
+    return true;
+}
+
 bool StartPeriodicCollision(HANDLE device, const SceneObject& objectA, const SceneObject& objectB, uint32_t periodMicroseconds) {
     if (periodMicroseconds == 0) {
         printf("Period must be > 0 microseconds.\n");
@@ -846,6 +1168,7 @@ void PrintHelp() {
     printf("  help                                 Show this message\n");
     printf("  run <script_path>                    Execute commands from script\n");
     printf("  load <name> <obj_path>               Load mesh from OBJ file\n");
+    printf("  loadbin <name> <fclmesh_path>        Load precompiled mesh image (no BVH build)\n");
     printf("  sphere <name> <radius> [x y z]       Create a sphere\n");
     printf("  move <name> <x> <y> <z>              Update translation\n");
     printf("  collide <nameA> <nameB>              Run discrete collision test\n");
@@ -862,6 +1185,10 @@ void PrintHelp() {
     printf("  selftest <scenario>                  Run single self-test scenario (runtime|sphere|broadphase|mesh|ccd)\n");
     printf("  diag                                 Query kernel detection timing diagnostics\n");
     printf("  diag_dpc                             Show diagnostics delta since selftest_dpc\n");
+    printf("  trace [show|on|off|reset]            Query phase trace stats / toggle the event ring\n");
+    printf("  trace dump <file.json>               Export (and clear) phase events as Chrome trace JSON\n");
+    printf("  record [status|start [MB]|stop|discard]  Control query workload recording\n");
+    printf("  record save <file>                   Save the stopped recording for FclMusaWorkloadReplay\n");
     printf("  quit                                 Exit the tool\n");
 }
 
@@ -950,6 +1277,10 @@ bool ExecuteCommand(const std::vector<std::string>& tokens, HANDLE device, Scene
     PrintTimingStats("DpcCollision", diag.DpcCollision);
     } else if (cmd == "diag_dpc") {
         return PrintDiagDpc(device);
+    } else if (cmd == "trace") {
+        return RunTraceCommand(device, tokens);
+    } else if (cmd == "record") {
+        return RunRecordCommand(device, tokens);
     } else if (cmd == "selftest") {
         if (tokens.size() == 2) {
             return RunSelfTestScenario(device, tokens[1]);
@@ -1045,6 +1376,38 @@ bool ExecuteCommand(const std::vector<std::string>& tokens, HANDLE device, Scene
                static_cast<unsigned long long>(handle.Value),
                vertices.size(),
                indices.size());
+    } else if (cmd == "loadbin") {
+        if (tokens.size() < 3) {
+            printf("Usage: loadbin <name> <fclmesh_path>\n");
+            return true;
+        }
+        if (objects.find(tokens[1]) != objects.end()) {
+            printf("Name already exists: %s\n", tokens[1].c_str());
+            return true;
+        }
+        FCL_GEOMETRY_HANDLE handle = {};
+        FCL_PRECOMPILED_MESH_HEADER header = {};
+        const auto start = std::chrono::steady_clock::now();
+        if (!CreatePrecompiledMesh(device, std::filesystem::u8path(tokens[2]), handle, header)) {
+            return true;
+        }
+        const double elapsedMs =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        SceneObject obj;
+        obj.Name = tokens[1];
+        obj.Handle = handle;
+        obj.Transform = IdentityTransform();
+        obj.Type = "mesh";
+        obj.VertexCount = header.VertexCount;
+        obj.IndexCount = header.IndexCount;
+        objects.emplace(obj.Name, obj);
+        printf("Mesh %s loaded from image (handle=%llu, vertices=%u, indices=%u, nodes=%u, %.2f ms)\n",
+               obj.Name.c_str(),
+               static_cast<unsigned long long>(handle.Value),
+               header.VertexCount,
+               header.IndexCount,
+               header.NodeCount,
+               elapsedMs);
     } else if (cmd == "sphere") {
         if (tokens.size() != 3 && tokens.size() != 6) {
             printf("Usage: sphere <name> <radius> [x y z]\n");
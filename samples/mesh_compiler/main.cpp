@@ -0,0 +1,358 @@
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "fclmusa/geometry.h"
+#include "fclmusa/geometry/precompiled_mesh.h"
+#include "fclmusa/platform.h"
+
+//
+// 预编译 Mesh 转换工具：把 OBJ / raw 网格转换为预编译映像（顶点、索引与已构建的 BVH），
+// 运行时经 FclCreateMeshGeometryFromImage（驱动为 IOCTL_FCL_CREATE_PRECOMPILED_MESH，cli_demo 的 loadbin）直接加载，不再构建 BVH。
+// - 输入按扩展名识别：.obj（多边形面按扇形三角化）或 .raw（UINT32 顶点数、UINT32 索引数，随后 FCL_VECTOR3[] 与 UINT32[]）
+// - --out-dir 批量转换，输出文件名为输入文件名 + .fclmesh；--verify 重新加载映像并对比构建与加载耗时
+// - --info 打印映像文件头
+// 用法：
+//   FclMusaMeshCompiler <input> <output.fclmesh> [--scale S] [--verify]
+//   FclMusaMeshCompiler --out-dir <dir> <input>... [--scale S] [--verify]
+//   FclMusaMeshCompiler --info <file.fclmesh>
+//
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr const char* kImageExtension = ".fclmesh";
+
+struct Options {
+    std::vector<std::string> Inputs;
+    std::string Output;
+    std::string OutputDirectory;
+    float Scale = 1.0f;
+    bool Verify = false;
+};
+
+struct MeshData {
+    std::vector<FCL_VECTOR3> Vertices;
+    std::vector<UINT32> Indices;
+};
+
+double ElapsedMilliseconds(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+bool ParseFaceIndex(const std::string& token, size_t vertexCount, UINT32* out) {
+    const std::string number = token.substr(0, token.find('/'));
+    if (number.empty()) {
+        return false;
+    }
+    try {
+        const long long index = std::stoll(number);
+        if (index > 0 && static_cast<size_t>(index) <= vertexCount) {
+            *out = static_cast<UINT32>(index - 1);
+            return true;
+        }
+        if (index < 0 && static_cast<size_t>(-index) <= vertexCount) {
+            *out = static_cast<UINT32>(static_cast<long long>(vertexCount) + index);
+            return true;
+        }
+    } catch (...) {
+    }
+    return false;
+}
+
+bool LoadObj(const std::string& path, float scale, MeshData* mesh) {
+    std::ifstream input(path);
+    if (!input) {
+        std::fprintf(stderr, "cannot open %s\n", path.c_str());
+        return false;
+    }
+    std::string line;
+    size_t lineNumber = 0;
+    std::vector<UINT32> face;
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream iss(line);
+        std::string token;
+        iss >> token;
+        if (token == "v") {
+            FCL_VECTOR3 vertex = {};
+            if (!(iss >> vertex.X >> vertex.Y >> vertex.Z)) {
+                std::fprintf(stderr, "%s:%zu: malformed vertex\n", path.c_str(), lineNumber);
+                return false;
+            }
+            mesh->Vertices.push_back({vertex.X * scale, vertex.Y * scale, vertex.Z * scale});
+        } else if (token == "f") {
+            face.clear();
+            std::string entry;
+            while (iss >> entry) {
+                UINT32 index = 0;
+                if (!ParseFaceIndex(entry, mesh->Vertices.size(), &index)) {
+                    std::fprintf(stderr, "%s:%zu: invalid face index '%s'\n", path.c_str(), lineNumber, entry.c_str());
+                    return false;
+                }
+                face.push_back(index);
+            }
+            if (face.size() < 3) {
+                std::fprintf(stderr, "%s:%zu: face has fewer than 3 vertices\n", path.c_str(), lineNumber);
+                return false;
+            }
+            for (size_t i = 1; i + 1 < face.size(); ++i) {
+                mesh->Indices.push_back(face[0]);
+                mesh->Indices.push_back(face[i]);
+                mesh->Indices.push_back(face[i + 1]);
+            }
+        }
+    }
+    return true;
+}
+
+bool LoadRaw(const std::string& path, float scale, MeshData* mesh) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        std::fprintf(stderr, "cannot open %s\n", path.c_str());
+        return false;
+    }
+    UINT32 counts[2] = {};
+    if (!input.read(reinterpret_cast<char*>(counts), sizeof(counts))) {
+        std::fprintf(stderr, "%s: truncated header\n", path.c_str());
+        return false;
+    }
+    mesh->Vertices.resize(counts[0]);
+    mesh->Indices.resize(counts[1]);
+    if (!input.read(reinterpret_cast<char*>(mesh->Vertices.data()), mesh->Vertices.size() * sizeof(FCL_VECTOR3)) ||
+        !input.read(reinterpret_cast<char*>(mesh->Indices.data()), mesh->Indices.size() * sizeof(UINT32))) {
+        std::fprintf(stderr, "%s: truncated data (%u vertices, %u indices declared)\n", path.c_str(), counts[0], counts[1]);
+        return false;
+    }
+    for (FCL_VECTOR3& vertex : mesh->Vertices) {
+        vertex = {vertex.X * scale, vertex.Y * scale, vertex.Z * scale};
+    }
+    return true;
+}
+
+bool LoadMesh(const std::string& path, float scale, MeshData* mesh) {
+    std::string extension = std::filesystem::path(path).extension().string();
+    for (char& c : extension) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    bool loaded = false;
+    if (extension == ".obj") {
+        loaded = LoadObj(path, scale, mesh);
+    } else if (extension == ".raw") {
+        loaded = LoadRaw(path, scale, mesh);
+    } else {
+        std::fprintf(stderr, "%s: unsupported input (expected .obj or .raw)\n", path.c_str());
+        return false;
+    }
+    if (loaded && (mesh->Vertices.empty() || mesh->Indices.size() < 3 || (mesh->Indices.size() % 3) != 0)) {
+        std::fprintf(stderr, "%s: mesh needs at least one triangle\n", path.c_str());
+        return false;
+    }
+    return loaded;
+}
+
+bool ReadFile(const std::string& path, std::vector<unsigned char>* data) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::fprintf(stderr, "cannot open %s\n", path.c_str());
+        return false;
+    }
+    data->assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool WriteFile(const std::string& path, const std::vector<unsigned char>& data) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file || !file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()))) {
+        std::fprintf(stderr, "cannot write %s\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool Compile(const std::string& input, const std::string& output, const Options& options) {
+    MeshData mesh;
+    if (!LoadMesh(input, options.Scale, &mesh)) {
+        return false;
+    }
+
+    FCL_MESH_GEOMETRY_DESC desc = {};
+    desc.Vertices = mesh.Vertices.data();
+    desc.VertexCount = static_cast<ULONG>(mesh.Vertices.size());
+    desc.Indices = mesh.Indices.data();
+    desc.IndexCount = static_cast<ULONG>(mesh.Indices.size());
+
+    const Clock::time_point buildStart = Clock::now();
+    FCL_GEOMETRY_HANDLE handle = {};
+    NTSTATUS status = FclCreateGeometry(FCL_GEOMETRY_MESH, &desc, &handle);
+    const double buildMs = ElapsedMilliseconds(buildStart);
+    if (!NT_SUCCESS(status)) {
+        std::fprintf(stderr, "%s: FclCreateGeometry failed (0x%08X)\n", input.c_str(), static_cast<unsigned>(status));
+        return false;
+    }
+
+    size_t requiredBytes = 0;
+    std::vector<unsigned char> image;
+    status = FclSerializeMeshGeometry(handle, nullptr, 0, &requiredBytes);
+    if (status == STATUS_BUFFER_TOO_SMALL) {
+        image.resize(requiredBytes);
+        status = FclSerializeMeshGeometry(handle, image.data(), image.size(), &requiredBytes);
+    }
+    FclDestroyGeometry(handle);
+    if (!NT_SUCCESS(status)) {
+        std::fprintf(stderr, "%s: FclSerializeMeshGeometry failed (0x%08X)\n", input.c_str(), static_cast<unsigned>(status));
+        return false;
+    }
+    if (!WriteFile(output, image)) {
+        return false;
+    }
+    std::printf("%s -> %s: %lu vertices, %lu triangles, %.1f KB, BVH build %.2f ms\n",
+        input.c_str(),
+        output.c_str(),
+        desc.VertexCount,
+        desc.IndexCount / 3,
+        static_cast<double>(image.size()) / 1024.0,
+        buildMs);
+
+    if (options.Verify) {
+        std::vector<unsigned char> reloaded;
+        if (!ReadFile(output, &reloaded)) {
+            return false;
+        }
+        const Clock::time_point loadStart = Clock::now();
+        status = FclCreateMeshGeometryFromImage(reloaded.data(), reloaded.size(), &handle);
+        const double loadMs = ElapsedMilliseconds(loadStart);
+        if (!NT_SUCCESS(status)) {
+            std::fprintf(stderr, "%s: verification failed (0x%08X)\n", output.c_str(), static_cast<unsigned>(status));
+            return false;
+        }
+        FclDestroyGeometry(handle);
+        std::printf("  verified: image load %.2f ms (%.1fx faster than build)\n", loadMs, (loadMs > 0.0) ? buildMs / loadMs : 0.0);
+    }
+    return true;
+}
+
+int PrintInfo(const std::string& path) {
+    std::vector<unsigned char> image;
+    if (!ReadFile(path, &image)) {
+        return EXIT_FAILURE;
+    }
+    FCL_PRECOMPILED_MESH_VIEW view = {};
+    const NTSTATUS status = FclParsePrecompiledMesh(image.data(), image.size(), &view);
+    if (!NT_SUCCESS(status)) {
+        std::fprintf(stderr, "%s: not a valid precompiled mesh (0x%08X)\n", path.c_str(), static_cast<unsigned>(status));
+        return EXIT_FAILURE;
+    }
+    FCL_PRECOMPILED_MESH_HEADER header = {};
+    std::memcpy(&header, image.data(), sizeof(header));
+    std::printf("%s: version %lu, %lu vertices, %lu triangles, %lu BVH nodes, %llu bytes, checksum %016llX\n",
+        path.c_str(),
+        header.Version,
+        header.VertexCount,
+        header.IndexCount / 3,
+        header.NodeCount,
+        header.ImageBytes,
+        header.Checksum);
+    return EXIT_SUCCESS;
+}
+
+void PrintUsage(const char* program) {
+    std::fprintf(stderr,
+        "usage:\n"
+        "  %s <input.obj|input.raw> <output%s> [--scale S] [--verify]\n"
+        "  %s --out-dir <dir> <input>... [--scale S] [--verify]\n"
+        "  %s --info <file%s>\n",
+        program,
+        kImageExtension,
+        program,
+        program,
+        kImageExtension);
+}
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--verify") {
+            options->Verify = true;
+        } else if (arg == "--scale" && i + 1 < argc) {
+            options->Scale = std::strtof(argv[++i], nullptr);
+            if (!(options->Scale > 0.0f)) {
+                return false;
+            }
+        } else if (arg == "--out-dir" && i + 1 < argc) {
+            options->OutputDirectory = argv[++i];
+        } else if (arg.size() > 2 && arg.compare(0, 2, "--") == 0) {
+            return false;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (!options->OutputDirectory.empty()) {
+        options->Inputs = std::move(positional);
+        return !options->Inputs.empty();
+    }
+    if (positional.size() != 2) {
+        return false;
+    }
+    options->Inputs.push_back(positional[0]);
+    options->Output = positional[1];
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc == 3 && std::strcmp(argv[1], "--info") == 0) {
+        return PrintInfo(argv[2]);
+    }
+    Options options;
+    if (!ParseOptions(argc, argv, &options)) {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (!options.OutputDirectory.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(options.OutputDirectory, error);
+        if (error) {
+            std::fprintf(stderr, "cannot create %s: %s\n", options.OutputDirectory.c_str(), error.message().c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!NT_SUCCESS(FclGeometrySubsystemInitialize())) {
+        std::fprintf(stderr, "FclGeometrySubsystemInitialize failed\n");
+        return EXIT_FAILURE;
+    }
+
+    size_t failures = 0;
+    for (const std::string& input : options.Inputs) {
+        std::string output = options.Output;
+        if (!options.OutputDirectory.empty()) {
+            output = (std::filesystem::path(options.OutputDirectory) /
+                      std::filesystem::path(input).filename().replace_extension(kImageExtension))
+                         .string();
+        }
+        if (!Compile(input, output, options)) {
+            ++failures;
+        }
+    }
+    FclGeometrySubsystemShutdown();
+
+    if (options.Inputs.size() > 1) {
+        std::printf("%zu of %zu meshes converted\n", options.Inputs.size() - failures, options.Inputs.size());
+    }
+    return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,734 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "fclmusa/broadphase.h"
+#include "fclmusa/collision.h"
+#include "fclmusa/diagnostics/workload_recorder.h"
+#include "fclmusa/distance.h"
+#include "fclmusa/geometry.h"
+#include "fclmusa/platform.h"
+
+//
+// 工作负载回放：读取 FclStartWorkloadRecording 录制的轨迹（cli_demo 的 record save 导出），在用户态库上按原顺序重放
+// - 默认尽快回放；--realtime 按记录的时间戳等待，重现原始调用节奏
+// - 句柄按录制时的值重新映射；失败的创建、引用未知句柄的调用跳过并计数
+// - 按调用类型输出录制时与回放时的延迟分布，并统计结果与录制不一致的次数（碰撞结论 / 接触数、距离、CCD 结论、
+//   批量 CCD 的最早碰撞对）
+// - --report 把回放延迟写为文本报告，--diff 对比两份报告（例如优化前 / 后的构建）
+// 用法：
+//   FclMusaWorkloadReplay <trace> [--realtime] [--repeat N] [--report <file>]
+//   FclMusaWorkloadReplay --diff <baseline.txt> <candidate.txt>
+//
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double kDistanceTolerance = 1.0e-4;
+
+const char* const kTypeNames[FCL_WORKLOAD_RECORD_TYPE_COUNT] = {"",
+    "create",
+    "destroy",
+    "update_mesh",
+    "collision",
+    "distance",
+    "ccd",
+    "broadphase",
+    "collide_objects",
+    "compound_collision",
+    "compound_distance",
+    "screw_ccd",
+    "ccd_batch"};
+
+struct Options {
+    std::string TracePath;
+    bool Realtime = false;
+    ULONG Repeat = 1;
+    std::string ReportPath;
+};
+
+struct LatencySummary {
+    size_t Count = 0;
+    double Mean = 0.0;
+    double P50 = 0.0;
+    double P90 = 0.0;
+    double P99 = 0.0;
+    double Max = 0.0;
+};
+
+// 最近秩百分位，输入须已排序。
+double Percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    const size_t rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[(rank == 0) ? 0 : rank - 1];
+}
+
+LatencySummary Summarize(std::vector<double> samples) {
+    LatencySummary summary;
+    if (samples.empty()) {
+        return summary;
+    }
+    std::sort(samples.begin(), samples.end());
+    double total = 0.0;
+    for (double sample : samples) {
+        total += sample;
+    }
+    summary.Count = samples.size();
+    summary.Mean = total / static_cast<double>(samples.size());
+    summary.P50 = Percentile(samples, 0.50);
+    summary.P90 = Percentile(samples, 0.90);
+    summary.P99 = Percentile(samples, 0.99);
+    summary.Max = samples.back();
+    return summary;
+}
+
+class Trace {
+public:
+    bool Load(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            std::fprintf(stderr, "cannot open %s\n", path.c_str());
+            return false;
+        }
+        data_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        if (data_.size() < sizeof(FCL_WORKLOAD_TRACE_HEADER)) {
+            std::fprintf(stderr, "%s: truncated header\n", path.c_str());
+            return false;
+        }
+        std::memcpy(&header_, data_.data(), sizeof(header_));
+        if (header_.Magic != FCL_WORKLOAD_TRACE_MAGIC || header_.Version != FCL_WORKLOAD_TRACE_VERSION ||
+            header_.HeaderSize != sizeof(FCL_WORKLOAD_TRACE_HEADER) || header_.TraceBytes > data_.size() ||
+            header_.TimestampFrequency == 0) {
+            std::fprintf(stderr, "%s: not a workload trace (or unsupported version)\n", path.c_str());
+            return false;
+        }
+
+        for (size_t offset = header_.HeaderSize; offset < header_.TraceBytes;) {
+            const auto* record = reinterpret_cast<const FCL_WORKLOAD_RECORD_HEADER*>(data_.data() + offset);
+            if (header_.TraceBytes - offset < sizeof(*record) || record->Size < sizeof(*record) ||
+                (record->Size % 8) != 0 || record->Size > header_.TraceBytes - offset || !HasValidPayload(record)) {
+                std::fprintf(stderr, "%s: malformed record at offset %zu\n", path.c_str(), offset);
+                return false;
+            }
+            records_.push_back(record);
+            offset += record->Size;
+        }
+        return true;
+    }
+
+    const FCL_WORKLOAD_TRACE_HEADER& Header() const noexcept {
+        return header_;
+    }
+
+    const std::vector<const FCL_WORKLOAD_RECORD_HEADER*>& Records() const noexcept {
+        return records_;
+    }
+
+    double ToNanoseconds(ULONGLONG ticks) const noexcept {
+        return static_cast<double>(ticks) * 1.0e9 / static_cast<double>(header_.TimestampFrequency);
+    }
+
+private:
+    static bool HasValidPayload(const FCL_WORKLOAD_RECORD_HEADER* record) {
+        ULONGLONG required = 0;
+        switch (record->Type) {
+            case FCL_WORKLOAD_RECORD_GEOMETRY:
+            case FCL_WORKLOAD_RECORD_UPDATE_MESH: {
+                if (record->Size < sizeof(FCL_WORKLOAD_GEOMETRY_RECORD)) {
+                    return false;
+                }
+                const auto* geometry = reinterpret_cast<const FCL_WORKLOAD_GEOMETRY_RECORD*>(record);
+                required = sizeof(*geometry);
+                if (geometry->GeometryType == FCL_GEOMETRY_COMPOUND) {
+                    required += static_cast<ULONGLONG>(geometry->ElementCount0) * sizeof(FCL_COMPOUND_CHILD_DESC);
+                } else {
+                    required += static_cast<ULONGLONG>(geometry->ElementCount0) * sizeof(FCL_VECTOR3) +
+                                static_cast<ULONGLONG>(geometry->ElementCount1) * sizeof(UINT32);
+                }
+                break;
+            }
+            case FCL_WORKLOAD_RECORD_DESTROY:
+                required = sizeof(FCL_WORKLOAD_DESTROY_RECORD);
+                break;
+            case FCL_WORKLOAD_RECORD_COLLISION:
+            case FCL_WORKLOAD_RECORD_DISTANCE:
+            case FCL_WORKLOAD_RECORD_COMPOUND_COLLISION:
+            case FCL_WORKLOAD_RECORD_COMPOUND_DISTANCE:
+                required = sizeof(FCL_WORKLOAD_PAIR_RECORD);
+                break;
+            case FCL_WORKLOAD_RECORD_COLLIDE_OBJECTS:
+                required = sizeof(FCL_WORKLOAD_COLLIDE_OBJECTS_RECORD);
+                break;
+            case FCL_WORKLOAD_RECORD_CONTINUOUS_COLLISION:
+                required = sizeof(FCL_WORKLOAD_CCD_RECORD);
+                break;
+            case FCL_WORKLOAD_RECORD_SCREW_CONTINUOUS_COLLISION:
+                required = sizeof(FCL_WORKLOAD_SCREW_CCD_RECORD);
+                break;
+            case FCL_WORKLOAD_RECORD_CONTINUOUS_BATCH: {
+                if (record->Size < sizeof(FCL_WORKLOAD_CCD_BATCH_RECORD)) {
+                    return false;
+                }
+                const auto* batch = reinterpret_cast<const FCL_WORKLOAD_CCD_BATCH_RECORD*>(record);
+                required = sizeof(*batch) +
+                           static_cast<ULONGLONG>(batch->ObjectCount) * sizeof(FCL_CONTINUOUS_BATCH_OBJECT);
+                break;
+            }
+            case FCL_WORKLOAD_RECORD_BROADPHASE: {
+                if (record->Size < sizeof(FCL_WORKLOAD_BROADPHASE_RECORD)) {
+                    return false;
+                }
+                const auto* broadphase = reinterpret_cast<const FCL_WORKLOAD_BROADPHASE_RECORD*>(record);
+                required = sizeof(*broadphase) +
+                           static_cast<ULONGLONG>(broadphase->ObjectCount) * sizeof(FCL_WORKLOAD_BROADPHASE_OBJECT);
+                break;
+            }
+            default:
+                return false;
+        }
+        return required <= record->Size;
+    }
+
+    std::vector<UCHAR> data_;
+    FCL_WORKLOAD_TRACE_HEADER header_ = {};
+    std::vector<const FCL_WORKLOAD_RECORD_HEADER*> records_;
+};
+
+struct ReplayStats {
+    std::vector<double> Latency[FCL_WORKLOAD_RECORD_TYPE_COUNT];
+    ULONGLONG Skipped = 0;     // 录制时失败或引用了未知句柄
+    ULONGLONG Failed = 0;      // 录制时成功、回放时失败
+    ULONGLONG Mismatches = 0;  // 结果与录制不一致
+};
+
+class Replayer {
+public:
+    Replayer(const Trace& trace, ReplayStats* stats) : trace_(trace), stats_(stats) {}
+
+    ~Replayer() {
+        // 逆序销毁：复合几何先于其子形状。
+        for (auto it = created_.rbegin(); it != created_.rend(); ++it) {
+            auto mapped = handles_.find(*it);
+            if (mapped != handles_.end()) {
+                FclDestroyGeometry(mapped->second);
+            }
+        }
+    }
+
+    Replayer(const Replayer&) = delete;
+    Replayer& operator=(const Replayer&) = delete;
+
+    void Run(bool realtime) {
+        const Clock::time_point origin = Clock::now();
+        for (const FCL_WORKLOAD_RECORD_HEADER* record : trace_.Records()) {
+            if (realtime && (record->Flags & FCL_WORKLOAD_RECORD_FLAG_EXISTING) == 0) {
+                std::this_thread::sleep_until(
+                    origin + std::chrono::nanoseconds(static_cast<long long>(trace_.ToNanoseconds(record->Timestamp))));
+            }
+            Replay(record);
+        }
+    }
+
+private:
+    template <typename Call>
+    NTSTATUS Timed(const FCL_WORKLOAD_RECORD_HEADER* record, Call&& call) {
+        const Clock::time_point start = Clock::now();
+        const NTSTATUS status = call();
+        const double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        // 录制开始前已存在的几何只是场景准备，不计入延迟分布。
+        if ((record->Flags & FCL_WORKLOAD_RECORD_FLAG_EXISTING) == 0) {
+            stats_->Latency[record->Type].push_back(elapsed);
+        }
+        if (!NT_SUCCESS(status)) {
+            ++stats_->Failed;
+        }
+        return status;
+    }
+
+    bool Map(FCL_GEOMETRY_HANDLE recorded, FCL_GEOMETRY_HANDLE* replayed) const {
+        auto it = handles_.find(recorded.Value);
+        if (it == handles_.end()) {
+            return false;
+        }
+        *replayed = it->second;
+        return true;
+    }
+
+    void Replay(const FCL_WORKLOAD_RECORD_HEADER* record) {
+        if (!NT_SUCCESS(record->Status)) {
+            ++stats_->Skipped;
+            return;
+        }
+        bool replayed = false;
+        switch (record->Type) {
+            case FCL_WORKLOAD_RECORD_GEOMETRY:
+                replayed = ReplayCreate(reinterpret_cast<const FCL_WORKLOAD_GEOMETRY_RECORD*>(record));
+                break;
+            case FCL_WORKLOAD_RECORD_DESTROY:
+                replayed = ReplayDestroy(reinterpret_cast<const FCL_WORKLOAD_DESTROY_RECORD*>(record));
+                break;
+            case FCL_WORKLOAD_RECORD_UPDATE_MESH:
+                replayed = ReplayUpdate(reinterpret_cast<const FCL_WORKLOAD_GEOMETRY_RECORD*>(record));
+                break;
+            case FCL_WORKLOAD_RECORD_COLLISION:
+            case FCL_WORKLOAD_RECORD_DISTANCE:
+            case FCL_WORKLOAD_RECORD_COMPOUND_COLLISION:
+            case FCL_WORKLOAD_RECORD_COMPOUND_DISTANCE:
+                replayed = ReplayPair(reinterpret_cast<const FCL_WORKLOAD_PAIR_RECORD*>(record));
+                break;
+            case FCL_WORKLOAD_RECORD_COLLIDE_OBJECTS:
+                replayed = ReplayCollideObjects(reinterpret_cast<const FCL_WORKLOAD_COLLIDE_OBJECTS_RECORD*>(record));
+                break;
+            case FCL_WORKLOAD_RECORD_CONTINUOUS_COLLISION:
+                replayed = ReplayContinuous(reinterpret_cast<const FCL_WORKLOAD_CCD_RECORD*>(record));
+                break;
+            case FCL_WORKLOAD_RECORD_SCREW_CONTINUOUS_COLLISION:
+                replayed = ReplayScrewContinuous(reinterpret_cast<const FCL_WORKLOAD_SCREW_CCD_RECORD*>(record));
+                break;
+            case FCL_WORKLOAD_RECORD_CONTINUOUS_BATCH:
+                replayed = ReplayContinuousBatch(reinterpret_cast<const FCL_WORKLOAD_CCD_BATCH_RECORD*>(record));
+                break;
+            case FCL_WORKLOAD_RECORD_BROADPHASE:
+                replayed = ReplayBroadphase(reinterpret_cast<const FCL_WORKLOAD_BROADPHASE_RECORD*>(record));
+                break;
+            default:
+                break;
+        }
+        if (!replayed) {
+            ++stats_->Skipped;
+        }
+    }
+
+    static FCL_MESH_GEOMETRY_DESC MeshDesc(const FCL_WORKLOAD_GEOMETRY_RECORD* record) {
+        const auto* vertices = reinterpret_cast<const FCL_VECTOR3*>(record + 1);
+        FCL_MESH_GEOMETRY_DESC desc = {};
+        desc.Vertices = vertices;
+        desc.VertexCount = record->ElementCount0;
+        desc.Indices = reinterpret_cast<const UINT32*>(vertices + record->ElementCount0);
+        desc.IndexCount = record->ElementCount1;
+        return desc;
+    }
+
+    bool ReplayCreate(const FCL_WORKLOAD_GEOMETRY_RECORD* record) {
+        // 与开始录制并发的创建可能同时出现在已存在几何与创建记录中。
+        if (record->Handle.Value == 0 || handles_.count(record->Handle.Value) != 0) {
+            return false;
+        }
+
+        const auto type = static_cast<FCL_GEOMETRY_TYPE>(record->GeometryType);
+        FCL_MESH_GEOMETRY_DESC mesh = {};
+        FCL_CONVEX_GEOMETRY_DESC convex = {};
+        FCL_COMPOUND_GEOMETRY_DESC compound = {};
+        std::vector<FCL_COMPOUND_CHILD_DESC> children;
+        const VOID* desc = nullptr;
+        switch (type) {
+            case FCL_GEOMETRY_SPHERE:
+            case FCL_GEOMETRY_OBB:
+            case FCL_GEOMETRY_CAPSULE:
+            case FCL_GEOMETRY_CYLINDER:
+                desc = &record->Shape;
+                break;
+            case FCL_GEOMETRY_MESH:
+                mesh = MeshDesc(record);
+                desc = &mesh;
+                break;
+            case FCL_GEOMETRY_CONVEX:
+                convex.Points = reinterpret_cast<const FCL_VECTOR3*>(record + 1);
+                convex.PointCount = record->ElementCount0;
+                desc = &convex;
+                break;
+            case FCL_GEOMETRY_COMPOUND: {
+                const auto* recorded = reinterpret_cast<const FCL_COMPOUND_CHILD_DESC*>(record + 1);
+                children.assign(recorded, recorded + record->ElementCount0);
+                for (FCL_COMPOUND_CHILD_DESC& child : children) {
+                    if (!Map(child.Geometry, &child.Geometry)) {
+                        return false;
+                    }
+                }
+                compound.Children = children.data();
+                compound.ChildCount = static_cast<ULONG>(children.size());
+                desc = &compound;
+                break;
+            }
+            default:
+                return false;
+        }
+
+        FCL_GEOMETRY_HANDLE handle = {};
+        if (NT_SUCCESS(Timed(&record->Header, [&] { return FclCreateGeometry(type, desc, &handle); }))) {
+            handles_[record->Handle.Value] = handle;
+            created_.push_back(record->Handle.Value);
+        }
+        return true;
+    }
+
+    bool ReplayDestroy(const FCL_WORKLOAD_DESTROY_RECORD* record) {
+        FCL_GEOMETRY_HANDLE handle = {};
+        if (!Map(record->Handle, &handle)) {
+            return false;
+        }
+        if (NT_SUCCESS(Timed(&record->Header, [&] { return FclDestroyGeometry(handle); }))) {
+            handles_.erase(record->Handle.Value);
+        }
+        return true;
+    }
+
+    bool ReplayUpdate(const FCL_WORKLOAD_GEOMETRY_RECORD* record) {
+        FCL_GEOMETRY_HANDLE handle = {};
+        if (!Map(record->Handle, &handle) || record->GeometryType != FCL_GEOMETRY_MESH) {
+            return false;
+        }
+        const FCL_MESH_GEOMETRY_DESC desc = MeshDesc(record);
+        Timed(&record->Header, [&] { return FclUpdateMeshGeometry(handle, &desc); });
+        return true;
+    }
+
+    bool ReplayPair(const FCL_WORKLOAD_PAIR_RECORD* record) {
+        FCL_GEOMETRY_HANDLE object1 = {};
+        FCL_GEOMETRY_HANDLE object2 = {};
+        if (!Map(record->Handle1, &object1) || !Map(record->Handle2, &object2)) {
+            return false;
+        }
+        const FCL_TRANSFORM* transform1 =
+            (record->Flags & FCL_WORKLOAD_PAIR_FLAG_TRANSFORM1) != 0 ? &record->Transform1 : nullptr;
+        const FCL_TRANSFORM* transform2 =
+            (record->Flags & FCL_WORKLOAD_PAIR_FLAG_TRANSFORM2) != 0 ? &record->Transform2 : nullptr;
+
+        FCL_COMPOUND_CHILD_PAIR children = {};
+        switch (record->Header.Type) {
+            case FCL_WORKLOAD_RECORD_COLLISION:
+            case FCL_WORKLOAD_RECORD_COMPOUND_COLLISION: {
+                const bool compound = record->Header.Type == FCL_WORKLOAD_RECORD_COMPOUND_COLLISION;
+                BOOLEAN intersecting = FALSE;
+                const NTSTATUS status = Timed(&record->Header, [&] {
+                    if (compound) {
+                        return FclCompoundCollisionDetect(
+                            object1, transform1, object2, transform2, &intersecting, nullptr, &children);
+                    }
+                    return FclCollisionDetect(object1, transform1, object2, transform2, &intersecting, nullptr);
+                });
+                if (NT_SUCCESS(status) && intersecting != record->Intersecting) {
+                    ++stats_->Mismatches;
+                }
+                break;
+            }
+            default: {
+                const bool compound = record->Header.Type == FCL_WORKLOAD_RECORD_COMPOUND_DISTANCE;
+                FCL_DISTANCE_RESULT result = {};
+                const NTSTATUS status = Timed(&record->Header, [&] {
+                    if (compound) {
+                        return FclCompoundDistanceCompute(object1, transform1, object2, transform2, &result, &children);
+                    }
+                    return FclDistanceCompute(object1, transform1, object2, transform2, &result);
+                });
+                if (NT_SUCCESS(status) && std::fabs(result.Distance - record->Distance) > kDistanceTolerance) {
+                    ++stats_->Mismatches;
+                }
+                break;
+            }
+        }
+        return true;
+    }
+
+    bool ReplayCollideObjects(const FCL_WORKLOAD_COLLIDE_OBJECTS_RECORD* record) {
+        FCL_COLLISION_OBJECT_DESC object1 = record->Object1;
+        FCL_COLLISION_OBJECT_DESC object2 = record->Object2;
+        if (!Map(object1.Geometry, &object1.Geometry) || !Map(object2.Geometry, &object2.Geometry)) {
+            return false;
+        }
+        FCL_COLLISION_QUERY_REQUEST request = {};
+        std::vector<FCL_CONTACT_INFO> contacts;
+        const bool hasRequest = (record->Flags & FCL_WORKLOAD_COLLIDE_FLAG_REQUEST) != 0;
+        if (hasRequest) {
+            request.MaxContacts = record->MaxContacts;
+            request.EnableContactInfo = record->EnableContactInfo;
+            request.Solver = record->Solver;
+            if ((record->Flags & FCL_WORKLOAD_COLLIDE_FLAG_CONTACT_ARRAY) != 0) {
+                contacts.resize(record->MaxContacts);
+                request.Contacts = contacts.data();
+            }
+        }
+        FCL_COLLISION_QUERY_RESULT result = {};
+        const NTSTATUS status = Timed(&record->Header,
+            [&] { return FclCollideObjects(&object1, &object2, hasRequest ? &request : nullptr, &result); });
+        if (NT_SUCCESS(status) &&
+            (result.Intersecting != record->Intersecting || result.ContactCount != record->ContactCount)) {
+            ++stats_->Mismatches;
+        }
+        return true;
+    }
+
+    bool ReplayContinuous(const FCL_WORKLOAD_CCD_RECORD* record) {
+        FCL_CONTINUOUS_COLLISION_QUERY query = record->Query;
+        if (!Map(query.Object1, &query.Object1) || !Map(query.Object2, &query.Object2)) {
+            return false;
+        }
+        FCL_CONTINUOUS_COLLISION_RESULT result = {};
+        const NTSTATUS status = Timed(&record->Header, [&] { return FclContinuousCollision(&query, &result); });
+        if (NT_SUCCESS(status) && result.Intersecting != record->Intersecting) {
+            ++stats_->Mismatches;
+        }
+        return true;
+    }
+
+    bool ReplayScrewContinuous(const FCL_WORKLOAD_SCREW_CCD_RECORD* record) {
+        FCL_SCREW_CONTINUOUS_COLLISION_QUERY query = record->Query;
+        if (!Map(query.Object1, &query.Object1) || !Map(query.Object2, &query.Object2)) {
+            return false;
+        }
+        FCL_CONTINUOUS_COLLISION_RESULT result = {};
+        const NTSTATUS status = Timed(&record->Header, [&] { return FclScrewContinuousCollision(&query, &result); });
+        if (NT_SUCCESS(status) && result.Intersecting != record->Intersecting) {
+            ++stats_->Mismatches;
+        }
+        return true;
+    }
+
+    bool ReplayContinuousBatch(const FCL_WORKLOAD_CCD_BATCH_RECORD* record) {
+        const auto* recorded = reinterpret_cast<const FCL_CONTINUOUS_BATCH_OBJECT*>(record + 1);
+        std::vector<FCL_CONTINUOUS_BATCH_OBJECT> objects(recorded, recorded + record->ObjectCount);
+        for (FCL_CONTINUOUS_BATCH_OBJECT& object : objects) {
+            if (!Map(object.Handle, &object.Handle)) {
+                return false;
+            }
+        }
+        FCL_CONTINUOUS_BATCH_QUERY query = {};
+        query.Objects = objects.data();
+        query.ObjectCount = record->ObjectCount;
+        query.Tolerance = record->Tolerance;
+        query.MaxIterations = record->MaxIterations;
+        query.Solver = static_cast<FCL_GJK_SOLVER_TYPE>(record->Solver);
+        std::vector<FCL_CONTINUOUS_BATCH_HIT> hits((record->HasPerObjectHits != 0) ? record->ObjectCount : 0);
+        FCL_CONTINUOUS_BATCH_RESULT result = {};
+        const NTSTATUS status = Timed(&record->Header, [&] {
+            return FclContinuousCollisionBatch(&query, hits.empty() ? nullptr : hits.data(), &result);
+        });
+        if (NT_SUCCESS(status) && (result.Object1 != record->Object1 || result.Object2 != record->Object2 ||
+                                      result.HitPairCount != record->HitPairCount)) {
+            ++stats_->Mismatches;
+        }
+        return true;
+    }
+
+    bool ReplayBroadphase(const FCL_WORKLOAD_BROADPHASE_RECORD* record) {
+        const auto* recorded = reinterpret_cast<const FCL_WORKLOAD_BROADPHASE_OBJECT*>(record + 1);
+        std::vector<FCL_BROADPHASE_OBJECT> objects(record->ObjectCount);
+        for (ULONG i = 0; i < record->ObjectCount; ++i) {
+            if (!Map(recorded[i].Handle, &objects[i].Handle)) {
+                return false;
+            }
+            objects[i].Transform = (recorded[i].HasTransform != 0) ? &recorded[i].Transform : nullptr;
+        }
+        std::vector<FCL_BROADPHASE_PAIR> pairs(record->PairCapacity);
+        ULONG pairCount = 0;
+        const NTSTATUS status = Timed(&record->Header, [&] {
+            return FclBroadphaseDetect(objects.data(),
+                record->ObjectCount,
+                pairs.empty() ? nullptr : pairs.data(),
+                record->PairCapacity,
+                &pairCount);
+        });
+        if (NT_SUCCESS(status) && pairCount != record->PairCount) {
+            ++stats_->Mismatches;
+        }
+        return true;
+    }
+
+    const Trace& trace_;
+    ReplayStats* stats_;
+    std::unordered_map<ULONGLONG, FCL_GEOMETRY_HANDLE> handles_;
+    std::vector<ULONGLONG> created_;
+};
+
+void PrintSummaryRow(const char* name, const char* source, const LatencySummary& summary) {
+    std::printf("%-18s %-9s %10zu %10.2f %10.2f %10.2f %10.2f %10.2f\n",
+        name,
+        source,
+        summary.Count,
+        summary.Mean * 1.0e-3,
+        summary.P50 * 1.0e-3,
+        summary.P90 * 1.0e-3,
+        summary.P99 * 1.0e-3,
+        summary.Max * 1.0e-3);
+}
+
+// 每行：调用类型 次数 平均 p50 p90 p99 最大（纳秒）。
+bool WriteReport(const std::string& path, const LatencySummary (&summaries)[FCL_WORKLOAD_RECORD_TYPE_COUNT]) {
+    std::ofstream file(path);
+    if (!file) {
+        std::fprintf(stderr, "cannot write %s\n", path.c_str());
+        return false;
+    }
+    file << "# FclMusaWorkloadReplay report: type count mean_ns p50_ns p90_ns p99_ns max_ns\n";
+    for (ULONG type = FCL_WORKLOAD_RECORD_GEOMETRY; type < FCL_WORKLOAD_RECORD_TYPE_COUNT; ++type) {
+        const LatencySummary& summary = summaries[type];
+        if (summary.Count != 0) {
+            file << kTypeNames[type] << ' ' << summary.Count << ' ' << summary.Mean << ' ' << summary.P50 << ' '
+                 << summary.P90 << ' ' << summary.P99 << ' ' << summary.Max << '\n';
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+bool ReadReport(const std::string& path, std::unordered_map<std::string, LatencySummary>* report) {
+    std::ifstream file(path);
+    if (!file) {
+        std::fprintf(stderr, "cannot open %s\n", path.c_str());
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string name;
+        LatencySummary summary;
+        if (!(fields >> name >> summary.Count >> summary.Mean >> summary.P50 >> summary.P90 >> summary.P99 >>
+                summary.Max)) {
+            std::fprintf(stderr, "%s: malformed line: %s\n", path.c_str(), line.c_str());
+            return false;
+        }
+        (*report)[name] = summary;
+    }
+    return true;
+}
+
+double PercentChange(double baseline, double candidate) {
+    return (baseline > 0.0) ? 100.0 * (candidate - baseline) / baseline : 0.0;
+}
+
+int RunDiff(const std::string& baselinePath, const std::string& candidatePath) {
+    std::unordered_map<std::string, LatencySummary> baseline;
+    std::unordered_map<std::string, LatencySummary> candidate;
+    if (!ReadReport(baselinePath, &baseline) || !ReadReport(candidatePath, &candidate)) {
+        return EXIT_FAILURE;
+    }
+    std::printf("%-18s %12s %12s %8s %12s %12s %8s  (us)\n", "type", "p50 base", "p50 new", "delta", "p99 base",
+        "p99 new", "delta");
+    for (ULONG type = FCL_WORKLOAD_RECORD_GEOMETRY; type < FCL_WORKLOAD_RECORD_TYPE_COUNT; ++type) {
+        auto before = baseline.find(kTypeNames[type]);
+        auto after = candidate.find(kTypeNames[type]);
+        if (before == baseline.end() || after == candidate.end()) {
+            continue;
+        }
+        const LatencySummary& a = before->second;
+        const LatencySummary& b = after->second;
+        std::printf("%-18s %12.2f %12.2f %+7.1f%% %12.2f %12.2f %+7.1f%%\n",
+            kTypeNames[type],
+            a.P50 * 1.0e-3,
+            b.P50 * 1.0e-3,
+            PercentChange(a.P50, b.P50),
+            a.P99 * 1.0e-3,
+            b.P99 * 1.0e-3,
+            PercentChange(a.P99, b.P99));
+    }
+    return EXIT_SUCCESS;
+}
+
+void PrintUsage(const char* program) {
+    std::fprintf(stderr,
+        "usage: %s <trace> [--realtime] [--repeat N] [--report <file>]\n"
+        "       %s --diff <baseline.txt> <candidate.txt>\n",
+        program,
+        program);
+}
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--realtime") {
+            options->Realtime = true;
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            options->Repeat = static_cast<ULONG>(std::strtoul(argv[++i], nullptr, 10));
+            if (options->Repeat == 0) {
+                return false;
+            }
+        } else if (arg == "--report" && i + 1 < argc) {
+            options->ReportPath = argv[++i];
+        } else if (!arg.empty() && arg[0] != '-' && options->TracePath.empty()) {
+            options->TracePath = arg;
+        } else {
+            return false;
+        }
+    }
+    return !options->TracePath.empty();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc == 4 && std::strcmp(argv[1], "--diff") == 0) {
+        return RunDiff(argv[2], argv[3]);
+    }
+    Options options;
+    if (!ParseOptions(argc, argv, &options)) {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    Trace trace;
+    if (!trace.Load(options.TracePath)) {
+        return EXIT_FAILURE;
+    }
+    const FCL_WORKLOAD_TRACE_HEADER& header = trace.Header();
+    std::printf("trace %s: %zu records, %llu dropped while recording, %.3f s span\n",
+        options.TracePath.c_str(),
+        trace.Records().size(),
+        header.DroppedRecords,
+        trace.Records().empty() ? 0.0 : trace.ToNanoseconds(trace.Records().back()->Timestamp) * 1.0e-9);
+
+    if (!NT_SUCCESS(FclGeometrySubsystemInitialize())) {
+        std::fprintf(stderr, "FclGeometrySubsystemInitialize failed\n");
+        return EXIT_FAILURE;
+    }
+
+    ReplayStats stats;
+    for (ULONG pass = 0; pass < options.Repeat; ++pass) {
+        Replayer replayer(trace, &stats);
+        replayer.Run(options.Realtime);
+    }
+    FclGeometrySubsystemShutdown();
+
+    std::vector<double> recorded[FCL_WORKLOAD_RECORD_TYPE_COUNT];
+    for (const FCL_WORKLOAD_RECORD_HEADER* record : trace.Records()) {
+        if (NT_SUCCESS(record->Status) && (record->Flags & FCL_WORKLOAD_RECORD_FLAG_EXISTING) == 0) {
+            recorded[record->Type].push_back(trace.ToNanoseconds(record->Duration));
+        }
+    }
+
+    LatencySummary replayed[FCL_WORKLOAD_RECORD_TYPE_COUNT];
+    std::printf("%-18s %-9s %10s %10s %10s %10s %10s %10s  (us)\n", "type", "source", "count", "mean", "p50", "p90",
+        "p99", "max");
+    for (ULONG type = FCL_WORKLOAD_RECORD_GEOMETRY; type < FCL_WORKLOAD_RECORD_TYPE_COUNT; ++type) {
+        replayed[type] = Summarize(std::move(stats.Latency[type]));
+        if (recorded[type].empty() && replayed[type].Count == 0) {
+            continue;
+        }
+        PrintSummaryRow(kTypeNames[type], "recorded", Summarize(std::move(recorded[type])));
+        PrintSummaryRow(kTypeNames[type], options.Realtime ? "realtime" : "replay", replayed[type]);
+    }
+    std::printf("skipped %llu, failed %llu, result mismatches %llu (over %lu pass%s)\n",
+        stats.Skipped,
+        stats.Failed,
+        stats.Mismatches,
+        options.Repeat,
+        (options.Repeat == 1) ? "" : "es");
+
+    if (!options.ReportPath.empty() && !WriteReport(options.ReportPath, replayed)) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -1,12 +1,34 @@
-#include <cmath>
+﻿#include <cmath>
+#include <cstring>
+#include <thread>
 
+#include "fclmusa/broadphase.h"
 #include "fclmusa/collision.h"
+#include "fclmusa/diagnostics/latency_histogram.h"
+#include "fclmusa/diagnostics/phase_trace.h"
+#include "fclmusa/diagnostics/workload_recorder.h"
 #include "fclmusa/distance.h"
 #include "fclmusa/geometry.h"
+#include "fclmusa/geometry/bvh_model.h"
+#include "fclmusa/geometry/precompiled_mesh.h"
 #include "fclmusa/geometry/math_utils.h"
 #include "fclmusa/ioctl.h"
 #include "fclmusa/logging.h"
+#include "fclmusa/memory/alloc_profiler.h"
+#include "fclmusa/memory/dpc_reserve.h"
+#include "fclmusa/memory/pool_allocator.h"
+#include "fclmusa/memory/query_arena.h"
+#include "fclmusa/memory/slab_allocator.h"
+#include "fclmusa/narrowphase/analytic_ccd.h"
+#include "fclmusa/narrowphase/libccd_memory.h"
+#include "fclmusa/narrowphase/mpr_intersect.h"
+#include "fclmusa/narrowphase/query_dispatch.h"
 #include "fclmusa/platform.h"
+#include "fclmusa/point_query.h"
+#include "fclmusa/raycast.h"
+#include "fclmusa/shape_cast.h"
+#include "fclmusa/solver.h"
+#include "fclmusa/upstream/upstream_bridge.h"
 
 using fclmusa::geom::IdentityTransform;
 
@@ -37,6 +59,29 @@ NTSTATUS CreateSphere(float radius, GeometryHandle& out) noexcept {
     return FclCreateGeometry(FCL_GEOMETRY_SPHERE, &desc, &out.handle);
 }
 
+NTSTATUS CreateBoxMesh(float halfExtent, GeometryHandle& out) noexcept {
+    const float h = halfExtent;
+    const FCL_VECTOR3 vertices[] = {
+        {-h, -h, -h}, {h, -h, -h}, {h, h, -h}, {-h, h, -h},
+        {-h, -h, h}, {h, -h, h}, {h, h, h}, {-h, h, h},
+    };
+    const UINT32 indices[] = {
+        0, 2, 1, 0, 3, 2,
+        4, 5, 6, 4, 6, 7,
+        0, 1, 5, 0, 5, 4,
+        1, 2, 6, 1, 6, 5,
+        2, 3, 7, 2, 7, 6,
+        3, 0, 4, 3, 4, 7,
+    };
+    FCL_MESH_GEOMETRY_DESC desc = {};
+    desc.Vertices = vertices;
+    desc.VertexCount = static_cast<ULONG>(sizeof(vertices) / sizeof(vertices[0]));
+    desc.Indices = indices;
+    desc.IndexCount = static_cast<ULONG>(sizeof(indices) / sizeof(indices[0]));
+    out.Release();
+    return FclCreateGeometry(FCL_GEOMETRY_MESH, &desc, &out.handle);
+}
+
 bool RunInvalidDescriptorTest() noexcept {
     FCL_GEOMETRY_HANDLE unused = {};
     const NTSTATUS status = FclCreateGeometry(FCL_GEOMETRY_SPHERE, nullptr, &unused);
@@ -155,29 +200,2716 @@ bool RunDistanceSuite() noexcept {
     return true;
 }
 
-}  // namespace
+FCL_GEOMETRY_SNAPSHOT MakeSphereSnapshot(float radius) noexcept {
+    FCL_GEOMETRY_SNAPSHOT snapshot = {};
+    snapshot.Type = FCL_GEOMETRY_SPHERE;
+    snapshot.Data.Sphere.Center = {0.0f, 0.0f, 0.0f};
+    snapshot.Data.Sphere.Radius = radius;
+    return snapshot;
+}
 
-int main() {
-    NTSTATUS status = FclGeometrySubsystemInitialize();
+FCL_GEOMETRY_SNAPSHOT MakeBoxSnapshot(const FCL_VECTOR3& extents) noexcept {
+    FCL_GEOMETRY_SNAPSHOT snapshot = {};
+    snapshot.Type = FCL_GEOMETRY_OBB;
+    snapshot.Data.Obb.Center = {0.0f, 0.0f, 0.0f};
+    snapshot.Data.Obb.Extents = extents;
+    snapshot.Data.Obb.Rotation = IdentityTransform().Rotation;
+    return snapshot;
+}
+
+// alongX 为真时轴线沿 X（局部 Z 旋转到世界 X），否则沿 Z。
+FCL_GEOMETRY_SNAPSHOT MakeCapsuleSnapshot(float radius, float halfLength, bool alongX) noexcept {
+    FCL_GEOMETRY_SNAPSHOT snapshot = {};
+    snapshot.Type = FCL_GEOMETRY_CAPSULE;
+    snapshot.Data.Capsule.Center = {0.0f, 0.0f, 0.0f};
+    snapshot.Data.Capsule.Rotation = IdentityTransform().Rotation;
+    if (alongX) {
+        snapshot.Data.Capsule.Rotation = {{{0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}}};
+    }
+    snapshot.Data.Capsule.Radius = radius;
+    snapshot.Data.Capsule.HalfLength = halfLength;
+    return snapshot;
+}
+
+FCL_TRANSFORM MakeRotatedTransform(float angleZ, const FCL_VECTOR3& translation) noexcept {
+    FCL_TRANSFORM transform = IdentityTransform();
+    const float c = std::cos(angleZ);
+    const float s = std::sin(angleZ);
+    transform.Rotation.M[0][0] = c;
+    transform.Rotation.M[0][1] = -s;
+    transform.Rotation.M[1][0] = s;
+    transform.Rotation.M[1][1] = c;
+    transform.Translation = translation;
+    return transform;
+}
+
+bool VerifyNativeKernelParity(
+    const char* label,
+    const FCL_GEOMETRY_SNAPSHOT& object1,
+    const FCL_TRANSFORM& transform1,
+    const FCL_GEOMETRY_SNAPSHOT& object2,
+    const FCL_TRANSFORM& transform2) noexcept {
+    BOOLEAN upstreamHit = FALSE;
+    FCL_CONTACT_INFO upstreamContact = {};
+    NTSTATUS status = FclUpstreamCollide(object1, transform1, object2, transform2, &upstreamHit, &upstreamContact);
     if (!NT_SUCCESS(status)) {
-        FCL_LOG_ERROR("FclGeometrySubsystemInitialize failed: 0x%X", status);
-        return 1;
+        FCL_LOG_ERROR("%s: FclUpstreamCollide failed: 0x%X", label, status);
+        return false;
     }
 
-    struct SubsystemGuard {
-        ~SubsystemGuard() {
-            FclGeometrySubsystemShutdown();
+    BOOLEAN nativeHit = FALSE;
+    status = fclmusa::narrowphase::DispatchCollision(object1, transform1, object2, transform2, &nativeHit, nullptr);
+    if (!NT_SUCCESS(status) || nativeHit != upstreamHit) {
+        FCL_LOG_ERROR("%s: boolean dispatch mismatch (status 0x%X, got %d expected %d)", label, status, nativeHit, upstreamHit);
+        return false;
+    }
+
+    FCL_CONTACT_INFO nativeContact = {};
+    status = fclmusa::narrowphase::DispatchCollision(object1, transform1, object2, transform2, &nativeHit, &nativeContact);
+    if (!NT_SUCCESS(status) || nativeHit != upstreamHit) {
+        FCL_LOG_ERROR("%s: contact dispatch mismatch (status 0x%X)", label, status);
+        return false;
+    }
+    if (nativeHit && std::fabs(nativeContact.PenetrationDepth - upstreamContact.PenetrationDepth) > 1e-3f) {
+        FCL_LOG_ERROR(
+            "%s: penetration mismatch %.6f vs %.6f",
+            label,
+            nativeContact.PenetrationDepth,
+            upstreamContact.PenetrationDepth);
+        return false;
+    }
+
+    FCL_DISTANCE_RESULT upstreamDistance = {};
+    FCL_DISTANCE_RESULT nativeDistance = {};
+    status = FclUpstreamDistance(object1, transform1, object2, transform2, &upstreamDistance);
+    if (!NT_SUCCESS(status)) {
+        FCL_LOG_ERROR("%s: FclUpstreamDistance failed: 0x%X", label, status);
+        return false;
+    }
+    status = fclmusa::narrowphase::DispatchDistance(object1, transform1, object2, transform2, &nativeDistance);
+    if (!NT_SUCCESS(status)) {
+        FCL_LOG_ERROR("%s: DispatchDistance failed: 0x%X", label, status);
+        return false;
+    }
+    if (!upstreamHit && std::fabs(nativeDistance.Distance - upstreamDistance.Distance) > 1e-3f) {
+        FCL_LOG_ERROR("%s: distance mismatch %.6f vs %.6f", label, nativeDistance.Distance, upstreamDistance.Distance);
+        return false;
+    }
+    return true;
+}
+
+bool RunNativeKernelParitySuite() noexcept {
+    const FCL_GEOMETRY_SNAPSHOT sphere = MakeSphereSnapshot(0.75f);
+    const FCL_GEOMETRY_SNAPSHOT box = MakeBoxSnapshot({1.0f, 0.5f, 0.25f});
+    const FCL_GEOMETRY_SNAPSHOT capsuleZ = MakeCapsuleSnapshot(0.25f, 0.5f, false);
+    const FCL_GEOMETRY_SNAPSHOT capsuleX = MakeCapsuleSnapshot(0.25f, 0.5f, true);
+    const FCL_TRANSFORM origin = IdentityTransform();
+
+    const struct {
+        const char* Label;
+        const FCL_GEOMETRY_SNAPSHOT* Object1;
+        const FCL_GEOMETRY_SNAPSHOT* Object2;
+        FCL_TRANSFORM Transform2;
+    } cases[] = {
+        {"sphere/sphere separated", &sphere, &sphere, MakeRotatedTransform(0.0f, {2.0f, 0.0f, 0.0f})},
+        {"sphere/sphere overlap", &sphere, &sphere, MakeRotatedTransform(0.0f, {1.0f, 0.2f, 0.0f})},
+        {"sphere/box separated", &sphere, &box, MakeRotatedTransform(0.5f, {0.0f, 2.0f, 0.0f})},
+        {"sphere/box face", &sphere, &box, MakeRotatedTransform(0.0f, {0.0f, 1.0f, 0.0f})},
+        {"sphere/box interior", &sphere, &box, MakeRotatedTransform(0.3f, {0.1f, 0.05f, 0.0f})},
+        {"box/sphere edge", &box, &sphere, MakeRotatedTransform(0.0f, {1.3f, 0.7f, 0.0f})},
+        {"box/box separated", &box, &box, MakeRotatedTransform(0.7853982f, {0.0f, 2.0f, 0.0f})},
+        {"box/box overlap", &box, &box, MakeRotatedTransform(0.7853982f, {1.5f, 0.5f, 0.0f})},
+        {"capsule/capsule separated", &capsuleX, &capsuleZ, MakeRotatedTransform(0.0f, {0.3f, 0.7f, 0.0f})},
+        {"capsule/capsule overlap", &capsuleX, &capsuleZ, MakeRotatedTransform(0.0f, {0.2f, 0.4f, 0.0f})},
+        {"capsule/capsule parallel", &capsuleZ, &capsuleZ, MakeRotatedTransform(0.0f, {0.8f, 0.0f, 0.3f})},
+        {"sphere/capsule separated", &sphere, &capsuleX, MakeRotatedTransform(0.4f, {0.0f, 1.5f, 0.0f})},
+        {"sphere/capsule overlap", &sphere, &capsuleX, MakeRotatedTransform(0.0f, {0.0f, 0.9f, 0.3f})},
+        {"capsule/box separated", &capsuleZ, &box, MakeRotatedTransform(0.3f, {0.0f, 1.2f, 0.0f})},
+        {"capsule/box edge", &capsuleZ, &box, MakeRotatedTransform(0.7853982f, {1.2f, 0.3f, 0.0f})},
+        {"box/capsule face", &box, &capsuleX, MakeRotatedTransform(0.0f, {0.0f, 0.7f, 0.0f})},
+    };
+
+    for (const auto& testCase : cases) {
+        if (!VerifyNativeKernelParity(testCase.Label, *testCase.Object1, origin, *testCase.Object2, testCase.Transform2)) {
+            return false;
         }
-    } guard;
+    }
+    return true;
+}
 
-    if (!RunInvalidDescriptorTest()) {
-        return 10;
+bool RunCoherenceCacheSuite() noexcept {
+    if (!NT_SUCCESS(FclCoherenceCacheConfigure(64))) {
+        return false;
     }
-    if (!RunSphereCollisionSuite()) {
-        return 11;
+    struct CacheGuard {
+        ~CacheGuard() {
+            FclCoherenceCacheConfigure(0);
+        }
+    } cacheGuard;
+
+    GeometryHandle a;
+    GeometryHandle b;
+    if (!NT_SUCCESS(CreateSphere(0.5f, a)) || !NT_SUCCESS(CreateSphere(0.5f, b))) {
+        return false;
     }
-    if (!RunDistanceSuite()) {
-        return 12;
+
+    const FCL_TRANSFORM transformA = IdentityTransform();
+    FCL_TRANSFORM transformB = IdentityTransform();
+    transformB.Translation.X = 3.0f;
+
+    // 第一次计算并记录分离轴，随后小幅移动仍应命中缓存。
+    for (int frame = 0; frame < 4; ++frame) {
+        transformB.Translation.X = 3.0f - 0.1f * static_cast<float>(frame);
+        BOOLEAN isColliding = TRUE;
+        if (!NT_SUCCESS(FclCollisionDetect(a.handle, &transformA, b.handle, &transformB, &isColliding, nullptr)) ||
+            isColliding) {
+            FCL_LOG_ERROR("Coherence cache: separated frame %d reported collision", frame);
+            return false;
+        }
+    }
+
+    FCL_COHERENCE_CACHE_STATS stats = {};
+    if (!NT_SUCCESS(FclCoherenceCacheQueryStats(&stats)) || stats.SeparatingAxisHits < 3) {
+        FCL_LOG_ERROR("Coherence cache: expected separating-axis hits, got %llu", stats.SeparatingAxisHits);
+        return false;
+    }
+
+    // 缓存轴失效后必须回落到窄阶段，给出正确的碰撞结果。
+    transformB.Translation.X = 0.5f;
+    BOOLEAN isColliding = FALSE;
+    if (!NT_SUCCESS(FclCollisionDetect(a.handle, &transformA, b.handle, &transformB, &isColliding, nullptr)) ||
+        !isColliding) {
+        FCL_LOG_ERROR("Coherence cache: overlapping pair not detected");
+        return false;
+    }
+
+    // 精确距离查询记录最近点；下一帧小幅平移后，上下界之差落在 AbsoluteError 内应直接复用。
+    FCL_DISTANCE_REQUEST request = {};
+    request.AbsoluteError = 0.05f;
+    FCL_DISTANCE_QUERY_RESULT distance = {};
+    transformB.Translation.X = 3.0f;
+    if (!NT_SUCCESS(FclDistanceQuery(a.handle, &transformA, b.handle, &transformB, &request, &distance))) {
+        FCL_LOG_ERROR("Coherence cache: distance query failed");
+        return false;
+    }
+    transformB.Translation.X = 3.02f;
+    if (!NT_SUCCESS(FclDistanceQuery(a.handle, &transformA, b.handle, &transformB, &request, &distance)) ||
+        !distance.NearestPointsValid || std::fabs(distance.Result.Distance - 2.02f) > request.AbsoluteError) {
+        FCL_LOG_ERROR("Coherence cache: reused distance %.6f vs 2.02", distance.Result.Distance);
+        return false;
+    }
+    if (!NT_SUCCESS(FclCoherenceCacheQueryStats(&stats)) || stats.DistanceReuses == 0) {
+        FCL_LOG_ERROR("Coherence cache: expected a distance reuse");
+        return false;
+    }
+
+    FclCoherenceCacheInvalidateGeometry(a.handle);
+    if (!NT_SUCCESS(FclCoherenceCacheQueryStats(&stats)) || stats.EntryCount != 0) {
+        FCL_LOG_ERROR("Coherence cache: invalidation left %lu entries", stats.EntryCount);
+        return false;
+    }
+    return true;
+}
+
+bool VerifyThresholdQuery(
+    const char* label,
+    const FCL_GEOMETRY_SNAPSHOT& object1,
+    const FCL_GEOMETRY_SNAPSHOT& object2,
+    const FCL_TRANSFORM& transform2,
+    const FCL_DISTANCE_REQUEST& request,
+    BOOLEAN expectBeyond,
+    float expectedDistance) noexcept {
+    const FCL_TRANSFORM origin = IdentityTransform();
+    FCL_DISTANCE_QUERY_RESULT result = {};
+    const NTSTATUS status = FclDistanceQueryCoreFromSnapshots(&object1, &origin, &object2, &transform2, &request, &result);
+    if (!NT_SUCCESS(status) || result.BeyondThreshold != expectBeyond) {
+        FCL_LOG_ERROR("%s: threshold query mismatch (status 0x%X, beyond %d)", label, status, result.BeyondThreshold);
+        return false;
+    }
+    if (expectBeyond) {
+        if (result.Result.Distance < request.DistanceThreshold || result.NearestPointsValid) {
+            FCL_LOG_ERROR("%s: beyond-threshold bound %.6f invalid", label, result.Result.Distance);
+            return false;
+        }
+        return true;
+    }
+    if (std::fabs(result.Result.Distance - expectedDistance) > 1e-3f) {
+        FCL_LOG_ERROR("%s: distance %.6f vs %.6f", label, result.Result.Distance, expectedDistance);
+        return false;
+    }
+    const bool wantPoints = (request.Flags & FCL_DISTANCE_FLAG_SKIP_NEAREST_POINTS) == 0;
+    if ((result.NearestPointsValid != FALSE) != wantPoints) {
+        FCL_LOG_ERROR("%s: nearest-point flag mismatch", label);
+        return false;
+    }
+    return true;
+}
+
+bool RunDistanceThresholdSuite() noexcept {
+    const FCL_GEOMETRY_SNAPSHOT sphere = MakeSphereSnapshot(0.5f);
+    const FCL_GEOMETRY_SNAPSHOT box = MakeBoxSnapshot({0.5f, 0.5f, 0.5f});
+
+    FCL_DISTANCE_REQUEST request = {};
+    request.DistanceThreshold = 0.05f;
+
+    // 原生内核路径：包围体间隙 1.0 直接判定远于阈值；间隙 0.02 需给出精确距离。
+    if (!VerifyThresholdQuery("sphere/sphere far", sphere, sphere, MakeRotatedTransform(0.0f, {2.0f, 0.0f, 0.0f}), request, TRUE, 0.0f) ||
+        !VerifyThresholdQuery("sphere/sphere near", sphere, sphere, MakeRotatedTransform(0.0f, {1.02f, 0.0f, 0.0f}), request, FALSE, 0.02f)) {
+        return false;
+    }
+
+    // upstream 路径（box/box 无原生距离内核）：阈值作为 BVH 遍历上界。
+    if (!VerifyThresholdQuery("box/box far", box, box, MakeRotatedTransform(0.3f, {0.0f, 2.0f, 0.0f}), request, TRUE, 0.0f) ||
+        !VerifyThresholdQuery("box/box near", box, box, MakeRotatedTransform(0.0f, {0.0f, 1.02f, 0.0f}), request, FALSE, 0.02f)) {
+        return false;
+    }
+    // 包围体下界不足以排除、但真实距离仍超过阈值：结果应由窄阶段确认。
+    // 包围体最优间隙约 0.385，真实距离约 0.394。
+    request.DistanceThreshold = 0.39f;
+    if (!VerifyThresholdQuery("box/sphere corner", box, sphere, MakeRotatedTransform(0.0f, {1.3f, 0.9f, 0.0f}), request, TRUE, 0.0f)) {
+        return false;
+    }
+
+    request.DistanceThreshold = 0.0f;
+    request.Flags = FCL_DISTANCE_FLAG_SKIP_NEAREST_POINTS;
+    if (!VerifyThresholdQuery("box/box no points", box, box, MakeRotatedTransform(0.0f, {0.0f, 3.0f, 0.0f}), request, FALSE, 2.0f)) {
+        return false;
+    }
+
+    request.RelativeError = -1.0f;
+    FCL_DISTANCE_QUERY_RESULT rejected = {};
+    const FCL_TRANSFORM origin = IdentityTransform();
+    if (FclDistanceQueryCoreFromSnapshots(&box, &origin, &box, &origin, &request, &rejected) != STATUS_INVALID_PARAMETER) {
+        FCL_LOG_ERROR("Negative relative error should be rejected");
+        return false;
+    }
+    return true;
+}
+
+bool RunContactManifoldSuite() noexcept {
+    GeometryHandle meshA;
+    GeometryHandle meshB;
+    if (!NT_SUCCESS(CreateBoxMesh(1.0f, meshA)) || !NT_SUCCESS(CreateBoxMesh(1.0f, meshB))) {
+        return false;
+    }
+
+    FCL_COLLISION_OBJECT_DESC objectA = {};
+    objectA.Geometry = meshA.handle;
+    objectA.Transform = IdentityTransform();
+    FCL_COLLISION_OBJECT_DESC objectB = {};
+    objectB.Geometry = meshB.handle;
+    objectB.Transform = MakeRotatedTransform(0.2f, {1.8f, 0.3f, 0.0f});
+
+    constexpr ULONG kCapacity = 4;
+    FCL_CONTACT_INFO contacts[kCapacity] = {};
+    FCL_COLLISION_QUERY_REQUEST request = {};
+    request.MaxContacts = kCapacity;
+    request.EnableContactInfo = TRUE;
+    request.Contacts = contacts;
+
+    FCL_COLLISION_QUERY_RESULT result = {};
+    NTSTATUS status = FclCollideObjects(&objectA, &objectB, &request, &result);
+    if (!NT_SUCCESS(status) || !result.Intersecting || result.ContactCount < 2 || result.ContactCount > kCapacity) {
+        FCL_LOG_ERROR("Manifold: status 0x%X, intersecting %d, count %lu", status, result.Intersecting, result.ContactCount);
+        return false;
+    }
+
+    // contacts[0] 为最深点，其余点互不重合。
+    for (ULONG i = 1; i < result.ContactCount; ++i) {
+        if (contacts[i].PenetrationDepth > contacts[0].PenetrationDepth + kTolerance) {
+            FCL_LOG_ERROR("Manifold: contact %lu deeper than contact 0", i);
+            return false;
+        }
+        for (ULONG j = 0; j < i; ++j) {
+            const FCL_VECTOR3 delta = fclmusa::geom::Subtract(contacts[i].PointOnObject1, contacts[j].PointOnObject1);
+            if (fclmusa::geom::Length(delta) <= kTolerance) {
+                FCL_LOG_ERROR("Manifold: contacts %lu and %lu coincide", i, j);
+                return false;
+            }
+        }
+    }
+    if (std::fabs(result.Contact.PenetrationDepth - contacts[0].PenetrationDepth) > kTolerance) {
+        FCL_LOG_ERROR("Manifold: result.Contact should mirror contacts[0]");
+        return false;
+    }
+
+    // 未提供数组时保持单接触点语义。
+    request.Contacts = nullptr;
+    status = FclCollideObjects(&objectA, &objectB, &request, &result);
+    if (!NT_SUCCESS(status) || !result.Intersecting || result.ContactCount != 1) {
+        FCL_LOG_ERROR("Manifold: single-contact fallback returned %lu contacts", result.ContactCount);
+        return false;
+    }
+    return true;
+}
+
+bool RunMprParitySuite() noexcept {
+    GeometryHandle mesh;
+    FCL_GEOMETRY_REFERENCE reference = {};
+    FCL_GEOMETRY_SNAPSHOT cube = {};
+    if (!NT_SUCCESS(CreateBoxMesh(0.5f, mesh)) ||
+        !NT_SUCCESS(FclAcquireGeometryReference(mesh.handle, &reference, &cube))) {
+        return false;
+    }
+    struct ReferenceGuard {
+        FCL_GEOMETRY_REFERENCE* Reference;
+        ~ReferenceGuard() {
+            FclReleaseGeometryReference(Reference);
+        }
+    } referenceGuard{&reference};
+
+    const FCL_GEOMETRY_SNAPSHOT sphere = MakeSphereSnapshot(0.5f);
+    const FCL_GEOMETRY_SNAPSHOT box = MakeBoxSnapshot({0.5f, 0.5f, 0.5f});
+    const FCL_TRANSFORM origin = IdentityTransform();
+
+    // 位姿远离接触边界，避免容差差异导致的误报。
+    const struct {
+        const char* Label;
+        const FCL_GEOMETRY_SNAPSHOT* Object1;
+        const FCL_GEOMETRY_SNAPSHOT* Object2;
+        FCL_TRANSFORM Transform2;
+    } cases[] = {
+        {"mpr sphere/box overlap", &sphere, &box, MakeRotatedTransform(0.4f, {0.7f, 0.2f, 0.0f})},
+        {"mpr sphere/box separated", &sphere, &box, MakeRotatedTransform(0.4f, {1.4f, 0.2f, 0.0f})},
+        {"mpr box/box overlap", &box, &box, MakeRotatedTransform(0.7853982f, {1.1f, 0.3f, 0.0f})},
+        {"mpr box/box separated", &box, &box, MakeRotatedTransform(0.7853982f, {1.4f, 0.3f, 0.0f})},
+        {"mpr sphere/mesh overlap", &sphere, &cube, MakeRotatedTransform(0.3f, {0.8f, 0.0f, 0.1f})},
+        {"mpr sphere/mesh separated", &sphere, &cube, MakeRotatedTransform(0.3f, {1.3f, 0.0f, 0.1f})},
+        {"mpr mesh/mesh overlap", &cube, &cube, MakeRotatedTransform(0.5f, {0.9f, 0.4f, 0.0f})},
+        {"mpr mesh/mesh separated", &cube, &cube, MakeRotatedTransform(0.5f, {1.0f, 1.3f, 0.0f})},
+    };
+
+    for (const auto& testCase : cases) {
+        BOOLEAN expected = FALSE;
+        NTSTATUS status = FclUpstreamCollide(*testCase.Object1, origin, *testCase.Object2, testCase.Transform2, &expected, nullptr);
+        if (!NT_SUCCESS(status)) {
+            FCL_LOG_ERROR("%s: FclUpstreamCollide failed: 0x%X", testCase.Label, status);
+            return false;
+        }
+        BOOLEAN mpr = FALSE;
+        status = fclmusa::narrowphase::MprIntersect(*testCase.Object1, origin, *testCase.Object2, testCase.Transform2, &mpr);
+        if (!NT_SUCCESS(status) || mpr != expected) {
+            FCL_LOG_ERROR("%s: MPR mismatch (status 0x%X, got %d expected %d)", testCase.Label, status, mpr, expected);
+            return false;
+        }
+        BOOLEAN dispatched = FALSE;
+        status = fclmusa::narrowphase::DispatchCollision(*testCase.Object1, origin, *testCase.Object2, testCase.Transform2, &dispatched, nullptr);
+        if (!NT_SUCCESS(status) || dispatched != expected) {
+            FCL_LOG_ERROR("%s: dispatch mismatch (status 0x%X)", testCase.Label, status);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RunSolverSelectionSuite() noexcept {
+    const FCL_GEOMETRY_SNAPSHOT box = MakeBoxSnapshot({0.5f, 0.5f, 0.5f});
+    const FCL_TRANSFORM origin = IdentityTransform();
+    const FCL_TRANSFORM pose = MakeRotatedTransform(0.6f, {1.6f, 0.4f, 0.0f});
+
+    // box/box 无原生距离内核，两种 GJK 实现应给出一致的距离。
+    const FCL_SOLVER_OPTIONS libccd = {FCL_GJK_SOLVER_LIBCCD, 0.0, 0};
+    const FCL_SOLVER_OPTIONS indep = {FCL_GJK_SOLVER_INDEP, 0.0, 0};
+    FCL_DISTANCE_RESULT libccdResult = {};
+    FCL_DISTANCE_RESULT indepResult = {};
+    if (!NT_SUCCESS(FclUpstreamDistance(box, origin, box, pose, &libccdResult, &libccd)) ||
+        !NT_SUCCESS(FclUpstreamDistance(box, origin, box, pose, &indepResult, &indep))) {
+        FCL_LOG_ERROR("Solver selection: distance query failed");
+        return false;
+    }
+    if (std::fabs(libccdResult.Distance - indepResult.Distance) > 1e-3f) {
+        FCL_LOG_ERROR("Solver selection: libccd %f vs indep %f", libccdResult.Distance, indepResult.Distance);
+        return false;
+    }
+
+    FCL_DISTANCE_REQUEST request = {};
+    request.Solver.Solver = static_cast<FCL_GJK_SOLVER_TYPE>(7);
+    FCL_DISTANCE_QUERY_RESULT rejected = {};
+    if (FclDistanceQueryCoreFromSnapshots(&box, &origin, &box, &pose, &request, &rejected) != STATUS_INVALID_PARAMETER) {
+        FCL_LOG_ERROR("Unknown solver type should be rejected");
+        return false;
+    }
+
+    // 全局默认：DEFAULT 字段在设置时解析为 LIBCCD，NULL 恢复出厂值。
+    const FCL_SOLVER_OPTIONS tuned = {FCL_GJK_SOLVER_INDEP, 1e-7, 256};
+    FCL_SOLVER_OPTIONS queried = {};
+    if (!NT_SUCCESS(FclSetDefaultSolverOptions(&tuned)) ||
+        !NT_SUCCESS(FclQueryDefaultSolverOptions(&queried)) ||
+        queried.Solver != FCL_GJK_SOLVER_INDEP || queried.MaxIterations != 256) {
+        FCL_LOG_ERROR("Default solver options round trip failed");
+        return false;
+    }
+    request.Solver = {};
+    const NTSTATUS status = FclDistanceQueryCoreFromSnapshots(&box, &origin, &box, &pose, &request, &rejected);
+    FclSetDefaultSolverOptions(nullptr);
+    if (!NT_SUCCESS(status) || std::fabs(rejected.Result.Distance - libccdResult.Distance) > 1e-3f) {
+        FCL_LOG_ERROR("Query with default solver failed (status 0x%X)", status);
+        return false;
+    }
+    return NT_SUCCESS(FclQueryDefaultSolverOptions(&queried)) && queried.Solver == FCL_GJK_SOLVER_LIBCCD;
+}
+
+FCL_INTERP_MOTION MakeLinearMotion(float angleZ, const FCL_VECTOR3& from, const FCL_VECTOR3& to) noexcept {
+    FCL_INTERP_MOTION motion = {};
+    motion.Start = MakeRotatedTransform(angleZ, from);
+    motion.End = MakeRotatedTransform(angleZ, to);
+    return motion;
+}
+
+bool RunAnalyticCcdSuite() noexcept {
+    const FCL_GEOMETRY_SNAPSHOT sphere = MakeSphereSnapshot(0.5f);
+    const FCL_GEOMETRY_SNAPSHOT box = MakeBoxSnapshot({0.5f, 0.5f, 0.5f});
+
+    const struct {
+        const char* Label;
+        const FCL_GEOMETRY_SNAPSHOT* Object1;
+        FCL_INTERP_MOTION Motion1;
+        const FCL_GEOMETRY_SNAPSHOT* Object2;
+        FCL_INTERP_MOTION Motion2;
+    } cases[] = {
+        {"ccd sphere/sphere head-on", &sphere, MakeLinearMotion(0.0f, {-3.0f, 0.0f, 0.0f}, {3.0f, 0.0f, 0.0f}),
+         &sphere, MakeLinearMotion(0.0f, {0.0f, 0.3f, 0.0f}, {0.0f, 0.3f, 0.0f})},
+        {"ccd sphere/sphere miss", &sphere, MakeLinearMotion(0.0f, {-3.0f, 1.2f, 0.0f}, {3.0f, 1.2f, 0.0f}),
+         &sphere, MakeLinearMotion(0.0f, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f})},
+        {"ccd sphere/box corner", &sphere, MakeLinearMotion(0.0f, {-3.0f, 0.8f, 0.0f}, {3.0f, 0.8f, 0.0f}),
+         &box, MakeLinearMotion(0.7853982f, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f})},
+        {"ccd box/sphere both moving", &box, MakeLinearMotion(0.4f, {0.0f, -2.0f, 0.0f}, {0.0f, 1.0f, 0.0f}),
+         &sphere, MakeLinearMotion(0.0f, {2.0f, 0.5f, 0.0f}, {-1.0f, 0.5f, 0.0f})},
+        {"ccd box/box rotated", &box, MakeLinearMotion(0.3f, {-3.0f, 0.2f, 0.0f}, {3.0f, 0.2f, 0.0f}),
+         &box, MakeLinearMotion(0.9f, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f})},
+    };
+
+    for (const auto& testCase : cases) {
+        FCL_CONTINUOUS_COLLISION_RESULT expected = {};
+        NTSTATUS status = FclUpstreamContinuousCollision(
+            *testCase.Object1, testCase.Motion1, *testCase.Object2, testCase.Motion2, 1.0e-5, 256, &expected);
+        if (!NT_SUCCESS(status)) {
+            FCL_LOG_ERROR("%s: upstream CCD failed: 0x%X", testCase.Label, status);
+            return false;
+        }
+        FCL_CONTINUOUS_COLLISION_RESULT analytic = {};
+        if (!fclmusa::narrowphase::TryAnalyticContinuousCollision(
+                *testCase.Object1, testCase.Motion1, *testCase.Object2, testCase.Motion2, &analytic)) {
+            FCL_LOG_ERROR("%s: analytic CCD not applied", testCase.Label);
+            return false;
+        }
+        if (analytic.Intersecting != expected.Intersecting ||
+            (expected.Intersecting && std::fabs(analytic.TimeOfImpact - expected.TimeOfImpact) > 1e-2)) {
+            FCL_LOG_ERROR(
+                "%s: TOI mismatch (analytic %d %f, upstream %d %f)",
+                testCase.Label,
+                analytic.Intersecting,
+                analytic.TimeOfImpact,
+                expected.Intersecting,
+                expected.TimeOfImpact);
+            return false;
+        }
+    }
+
+    // 盒体旋转时必须回退到保守推进。
+    FCL_INTERP_MOTION spinning = MakeLinearMotion(0.0f, {-3.0f, 0.0f, 0.0f}, {3.0f, 0.0f, 0.0f});
+    spinning.End = MakeRotatedTransform(1.0f, spinning.End.Translation);
+    FCL_CONTINUOUS_COLLISION_RESULT ignored = {};
+    if (fclmusa::narrowphase::TryAnalyticContinuousCollision(box, spinning, box, MakeLinearMotion(0.0f, {}, {}), &ignored)) {
+        FCL_LOG_ERROR("Analytic CCD must not handle rotating boxes");
+        return false;
+    }
+
+    // 回退到 upstream 的组合同样给出 TOI 时刻的接触法线（对象 1 指向对象 2）。
+    const FCL_INTERP_MOTION still = MakeLinearMotion(0.0f, {}, {});
+    FCL_CONTINUOUS_COLLISION_RESULT fallback = {};
+    if (!NT_SUCCESS(FclContinuousCollisionCoreFromSnapshots(&box, &spinning, &box, &still, 1.0e-4, 64, &fallback)) ||
+        !fallback.Intersecting || fallback.Contact.Normal.X <= 0.5f) {
+        FCL_LOG_ERROR("Upstream CCD contact normal missing (%.3f, %.3f, %.3f)",
+            fallback.Contact.Normal.X, fallback.Contact.Normal.Y, fallback.Contact.Normal.Z);
+        return false;
+    }
+    return true;
+}
+
+bool TransformsClose(const FCL_TRANSFORM& a, const FCL_TRANSFORM& b, float tolerance) noexcept {
+    for (int row = 0; row < 3; ++row) {
+        for (int column = 0; column < 3; ++column) {
+            if (std::fabs(a.Rotation.M[row][column] - b.Rotation.M[row][column]) > tolerance) {
+                return false;
+            }
+        }
+    }
+    return std::fabs(a.Translation.X - b.Translation.X) <= tolerance &&
+           std::fabs(a.Translation.Y - b.Translation.Y) <= tolerance &&
+           std::fabs(a.Translation.Z - b.Translation.Z) <= tolerance;
+}
+
+bool RunScrewCcdSuite() noexcept {
+    const FCL_GEOMETRY_SNAPSHOT box = MakeBoxSnapshot({1.5f, 0.1f, 0.1f});
+    const FCL_GEOMETRY_SNAPSHOT sphere = MakeSphereSnapshot(0.3f);
+
+    // Initialize / Evaluate 往返：t = 0 / 1 还原起止位姿。
+    FCL_SCREW_MOTION_DESC desc = {};
+    desc.Start = MakeRotatedTransform(0.2f, {1.0f, -0.5f, 0.3f});
+    desc.End = MakeRotatedTransform(1.9f, {-0.4f, 0.8f, 0.6f});
+    FCL_SCREW_MOTION sweeping = {};
+    FCL_TRANSFORM start = {};
+    FCL_TRANSFORM end = {};
+    if (!NT_SUCCESS(FclScrewMotionInitialize(&desc, &sweeping)) ||
+        !NT_SUCCESS(FclScrewMotionEvaluate(&sweeping, 0.0, &start)) ||
+        !NT_SUCCESS(FclScrewMotionEvaluate(&sweeping, 1.0, &end)) ||
+        !TransformsClose(start, desc.Start, 1e-4f) ||
+        !TransformsClose(end, desc.End, 1e-4f)) {
+        FCL_LOG_ERROR("Screw motion round trip failed");
+        return false;
+    }
+
+    // 细长杆绕 Z 轴扫过 π，起止位姿都不与球体相交，但中途必然扫过。
+    FCL_SCREW_MOTION spinning = {};
+    spinning.Start = IdentityTransform();
+    spinning.Axis = {0.0f, 0.0f, 1.0f};
+    spinning.AngularVelocity = 3.1415927f;
+    FCL_SCREW_MOTION still = {};
+    still.Start = MakeRotatedTransform(0.0f, {0.0f, 1.0f, 0.0f});
+    still.Axis = {1.0f, 0.0f, 0.0f};
+
+    FCL_CONTINUOUS_COLLISION_RESULT result = {};
+    NTSTATUS status = FclScrewContinuousCollisionCoreFromSnapshots(&box, &spinning, &sphere, &still, 1.0e-4, 256, &result);
+    if (!NT_SUCCESS(status) || !result.Intersecting || result.TimeOfImpact <= 0.0 || result.TimeOfImpact >= 1.0) {
+        FCL_LOG_ERROR("Screw CCD missed sweeping rod (status 0x%X, toi %f)", status, result.TimeOfImpact);
+        return false;
+    }
+
+    // 扫掠包围球早退：远处的物体直接返回 TOI = 1。
+    still.Start.Translation = {0.0f, 10.0f, 0.0f};
+    status = FclScrewContinuousCollisionCoreFromSnapshots(&box, &spinning, &sphere, &still, 1.0e-4, 256, &result);
+    if (!NT_SUCCESS(status) || result.Intersecting || result.TimeOfImpact != 1.0) {
+        FCL_LOG_ERROR("Screw CCD early-out failed (status 0x%X)", status);
+        return false;
+    }
+
+    spinning.Axis = {0.0f, 0.0f, 2.0f};
+    if (FclScrewContinuousCollisionCoreFromSnapshots(&box, &spinning, &sphere, &still, 0.0, 0, &result) != STATUS_INVALID_PARAMETER) {
+        FCL_LOG_ERROR("Screw CCD accepted non-unit axis");
+        return false;
+    }
+    return true;
+}
+
+bool RunContinuousBatchSuite() noexcept {
+    GeometryHandle sphere;
+    GeometryHandle box;
+    if (!NT_SUCCESS(CreateSphere(0.5f, sphere)) || !NT_SUCCESS(CreateBoxMesh(0.5f, box))) {
+        FCL_LOG_ERROR("Failed to create batch CCD geometry");
+        return false;
+    }
+
+    // 一排球体两两相向运动（偶数向 +X，奇数向 -X），末尾追加一个远处旋转的 Mesh 盒。
+    constexpr ULONG kSphereCount = 32;
+    FCL_CONTINUOUS_BATCH_OBJECT objects[kSphereCount + 1] = {};
+    for (ULONG i = 0; i < kSphereCount; ++i) {
+        const float x = 1.5f * static_cast<float>(i);
+        const float step = (i % 2 == 0) ? 0.8f : -0.8f;
+        objects[i].Handle = sphere.handle;
+        objects[i].Motion = MakeLinearMotion(0.0f, {x, 0.0f, 0.0f}, {x + step, 0.0f, 0.0f});
+    }
+    objects[kSphereCount].Handle = box.handle;
+    objects[kSphereCount].Motion = MakeLinearMotion(0.0f, {0.0f, 20.0f, 0.0f}, {0.0f, 20.0f, 0.0f});
+    objects[kSphereCount].Motion.End = MakeRotatedTransform(1.2f, {4.0f, 20.0f, 0.0f});
+
+    FCL_CONTINUOUS_BATCH_QUERY query = {};
+    query.Objects = objects;
+    query.ObjectCount = RTL_NUMBER_OF(objects);
+    FCL_CONTINUOUS_BATCH_HIT hits[RTL_NUMBER_OF(objects)] = {};
+    FCL_CONTINUOUS_BATCH_RESULT batch = {};
+    NTSTATUS status = FclContinuousCollisionBatch(&query, hits, &batch);
+    if (!NT_SUCCESS(status)) {
+        FCL_LOG_ERROR("FclContinuousCollisionBatch failed: 0x%X", status);
+        return false;
+    }
+    if (batch.CandidatePairCount >= query.ObjectCount * (query.ObjectCount - 1) / 2 ||
+        batch.HitPairCount != kSphereCount / 2 ||
+        batch.Object1 % 2 != 0 || batch.Object2 != batch.Object1 + 1 ||
+        std::fabs(batch.Earliest.TimeOfImpact - 0.3125) > 1e-3) {
+        FCL_LOG_ERROR(
+            "Batch CCD summary mismatch (candidates %lu, hits %lu, earliest %lu/%lu)",
+            batch.CandidatePairCount,
+            batch.HitPairCount,
+            batch.Object1,
+            batch.Object2);
+        return false;
+    }
+
+    // 与逐对 FclContinuousCollision 的暴力结果对照每个对象的最早 TOI。
+    for (ULONG i = 0; i < query.ObjectCount; ++i) {
+        double earliest = 1.0;
+        ULONG partner = FCL_CONTINUOUS_BATCH_NO_HIT;
+        for (ULONG j = 0; j < query.ObjectCount; ++j) {
+            if (j == i) {
+                continue;
+            }
+            FCL_CONTINUOUS_COLLISION_QUERY pairQuery = {};
+            pairQuery.Object1 = objects[i].Handle;
+            pairQuery.Motion1 = objects[i].Motion;
+            pairQuery.Object2 = objects[j].Handle;
+            pairQuery.Motion2 = objects[j].Motion;
+            FCL_CONTINUOUS_COLLISION_RESULT pairResult = {};
+            status = FclContinuousCollision(&pairQuery, &pairResult);
+            if (!NT_SUCCESS(status)) {
+                FCL_LOG_ERROR("Pairwise CCD failed: 0x%X", status);
+                return false;
+            }
+            if (pairResult.Intersecting && (partner == FCL_CONTINUOUS_BATCH_NO_HIT || pairResult.TimeOfImpact < earliest)) {
+                earliest = pairResult.TimeOfImpact;
+                partner = j;
+            }
+        }
+        if (hits[i].Partner != partner || std::fabs(hits[i].Result.TimeOfImpact - earliest) > 1e-3) {
+            FCL_LOG_ERROR(
+                "Batch CCD object %lu mismatch (partner %lu vs %lu, toi %f vs %f)",
+                i,
+                hits[i].Partner,
+                partner,
+                hits[i].Result.TimeOfImpact,
+                earliest);
+            return false;
+        }
+    }
+
+    // 奇数对象作为 Object2 出现时，接触法线需翻转为由本对象指向对方。
+    if (hits[1].Result.Contact.Normal.X > 0.0f || hits[0].Result.Contact.Normal.X < 0.0f) {
+        FCL_LOG_ERROR("Batch CCD contact orientation mismatch");
+        return false;
+    }
+    return true;
+}
+
+bool RunShapeCastSuite() noexcept {
+    GeometryHandle sphere;
+    GeometryHandle box;
+    if (!NT_SUCCESS(CreateSphere(0.5f, sphere)) || !NT_SUCCESS(CreateBoxMesh(0.5f, box))) {
+        FCL_LOG_ERROR("Failed to create shape cast geometry");
+        return false;
+    }
+
+    // 目标：原点球体、x = 2 的 Mesh 盒、偏离路径的远处球体。
+    const FCL_TRANSFORM origin = IdentityTransform();
+    const FCL_TRANSFORM boxPose = MakeRotatedTransform(0.0f, {2.0f, 0.0f, 0.0f});
+    const FCL_TRANSFORM farPose = MakeRotatedTransform(0.0f, {0.0f, 10.0f, 0.0f});
+    const FCL_BROADPHASE_OBJECT targets[] = {
+        {sphere.handle, &origin},
+        {box.handle, &boxPose},
+        {sphere.handle, &farPose},
+    };
+
+    const struct {
+        const char* Label;
+        FCL_VECTOR3 Start;
+        FCL_VECTOR3 Translation;
+        ULONG HitIndex;
+        double Fraction;
+        float NormalX;
+    } cases[] = {
+        {"cast +X hits sphere", {-5.0f, 0.0f, 0.0f}, {10.0f, 0.0f, 0.0f}, 0, 0.4, -1.0f},
+        {"cast -X hits mesh box", {5.0f, 0.0f, 0.0f}, {-10.0f, 0.0f, 0.0f}, 1, 0.3, 1.0f},
+        {"cast +Y misses", {-5.0f, 0.0f, 0.0f}, {0.0f, 10.0f, 0.0f}, FCL_SHAPE_CAST_NO_HIT, 1.0, 0.0f},
+    };
+
+    for (const auto& testCase : cases) {
+        FCL_SHAPE_CAST_REQUEST request = {};
+        request.Shape = sphere.handle;
+        request.Start = MakeRotatedTransform(0.0f, testCase.Start);
+        request.Translation = testCase.Translation;
+        FCL_SHAPE_CAST_RESULT result = {};
+        const NTSTATUS status = FclShapeCast(&request, targets, RTL_NUMBER_OF(targets), &result);
+        if (!NT_SUCCESS(status) ||
+            result.HitIndex != testCase.HitIndex ||
+            std::fabs(result.Fraction - testCase.Fraction) > 1e-3 ||
+            (result.Hit && std::fabs(result.Normal.X - testCase.NormalX) > 1e-2f)) {
+            FCL_LOG_ERROR(
+                "%s: status 0x%X, index %lu, fraction %f, normal.x %f",
+                testCase.Label,
+                status,
+                result.HitIndex,
+                result.Fraction,
+                result.Normal.X);
+            return false;
+        }
+        if (result.Hit && !FclIsGeometryHandleValid(result.HitHandle)) {
+            FCL_LOG_ERROR("%s: hit handle not reported", testCase.Label);
+            return false;
+        }
+    }
+
+    // 起始即相交：Fraction = 0。
+    const FCL_GEOMETRY_SNAPSHOT snapshot = MakeSphereSnapshot(0.5f);
+    const FCL_TRANSFORM overlapping = MakeRotatedTransform(0.0f, {0.5f, 0.0f, 0.0f});
+    const FCL_VECTOR3 translation = {1.0f, 0.0f, 0.0f};
+    FCL_SHAPE_CAST_RESULT result = {};
+    const NTSTATUS status = FclShapeCastCoreFromSnapshots(
+        &snapshot, &overlapping, &translation, &snapshot, &origin, 0.0f, 0, &result);
+    if (!NT_SUCCESS(status) || !result.Hit || result.Fraction != 0.0) {
+        FCL_LOG_ERROR("Initially overlapping cast should report fraction 0 (status 0x%X)", status);
+        return false;
+    }
+
+    // 球擦过 X 向胶囊端部：凸体步进应收敛到真实接触（t = 0.34）；迭代上限为 1 时命中须标记为未收敛。
+    const FCL_GEOMETRY_SNAPSHOT capsule = MakeCapsuleSnapshot(0.5f, 1.0f, true);
+    const FCL_TRANSFORM grazing = MakeRotatedTransform(0.0f, {-5.0f, 0.8f, 0.0f});
+    const FCL_VECTOR3 sweep = {10.0f, 0.0f, 0.0f};
+    FCL_SHAPE_CAST_RESULT converged = {};
+    NTSTATUS castStatus = FclShapeCastCoreFromSnapshots(
+        &snapshot, &grazing, &sweep, &capsule, &origin, 0.0f, 0, &converged);
+    if (!NT_SUCCESS(castStatus) || !converged.Hit || converged.IterationLimited ||
+        std::fabs(converged.Fraction - 0.34) > 1e-3) {
+        FCL_LOG_ERROR(
+            "Sphere vs capsule cast: status 0x%X, hit %u, limited %u, fraction %f",
+            castStatus,
+            converged.Hit,
+            converged.IterationLimited,
+            converged.Fraction);
+        return false;
+    }
+    FCL_SHAPE_CAST_RESULT limited = {};
+    castStatus = FclShapeCastCoreFromSnapshots(&snapshot, &grazing, &sweep, &capsule, &origin, 0.0f, 1, &limited);
+    if (!NT_SUCCESS(castStatus) || !limited.Hit || !limited.IterationLimited || limited.Fraction > converged.Fraction) {
+        FCL_LOG_ERROR(
+            "Iteration-limited cast should be flagged: status 0x%X, hit %u, limited %u, fraction %f",
+            castStatus,
+            limited.Hit,
+            limited.IterationLimited,
+            limited.Fraction);
+        return false;
+    }
+    return true;
+}
+
+bool RunRaycastSuite() noexcept {
+    GeometryHandle sphere;
+    GeometryHandle box;
+    if (!NT_SUCCESS(CreateSphere(0.5f, sphere)) || !NT_SUCCESS(CreateBoxMesh(0.5f, box))) {
+        FCL_LOG_ERROR("Failed to create raycast geometry");
+        return false;
+    }
+
+    // 场景：原点球体与 x = 2 的 Mesh 盒。
+    const FCL_TRANSFORM origin = IdentityTransform();
+    const FCL_TRANSFORM boxPose = MakeRotatedTransform(0.0f, {2.0f, 0.0f, 0.0f});
+    const FCL_BROADPHASE_OBJECT targets[] = {
+        {sphere.handle, &origin},
+        {box.handle, &boxPose},
+    };
+
+    // 第 2、3 条射线分别穿过盒顶面的对角线（共享边）与角点（共享顶点），必须命中。
+    const FCL_RAY rays[] = {
+        {{-5.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, 0.0f},
+        {{5.0f, 0.0f, 0.0f}, {-2.0f, 0.0f, 0.0f}, 0.0f},
+        {{2.0f, 0.0f, 3.0f}, {0.0f, 0.0f, -1.0f}, 0.0f},
+        {{2.5f, 0.5f, 3.0f}, {0.0f, 0.0f, -1.0f}, 0.0f},
+        {{-5.0f, 3.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, 0.0f},
+        {{-5.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, 2.0f},
+    };
+    const struct {
+        ULONG ObjectIndex;
+        float Distance;
+        FCL_VECTOR3 Normal;
+    } expected[] = {
+        {0, 4.5f, {-1.0f, 0.0f, 0.0f}},
+        {1, 1.25f, {1.0f, 0.0f, 0.0f}},
+        {1, 2.5f, {0.0f, 0.0f, 1.0f}},
+        {1, 2.5f, {0.0f, 0.0f, 0.0f}},
+        {FCL_RAYCAST_NO_HIT, 0.0f, {0.0f, 0.0f, 0.0f}},
+        {FCL_RAYCAST_NO_HIT, 0.0f, {0.0f, 0.0f, 0.0f}},
+    };
+    constexpr ULONG kRayCount = RTL_NUMBER_OF(rays);
+
+    FCL_RAY_HIT scalar[kRayCount] = {};
+    FCL_RAY_HIT packet[kRayCount] = {};
+    NTSTATUS status = FclRaycastBatch(rays, kRayCount, targets, RTL_NUMBER_OF(targets), 0, scalar);
+    if (!NT_SUCCESS(status)) {
+        FCL_LOG_ERROR("FclRaycastBatch failed: 0x%X", status);
+        return false;
+    }
+    status = FclRaycastBatch(rays, kRayCount, targets, RTL_NUMBER_OF(targets), FCL_RAYCAST_FLAG_PACKET, packet);
+    if (!NT_SUCCESS(status)) {
+        FCL_LOG_ERROR("FclRaycastBatch (packet) failed: 0x%X", status);
+        return false;
+    }
+
+    for (ULONG i = 0; i < kRayCount; ++i) {
+        const FCL_RAY_HIT& hit = scalar[i];
+        if (hit.ObjectIndex != expected[i].ObjectIndex ||
+            (hit.Hit && std::fabs(hit.Distance - expected[i].Distance) > 1e-4f)) {
+            FCL_LOG_ERROR("Ray %lu: object %lu, distance %f", i, hit.ObjectIndex, hit.Distance);
+            return false;
+        }
+        const FCL_VECTOR3& normal = expected[i].Normal;
+        if (hit.Hit && fclmusa::geom::Dot(normal, normal) > 0.0f && fclmusa::geom::Dot(hit.Normal, normal) < 0.99f) {
+            FCL_LOG_ERROR("Ray %lu: unexpected normal (%f, %f, %f)", i, hit.Normal.X, hit.Normal.Y, hit.Normal.Z);
+            return false;
+        }
+        if (hit.Hit && hit.ObjectIndex == 1 && hit.TriangleIndex == FCL_RAYCAST_NO_TRIANGLE) {
+            FCL_LOG_ERROR("Ray %lu: mesh hit without triangle index", i);
+            return false;
+        }
+        if (packet[i].Hit != hit.Hit || packet[i].ObjectIndex != hit.ObjectIndex ||
+            packet[i].TriangleIndex != hit.TriangleIndex || packet[i].Distance != hit.Distance) {
+            FCL_LOG_ERROR("Ray %lu: packet traversal differs from scalar traversal", i);
+            return false;
+        }
+    }
+
+    // ANY_HIT：只要求报告某个命中，遮挡查询不关心最近。
+    const FCL_RAY through = {{-5.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, 0.0f};
+    FCL_RAY_HIT anyHit = {};
+    status = FclRaycast(&through, targets, RTL_NUMBER_OF(targets), FCL_RAYCAST_FLAG_ANY_HIT, &anyHit);
+    if (!NT_SUCCESS(status) || !anyHit.Hit || !FclIsGeometryHandleValid(anyHit.Handle)) {
+        FCL_LOG_ERROR("Any-hit ray should report an occluder (status 0x%X)", status);
+        return false;
+    }
+
+    // 胶囊 / 圆柱解析求交、凸包三角化面、复合体子形状：同一批射线中混合各类目标。
+    FCL_CAPSULE_GEOMETRY_DESC capsuleDesc = {};
+    capsuleDesc.Rotation = IdentityTransform().Rotation;
+    capsuleDesc.Radius = 0.25f;
+    capsuleDesc.HalfLength = 0.5f;
+    FCL_CYLINDER_GEOMETRY_DESC cylinderDesc = {};
+    cylinderDesc.Rotation = IdentityTransform().Rotation;
+    cylinderDesc.Radius = 0.5f;
+    cylinderDesc.HalfLength = 0.5f;
+    const FCL_VECTOR3 cubePoints[] = {
+        {-0.5f, -0.5f, -0.5f}, {0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, -0.5f}, {-0.5f, 0.5f, -0.5f},
+        {-0.5f, -0.5f, 0.5f}, {0.5f, -0.5f, 0.5f}, {0.5f, 0.5f, 0.5f}, {-0.5f, 0.5f, 0.5f},
+    };
+    FCL_CONVEX_GEOMETRY_DESC convexDesc = {};
+    convexDesc.Points = cubePoints;
+    convexDesc.PointCount = RTL_NUMBER_OF(cubePoints);
+    GeometryHandle capsule;
+    GeometryHandle cylinder;
+    GeometryHandle convex;
+    GeometryHandle compound;
+    status = FclCreateGeometry(FCL_GEOMETRY_CAPSULE, &capsuleDesc, &capsule.handle);
+    if (NT_SUCCESS(status)) {
+        status = FclCreateGeometry(FCL_GEOMETRY_CYLINDER, &cylinderDesc, &cylinder.handle);
+    }
+    if (NT_SUCCESS(status)) {
+        status = FclCreateGeometry(FCL_GEOMETRY_CONVEX, &convexDesc, &convex.handle);
+    }
+    if (NT_SUCCESS(status)) {
+        FCL_COMPOUND_CHILD_DESC children[2] = {};
+        children[0].Geometry = sphere.handle;
+        children[0].LocalTransform = IdentityTransform();
+        children[1].Geometry = capsule.handle;
+        children[1].LocalTransform = MakeRotatedTransform(0.0f, {2.0f, 0.0f, 0.0f});
+        FCL_COMPOUND_GEOMETRY_DESC compoundDesc = {};
+        compoundDesc.Children = children;
+        compoundDesc.ChildCount = RTL_NUMBER_OF(children);
+        status = FclCreateGeometry(FCL_GEOMETRY_COMPOUND, &compoundDesc, &compound.handle);
+    }
+    if (!NT_SUCCESS(status)) {
+        FCL_LOG_ERROR("Failed to create raycast shape geometry: 0x%X", status);
+        return false;
+    }
+
+    const FCL_TRANSFORM capsulePose = MakeRotatedTransform(0.0f, {0.0f, 5.0f, 0.0f});
+    const FCL_TRANSFORM cylinderPose = MakeRotatedTransform(0.0f, {0.0f, 10.0f, 0.0f});
+    const FCL_TRANSFORM convexPose = MakeRotatedTransform(0.0f, {0.0f, 15.0f, 0.0f});
+    const FCL_TRANSFORM compoundPose = MakeRotatedTransform(0.0f, {0.0f, 20.0f, 0.0f});
+    const FCL_BROADPHASE_OBJECT shapes[] = {
+        {capsule.handle, &capsulePose},
+        {cylinder.handle, &cylinderPose},
+        {convex.handle, &convexPose},
+        {compound.handle, &compoundPose},
+    };
+    // 依次为：胶囊侧面、胶囊端球、圆柱端面、圆柱侧面、圆柱内部起点（出射点）、凸包面、复合体的胶囊子形状。
+    const FCL_RAY shapeRays[] = {
+        {{-5.0f, 5.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, 0.0f},
+        {{0.0f, 5.0f, 5.0f}, {0.0f, 0.0f, -1.0f}, 0.0f},
+        {{0.0f, 10.0f, 5.0f}, {0.0f, 0.0f, -1.0f}, 0.0f},
+        {{-5.0f, 10.0f, 0.2f}, {1.0f, 0.0f, 0.0f}, 0.0f},
+        {{0.0f, 10.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, 0.0f},
+        {{-5.0f, 15.0f, 0.1f}, {1.0f, 0.0f, 0.0f}, 0.0f},
+        {{5.0f, 20.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, 0.0f},
+    };
+    const struct {
+        ULONG ObjectIndex;
+        ULONG ChildIndex;
+        float Distance;
+        FCL_VECTOR3 Normal;
+    } shapeExpected[] = {
+        {0, FCL_COMPOUND_NO_CHILD, 4.75f, {-1.0f, 0.0f, 0.0f}},
+        {0, FCL_COMPOUND_NO_CHILD, 4.25f, {0.0f, 0.0f, 1.0f}},
+        {1, FCL_COMPOUND_NO_CHILD, 4.5f, {0.0f, 0.0f, 1.0f}},
+        {1, FCL_COMPOUND_NO_CHILD, 4.5f, {-1.0f, 0.0f, 0.0f}},
+        {1, FCL_COMPOUND_NO_CHILD, 0.5f, {1.0f, 0.0f, 0.0f}},
+        {2, FCL_COMPOUND_NO_CHILD, 4.5f, {-1.0f, 0.0f, 0.0f}},
+        {3, 1, 2.75f, {1.0f, 0.0f, 0.0f}},
+    };
+    FCL_RAY_HIT shapeHits[RTL_NUMBER_OF(shapeRays)] = {};
+    status = FclRaycastBatch(shapeRays, RTL_NUMBER_OF(shapeRays), shapes, RTL_NUMBER_OF(shapes), 0, shapeHits);
+    if (!NT_SUCCESS(status)) {
+        FCL_LOG_ERROR("FclRaycastBatch over capsule / cylinder / convex / compound failed: 0x%X", status);
+        return false;
+    }
+    for (ULONG i = 0; i < RTL_NUMBER_OF(shapeRays); ++i) {
+        const FCL_RAY_HIT& hit = shapeHits[i];
+        if (!hit.Hit || hit.ObjectIndex != shapeExpected[i].ObjectIndex ||
+            hit.ChildIndex != shapeExpected[i].ChildIndex ||
+            std::fabs(hit.Distance - shapeExpected[i].Distance) > 1e-4f ||
+            fclmusa::geom::Dot(hit.Normal, shapeExpected[i].Normal) < 0.99f ||
+            (hit.ObjectIndex == 2) != (hit.TriangleIndex != FCL_RAYCAST_NO_TRIANGLE)) {
+            FCL_LOG_ERROR("Shape ray %lu: object %lu, child %lu, distance %f, normal (%f, %f, %f)",
+                i,
+                hit.ObjectIndex,
+                hit.ChildIndex,
+                hit.Distance,
+                hit.Normal.X,
+                hit.Normal.Y,
+                hit.Normal.Z);
+            return false;
+        }
+    }
+
+    const FCL_RAY degenerate = {{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, 0.0f};
+    if (FclRaycast(&degenerate, targets, RTL_NUMBER_OF(targets), 0, &anyHit) != STATUS_INVALID_PARAMETER) {
+        FCL_LOG_ERROR("Zero-length ray direction should be rejected");
+        return false;
+    }
+    return true;
+}
+
+bool RunMeshPointQuerySuite() noexcept {
+    GeometryHandle box;
+    GeometryHandle sphere;
+    if (!NT_SUCCESS(CreateBoxMesh(0.5f, box)) || !NT_SUCCESS(CreateSphere(0.5f, sphere))) {
+        FCL_LOG_ERROR("Failed to create point query geometry");
+        return false;
+    }
+
+    // 盒体绕 Z 旋转并平移，点以盒体局部坐标给出，覆盖面 / 边 / 顶点区域与内部点。
+    const FCL_TRANSFORM pose = MakeRotatedTransform(0.5f, {1.0f, 0.0f, 0.0f});
+    const struct {
+        FCL_VECTOR3 Local;
+        float Distance;
+        BOOLEAN Inside;
+        bool UniqueClosest;
+        FCL_VECTOR3 ClosestLocal;
+    } cases[] = {
+        {{0.0f, 0.0f, 0.0f}, 0.5f, TRUE, false, {}},
+        {{0.2f, 0.1f, 0.0f}, 0.3f, TRUE, true, {0.5f, 0.1f, 0.0f}},
+        {{0.45f, 0.45f, 0.45f}, 0.05f, TRUE, false, {}},
+        {{1.5f, 0.0f, 0.0f}, 1.0f, FALSE, true, {0.5f, 0.0f, 0.0f}},
+        {{1.0f, 1.0f, 0.0f}, 0.70710677f, FALSE, true, {0.5f, 0.5f, 0.0f}},
+        {{1.0f, 1.0f, 1.0f}, 0.8660254f, FALSE, true, {0.5f, 0.5f, 0.5f}},
+    };
+    constexpr ULONG kPointCount = RTL_NUMBER_OF(cases);
+
+    FCL_VECTOR3 points[kPointCount] = {};
+    for (ULONG i = 0; i < kPointCount; ++i) {
+        points[i] = fclmusa::geom::TransformPoint(pose, cases[i].Local);
+    }
+    FCL_POINT_QUERY_RESULT results[kPointCount] = {};
+    NTSTATUS status = FclMeshPointQuery(box.handle, &pose, points, kPointCount, 0.0f, FCL_POINT_QUERY_FLAG_SIGNED, results);
+    if (!NT_SUCCESS(status)) {
+        FCL_LOG_ERROR("FclMeshPointQuery failed: 0x%X", status);
+        return false;
+    }
+
+    for (ULONG i = 0; i < kPointCount; ++i) {
+        const FCL_POINT_QUERY_RESULT& result = results[i];
+        const float expectedSigned = cases[i].Inside ? -cases[i].Distance : cases[i].Distance;
+        if (result.TriangleIndex == FCL_POINT_QUERY_NO_TRIANGLE ||
+            std::fabs(result.Distance - cases[i].Distance) > kTolerance ||
+            std::fabs(result.SignedDistance - expectedSigned) > kTolerance ||
+            result.Inside != cases[i].Inside) {
+            FCL_LOG_ERROR(
+                "Point %lu: distance %f, signed %f, inside %u, triangle %lu",
+                i,
+                result.Distance,
+                result.SignedDistance,
+                result.Inside,
+                result.TriangleIndex);
+            return false;
+        }
+        // 内部点到多个面等距时最近点不唯一，只检查距离与符号。
+        if (cases[i].UniqueClosest) {
+            const FCL_VECTOR3 expected = fclmusa::geom::TransformPoint(pose, cases[i].ClosestLocal);
+            const float error = fclmusa::geom::Length(fclmusa::geom::Subtract(result.ClosestPoint, expected));
+            if (error > kTolerance) {
+                FCL_LOG_ERROR("Point %lu: closest point off by %f", i, error);
+                return false;
+            }
+        }
+    }
+
+    // 搜索半径之外的点不返回三角形。
+    const FCL_VECTOR3 distant = fclmusa::geom::TransformPoint(pose, {3.0f, 0.0f, 0.0f});
+    FCL_POINT_QUERY_RESULT limited = {};
+    status = FclMeshPointQuery(box.handle, &pose, &distant, 1, 1.0f, 0, &limited);
+    if (!NT_SUCCESS(status) || limited.TriangleIndex != FCL_POINT_QUERY_NO_TRIANGLE) {
+        FCL_LOG_ERROR("Point beyond maxDistance should report no triangle (status 0x%X)", status);
+        return false;
+    }
+
+    status = FclMeshPointQuery(sphere.handle, nullptr, points, 1, 0.0f, 0, results);
+    if (status != STATUS_NOT_SUPPORTED) {
+        FCL_LOG_ERROR("Point query on a non-mesh geometry should be rejected (status 0x%X)", status);
+        return false;
+    }
+    return true;
+}
+
+bool RunConvexSuite() noexcept {
+    // 立方体 8 个角点加若干内部点：内部点应被丢弃。
+    const FCL_VECTOR3 points[] = {
+        {-0.5f, -0.5f, -0.5f}, {0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, -0.5f}, {-0.5f, 0.5f, -0.5f},
+        {-0.5f, -0.5f, 0.5f}, {0.5f, -0.5f, 0.5f}, {0.5f, 0.5f, 0.5f}, {-0.5f, 0.5f, 0.5f},
+        {0.0f, 0.0f, 0.0f}, {0.1f, 0.2f, -0.1f}, {-0.3f, 0.4f, 0.25f},
+    };
+    FCL_CONVEX_GEOMETRY_DESC desc = {};
+    desc.Points = points;
+    desc.PointCount = RTL_NUMBER_OF(points);
+    GeometryHandle convex;
+    GeometryHandle sphere;
+    GeometryHandle box;
+    if (!NT_SUCCESS(FclCreateGeometry(FCL_GEOMETRY_CONVEX, &desc, &convex.handle)) ||
+        !NT_SUCCESS(CreateSphere(0.5f, sphere)) ||
+        !NT_SUCCESS(CreateBoxMesh(0.5f, box))) {
+        FCL_LOG_ERROR("Failed to create convex geometry");
+        return false;
+    }
+
+    FCL_GEOMETRY_REFERENCE reference = {};
+    FCL_GEOMETRY_SNAPSHOT snapshot = {};
+    if (!NT_SUCCESS(FclAcquireGeometryReference(convex.handle, &reference, &snapshot))) {
+        return false;
+    }
+    const bool hullOk = snapshot.Type == FCL_GEOMETRY_CONVEX &&
+        snapshot.Data.Convex.VertexCount == 8 &&
+        snapshot.Data.Convex.IndexCount == 36;
+    FclReleaseGeometryReference(&reference);
+    if (!hullOk) {
+        FCL_LOG_ERROR("Convex hull should keep 8 vertices / 12 triangles");
+        return false;
+    }
+
+    // GJK 迭代收敛容差比解析内核宽。
+    constexpr float kGjkTolerance = 1e-3f;
+    const FCL_TRANSFORM identity = IdentityTransform();
+    const struct {
+        float Offset;
+        BOOLEAN Colliding;
+        float Distance;
+    } sphereCases[] = {
+        {0.9f, TRUE, 0.0f},
+        {1.1f, FALSE, 0.1f},
+        {1.5f, FALSE, 0.5f},
+    };
+    for (const auto& sphereCase : sphereCases) {
+        FCL_TRANSFORM spherePose = IdentityTransform();
+        spherePose.Translation.X = sphereCase.Offset;
+        BOOLEAN isColliding = FALSE;
+        NTSTATUS status = FclCollisionDetect(convex.handle, &identity, sphere.handle, &spherePose, &isColliding, nullptr);
+        if (!NT_SUCCESS(status) || isColliding != sphereCase.Colliding) {
+            FCL_LOG_ERROR("Convex/sphere at %f: status 0x%X, colliding %u", sphereCase.Offset, status, isColliding);
+            return false;
+        }
+        if (sphereCase.Colliding) {
+            continue;
+        }
+        FCL_DISTANCE_RESULT distance = {};
+        status = FclDistanceCompute(convex.handle, &identity, sphere.handle, &spherePose, &distance);
+        if (!NT_SUCCESS(status) || std::fabs(distance.Distance - sphereCase.Distance) > kGjkTolerance) {
+            FCL_LOG_ERROR("Convex/sphere distance at %f: status 0x%X, distance %f", sphereCase.Offset, status, distance.Distance);
+            return false;
+        }
+    }
+
+    // 由 Mesh 生成的凸包与原 Mesh（凸体）的碰撞结论一致。
+    GeometryHandle fromMesh;
+    if (!NT_SUCCESS(FclCreateConvexFromMesh(box.handle, &fromMesh.handle))) {
+        FCL_LOG_ERROR("FclCreateConvexFromMesh failed");
+        return false;
+    }
+    for (int step = 0; step < 16; ++step) {
+        const float angle = 0.2f * static_cast<float>(step);
+        const FCL_TRANSFORM pose = MakeRotatedTransform(angle, {0.6f + 0.05f * static_cast<float>(step), 0.3f, 0.0f});
+        BOOLEAN meshColliding = FALSE;
+        BOOLEAN convexColliding = FALSE;
+        if (!NT_SUCCESS(FclCollisionDetect(box.handle, &identity, box.handle, &pose, &meshColliding, nullptr)) ||
+            !NT_SUCCESS(FclCollisionDetect(fromMesh.handle, &identity, convex.handle, &pose, &convexColliding, nullptr)) ||
+            meshColliding != convexColliding) {
+            FCL_LOG_ERROR("Step %d: mesh colliding %u, convex colliding %u", step, meshColliding, convexColliding);
+            return false;
+        }
+    }
+
+    // 共面点集无法构成凸体；非 Mesh 句柄不能转换。
+    const FCL_VECTOR3 planar[] = {{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 1.0f, 0.0f}};
+    desc.Points = planar;
+    desc.PointCount = RTL_NUMBER_OF(planar);
+    GeometryHandle degenerate;
+    if (NT_SUCCESS(FclCreateGeometry(FCL_GEOMETRY_CONVEX, &desc, &degenerate.handle))) {
+        FCL_LOG_ERROR("Coplanar convex input should be rejected");
+        return false;
+    }
+    GeometryHandle fromSphere;
+    const NTSTATUS status = FclCreateConvexFromMesh(sphere.handle, &fromSphere.handle);
+    if (status != STATUS_NOT_SUPPORTED) {
+        FCL_LOG_ERROR("FclCreateConvexFromMesh on a sphere should be rejected (status 0x%X)", status);
+        return false;
+    }
+    return true;
+}
+
+bool RunCapsuleCylinderSuite() noexcept {
+    FCL_CAPSULE_GEOMETRY_DESC capsuleDesc = {};
+    capsuleDesc.Rotation = IdentityTransform().Rotation;
+    capsuleDesc.Radius = 0.25f;
+    capsuleDesc.HalfLength = 0.5f;
+    FCL_CYLINDER_GEOMETRY_DESC cylinderDesc = {};
+    cylinderDesc.Rotation = IdentityTransform().Rotation;
+    cylinderDesc.Radius = 0.5f;
+    cylinderDesc.HalfLength = 0.5f;
+
+    GeometryHandle capsule;
+    GeometryHandle cylinder;
+    GeometryHandle sphere;
+    if (!NT_SUCCESS(FclCreateGeometry(FCL_GEOMETRY_CAPSULE, &capsuleDesc, &capsule.handle)) ||
+        !NT_SUCCESS(FclCreateGeometry(FCL_GEOMETRY_CYLINDER, &cylinderDesc, &cylinder.handle)) ||
+        !NT_SUCCESS(CreateSphere(0.25f, sphere))) {
+        FCL_LOG_ERROR("Failed to create capsule / cylinder geometry");
+        return false;
+    }
+
+    // 圆柱侧面与端面外各放一个球，距离均为 0.25（GJK 收敛容差）。
+    constexpr float kGjkTolerance = 1e-3f;
+    const FCL_TRANSFORM identity = IdentityTransform();
+    const FCL_VECTOR3 sphereOffsets[] = {{1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+    for (const FCL_VECTOR3& offset : sphereOffsets) {
+        FCL_TRANSFORM spherePose = IdentityTransform();
+        spherePose.Translation = offset;
+        FCL_DISTANCE_RESULT result = {};
+        const NTSTATUS status = FclDistanceCompute(cylinder.handle, &identity, sphere.handle, &spherePose, &result);
+        if (!NT_SUCCESS(status) || std::fabs(result.Distance - 0.25f) > kGjkTolerance) {
+            FCL_LOG_ERROR("Cylinder/sphere distance: status 0x%X, distance %f", status, result.Distance);
+            return false;
+        }
+    }
+
+    // 胶囊沿 X 平移靠近圆柱：半径和 0.75 处开始接触。
+    const struct {
+        float Offset;
+        BOOLEAN Colliding;
+    } capsuleCases[] = {
+        {0.7f, TRUE},
+        {0.8f, FALSE},
+    };
+    for (const auto& capsuleCase : capsuleCases) {
+        FCL_TRANSFORM capsulePose = IdentityTransform();
+        capsulePose.Translation.X = capsuleCase.Offset;
+        BOOLEAN isColliding = FALSE;
+        const NTSTATUS status = FclCollisionDetect(cylinder.handle, &identity, capsule.handle, &capsulePose, &isColliding, nullptr);
+        if (!NT_SUCCESS(status) || isColliding != capsuleCase.Colliding) {
+            FCL_LOG_ERROR("Cylinder/capsule at %f: status 0x%X, colliding %u", capsuleCase.Offset, status, isColliding);
+            return false;
+        }
+    }
+
+    // 胶囊端点球：沿轴向偏移 1.2 的球距离为 1.2 - 0.5 - 0.25 - 0.25。
+    FCL_TRANSFORM spherePose = IdentityTransform();
+    spherePose.Translation.Z = 1.2f;
+    FCL_DISTANCE_RESULT capsuleDistance = {};
+    NTSTATUS status = FclDistanceCompute(capsule.handle, &identity, sphere.handle, &spherePose, &capsuleDistance);
+    if (!NT_SUCCESS(status) || std::fabs(capsuleDistance.Distance - 0.2f) > kTolerance) {
+        FCL_LOG_ERROR("Capsule/sphere axial distance: status 0x%X, distance %f", status, capsuleDistance.Distance);
+        return false;
+    }
+
+    capsuleDesc.HalfLength = 0.0f;
+    GeometryHandle degenerate;
+    if (NT_SUCCESS(FclCreateGeometry(FCL_GEOMETRY_CAPSULE, &capsuleDesc, &degenerate.handle))) {
+        FCL_LOG_ERROR("Capsule with zero half length should be rejected");
+        return false;
+    }
+    return true;
+}
+
+bool RunCompoundSuite() noexcept {
+    // 三个半径 0.25 的球沿 X 轴排列（-1, 0, 1），组成一个复合几何。
+    GeometryHandle parts[3];
+    FCL_COMPOUND_CHILD_DESC children[3] = {};
+    for (int i = 0; i < 3; ++i) {
+        if (!NT_SUCCESS(CreateSphere(0.25f, parts[i]))) {
+            FCL_LOG_ERROR("Failed to create compound child %d", i);
+            return false;
+        }
+        children[i].Geometry = parts[i].handle;
+        children[i].LocalTransform = IdentityTransform();
+        children[i].LocalTransform.Translation.X = static_cast<float>(i - 1);
+    }
+    FCL_COMPOUND_GEOMETRY_DESC compoundDesc = {};
+    compoundDesc.Children = children;
+    compoundDesc.ChildCount = 3;
+
+    GeometryHandle compound;
+    GeometryHandle probe;
+    if (!NT_SUCCESS(FclCreateGeometry(FCL_GEOMETRY_COMPOUND, &compoundDesc, &compound.handle)) ||
+        !NT_SUCCESS(CreateSphere(0.25f, probe))) {
+        FCL_LOG_ERROR("Failed to create compound geometry");
+        return false;
+    }
+
+    const FCL_TRANSFORM identity = IdentityTransform();
+    FCL_TRANSFORM probePose = IdentityTransform();
+    probePose.Translation = {1.0f, 0.4f, 0.0f};
+    BOOLEAN isColliding = FALSE;
+    FCL_COMPOUND_CHILD_PAIR hit = {};
+    NTSTATUS status = FclCompoundCollisionDetect(compound.handle, &identity, probe.handle, &probePose, &isColliding, nullptr, &hit);
+    if (!NT_SUCCESS(status) || !isColliding || hit.Child1 != 2 || hit.Child2 != FCL_COMPOUND_NO_CHILD) {
+        FCL_LOG_ERROR("Compound collision: status 0x%X, colliding %u, child %lu", status, isColliding, hit.Child1);
+        return false;
+    }
+
+    // 整体平移复合体只需一个变换。
+    FCL_TRANSFORM lifted = IdentityTransform();
+    lifted.Translation.Z = 5.0f;
+    status = FclCollisionDetect(compound.handle, &lifted, probe.handle, &probePose, &isColliding, nullptr);
+    if (!NT_SUCCESS(status) || isColliding) {
+        FCL_LOG_ERROR("Lifted compound should not collide: status 0x%X", status);
+        return false;
+    }
+
+    // 探针位于中间球正上方 1.0 处，距离 1.0 - 0.25 - 0.25；复合体作为对象 2 时序号写入 Child2。
+    probePose.Translation = {0.0f, 1.0f, 0.0f};
+    FCL_DISTANCE_RESULT distance = {};
+    status = FclCompoundDistanceCompute(probe.handle, &probePose, compound.handle, &identity, &distance, &hit);
+    if (!NT_SUCCESS(status) || std::fabs(distance.Distance - 0.5f) > kTolerance ||
+        hit.Child1 != FCL_COMPOUND_NO_CHILD || hit.Child2 != 1) {
+        FCL_LOG_ERROR("Compound distance: status 0x%X, distance %f, child %lu", status, distance.Distance, hit.Child2);
+        return false;
+    }
+
+    // 复合体存在期间子形状不可销毁；子形状不能是复合几何。
+    if (FclDestroyGeometry(parts[0].handle) != STATUS_DEVICE_BUSY) {
+        FCL_LOG_ERROR("Compound child destroyed while referenced");
+        return false;
+    }
+    FCL_COMPOUND_CHILD_DESC nested = {compound.handle, IdentityTransform()};
+    compoundDesc.Children = &nested;
+    compoundDesc.ChildCount = 1;
+    GeometryHandle rejected;
+    if (FclCreateGeometry(FCL_GEOMETRY_COMPOUND, &compoundDesc, &rejected.handle) != STATUS_NOT_SUPPORTED) {
+        FCL_LOG_ERROR("Nested compound should be rejected");
+        return false;
+    }
+
+    compound.Release();
+    if (!NT_SUCCESS(FclDestroyGeometry(parts[0].handle))) {
+        FCL_LOG_ERROR("Compound child still referenced after compound destroyed");
+        return false;
+    }
+    parts[0].handle.Value = 0;
+    return true;
+}
+
+bool RunQueryArenaSuite() noexcept {
+    using fclmusa::memory::QueryArenaScope;
+    fclmusa::memory::EnablePoolTracking(TRUE);
+
+    // 作用域内分配 16 字节对齐；栈顶块释放后立即复用；嵌套作用域不生效。
+    {
+        QueryArenaScope scope;
+        QueryArenaScope nested;
+        if (!scope.Active() || nested.Active()) {
+            FCL_LOG_ERROR("Query arena scope activation mismatch");
+            return false;
+        }
+        void* first = fclmusa::memory::Allocate(40);
+        void* second = fclmusa::memory::Allocate(40);
+        const bool aligned = first != nullptr && second != nullptr &&
+                             (reinterpret_cast<ULONG_PTR>(second) % 16) == 0 &&
+                             fclmusa::memory::QueryAllocationSize(second) == 40;
+        fclmusa::memory::Free(second);
+        void* reused = fclmusa::memory::Allocate(40);
+        fclmusa::memory::Free(reused);
+        fclmusa::memory::Free(first);
+        if (!aligned || reused != second) {
+            FCL_LOG_ERROR("Query arena allocation layout mismatch");
+            return false;
+        }
+    }
+
+    // 预热一次让 arena 申请内存块，之后的 upstream 查询不再产生池分配。
+    const FCL_GEOMETRY_SNAPSHOT box = MakeBoxSnapshot({0.5f, 0.5f, 0.5f});
+    const FCL_TRANSFORM origin = IdentityTransform();
+    const FCL_TRANSFORM pose = MakeRotatedTransform(0.6f, {1.6f, 0.4f, 0.0f});
+    FCL_DISTANCE_RESULT result = {};
+    if (!NT_SUCCESS(FclUpstreamDistance(box, origin, box, pose, &result))) {
+        FCL_LOG_ERROR("Query arena warm-up failed");
+        return false;
+    }
+    const float expected = result.Distance;
+
+    const FCL_POOL_STATS poolBefore = fclmusa::memory::QueryStats();
+    const FCL_QUERY_ARENA_STATS arenaBefore = fclmusa::memory::QueryArenaStats();
+    for (int i = 0; i < 16; ++i) {
+        if (!NT_SUCCESS(FclUpstreamDistance(box, origin, box, pose, &result)) ||
+            std::fabs(result.Distance - expected) > kTolerance) {
+            FCL_LOG_ERROR("Query arena: distance query %d mismatch", i);
+            return false;
+        }
+    }
+    const FCL_POOL_STATS poolAfter = fclmusa::memory::QueryStats();
+    const FCL_QUERY_ARENA_STATS arenaAfter = fclmusa::memory::QueryArenaStats();
+    if (poolAfter.AllocationCount != poolBefore.AllocationCount ||
+        arenaAfter.ScopeCount - arenaBefore.ScopeCount != 16 ||
+        arenaAfter.ArenaAllocations <= arenaBefore.ArenaAllocations) {
+        FCL_LOG_ERROR("Query arena: %llu pool allocations, %llu arena allocations over 16 queries",
+            poolAfter.AllocationCount - poolBefore.AllocationCount,
+            arenaAfter.ArenaAllocations - arenaBefore.ArenaAllocations);
+        return false;
+    }
+
+    // 关闭后退回池分配，结果不变且不泄漏。
+    fclmusa::memory::EnableQueryArena(FALSE);
+    const NTSTATUS status = FclUpstreamDistance(box, origin, box, pose, &result);
+    fclmusa::memory::EnableQueryArena(TRUE);
+    const FCL_POOL_STATS poolDisabled = fclmusa::memory::QueryStats();
+    fclmusa::memory::EnablePoolTracking(FALSE);
+    if (!NT_SUCCESS(status) || std::fabs(result.Distance - expected) > kTolerance ||
+        poolDisabled.AllocationCount == poolAfter.AllocationCount ||
+        poolDisabled.BytesInUse != poolAfter.BytesInUse) {
+        FCL_LOG_ERROR("Query arena disabled path mismatch (status 0x%X)", status);
+        return false;
+    }
+    return true;
+}
+
+bool RunSlabAllocatorSuite() noexcept {
+    fclmusa::memory::EnablePoolTracking(TRUE);
+    const FCL_POOL_STATS before = fclmusa::memory::QueryStats();
+
+    // 覆盖最小级别、级别边界与 slab 上限两侧（2032 为最大 slab 负载，2033 起走系统池）。
+    const size_t sizes[] = {1, 16, 100, 2000, 2032, 2033, 5000};
+    constexpr size_t kSizeCount = sizeof(sizes) / sizeof(sizes[0]);
+    void* blocks[kSizeCount] = {};
+    size_t total = 0;
+    for (size_t i = 0; i < kSizeCount; ++i) {
+        blocks[i] = fclmusa::memory::Allocate(sizes[i]);
+        if (blocks[i] == nullptr || (reinterpret_cast<ULONG_PTR>(blocks[i]) % 16) != 0 ||
+            fclmusa::memory::QueryAllocationSize(blocks[i]) != sizes[i]) {
+            FCL_LOG_ERROR("Slab allocation of %zu bytes failed or misaligned", sizes[i]);
+            return false;
+        }
+        std::memset(blocks[i], static_cast<int>(i + 1), sizes[i]);
+        total += sizes[i];
+    }
+    const FCL_POOL_STATS mid = fclmusa::memory::QueryStats();
+    bool intact = true;
+    for (size_t i = 0; i < kSizeCount; ++i) {
+        const auto* bytes = static_cast<const unsigned char*>(blocks[i]);
+        intact = intact && bytes[0] == i + 1 && bytes[sizes[i] - 1] == i + 1;
+        fclmusa::memory::Free(blocks[i]);
+    }
+    if (!intact || mid.BytesInUse - before.BytesInUse != total || mid.AllocationCount - before.AllocationCount != kSizeCount) {
+        FCL_LOG_ERROR("Slab allocator accounting mismatch");
+        return false;
+    }
+
+    // 跨线程释放：工作线程分配、主线程释放，再反过来；结束后统计回到起点。
+    void* handoff[256] = {};
+    std::thread producer([&handoff]() {
+        for (void*& block : handoff) {
+            block = fclmusa::memory::Allocate(72);
+        }
+    });
+    producer.join();
+    for (void* block : handoff) {
+        fclmusa::memory::Free(block);
+    }
+    for (void*& block : handoff) {
+        block = fclmusa::memory::Allocate(72);
+    }
+    std::thread consumer([&handoff]() {
+        for (void* block : handoff) {
+            fclmusa::memory::Free(block);
+        }
+    });
+    consumer.join();
+
+    // 稳态：magazine 命中后反复分配 / 释放不再申请新页。
+    void* warm[2] = {fclmusa::memory::Allocate(64), fclmusa::memory::Allocate(48)};
+    fclmusa::memory::Free(warm[1]);
+    fclmusa::memory::Free(warm[0]);
+    const FCL_SLAB_STATS slabBefore = fclmusa::memory::QuerySlabStats();
+    for (int round = 0; round < 10000; ++round) {
+        void* pair[2] = {fclmusa::memory::Allocate(64), fclmusa::memory::Allocate(48)};
+        fclmusa::memory::Free(pair[1]);
+        fclmusa::memory::Free(pair[0]);
+    }
+    const FCL_SLAB_STATS slabAfter = fclmusa::memory::QuerySlabStats();
+
+    // 关闭缓存后新分配走系统池，关闭前分配的 slab 块仍可正常释放。
+    void* cached = fclmusa::memory::Allocate(32);
+    fclmusa::memory::EnableSlabCache(FALSE);
+    void* direct = fclmusa::memory::Allocate(32);
+    fclmusa::memory::Free(cached);
+    fclmusa::memory::Free(direct);
+    fclmusa::memory::EnableSlabCache(TRUE);
+
+    const FCL_POOL_STATS after = fclmusa::memory::QueryStats();
+    fclmusa::memory::EnablePoolTracking(FALSE);
+    if (slabAfter.SlabPages != slabBefore.SlabPages || after.BytesInUse != before.BytesInUse ||
+        after.AllocationCount - before.AllocationCount != after.FreeCount - before.FreeCount) {
+        FCL_LOG_ERROR("Slab allocator: %llu new pages, %llu bytes leaked",
+            slabAfter.SlabPages - slabBefore.SlabPages, after.BytesInUse - before.BytesInUse);
+        return false;
+    }
+    return true;
+}
+
+bool RunDpcReserveSuite() noexcept {
+    using fclmusa::memory::detail::AllocationHeader;
+    fclmusa::memory::EnablePoolTracking(TRUE);
+
+    // 小配置：2 个 256 B、1 个 4 KB、1 个 64 KB 块，覆盖级别选择、溢出与耗尽。
+    fclmusa::memory::SetDpcReserveConfig({2, 1, 1});
+    if (!NT_SUCCESS(fclmusa::memory::InitializeDpcReserve())) {
+        FCL_LOG_ERROR0("DPC reserve initialization failed");
+        return false;
+    }
+    const FCL_POOL_STATS poolBefore = fclmusa::memory::QueryStats();
+    const FCL_SLAB_STATS slabBefore = fclmusa::memory::QuerySlabStats();
+
+    KIRQL oldIrql = PASSIVE_LEVEL;
+    KeRaiseIrql(DISPATCH_LEVEL, &oldIrql);
+    const size_t smallPayload = 256 - sizeof(AllocationHeader);
+    void* blocks[5] = {
+        fclmusa::memory::Allocate(smallPayload),
+        fclmusa::memory::Allocate(100),
+        fclmusa::memory::Allocate(100),  // 256 B 级别已空，溢出到 4 KB
+        fclmusa::memory::Allocate(3000),  // 4 KB 级别已空，溢出到 64 KB
+        fclmusa::memory::Allocate(16),  // 全部耗尽
+    };
+    void* oversized = fclmusa::memory::Allocate(64 * 1024);
+    const FCL_DPC_RESERVE_STATS full = fclmusa::memory::QueryDpcReserveStats();
+    for (void* block : blocks) {
+        fclmusa::memory::Free(block);
+    }
+    KeLowerIrql(oldIrql);
+
+    bool layout = blocks[4] == nullptr && oversized == nullptr;
+    for (int i = 0; i < 4; ++i) {
+        layout = layout && blocks[i] != nullptr && (reinterpret_cast<ULONG_PTR>(blocks[i]) % 16) == 0;
+    }
+    const FCL_DPC_RESERVE_STATS drained = fclmusa::memory::QueryDpcReserveStats();
+    const FCL_POOL_STATS poolMid = fclmusa::memory::QueryStats();
+    const FCL_SLAB_STATS slabMid = fclmusa::memory::QuerySlabStats();
+    if (!layout || full.Classes[0].BlocksInUse != 2 || full.Classes[1].BlocksInUse != 1 ||
+        full.Classes[2].BlocksInUse != 1 || full.Allocations != 4 || full.Exhaustions != 2 ||
+        full.Classes[0].Overflows != 2 || full.ReserveBytes != 2 * 256 + 4096 + 64 * 1024) {
+        FCL_LOG_ERROR("DPC reserve class selection mismatch (exhaustions %llu)", full.Exhaustions);
+        return false;
+    }
+    if (drained.Classes[0].BlocksInUse != 0 || drained.Classes[2].BlocksInUse != 0 ||
+        drained.Classes[0].HighWaterBlocks != 2 || drained.Classes[2].HighWaterBlocks != 1 ||
+        poolMid.AllocationCount - poolBefore.AllocationCount != 4 || poolMid.BytesInUse != poolBefore.BytesInUse ||
+        slabMid.SlabPages != slabBefore.SlabPages) {
+        FCL_LOG_ERROR0("DPC reserve accounting mismatch after release");
+        return false;
+    }
+
+    // 默认配置下在 DISPATCH_LEVEL 执行 upstream 查询：结果与 PASSIVE 一致，分配全部来自预留池且不耗尽。
+    fclmusa::memory::SetDpcReserveConfig(fclmusa::memory::kDefaultDpcReserveConfig);
+    if (!NT_SUCCESS(fclmusa::memory::InitializeDpcReserve())) {
+        FCL_LOG_ERROR0("DPC reserve re-initialization failed");
+        return false;
+    }
+    const FCL_GEOMETRY_SNAPSHOT box = MakeBoxSnapshot({0.5f, 0.5f, 0.5f});
+    const FCL_TRANSFORM origin = IdentityTransform();
+    const FCL_TRANSFORM pose = MakeRotatedTransform(0.6f, {1.6f, 0.4f, 0.0f});
+    FCL_DISTANCE_RESULT passive = {};
+    FCL_DISTANCE_RESULT dispatch = {};
+    const NTSTATUS passiveStatus = FclUpstreamDistance(box, origin, box, pose, &passive);
+    KeRaiseIrql(DISPATCH_LEVEL, &oldIrql);
+    const NTSTATUS dispatchStatus = FclUpstreamDistance(box, origin, box, pose, &dispatch);
+    KeLowerIrql(oldIrql);
+    const FCL_DPC_RESERVE_STATS query = fclmusa::memory::QueryDpcReserveStats();
+    fclmusa::memory::ShutdownDpcReserve();
+    const FCL_POOL_STATS poolAfter = fclmusa::memory::QueryStats();
+    fclmusa::memory::EnablePoolTracking(FALSE);
+    if (!NT_SUCCESS(passiveStatus) || !NT_SUCCESS(dispatchStatus) ||
+        std::fabs(passive.Distance - dispatch.Distance) > kTolerance || query.Allocations == 0 ||
+        query.Exhaustions != 0 || query.Classes[0].BlocksInUse != 0 || query.Classes[1].BlocksInUse != 0 ||
+        query.Classes[2].BlocksInUse != 0 || poolAfter.BytesInUse != poolBefore.BytesInUse) {
+        FCL_LOG_ERROR("DPC reserve upstream query mismatch (status 0x%X, %llu reserve allocations)",
+            dispatchStatus, query.Allocations);
+        return false;
+    }
+    return true;
+}
+
+#if FCL_MUSA_ENABLE_ALLOC_PROFILING
+const FCL_ALLOC_PROFILE_ENTRY* FindProfileTag(const FCL_ALLOC_PROFILE& profile, ULONG tag) noexcept {
+    for (ULONG i = 0; i < profile.TagCount; ++i) {
+        if (profile.Tags[i].Key == tag) {
+            return &profile.Tags[i];
+        }
+    }
+    return nullptr;
+}
+#endif
+
+bool RunAllocationProfileSuite() noexcept {
+    static FCL_ALLOC_PROFILE profile = {};
+#if FCL_MUSA_ENABLE_ALLOC_PROFILING
+    constexpr ULONG kProfileTag = 'fPsT';
+    constexpr ULONG kOuterSite = FCL_ALLOC_SITE_USER_FIRST;
+    constexpr ULONG kInnerSite = FCL_ALLOC_SITE_USER_FIRST + 1;
+    FclResetAllocationProfile();
+
+    void* blocks[4] = {};
+    {
+        FCL_ALLOCATION_SITE(kOuterSite);
+        blocks[0] = fclmusa::memory::Allocate(8, kProfileTag);
+        blocks[1] = fclmusa::memory::Allocate(100, kProfileTag);
+        {
+            // 内层调用点覆盖外层，离开作用域后恢复。
+            FCL_ALLOCATION_SITE(kInnerSite);
+            blocks[2] = fclmusa::memory::Allocate(64, kProfileTag);
+        }
+        blocks[3] = fclmusa::memory::Allocate(5000, kProfileTag);
+    }
+    for (void* block : blocks) {
+        if (block == nullptr) {
+            FCL_LOG_ERROR0("Allocation profile test allocation failed");
+            return false;
+        }
+    }
+
+    NTSTATUS status = FclQueryAllocationProfile(&profile);
+    const FCL_ALLOC_PROFILE_ENTRY* tag = FindProfileTag(profile, kProfileTag);
+    const FCL_ALLOC_PROFILE_ENTRY& outer = profile.Sites[kOuterSite];
+    const FCL_ALLOC_PROFILE_ENTRY& inner = profile.Sites[kInnerSite];
+    bool ok = NT_SUCCESS(status) && profile.Enabled && tag != nullptr && tag->AllocationCount == 4 &&
+              tag->LiveBytes == 5172 && tag->PeakLiveBytes == 5172 && tag->SizeHistogram[0] == 1 &&
+              tag->SizeHistogram[2] == 1 && tag->SizeHistogram[3] == 1 && tag->SizeHistogram[9] == 1 &&
+              outer.AllocationCount == 3 && outer.LiveBytes == 5108 && inner.AllocationCount == 1 &&
+              inner.LiveBytes == 64;
+    if (!ok) {
+        FCL_LOG_ERROR("Allocation profile mismatch after allocation (status 0x%X)", status);
+    }
+
+    // 释放不在调用点作用域内，仍按块头记录的调用点回退。
+    for (void* block : blocks) {
+        fclmusa::memory::Free(block, kProfileTag);
+    }
+    status = FclQueryAllocationProfile(&profile);
+    tag = FindProfileTag(profile, kProfileTag);
+    if (!NT_SUCCESS(status) || tag == nullptr || tag->FreeCount != 4 || tag->LiveBytes != 0 ||
+        tag->PeakLiveBytes != 5172 || profile.Sites[kOuterSite].LiveBytes != 0 ||
+        profile.Sites[kInnerSite].FreeCount != 1) {
+        FCL_LOG_ERROR0("Allocation profile mismatch after free");
+        ok = false;
+    }
+
+    FclResetAllocationProfile();
+    status = FclQueryAllocationProfile(&profile);
+    tag = FindProfileTag(profile, kProfileTag);
+    if (!NT_SUCCESS(status) || tag == nullptr || tag->AllocationCount != 0 || tag->PeakLiveBytes != 0 ||
+        tag->SizeHistogram[9] != 0) {
+        FCL_LOG_ERROR0("Allocation profile reset mismatch");
+        ok = false;
+    }
+    return ok;
+#else
+    const NTSTATUS status = FclQueryAllocationProfile(&profile);
+    if (status != STATUS_NOT_SUPPORTED || profile.Enabled) {
+        FCL_LOG_ERROR("Allocation profile should be compiled out (status 0x%X)", status);
+        return false;
+    }
+    FclResetAllocationProfile();
+    return true;
+#endif
+}
+
+bool RunCcdObjectPoolSuite() noexcept {
+    using fclmusa::narrowphase::CcdObjectPoolScope;
+    // 与 libccd 多面体的面 / 边 / 顶点大小相当。
+    constexpr size_t kObjectSizes[3] = {80, 120, 152};
+    constexpr ULONG kObjectCount = 48;
+    fclmusa::memory::EnablePoolTracking(TRUE);
+    fclmusa::narrowphase::ResetCcdObjectPoolStats();
+    const FCL_POOL_STATS poolBefore = fclmusa::memory::QueryStats();
+
+    bool ok = true;
+    {
+        CcdObjectPoolScope scope;
+        CcdObjectPoolScope nested;
+        if (!scope.Active() || nested.Active()) {
+            FCL_LOG_ERROR0("CCD object pool scope activation mismatch");
+            return false;
+        }
+
+        void* objects[kObjectCount] = {};
+        for (ULONG i = 0; i < kObjectCount; ++i) {
+            objects[i] = FclCcdRealloc(nullptr, kObjectSizes[i % 3]);
+            if (objects[i] == nullptr || (reinterpret_cast<ULONG_PTR>(objects[i]) % 16) != 0) {
+                FCL_LOG_ERROR("CCD object pool allocation %lu failed or misaligned", i);
+                return false;
+            }
+            std::memset(objects[i], 0xCD, kObjectSizes[i % 3]);
+        }
+
+        // 释放一半后按相同大小重新分配，应全部复用空闲链表中的对象。
+        for (ULONG i = 0; i < kObjectCount; i += 2) {
+            FclCcdFree(objects[i]);
+        }
+        for (ULONG i = 0; i < kObjectCount; i += 2) {
+            objects[i] = FclCcdRealloc(nullptr, kObjectSizes[i % 3]);
+        }
+
+        // 复用的对象经 FclCcdCalloc 返回时必须清零。
+        FclCcdFree(objects[0]);
+        auto* zeroed = static_cast<unsigned char*>(FclCcdCalloc(1, kObjectSizes[0]));
+        ok = zeroed == objects[0];
+        for (size_t i = 0; ok && i < kObjectSizes[0]; ++i) {
+            ok = zeroed[i] == 0;
+        }
+        objects[0] = zeroed;
+
+        // 扩大到对象池上限以外：转发到 fclmusa::memory 并保留原内容，旧对象回到空闲链表。
+        auto* grown = static_cast<unsigned char*>(FclCcdRealloc(objects[1], 1024));
+        ok = ok && grown != nullptr && grown[0] == 0xCD && grown[kObjectSizes[1] - 1] == 0xCD;
+        objects[1] = grown;
+
+        for (void* object : objects) {
+            FclCcdFree(object);
+        }
+    }
+
+    const FCL_CCD_POOL_STATS stats = fclmusa::narrowphase::QueryCcdObjectPoolStats();
+    const FCL_POOL_STATS poolAfter = fclmusa::memory::QueryStats();
+    if (!ok || stats.ScopeCount != 1 || stats.ObjectAllocations != kObjectCount + kObjectCount / 2 + 1 ||
+        stats.RecycledAllocations != kObjectCount / 2 + 1 || stats.FallbackAllocations != 1 ||
+        stats.ObjectFrees != stats.ObjectAllocations || stats.ChunkAllocations == 0 ||
+        stats.ChunkAllocations > 4 || stats.PeakScopeObjects != kObjectCount ||
+        poolAfter.BytesInUse != poolBefore.BytesInUse) {
+        FCL_LOG_ERROR("CCD object pool mismatch (%llu allocations, %llu recycled, %llu chunks)",
+            stats.ObjectAllocations, stats.RecycledAllocations, stats.ChunkAllocations);
+        fclmusa::memory::EnablePoolTracking(FALSE);
+        return false;
+    }
+
+    // 深穿透的 upstream 查询：对象池开关不影响结果，查询结束后对象池的块全部归还。
+    // 关闭查询 arena，使对象池的块直接来自池分配，BytesInUse 不受 arena 保留块影响。
+    const FCL_GEOMETRY_SNAPSHOT capsule = MakeCapsuleSnapshot(0.4f, 0.6f, true);
+    const FCL_GEOMETRY_SNAPSHOT box = MakeBoxSnapshot({0.5f, 0.5f, 0.5f});
+    const FCL_TRANSFORM origin = IdentityTransform();
+    const FCL_TRANSFORM pose = MakeRotatedTransform(0.3f, {0.15f, 0.1f, 0.05f});
+    FCL_SOLVER_OPTIONS solver = {};
+    solver.Solver = FCL_GJK_SOLVER_LIBCCD;
+    BOOLEAN hit[2] = {};
+    FCL_CONTACT_INFO contact[2] = {};
+    NTSTATUS status[2] = {};
+    fclmusa::memory::EnableQueryArena(FALSE);
+    for (int enabled = 1; enabled >= 0; --enabled) {
+        fclmusa::narrowphase::EnableCcdObjectPool(enabled ? TRUE : FALSE);
+        status[enabled] = FclUpstreamCollide(capsule, origin, box, pose, &hit[enabled], &contact[enabled], &solver);
+    }
+    fclmusa::narrowphase::EnableCcdObjectPool(TRUE);
+    fclmusa::memory::EnableQueryArena(TRUE);
+    const FCL_CCD_POOL_STATS queryStats = fclmusa::narrowphase::QueryCcdObjectPoolStats();
+    const FCL_POOL_STATS poolQuery = fclmusa::memory::QueryStats();
+    fclmusa::memory::EnablePoolTracking(FALSE);
+    if (!NT_SUCCESS(status[0]) || !NT_SUCCESS(status[1]) || !hit[0] || !hit[1] ||
+        std::fabs(contact[0].PenetrationDepth - contact[1].PenetrationDepth) > kTolerance ||
+        queryStats.ScopeCount != 2 || queryStats.ObjectFrees - stats.ObjectFrees !=
+            queryStats.ObjectAllocations - stats.ObjectAllocations ||
+        poolQuery.BytesInUse != poolBefore.BytesInUse) {
+        FCL_LOG_ERROR("CCD object pool upstream query mismatch (status 0x%X / 0x%X)", status[1], status[0]);
+        return false;
+    }
+    return true;
+}
+
+NTSTATUS QueryLatency(
+    FCL_LATENCY_KIND kind,
+    ULONG type1,
+    ULONG type2,
+    ULONG flags,
+    FCL_LATENCY_HISTOGRAM* histogram) noexcept {
+    FCL_LATENCY_HISTOGRAM_QUERY query = {};
+    query.Kind = static_cast<ULONG>(kind);
+    query.Type1 = type1;
+    query.Type2 = type2;
+    query.Flags = flags;
+    return FclQueryLatencyHistogram(&query, histogram);
+}
+
+bool RunLatencyHistogramSuite() noexcept {
+    using fclmusa::diagnostics::LatencyBucketIndex;
+    using fclmusa::diagnostics::LatencyBucketLowerBound;
+    using fclmusa::diagnostics::LatencyBucketUpperBound;
+    using fclmusa::diagnostics::RecordLatency;
+
+    // 桶边界：[0, 8) 逐纳秒，之后每个 2 的幂区间 8 个子桶，桶宽不超过下界的 1/8。
+    const ULONGLONG samples[] = {0, 1, 7, 8, 15, 16, 17, 100, 1000, 12345, 999999, (1ULL << 29) + 5};
+    for (ULONGLONG value : samples) {
+        const ULONG bucket = LatencyBucketIndex(value);
+        const ULONGLONG lower = LatencyBucketLowerBound(bucket);
+        const ULONGLONG upper = LatencyBucketUpperBound(bucket);
+        if (bucket >= FCL_LATENCY_HISTOGRAM_BUCKETS || value < lower || value > upper ||
+            (lower >= 8 && (upper - lower + 1) * 8 > lower)) {
+            FCL_LOG_ERROR("Latency bucket %lu [%llu, %llu] does not cover %llu", bucket, lower, upper, value);
+            return false;
+        }
+    }
+    if (LatencyBucketIndex(1ULL << 40) != FCL_LATENCY_HISTOGRAM_BUCKETS - 1 ||
+        LatencyBucketIndex(16) != 16 || LatencyBucketIndex(17) != 16) {
+        FCL_LOG_ERROR0("Latency bucket index mismatch");
+        return false;
+    }
+
+    // 90 个 100 ns、9 个 10 us、1 个 1 ms：p50 / p90 落在 100 ns 所在桶，p99 在 10 us 桶，p99.9 截断到最大值。
+    static FCL_LATENCY_HISTOGRAM histogram = {};
+    FclResetLatencyHistograms();
+    for (int i = 0; i < 90; ++i) {
+        RecordLatency(FCL_LATENCY_COLLISION, FCL_GEOMETRY_MESH, FCL_GEOMETRY_SPHERE, 100);
+    }
+    for (int i = 0; i < 9; ++i) {
+        RecordLatency(FCL_LATENCY_COLLISION, FCL_GEOMETRY_SPHERE, FCL_GEOMETRY_MESH, 10000);
+    }
+    RecordLatency(FCL_LATENCY_COLLISION, FCL_GEOMETRY_OBB, FCL_GEOMETRY_OBB, 1000000);
+
+    NTSTATUS status = QueryLatency(FCL_LATENCY_COLLISION, 0, 0, 0, &histogram);
+    if (!NT_SUCCESS(status) || histogram.Count != 100 || histogram.MinNanoseconds != 100 ||
+        histogram.MaxNanoseconds != 1000000 || histogram.TotalNanoseconds != 90 * 100 + 9 * 10000 + 1000000 ||
+        histogram.P50Nanoseconds != LatencyBucketUpperBound(LatencyBucketIndex(100)) ||
+        histogram.P90Nanoseconds != histogram.P50Nanoseconds ||
+        histogram.P99Nanoseconds != LatencyBucketUpperBound(LatencyBucketIndex(10000)) ||
+        histogram.P999Nanoseconds != 1000000 || histogram.Buckets[LatencyBucketIndex(100)] != 90) {
+        FCL_LOG_ERROR(
+            "Latency aggregate mismatch (status 0x%X, count %llu, p50 %llu, p99 %llu, p99.9 %llu)",
+            status,
+            histogram.Count,
+            histogram.P50Nanoseconds,
+            histogram.P99Nanoseconds,
+            histogram.P999Nanoseconds);
+        return false;
+    }
+
+    // 类型对与顺序无关，按规范化后的 (低, 高) 返回。
+    status = QueryLatency(FCL_LATENCY_COLLISION, FCL_GEOMETRY_MESH, FCL_GEOMETRY_SPHERE, 0, &histogram);
+    if (!NT_SUCCESS(status) || histogram.Type1 != FCL_GEOMETRY_SPHERE || histogram.Type2 != FCL_GEOMETRY_MESH ||
+        histogram.Count != 99 || histogram.MaxNanoseconds != 10000) {
+        FCL_LOG_ERROR("Latency pair histogram mismatch (status 0x%X, count %llu)", status, histogram.Count);
+        return false;
+    }
+    status = QueryLatency(FCL_LATENCY_DISTANCE, FCL_GEOMETRY_SPHERE, FCL_GEOMETRY_MESH, 0, &histogram);
+    if (!NT_SUCCESS(status) || histogram.Count != 0 || histogram.P99Nanoseconds != 0) {
+        FCL_LOG_ERROR0("Latency histogram leaked across query kinds");
+        return false;
+    }
+
+    if (QueryLatency(FCL_LATENCY_KIND_COUNT, 0, 0, 0, &histogram) != STATUS_INVALID_PARAMETER ||
+        QueryLatency(FCL_LATENCY_COLLISION, FCL_GEOMETRY_SPHERE, 0, 0, &histogram) != STATUS_INVALID_PARAMETER ||
+        QueryLatency(FCL_LATENCY_COLLISION, FCL_GEOMETRY_SPHERE, 8, 0, &histogram) != STATUS_INVALID_PARAMETER ||
+        QueryLatency(FCL_LATENCY_COLLISION, 0, 0, 0x2, &histogram) != STATUS_INVALID_PARAMETER) {
+        FCL_LOG_ERROR0("Latency histogram accepted an invalid query");
+        return false;
+    }
+
+    // 读后清零只清所读的直方图：汇总清零后类型对直方图仍保留。
+    status = QueryLatency(FCL_LATENCY_COLLISION, 0, 0, FCL_LATENCY_QUERY_FLAG_RESET, &histogram);
+    const ULONGLONG windowCount = histogram.Count;
+    NTSTATUS nextStatus = QueryLatency(FCL_LATENCY_COLLISION, 0, 0, 0, &histogram);
+    if (!NT_SUCCESS(status) || !NT_SUCCESS(nextStatus) || windowCount != 100 || histogram.Count != 0 ||
+        histogram.MinNanoseconds != 0 || histogram.MaxNanoseconds != 0) {
+        FCL_LOG_ERROR("Latency reset-on-read mismatch (window %llu, after %llu)", windowCount, histogram.Count);
+        return false;
+    }
+    status = QueryLatency(FCL_LATENCY_COLLISION, FCL_GEOMETRY_OBB, FCL_GEOMETRY_OBB, 0, &histogram);
+    if (!NT_SUCCESS(status) || histogram.Count != 1) {
+        FCL_LOG_ERROR0("Latency reset-on-read cleared an unrelated histogram");
+        return false;
+    }
+
+    // 多线程并发记录落在不同分片上，汇总后一个不少。
+    constexpr int kThreads = 4;
+    constexpr int kRecordsPerThread = 20000;
+    FclResetLatencyHistograms();
+    std::thread workers[kThreads];
+    for (int t = 0; t < kThreads; ++t) {
+        workers[t] = std::thread([t]() {
+            for (int i = 0; i < kRecordsPerThread; ++i) {
+                RecordLatency(
+                    FCL_LATENCY_DISTANCE,
+                    FCL_GEOMETRY_CONVEX,
+                    FCL_GEOMETRY_OBB,
+                    static_cast<ULONGLONG>(50 + 1000 * t + (i % 7)));
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    status = QueryLatency(FCL_LATENCY_DISTANCE, 0, 0, 0, &histogram);
+    nextStatus = QueryLatency(FCL_LATENCY_DISTANCE, FCL_GEOMETRY_OBB, FCL_GEOMETRY_CONVEX, 0, &histogram);
+    if (!NT_SUCCESS(status) || !NT_SUCCESS(nextStatus) || histogram.Count != kThreads * kRecordsPerThread ||
+        histogram.MinNanoseconds != 50 || histogram.MaxNanoseconds != 3056) {
+        FCL_LOG_ERROR("Concurrent latency recording lost samples (count %llu)", histogram.Count);
+        return false;
+    }
+
+    // 公开查询接口的计时经由诊断回调计入直方图。
+    GeometryHandle sphere;
+    GeometryHandle box;
+    if (!NT_SUCCESS(CreateSphere(0.5f, sphere)) || !NT_SUCCESS(CreateBoxMesh(0.5f, box))) {
+        FCL_LOG_ERROR0("Latency histogram geometry creation failed");
+        return false;
+    }
+    FclResetLatencyHistograms();
+    FCL_TRANSFORM transform = IdentityTransform();
+    transform.Translation.X = 0.8f;
+    BOOLEAN isColliding = FALSE;
+    FCL_CONTACT_INFO contact = {};
+    FCL_DISTANCE_RESULT distance = {};
+    status = FclCollisionDetect(sphere.handle, nullptr, box.handle, &transform, &isColliding, &contact);
+    nextStatus = FclDistanceCompute(sphere.handle, nullptr, box.handle, &transform, &distance);
+    if (!NT_SUCCESS(status) || !NT_SUCCESS(nextStatus)) {
+        FCL_LOG_ERROR("Latency histogram queries failed (0x%X, 0x%X)", status, nextStatus);
+        return false;
+    }
+    FCL_LATENCY_HISTOGRAM_QUERY query = {};
+    query.Kind = FCL_LATENCY_COLLISION;
+    query.Type1 = FCL_GEOMETRY_SPHERE;
+    query.Type2 = FCL_GEOMETRY_MESH;
+    status = FclQueryLatencyHistogram(&query, &histogram);
+    const ULONGLONG collisionCount = histogram.Count;
+    query.Kind = FCL_LATENCY_DISTANCE;
+    nextStatus = FclQueryLatencyHistogram(&query, &histogram);
+    if (!NT_SUCCESS(status) || !NT_SUCCESS(nextStatus) || collisionCount != 1 || histogram.Count != 1) {
+        FCL_LOG_ERROR(
+            "Public queries were not recorded (collision %llu, distance %llu)", collisionCount, histogram.Count);
+        return false;
+    }
+    FclResetLatencyHistograms();
+    return true;
+}
+
+NTSTATUS QueryPhaseTrace(ULONG flags, PFCL_PHASE_TRACE_SNAPSHOT snapshot) noexcept {
+    FCL_PHASE_TRACE_QUERY query = {};
+    query.Flags = flags;
+    return FclQueryPhaseTrace(&query, snapshot);
+}
+
+bool RunPhaseTraceSuite() noexcept {
+    static FCL_PHASE_TRACE_SNAPSHOT snapshot = {};
+#if FCL_MUSA_ENABLE_PHASE_TRACING
+    using fclmusa::diagnostics::RecordPhase;
+
+    GeometryHandle sphere;
+    GeometryHandle box;
+    if (!NT_SUCCESS(CreateSphere(0.5f, sphere)) || !NT_SUCCESS(CreateBoxMesh(0.5f, box))) {
+        FCL_LOG_ERROR0("Phase trace geometry creation failed");
+        return false;
+    }
+
+    // 一次 upstream 碰撞：2 次句柄获取、2 次绑定构建、1 次窄阶段、1 次结果转换，外层入口 1 次。
+    FclResetPhaseTrace();
+    FclEnablePhaseTraceRing(TRUE);
+    FCL_GEOMETRY_REFERENCE sphereReference = {};
+    FCL_GEOMETRY_REFERENCE boxReference = {};
+    FCL_GEOMETRY_SNAPSHOT sphereSnapshot = {};
+    FCL_GEOMETRY_SNAPSHOT boxSnapshot = {};
+    NTSTATUS status = FclAcquireGeometryReference(sphere.handle, &sphereReference, &sphereSnapshot);
+    NTSTATUS nextStatus = FclAcquireGeometryReference(box.handle, &boxReference, &boxSnapshot);
+    FCL_TRANSFORM transform = IdentityTransform();
+    transform.Translation.X = 0.8f;
+    const FCL_TRANSFORM origin = IdentityTransform();
+    BOOLEAN isColliding = FALSE;
+    FCL_CONTACT_INFO contact = {};
+    if (NT_SUCCESS(status) && NT_SUCCESS(nextStatus)) {
+        status = FclUpstreamCollide(sphereSnapshot, origin, boxSnapshot, transform, &isColliding, &contact, nullptr);
+    }
+    FclReleaseGeometryReference(&sphereReference);
+    FclReleaseGeometryReference(&boxReference);
+    if (!NT_SUCCESS(status) || !NT_SUCCESS(nextStatus) || !isColliding) {
+        FCL_LOG_ERROR("Phase trace collision failed (0x%X, 0x%X)", status, nextStatus);
+        return false;
+    }
+
+    status = QueryPhaseTrace(0, &snapshot);
+    const FCL_PHASE_STATS* phases = snapshot.Phases;
+    const ULONGLONG innerCycles = phases[FCL_TRACE_PHASE_BINDING_BUILD].TotalCycles +
+                                  phases[FCL_TRACE_PHASE_NARROWPHASE].TotalCycles +
+                                  phases[FCL_TRACE_PHASE_RESULT_CONVERSION].TotalCycles;
+    if (!NT_SUCCESS(status) || !snapshot.Enabled || !snapshot.RingEnabled ||
+        phases[FCL_TRACE_PHASE_HANDLE_ACQUIRE].Count != 2 || phases[FCL_TRACE_PHASE_BINDING_BUILD].Count != 2 ||
+        phases[FCL_TRACE_PHASE_NARROWPHASE].Count != 1 || phases[FCL_TRACE_PHASE_RESULT_CONVERSION].Count != 1 ||
+        phases[FCL_TRACE_PHASE_UPSTREAM_QUERY].Count != 1 ||
+        phases[FCL_TRACE_PHASE_UPSTREAM_QUERY].TotalCycles < innerCycles ||
+        phases[FCL_TRACE_PHASE_BINDING_BUILD].MinCycles > phases[FCL_TRACE_PHASE_BINDING_BUILD].MaxCycles) {
+        FCL_LOG_ERROR(
+            "Phase statistics mismatch (status 0x%X, acquire %llu, binding %llu, narrowphase %llu)",
+            status,
+            phases[FCL_TRACE_PHASE_HANDLE_ACQUIRE].Count,
+            phases[FCL_TRACE_PHASE_BINDING_BUILD].Count,
+            phases[FCL_TRACE_PHASE_NARROWPHASE].Count);
+        return false;
+    }
+
+    // 事件按完成顺序写入：外层入口最后完成，且时间上包住内层阶段。
+    const FCL_PHASE_TRACE_EVENT& outer = snapshot.Events[snapshot.EventCount - 1];
+    bool ok = snapshot.EventCount == 7 && snapshot.TotalEvents == 7 && outer.Phase == FCL_TRACE_PHASE_UPSTREAM_QUERY;
+    for (ULONG i = 0; ok && i < snapshot.EventCount; ++i) {
+        const FCL_PHASE_TRACE_EVENT& event = snapshot.Events[i];
+        ok = event.Sequence == i + 1;
+        if (ok && i >= 2 && i + 1 < snapshot.EventCount) {
+            ok = event.StartCycles >= outer.StartCycles &&
+                 event.StartCycles + event.DurationCycles <= outer.StartCycles + outer.DurationCycles;
+        }
+    }
+    if (!ok) {
+        FCL_LOG_ERROR("Phase trace events mismatch (count %lu, total %llu)", snapshot.EventCount, snapshot.TotalEvents);
+        return false;
+    }
+
+    // 写满后覆盖最旧的事件；读后清零丢弃已读范围并清零统计。
+    constexpr ULONG kOverflow = 10;
+    for (ULONG i = 0; i < FCL_PHASE_TRACE_RING_CAPACITY + kOverflow; ++i) {
+        RecordPhase(FCL_TRACE_PHASE_NARROWPHASE, 1000 * i, 1000 * i + 10);
+    }
+    status = QueryPhaseTrace(FCL_PHASE_TRACE_FLAG_RESET, &snapshot);
+    const ULONGLONG expectedTotal = 7 + FCL_PHASE_TRACE_RING_CAPACITY + kOverflow;
+    if (!NT_SUCCESS(status) || snapshot.EventCount != FCL_PHASE_TRACE_RING_CAPACITY ||
+        snapshot.TotalEvents != expectedTotal ||
+        snapshot.Events[0].Sequence != expectedTotal - FCL_PHASE_TRACE_RING_CAPACITY + 1 ||
+        snapshot.Events[FCL_PHASE_TRACE_RING_CAPACITY - 1].Sequence != expectedTotal ||
+        snapshot.Events[FCL_PHASE_TRACE_RING_CAPACITY - 1].DurationCycles != 10 ||
+        snapshot.Phases[FCL_TRACE_PHASE_NARROWPHASE].Count != 1 + FCL_PHASE_TRACE_RING_CAPACITY + kOverflow) {
+        FCL_LOG_ERROR(
+            "Phase trace ring overflow mismatch (count %lu, total %llu)", snapshot.EventCount, snapshot.TotalEvents);
+        return false;
+    }
+    status = QueryPhaseTrace(FCL_PHASE_TRACE_FLAG_DISABLE_RING, &snapshot);
+    if (!NT_SUCCESS(status) || snapshot.EventCount != 0 || snapshot.TotalEvents != 0 ||
+        snapshot.Phases[FCL_TRACE_PHASE_NARROWPHASE].Count != 0) {
+        FCL_LOG_ERROR0("Phase trace reset-on-read mismatch");
+        return false;
+    }
+
+    // 环形缓冲区关闭后只累计统计。
+    RecordPhase(FCL_TRACE_PHASE_BINDING_BUILD, 100, 150);
+    status = QueryPhaseTrace(0, &snapshot);
+    if (!NT_SUCCESS(status) || snapshot.RingEnabled || snapshot.EventCount != 0 ||
+        snapshot.Phases[FCL_TRACE_PHASE_BINDING_BUILD].Count != 1 ||
+        snapshot.Phases[FCL_TRACE_PHASE_BINDING_BUILD].MinCycles != 50) {
+        FCL_LOG_ERROR0("Phase trace ring did not stop");
+        return false;
+    }
+    if (QueryPhaseTrace(0x8, &snapshot) != STATUS_INVALID_PARAMETER) {
+        FCL_LOG_ERROR0("Phase trace accepted unknown flags");
+        return false;
+    }
+
+    // 多线程并发写入：统计一个不少，读出的事件序号严格递增。
+    constexpr int kThreads = 4;
+    constexpr int kRecordsPerThread = 5000;
+    FclResetPhaseTrace();
+    FclEnablePhaseTraceRing(TRUE);
+    std::thread workers[kThreads];
+    for (int t = 0; t < kThreads; ++t) {
+        workers[t] = std::thread([t]() {
+            for (int i = 0; i < kRecordsPerThread; ++i) {
+                RecordPhase(FCL_TRACE_PHASE_RESULT_CONVERSION, i, i + 1 + t);
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    status = QueryPhaseTrace(FCL_PHASE_TRACE_FLAG_RESET | FCL_PHASE_TRACE_FLAG_DISABLE_RING, &snapshot);
+    ok = NT_SUCCESS(status) && snapshot.TotalEvents == kThreads * kRecordsPerThread &&
+         snapshot.EventCount == FCL_PHASE_TRACE_RING_CAPACITY &&
+         snapshot.Phases[FCL_TRACE_PHASE_RESULT_CONVERSION].Count == kThreads * kRecordsPerThread &&
+         snapshot.Phases[FCL_TRACE_PHASE_RESULT_CONVERSION].MinCycles == 1 &&
+         snapshot.Phases[FCL_TRACE_PHASE_RESULT_CONVERSION].MaxCycles == kThreads;
+    for (ULONG i = 1; ok && i < snapshot.EventCount; ++i) {
+        ok = snapshot.Events[i].Sequence > snapshot.Events[i - 1].Sequence &&
+             snapshot.Events[i].Phase == FCL_TRACE_PHASE_RESULT_CONVERSION;
+    }
+    if (!ok) {
+        FCL_LOG_ERROR(
+            "Concurrent phase tracing mismatch (total %llu, events %lu)", snapshot.TotalEvents, snapshot.EventCount);
+        return false;
+    }
+    FclResetPhaseTrace();
+    return true;
+#else
+    const NTSTATUS status = QueryPhaseTrace(0, &snapshot);
+    if (status != STATUS_NOT_SUPPORTED || snapshot.Enabled || FclEnablePhaseTraceRing(TRUE) != STATUS_NOT_SUPPORTED) {
+        FCL_LOG_ERROR("Phase tracing should be compiled out (status 0x%X)", status);
+        return false;
+    }
+    FclResetPhaseTrace();
+    return true;
+#endif
+}
+
+// 分段读出轨迹（每次 chunkBytes 字节），返回读出的总长度；失败返回 0。
+ULONGLONG ReadWorkloadTrace(UCHAR* buffer, ULONG capacity, ULONG chunkBytes) noexcept {
+    ULONGLONG offset = 0;
+    for (;;) {
+        const ULONG room = static_cast<ULONG>(capacity - offset);
+        ULONG bytesRead = 0;
+        const NTSTATUS status =
+            FclReadWorkloadRecording(offset, buffer + offset, (room < chunkBytes) ? room : chunkBytes, &bytesRead);
+        if (!NT_SUCCESS(status)) {
+            return 0;
+        }
+        if (bytesRead == 0) {
+            return offset;
+        }
+        offset += bytesRead;
+    }
+}
+
+// 遍历记录并按类型计数；记录头越界或类型未知时返回 false。
+bool WalkWorkloadTrace(const UCHAR* trace,
+    ULONGLONG traceBytes,
+    ULONG (&counts)[FCL_WORKLOAD_RECORD_TYPE_COUNT],
+    ULONGLONG* recordCount) noexcept {
+    RtlZeroMemory(counts, sizeof(counts));
+    *recordCount = 0;
+    for (ULONGLONG offset = sizeof(FCL_WORKLOAD_TRACE_HEADER); offset < traceBytes;) {
+        const auto* record = reinterpret_cast<const FCL_WORKLOAD_RECORD_HEADER*>(trace + offset);
+        if (record->Size < sizeof(*record) || (record->Size % 8) != 0 || record->Size > traceBytes - offset ||
+            record->Type == 0 || record->Type >= FCL_WORKLOAD_RECORD_TYPE_COUNT) {
+            return false;
+        }
+        ++counts[record->Type];
+        ++*recordCount;
+        offset += record->Size;
+    }
+    return true;
+}
+
+bool RunWorkloadRecordingSuite() noexcept {
+    static UCHAR trace[256 * 1024];
+    FclDiscardWorkloadRecording();
+
+    GeometryHandle existing;
+    if (!NT_SUCCESS(CreateSphere(0.5f, existing))) {
+        FCL_LOG_ERROR0("Workload recording geometry creation failed");
+        return false;
+    }
+
+    FCL_WORKLOAD_RECORDING_CONFIG config = {};
+    config.CapacityBytes = 1024;
+    if (FclStartWorkloadRecording(&config) != STATUS_INVALID_PARAMETER) {
+        FCL_LOG_ERROR0("Workload recording accepted a capacity below one page");
+        return false;
+    }
+    config.CapacityBytes = sizeof(trace);
+    NTSTATUS status = FclStartWorkloadRecording(&config);
+    if (!NT_SUCCESS(status) || FclStartWorkloadRecording(&config) != STATUS_DEVICE_BUSY) {
+        FCL_LOG_ERROR("Workload recording start failed: 0x%X", status);
+        return false;
+    }
+    ULONG bytesRead = 0;
+    if (FclReadWorkloadRecording(0, trace, sizeof(trace), &bytesRead) != STATUS_INVALID_DEVICE_STATE) {
+        FCL_LOG_ERROR0("Workload trace readable while recording");
+        FclDiscardWorkloadRecording();
+        return false;
+    }
+
+    // 录制期间：Mesh 创建与更新、复合体、失败的创建、各类查询入口，最后销毁复合体。
+    const FCL_VECTOR3 vertices[] = {{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+    const FCL_VECTOR3 grown[] = {{0.0f, 0.0f, 0.0f}, {2.0f, 0.0f, 0.0f}, {0.0f, 2.0f, 0.0f}, {0.0f, 0.0f, 2.0f}};
+    const UINT32 indices[] = {0, 2, 1, 0, 1, 3, 0, 3, 2, 1, 2, 3};
+    FCL_MESH_GEOMETRY_DESC meshDesc = {};
+    meshDesc.Vertices = vertices;
+    meshDesc.VertexCount = 4;
+    meshDesc.Indices = indices;
+    meshDesc.IndexCount = 12;
+    GeometryHandle mesh;
+    GeometryHandle compound;
+    FCL_COMPOUND_CHILD_DESC children[2] = {};
+    children[0].Geometry = existing.handle;
+    children[0].LocalTransform = IdentityTransform();
+    status = FclCreateGeometry(FCL_GEOMETRY_MESH, &meshDesc, &mesh.handle);
+    if (NT_SUCCESS(status)) {
+        children[1].Geometry = mesh.handle;
+        children[1].LocalTransform = MakeRotatedTransform(0.0f, {2.0f, 0.0f, 0.0f});
+        FCL_COMPOUND_GEOMETRY_DESC compoundDesc = {};
+        compoundDesc.Children = children;
+        compoundDesc.ChildCount = 2;
+        status = FclCreateGeometry(FCL_GEOMETRY_COMPOUND, &compoundDesc, &compound.handle);
+    }
+    FCL_GEOMETRY_HANDLE rejected = {};
+    const NTSTATUS rejectedStatus = FclCreateGeometry(FCL_GEOMETRY_SPHERE, nullptr, &rejected);
+
+    const FCL_TRANSFORM offset = MakeRotatedTransform(0.0f, {0.3f, 0.0f, 0.0f});
+    BOOLEAN isColliding = FALSE;
+    FCL_DISTANCE_RESULT distance = {};
+    FCL_CONTINUOUS_COLLISION_QUERY ccd = {};
+    FCL_CONTINUOUS_COLLISION_RESULT ccdResult = {};
+    FCL_BROADPHASE_OBJECT objects[2] = {{existing.handle, nullptr}, {mesh.handle, &offset}};
+    FCL_BROADPHASE_PAIR pairs[4] = {};
+    ULONG pairCount = 0;
+    FCL_COLLISION_OBJECT_DESC collideA = {existing.handle, IdentityTransform()};
+    FCL_COLLISION_OBJECT_DESC collideB = {mesh.handle, offset};
+    FCL_CONTACT_INFO contacts[4] = {};
+    FCL_COLLISION_QUERY_REQUEST request = {};
+    request.MaxContacts = RTL_NUMBER_OF(contacts);
+    request.EnableContactInfo = TRUE;
+    request.Contacts = contacts;
+    FCL_COLLISION_QUERY_RESULT collideResult = {};
+    BOOLEAN compoundColliding = FALSE;
+    FCL_COMPOUND_CHILD_PAIR childPair = {};
+    FCL_DISTANCE_RESULT compoundDistance = {};
+    FCL_SCREW_CONTINUOUS_COLLISION_QUERY screw = {};
+    FCL_CONTINUOUS_COLLISION_RESULT screwResult = {};
+    FCL_CONTINUOUS_BATCH_OBJECT batchObjects[2] = {};
+    FCL_CONTINUOUS_BATCH_QUERY batch = {};
+    FCL_CONTINUOUS_BATCH_RESULT batchResult = {};
+    if (NT_SUCCESS(status)) {
+        status = FclCollisionDetect(existing.handle, nullptr, mesh.handle, &offset, &isColliding, nullptr);
+    }
+    if (NT_SUCCESS(status)) {
+        status = FclCollideObjects(&collideA, &collideB, &request, &collideResult);
+    }
+    if (NT_SUCCESS(status)) {
+        status = FclCompoundCollisionDetect(
+            existing.handle, nullptr, compound.handle, &offset, &compoundColliding, nullptr, &childPair);
+    }
+    if (NT_SUCCESS(status)) {
+        status = FclDistanceCompute(existing.handle, nullptr, compound.handle, &offset, &distance);
+    }
+    if (NT_SUCCESS(status)) {
+        status = FclCompoundDistanceCompute(
+            existing.handle, nullptr, compound.handle, &offset, &compoundDistance, &childPair);
+    }
+    if (NT_SUCCESS(status)) {
+        ccd.Object1 = existing.handle;
+        ccd.Motion1 = MakeLinearMotion(0.0f, {-3.0f, 0.3f, 0.3f}, {3.0f, 0.3f, 0.3f});
+        ccd.Object2 = mesh.handle;
+        ccd.Motion2 = MakeLinearMotion(0.0f, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f});
+        status = FclContinuousCollision(&ccd, &ccdResult);
+    }
+    if (NT_SUCCESS(status)) {
+        // 与线性 CCD 相同的扫掠，以沿 X 轴平移的螺旋运动表示。
+        screw.Object1 = existing.handle;
+        screw.Motion1.Start = MakeRotatedTransform(0.0f, {-3.0f, 0.3f, 0.3f});
+        screw.Motion1.Axis = {1.0f, 0.0f, 0.0f};
+        screw.Motion1.LinearVelocity = 6.0f;
+        screw.Object2 = mesh.handle;
+        screw.Motion2.Start = IdentityTransform();
+        screw.Motion2.Axis = {1.0f, 0.0f, 0.0f};
+        status = FclScrewContinuousCollision(&screw, &screwResult);
+    }
+    if (NT_SUCCESS(status)) {
+        batchObjects[0].Handle = existing.handle;
+        batchObjects[0].Motion = ccd.Motion1;
+        batchObjects[1].Handle = mesh.handle;
+        batchObjects[1].Motion = ccd.Motion2;
+        batch.Objects = batchObjects;
+        batch.ObjectCount = RTL_NUMBER_OF(batchObjects);
+        status = FclContinuousCollisionBatch(&batch, nullptr, &batchResult);
+    }
+    if (NT_SUCCESS(status)) {
+        status = FclBroadphaseDetect(objects, 2, pairs, 4, &pairCount);
+    }
+    if (NT_SUCCESS(status)) {
+        meshDesc.Vertices = grown;
+        status = FclUpdateMeshGeometry(mesh.handle, &meshDesc);
+    }
+    const ULONGLONG compoundValue = compound.handle.Value;
+    compound.Release();
+    const NTSTATUS stopStatus = FclStopWorkloadRecording();
+    if (!NT_SUCCESS(status) || NT_SUCCESS(rejectedStatus) || !NT_SUCCESS(stopStatus) || !isColliding ||
+        !collideResult.Intersecting || !compoundColliding || !ccdResult.Intersecting || batchResult.HitPairCount != 1 ||
+        pairCount != 1 || FclStopWorkloadRecording() != STATUS_INVALID_DEVICE_STATE) {
+        FCL_LOG_ERROR("Workload recording calls failed (0x%X, stop 0x%X, pairs %lu)", status, stopStatus, pairCount);
+        FclDiscardWorkloadRecording();
+        return false;
+    }
+
+    // 录制结束后新的调用不再写入；分段读出的长度与文件头一致。
+    BOOLEAN ignored = FALSE;
+    FclCollisionDetect(existing.handle, nullptr, mesh.handle, nullptr, &ignored, nullptr);
+    FCL_WORKLOAD_RECORDING_STATUS recording = {};
+    FclQueryWorkloadRecording(&recording);
+    const ULONGLONG traceBytes = ReadWorkloadTrace(trace, sizeof(trace), 100);
+    const auto* header = reinterpret_cast<const FCL_WORKLOAD_TRACE_HEADER*>(trace);
+    ULONG counts[FCL_WORKLOAD_RECORD_TYPE_COUNT] = {};
+    ULONGLONG recordCount = 0;
+    if (recording.Recording || !recording.HasTrace || traceBytes != recording.TraceBytes ||
+        traceBytes < sizeof(*header) || header->Magic != FCL_WORKLOAD_TRACE_MAGIC ||
+        header->TraceBytes != traceBytes || header->DroppedRecords != 0 || header->TimestampFrequency == 0 ||
+        !WalkWorkloadTrace(trace, traceBytes, counts, &recordCount) || recordCount != header->RecordCount ||
+        recordCount != recording.RecordCount) {
+        FCL_LOG_ERROR("Workload trace header mismatch (%llu bytes, %llu records)", traceBytes, recordCount);
+        FclDiscardWorkloadRecording();
+        return false;
+    }
+    // 已存在的几何数量取决于之前的用例，只检查录制期间的调用。
+    if (counts[FCL_WORKLOAD_RECORD_COLLISION] != 1 || counts[FCL_WORKLOAD_RECORD_DISTANCE] != 1 ||
+        counts[FCL_WORKLOAD_RECORD_COLLIDE_OBJECTS] != 1 || counts[FCL_WORKLOAD_RECORD_COMPOUND_COLLISION] != 1 ||
+        counts[FCL_WORKLOAD_RECORD_COMPOUND_DISTANCE] != 1 || counts[FCL_WORKLOAD_RECORD_CONTINUOUS_COLLISION] != 1 ||
+        counts[FCL_WORKLOAD_RECORD_SCREW_CONTINUOUS_COLLISION] != 1 ||
+        counts[FCL_WORKLOAD_RECORD_CONTINUOUS_BATCH] != 1 || counts[FCL_WORKLOAD_RECORD_BROADPHASE] != 1 ||
+        counts[FCL_WORKLOAD_RECORD_UPDATE_MESH] != 1 || counts[FCL_WORKLOAD_RECORD_DESTROY] != 1 ||
+        counts[FCL_WORKLOAD_RECORD_GEOMETRY] < 4) {
+        FCL_LOG_ERROR("Workload record counts mismatch (geometry %lu, collision %lu, destroy %lu)",
+            counts[FCL_WORKLOAD_RECORD_GEOMETRY],
+            counts[FCL_WORKLOAD_RECORD_COLLISION],
+            counts[FCL_WORKLOAD_RECORD_DESTROY]);
+        FclDiscardWorkloadRecording();
+        return false;
+    }
+
+    // 逐条核对内容：已存在的球、Mesh 顶点 / 索引、复合体子形状、失败的创建、查询参数与结果。
+    bool sawExisting = false;
+    bool sawMesh = false;
+    bool sawCompound = false;
+    bool sawRejected = false;
+    bool ok = true;
+    ULONGLONG previousTimestamp = 0;
+    for (ULONGLONG position = header->HeaderSize; ok && position < traceBytes;) {
+        const auto* record = reinterpret_cast<const FCL_WORKLOAD_RECORD_HEADER*>(trace + position);
+        position += record->Size;
+        if ((record->Flags & FCL_WORKLOAD_RECORD_FLAG_EXISTING) != 0) {
+            const auto* geometry = reinterpret_cast<const FCL_WORKLOAD_GEOMETRY_RECORD*>(record);
+            if (geometry->Handle.Value == existing.handle.Value) {
+                sawExisting = true;
+                ok = record->Type == FCL_WORKLOAD_RECORD_GEOMETRY && record->Timestamp == 0 &&
+                     geometry->GeometryType == FCL_GEOMETRY_SPHERE && geometry->Shape.Sphere.Radius == 0.5f;
+            }
+            continue;
+        }
+        // 单线程调用按开始顺序写入。
+        ok = record->Timestamp >= previousTimestamp;
+        previousTimestamp = record->Timestamp;
+        if (!ok) {
+            break;
+        }
+        switch (record->Type) {
+            case FCL_WORKLOAD_RECORD_GEOMETRY: {
+                const auto* geometry = reinterpret_cast<const FCL_WORKLOAD_GEOMETRY_RECORD*>(record);
+                if (geometry->Handle.Value == mesh.handle.Value) {
+                    const auto* payload = reinterpret_cast<const FCL_VECTOR3*>(geometry + 1);
+                    const auto* recordedIndices = reinterpret_cast<const UINT32*>(payload + 4);
+                    sawMesh = true;
+                    ok = geometry->GeometryType == FCL_GEOMETRY_MESH && geometry->ElementCount0 == 4 &&
+                         geometry->ElementCount1 == 12 && payload[1].X == 1.0f && recordedIndices[11] == 3;
+                } else if (geometry->GeometryType == FCL_GEOMETRY_COMPOUND) {
+                    const auto* recordedChildren = reinterpret_cast<const FCL_COMPOUND_CHILD_DESC*>(geometry + 1);
+                    sawCompound = true;
+                    ok = geometry->ElementCount0 == 2 && recordedChildren[0].Geometry.Value == existing.handle.Value &&
+                         recordedChildren[1].Geometry.Value == mesh.handle.Value &&
+                         recordedChildren[1].LocalTransform.Translation.X == 2.0f;
+                } else if (geometry->Handle.Value == 0) {
+                    sawRejected = true;
+                    ok = record->Status == STATUS_INVALID_PARAMETER && record->Size == sizeof(*geometry);
+                }
+                break;
+            }
+            case FCL_WORKLOAD_RECORD_UPDATE_MESH: {
+                const auto* geometry = reinterpret_cast<const FCL_WORKLOAD_GEOMETRY_RECORD*>(record);
+                ok = geometry->Handle.Value == mesh.handle.Value && geometry->ElementCount0 == 4 &&
+                     reinterpret_cast<const FCL_VECTOR3*>(geometry + 1)[1].X == 2.0f;
+                break;
+            }
+            case FCL_WORKLOAD_RECORD_COLLISION: {
+                const auto* pair = reinterpret_cast<const FCL_WORKLOAD_PAIR_RECORD*>(record);
+                ok = pair->Handle1.Value == existing.handle.Value && pair->Handle2.Value == mesh.handle.Value &&
+                     pair->Flags == FCL_WORKLOAD_PAIR_FLAG_TRANSFORM2 && pair->Transform2.Translation.X == 0.3f &&
+                     pair->Intersecting && NT_SUCCESS(record->Status);
+                break;
+            }
+            case FCL_WORKLOAD_RECORD_COLLIDE_OBJECTS: {
+                const auto* collide = reinterpret_cast<const FCL_WORKLOAD_COLLIDE_OBJECTS_RECORD*>(record);
+                ok = collide->Object1.Geometry.Value == existing.handle.Value &&
+                     collide->Object2.Geometry.Value == mesh.handle.Value &&
+                     collide->Object2.Transform.Translation.X == 0.3f &&
+                     collide->Flags == (FCL_WORKLOAD_COLLIDE_FLAG_REQUEST | FCL_WORKLOAD_COLLIDE_FLAG_CONTACT_ARRAY) &&
+                     collide->MaxContacts == RTL_NUMBER_OF(contacts) && collide->EnableContactInfo &&
+                     collide->Intersecting && collide->ContactCount == collideResult.ContactCount;
+                break;
+            }
+            case FCL_WORKLOAD_RECORD_COMPOUND_COLLISION: {
+                const auto* pair = reinterpret_cast<const FCL_WORKLOAD_PAIR_RECORD*>(record);
+                ok = pair->Handle2.Value == compoundValue && pair->Flags == FCL_WORKLOAD_PAIR_FLAG_TRANSFORM2 &&
+                     pair->Intersecting;
+                break;
+            }
+            case FCL_WORKLOAD_RECORD_DISTANCE: {
+                const auto* pair = reinterpret_cast<const FCL_WORKLOAD_PAIR_RECORD*>(record);
+                ok = pair->Handle2.Value == compoundValue && pair->Distance == distance.Distance;
+                break;
+            }
+            case FCL_WORKLOAD_RECORD_COMPOUND_DISTANCE: {
+                const auto* pair = reinterpret_cast<const FCL_WORKLOAD_PAIR_RECORD*>(record);
+                ok = pair->Handle2.Value == compoundValue && pair->Distance == compoundDistance.Distance;
+                break;
+            }
+            case FCL_WORKLOAD_RECORD_CONTINUOUS_COLLISION: {
+                const auto* continuous = reinterpret_cast<const FCL_WORKLOAD_CCD_RECORD*>(record);
+                ok = continuous->Query.Object2.Value == mesh.handle.Value && continuous->Intersecting &&
+                     continuous->TimeOfImpact == ccdResult.TimeOfImpact;
+                break;
+            }
+            case FCL_WORKLOAD_RECORD_SCREW_CONTINUOUS_COLLISION: {
+                const auto* continuous = reinterpret_cast<const FCL_WORKLOAD_SCREW_CCD_RECORD*>(record);
+                ok = continuous->Query.Object2.Value == mesh.handle.Value &&
+                     continuous->Query.Motion1.LinearVelocity == 6.0f &&
+                     continuous->Intersecting == screwResult.Intersecting &&
+                     continuous->TimeOfImpact == screwResult.TimeOfImpact;
+                break;
+            }
+            case FCL_WORKLOAD_RECORD_CONTINUOUS_BATCH: {
+                const auto* recordedBatch = reinterpret_cast<const FCL_WORKLOAD_CCD_BATCH_RECORD*>(record);
+                const auto* recordedObjects = reinterpret_cast<const FCL_CONTINUOUS_BATCH_OBJECT*>(recordedBatch + 1);
+                ok = recordedBatch->ObjectCount == 2 && recordedBatch->HasPerObjectHits == 0 &&
+                     recordedObjects[1].Handle.Value == mesh.handle.Value &&
+                     recordedObjects[0].Motion.End.Translation.X == 3.0f &&
+                     recordedBatch->Object1 == batchResult.Object1 && recordedBatch->Object2 == batchResult.Object2 &&
+                     recordedBatch->HitPairCount == 1 &&
+                     recordedBatch->TimeOfImpact == batchResult.Earliest.TimeOfImpact;
+                break;
+            }
+            case FCL_WORKLOAD_RECORD_BROADPHASE: {
+                const auto* broadphase = reinterpret_cast<const FCL_WORKLOAD_BROADPHASE_RECORD*>(record);
+                const auto* recordedObjects = reinterpret_cast<const FCL_WORKLOAD_BROADPHASE_OBJECT*>(broadphase + 1);
+                ok = broadphase->ObjectCount == 2 && broadphase->PairCapacity == 4 && broadphase->PairCount == 1 &&
+                     recordedObjects[0].HasTransform == 0 && recordedObjects[1].HasTransform == 1 &&
+                     recordedObjects[1].Transform.Translation.X == 0.3f;
+                break;
+            }
+            case FCL_WORKLOAD_RECORD_DESTROY:
+                ok = NT_SUCCESS(record->Status) &&
+                     reinterpret_cast<const FCL_WORKLOAD_DESTROY_RECORD*>(record)->Handle.Value == compoundValue;
+                break;
+            default:
+                break;
+        }
+    }
+    if (!ok || !sawExisting || !sawMesh || !sawCompound || !sawRejected) {
+        FCL_LOG_ERROR("Workload record contents mismatch (existing %d, mesh %d, compound %d, rejected %d)",
+            sawExisting,
+            sawMesh,
+            sawCompound,
+            sawRejected);
+        FclDiscardWorkloadRecording();
+        return false;
+    }
+
+    // 缓冲区写满后丢弃后续记录：有效部分仍是完整记录组成的前缀，丢弃数计入状态。
+    config.CapacityBytes = 4096;
+    config.Flags = FCL_WORKLOAD_RECORDING_FLAG_SKIP_EXISTING;
+    status = FclStartWorkloadRecording(&config);
+    constexpr ULONG kCalls = 64;
+    for (ULONG i = 0; NT_SUCCESS(status) && i < kCalls; ++i) {
+        status = FclCollisionDetect(existing.handle, nullptr, mesh.handle, &offset, &isColliding, nullptr);
+    }
+    if (NT_SUCCESS(status)) {
+        status = FclStopWorkloadRecording();
+    }
+    FclQueryWorkloadRecording(&recording);
+    const ULONGLONG fullRecords = (4096 - sizeof(FCL_WORKLOAD_TRACE_HEADER)) / sizeof(FCL_WORKLOAD_PAIR_RECORD);
+    if (!NT_SUCCESS(status) || recording.RecordCount != fullRecords ||
+        recording.DroppedRecords != kCalls - fullRecords ||
+        recording.TraceBytes != sizeof(FCL_WORKLOAD_TRACE_HEADER) + fullRecords * sizeof(FCL_WORKLOAD_PAIR_RECORD) ||
+        ReadWorkloadTrace(trace, sizeof(trace), sizeof(trace)) != recording.TraceBytes) {
+        FCL_LOG_ERROR("Workload recording overflow mismatch (0x%X, %llu records, %llu dropped)",
+            status,
+            recording.RecordCount,
+            recording.DroppedRecords);
+        FclDiscardWorkloadRecording();
+        return false;
+    }
+
+    FclDiscardWorkloadRecording();
+    FclQueryWorkloadRecording(&recording);
+    if (recording.HasTrace || recording.Recording || recording.TraceBytes != 0 ||
+        FclReadWorkloadRecording(0, trace, sizeof(trace), &bytesRead) != STATUS_INVALID_DEVICE_STATE) {
+        FCL_LOG_ERROR0("Workload recording discard mismatch");
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+ULONGLONG PrecompiledMeshChecksum(const UCHAR* data, size_t size) noexcept {
+    ULONGLONG hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+NTSTATUS CreateFromTamperedImage(
+    const UCHAR* image,
+    size_t imageBytes,
+    UCHAR* scratch,
+    size_t parseBytes,
+    void (*tamper)(UCHAR* image, PFCL_PRECOMPILED_MESH_HEADER header)) noexcept {
+    RtlCopyMemory(scratch, image, imageBytes);
+    tamper(scratch, reinterpret_cast<PFCL_PRECOMPILED_MESH_HEADER>(scratch));
+    GeometryHandle created;
+    return FclCreateMeshGeometryFromImage(scratch, parseBytes, &created.handle);
+}
+
+bool RunPrecompiledMeshSuite() noexcept {
+    static UCHAR image[128 * 1024];
+    static UCHAR scratch[128 * 1024];
+
+    // 起伏的 8x8 网格，三角形足够多以产生多层 BVH。
+    constexpr ULONG kGrid = 8;
+    FCL_VECTOR3 vertices[(kGrid + 1) * (kGrid + 1)] = {};
+    UINT32 indices[kGrid * kGrid * 6] = {};
+    for (ULONG y = 0; y <= kGrid; ++y) {
+        for (ULONG x = 0; x <= kGrid; ++x) {
+            const float fx = static_cast<float>(x) / kGrid - 0.5f;
+            const float fy = static_cast<float>(y) / kGrid - 0.5f;
+            vertices[y * (kGrid + 1) + x] = {fx * 4.0f, fy * 4.0f, 0.2f * std::sin(fx * 6.0f) * std::cos(fy * 6.0f)};
+        }
+    }
+    ULONG indexCount = 0;
+    for (ULONG y = 0; y < kGrid; ++y) {
+        for (ULONG x = 0; x < kGrid; ++x) {
+            const UINT32 v0 = y * (kGrid + 1) + x;
+            const UINT32 v1 = v0 + 1;
+            const UINT32 v2 = v0 + kGrid + 1;
+            const UINT32 v3 = v2 + 1;
+            const UINT32 quad[] = {v0, v1, v3, v0, v3, v2};
+            for (UINT32 index : quad) {
+                indices[indexCount++] = index;
+            }
+        }
+    }
+    FCL_MESH_GEOMETRY_DESC desc = {};
+    desc.Vertices = vertices;
+    desc.VertexCount = RTL_NUMBER_OF(vertices);
+    desc.Indices = indices;
+    desc.IndexCount = indexCount;
+    GeometryHandle mesh;
+    GeometryHandle sphere;
+    if (!NT_SUCCESS(FclCreateGeometry(FCL_GEOMETRY_MESH, &desc, &mesh.handle)) ||
+        !NT_SUCCESS(CreateSphere(0.3f, sphere))) {
+        FCL_LOG_ERROR0("Precompiled mesh geometry creation failed");
+        return false;
+    }
+
+    // 非 Mesh、长度查询与缓冲区不足。
+    size_t imageBytes = 0;
+    if (FclSerializeMeshGeometry(sphere.handle, image, sizeof(image), &imageBytes) != STATUS_NOT_SUPPORTED ||
+        FclSerializeMeshGeometry(mesh.handle, nullptr, 0, &imageBytes) != STATUS_BUFFER_TOO_SMALL || imageBytes == 0 ||
+        imageBytes > sizeof(image) ||
+        FclSerializeMeshGeometry(mesh.handle, image, imageBytes - 1, &imageBytes) != STATUS_BUFFER_TOO_SMALL) {
+        FCL_LOG_ERROR("Precompiled mesh size query mismatch (%zu bytes)", imageBytes);
+        return false;
+    }
+    NTSTATUS status = FclSerializeMeshGeometry(mesh.handle, image, imageBytes, &imageBytes);
+    GeometryHandle loaded;
+    if (NT_SUCCESS(status)) {
+        status = FclCreateMeshGeometryFromImage(image, imageBytes, &loaded.handle);
+    }
+    if (!NT_SUCCESS(status)) {
+        FCL_LOG_ERROR("Precompiled mesh round trip failed: 0x%X", status);
+        return false;
+    }
+
+    // 采用的 BVH 与原 Mesh 逐节点一致。
+    FCL_GEOMETRY_REFERENCE originalRef = {};
+    FCL_GEOMETRY_REFERENCE loadedRef = {};
+    FCL_GEOMETRY_SNAPSHOT original = {};
+    FCL_GEOMETRY_SNAPSHOT adopted = {};
+    bool identical = false;
+    if (NT_SUCCESS(FclAcquireGeometryReference(mesh.handle, &originalRef, &original))) {
+        if (NT_SUCCESS(FclAcquireGeometryReference(loaded.handle, &loadedRef, &adopted))) {
+            ULONG nodeCount = 0;
+            ULONG adoptedNodeCount = 0;
+            ULONG triangleCount = 0;
+            const FCL_BVH_NODE* nodes = FclBvhGetNodes(original.Data.Mesh.Bvh, &nodeCount);
+            const FCL_BVH_NODE* adoptedNodes = FclBvhGetNodes(adopted.Data.Mesh.Bvh, &adoptedNodeCount);
+            const UINT32* order = FclBvhGetTriangleOrder(original.Data.Mesh.Bvh, &triangleCount);
+            const UINT32* adoptedOrder = FclBvhGetTriangleOrder(adopted.Data.Mesh.Bvh, nullptr);
+            identical = adopted.Type == FCL_GEOMETRY_MESH && nodeCount > 1 && nodeCount == adoptedNodeCount &&
+                        adopted.Data.Mesh.VertexCount == desc.VertexCount &&
+                        adopted.Data.Mesh.IndexCount == desc.IndexCount &&
+                        std::memcmp(nodes, adoptedNodes, nodeCount * sizeof(FCL_BVH_NODE)) == 0 &&
+                        std::memcmp(order, adoptedOrder, triangleCount * sizeof(UINT32)) == 0 &&
+                        std::memcmp(adopted.Data.Mesh.Indices, indices, indexCount * sizeof(UINT32)) == 0;
+            FclReleaseGeometryReference(&loadedRef);
+        }
+        FclReleaseGeometryReference(&originalRef);
+    }
+    if (!identical) {
+        FCL_LOG_ERROR0("Precompiled mesh BVH differs from the built one");
+        return false;
+    }
+
+    // 查询结果与直接创建的 Mesh 相同。
+    const FCL_TRANSFORM poses[] = {
+        MakeRotatedTransform(0.0f, {0.1f, 0.2f, 0.25f}),
+        MakeRotatedTransform(0.0f, {-1.2f, 0.7f, 0.6f}),
+        MakeRotatedTransform(0.0f, {3.0f, 0.0f, 0.0f}),
+    };
+    for (const FCL_TRANSFORM& pose : poses) {
+        BOOLEAN builtHit = FALSE;
+        BOOLEAN loadedHit = FALSE;
+        FCL_DISTANCE_RESULT builtDistance = {};
+        FCL_DISTANCE_RESULT loadedDistance = {};
+        if (!NT_SUCCESS(FclCollisionDetect(sphere.handle, &pose, mesh.handle, nullptr, &builtHit, nullptr)) ||
+            !NT_SUCCESS(FclCollisionDetect(sphere.handle, &pose, loaded.handle, nullptr, &loadedHit, nullptr)) ||
+            !NT_SUCCESS(FclDistanceCompute(sphere.handle, &pose, mesh.handle, nullptr, &builtDistance)) ||
+            !NT_SUCCESS(FclDistanceCompute(sphere.handle, &pose, loaded.handle, nullptr, &loadedDistance)) ||
+            builtHit != loadedHit || builtDistance.Distance != loadedDistance.Distance) {
+            FCL_LOG_ERROR("Precompiled mesh query mismatch (%u/%u, %f/%f)",
+                builtHit,
+                loadedHit,
+                builtDistance.Distance,
+                loadedDistance.Distance);
+            return false;
+        }
+    }
+
+    // 损坏的映像：截断、魔数、版本、校验和、树结构（重新计算校验和后仍被拒绝）。
+    const struct {
+        void (*Tamper)(UCHAR* image, PFCL_PRECOMPILED_MESH_HEADER header);
+        size_t TrimBytes;
+        NTSTATUS Expected;
+    } cases[] = {
+        {[](UCHAR*, PFCL_PRECOMPILED_MESH_HEADER) {}, 8, STATUS_INVALID_IMAGE_FORMAT},
+        {[](UCHAR*, PFCL_PRECOMPILED_MESH_HEADER header) { header->Magic ^= 1u; }, 0, STATUS_INVALID_IMAGE_FORMAT},
+        {[](UCHAR*, PFCL_PRECOMPILED_MESH_HEADER header) { header->Version += 1u; }, 0, STATUS_REVISION_MISMATCH},
+        {[](UCHAR*, PFCL_PRECOMPILED_MESH_HEADER header) { header->NodesOffset += 8u; }, 0, STATUS_INVALID_IMAGE_FORMAT},
+        {[](UCHAR* bytes, PFCL_PRECOMPILED_MESH_HEADER header) { bytes[header->VerticesOffset] ^= 0x40u; },
+         0,
+         STATUS_DATA_ERROR},
+        {[](UCHAR* bytes, PFCL_PRECOMPILED_MESH_HEADER header) {
+             auto* nodes = reinterpret_cast<PFCL_BVH_NODE>(bytes + header->NodesOffset);
+             nodes[0].LeftChild = 0;
+             header->Checksum = PrecompiledMeshChecksum(
+                 bytes + sizeof(*header), static_cast<size_t>(header->ImageBytes - sizeof(*header)));
+         },
+         0,
+         STATUS_INVALID_PARAMETER},
+        {[](UCHAR* bytes, PFCL_PRECOMPILED_MESH_HEADER header) {
+             auto* order = reinterpret_cast<UINT32*>(bytes + header->TriangleOrderOffset);
+             order[1] = order[0];
+             header->Checksum = PrecompiledMeshChecksum(
+                 bytes + sizeof(*header), static_cast<size_t>(header->ImageBytes - sizeof(*header)));
+         },
+         0,
+         STATUS_INVALID_PARAMETER},
+    };
+    for (ULONG i = 0; i < RTL_NUMBER_OF(cases); ++i) {
+        status = CreateFromTamperedImage(image, imageBytes, scratch, imageBytes - cases[i].TrimBytes, cases[i].Tamper);
+        if (status != cases[i].Expected) {
+            FCL_LOG_ERROR("Precompiled mesh case %lu returned 0x%X (expected 0x%X)", i, status, cases[i].Expected);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    NTSTATUS status = FclGeometrySubsystemInitialize();
+    if (!NT_SUCCESS(status)) {
+        FCL_LOG_ERROR("FclGeometrySubsystemInitialize failed: 0x%X", status);
+        return 1;
+    }
+
+    struct SubsystemGuard {
+        ~SubsystemGuard() {
+            FclGeometrySubsystemShutdown();
+        }
+    } guard;
+
+    if (!RunInvalidDescriptorTest()) {
+        return 10;
+    }
+    if (!RunSphereCollisionSuite()) {
+        return 11;
+    }
+    if (!RunDistanceSuite()) {
+        return 12;
+    }
+    if (!RunNativeKernelParitySuite()) {
+        return 13;
+    }
+    if (!RunCoherenceCacheSuite()) {
+        return 14;
+    }
+    if (!RunDistanceThresholdSuite()) {
+        return 15;
+    }
+    if (!RunContactManifoldSuite()) {
+        return 16;
+    }
+    if (!RunMprParitySuite()) {
+        return 17;
+    }
+    if (!RunSolverSelectionSuite()) {
+        return 18;
+    }
+    if (!RunAnalyticCcdSuite()) {
+        return 19;
+    }
+    if (!RunScrewCcdSuite()) {
+        return 20;
+    }
+    if (!RunContinuousBatchSuite()) {
+        return 21;
+    }
+    if (!RunShapeCastSuite()) {
+        return 22;
+    }
+    if (!RunRaycastSuite()) {
+        return 23;
+    }
+    if (!RunMeshPointQuerySuite()) {
+        return 24;
+    }
+    if (!RunConvexSuite()) {
+        return 25;
+    }
+    if (!RunCapsuleCylinderSuite()) {
+        return 26;
+    }
+    if (!RunCompoundSuite()) {
+        return 27;
+    }
+    if (!RunQueryArenaSuite()) {
+        return 28;
+    }
+    if (!RunSlabAllocatorSuite()) {
+        return 29;
+    }
+    if (!RunDpcReserveSuite()) {
+        return 30;
+    }
+    if (!RunAllocationProfileSuite()) {
+        return 31;
+    }
+    if (!RunCcdObjectPoolSuite()) {
+        return 32;
+    }
+    if (!RunLatencyHistogramSuite()) {
+        return 33;
+    }
+    if (!RunPhaseTraceSuite()) {
+        return 34;
+    }
+    if (!RunWorkloadRecordingSuite()) {
+        return 35;
+    }
+    if (!RunPrecompiledMeshSuite()) {
+        return 36;
     }
 
     return 0;